@@ -52,6 +52,19 @@ public:
     virtual long long getMinFreshSec() const;
 
     virtual long long getSMaxAgeSec() const;
+
+    /**
+     * RFC 5861 stale-while-revalidate. a stale response may be returned while it is revalidated in background.
+     * @return seconds the response may be stale, or -1 if the directive does not exist.
+     */
+    virtual long long getStaleWhileRevalidateSec() const;
+
+    /**
+     * RFC 5861 stale-if-error. a stale response may be returned when the request to the server fails.
+     * @return seconds the response may be stale, or -1 if the directive does not exist.
+     */
+    virtual long long getStaleIfErrorSec() const;
+
     /**
      * 
      * @return 
@@ -99,6 +112,8 @@ private:
     long long m_maxStaleSec;
     long long m_minFreshSec;
     long long m_sMaxAgeSec;
+    long long m_staleWhileRevalidateSec;
+    long long m_staleIfErrorSec;
     bool m_mustRevalidate;
     bool m_noCache;
     bool m_noStore;
@@ -151,6 +166,12 @@ public:
         Builder& setSMaxAgeSec(long long sMaxAgeSec);
         long long getSMaxAgeSec() const;
 
+        Builder& setStaleWhileRevalidateSec(long long staleWhileRevalidateSec);
+        long long getStaleWhileRevalidateSec() const;
+
+        Builder& setStaleIfErrorSec(long long staleIfErrorSec);
+        long long getStaleIfErrorSec() const;
+
         Builder& setMustRevalidate(bool mustRevalidate);
         bool isMustRevalidate() const;
 
@@ -193,6 +214,8 @@ public:
         long long m_maxStaleSec;
         long long m_minFreshSec;
         long long m_sMaxAgeSec;
+        long long m_staleWhileRevalidateSec;
+        long long m_staleIfErrorSec;
         bool m_mustRevalidate;
         bool m_noCache;
         bool m_noStore;
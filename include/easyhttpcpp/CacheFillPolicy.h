@@ -0,0 +1,25 @@
+/*
+ * Copyright 2019 Sony Corporation
+ */
+
+#ifndef EASYHTTPCPP_CACHEFILLPOLICY_H_INCLUDED
+#define EASYHTTPCPP_CACHEFILLPOLICY_H_INCLUDED
+
+namespace easyhttpcpp {
+
+/**
+ * What is done with the rest of a cacheable response body when it is closed before it has been read to the end.
+ */
+enum CacheFillPolicy {
+    /** skip the rest for a short time; if it does not end, the response is not cached and the connection is closed. */
+    CacheFillPolicyDiscardOnClose = 0,
+    /**
+     * read the rest in background within the byte and time budgets, then store the response in HttpCache and
+     * return the connection to the pool.
+     */
+    CacheFillPolicyCompleteInBackground
+};
+
+} /* namespace easyhttpcpp */
+
+#endif /* EASYHTTPCPP_CACHEFILLPOLICY_H_INCLUDED */
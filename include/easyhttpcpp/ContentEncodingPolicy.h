@@ -0,0 +1,30 @@
+/*
+ * Copyright 2019 Sony Corporation
+ */
+
+#ifndef EASYHTTPCPP_CONTENTENCODINGPOLICY_H_INCLUDED
+#define EASYHTTPCPP_CONTENTENCODINGPOLICY_H_INCLUDED
+
+namespace easyhttpcpp {
+
+/**
+ * Content negotiation of compressed response bodies (gzip, deflate).
+ *
+ * Except for ContentEncodingPolicyIdentity, EasyHttp sends Accept-Encoding unless the request already has one
+ * or has Range, and gives the decompressed body to the user without Content-Encoding and Content-Length.
+ *
+ * HttpCache keeps the response of a request with Accept-Encoding apart from the one without it. A cached body stored
+ * compressed is decompressed for a request without Accept-Encoding whatever the policy is.
+ */
+enum ContentEncodingPolicy {
+    /** do not send Accept-Encoding. response bodies are given as received. */
+    ContentEncodingPolicyIdentity = 0,
+    /** decompress while receiving; HttpCache stores the decompressed body. */
+    ContentEncodingPolicyCacheDecompressed,
+    /** HttpCache stores the body as received; it is decompressed on every read. */
+    ContentEncodingPolicyCacheCompressed
+};
+
+} /* namespace easyhttpcpp */
+
+#endif /* EASYHTTPCPP_CONTENTENCODINGPOLICY_H_INCLUDED */
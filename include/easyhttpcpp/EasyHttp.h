@@ -11,13 +11,17 @@
 #include "Poco/AutoPtr.h"
 #include "Poco/RefCountedObject.h"
 #include "Poco/SharedPtr.h"
+#include "Poco/Types.h"
 
 #include "easyhttpcpp/Call.h"
 #include "easyhttpcpp/ConnectionPool.h"
+#include "easyhttpcpp/CacheFillPolicy.h"
+#include "easyhttpcpp/ContentEncodingPolicy.h"
 #include "easyhttpcpp/CrlCheckPolicy.h"
 #include "easyhttpcpp/Interceptor.h"
 #include "easyhttpcpp/HttpCache.h"
 #include "easyhttpcpp/HttpExports.h"
+#include "easyhttpcpp/PrefetchPriority.h"
 #include "easyhttpcpp/Proxy.h"
 #include "easyhttpcpp/Request.h"
 
@@ -53,6 +57,25 @@ public:
      */
     virtual Call::Ptr newCall(Request::Ptr pRequest) = 0;
 
+    /**
+     * Fetch a response into HttpCache in background, so that a later Call of the same request is served from cache.
+     *
+     * Prefetch requests are queued and fetched through the normal cache path, at most
+     * getMaxConcurrentPrefetchCount() at a time and within getPrefetchBytesPerSec(). A request which is already
+     * fresh in cache, or already queued, is skipped. Failures are not notified.
+     *
+     * @param pRequest the HTTP GET request.
+     * @param priority order in which queued requests are fetched.
+     * @exception HttpIllegalArgumentException if the request is NULL or its response can not be cached.
+     * @exception HttpIllegalStateException if HttpCache is not set or EasyHttp is invalidated.
+     */
+    virtual void prefetch(Request::Ptr pRequest, PrefetchPriority priority) = 0;
+
+    /**
+     * Cancel all queued and running prefetch requests. Responses being fetched are not stored in cache.
+     */
+    virtual void cancelPrefetches() = 0;
+
     /**
      * Get proxy settings as set inside the builder or @c NULL if not set.
      *
@@ -95,6 +118,52 @@ public:
      */
     virtual CrlCheckPolicy getCrlCheckPolicy() const = 0;
 
+    /**
+     * Gets the content encoding policy as set inside the builder or ContentEncodingPolicyIdentity if not set.
+     *
+     * @return the content encoding policy.
+     * @see ContentEncodingPolicy
+     */
+    virtual ContentEncodingPolicy getContentEncodingPolicy() const = 0;
+
+    /**
+     * Gets whether concurrent identical requests are coalesced as set inside the builder or false if not set.
+     *
+     * @return true if request coalescing is enabled.
+     * @see Builder::setRequestCoalescingEnabled
+     */
+    virtual bool isRequestCoalescingEnabled() const = 0;
+
+    /**
+     * Gets the time a coalesced request waits for the first one as set inside the builder or 1000 if not set.
+     *
+     * @return the wait in milliseconds.
+     * @see Builder::setRequestCoalescingTimeoutMillis
+     */
+    virtual unsigned int getRequestCoalescingTimeoutMillis() const = 0;
+
+    /**
+     * Gets the cache fill policy as set inside the builder or CacheFillPolicyDiscardOnClose if not set.
+     *
+     * @return the cache fill policy.
+     * @see CacheFillPolicy
+     */
+    virtual CacheFillPolicy getCacheFillPolicy() const = 0;
+
+    /**
+     * Gets the byte budget of a background cache fill as set inside the builder or 16 MiB if not set.
+     *
+     * @return the maximum bytes read in background per response.
+     */
+    virtual Poco::UInt64 getBackgroundCacheFillMaxBytes() const = 0;
+
+    /**
+     * Gets the time budget of a background cache fill as set inside the builder or 10 seconds if not set.
+     *
+     * @return the maximum seconds spent in background per response.
+     */
+    virtual unsigned int getBackgroundCacheFillTimeoutSec() const = 0;
+
     /**
      * Gets the path to SSL root ca certificate directory as set inside the builder
      * or @c NULL is not set.
@@ -135,6 +204,21 @@ public:
      */
     virtual unsigned int getMaximumPoolSizeOfAsyncThreadPool() const = 0;
 
+    /**
+     * Get the maximum number of prefetch requests fetched at the same time as set inside the builder or 1 if not set.
+     *
+     * @return the maximum number of concurrent prefetch requests.
+     */
+    virtual unsigned int getMaxConcurrentPrefetchCount() const = 0;
+
+    /**
+     * Get the total bandwidth of prefetch requests in bytes per second as set inside the builder or 0 (unlimited)
+     * if not set.
+     *
+     * @return the bandwidth of prefetch requests.
+     */
+    virtual Poco::UInt64 getPrefetchBytesPerSec() const = 0;
+
     /**
      * Invalidate EasyHttp object and cancel all background tasks.
      *
@@ -253,6 +337,114 @@ public:
          */
         CrlCheckPolicy getCrlCheckPolicy() const;
 
+        /**
+         * @brief Set ContentEncodingPolicy
+         * 
+         * if ContentEncodingPolicy is not set, use ContentEncodingPolicyIdentity.
+         * @param contentEncodingPolicy ContentEncodingPolicy
+         * @return Builder
+         */
+        Builder& setContentEncodingPolicy(ContentEncodingPolicy contentEncodingPolicy);
+
+        /**
+         * @brief Get ContentEncodingPolicy
+         * @return ContentEncodingPolicy
+         */
+        ContentEncodingPolicy getContentEncodingPolicy() const;
+
+        /**
+         * @brief Enable coalescing of concurrent identical requests.
+         *
+         * When enabled and HttpCache is set, concurrent GET requests of the same url which can not be served from
+         * cache are coalesced: the first one is sent to the server, and the others wait until its response body has
+         * been read and stored in cache, then are served from cache. A waiting request which still can not be
+         * served from cache, because the response was not cacheable or the wait timed out, is sent to the server.
+         * The wait is at most setRequestCoalescingTimeoutMillis, and ends as soon as the response of the first
+         * request turns out not to be stored in cache.
+         * @param requestCoalescingEnabled true to enable.
+         * @return Builder
+         */
+        Builder& setRequestCoalescingEnabled(bool requestCoalescingEnabled);
+
+        /**
+         * @brief Get whether request coalescing is enabled.
+         *
+         * If it is not set, request coalescing is disabled.
+         * @return true if request coalescing is enabled.
+         */
+        bool isRequestCoalescingEnabled() const;
+
+        /**
+         * @brief Set the time a coalesced request waits for the first one.
+         *
+         * A waiting request is sent to the server when the first one has not stored its response in cache within
+         * this time, e.g. because its response body is still being read.
+         * @param requestCoalescingTimeoutMillis the maximum milliseconds of the wait.
+         * @return Builder
+         * @exception HttpIllegalArgumentException
+         */
+        Builder& setRequestCoalescingTimeoutMillis(unsigned int requestCoalescingTimeoutMillis);
+
+        /**
+         * @brief Get the time a coalesced request waits for the first one.
+         *
+         * If it is not set, the wait is 1000 milliseconds.
+         * @return the maximum milliseconds of the wait.
+         */
+        unsigned int getRequestCoalescingTimeoutMillis() const;
+
+        /**
+         * @brief Set CacheFillPolicy
+         *
+         * if CacheFillPolicy is not set, use CacheFillPolicyDiscardOnClose.
+         * With CacheFillPolicyCompleteInBackground, the rest of a cacheable response body which is closed before
+         * the end is read on the thread pool of asynchronous requests, within setBackgroundCacheFillMaxBytes and
+         * setBackgroundCacheFillTimeoutSec. A response which does not end within them is not cached.
+         * @param cacheFillPolicy CacheFillPolicy
+         * @return Builder
+         */
+        Builder& setCacheFillPolicy(CacheFillPolicy cacheFillPolicy);
+
+        /**
+         * @brief Get CacheFillPolicy
+         * @return CacheFillPolicy
+         */
+        CacheFillPolicy getCacheFillPolicy() const;
+
+        /**
+         * @brief Set the byte budget of a background cache fill.
+         *
+         * A response whose rest is known to be larger than this is not read in background.
+         * @param backgroundCacheFillMaxBytes the maximum bytes read in background per response.
+         * @return Builder
+         */
+        Builder& setBackgroundCacheFillMaxBytes(Poco::UInt64 backgroundCacheFillMaxBytes);
+
+        /**
+         * @brief Get the byte budget of a background cache fill.
+         *
+         * If it is not set, the budget is 16 MiB.
+         * @return the maximum bytes read in background per response.
+         */
+        Poco::UInt64 getBackgroundCacheFillMaxBytes() const;
+
+        /**
+         * @brief Set the time budget of a background cache fill.
+         *
+         * @param backgroundCacheFillTimeoutSec the maximum seconds spent in background per response.
+         * @return Builder
+         * @exception HttpIllegalArgumentException
+         */
+        Builder& setBackgroundCacheFillTimeoutSec(unsigned int backgroundCacheFillTimeoutSec);
+
+        /**
+         * @brief Get the time budget of a background cache fill.
+         *
+         * If it is not set, the budget is 10 seconds.
+         * @return the maximum seconds spent in background per response.
+         */
+        unsigned int getBackgroundCacheFillTimeoutSec() const;
+
         /**
          * @brief Add CallInterceptor.
          * @param pInterceptor CallInterceptor
@@ -328,6 +520,42 @@ public:
          */
         unsigned int getMaximumPoolSizeOfAsyncThreadPool() const;
 
+        /**
+         * @brief Set the maximum number of prefetch requests fetched at the same time.
+         *
+         * Prefetch requests run on the thread pool of asynchronous requests; keep this less than the maximum pool
+         * size so that asynchronous requests are not delayed by them.
+         * @param maxConcurrentPrefetchCount the maximum number of concurrent prefetch requests.
+         * @return Builder
+         * @exception HttpIllegalArgumentException
+         */
+        Builder& setMaxConcurrentPrefetchCount(unsigned int maxConcurrentPrefetchCount);
+
+        /**
+         * @brief Get the maximum number of prefetch requests fetched at the same time.
+         *
+         * If it is not set, the maximum number is 1.
+         * @return the maximum number of concurrent prefetch requests.
+         */
+        unsigned int getMaxConcurrentPrefetchCount() const;
+
+        /**
+         * @brief Set the total bandwidth of prefetch requests.
+         *
+         * Response bodies of prefetch requests are read no faster than this, summed over all prefetch requests.
+         * @param prefetchBytesPerSec bytes per second, or 0 for unlimited.
+         * @return Builder
+         */
+        Builder& setPrefetchBytesPerSec(Poco::UInt64 prefetchBytesPerSec);
+
+        /**
+         * @brief Get the total bandwidth of prefetch requests.
+         *
+         * If it is not set, the bandwidth is 0 (unlimited).
+         * @return bytes per second.
+         */
+        Poco::UInt64 getPrefetchBytesPerSec() const;
+
     private:
         HttpCache::Ptr m_pCache;
         unsigned int m_timeoutSec;
@@ -335,11 +563,19 @@ public:
         std::string m_rootCaDirectory;
         std::string m_rootCaFile;
         CrlCheckPolicy m_crlCheckPolicy;
+        ContentEncodingPolicy m_contentEncodingPolicy;
+        bool m_requestCoalescingEnabled;
+        unsigned int m_requestCoalescingTimeoutMillis;
+        CacheFillPolicy m_cacheFillPolicy;
+        Poco::UInt64 m_backgroundCacheFillMaxBytes;
+        unsigned int m_backgroundCacheFillTimeoutSec;
         std::list<Interceptor::Ptr> m_callInterceptors;
         std::list<Interceptor::Ptr> m_networkInterceptors;
         ConnectionPool::Ptr m_pConnectionPool;
         unsigned int m_corePoolSizeOfAsyncThreadPool;
         unsigned int m_maximumPoolSizeOfAsyncThreadPool;
+        unsigned int m_maxConcurrentPrefetchCount;
+        Poco::UInt64 m_prefetchBytesPerSec;
     };
 };
 
@@ -12,6 +12,7 @@
 #include "Poco/RefCountedObject.h"
 #include "Poco/Path.h"
 
+#include "easyhttpcpp/HttpCacheKeyHasher.h"
 #include "easyhttpcpp/HttpExports.h"
 
 namespace easyhttpcpp {
@@ -20,6 +21,24 @@ class EASYHTTPCPP_HTTP_API HttpCache : public Poco::RefCountedObject {
 public:
     typedef Poco::AutoPtr<HttpCache> Ptr;
 
+    class Builder;
+
+    /**
+     * Which cached responses are evicted when the cache directory is full.
+     */
+    enum EvictionPolicy {
+        EvictionPolicyLru = 0, /**< the least recently used responses are evicted. */
+        EvictionPolicyTinyLfu /**< W-TinyLFU; a response used only once does not evict frequently used ones. */
+    };
+
+    /**
+     * How response bodies are stored in the cache directory.
+     */
+    enum BodyCompression {
+        BodyCompressionNone = 0, /**< response bodies are stored as received. */
+        BodyCompressionGzip /**< response bodies are stored gzip compressed when it saves space. */
+    };
+
     /**
      * 
      */
@@ -56,6 +75,168 @@ public:
      */
     virtual size_t getSize() = 0;
 
+    /**
+     * Writes buffered cache bookkeeping, such as last accessed times, to the file system.
+     * It is also done periodically and when the cache is destroyed.
+     * @exception HttpExecutionException
+     */
+    virtual void flush() = 0;
+
+    /**
+     * Builds HttpCache with options other than path and maxSize. An option which is not set is the same as
+     * createCache(path, maxSize).
+     */
+    class EASYHTTPCPP_HTTP_API Builder {
+    public:
+        /**
+         * @param path cache directory
+         * @param maxSize max bytes of the cache directory
+         */
+        Builder(const Poco::Path& path, size_t maxSize);
+        virtual ~Builder();
+
+        /**
+         * Builds HttpCache by specified parameters.
+         * @return HttpCache
+         */
+        HttpCache::Ptr build();
+
+        /**
+         * @brief Get cache directory.
+         * @return cache directory
+         */
+        const Poco::Path& getPath() const;
+
+        /**
+         * @brief Get max bytes of the cache directory.
+         * @return max bytes
+         */
+        size_t getMaxSize() const;
+
+        /**
+         * @brief Set max bytes of the memory cache.
+         *
+         * Small recently used responses are also kept in memory, so that they are served without database and
+         * file access.
+         * @param memoryCacheMaxSize max bytes. if 0, memory cache is not used.
+         * @return Builder
+         */
+        Builder& setMemoryCacheMaxSize(size_t memoryCacheMaxSize);
+
+        /**
+         * @brief Get max bytes of the memory cache.
+         *
+         * If it is not set, it is 0 (memory cache is not used).
+         * @return max bytes
+         */
+        size_t getMemoryCacheMaxSize() const;
+
+        /**
+         * @brief Set hasher of cache keys.
+         *
+         * Cached responses of the directory made with another hasher are kept; their keys are made again when the
+         * cache is opened.
+         * @param pKeyHasher hasher. if NULL, HttpCacheKeyHasher::createDefaultHasher is used.
+         * @return Builder
+         */
+        Builder& setKeyHasher(HttpCacheKeyHasher::Ptr pKeyHasher);
+
+        /**
+         * @brief Get hasher of cache keys.
+         *
+         * If it is not set, it is NULL (the default hasher).
+         * @return hasher
+         */
+        HttpCacheKeyHasher::Ptr getKeyHasher() const;
+
+        /**
+         * @brief Set max bytes of a response body stored in the database.
+         *
+         * Small response bodies are stored in the database instead of a file per response, so that caching many
+         * small responses does not cost a file each.
+         * @param inlineBodyMaxSize max bytes (e.g. 4096). if 0, every response body is stored in a file.
+         * @return Builder
+         */
+        Builder& setInlineBodyMaxSize(size_t inlineBodyMaxSize);
+
+        /**
+         * @brief Get max bytes of a response body stored in the database.
+         *
+         * If it is not set, it is 0 (every response body is stored in a file).
+         * @return max bytes
+         */
+        size_t getInlineBodyMaxSize() const;
+
+        /**
+         * @brief Set depth of the directories which response body files are stored in.
+         *
+         * Files are spread over directories named by the leading characters of their keys, so that no directory
+         * holds too many files. Cached response bodies of the directory stored with another depth are moved when
+         * the cache is opened.
+         * @param dataDirFanOutLevels depth of the directories. if 0, every file is stored in the cache directory.
+         * @return Builder
+         */
+        Builder& setDataDirFanOutLevels(unsigned int dataDirFanOutLevels);
+
+        /**
+         * @brief Get depth of the directories which response body files are stored in.
+         *
+         * If it is not set, it is 2.
+         * @return depth of the directories
+         */
+        unsigned int getDataDirFanOutLevels() const;
+
+        /**
+         * @brief Set eviction policy of the cache directory.
+         *
+         * EvictionPolicyTinyLfu keeps frequently used responses when many responses are requested only once, such
+         * as by a crawl. The memory cache is always LRU.
+         * @param evictionPolicy eviction policy
+         * @return Builder
+         */
+        Builder& setEvictionPolicy(EvictionPolicy evictionPolicy);
+
+        /**
+         * @brief Get eviction policy of the cache directory.
+         *
+         * If it is not set, it is EvictionPolicyLru.
+         * @return eviction policy
+         */
+        EvictionPolicy getEvictionPolicy() const;
+
+        /**
+         * @brief Set compression of response bodies.
+         *
+         * A response body is compressed only when it is not already content-encoded and compression saves enough
+         * space; it is decompressed while it is read from the cache. maxSize is compared with the compressed bytes.
+         * The response body is compressed by the cache writer thread while it is received, not when it is closed.
+         * Bodies already in the cache are read regardless of it.
+         * @param bodyCompression compression of response bodies written from now on
+         * @return Builder
+         */
+        Builder& setBodyCompression(BodyCompression bodyCompression);
+
+        /**
+         * @brief Get compression of response bodies.
+         *
+         * If it is not set, it is BodyCompressionNone.
+         * @return compression
+         */
+        BodyCompression getBodyCompression() const;
+
+    private:
+        Builder();
+
+        Poco::Path m_path;
+        size_t m_maxSize;
+        size_t m_memoryCacheMaxSize;
+        HttpCacheKeyHasher::Ptr m_pKeyHasher;
+        size_t m_inlineBodyMaxSize;
+        unsigned int m_dataDirFanOutLevels;
+        EvictionPolicy m_evictionPolicy;
+        BodyCompression m_bodyCompression;
+    };
+
 };
 
 } /* namespace easyhttpcpp */
@@ -0,0 +1,64 @@
+/*
+ * Copyright 2019 Sony Corporation
+ */
+
+#ifndef EASYHTTPCPP_HTTPCACHEKEYHASHER_H_INCLUDED
+#define EASYHTTPCPP_HTTPCACHEKEYHASHER_H_INCLUDED
+
+#include <string>
+
+#include "Poco/AutoPtr.h"
+#include "Poco/RefCountedObject.h"
+
+#include "easyhttpcpp/HttpExports.h"
+
+namespace easyhttpcpp {
+
+/**
+ * @brief A HttpCacheKeyHasher makes the cache key of a request from its method and url.
+ *
+ * The key is used as the file name of the cached response body, and the cache assumes that different requests get
+ * different keys. The stored method and url are checked before a cached response or an interrupted download is
+ * served, updated or removed, but a hasher which is not collision resistant may still let a request replace the
+ * cached response of another request.
+ */
+class EASYHTTPCPP_HTTP_API HttpCacheKeyHasher : public Poco::RefCountedObject {
+public:
+    typedef Poco::AutoPtr<HttpCacheKeyHasher> Ptr;
+
+    /**
+     * 
+     */
+    virtual ~HttpCacheKeyHasher();
+
+    /**
+     * Returns the name of the hash function. The name is stored in the cache, and the keys of cached responses are
+     * made again when the cache is opened with a hasher of another name.
+     * @return name
+     */
+    virtual const std::string& getName() const = 0;
+
+    /**
+     * Makes a key from data.
+     * @param data method and url of the request
+     * @return key which consists of characters usable in a file name. if empty, the request is not cached.
+     */
+    virtual std::string hash(const std::string& data) = 0;
+
+    /**
+     * Creates the default hasher, which makes a message digest in hex.
+     * @return HttpCacheKeyHasher
+     */
+    static HttpCacheKeyHasher::Ptr createDefaultHasher();
+
+    /**
+     * Creates a hasher which makes a 128-bit MurmurHash3 in hex. It is faster than the default hasher but not
+     * collision resistant; use it only when the urls are not chosen by an untrusted party.
+     * @return HttpCacheKeyHasher
+     */
+    static HttpCacheKeyHasher::Ptr createMurmur3Hasher();
+};
+
+} /* namespace easyhttpcpp */
+
+#endif /* EASYHTTPCPP_HTTPCACHEKEYHASHER_H_INCLUDED */
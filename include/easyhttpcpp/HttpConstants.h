@@ -16,6 +16,8 @@ public:
 
     class EASYHTTPCPP_HTTP_API HeaderNames {
     public:
+        static const char* const AcceptEncoding;
+        static const char* const AcceptRanges;
         static const char* const Age;
         static const char* const Authorization;
         static const char* const CacheControl;
@@ -23,11 +25,13 @@ public:
         static const char* const ContentEncoding;
         static const char* const ContentType;
         static const char* const ContentLength;
+        static const char* const ContentRange;
         static const char* const Date;
         static const char* const ETag;
         static const char* const Expires;
         static const char* const IfModifiedSince;
         static const char* const IfNoneMatch;
+        static const char* const IfRange;
         static const char* const KeepAlive;
         static const char* const LastModified;
         static const char* const Location;
@@ -49,7 +53,12 @@ public:
         static const char* const Close;
         static const char* const HeuristicExpiration;
         static const char* const ResponseIsStale;
+        static const char* const RevalidationFailed;
         static const char* const ApplicationOctetStream;
+        static const char* const Bytes;
+        static const char* const Deflate;
+        static const char* const Gzip;
+        static const char* const XGzip;
     };
 
     class EASYHTTPCPP_HTTP_API CacheDirectives {
@@ -65,6 +74,8 @@ public:
         static const char* const Private;
         static const char* const Public;
         static const char* const SMaxAge;
+        static const char* const StaleIfError;
+        static const char* const StaleWhileRevalidate;
     };
 
     class EASYHTTPCPP_HTTP_API Schemes {
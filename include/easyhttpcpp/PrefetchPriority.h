@@ -0,0 +1,25 @@
+/*
+ * Copyright 2019 Sony Corporation
+ */
+
+#ifndef EASYHTTPCPP_PREFETCHPRIORITY_H_INCLUDED
+#define EASYHTTPCPP_PREFETCHPRIORITY_H_INCLUDED
+
+namespace easyhttpcpp {
+
+/**
+ * Order in which requests given to EasyHttp::prefetch are fetched.
+ *
+ * Requests of the same priority are fetched in the order they were given.
+ */
+enum PrefetchPriority {
+    /** fetched before normal and low priority requests. */
+    PrefetchPriorityHigh = 0,
+    PrefetchPriorityNormal,
+    /** fetched after all other prefetch requests. */
+    PrefetchPriorityLow
+};
+
+} /* namespace easyhttpcpp */
+
+#endif /* EASYHTTPCPP_PREFETCHPRIORITY_H_INCLUDED */
@@ -6,6 +6,7 @@
 #define EASYHTTPCPP_REQUESTBODY_H_INCLUDED
 
 #include <ostream>
+#include <string>
 
 #ifdef _WIN32
 #include <basetsd.h>
@@ -94,6 +95,28 @@ public:
     EASYHTTPCPP_DEPRECATED("please use create(MediaType::Ptr, Poco::SharedPtr<easyhttpcpp::common::ByteArrayBuffer>)")
         static Ptr create(MediaType::Ptr pMediaType, const easyhttpcpp::common::ByteArrayBuffer& content);
 
+    /**
+     * @brief Create RequestBody which compresses given RequestBody by gzip while writing.
+     *
+     * Content-Encoding: gzip is added to the request and the body is sent by chunked transfer encoding.
+     * Compression is skipped when the content is smaller than 1024 bytes or its media type is already compressed
+     * (image, audio, video and archives).
+     * @param pRequestBody RequestBody to compress
+     * @return RequestBody
+     * @exception HttpIllegalArgumentException
+     */
+    static Ptr createGzip(RequestBody::Ptr pRequestBody);
+
+    /**
+     * @brief Create RequestBody which compresses given RequestBody by gzip while writing.
+     * @param pRequestBody RequestBody to compress
+     * @param compressionLevel compression level from 1 (fastest) to 9 (smallest)
+     * @param adaptive if true, compression is skipped for small or already compressed content.
+     * @return RequestBody
+     * @exception HttpIllegalArgumentException
+     */
+    static Ptr createGzip(RequestBody::Ptr pRequestBody, int compressionLevel, bool adaptive);
+
     /**
      * @brief Get MethiaType
      * @return MediaType
@@ -119,6 +142,12 @@ public:
      */
     virtual ssize_t getContentLength() const = 0;
 
+    /**
+     * @brief Get Content-Encoding applied while writing.
+     * @return Content-Encoding. if not encoded, return empty string.
+     */
+    virtual std::string getContentEncoding() const;
+
     /**
      * @brief reset for re-read request body.
      * @return if succeeded to reset, return true.
@@ -11,14 +11,19 @@ typedef SSIZE_T ssize_t;
 #endif
 
 #include "Poco/AutoPtr.h"
+#include "Poco/Path.h"
 #include "Poco/RefCountedObject.h"
+#include "Poco/Types.h"
 
 #include "easyhttpcpp/HttpExports.h"
 #include "easyhttpcpp/MediaType.h"
 #include "easyhttpcpp/ResponseBodyStream.h"
+#include "easyhttpcpp/ResponseBodyWriteCallback.h"
 
 namespace easyhttpcpp {
 
+class HttpExecutionTaskManager;
+
 /**
  * @brief A ResponseBody preserve Http response body.
  */
@@ -83,14 +88,49 @@ public:
      */
     virtual std::string toString();
 
+    /**
+     * @brief Write response body to file.
+     *
+     * Disk space is reserved up front from Content-Length. When the response is being stored to the cache,
+     * the cached copy is reused for the file instead of writing the body twice.
+     * If the write fails part way, the partially written file is left as is so that it can be resumed.
+     * after writeTo, can not read response body.
+     * @param path destination file. its parent directory must exist.
+     * @param append If true, response body is appended to the existing file.
+     *        Use this to resume a download with a Range request that starts at the current file size.
+     * @return number of bytes of the response body written to the file.
+     * @exception HttpIllegalArgumentException
+     * @exception HttpIllegalStateException
+     * @exception HttpExecutionException
+     */
+    virtual Poco::UInt64 writeTo(const Poco::Path& path, bool append = false);
+
+    /**
+     * @brief Write response body to file asynchronously.
+     *
+     * This method returns as soon as it accepts the request, and when the write completes, callback is invoked.
+     * ResponseBody must be obtained from a Response returned by Call.
+     * @param path destination file. its parent directory must exist.
+     * @param pCallback completion callback.
+     * @param append If true, response body is appended to the existing file.
+     * @exception HttpIllegalArgumentException
+     * @exception HttpIllegalStateException
+     */
+    virtual void writeToAsync(const Poco::Path& path, ResponseBodyWriteCallback::Ptr pCallback, bool append = false);
+
 private:
+    friend class HttpEngine;
+
     ResponseBody(MediaType::Ptr pMediaType, bool hasContentLength, ssize_t contentLength,
             ResponseBodyStream::Ptr pContent);
 
+    void setExecutionTaskManager(Poco::AutoPtr<HttpExecutionTaskManager> pExecutionTaskManager);
+
     MediaType::Ptr m_pMediaType;
     bool m_hasContentLength;
     ssize_t m_contentLength;
     ResponseBodyStream::Ptr m_pContent;
+    Poco::AutoPtr<HttpExecutionTaskManager> m_pExecutionTaskManager;
 };
 
 } /* namespace easyhttpcpp */
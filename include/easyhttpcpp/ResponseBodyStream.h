@@ -45,6 +45,21 @@ public:
      */
     virtual bool isEof() = 0;
 
+    /**
+     * @brief Read the rest of response body without copying.
+     *
+     * This is available when the response body is read from the cache. The data is valid until the stream is
+     * closed. After this returns true, the stream is at eof.
+     * @param pData start of the rest of response body
+     * @param size size of the rest of response body
+     * @return If the rest of response body is not in contiguous memory, return false and read() has to be used.
+     * @exception HttpIllegalStateException
+     */
+    virtual bool readContiguous(const char*& pData, size_t& size)
+    {
+        return false;
+    }
+
     /**
      * @brief Close stream.
      * 
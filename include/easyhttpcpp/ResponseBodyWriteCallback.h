@@ -0,0 +1,51 @@
+/*
+ * Copyright 2019 Sony Corporation
+ */
+
+#ifndef EASYHTTPCPP_RESPONSEBODYWRITECALLBACK_H_INCLUDED
+#define EASYHTTPCPP_RESPONSEBODYWRITECALLBACK_H_INCLUDED
+
+#include "Poco/AutoPtr.h"
+#include "Poco/Path.h"
+#include "Poco/RefCountedObject.h"
+#include "Poco/Types.h"
+
+#include "easyhttpcpp/HttpException.h"
+
+namespace easyhttpcpp {
+
+/**
+ * @class ResponseBodyWriteCallback ResponseBodyWriteCallback.h "easyhttpcpp/ResponseBodyWriteCallback.h"
+ *
+ * Completion callback class for ResponseBody::writeToAsync.
+ */
+class ResponseBodyWriteCallback : public Poco::RefCountedObject {
+public:
+    /**
+     * A "smart" pointer to facilitate reference counting based garbage collection.
+     */
+    typedef Poco::AutoPtr<ResponseBodyWriteCallback> Ptr;
+
+    virtual ~ResponseBodyWriteCallback()
+    {
+    }
+
+    /**
+     * Called when the whole response body was written to the file.
+     *
+     * @param path the file the response body was written to.
+     * @param writtenBytes number of bytes of the response body written by this call.
+     */
+    virtual void onCompleted(const Poco::Path& path, Poco::UInt64 writtenBytes) = 0;
+
+    /**
+     * Called when the exception occurred in executing ResponseBody::writeToAsync.
+     *
+     * @param pWhat the exception that occurred in executing ResponseBody::writeToAsync.
+     */
+    virtual void onFailure(HttpException::Ptr pWhat) = 0;
+};
+
+} /* namespace easyhttpcpp */
+
+#endif /* EASYHTTPCPP_RESPONSEBODYWRITECALLBACK_H_INCLUDED */
@@ -0,0 +1,160 @@
+/*
+ * Copyright 2019 Sony Corporation
+ */
+
+#ifndef EASYHTTPCPP_SEGMENTEDDOWNLOADER_H_INCLUDED
+#define EASYHTTPCPP_SEGMENTEDDOWNLOADER_H_INCLUDED
+
+#include "Poco/AutoPtr.h"
+#include "Poco/Mutex.h"
+#include "Poco/Path.h"
+#include "Poco/RefCountedObject.h"
+#include "Poco/Types.h"
+
+#include "easyhttpcpp/EasyHttp.h"
+#include "easyhttpcpp/HttpExports.h"
+#include "easyhttpcpp/Request.h"
+
+namespace easyhttpcpp {
+
+class SegmentedDownloadContext;
+
+/**
+ * @brief A SegmentedDownloader downloads a large resource to a file over several connections at once.
+ *
+ * The resource is probed with HEAD. If the server accepts byte ranges, the resource is split into segments which are
+ * fetched concurrently with Range requests through the EasyHttp connection pool and written at their offsets into a
+ * preallocated file. A failed segment is retried from the last byte it received. If the server does not accept byte
+ * ranges, the resource is downloaded with a single GET.
+ */
+class EASYHTTPCPP_HTTP_API SegmentedDownloader : public Poco::RefCountedObject {
+public:
+    typedef Poco::AutoPtr<SegmentedDownloader> Ptr;
+
+    /**
+     * @brief Receives aggregate progress of SegmentedDownloader::download.
+     *
+     * Called from the threads downloading the segments.
+     */
+    class ProgressListener : public Poco::RefCountedObject {
+    public:
+        typedef Poco::AutoPtr<ProgressListener> Ptr;
+
+        virtual ~ProgressListener()
+        {
+        }
+
+        /**
+         * @param downloadedBytes bytes written to the file so far, summed over all segments.
+         * @param totalBytes size of the resource.
+         */
+        virtual void onProgress(Poco::UInt64 downloadedBytes, Poco::UInt64 totalBytes) = 0;
+    };
+
+    class Builder;
+
+    virtual ~SegmentedDownloader();
+
+    /**
+     * @brief Download the resource of a GET request to a file.
+     *
+     * Blocks until the whole resource is written. An existing file is overwritten.
+     * @param pRequest GET request. its headers are sent with every segment request.
+     * @param path destination file. its parent directory must exist.
+     * @return size of the downloaded resource.
+     * @exception HttpIllegalArgumentException
+     * @exception HttpIllegalStateException
+     * @exception HttpExecutionException
+     * @exception HttpTimeoutException
+     * @exception HttpSslException
+     */
+    virtual Poco::UInt64 download(Request::Ptr pRequest, const Poco::Path& path);
+
+    /**
+     * @brief Cancel the download in progress.
+     * @return true if a download was in progress.
+     */
+    virtual bool cancel();
+
+    virtual unsigned int getSegmentCount() const;
+    virtual Poco::UInt64 getSegmentSize() const;
+    virtual unsigned int getMaxRetryCount() const;
+
+    /**
+     * @brief A SegmentedDownloader::Builder is Builder for SegmentedDownloader.
+     */
+    class EASYHTTPCPP_HTTP_API Builder {
+    public:
+        Builder();
+        virtual ~Builder();
+
+        /**
+         * @brief Build SegmentedDownloader.
+         * @param pEasyHttp EasyHttp used for all requests.
+         * @return SegmentedDownloader
+         * @exception HttpIllegalArgumentException
+         */
+        SegmentedDownloader::Ptr build(EasyHttp::Ptr pEasyHttp);
+
+        /**
+         * @brief Set the number of segments downloaded concurrently. default is 4.
+         * @param segmentCount number of concurrent segments.
+         * @return Builder
+         * @exception HttpIllegalArgumentException
+         */
+        Builder& setSegmentCount(unsigned int segmentCount);
+        unsigned int getSegmentCount() const;
+
+        /**
+         * @brief Set the size of one segment.
+         *
+         * If 0 (default), the resource is split into getSegmentCount() equal segments. Otherwise the resource is split
+         * into segments of this size which are fetched getSegmentCount() at a time.
+         * @param segmentSize bytes per segment.
+         * @return Builder
+         */
+        Builder& setSegmentSize(Poco::UInt64 segmentSize);
+        Poco::UInt64 getSegmentSize() const;
+
+        /**
+         * @brief Set how many times a failed segment is retried. default is 3.
+         * @param maxRetryCount retry count.
+         * @return Builder
+         */
+        Builder& setMaxRetryCount(unsigned int maxRetryCount);
+        unsigned int getMaxRetryCount() const;
+
+        /**
+         * @brief Set ProgressListener.
+         * @param pProgressListener ProgressListener
+         * @return Builder
+         */
+        Builder& setProgressListener(ProgressListener::Ptr pProgressListener);
+        ProgressListener::Ptr getProgressListener() const;
+
+    private:
+        unsigned int m_segmentCount;
+        Poco::UInt64 m_segmentSize;
+        unsigned int m_maxRetryCount;
+        ProgressListener::Ptr m_pProgressListener;
+    };
+
+private:
+    SegmentedDownloader(EasyHttp::Ptr pEasyHttp, Builder& builder);
+
+    Poco::UInt64 downloadWithSingleRequest(Request::Ptr pRequest, const Poco::Path& path);
+
+    EasyHttp::Ptr m_pEasyHttp;
+    unsigned int m_segmentCount;
+    Poco::UInt64 m_segmentSize;
+    unsigned int m_maxRetryCount;
+    ProgressListener::Ptr m_pProgressListener;
+    Poco::FastMutex m_instanceMutex;
+    bool m_downloading;
+    bool m_cancelled;
+    Poco::AutoPtr<SegmentedDownloadContext> m_pDownloadContext;
+};
+
+} /* namespace easyhttpcpp */
+
+#endif /* EASYHTTPCPP_SEGMENTEDDOWNLOADER_H_INCLUDED */
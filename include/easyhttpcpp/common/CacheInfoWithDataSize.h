@@ -15,6 +15,8 @@
 namespace easyhttpcpp {
 namespace common {
 
+class LruCacheByDataSizeStrategy;
+
 class EASYHTTPCPP_COMMON_API CacheInfoWithDataSize : public Poco::RefCountedObject {
 public:
     typedef Poco::AutoPtr<CacheInfoWithDataSize> Ptr;
@@ -31,12 +33,24 @@ public:
     void setDataSize(size_t dataSize);
     size_t getDataSize() const;
 
+    /**
+     * Neighbors in the LRU list of the LruCacheByDataSizeStrategy which keeps this entry.
+     * @return NULL if this entry is the newest (or the oldest), or is not kept by a strategy.
+     */
+    CacheInfoWithDataSize* getNewer() const;
+    CacheInfoWithDataSize* getOlder() const;
+
 protected:
     void copyFrom(const CacheInfoWithDataSize& original);
 
 private:
+    friend class LruCacheByDataSizeStrategy;
+
     std::string m_key;
     size_t m_dataSize;
+    // links of the LRU list. they are not copied; a copy is not in any list.
+    CacheInfoWithDataSize* m_pNewer;
+    CacheInfoWithDataSize* m_pOlder;
 };
 
 } /* namespace common */
@@ -18,6 +18,7 @@
 #include "easyhttpcpp/common/Cache.h"
 #include "easyhttpcpp/common/CacheMetadata.h"
 #include "easyhttpcpp/common/CommonExports.h"
+#include "easyhttpcpp/common/StripedMutex.h"
 
 namespace easyhttpcpp {
 namespace common {
@@ -27,24 +28,37 @@ public:
     typedef Poco::AutoPtr<CacheManager> Ptr;
 
     CacheManager(Cache::Ptr pL1Cache, Cache::Ptr pL2Cache);
+    // data up to maxL1DataSize bytes found in L2 cache is copied to L1 cache.
+    CacheManager(Cache::Ptr pL1Cache, Cache::Ptr pL2Cache, size_t maxL1DataSize);
     virtual ~CacheManager();
     virtual bool getMetadata(const std::string& key, CacheMetadata::Ptr& pCacheMetadata);
     virtual bool getData(const std::string& key, std::istream*& pStream);
+    // cacheIndex is the index of the cache which served the data (0: L1, 1: L2); give it to releaseData.
+    virtual bool getData(const std::string& key, std::istream*& pStream, unsigned int& cacheIndex);
     virtual bool get(const std::string& key, CacheMetadata::Ptr& pCacheMetadata, std::istream*& pStream);
+    virtual bool get(const std::string& key, CacheMetadata::Ptr& pCacheMetadata, std::istream*& pStream,
+            unsigned int& cacheIndex);
     virtual bool putMetadata(const std::string& key, CacheMetadata::Ptr pCacheMetadata);
     virtual bool put(const std::string& key, CacheMetadata::Ptr pCacheMetadata, const std::string& path);
     virtual bool put(const std::string& key, CacheMetadata::Ptr pCacheMetadata,
             Poco::SharedPtr<ByteArrayBuffer> pData);
     virtual bool remove(const std::string& key);
+    // releases the data in every cache; data got with a cache index is released by releaseData(key, cacheIndex).
     virtual void releaseData(const std::string& key);
+    // releases the data only in the cache which served it, so that a reference taken by another reader of the
+    // other cache is kept.
+    virtual void releaseData(const std::string& key, unsigned int cacheIndex);
     virtual bool purge(bool mayDeleteIfBusy);
 
 private:
     void bringToL1Cache(const std::string& key);
+    Poco::SharedPtr<ByteArrayBuffer> readData(std::istream& stream);
     // 0 : L1 cache (suppose memory cache)
     // 1 : L2 cache (suppose file cache)
     Cache::Ptr m_caches[2];
-    Poco::FastMutex m_instanceMutex;
+    size_t m_maxL1DataSize;
+    // operations on different keys run in parallel; each cache keeps its own state consistent.
+    StripedMutex m_keyMutexes;
 };
 
 } /* namespace common */
@@ -7,6 +7,7 @@
 
 #include "Poco/File.h"
 #include "Poco/Path.h"
+#include "Poco/Types.h"
 
 #include "easyhttpcpp/common/CommonExports.h"
 
@@ -21,6 +22,18 @@ public:
     static bool moveFile(const Poco::File& sourceFile, const Poco::File& destinationFile);
     static std::string convertToAbsolutePathString(const std::string& path, bool extendedPrefix = false);
 
+    /**
+     * Reserves disk blocks for [offset, offset + length) of an existing file without changing its size.
+     * This is a hint only; false is returned when the platform or filesystem does not support it.
+     */
+    static bool preallocateFile(const Poco::File& file, Poco::UInt64 offset, Poco::UInt64 length);
+
+    /**
+     * Copies sourceFile to destinationFile, overwriting it. Uses a copy-on-write clone or an in-kernel copy when
+     * the platform supports it, so the data is not copied through user space.
+     */
+    static bool copyFile(const Poco::File& sourceFile, const Poco::File& destinationFile);
+
 private:
     FileUtil();
 };
@@ -0,0 +1,69 @@
+/*
+ * Copyright 2019 Sony Corporation
+ */
+
+#ifndef EASYHTTPCPP_COMMON_FREQUENCYSKETCH_H_INCLUDED
+#define EASYHTTPCPP_COMMON_FREQUENCYSKETCH_H_INCLUDED
+
+#include <string>
+#include <vector>
+
+#include "Poco/Types.h"
+
+#include "easyhttpcpp/common/CommonExports.h"
+
+namespace easyhttpcpp {
+namespace common {
+
+/**
+ * A count-min sketch which estimates how often keys were accessed recently, in a few bits per key.
+ * Counters saturate at MaxFrequency and are halved periodically, so that old accesses are forgotten.
+ */
+class EASYHTTPCPP_COMMON_API FrequencySketch {
+public:
+    static const unsigned int MaxFrequency = 15;
+
+    FrequencySketch(size_t expectedEntryCount);
+    virtual ~FrequencySketch();
+
+    /**
+     * Records an access to the key.
+     */
+    void increment(const std::string& key);
+
+    /**
+     * Returns the estimated access count of the key. It may be larger than the actual count, never smaller.
+     */
+    unsigned int frequency(const std::string& key) const;
+
+    /**
+     * Grows the sketch when more entries than it was made for are kept. recorded accesses are forgotten.
+     */
+    void ensureCapacity(size_t expectedEntryCount);
+
+    void clear();
+
+private:
+    FrequencySketch();
+    FrequencySketch(const FrequencySketch&);
+    FrequencySketch& operator=(const FrequencySketch&);
+
+    void resize(size_t expectedEntryCount);
+    size_t indexOf(Poco::UInt32 hash, size_t depth) const;
+    void halve();
+
+    static const size_t Depth = 4;
+    static const size_t MinWidth = 64;
+    static const size_t SampleSizeFactor = 10;
+
+    // Depth rows of m_width counters.
+    std::vector<unsigned char> m_counters;
+    size_t m_width;
+    size_t m_additionCount;
+    size_t m_sampleSize;
+};
+
+} /* namespace common */
+} /* namespace easyhttpcpp */
+
+#endif /* EASYHTTPCPP_COMMON_FREQUENCYSKETCH_H_INCLUDED */
@@ -31,6 +31,14 @@ public:
     virtual bool update(const std::string& key, CacheInfoWithDataSize::Ptr pCachInfo);
     virtual bool remove(const std::string& key);
     virtual CacheInfoWithDataSize::Ptr get(const std::string& key);
+
+    /**
+     * Same as get, but returns the entry kept by the strategy instead of a copy, so that nothing is allocated.
+     * The entry must not be modified; use update. It is valid until the key is updated or removed.
+     * @return NULL if not found.
+     */
+    virtual const CacheInfoWithDataSize* getView(const std::string& key);
+
     virtual bool clear(bool mayDeleteIfBusy);
     virtual void reset();
 
@@ -40,17 +48,26 @@ public:
     virtual bool isEmpty() const;
 
 protected:
-    typedef std::list<CacheInfoWithDataSize::Ptr> LruList;
-    typedef Poco::HashMap<std::string, LruList::iterator> LruListMap;
+    // the entries are linked through CacheInfoWithDataSize from m_pNewest to m_pOldest, so that moving an entry
+    // in the LRU list allocates nothing.
+    typedef Poco::HashMap<std::string, CacheInfoWithDataSize::Ptr> LruListMap;
     typedef std::list<std::string> LruKeyList;
 
     virtual bool createRemoveList(LruKeyList& keys, bool mayDeleteIfBusy);
     virtual bool createRemoveLruDataList(LruKeyList& keys, size_t removeSize);
     virtual CacheInfoWithDataSize::Ptr newCacheInfo(CacheInfoWithDataSize::Ptr pCacheInfo);
+    // copies pCacheInfo to the kept entry on update.
+    virtual void copyCacheInfo(CacheInfoWithDataSize& destination, const CacheInfoWithDataSize& source);
+    // makes the entry of the key the newest and returns it, or NULL if not found.
+    virtual CacheInfoWithDataSize* touch(const std::string& key);
+    // called after an entry is removed from the list, or after all entries are removed by reset.
+    virtual void onEntryRemoved(const std::string& key);
+    virtual void onAllEntriesRemoved();
 
     LruCacheByDataSizeStrategyListener* m_pListener;
-    LruList m_lruList;
     LruListMap m_lruListMap;
+    CacheInfoWithDataSize* m_pNewest;
+    CacheInfoWithDataSize* m_pOldest;
     size_t m_maxSize;
     size_t m_totalSize;
 
@@ -58,6 +75,9 @@ private:
     LruCacheByDataSizeStrategy();
     bool addOrUpdate(const std::string& key, CacheInfoWithDataSize::Ptr pCacheInfo);
     bool makeSpace(size_t requestSize, const std::string& updatedKey);
+    void linkNewest(CacheInfoWithDataSize* pCacheInfo);
+    void unlink(CacheInfoWithDataSize* pCacheInfo);
+    void unlinkAll();
 };
 
 } /* namespace common */
@@ -0,0 +1,58 @@
+/*
+ * Copyright 2019 Sony Corporation
+ */
+
+#ifndef EASYHTTPCPP_COMMON_MAPPEDFILE_H_INCLUDED
+#define EASYHTTPCPP_COMMON_MAPPEDFILE_H_INCLUDED
+
+#include <string>
+
+#include "Poco/AutoPtr.h"
+#include "Poco/File.h"
+#include "Poco/RefCountedObject.h"
+
+#include "easyhttpcpp/common/CommonExports.h"
+
+namespace easyhttpcpp {
+namespace common {
+
+/**
+ * A read-only memory mapping of a whole file.
+ * The file must not be truncated while it is mapped. Removing or replacing it is safe.
+ */
+class EASYHTTPCPP_COMMON_API MappedFile : public Poco::RefCountedObject {
+public:
+    typedef Poco::AutoPtr<MappedFile> Ptr;
+
+    enum AccessPattern {
+        AccessPatternNormal,
+        AccessPatternSequential
+    };
+
+    virtual ~MappedFile();
+
+    /**
+     * Maps file to memory.
+     * @param file file to map
+     * @param maxSize files larger than this are not mapped.
+     * @param accessPattern hint for read ahead
+     * @return MappedFile, or NULL if the file is empty, too large or the platform does not support mapping.
+     */
+    static MappedFile::Ptr map(const Poco::File& file, size_t maxSize, AccessPattern accessPattern);
+
+    const char* getData() const;
+    size_t getSize() const;
+
+private:
+    MappedFile(void* pAddress, size_t size);
+    MappedFile(const MappedFile&);
+    MappedFile& operator=(const MappedFile&);
+
+    void* m_pAddress;
+    size_t m_size;
+};
+
+} /* namespace common */
+} /* namespace easyhttpcpp */
+
+#endif /* EASYHTTPCPP_COMMON_MAPPEDFILE_H_INCLUDED */
@@ -0,0 +1,67 @@
+/*
+ * Copyright 2019 Sony Corporation
+ */
+
+#ifndef EASYHTTPCPP_COMMON_MAPPEDFILEINPUTSTREAM_H_INCLUDED
+#define EASYHTTPCPP_COMMON_MAPPEDFILEINPUTSTREAM_H_INCLUDED
+
+#include <istream>
+#include <streambuf>
+
+#include "easyhttpcpp/common/CommonExports.h"
+#include "easyhttpcpp/common/MappedFile.h"
+
+namespace easyhttpcpp {
+namespace common {
+
+/**
+ * A stream buffer which reads a MappedFile directly; there is no intermediate buffer.
+ */
+class EASYHTTPCPP_COMMON_API MappedFileStreamBuf : public std::streambuf {
+public:
+    MappedFileStreamBuf(MappedFile::Ptr pMappedFile);
+    virtual ~MappedFileStreamBuf();
+
+    /**
+     * Returns the unread part of the file and moves to the end.
+     */
+    void readRest(const char*& pData, size_t& size);
+
+protected:
+    virtual std::streamsize showmanyc();
+    virtual pos_type seekoff(off_type off, std::ios_base::seekdir dir,
+            std::ios_base::openmode which = std::ios_base::in | std::ios_base::out);
+    virtual pos_type seekpos(pos_type pos, std::ios_base::openmode which = std::ios_base::in | std::ios_base::out);
+
+private:
+    MappedFileStreamBuf(const MappedFileStreamBuf&);
+    MappedFileStreamBuf& operator=(const MappedFileStreamBuf&);
+
+    MappedFile::Ptr m_pMappedFile;
+};
+
+/**
+ * An input stream of a memory mapped file.
+ */
+class EASYHTTPCPP_COMMON_API MappedFileInputStream : public std::istream {
+public:
+    MappedFileInputStream(MappedFile::Ptr pMappedFile);
+    virtual ~MappedFileInputStream();
+
+    /**
+     * Returns the unread part of the file without copying it, and sets eof.
+     * The data is valid while this stream exists.
+     */
+    void readRest(const char*& pData, size_t& size);
+
+private:
+    MappedFileInputStream(const MappedFileInputStream&);
+    MappedFileInputStream& operator=(const MappedFileInputStream&);
+
+    MappedFileStreamBuf m_streamBuf;
+};
+
+} /* namespace common */
+} /* namespace easyhttpcpp */
+
+#endif /* EASYHTTPCPP_COMMON_MAPPEDFILEINPUTSTREAM_H_INCLUDED */
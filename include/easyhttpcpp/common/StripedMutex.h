@@ -0,0 +1,61 @@
+/*
+ * Copyright 2019 Sony Corporation
+ */
+
+#ifndef EASYHTTPCPP_COMMON_STRIPEDMUTEX_H_INCLUDED
+#define EASYHTTPCPP_COMMON_STRIPEDMUTEX_H_INCLUDED
+
+#include <string>
+
+#include "Poco/Mutex.h"
+
+#include "easyhttpcpp/common/CommonExports.h"
+
+namespace easyhttpcpp {
+namespace common {
+
+/**
+ * A fixed set of mutexes selected by the hash of a key.
+ * Operations on the same key take the same mutex, while operations on different keys usually do not wait for
+ * each other.
+ */
+class EASYHTTPCPP_COMMON_API StripedMutex {
+public:
+    StripedMutex();
+    virtual ~StripedMutex();
+
+    /**
+     * Returns the mutex of the key.
+     */
+    Poco::FastMutex& get(const std::string& key);
+
+    /**
+     * Locks all mutexes in a fixed order. Used by operations on all keys.
+     */
+    void lockAll();
+    void unlockAll();
+
+    class EASYHTTPCPP_COMMON_API ScopedLockAll {
+    public:
+        ScopedLockAll(StripedMutex& stripedMutex);
+        ~ScopedLockAll();
+    private:
+        ScopedLockAll();
+        ScopedLockAll(const ScopedLockAll&);
+        ScopedLockAll& operator=(const ScopedLockAll&);
+
+        StripedMutex& m_stripedMutex;
+    };
+
+private:
+    StripedMutex(const StripedMutex&);
+    StripedMutex& operator=(const StripedMutex&);
+
+    static const size_t StripeCount = 16;
+    Poco::FastMutex m_mutexes[StripeCount];
+};
+
+} /* namespace common */
+} /* namespace easyhttpcpp */
+
+#endif /* EASYHTTPCPP_COMMON_STRIPEDMUTEX_H_INCLUDED */
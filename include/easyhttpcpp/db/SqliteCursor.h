@@ -47,6 +47,8 @@ public:
     virtual unsigned long long optGetUnsignedLongLong(size_t columnIndex, unsigned long long defaultValue);
     virtual std::string getString(size_t columnIndex);
     virtual std::string optGetString(size_t columnIndex, const std::string& defaultValue);
+    // the value may contain NUL characters.
+    virtual std::string getBlob(size_t columnIndex);
     virtual CursorFieldType getType(size_t columnIndex);
     virtual bool isNull(size_t columnIndex);
     virtual bool move(int offset);
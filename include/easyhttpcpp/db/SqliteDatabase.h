@@ -5,6 +5,7 @@
 #ifndef EASYHTTPCPP_DB_SQLITEDATABASE_H_INCLUDED
 #define EASYHTTPCPP_DB_SQLITEDATABASE_H_INCLUDED
 
+#include <map>
 #include <string>
 #include <vector>
 
@@ -15,6 +16,7 @@
 #include "easyhttpcpp/db/DbExports.h"
 #include "easyhttpcpp/db/SqliteCursor.h"
 #include "easyhttpcpp/db/SqliteDatabaseCorruptionListener.h"
+#include "easyhttpcpp/db/SqliteStatement.h"
 
 namespace easyhttpcpp {
 namespace db {
@@ -35,6 +37,26 @@ public:
         AutoVacuumIncremental
     };
 
+    enum JournalMode {
+        JournalModeDelete,
+        JournalModeTruncate,
+        JournalModePersist,
+        JournalModeMemory,
+        JournalModeWal,
+        JournalModeOff
+    };
+
+    enum Synchronous {
+        // 0 means no sync
+        SynchronousOff,
+        // 1 means sync at critical moments only; with WAL, durable except the last transactions on power loss
+        SynchronousNormal,
+        // 2 means sync on every transaction
+        SynchronousFull,
+        // 3 means sync on every transaction and directory
+        SynchronousExtra
+    };
+
     SqliteDatabase(const std::string& path);
 
     virtual ~SqliteDatabase();
@@ -50,6 +72,27 @@ public:
 
     virtual SqliteCursor::Ptr rawQuery(const std::string& sql, const std::vector<std::string>* selectionArgs);
 
+    /**
+     * Compiles sql and caches it while the database session is open.
+     * @return the cached statement for the same sql if exists
+     * @exception SqlIllegalStateException, SqlExecutionException
+     */
+    virtual SqliteStatement::Ptr compileStatement(const std::string& sql);
+
+    /**
+     * Executes the compiled query statement with the bound parameters.
+     * Returned cursor is valid until the statement is executed again.
+     * @exception SqlIllegalStateException, SqlExecutionException, SqlDatabaseCorruptException
+     */
+    virtual SqliteCursor::Ptr queryStatement(SqliteStatement::Ptr pStatement);
+
+    /**
+     * Executes the compiled INSERT, UPDATE or DELETE statement with the bound parameters.
+     * @return affected row count
+     * @exception SqlIllegalStateException, SqlExecutionException, SqlDatabaseCorruptException
+     */
+    virtual size_t executeUpdateDelete(SqliteStatement::Ptr pStatement);
+
     virtual void insert(const std::string& table, const ContentValues& values);
 
     virtual void replace(const std::string& table, const ContentValues& initialValues);
@@ -78,6 +121,39 @@ public:
 
     virtual void setAutoVacuum(AutoVacuum autoVacuum);
 
+    virtual JournalMode getJournalMode();
+
+    /**
+     * Sets journal mode. journal mode can not be changed in a transaction.
+     * the actual mode might differ when the file system does not support the mode; check by getJournalMode().
+     */
+    virtual void setJournalMode(JournalMode journalMode);
+
+    virtual Synchronous getSynchronous();
+
+    virtual void setSynchronous(Synchronous synchronous);
+
+    virtual int getCacheSize();
+
+    /**
+     * Sets page cache size of this session. positive value is in pages and negative value is in KiB.
+     */
+    virtual void setCacheSize(int cacheSize);
+
+    virtual long long getMmapSize();
+
+    /**
+     * Sets maximum bytes of the database file mapped to memory. 0 disables memory mapped I/O.
+     */
+    virtual void setMmapSize(long long mmapSize);
+
+    virtual unsigned int getBusyTimeout();
+
+    /**
+     * Sets milliseconds to wait for a lock held by another connection before failing with busy.
+     */
+    virtual void setBusyTimeout(unsigned int busyTimeoutMs);
+
     virtual bool isOpen();
 
     virtual void reopen();
@@ -85,7 +161,10 @@ public:
     virtual void setDatabaseCorruptionListener(SqliteDatabaseCorruptionListener::Ptr pListener);
 
 private:
+    typedef std::map<std::string, SqliteStatement::Ptr> StatementMap;
+
     Poco::SharedPtr<Poco::Data::Session> m_pSession;
+    StatementMap m_statements;
     Poco::FastMutex m_mutex;
     SqliteDatabaseCorruptionListener::Ptr m_pDatabaseCorruptionListener;
     std::string m_path;
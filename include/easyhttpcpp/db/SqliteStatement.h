@@ -0,0 +1,78 @@
+/*
+ * Copyright 2019 Sony Corporation
+ */
+
+#ifndef EASYHTTPCPP_DB_SQLITESTATEMENT_H_INCLUDED
+#define EASYHTTPCPP_DB_SQLITESTATEMENT_H_INCLUDED
+
+#include <string>
+#include <vector>
+
+#include "Poco/AutoPtr.h"
+#include "Poco/RefCountedObject.h"
+#include "Poco/SharedPtr.h"
+#include "Poco/Data/Session.h"
+#include "Poco/Data/Statement.h"
+#include "Poco/Dynamic/Var.h"
+
+#include "easyhttpcpp/db/DbExports.h"
+
+namespace easyhttpcpp {
+namespace db {
+
+/**
+ * A compiled SQL statement which can be executed repeatedly with different parameters.
+ * Create it by SqliteDatabase::compileStatement and execute it by SqliteDatabase::queryStatement or
+ * SqliteDatabase::executeUpdateDelete. The statement is valid while the database session is open.
+ */
+class EASYHTTPCPP_DB_API SqliteStatement : public Poco::RefCountedObject {
+public:
+    typedef Poco::AutoPtr<SqliteStatement> Ptr;
+
+    SqliteStatement(Poco::Data::Session& session, const std::string& sql);
+    virtual ~SqliteStatement();
+
+    const std::string& getSql() const;
+    size_t getParameterCount() const;
+
+    /**
+     * Binds a string to the parameter (0-based index).
+     * @exception SqlIllegalArgumentException
+     */
+    void bindString(size_t index, const std::string& value);
+
+    /**
+     * Binds an integer to the parameter (0-based index).
+     * @exception SqlIllegalArgumentException
+     */
+    void bindLongLong(size_t index, long long value);
+
+    /**
+     * Binds binary data to the parameter (0-based index). The data may contain NUL characters.
+     * @exception SqlIllegalArgumentException
+     */
+    void bindBlob(size_t index, const std::string& value);
+
+    /**
+     * Executes the statement with the bound parameters.
+     * @return affected row count or extracted row count
+     * @exception Poco::Exception
+     */
+    size_t execute();
+
+    Poco::Data::Statement& getStatement();
+
+private:
+    SqliteStatement();
+    void throwExceptionIfIllegalIndex(size_t index) const;
+
+    std::string m_sql;
+    // bound by reference to m_pStatement. size is fixed on construction.
+    std::vector<Poco::Dynamic::Var> m_parameters;
+    Poco::SharedPtr<Poco::Data::Statement> m_pStatement;
+};
+
+} /* namespace db */
+} /* namespace easyhttpcpp */
+
+#endif /* EASYHTTPCPP_DB_SQLITESTATEMENT_H_INCLUDED */
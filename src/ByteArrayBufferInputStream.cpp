@@ -0,0 +1,56 @@
+/*
+ * Copyright 2019 Sony Corporation
+ */
+
+#include "ByteArrayBufferInputStream.h"
+
+using easyhttpcpp::common::ByteArrayBuffer;
+
+namespace easyhttpcpp {
+
+ByteArrayBufferStreamBuf::ByteArrayBufferStreamBuf(Poco::SharedPtr<ByteArrayBuffer> pBuffer) : m_pBuffer(pBuffer)
+{
+    char* pBegin = reinterpret_cast<char*>(m_pBuffer->getBuffer());
+    setg(pBegin, pBegin, pBegin + m_pBuffer->getWrittenDataSize());
+}
+
+ByteArrayBufferStreamBuf::~ByteArrayBufferStreamBuf()
+{
+}
+
+ByteArrayBufferStreamBuf::pos_type ByteArrayBufferStreamBuf::seekoff(off_type off, std::ios_base::seekdir dir,
+        std::ios_base::openmode which)
+{
+    if ((which & std::ios_base::in) == 0) {
+        return pos_type(off_type(-1));
+    }
+    off_type base = 0;
+    if (dir == std::ios_base::cur) {
+        base = gptr() - eback();
+    } else if (dir == std::ios_base::end) {
+        base = egptr() - eback();
+    }
+    off_type newPos = base + off;
+    if (newPos < 0 || egptr() - eback() < newPos) {
+        return pos_type(off_type(-1));
+    }
+    setg(eback(), eback() + newPos, egptr());
+    return pos_type(newPos);
+}
+
+ByteArrayBufferStreamBuf::pos_type ByteArrayBufferStreamBuf::seekpos(pos_type pos, std::ios_base::openmode which)
+{
+    return seekoff(off_type(pos), std::ios_base::beg, which);
+}
+
+ByteArrayBufferInputStream::ByteArrayBufferInputStream(Poco::SharedPtr<ByteArrayBuffer> pBuffer) :
+        std::istream(NULL), m_streamBuf(pBuffer)
+{
+    init(&m_streamBuf);
+}
+
+ByteArrayBufferInputStream::~ByteArrayBufferInputStream()
+{
+}
+
+} /* namespace easyhttpcpp */
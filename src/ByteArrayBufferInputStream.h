@@ -0,0 +1,43 @@
+/*
+ * Copyright 2019 Sony Corporation
+ */
+
+#ifndef EASYHTTPCPP_BYTEARRAYBUFFERINPUTSTREAM_H_INCLUDED
+#define EASYHTTPCPP_BYTEARRAYBUFFERINPUTSTREAM_H_INCLUDED
+
+#include <istream>
+#include <streambuf>
+
+#include "Poco/SharedPtr.h"
+
+#include "easyhttpcpp/common/ByteArrayBuffer.h"
+#include "easyhttpcpp/HttpExports.h"
+
+namespace easyhttpcpp {
+
+class EASYHTTPCPP_HTTP_INTERNAL_API ByteArrayBufferStreamBuf : public std::streambuf {
+public:
+    ByteArrayBufferStreamBuf(Poco::SharedPtr<easyhttpcpp::common::ByteArrayBuffer> pBuffer);
+    virtual ~ByteArrayBufferStreamBuf();
+
+protected:
+    virtual pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which);
+    virtual pos_type seekpos(pos_type pos, std::ios_base::openmode which);
+
+private:
+    Poco::SharedPtr<easyhttpcpp::common::ByteArrayBuffer> m_pBuffer;
+};
+
+// reads the written data of a ByteArrayBuffer without copying. the buffer is kept alive while the stream exists.
+class EASYHTTPCPP_HTTP_INTERNAL_API ByteArrayBufferInputStream : public std::istream {
+public:
+    ByteArrayBufferInputStream(Poco::SharedPtr<easyhttpcpp::common::ByteArrayBuffer> pBuffer);
+    virtual ~ByteArrayBufferInputStream();
+
+private:
+    ByteArrayBufferStreamBuf m_streamBuf;
+};
+
+} /* namespace easyhttpcpp */
+
+#endif /* EASYHTTPCPP_BYTEARRAYBUFFERINPUTSTREAM_H_INCLUDED */
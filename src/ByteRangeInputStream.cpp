@@ -0,0 +1,47 @@
+/*
+ * Copyright 2019 Sony Corporation
+ */
+
+#include "ByteRangeInputStream.h"
+
+namespace easyhttpcpp {
+
+static const std::streamsize ByteRangeBufferBytes = 8192;
+
+ByteRangeStreamBuf::ByteRangeStreamBuf(std::istream& source, Poco::UInt64 length) :
+        Poco::BufferedStreamBuf(ByteRangeBufferBytes, std::ios::in), m_source(source), m_remainingBytes(length)
+{
+}
+
+ByteRangeStreamBuf::~ByteRangeStreamBuf()
+{
+}
+
+int ByteRangeStreamBuf::readFromDevice(char* pBuffer, std::streamsize length)
+{
+    if (m_remainingBytes == 0 || !m_source) {
+        return -1;
+    }
+    std::streamsize readBytes = m_remainingBytes < static_cast<Poco::UInt64>(length) ?
+            static_cast<std::streamsize>(m_remainingBytes) : length;
+    m_source.read(pBuffer, readBytes);
+    std::streamsize retBytes = m_source.gcount();
+    if (retBytes <= 0) {
+        return -1;
+    }
+    m_remainingBytes -= retBytes;
+    return static_cast<int>(retBytes);
+}
+
+ByteRangeInputStream::ByteRangeInputStream(std::istream* pSource, Poco::UInt64 length) : std::istream(NULL),
+        m_pSource(pSource), m_streamBuf(*pSource, length)
+{
+    init(&m_streamBuf);
+}
+
+ByteRangeInputStream::~ByteRangeInputStream()
+{
+    delete m_pSource;
+}
+
+} /* namespace easyhttpcpp */
@@ -0,0 +1,43 @@
+/*
+ * Copyright 2019 Sony Corporation
+ */
+
+#ifndef EASYHTTPCPP_BYTERANGEINPUTSTREAM_H_INCLUDED
+#define EASYHTTPCPP_BYTERANGEINPUTSTREAM_H_INCLUDED
+
+#include <istream>
+
+#include "Poco/BufferedStreamBuf.h"
+#include "Poco/Types.h"
+
+#include "easyhttpcpp/HttpExports.h"
+
+namespace easyhttpcpp {
+
+class EASYHTTPCPP_HTTP_INTERNAL_API ByteRangeStreamBuf : public Poco::BufferedStreamBuf {
+public:
+    ByteRangeStreamBuf(std::istream& source, Poco::UInt64 length);
+    virtual ~ByteRangeStreamBuf();
+
+protected:
+    virtual int readFromDevice(char* pBuffer, std::streamsize length);
+
+private:
+    std::istream& m_source;
+    Poco::UInt64 m_remainingBytes;
+};
+
+// reads at most length bytes of pSource from its current position. pSource is deleted with this stream.
+class EASYHTTPCPP_HTTP_INTERNAL_API ByteRangeInputStream : public std::istream {
+public:
+    ByteRangeInputStream(std::istream* pSource, Poco::UInt64 length);
+    virtual ~ByteRangeInputStream();
+
+private:
+    std::istream* m_pSource;
+    ByteRangeStreamBuf m_streamBuf;
+};
+
+} /* namespace easyhttpcpp */
+
+#endif /* EASYHTTPCPP_BYTERANGEINPUTSTREAM_H_INCLUDED */
@@ -23,6 +23,8 @@ CacheControl::CacheControl(CacheControl::Builder& builder)
     m_maxStaleSec = builder.getMaxStaleSec();
     m_minFreshSec = builder.getMinFreshSec();
     m_sMaxAgeSec = builder.getSMaxAgeSec();
+    m_staleWhileRevalidateSec = builder.getStaleWhileRevalidateSec();
+    m_staleIfErrorSec = builder.getStaleIfErrorSec();
     m_mustRevalidate = builder.isMustRevalidate();
     m_noCache = builder.isNoCache();
     m_noStore = builder.isNoStore();
@@ -103,6 +105,10 @@ CacheControl::Ptr CacheControl::createFromHeaders(Headers::Ptr pHeaders)
                 builder.setMaxAgeSec(parseNumber(parameter, -1LL));
             } else if (Poco::icompare(directive, HttpConstants::CacheDirectives::SMaxAge) == 0) {
                 builder.setSMaxAgeSec(parseNumber(parameter, -1LL));
+            } else if (Poco::icompare(directive, HttpConstants::CacheDirectives::StaleWhileRevalidate) == 0) {
+                builder.setStaleWhileRevalidateSec(parseNumber(parameter, -1LL));
+            } else if (Poco::icompare(directive, HttpConstants::CacheDirectives::StaleIfError) == 0) {
+                builder.setStaleIfErrorSec(parseNumber(parameter, -1LL));
             } else if (Poco::icompare(directive, HttpConstants::CacheDirectives::MaxStale) == 0) {
                 builder.setMaxStaleSec(parseNumber(parameter, -1LL));
             } else if (Poco::icompare(directive, HttpConstants::CacheDirectives::MinFresh) == 0) {
@@ -147,6 +153,16 @@ long long CacheControl::getSMaxAgeSec() const
     return m_sMaxAgeSec;
 }
 
+long long CacheControl::getStaleWhileRevalidateSec() const
+{
+    return m_staleWhileRevalidateSec;
+}
+
+long long CacheControl::getStaleIfErrorSec() const
+{
+    return m_staleIfErrorSec;
+}
+
 bool CacheControl::isMustRevalidate() const
 {
     return m_mustRevalidate;
@@ -202,8 +218,8 @@ long long CacheControl::parseNumber(const std::string& parameter, long long defa
 }
 
 CacheControl::Builder::Builder() : m_maxAgeSec(-1), m_maxStaleSec(-1), m_minFreshSec(-1), m_sMaxAgeSec(-1),
-        m_mustRevalidate(false), m_noCache(false), m_noStore(false), m_noTransform(false), m_onlyIfCached(false),
-        m_public(false), m_private(false)
+        m_staleWhileRevalidateSec(-1), m_staleIfErrorSec(-1), m_mustRevalidate(false), m_noCache(false),
+        m_noStore(false), m_noTransform(false), m_onlyIfCached(false), m_public(false), m_private(false)
 {
 }
 
@@ -260,6 +276,28 @@ long long CacheControl::Builder::getSMaxAgeSec() const
     return m_sMaxAgeSec;
 }
 
+CacheControl::Builder& CacheControl::Builder::setStaleWhileRevalidateSec(long long staleWhileRevalidateSec)
+{
+    m_staleWhileRevalidateSec = staleWhileRevalidateSec;
+    return *this;
+}
+
+long long CacheControl::Builder::getStaleWhileRevalidateSec() const
+{
+    return m_staleWhileRevalidateSec;
+}
+
+CacheControl::Builder& CacheControl::Builder::setStaleIfErrorSec(long long staleIfErrorSec)
+{
+    m_staleIfErrorSec = staleIfErrorSec;
+    return *this;
+}
+
+long long CacheControl::Builder::getStaleIfErrorSec() const
+{
+    return m_staleIfErrorSec;
+}
+
 CacheControl::Builder& CacheControl::Builder::setMustRevalidate(bool mustRevalidate)
 {
     m_mustRevalidate = mustRevalidate;
@@ -0,0 +1,68 @@
+/*
+ * Copyright 2019 Sony Corporation
+ */
+
+#include "Poco/Exception.h"
+
+#include "easyhttpcpp/common/CoreLogger.h"
+
+#include "ContentDecodingInputStream.h"
+#include "HttpInternalConstants.h"
+
+namespace easyhttpcpp {
+
+static const std::string Tag = "ContentDecodingInputStream";
+
+ContentDecodingStreamBuf::ContentDecodingStreamBuf(std::istream& source, Poco::InflatingStreamBuf::StreamType type) :
+        Poco::BufferedStreamBuf(HttpInternalConstants::ContentEncodings::DecodingBufferBytes, std::ios::in),
+        m_source(source), m_inflatingStream(source, type)
+{
+}
+
+ContentDecodingStreamBuf::ContentDecodingStreamBuf(std::istream* pSource, Poco::InflatingStreamBuf::StreamType type) :
+        Poco::BufferedStreamBuf(HttpInternalConstants::ContentEncodings::DecodingBufferBytes, std::ios::in),
+        m_pOwnedSource(pSource), m_source(*pSource), m_inflatingStream(*pSource, type)
+{
+}
+
+ContentDecodingStreamBuf::~ContentDecodingStreamBuf()
+{
+}
+
+int ContentDecodingStreamBuf::readFromDevice(char* pBuffer, std::streamsize length)
+{
+    m_inflatingStream.read(pBuffer, length);
+    std::streamsize retBytes = m_inflatingStream.gcount();
+    if (retBytes > 0) {
+        return static_cast<int>(retBytes);
+    }
+    if (m_inflatingStream.bad()) {
+        // broken or truncated compressed data.
+        EASYHTTPCPP_LOG_D(Tag, "readFromDevice: can not decompress response body.");
+        throw Poco::IOException("can not decompress response body.");
+    }
+
+    // skip trailing bytes after the compressed data.
+    while (m_source.good()) {
+        m_source.read(pBuffer, length);
+    }
+    return -1;
+}
+
+ContentDecodingInputStream::ContentDecodingInputStream(std::istream& source,
+        Poco::InflatingStreamBuf::StreamType type) : std::istream(NULL), m_streamBuf(source, type)
+{
+    init(&m_streamBuf);
+}
+
+ContentDecodingInputStream::ContentDecodingInputStream(std::istream* pSource,
+        Poco::InflatingStreamBuf::StreamType type) : std::istream(NULL), m_streamBuf(pSource, type)
+{
+    init(&m_streamBuf);
+}
+
+ContentDecodingInputStream::~ContentDecodingInputStream()
+{
+}
+
+} /* namespace easyhttpcpp */
@@ -0,0 +1,50 @@
+/*
+ * Copyright 2019 Sony Corporation
+ */
+
+#ifndef EASYHTTPCPP_CONTENTDECODINGINPUTSTREAM_H_INCLUDED
+#define EASYHTTPCPP_CONTENTDECODINGINPUTSTREAM_H_INCLUDED
+
+#include <istream>
+
+#include "Poco/BufferedStreamBuf.h"
+#include "Poco/InflatingStream.h"
+#include "Poco/SharedPtr.h"
+
+#include "easyhttpcpp/HttpExports.h"
+
+namespace easyhttpcpp {
+
+class EASYHTTPCPP_HTTP_INTERNAL_API ContentDecodingStreamBuf : public Poco::BufferedStreamBuf {
+public:
+    ContentDecodingStreamBuf(std::istream& source, Poco::InflatingStreamBuf::StreamType type);
+    // pSource is deleted with the stream buffer.
+    ContentDecodingStreamBuf(std::istream* pSource, Poco::InflatingStreamBuf::StreamType type);
+    virtual ~ContentDecodingStreamBuf();
+
+protected:
+    virtual int readFromDevice(char* pBuffer, std::streamsize length);
+
+private:
+    // declared first, so that it is deleted after m_inflatingStream.
+    Poco::SharedPtr<std::istream> m_pOwnedSource;
+    std::istream& m_source;
+    Poco::InflatingInputStream m_inflatingStream;
+};
+
+// decompresses source. after the end of the compressed data, the rest of source is read and discarded so that
+// the connection (e.g. the last chunk) and the cache see the end of the response body.
+class EASYHTTPCPP_HTTP_INTERNAL_API ContentDecodingInputStream : public std::istream {
+public:
+    ContentDecodingInputStream(std::istream& source, Poco::InflatingStreamBuf::StreamType type);
+    // pSource is deleted with the stream.
+    ContentDecodingInputStream(std::istream* pSource, Poco::InflatingStreamBuf::StreamType type);
+    virtual ~ContentDecodingInputStream();
+
+private:
+    ContentDecodingStreamBuf m_streamBuf;
+};
+
+} /* namespace easyhttpcpp */
+
+#endif /* EASYHTTPCPP_CONTENTDECODINGINPUTSTREAM_H_INCLUDED */
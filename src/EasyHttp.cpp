@@ -26,10 +26,17 @@ EasyHttp::~EasyHttp()
 }
 
 EasyHttp::Builder::Builder() : m_timeoutSec(EasyHttpContext::DefaultTimeoutSec),
-        m_crlCheckPolicy(CrlCheckPolicyNoCheck),
+        m_crlCheckPolicy(CrlCheckPolicyNoCheck), m_contentEncodingPolicy(ContentEncodingPolicyIdentity),
+        m_requestCoalescingEnabled(false),
+        m_requestCoalescingTimeoutMillis(HttpInternalConstants::RequestCoalescings::DefaultTimeoutMillis),
+        m_cacheFillPolicy(CacheFillPolicyDiscardOnClose),
+        m_backgroundCacheFillMaxBytes(HttpInternalConstants::BackgroundCacheFills::DefaultMaxBytes),
+        m_backgroundCacheFillTimeoutSec(HttpInternalConstants::BackgroundCacheFills::DefaultTimeoutSec),
         m_corePoolSizeOfAsyncThreadPool(HttpInternalConstants::AsyncRequests::DefaultCorePoolSizeOfAsyncThreadPool),
         m_maximumPoolSizeOfAsyncThreadPool(
-                HttpInternalConstants::AsyncRequests::DefaultMaximumPoolSizeOfAsyncThreadPool)
+                HttpInternalConstants::AsyncRequests::DefaultMaximumPoolSizeOfAsyncThreadPool),
+        m_maxConcurrentPrefetchCount(HttpInternalConstants::Prefetches::DefaultMaxConcurrentPrefetchCount),
+        m_prefetchBytesPerSec(0)
 
 {
 }
@@ -127,6 +134,82 @@ CrlCheckPolicy EasyHttp::Builder::getCrlCheckPolicy() const
     return m_crlCheckPolicy;
 }
 
+EasyHttp::Builder& EasyHttp::Builder::setContentEncodingPolicy(ContentEncodingPolicy contentEncodingPolicy)
+{
+    m_contentEncodingPolicy = contentEncodingPolicy;
+    return *this;
+}
+
+ContentEncodingPolicy EasyHttp::Builder::getContentEncodingPolicy() const
+{
+    return m_contentEncodingPolicy;
+}
+
+EasyHttp::Builder& EasyHttp::Builder::setRequestCoalescingEnabled(bool requestCoalescingEnabled)
+{
+    m_requestCoalescingEnabled = requestCoalescingEnabled;
+    return *this;
+}
+
+bool EasyHttp::Builder::isRequestCoalescingEnabled() const
+{
+    return m_requestCoalescingEnabled;
+}
+
+EasyHttp::Builder& EasyHttp::Builder::setRequestCoalescingTimeoutMillis(unsigned int requestCoalescingTimeoutMillis)
+{
+    if (requestCoalescingTimeoutMillis == 0) {
+        std::string message = "can not set 0 to request coalescing timeout.";
+        EASYHTTPCPP_LOG_D(Tag, "%s", message.c_str());
+        throw HttpIllegalArgumentException(message);
+    }
+    m_requestCoalescingTimeoutMillis = requestCoalescingTimeoutMillis;
+    return *this;
+}
+
+unsigned int EasyHttp::Builder::getRequestCoalescingTimeoutMillis() const
+{
+    return m_requestCoalescingTimeoutMillis;
+}
+
+EasyHttp::Builder& EasyHttp::Builder::setCacheFillPolicy(CacheFillPolicy cacheFillPolicy)
+{
+    m_cacheFillPolicy = cacheFillPolicy;
+    return *this;
+}
+
+CacheFillPolicy EasyHttp::Builder::getCacheFillPolicy() const
+{
+    return m_cacheFillPolicy;
+}
+
+EasyHttp::Builder& EasyHttp::Builder::setBackgroundCacheFillMaxBytes(Poco::UInt64 backgroundCacheFillMaxBytes)
+{
+    m_backgroundCacheFillMaxBytes = backgroundCacheFillMaxBytes;
+    return *this;
+}
+
+Poco::UInt64 EasyHttp::Builder::getBackgroundCacheFillMaxBytes() const
+{
+    return m_backgroundCacheFillMaxBytes;
+}
+
+EasyHttp::Builder& EasyHttp::Builder::setBackgroundCacheFillTimeoutSec(unsigned int backgroundCacheFillTimeoutSec)
+{
+    if (backgroundCacheFillTimeoutSec == 0) {
+        std::string message = "can not set 0 to background cache fill timeout.";
+        EASYHTTPCPP_LOG_D(Tag, "%s", message.c_str());
+        throw HttpIllegalArgumentException(message);
+    }
+    m_backgroundCacheFillTimeoutSec = backgroundCacheFillTimeoutSec;
+    return *this;
+}
+
+unsigned int EasyHttp::Builder::getBackgroundCacheFillTimeoutSec() const
+{
+    return m_backgroundCacheFillTimeoutSec;
+}
+
 EasyHttp::Builder& EasyHttp::Builder::addInterceptor(Interceptor::Ptr pInterceptor)
 {
     m_callInterceptors.push_back(pInterceptor);
@@ -183,4 +266,31 @@ unsigned int EasyHttp::Builder::getMaximumPoolSizeOfAsyncThreadPool() const
     return m_maximumPoolSizeOfAsyncThreadPool;
 }
 
+EasyHttp::Builder& EasyHttp::Builder::setMaxConcurrentPrefetchCount(unsigned int maxConcurrentPrefetchCount)
+{
+    if (maxConcurrentPrefetchCount == 0) {
+        std::string message = "can not set 0 to max concurrent prefetch count.";
+        EASYHTTPCPP_LOG_D(Tag, "%s", message.c_str());
+        throw HttpIllegalArgumentException(message);
+    }
+    m_maxConcurrentPrefetchCount = maxConcurrentPrefetchCount;
+    return *this;
+}
+
+unsigned int EasyHttp::Builder::getMaxConcurrentPrefetchCount() const
+{
+    return m_maxConcurrentPrefetchCount;
+}
+
+EasyHttp::Builder& EasyHttp::Builder::setPrefetchBytesPerSec(Poco::UInt64 prefetchBytesPerSec)
+{
+    m_prefetchBytesPerSec = prefetchBytesPerSec;
+    return *this;
+}
+
+Poco::UInt64 EasyHttp::Builder::getPrefetchBytesPerSec() const
+{
+    return m_prefetchBytesPerSec;
+}
+
 } /* namespace easyhttpcpp */
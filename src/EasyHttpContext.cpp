@@ -6,12 +6,18 @@
 #include "Poco/Net/SSLManager.h"
 
 #include "EasyHttpContext.h"
+#include "HttpInternalConstants.h"
 
 namespace easyhttpcpp {
 
 const unsigned int EasyHttpContext::DefaultTimeoutSec = 60;
 
-EasyHttpContext::EasyHttpContext() : m_timeoutSec(DefaultTimeoutSec), m_crlCheckPolicy(CrlCheckPolicyNoCheck)
+EasyHttpContext::EasyHttpContext() : m_timeoutSec(DefaultTimeoutSec), m_crlCheckPolicy(CrlCheckPolicyNoCheck),
+        m_contentEncodingPolicy(ContentEncodingPolicyIdentity), m_requestCoalescingEnabled(false),
+        m_requestCoalescingTimeoutMillis(HttpInternalConstants::RequestCoalescings::DefaultTimeoutMillis),
+        m_cacheFillPolicy(CacheFillPolicyDiscardOnClose),
+        m_backgroundCacheFillMaxBytes(HttpInternalConstants::BackgroundCacheFills::DefaultMaxBytes),
+        m_backgroundCacheFillTimeoutSec(HttpInternalConstants::BackgroundCacheFills::DefaultTimeoutSec)
 {
 }
 
@@ -81,6 +87,66 @@ CrlCheckPolicy EasyHttpContext::getCrlCheckPolicy() const
     return m_crlCheckPolicy;
 }
 
+void EasyHttpContext::setContentEncodingPolicy(ContentEncodingPolicy contentEncodingPolicy)
+{
+    m_contentEncodingPolicy = contentEncodingPolicy;
+}
+
+ContentEncodingPolicy EasyHttpContext::getContentEncodingPolicy() const
+{
+    return m_contentEncodingPolicy;
+}
+
+void EasyHttpContext::setRequestCoalescingEnabled(bool requestCoalescingEnabled)
+{
+    m_requestCoalescingEnabled = requestCoalescingEnabled;
+}
+
+bool EasyHttpContext::isRequestCoalescingEnabled() const
+{
+    return m_requestCoalescingEnabled;
+}
+
+void EasyHttpContext::setRequestCoalescingTimeoutMillis(unsigned int requestCoalescingTimeoutMillis)
+{
+    m_requestCoalescingTimeoutMillis = requestCoalescingTimeoutMillis;
+}
+
+unsigned int EasyHttpContext::getRequestCoalescingTimeoutMillis() const
+{
+    return m_requestCoalescingTimeoutMillis;
+}
+
+void EasyHttpContext::setCacheFillPolicy(CacheFillPolicy cacheFillPolicy)
+{
+    m_cacheFillPolicy = cacheFillPolicy;
+}
+
+CacheFillPolicy EasyHttpContext::getCacheFillPolicy() const
+{
+    return m_cacheFillPolicy;
+}
+
+void EasyHttpContext::setBackgroundCacheFillMaxBytes(Poco::UInt64 backgroundCacheFillMaxBytes)
+{
+    m_backgroundCacheFillMaxBytes = backgroundCacheFillMaxBytes;
+}
+
+Poco::UInt64 EasyHttpContext::getBackgroundCacheFillMaxBytes() const
+{
+    return m_backgroundCacheFillMaxBytes;
+}
+
+void EasyHttpContext::setBackgroundCacheFillTimeoutSec(unsigned int backgroundCacheFillTimeoutSec)
+{
+    m_backgroundCacheFillTimeoutSec = backgroundCacheFillTimeoutSec;
+}
+
+unsigned int EasyHttpContext::getBackgroundCacheFillTimeoutSec() const
+{
+    return m_backgroundCacheFillTimeoutSec;
+}
+
 void EasyHttpContext::setCallInterceptors(EasyHttpContext::InterceptorList& interceptors)
 {
     m_callInterceptors = interceptors;
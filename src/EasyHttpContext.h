@@ -10,8 +10,11 @@
 
 #include "Poco/AutoPtr.h"
 #include "Poco/RefCountedObject.h"
+#include "Poco/Types.h"
 
+#include "easyhttpcpp/CacheFillPolicy.h"
 #include "easyhttpcpp/ConnectionPool.h"
+#include "easyhttpcpp/ContentEncodingPolicy.h"
 #include "easyhttpcpp/CrlCheckPolicy.h"
 #include "easyhttpcpp/HttpCache.h"
 #include "easyhttpcpp/HttpExports.h"
@@ -41,6 +44,18 @@ public:
     virtual const std::string& getRootCaFile() const;
     virtual void setCrlCheckPolicy(CrlCheckPolicy crlCheckPolicy);
     virtual CrlCheckPolicy getCrlCheckPolicy() const;
+    virtual void setContentEncodingPolicy(ContentEncodingPolicy contentEncodingPolicy);
+    virtual ContentEncodingPolicy getContentEncodingPolicy() const;
+    virtual void setRequestCoalescingEnabled(bool requestCoalescingEnabled);
+    virtual bool isRequestCoalescingEnabled() const;
+    virtual void setRequestCoalescingTimeoutMillis(unsigned int requestCoalescingTimeoutMillis);
+    virtual unsigned int getRequestCoalescingTimeoutMillis() const;
+    virtual void setCacheFillPolicy(CacheFillPolicy cacheFillPolicy);
+    virtual CacheFillPolicy getCacheFillPolicy() const;
+    virtual void setBackgroundCacheFillMaxBytes(Poco::UInt64 backgroundCacheFillMaxBytes);
+    virtual Poco::UInt64 getBackgroundCacheFillMaxBytes() const;
+    virtual void setBackgroundCacheFillTimeoutSec(unsigned int backgroundCacheFillTimeoutSec);
+    virtual unsigned int getBackgroundCacheFillTimeoutSec() const;
     virtual void setCallInterceptors(InterceptorList& interceptors);
     virtual InterceptorList& getCallInterceptors();
     virtual void setNetworkInterceptors(InterceptorList& interceptors);
@@ -59,6 +74,12 @@ private:
     std::string m_rootCaDirectory;
     std::string m_rootCaFile;
     CrlCheckPolicy m_crlCheckPolicy;
+    ContentEncodingPolicy m_contentEncodingPolicy;
+    bool m_requestCoalescingEnabled;
+    unsigned int m_requestCoalescingTimeoutMillis;
+    CacheFillPolicy m_cacheFillPolicy;
+    Poco::UInt64 m_backgroundCacheFillMaxBytes;
+    unsigned int m_backgroundCacheFillTimeoutSec;
     InterceptorList m_callInterceptors;
     InterceptorList m_networkInterceptors;
     ConnectionPool::Ptr m_pConnectionPool;
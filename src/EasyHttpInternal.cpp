@@ -6,6 +6,7 @@
 
 #include "CallInternal.h"
 #include "EasyHttpInternal.h"
+#include "HttpCacheStrategy.h"
 
 namespace easyhttpcpp {
 
@@ -20,6 +21,12 @@ EasyHttpInternal::EasyHttpInternal(EasyHttp::Builder& builder) : m_invalidated(f
     m_pContext->setRootCaDirectory(builder.getRootCaDirectory());
     m_pContext->setRootCaFile(builder.getRootCaFile());
     m_pContext->setCrlCheckPolicy(builder.getCrlCheckPolicy());
+    m_pContext->setContentEncodingPolicy(builder.getContentEncodingPolicy());
+    m_pContext->setRequestCoalescingEnabled(builder.isRequestCoalescingEnabled());
+    m_pContext->setRequestCoalescingTimeoutMillis(builder.getRequestCoalescingTimeoutMillis());
+    m_pContext->setCacheFillPolicy(builder.getCacheFillPolicy());
+    m_pContext->setBackgroundCacheFillMaxBytes(builder.getBackgroundCacheFillMaxBytes());
+    m_pContext->setBackgroundCacheFillTimeoutSec(builder.getBackgroundCacheFillTimeoutSec());
     m_pContext->setCallInterceptors(builder.getInterceptors());
     m_pContext->setNetworkInterceptors(builder.getNetworkInterceptors());
     m_pContext->setConnectionPool(builder.getConnectionPool());
@@ -27,10 +34,14 @@ EasyHttpInternal::EasyHttpInternal(EasyHttp::Builder& builder) : m_invalidated(f
     m_maximumPoolSizeOfAsyncThreadPool = builder.getMaximumPoolSizeOfAsyncThreadPool();
     m_pContext->setHttpExecutionTaskManager(new HttpExecutionTaskManager(m_corePoolSizeOfAsyncThreadPool,
             m_maximumPoolSizeOfAsyncThreadPool));
+    m_maxConcurrentPrefetchCount = builder.getMaxConcurrentPrefetchCount();
+    m_prefetchBytesPerSec = builder.getPrefetchBytesPerSec();
+    m_pPrefetcher = new HttpPrefetcher(m_pContext, m_maxConcurrentPrefetchCount, m_prefetchBytesPerSec);
 }
 
 EasyHttpInternal::~EasyHttpInternal()
 {
+    m_pPrefetcher->cancelAll();
     m_pContext->getHttpExecutionTaskManager()->gracefulShutdown();
 }
 
@@ -49,6 +60,38 @@ Call::Ptr EasyHttpInternal::newCall(Request::Ptr pRequest)
     return new CallInternal(m_pContext, pRequest);
 }
 
+void EasyHttpInternal::prefetch(Request::Ptr pRequest, PrefetchPriority priority)
+{
+    Poco::FastMutex::ScopedLock lock(m_instanceMutex);
+    if (m_invalidated) {
+        EASYHTTPCPP_LOG_D(Tag, "prefetch: EasyHttp is already invalidated.");
+        throw HttpIllegalStateException("Need to instantiate EasyHttp object again before calling prefetch.");
+    }
+    if (!pRequest) {
+        EASYHTTPCPP_LOG_D(Tag, "prefetch: pRequest is NULL.");
+        throw HttpIllegalArgumentException("prefetch require Request.");
+    }
+    if (!HttpCacheStrategy::isAvailableToCache(pRequest)) {
+        EASYHTTPCPP_LOG_D(Tag, "prefetch: response of the request can not be cached. [%s]",
+                pRequest->getUrl().c_str());
+        throw HttpIllegalArgumentException("prefetch require Request whose response can be cached.");
+    }
+    if (priority < PrefetchPriorityHigh || priority > PrefetchPriorityLow) {
+        EASYHTTPCPP_LOG_D(Tag, "prefetch: invalid priority. [%d]", priority);
+        throw HttpIllegalArgumentException("prefetch require valid PrefetchPriority.");
+    }
+    if (!m_pContext->getCache()) {
+        EASYHTTPCPP_LOG_D(Tag, "prefetch: HttpCache is not set.");
+        throw HttpIllegalStateException("prefetch require HttpCache.");
+    }
+    m_pPrefetcher->prefetch(pRequest, priority);
+}
+
+void EasyHttpInternal::cancelPrefetches()
+{
+    m_pPrefetcher->cancelAll();
+}
+
 Proxy::Ptr EasyHttpInternal::getProxy() const
 {
     return m_pContext->getProxy();
@@ -69,6 +112,36 @@ CrlCheckPolicy EasyHttpInternal::getCrlCheckPolicy() const
     return m_pContext->getCrlCheckPolicy();
 }
 
+ContentEncodingPolicy EasyHttpInternal::getContentEncodingPolicy() const
+{
+    return m_pContext->getContentEncodingPolicy();
+}
+
+bool EasyHttpInternal::isRequestCoalescingEnabled() const
+{
+    return m_pContext->isRequestCoalescingEnabled();
+}
+
+unsigned int EasyHttpInternal::getRequestCoalescingTimeoutMillis() const
+{
+    return m_pContext->getRequestCoalescingTimeoutMillis();
+}
+
+CacheFillPolicy EasyHttpInternal::getCacheFillPolicy() const
+{
+    return m_pContext->getCacheFillPolicy();
+}
+
+Poco::UInt64 EasyHttpInternal::getBackgroundCacheFillMaxBytes() const
+{
+    return m_pContext->getBackgroundCacheFillMaxBytes();
+}
+
+unsigned int EasyHttpInternal::getBackgroundCacheFillTimeoutSec() const
+{
+    return m_pContext->getBackgroundCacheFillTimeoutSec();
+}
+
 const std::string& EasyHttpInternal::getRootCaDirectory() const
 {
     return m_pContext->getRootCaDirectory();
@@ -99,6 +172,16 @@ unsigned int EasyHttpInternal::getMaximumPoolSizeOfAsyncThreadPool() const
     return m_maximumPoolSizeOfAsyncThreadPool;
 }
 
+unsigned int EasyHttpInternal::getMaxConcurrentPrefetchCount() const
+{
+    return m_maxConcurrentPrefetchCount;
+}
+
+Poco::UInt64 EasyHttpInternal::getPrefetchBytesPerSec() const
+{
+    return m_prefetchBytesPerSec;
+}
+
 void EasyHttpInternal::invalidateAndCancel()
 {
     {
@@ -110,6 +193,7 @@ void EasyHttpInternal::invalidateAndCancel()
         m_invalidated = true;
     }
 
+    m_pPrefetcher->cancelAll();
     m_pContext->getHttpExecutionTaskManager()->gracefulShutdown();
 }
 
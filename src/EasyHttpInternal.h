@@ -12,6 +12,7 @@
 #include "easyhttpcpp/HttpExports.h"
 
 #include "EasyHttpContext.h"
+#include "HttpPrefetcher.h"
 
 namespace easyhttpcpp {
 
@@ -20,15 +21,25 @@ public:
     EasyHttpInternal(EasyHttp::Builder& builder);
     virtual ~EasyHttpInternal();
     virtual Call::Ptr newCall(Request::Ptr pRequest);
+    virtual void prefetch(Request::Ptr pRequest, PrefetchPriority priority);
+    virtual void cancelPrefetches();
     virtual Proxy::Ptr getProxy() const;
     virtual unsigned int getTimeoutSec() const;
     virtual HttpCache::Ptr getCache() const;
     virtual CrlCheckPolicy getCrlCheckPolicy() const;
+    virtual ContentEncodingPolicy getContentEncodingPolicy() const;
+    virtual bool isRequestCoalescingEnabled() const;
+    virtual unsigned int getRequestCoalescingTimeoutMillis() const;
+    virtual CacheFillPolicy getCacheFillPolicy() const;
+    virtual Poco::UInt64 getBackgroundCacheFillMaxBytes() const;
+    virtual unsigned int getBackgroundCacheFillTimeoutSec() const;
     virtual const std::string& getRootCaDirectory() const;
     virtual const std::string& getRootCaFile() const;
     virtual ConnectionPool::Ptr getConnectionPool() const;
     virtual unsigned int getCorePoolSizeOfAsyncThreadPool() const;
     virtual unsigned int getMaximumPoolSizeOfAsyncThreadPool() const;
+    virtual unsigned int getMaxConcurrentPrefetchCount() const;
+    virtual Poco::UInt64 getPrefetchBytesPerSec() const;
     virtual void invalidateAndCancel();
 
     EasyHttpContext::Ptr getHttpContenxt() const;
@@ -38,6 +49,9 @@ private:
     EasyHttpContext::Ptr m_pContext;
     unsigned int m_corePoolSizeOfAsyncThreadPool;
     unsigned int m_maximumPoolSizeOfAsyncThreadPool;
+    unsigned int m_maxConcurrentPrefetchCount;
+    Poco::UInt64 m_prefetchBytesPerSec;
+    HttpPrefetcher::Ptr m_pPrefetcher;
     Poco::FastMutex m_instanceMutex;
     bool m_invalidated;
 
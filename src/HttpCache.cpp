@@ -5,6 +5,7 @@
 #include "easyhttpcpp/HttpCache.h"
 
 #include "HttpCacheInternal.h"
+#include "HttpInternalConstants.h"
 
 namespace easyhttpcpp {
 
@@ -14,7 +15,100 @@ HttpCache::~HttpCache()
 
 HttpCache::Ptr HttpCache::createCache(const Poco::Path& path, size_t maxSize)
 {
-    return new HttpCacheInternal(path, maxSize);
+    Builder builder(path, maxSize);
+    return builder.build();
+}
+
+HttpCache::Builder::Builder(const Poco::Path& path, size_t maxSize) : m_path(path), m_maxSize(maxSize),
+        m_memoryCacheMaxSize(0), m_inlineBodyMaxSize(0),
+        m_dataDirFanOutLevels(HttpInternalConstants::Caches::DataDirFanOutLevels), m_evictionPolicy(EvictionPolicyLru),
+        m_bodyCompression(BodyCompressionNone)
+{
+}
+
+HttpCache::Builder::~Builder()
+{
+}
+
+HttpCache::Ptr HttpCache::Builder::build()
+{
+    return new HttpCacheInternal(*this);
+}
+
+const Poco::Path& HttpCache::Builder::getPath() const
+{
+    return m_path;
+}
+
+size_t HttpCache::Builder::getMaxSize() const
+{
+    return m_maxSize;
+}
+
+HttpCache::Builder& HttpCache::Builder::setMemoryCacheMaxSize(size_t memoryCacheMaxSize)
+{
+    m_memoryCacheMaxSize = memoryCacheMaxSize;
+    return *this;
+}
+
+size_t HttpCache::Builder::getMemoryCacheMaxSize() const
+{
+    return m_memoryCacheMaxSize;
+}
+
+HttpCache::Builder& HttpCache::Builder::setKeyHasher(HttpCacheKeyHasher::Ptr pKeyHasher)
+{
+    m_pKeyHasher = pKeyHasher;
+    return *this;
+}
+
+HttpCacheKeyHasher::Ptr HttpCache::Builder::getKeyHasher() const
+{
+    return m_pKeyHasher;
+}
+
+HttpCache::Builder& HttpCache::Builder::setInlineBodyMaxSize(size_t inlineBodyMaxSize)
+{
+    m_inlineBodyMaxSize = inlineBodyMaxSize;
+    return *this;
+}
+
+size_t HttpCache::Builder::getInlineBodyMaxSize() const
+{
+    return m_inlineBodyMaxSize;
+}
+
+HttpCache::Builder& HttpCache::Builder::setDataDirFanOutLevels(unsigned int dataDirFanOutLevels)
+{
+    m_dataDirFanOutLevels = dataDirFanOutLevels;
+    return *this;
+}
+
+unsigned int HttpCache::Builder::getDataDirFanOutLevels() const
+{
+    return m_dataDirFanOutLevels;
+}
+
+HttpCache::Builder& HttpCache::Builder::setEvictionPolicy(EvictionPolicy evictionPolicy)
+{
+    m_evictionPolicy = evictionPolicy;
+    return *this;
+}
+
+HttpCache::EvictionPolicy HttpCache::Builder::getEvictionPolicy() const
+{
+    return m_evictionPolicy;
+}
+
+HttpCache::Builder& HttpCache::Builder::setBodyCompression(BodyCompression bodyCompression)
+{
+    m_bodyCompression = bodyCompression;
+    return *this;
+}
+
+HttpCache::BodyCompression HttpCache::Builder::getBodyCompression() const
+{
+    return m_bodyCompression;
 }
 
 } /* namespace easyhttpcpp */
@@ -6,30 +6,34 @@
 
 #include "easyhttpcpp/common/CoreLogger.h"
 #include "easyhttpcpp/common/FileUtil.h"
+#include "easyhttpcpp/common/StringUtil.h"
 #include "easyhttpcpp/db/AutoSqliteCursor.h"
-#include "easyhttpcpp/db/AutoSqliteDatabase.h"
 #include "easyhttpcpp/db/AutoSqliteTransaction.h"
 #include "easyhttpcpp/db/ContentValues.h"
 #include "easyhttpcpp/db/SqlException.h"
+#include "easyhttpcpp/db/SqliteStatement.h"
 #include "easyhttpcpp/HttpException.h"
 
 #include "HttpCacheDatabase.h"
+#include "HttpCacheFreshness.h"
 #include "HttpCacheMetadata.h"
 #include "HttpCacheEnumerationListener.h"
 #include "HttpInternalConstants.h"
 #include "HttpUtil.h"
 
+using easyhttpcpp::common::ByteArrayBuffer;
 using easyhttpcpp::common::Cache;
 using easyhttpcpp::common::CacheMetadata;
 using easyhttpcpp::common::FileUtil;
+using easyhttpcpp::common::StringUtil;
 using easyhttpcpp::db::AutoSqliteCursor;
-using easyhttpcpp::db::AutoSqliteDatabase;
 using easyhttpcpp::db::AutoSqliteTransaction;
 using easyhttpcpp::db::ContentValues;
 using easyhttpcpp::db::SqlException;
 using easyhttpcpp::db::SqliteCursor;
 using easyhttpcpp::db::SqliteDatabase;
 using easyhttpcpp::db::SqliteOpenHelper;
+using easyhttpcpp::db::SqliteStatement;
 
 namespace easyhttpcpp {
 
@@ -37,6 +41,62 @@ static const std::string Tag = "HttpCacheDatabase";
 
 HttpCacheDatabase::HttpCacheDatabase(HttpCacheDatabaseOpenHelper::Ptr pOpenHelper) : m_pOpenHelper(pOpenHelper)
 {
+    // fixed statements are compiled once and reused while the database session is open.
+    std::string freshnessColumns = std::string(HttpInternalConstants::Database::Key::ResponseDateAtEpoch) + ", " +
+            HttpInternalConstants::Database::Key::ExpiresAtEpoch + ", " +
+            HttpInternalConstants::Database::Key::LastModifiedAtEpoch + ", " +
+            HttpInternalConstants::Database::Key::AgeSec + ", " +
+            HttpInternalConstants::Database::Key::MaxAgeSec + ", " +
+            HttpInternalConstants::Database::Key::SMaxAgeSec + ", " +
+            HttpInternalConstants::Database::Key::NoCache + ", " +
+            HttpInternalConstants::Database::Key::MustRevalidate + ", " +
+            HttpInternalConstants::Database::Key::ETag + ", " +
+            HttpInternalConstants::Database::Key::LastModified;
+    m_selectMetadataSql = std::string("SELECT ") +
+            HttpInternalConstants::Database::Key::Url + ", " +
+            HttpInternalConstants::Database::Key::Method + ", " +
+            HttpInternalConstants::Database::Key::StatusCode + ", " +
+            HttpInternalConstants::Database::Key::StatusMessage + ", " +
+            HttpInternalConstants::Database::Key::ResponseHeaders + ", " +
+            HttpInternalConstants::Database::Key::ResponseBodySize + ", " +
+            HttpInternalConstants::Database::Key::SentRequestAtEpoch + ", " +
+            HttpInternalConstants::Database::Key::ReceivedResponseAtEpoch + ", " +
+            HttpInternalConstants::Database::Key::CreatedAtEpoch + ", " +
+            freshnessColumns + ", " +
+            HttpInternalConstants::Database::Key::ResponseBodyCompressed +
+            " FROM " + HttpInternalConstants::Database::TableName +
+            " WHERE " + HttpInternalConstants::Database::Key::CacheKey + "=?";
+    m_deleteMetadataSql = std::string("DELETE FROM ") + HttpInternalConstants::Database::TableName +
+            " WHERE " + HttpInternalConstants::Database::Key::CacheKey + "=?";
+    std::string replaceMetadataSql = std::string("INSERT OR REPLACE INTO ") +
+            HttpInternalConstants::Database::TableName +
+            " (" + HttpInternalConstants::Database::Key::CacheKey + ", " +
+            HttpInternalConstants::Database::Key::Url + ", " +
+            HttpInternalConstants::Database::Key::Method + ", " +
+            HttpInternalConstants::Database::Key::StatusCode + ", " +
+            HttpInternalConstants::Database::Key::StatusMessage + ", " +
+            HttpInternalConstants::Database::Key::ResponseHeaders + ", " +
+            HttpInternalConstants::Database::Key::ResponseBodySize + ", " +
+            HttpInternalConstants::Database::Key::SentRequestAtEpoch + ", " +
+            HttpInternalConstants::Database::Key::ReceivedResponseAtEpoch + ", " +
+            HttpInternalConstants::Database::Key::CreatedAtEpoch + ", " +
+            HttpInternalConstants::Database::Key::LastAccessedAtEpoch + ", " +
+            freshnessColumns + ", " +
+            HttpInternalConstants::Database::Key::ResponseBodyCompressed + ", " +
+            HttpInternalConstants::Database::Key::ResponseBody +
+            ") VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ";
+    // the values are evaluated before the old row is replaced, so a response body stored in the row is kept.
+    m_replaceMetadataSql = replaceMetadataSql + "(SELECT " + HttpInternalConstants::Database::Key::ResponseBody +
+            " FROM " + HttpInternalConstants::Database::TableName +
+            " WHERE " + HttpInternalConstants::Database::Key::CacheKey + "=?))";
+    m_replaceMetadataWithResponseBodySql = replaceMetadataSql + "?)";
+    m_selectResponseBodySql = std::string("SELECT ") + HttpInternalConstants::Database::Key::ResponseBody +
+            " FROM " + HttpInternalConstants::Database::TableName +
+            " WHERE " + HttpInternalConstants::Database::Key::CacheKey + "=? AND " +
+            HttpInternalConstants::Database::Key::ResponseBody + " IS NOT NULL";
+    m_updateLastAccessedSecSql = std::string("UPDATE ") + HttpInternalConstants::Database::TableName +
+            " SET " + HttpInternalConstants::Database::Key::LastAccessedAtEpoch + "=?" +
+            " WHERE " + HttpInternalConstants::Database::Key::CacheKey + "=?";
 }
 
 HttpCacheDatabase::~HttpCacheDatabase()
@@ -47,6 +107,7 @@ HttpCacheMetadata::Ptr HttpCacheDatabase::getMetadata(const std::string& key)
 {
     Poco::FastMutex::ScopedLock lock(m_mutex);
 
+    // the database is kept open across calls; it is closed by closeSqliteSession().
     SqliteDatabase::Ptr pDb;
     try {
         pDb = m_pOpenHelper->getReadableDatabase();
@@ -54,26 +115,12 @@ HttpCacheMetadata::Ptr HttpCacheDatabase::getMetadata(const std::string& key)
         EASYHTTPCPP_LOG_D(Tag, "getMetadata() Unable to open database. Error: %s", e.getMessage().c_str());
         throw;
     }
-    AutoSqliteDatabase autoSqliteDatabase(pDb);
 
     try {
-        std::vector<std::string> columns;
-        columns.push_back(HttpInternalConstants::Database::Key::Url);
-        columns.push_back(HttpInternalConstants::Database::Key::Method);
-        columns.push_back(HttpInternalConstants::Database::Key::StatusCode);
-        columns.push_back(HttpInternalConstants::Database::Key::StatusMessage);
-        columns.push_back(HttpInternalConstants::Database::Key::ResponseHeaderJson);
-        columns.push_back(HttpInternalConstants::Database::Key::ResponseBodySize);
-        columns.push_back(HttpInternalConstants::Database::Key::SentRequestAtEpoch);
-        columns.push_back(HttpInternalConstants::Database::Key::ReceivedResponseAtEpoch);
-        columns.push_back(HttpInternalConstants::Database::Key::CreatedAtEpoch);
+        SqliteStatement::Ptr pStatement = pDb->compileStatement(m_selectMetadataSql);
+        pStatement->bindString(0, key);
 
-        std::string whereClause = std::string(HttpInternalConstants::Database::Key::CacheKey) + "=?";
-        std::vector<std::string> whereArgs;
-        whereArgs.push_back(key);
-
-        SqliteCursor::Ptr pCursor = pDb->query(HttpInternalConstants::Database::TableName, &columns, &whereClause,
-                &whereArgs, NULL, NULL, NULL, NULL);
+        SqliteCursor::Ptr pCursor = pDb->queryStatement(pStatement);
         AutoSqliteCursor autoSqliteCursor(pCursor);
         if (pCursor->moveToFirst()) {
             HttpCacheMetadata::Ptr pHttpCacheMetadata = new HttpCacheMetadata();
@@ -82,15 +129,30 @@ HttpCacheMetadata::Ptr HttpCacheDatabase::getMetadata(const std::string& key)
             pHttpCacheMetadata->setHttpMethod(static_cast<Request::HttpMethod> (pCursor->getInt(1)));
             pHttpCacheMetadata->setStatusCode(pCursor->getInt(2));
             pHttpCacheMetadata->setStatusMessage(pCursor->getString(3));
-            pHttpCacheMetadata->setResponseHeaders(HttpUtil::exchangeJsonStrToHeaders(pCursor->getString(4)));
+            // headers are decoded only when they are used; freshness is read from its own columns.
+            std::string encodedResponseHeaders = pCursor->getString(4);
+            pHttpCacheMetadata->setEncodedResponseHeaders(encodedResponseHeaders);
             pHttpCacheMetadata->setResponseBodySize(pCursor->getUnsignedLongLong(5));
             pHttpCacheMetadata->setSentRequestAtEpoch(pCursor->getUnsignedLongLong(6));
             pHttpCacheMetadata->setReceivedResponseAtEpoch(pCursor->getUnsignedLongLong(7));
             pHttpCacheMetadata->setCreatedAtEpoch(pCursor->getUnsignedLongLong(8));
+            HttpCacheFreshness::Ptr pFreshness = new HttpCacheFreshness();
+            pFreshness->setResponseDateAtEpoch(pCursor->getLongLong(9));
+            pFreshness->setExpiresAtEpoch(pCursor->getLongLong(10));
+            pFreshness->setLastModifiedAtEpoch(pCursor->getLongLong(11));
+            pFreshness->setAgeSec(pCursor->getLongLong(12));
+            pFreshness->setMaxAgeSec(pCursor->getLongLong(13));
+            pFreshness->setSMaxAgeSec(pCursor->getLongLong(14));
+            pFreshness->setNoCache(pCursor->getInt(15) != 0);
+            pFreshness->setMustRevalidate(pCursor->getInt(16) != 0);
+            pFreshness->setETag(pCursor->getString(17));
+            pFreshness->setLastModified(pCursor->getString(18));
+            pHttpCacheMetadata->setFreshness(pFreshness);
+            pHttpCacheMetadata->setResponseBodyCompressed(pCursor->getInt(19) != 0);
 
             // dump
             EASYHTTPCPP_LOG_D(Tag, "getMetadata");
-            dumpMetadata(pHttpCacheMetadata);
+            dumpMetadata(pHttpCacheMetadata, encodedResponseHeaders);
             return pHttpCacheMetadata;
         } else {
             EASYHTTPCPP_LOG_D(Tag, "getMetadata(): can not get row");
@@ -113,28 +175,61 @@ bool HttpCacheDatabase::deleteMetadata(const std::string& key)
         EASYHTTPCPP_LOG_D(Tag, "deleteMetadata() Unable to open database. Error: %s", e.getMessage().c_str());
         throw;
     }
-    AutoSqliteDatabase autoSqliteDatabase(pDb);
 
     try {
-        AutoSqliteTransaction autoSqliteTransaction(pDb);
+        // a single statement is atomic by itself, so no explicit transaction is needed.
+        SqliteStatement::Ptr pStatement = pDb->compileStatement(m_deleteMetadataSql);
+        pStatement->bindString(0, key);
 
-        std::string whereClause = std::string(HttpInternalConstants::Database::Key::CacheKey) + "=?";
-        std::vector<std::string> whereArgs;
-        whereArgs.push_back(key);
+        return pDb->executeUpdateDelete(pStatement) > 0;
+    } catch (const SqlException& e) {
+        EASYHTTPCPP_LOG_D(Tag, "SQLite error while deleteMetadata(): %s", e.getMessage().c_str());
+        throw;
+    }
+}
 
-        bool deleted = pDb->deleteRows(HttpInternalConstants::Database::TableName, &whereClause, &whereArgs) > 0;
+Poco::SharedPtr<ByteArrayBuffer> HttpCacheDatabase::getResponseBody(const std::string& key)
+{
+    Poco::FastMutex::ScopedLock lock(m_mutex);
 
-        pDb->setTransactionSuccessful();
+    SqliteDatabase::Ptr pDb;
+    try {
+        pDb = m_pOpenHelper->getReadableDatabase();
+    } catch (const SqlException& e) {
+        EASYHTTPCPP_LOG_D(Tag, "getResponseBody() Unable to open database. Error: %s", e.getMessage().c_str());
+        throw;
+    }
 
-        return deleted;
+    try {
+        SqliteStatement::Ptr pStatement = pDb->compileStatement(m_selectResponseBodySql);
+        pStatement->bindString(0, key);
+
+        SqliteCursor::Ptr pCursor = pDb->queryStatement(pStatement);
+        AutoSqliteCursor autoSqliteCursor(pCursor);
+        if (!pCursor->moveToFirst()) {
+            EASYHTTPCPP_LOG_D(Tag, "getResponseBody(): response body is not stored in database.");
+            return NULL;
+        }
+        return new ByteArrayBuffer(pCursor->getBlob(0));
     } catch (const SqlException& e) {
-        EASYHTTPCPP_LOG_D(Tag, "SQLite error while deleteMetadata(): %s", e.getMessage().c_str());
-        // do not set the transaction as successful; database will rollback automatically
+        EASYHTTPCPP_LOG_D(Tag, "SQLite error while getResponseBody(): %s", e.getMessage().c_str());
         throw;
     }
 }
 
 void HttpCacheDatabase::updateMetadata(const std::string& key, HttpCacheMetadata::Ptr pHttpCacheMetadata)
+{
+    updateMetadataInternal(key, pHttpCacheMetadata, NULL);
+}
+
+void HttpCacheDatabase::updateMetadata(const std::string& key, HttpCacheMetadata::Ptr pHttpCacheMetadata,
+        const std::string& responseBody)
+{
+    updateMetadataInternal(key, pHttpCacheMetadata, &responseBody);
+}
+
+void HttpCacheDatabase::updateMetadataInternal(const std::string& key, HttpCacheMetadata::Ptr pHttpCacheMetadata,
+        const std::string* pResponseBody)
 {
     Poco::FastMutex::ScopedLock lock(m_mutex);
 
@@ -145,41 +240,55 @@ void HttpCacheDatabase::updateMetadata(const std::string& key, HttpCacheMetadata
         EASYHTTPCPP_LOG_D(Tag, "updateMetadata() Unable to open database. Error: %s", e.getMessage().c_str());
         throw;
     }
-    AutoSqliteDatabase autoSqliteDatabase(pDb);
 
     try {
-        // always use transactions for speedy and reliable updates
-        AutoSqliteTransaction autoSqliteTransaction(pDb);
-
-        ContentValues values;
-        values.put(HttpInternalConstants::Database::Key::CacheKey, pHttpCacheMetadata->getKey());
-        values.put(HttpInternalConstants::Database::Key::Url, pHttpCacheMetadata->getUrl());
-        values.put(HttpInternalConstants::Database::Key::Method, pHttpCacheMetadata->getHttpMethod());
-        values.put(HttpInternalConstants::Database::Key::StatusCode, pHttpCacheMetadata->getStatusCode());
-        values.put(HttpInternalConstants::Database::Key::StatusMessage, pHttpCacheMetadata->getStatusMessage());
-        values.put(HttpInternalConstants::Database::Key::ResponseHeaderJson,
-                HttpUtil::exchangeHeadersToJsonStr(pHttpCacheMetadata->getResponseHeaders()));
-        values.put(HttpInternalConstants::Database::Key::ResponseBodySize, pHttpCacheMetadata->getResponseBodySize());
-        values.put(HttpInternalConstants::Database::Key::SentRequestAtEpoch,
-                pHttpCacheMetadata->getSentRequestAtEpoch());
-        values.put(HttpInternalConstants::Database::Key::ReceivedResponseAtEpoch,
-                pHttpCacheMetadata->getReceivedResponseAtEpoch());
-        values.put(HttpInternalConstants::Database::Key::CreatedAtEpoch, pHttpCacheMetadata->getCreatedAtEpoch());
+        SqliteStatement::Ptr pStatement = pDb->compileStatement(pResponseBody ? m_replaceMetadataWithResponseBodySql :
+                m_replaceMetadataSql);
+        pStatement->bindString(0, key);
+        pStatement->bindString(1, pHttpCacheMetadata->getUrl());
+        pStatement->bindLongLong(2, pHttpCacheMetadata->getHttpMethod());
+        pStatement->bindLongLong(3, pHttpCacheMetadata->getStatusCode());
+        pStatement->bindString(4, pHttpCacheMetadata->getStatusMessage());
+        // headers read from the database are written back without being decoded.
+        std::string encodedResponseHeaders = pHttpCacheMetadata->getEncodedResponseHeaders();
+        pStatement->bindString(5, encodedResponseHeaders);
+        pStatement->bindLongLong(6, static_cast<long long>(pHttpCacheMetadata->getResponseBodySize()));
+        pStatement->bindLongLong(7, static_cast<long long>(pHttpCacheMetadata->getSentRequestAtEpoch()));
+        pStatement->bindLongLong(8, static_cast<long long>(pHttpCacheMetadata->getReceivedResponseAtEpoch()));
+        pStatement->bindLongLong(9, static_cast<long long>(pHttpCacheMetadata->getCreatedAtEpoch()));
         Poco::Timestamp now;
-        values.put(HttpInternalConstants::Database::Key::LastAccessedAtEpoch, now.epochTime());
+        pStatement->bindLongLong(10, static_cast<long long>(now.epochTime()));
+        HttpCacheFreshness::Ptr pFreshness = pHttpCacheMetadata->getFreshness();
+        pStatement->bindLongLong(11, pFreshness->getResponseDateAtEpoch());
+        pStatement->bindLongLong(12, pFreshness->getExpiresAtEpoch());
+        pStatement->bindLongLong(13, pFreshness->getLastModifiedAtEpoch());
+        pStatement->bindLongLong(14, pFreshness->getAgeSec());
+        pStatement->bindLongLong(15, pFreshness->getMaxAgeSec());
+        pStatement->bindLongLong(16, pFreshness->getSMaxAgeSec());
+        pStatement->bindLongLong(17, pFreshness->isNoCache() ? 1 : 0);
+        pStatement->bindLongLong(18, pFreshness->isMustRevalidate() ? 1 : 0);
+        pStatement->bindString(19, pFreshness->getETag());
+        pStatement->bindString(20, pFreshness->getLastModified());
+        pStatement->bindLongLong(21, pHttpCacheMetadata->isResponseBodyCompressed() ? 1 : 0);
+        if (pResponseBody) {
+            pStatement->bindBlob(22, *pResponseBody);
+        } else {
+            pStatement->bindString(22, key);
+        }
 
         // do an INSERT, and if that INSERT fails because of a conflict,
         // delete the conflicting rows before INSERTing again
-        pDb->replace(HttpInternalConstants::Database::TableName, values);
+        pDb->executeUpdateDelete(pStatement);
         EASYHTTPCPP_LOG_V(Tag, "New HttpCacheMetadata updateMetadata.");
 
-        pDb->setTransactionSuccessful();
-
         // dump
         EASYHTTPCPP_LOG_D(Tag, "updateMetadata");
-        dumpMetadata(pHttpCacheMetadata);
+        dumpMetadata(pHttpCacheMetadata, encodedResponseHeaders);
         EASYHTTPCPP_LOG_D(Tag, "lastAccessedAtEpoch = %s", Poco::DateTimeFormatter::format(now,
                 Poco::DateTimeFormat::HTTP_FORMAT).c_str());
+        if (pResponseBody) {
+            EASYHTTPCPP_LOG_D(Tag, "response body is stored in database.");
+        }
 
     } catch (const SqlException& e) {
         EASYHTTPCPP_LOG_D(Tag, "SQLite error while updateMetadata(): %s", e.getMessage().c_str());
@@ -198,43 +307,80 @@ bool HttpCacheDatabase::updateLastAccessedSec(const std::string& key)
         EASYHTTPCPP_LOG_D(Tag, "updateMetadata() Unable to open database. Error: %s", e.getMessage().c_str());
         throw;
     }
-    AutoSqliteDatabase autoSqliteDatabase(pDb);
 
     try {
-        // always use transactions for speedy and reliable updates
-        AutoSqliteTransaction autoSqliteTransaction(pDb);
-
-        ContentValues values;
         Poco::Timestamp now;
-        values.put(HttpInternalConstants::Database::Key::LastAccessedAtEpoch, now.epochTime());
-
         EASYHTTPCPP_LOG_D(Tag, "updateLastAccessedSec: lastAccessedAtEpoch = %s", Poco::DateTimeFormatter::format(now,
                 Poco::DateTimeFormat::HTTP_FORMAT).c_str());
 
-        std::string whereClause = std::string(HttpInternalConstants::Database::Key::CacheKey) + "=?";
-        std::vector<std::string> whereArgs;
-        whereArgs.push_back(key);
+        SqliteStatement::Ptr pStatement = pDb->compileStatement(m_updateLastAccessedSecSql);
+        pStatement->bindLongLong(0, static_cast<long long>(now.epochTime()));
+        pStatement->bindString(1, key);
 
-        bool update;
-        if (pDb->update(HttpInternalConstants::Database::TableName, values, &whereClause, &whereArgs) == 0) {
+        if (pDb->executeUpdateDelete(pStatement) == 0) {
             // cannot update lastAccessedSec in cache, but ignore it.
             EASYHTTPCPP_LOG_D(Tag, "updateLastAccessedSec : can not update database.");
-            update = false;
-        } else {
-            update = true;
+            return false;
         }
-        pDb->setTransactionSuccessful();
-        return update;
+        return true;
     } catch (const SqlException& e) {
         EASYHTTPCPP_LOG_D(Tag, "SQLite error while updateLastAccessedSec(): %s", e.getMessage().c_str());
         throw;
     }
 }
 
+size_t HttpCacheDatabase::updateLastAccessedSecInBatch(const LastAccessedSecMap& lastAccessedSecs)
+{
+    Poco::FastMutex::ScopedLock lock(m_mutex);
+
+    if (lastAccessedSecs.empty()) {
+        return 0;
+    }
+
+    SqliteDatabase::Ptr pDb;
+    try {
+        pDb = m_pOpenHelper->getWritableDatabase();
+    } catch (const SqlException& e) {
+        EASYHTTPCPP_LOG_D(Tag, "updateLastAccessedSecInBatch() Unable to open database. Error: %s",
+                e.getMessage().c_str());
+        throw;
+    }
+
+    try {
+        // one transaction for all rows, so that a batch costs a single commit.
+        AutoSqliteTransaction autoSqliteTransaction(pDb);
+
+        SqliteStatement::Ptr pStatement = pDb->compileStatement(m_updateLastAccessedSecSql);
+        size_t updatedCount = 0;
+        for (LastAccessedSecMap::const_iterator it = lastAccessedSecs.begin(); it != lastAccessedSecs.end(); ++it) {
+            pStatement->bindLongLong(0, static_cast<long long>(it->second));
+            pStatement->bindString(1, it->first);
+            updatedCount += pDb->executeUpdateDelete(pStatement);
+        }
+
+        pDb->setTransactionSuccessful();
+
+        EASYHTTPCPP_LOG_D(Tag, "updateLastAccessedSecInBatch: updated %zu/%zu rows.", updatedCount,
+                lastAccessedSecs.size());
+        return updatedCount;
+    } catch (const SqlException& e) {
+        EASYHTTPCPP_LOG_D(Tag, "SQLite error while updateLastAccessedSecInBatch(): %s", e.getMessage().c_str());
+        throw;
+    }
+}
+
 bool HttpCacheDatabase::deleteDatabaseFile()
 {
     Poco::FastMutex::ScopedLock lock(m_mutex);
-    return FileUtil::removeFileIfPresent(Poco::File(m_pOpenHelper->getDatabasePath().absolute().toString()));
+
+    // the session is closed under the same lock, so that another thread does not open the file meanwhile.
+    m_pOpenHelper->closeSqliteSession();
+    std::string databaseFile = m_pOpenHelper->getDatabasePath().absolute().toString();
+    // remove write-ahead log and shared memory files too, so that stale log is not applied to a new database.
+    bool ret = FileUtil::removeFileIfPresent(Poco::File(databaseFile));
+    ret &= FileUtil::removeFileIfPresent(Poco::File(databaseFile + "-wal"));
+    ret &= FileUtil::removeFileIfPresent(Poco::File(databaseFile + "-shm"));
+    return ret;
 }
 
 void HttpCacheDatabase::enumerate(HttpCacheEnumerationListener* pListener)
@@ -251,26 +397,24 @@ void HttpCacheDatabase::enumerate(HttpCacheEnumerationListener* pListener)
     }
 
     try {
-        SqliteCursor::Ptr pCursor;
-
-        {
-            AutoSqliteDatabase autoSqliteDatabase(pDb);
-
-            std::vector<std::string> columns;
-            columns.push_back(HttpInternalConstants::Database::Key::CacheKey);
-            columns.push_back(HttpInternalConstants::Database::Key::ResponseBodySize);
+        std::vector<std::string> columns;
+        columns.push_back(HttpInternalConstants::Database::Key::CacheKey);
+        columns.push_back(HttpInternalConstants::Database::Key::ResponseBodySize);
+        columns.push_back(HttpInternalConstants::Database::Key::Id);
+        columns.push_back(HttpInternalConstants::Database::Key::LastAccessedAtEpoch);
 
-            // sort by LastAccessedSec.
-            std::string orderBy = std::string(HttpInternalConstants::Database::Key::LastAccessedAtEpoch) + " ASC";
-            pCursor = pDb->query(HttpInternalConstants::Database::TableName, &columns, NULL, NULL, NULL,
-                    NULL, &orderBy, NULL);
-        }
+        // sort by LastAccessedSec.
+        std::string orderBy = std::string(HttpInternalConstants::Database::Key::LastAccessedAtEpoch) + " ASC";
+        SqliteCursor::Ptr pCursor = pDb->query(HttpInternalConstants::Database::TableName, &columns, NULL, NULL,
+                NULL, NULL, &orderBy, NULL);
         AutoSqliteCursor autoSqliteCursor(pCursor);
         if (pCursor->moveToFirst()) {
             do {
                 HttpCacheEnumerationListener::EnumerationParam param;
                 param.m_key = pCursor->getString(0);
                 param.m_responseBodySize = pCursor->getUnsignedLongLong(1);
+                param.m_id = pCursor->getLongLong(2);
+                param.m_lastAccessedAtEpoch = static_cast<std::time_t>(pCursor->getLongLong(3));
                 if (!pListener->onEnumerate(param)) {
                     EASYHTTPCPP_LOG_D(Tag, "enumerate: error occurred onEnumerate.");
                     // could not store it in cache, but continue processing because it is cache. 
@@ -283,8 +427,58 @@ void HttpCacheDatabase::enumerate(HttpCacheEnumerationListener* pListener)
     }
 }
 
+size_t HttpCacheDatabase::enumerateChunk(long long afterId, size_t maxCount, EnumerationParamList& params)
+{
+    Poco::FastMutex::ScopedLock lock(m_mutex);
+
+    SqliteDatabase::Ptr pDb;
+    try {
+        pDb = m_pOpenHelper->getReadableDatabase();
+    } catch (const SqlException& e) {
+        EASYHTTPCPP_LOG_D(Tag, "enumerateChunk() Unable to open database. Error: %s", e.getMessage().c_str());
+        throw;
+    }
+
+    try {
+        std::vector<std::string> columns;
+        columns.push_back(HttpInternalConstants::Database::Key::CacheKey);
+        columns.push_back(HttpInternalConstants::Database::Key::ResponseBodySize);
+        columns.push_back(HttpInternalConstants::Database::Key::Id);
+        columns.push_back(HttpInternalConstants::Database::Key::LastAccessedAtEpoch);
+
+        // paging by row id walks the primary key index, so each chunk costs the same regardless of its position.
+        std::string where = std::string(HttpInternalConstants::Database::Key::Id) + ">?";
+        std::vector<std::string> whereArgs;
+        whereArgs.push_back(StringUtil::format("%lld", afterId));
+        std::string orderBy = std::string(HttpInternalConstants::Database::Key::Id) + " ASC";
+        std::string limit = StringUtil::format("%zu", maxCount);
+        SqliteCursor::Ptr pCursor = pDb->query(HttpInternalConstants::Database::TableName, &columns, &where,
+                &whereArgs, NULL, NULL, &orderBy, &limit);
+        AutoSqliteCursor autoSqliteCursor(pCursor);
+        size_t count = 0;
+        if (pCursor->moveToFirst()) {
+            do {
+                HttpCacheEnumerationListener::EnumerationParam param;
+                param.m_key = pCursor->getString(0);
+                param.m_responseBodySize = pCursor->getUnsignedLongLong(1);
+                param.m_id = pCursor->getLongLong(2);
+                param.m_lastAccessedAtEpoch = static_cast<std::time_t>(pCursor->getLongLong(3));
+                params.push_back(param);
+                count++;
+            } while (pCursor->moveToNext());
+        }
+        return count;
+    } catch (const SqlException& e) {
+        EASYHTTPCPP_LOG_D(Tag, "SQLite error while enumerateChunk(): %s", e.getMessage().c_str());
+        throw;
+    }
+}
+
 void HttpCacheDatabase::closeSqliteSession()
 {
+    // wait for the statement in progress, because the session may be used by another thread.
+    Poco::FastMutex::ScopedLock lock(m_mutex);
+
     m_pOpenHelper->closeSqliteSession();
 }
 
@@ -313,7 +507,6 @@ HttpCacheDatabase::HttpCacheMetadataAll::Ptr HttpCacheDatabase::getMetadataAll(c
         EASYHTTPCPP_LOG_D(Tag, "getMetadataAll() Unable to open database. Error: %s", e.getMessage().c_str());
         throw;
     }
-    AutoSqliteDatabase autoSqliteDatabase(pDb);
 
     try {
         std::vector<std::string> columns;
@@ -321,12 +514,13 @@ HttpCacheDatabase::HttpCacheMetadataAll::Ptr HttpCacheDatabase::getMetadataAll(c
         columns.push_back(HttpInternalConstants::Database::Key::Method);
         columns.push_back(HttpInternalConstants::Database::Key::StatusCode);
         columns.push_back(HttpInternalConstants::Database::Key::StatusMessage);
-        columns.push_back(HttpInternalConstants::Database::Key::ResponseHeaderJson);
+        columns.push_back(HttpInternalConstants::Database::Key::ResponseHeaders);
         columns.push_back(HttpInternalConstants::Database::Key::ResponseBodySize);
         columns.push_back(HttpInternalConstants::Database::Key::SentRequestAtEpoch);
         columns.push_back(HttpInternalConstants::Database::Key::ReceivedResponseAtEpoch);
         columns.push_back(HttpInternalConstants::Database::Key::CreatedAtEpoch);
         columns.push_back(HttpInternalConstants::Database::Key::LastAccessedAtEpoch);
+        columns.push_back(HttpInternalConstants::Database::Key::ResponseBodyCompressed);
 
         std::string whereClause = std::string(HttpInternalConstants::Database::Key::CacheKey) + "=?";
         std::vector<std::string> whereArgs;
@@ -343,12 +537,13 @@ HttpCacheDatabase::HttpCacheMetadataAll::Ptr HttpCacheDatabase::getMetadataAll(c
             pHttpCacheMetadataAll->setHttpMethod(static_cast<Request::HttpMethod> (pCursor->getInt(1)));
             pHttpCacheMetadataAll->setStatusCode(pCursor->getInt(2));
             pHttpCacheMetadataAll->setStatusMessage(pCursor->getString(3));
-            pHttpCacheMetadataAll->setResponseHeaders(HttpUtil::exchangeJsonStrToHeaders(pCursor->getString(4)));
+            pHttpCacheMetadataAll->setResponseHeaders(HttpUtil::exchangeBinaryStrToHeaders(pCursor->getString(4)));
             pHttpCacheMetadataAll->setResponseBodySize(pCursor->getUnsignedLongLong(5));
             pHttpCacheMetadataAll->setSentRequestAtEpoch(pCursor->getUnsignedLongLong(6));
             pHttpCacheMetadataAll->setReceivedResponseAtEpoch(pCursor->getUnsignedLongLong(7));
             pHttpCacheMetadataAll->setCreatedAtEpoch(pCursor->getUnsignedLongLong(8));
             pHttpCacheMetadataAll->setLastAccessedAtEpoch(pCursor->getUnsignedLongLong(9));
+            pHttpCacheMetadataAll->setResponseBodyCompressed(pCursor->getInt(10) != 0);
             return pHttpCacheMetadataAll;
         } else {
             EASYHTTPCPP_LOG_D(Tag, "getMetadataAll(): can not get row");
@@ -372,7 +567,6 @@ void HttpCacheDatabase::updateMetadataAll(const std::string& key,
         EASYHTTPCPP_LOG_D(Tag, "updateMetadataAll() Unable to open database. Error: %s", e.getMessage().c_str());
         throw;
     }
-    AutoSqliteDatabase autoSqliteDatabase(pDb);
 
     try {
         // always use transactions for speedy and reliable updates
@@ -384,8 +578,8 @@ void HttpCacheDatabase::updateMetadataAll(const std::string& key,
         values.put(HttpInternalConstants::Database::Key::Method, pHttpCacheMetadataAll->getHttpMethod());
         values.put(HttpInternalConstants::Database::Key::StatusCode, pHttpCacheMetadataAll->getStatusCode());
         values.put(HttpInternalConstants::Database::Key::StatusMessage, pHttpCacheMetadataAll->getStatusMessage());
-        values.put(HttpInternalConstants::Database::Key::ResponseHeaderJson,
-                HttpUtil::exchangeHeadersToJsonStr(pHttpCacheMetadataAll->getResponseHeaders()));
+        values.put(HttpInternalConstants::Database::Key::ResponseHeaders,
+                HttpUtil::exchangeHeadersToBinaryStr(pHttpCacheMetadataAll->getResponseHeaders()));
         values.put(HttpInternalConstants::Database::Key::ResponseBodySize,
                 pHttpCacheMetadataAll->getResponseBodySize());
         values.put(HttpInternalConstants::Database::Key::SentRequestAtEpoch,
@@ -395,6 +589,9 @@ void HttpCacheDatabase::updateMetadataAll(const std::string& key,
         values.put(HttpInternalConstants::Database::Key::CreatedAtEpoch, pHttpCacheMetadataAll->getCreatedAtEpoch());
         values.put(HttpInternalConstants::Database::Key::LastAccessedAtEpoch,
                 pHttpCacheMetadataAll->getLastAccessedAtEpoch());
+        values.put(HttpInternalConstants::Database::Key::ResponseBodyCompressed,
+                pHttpCacheMetadataAll->isResponseBodyCompressed() ? 1 : 0);
+        HttpCacheDatabaseOpenHelper::putFreshness(values, *pHttpCacheMetadataAll->getFreshness());
 
         // do an INSERT, and if that INSERT fails because of a conflict,
         // delete the conflicting rows before INSERTing again
@@ -409,15 +606,16 @@ void HttpCacheDatabase::updateMetadataAll(const std::string& key,
     }
 }
 
-void HttpCacheDatabase::dumpMetadata(HttpCacheMetadata::Ptr pHttpCacheMetadata)
+void HttpCacheDatabase::dumpMetadata(HttpCacheMetadata::Ptr pHttpCacheMetadata,
+        const std::string& encodedResponseHeaders)
 {
     EASYHTTPCPP_LOG_D(Tag, "url = %s", pHttpCacheMetadata->getUrl().c_str());
     EASYHTTPCPP_LOG_D(Tag, "method = %s", HttpUtil::httpMethodToString(pHttpCacheMetadata->getHttpMethod()).c_str());
     EASYHTTPCPP_LOG_D(Tag, "code = %d", pHttpCacheMetadata->getStatusCode());
     EASYHTTPCPP_LOG_D(Tag, "message = %s", pHttpCacheMetadata->getStatusMessage().c_str());
-    EASYHTTPCPP_LOG_D(Tag, "header = %s", HttpUtil::exchangeHeadersToJsonStr(
-            pHttpCacheMetadata->getResponseHeaders()).c_str());
-    EASYHTTPCPP_LOG_D(Tag, "body size = %zu", pHttpCacheMetadata->getResponseBodySize());
+    EASYHTTPCPP_LOG_D(Tag, "header = %zu bytes", encodedResponseHeaders.size());
+    EASYHTTPCPP_LOG_D(Tag, "body size = %zu%s", pHttpCacheMetadata->getResponseBodySize(),
+            pHttpCacheMetadata->isResponseBodyCompressed() ? " (compressed)" : "");
     Poco::Timestamp sentRequestTime = Poco::Timestamp::fromEpochTime(pHttpCacheMetadata->getSentRequestAtEpoch());
     EASYHTTPCPP_LOG_D(Tag, "sentRequestAtEpoch = %s", Poco::DateTimeFormatter::format(sentRequestTime,
             Poco::DateTimeFormat::HTTP_FORMAT).c_str());
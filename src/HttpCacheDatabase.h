@@ -5,36 +5,53 @@
 #ifndef EASYHTTPCPP_HTTPCACHEDATABASE_H_INCLUDED
 #define EASYHTTPCPP_HTTPCACHEDATABASE_H_INCLUDED
 
+#include <ctime>
+#include <map>
 #include <string>
+#include <vector>
 
 #include "Poco/AutoPtr.h"
 #include "Poco/Mutex.h"
 #include "Poco/RefCountedObject.h"
+#include "Poco/SharedPtr.h"
 
+#include "easyhttpcpp/common/ByteArrayBuffer.h"
 #include "easyhttpcpp/common/Cache.h"
 #include "easyhttpcpp/common/CacheMetadata.h"
 #include "easyhttpcpp/HttpExports.h"
 
 #include "HttpCacheDatabaseOpenHelper.h"
+#include "HttpCacheEnumerationListener.h"
 #include "HttpCacheMetadata.h"
 
 namespace easyhttpcpp {
 
-class HttpCacheEnumerationListener;
-
 class EASYHTTPCPP_HTTP_INTERNAL_API HttpCacheDatabase : public Poco::RefCountedObject {
 public:
     typedef Poco::AutoPtr<HttpCacheDatabase> Ptr;
+    typedef std::map<std::string, std::time_t> LastAccessedSecMap;
+    typedef std::vector<HttpCacheEnumerationListener::EnumerationParam> EnumerationParamList;
 
     HttpCacheDatabase(HttpCacheDatabaseOpenHelper::Ptr pOpenHelper);
     virtual ~HttpCacheDatabase();
 
     HttpCacheMetadata::Ptr getMetadata(const std::string& key);
     bool deleteMetadata(const std::string& key);
+    // returns NULL when the response body of the key is stored in a file.
+    Poco::SharedPtr<easyhttpcpp::common::ByteArrayBuffer> getResponseBody(const std::string& key);
+    // a response body already stored in the row is kept.
     void updateMetadata(const std::string& key, HttpCacheMetadata::Ptr pHttpCacheMetadata);
+    // stores responseBody in the row together with the metadata.
+    void updateMetadata(const std::string& key, HttpCacheMetadata::Ptr pHttpCacheMetadata,
+            const std::string& responseBody);
     bool updateLastAccessedSec(const std::string& key);
+    // updates lastAccessedSec of all keys in one transaction. returns count of updated rows.
+    size_t updateLastAccessedSecInBatch(const LastAccessedSecMap& lastAccessedSecs);
     bool deleteDatabaseFile();
     void enumerate(HttpCacheEnumerationListener* pListener);
+    // appends at most maxCount entries whose row id is greater than afterId in row id order.
+    // returns count of appended entries.
+    size_t enumerateChunk(long long afterId, size_t maxCount, EnumerationParamList& params);
     void closeSqliteSession();
 
     // for test method.
@@ -53,10 +70,18 @@ public:
 
 private:
     HttpCacheDatabase();
-    void dumpMetadata(HttpCacheMetadata::Ptr pHttpCacheMetadata);
+    void updateMetadataInternal(const std::string& key, HttpCacheMetadata::Ptr pHttpCacheMetadata,
+            const std::string* pResponseBody);
+    void dumpMetadata(HttpCacheMetadata::Ptr pHttpCacheMetadata, const std::string& encodedResponseHeaders);
 
     Poco::FastMutex m_mutex;
     HttpCacheDatabaseOpenHelper::Ptr m_pOpenHelper;
+    std::string m_selectMetadataSql;
+    std::string m_deleteMetadataSql;
+    std::string m_replaceMetadataSql;
+    std::string m_replaceMetadataWithResponseBodySql;
+    std::string m_selectResponseBodySql;
+    std::string m_updateLastAccessedSecSql;
 };
 
 } /* namespace easyhttpcpp */
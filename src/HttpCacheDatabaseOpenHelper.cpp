@@ -2,16 +2,42 @@
  * Copyright 2019 Sony Corporation
  */
 
+#include <set>
 #include <string>
+#include <utility>
+#include <vector>
+
+#include "Poco/Exception.h"
+#include "Poco/File.h"
+#include "Poco/NumberParser.h"
+
+#include "easyhttpcpp/common/CoreLogger.h"
+#include "easyhttpcpp/common/FileUtil.h"
+#include "easyhttpcpp/common/StringUtil.h"
+#include "easyhttpcpp/db/AutoSqliteCursor.h"
+#include "easyhttpcpp/db/AutoSqliteTransaction.h"
+#include "easyhttpcpp/db/SqlException.h"
 
 #include "HttpCacheDatabaseOpenHelper.h"
+#include "HttpDigestCacheKeyHasher.h"
 #include "HttpInternalConstants.h"
+#include "HttpUtil.h"
 
+using easyhttpcpp::common::FileUtil;
+using easyhttpcpp::common::StringUtil;
+using easyhttpcpp::db::AutoSqliteCursor;
+using easyhttpcpp::db::AutoSqliteTransaction;
+using easyhttpcpp::db::ContentValues;
+using easyhttpcpp::db::SqlDatabaseCorruptException;
+using easyhttpcpp::db::SqlException;
+using easyhttpcpp::db::SqliteCursor;
 using easyhttpcpp::db::SqliteDatabase;
 using easyhttpcpp::db::SqliteOpenHelper;
 
 namespace easyhttpcpp {
 
+static const std::string Tag = "HttpCacheDatabaseOpenHelper";
+
 static const std::string KeyId = "id";
 static const std::string KeyCacheKey = "cache_key";
 static const std::string KeyUrl = "url";
@@ -25,9 +51,25 @@ static const std::string KeyReceivedResponseAtEpoch = "received_response_at_epoc
 static const std::string KeyCreatedAtEpoch = "created_at_epoch";
 static const std::string KeyLastAccessedAtEpoch = "last_accessed_at_epoch";
 
-HttpCacheDatabaseOpenHelper::HttpCacheDatabaseOpenHelper(const Poco::Path& databaseFile) :
-        SqliteOpenHelper(databaseFile, HttpInternalConstants::Database::Version)
+namespace {
+
+struct CacheKeyRow {
+    long long m_id;
+    std::string m_key;
+    Request::HttpMethod m_method;
+    std::string m_url;
+};
+
+} /* namespace */
+
+HttpCacheDatabaseOpenHelper::HttpCacheDatabaseOpenHelper(const Poco::Path& databaseFile,
+        HttpCacheKeyHasher::Ptr pKeyHasher, unsigned int dataDirFanOutLevels) :
+        SqliteOpenHelper(databaseFile, HttpInternalConstants::Database::Version), m_pKeyHasher(pKeyHasher),
+        m_dataDirFanOutLevels(dataDirFanOutLevels)
 {
+    if (!m_pKeyHasher) {
+        m_pKeyHasher = HttpCacheKeyHasher::createDefaultHasher();
+    }
 }
 
 HttpCacheDatabaseOpenHelper::~HttpCacheDatabaseOpenHelper()
@@ -43,18 +85,346 @@ void HttpCacheDatabaseOpenHelper::onCreate(SqliteDatabase& db)
             HttpInternalConstants::Database::Key::Method + " INTEGER, " +
             HttpInternalConstants::Database::Key::StatusCode + " INTEGER, " +
             HttpInternalConstants::Database::Key::StatusMessage + " TEXT, " +
-            HttpInternalConstants::Database::Key::ResponseHeaderJson + " TEXT, " +
+            HttpInternalConstants::Database::Key::ResponseHeaders + " TEXT, " +
             HttpInternalConstants::Database::Key::ResponseBodySize + " INTEGER, " +
             HttpInternalConstants::Database::Key::SentRequestAtEpoch + " INTEGER, " +
             HttpInternalConstants::Database::Key::ReceivedResponseAtEpoch + " INTEGER, " +
             HttpInternalConstants::Database::Key::CreatedAtEpoch + " INTEGER, " +
-            HttpInternalConstants::Database::Key::LastAccessedAtEpoch + " INTEGER )";
+            HttpInternalConstants::Database::Key::LastAccessedAtEpoch + " INTEGER, " +
+            HttpInternalConstants::Database::Key::ResponseDateAtEpoch + " INTEGER DEFAULT -1, " +
+            HttpInternalConstants::Database::Key::ExpiresAtEpoch + " INTEGER DEFAULT -1, " +
+            HttpInternalConstants::Database::Key::LastModifiedAtEpoch + " INTEGER DEFAULT -1, " +
+            HttpInternalConstants::Database::Key::AgeSec + " INTEGER DEFAULT -1, " +
+            HttpInternalConstants::Database::Key::MaxAgeSec + " INTEGER DEFAULT -1, " +
+            HttpInternalConstants::Database::Key::SMaxAgeSec + " INTEGER DEFAULT -1, " +
+            HttpInternalConstants::Database::Key::NoCache + " INTEGER DEFAULT 0, " +
+            HttpInternalConstants::Database::Key::MustRevalidate + " INTEGER DEFAULT 0, " +
+            HttpInternalConstants::Database::Key::ETag + " TEXT DEFAULT '', " +
+            HttpInternalConstants::Database::Key::LastModified + " TEXT DEFAULT '', " +
+            HttpInternalConstants::Database::Key::ResponseBody + " BLOB, " +
+            HttpInternalConstants::Database::Key::ResponseBodyCompressed + " INTEGER DEFAULT 0 )";
     db.execSql(sqlCmd);
+
+    createPropertiesTable(db);
+    setProperty(db, HttpInternalConstants::Database::Property::KeyHasherName, m_pKeyHasher->getName());
+    setProperty(db, HttpInternalConstants::Database::Property::DataDirFanOutLevels,
+            StringUtil::format("%u", m_dataDirFanOutLevels));
+}
+
+void HttpCacheDatabaseOpenHelper::onConfigure(SqliteDatabase& db)
+{
+    // the cache database can be rebuilt, so favor write throughput over durability of the last transactions.
+    // WAL lets readers run while a metadata update is written and needs fsync only on checkpoint.
+    try {
+        db.setJournalMode(SqliteDatabase::JournalModeWal);
+        db.setSynchronous(SqliteDatabase::SynchronousNormal);
+        db.setCacheSize(-HttpInternalConstants::Database::CacheSizeKiB);
+        db.setMmapSize(HttpInternalConstants::Database::MmapSize);
+        db.setBusyTimeout(HttpInternalConstants::Database::BusyTimeoutMs);
+    } catch (const SqlDatabaseCorruptException&) {
+        throw;
+    } catch (const SqlException& e) {
+        // database works with default settings, so continue processing.
+        EASYHTTPCPP_LOG_W(Tag, "Failed to configure cache database.");
+        EASYHTTPCPP_LOG_D(Tag, "Failed to configure cache database. Details: %s", e.getMessage().c_str());
+    }
 }
 
 void HttpCacheDatabaseOpenHelper::onUpgrade(SqliteDatabase& db, unsigned int oldVersion,
         unsigned int newVersion)
 {
+    EASYHTTPCPP_LOG_D(Tag, "onUpgrade: version %u -> %u", oldVersion, newVersion);
+    if (oldVersion < 2) {
+        addFreshnessColumns(db);
+    }
+    if (oldVersion < 3) {
+        convertResponseHeadersToBinary(db);
+    }
+    if (oldVersion < 4) {
+        // keys of older versions are message digests; onOpen makes them again only for another hasher.
+        createPropertiesTable(db);
+        setProperty(db, HttpInternalConstants::Database::Property::KeyHasherName, HttpDigestCacheKeyHasher::Name);
+    }
+    if (oldVersion < 5) {
+        // existing response bodies stay in their files.
+        db.execSql(std::string("ALTER TABLE ") + HttpInternalConstants::Database::TableName + " ADD COLUMN " +
+                HttpInternalConstants::Database::Key::ResponseBody + " BLOB");
+    }
+    if (oldVersion < 6) {
+        // existing response bodies are not compressed.
+        db.execSql(std::string("ALTER TABLE ") + HttpInternalConstants::Database::TableName + " ADD COLUMN " +
+                HttpInternalConstants::Database::Key::ResponseBodyCompressed + " INTEGER DEFAULT 0");
+    }
+}
+
+void HttpCacheDatabaseOpenHelper::onOpen(SqliteDatabase& db)
+{
+    std::string keyHasherName = getProperty(db, HttpInternalConstants::Database::Property::KeyHasherName);
+    // caches written before the layout was recorded have all files in the cache root directory.
+    unsigned int oldDataDirFanOutLevels = 0;
+    if (!Poco::NumberParser::tryParseUnsigned(getProperty(db,
+            HttpInternalConstants::Database::Property::DataDirFanOutLevels), oldDataDirFanOutLevels)) {
+        oldDataDirFanOutLevels = 0;
+    }
+    if (keyHasherName == m_pKeyHasher->getName() && oldDataDirFanOutLevels == m_dataDirFanOutLevels) {
+        return;
+    }
+
+    // the cache was written with another hasher or layout. keys are made again from the stored method and url,
+    // and the files are moved to the current layout, so that the cached responses are still found.
+    std::vector<std::pair<std::string, std::string> > renamedKeys;
+    {
+        AutoSqliteTransaction autoSqliteTransaction(SqliteDatabase::Ptr(&db, true));
+        if (keyHasherName != m_pKeyHasher->getName()) {
+            remakeCacheKeys(db, renamedKeys);
+            setProperty(db, HttpInternalConstants::Database::Property::KeyHasherName, m_pKeyHasher->getName());
+        } else {
+            getCacheKeys(db, renamedKeys);
+        }
+        setProperty(db, HttpInternalConstants::Database::Property::DataDirFanOutLevels,
+                StringUtil::format("%u", m_dataDirFanOutLevels));
+        db.setTransactionSuccessful();
+    }
+
+    // files are moved after the commit. if the process stops meanwhile, the entries are only missed; their files
+    // are removed as orphans when the index is loaded.
+    moveCachedFiles(renamedKeys, oldDataDirFanOutLevels);
+    EASYHTTPCPP_LOG_D(Tag, "onOpen: moved %zu cached files with %s.", renamedKeys.size(),
+            m_pKeyHasher->getName().c_str());
+}
+
+void HttpCacheDatabaseOpenHelper::putFreshness(ContentValues& values, const HttpCacheFreshness& freshness)
+{
+    values.put(HttpInternalConstants::Database::Key::ResponseDateAtEpoch, freshness.getResponseDateAtEpoch());
+    values.put(HttpInternalConstants::Database::Key::ExpiresAtEpoch, freshness.getExpiresAtEpoch());
+    values.put(HttpInternalConstants::Database::Key::LastModifiedAtEpoch, freshness.getLastModifiedAtEpoch());
+    values.put(HttpInternalConstants::Database::Key::AgeSec, freshness.getAgeSec());
+    values.put(HttpInternalConstants::Database::Key::MaxAgeSec, freshness.getMaxAgeSec());
+    values.put(HttpInternalConstants::Database::Key::SMaxAgeSec, freshness.getSMaxAgeSec());
+    values.put(HttpInternalConstants::Database::Key::NoCache, freshness.isNoCache() ? 1 : 0);
+    values.put(HttpInternalConstants::Database::Key::MustRevalidate, freshness.isMustRevalidate() ? 1 : 0);
+    values.put(HttpInternalConstants::Database::Key::ETag, freshness.getETag());
+    values.put(HttpInternalConstants::Database::Key::LastModified, freshness.getLastModified());
+}
+
+void HttpCacheDatabaseOpenHelper::addFreshnessColumns(SqliteDatabase& db)
+{
+    static const char* const IntegerColumns[] = {
+        HttpInternalConstants::Database::Key::ResponseDateAtEpoch,
+        HttpInternalConstants::Database::Key::ExpiresAtEpoch,
+        HttpInternalConstants::Database::Key::LastModifiedAtEpoch,
+        HttpInternalConstants::Database::Key::AgeSec,
+        HttpInternalConstants::Database::Key::MaxAgeSec,
+        HttpInternalConstants::Database::Key::SMaxAgeSec
+    };
+    static const char* const FlagColumns[] = {
+        HttpInternalConstants::Database::Key::NoCache,
+        HttpInternalConstants::Database::Key::MustRevalidate
+    };
+    static const char* const TextColumns[] = {
+        HttpInternalConstants::Database::Key::ETag,
+        HttpInternalConstants::Database::Key::LastModified
+    };
+    std::string alterTable = std::string("ALTER TABLE ") + HttpInternalConstants::Database::TableName +
+            " ADD COLUMN ";
+    for (size_t i = 0; i < sizeof(IntegerColumns) / sizeof(IntegerColumns[0]); i++) {
+        db.execSql(alterTable + IntegerColumns[i] + " INTEGER DEFAULT -1");
+    }
+    for (size_t i = 0; i < sizeof(FlagColumns) / sizeof(FlagColumns[0]); i++) {
+        db.execSql(alterTable + FlagColumns[i] + " INTEGER DEFAULT 0");
+    }
+    for (size_t i = 0; i < sizeof(TextColumns) / sizeof(TextColumns[0]); i++) {
+        db.execSql(alterTable + TextColumns[i] + " TEXT DEFAULT ''");
+    }
+
+    // fill the new columns of existing rows from their response headers.
+    std::vector<std::pair<std::string, std::string> > rows;
+    {
+        std::vector<std::string> columns;
+        columns.push_back(HttpInternalConstants::Database::Key::CacheKey);
+        columns.push_back(HttpInternalConstants::Database::Key::ResponseHeaderJson);
+        SqliteCursor::Ptr pCursor = db.query(HttpInternalConstants::Database::TableName, &columns, NULL, NULL,
+                NULL, NULL, NULL, NULL);
+        AutoSqliteCursor autoSqliteCursor(pCursor);
+        if (pCursor->moveToFirst()) {
+            do {
+                rows.push_back(std::make_pair(pCursor->getString(0), pCursor->getString(1)));
+            } while (pCursor->moveToNext());
+        }
+    }
+    std::string whereClause = std::string(HttpInternalConstants::Database::Key::CacheKey) + "=?";
+    for (size_t i = 0; i < rows.size(); i++) {
+        HttpCacheFreshness::Ptr pFreshness = HttpCacheFreshness::createFromHeaders(
+                HttpUtil::exchangeJsonStrToHeaders(rows[i].second));
+        ContentValues values;
+        putFreshness(values, *pFreshness);
+        std::vector<std::string> whereArgs;
+        whereArgs.push_back(rows[i].first);
+        db.update(HttpInternalConstants::Database::TableName, values, &whereClause, &whereArgs);
+    }
+    EASYHTTPCPP_LOG_D(Tag, "addFreshnessColumns: filled %zu rows.", rows.size());
+}
+
+void HttpCacheDatabaseOpenHelper::convertResponseHeadersToBinary(SqliteDatabase& db)
+{
+    // SQLite can not drop a column, so the JSON column is left empty.
+    db.execSql(std::string("ALTER TABLE ") + HttpInternalConstants::Database::TableName + " ADD COLUMN " +
+            HttpInternalConstants::Database::Key::ResponseHeaders + " TEXT");
+
+    std::vector<std::pair<std::string, std::string> > rows;
+    {
+        std::vector<std::string> columns;
+        columns.push_back(HttpInternalConstants::Database::Key::CacheKey);
+        columns.push_back(HttpInternalConstants::Database::Key::ResponseHeaderJson);
+        SqliteCursor::Ptr pCursor = db.query(HttpInternalConstants::Database::TableName, &columns, NULL, NULL,
+                NULL, NULL, NULL, NULL);
+        AutoSqliteCursor autoSqliteCursor(pCursor);
+        if (pCursor->moveToFirst()) {
+            do {
+                rows.push_back(std::make_pair(pCursor->getString(0), pCursor->getString(1)));
+            } while (pCursor->moveToNext());
+        }
+    }
+    std::string whereClause = std::string(HttpInternalConstants::Database::Key::CacheKey) + "=?";
+    for (size_t i = 0; i < rows.size(); i++) {
+        ContentValues values;
+        values.put(HttpInternalConstants::Database::Key::ResponseHeaders,
+                HttpUtil::exchangeHeadersToBinaryStr(HttpUtil::exchangeJsonStrToHeaders(rows[i].second)));
+        values.put(HttpInternalConstants::Database::Key::ResponseHeaderJson, std::string());
+        std::vector<std::string> whereArgs;
+        whereArgs.push_back(rows[i].first);
+        db.update(HttpInternalConstants::Database::TableName, values, &whereClause, &whereArgs);
+    }
+    EASYHTTPCPP_LOG_D(Tag, "convertResponseHeadersToBinary: converted %zu rows.", rows.size());
+}
+
+void HttpCacheDatabaseOpenHelper::createPropertiesTable(SqliteDatabase& db)
+{
+    db.execSql(std::string("CREATE TABLE IF NOT EXISTS ") + HttpInternalConstants::Database::PropertiesTableName +
+            " (" + HttpInternalConstants::Database::Property::Name + " TEXT PRIMARY KEY, " +
+            HttpInternalConstants::Database::Property::Value + " TEXT)");
+}
+
+std::string HttpCacheDatabaseOpenHelper::getProperty(SqliteDatabase& db, const std::string& name)
+{
+    std::vector<std::string> columns;
+    columns.push_back(HttpInternalConstants::Database::Property::Value);
+    std::string selection = std::string(HttpInternalConstants::Database::Property::Name) + "=?";
+    std::vector<std::string> selectionArgs;
+    selectionArgs.push_back(name);
+    SqliteCursor::Ptr pCursor = db.query(HttpInternalConstants::Database::PropertiesTableName, &columns, &selection,
+            &selectionArgs, NULL, NULL, NULL, NULL);
+    AutoSqliteCursor autoSqliteCursor(pCursor);
+    if (!pCursor->moveToFirst()) {
+        return "";
+    }
+    return pCursor->getString(0);
+}
+
+void HttpCacheDatabaseOpenHelper::setProperty(SqliteDatabase& db, const std::string& name,
+        const std::string& value)
+{
+    ContentValues values;
+    values.put(HttpInternalConstants::Database::Property::Name, name);
+    values.put(HttpInternalConstants::Database::Property::Value, value);
+    db.replace(HttpInternalConstants::Database::PropertiesTableName, values);
+}
+
+void HttpCacheDatabaseOpenHelper::remakeCacheKeys(SqliteDatabase& db,
+        std::vector<std::pair<std::string, std::string> >& renamedKeys)
+{
+    std::vector<CacheKeyRow> rows;
+    {
+        std::vector<std::string> columns;
+        columns.push_back(HttpInternalConstants::Database::Key::Id);
+        columns.push_back(HttpInternalConstants::Database::Key::CacheKey);
+        columns.push_back(HttpInternalConstants::Database::Key::Method);
+        columns.push_back(HttpInternalConstants::Database::Key::Url);
+        SqliteCursor::Ptr pCursor = db.query(HttpInternalConstants::Database::TableName, &columns, NULL, NULL,
+                NULL, NULL, NULL, NULL);
+        AutoSqliteCursor autoSqliteCursor(pCursor);
+        if (pCursor->moveToFirst()) {
+            do {
+                CacheKeyRow row;
+                row.m_id = pCursor->getLongLong(0);
+                row.m_key = pCursor->getString(1);
+                row.m_method = static_cast<Request::HttpMethod>(pCursor->getInt(2));
+                row.m_url = pCursor->getString(3);
+                rows.push_back(row);
+            } while (pCursor->moveToNext());
+        }
+    }
+
+    // keys are unique, so they are replaced with temporary ones first; a new key may equal an old key of
+    // another row.
+    db.execSql(std::string("UPDATE ") + HttpInternalConstants::Database::TableName + " SET " +
+            HttpInternalConstants::Database::Key::CacheKey + "='~'||" + HttpInternalConstants::Database::Key::Id);
+
+    std::set<std::string> newKeys;
+    std::string whereClause = std::string(HttpInternalConstants::Database::Key::Id) + "=?";
+    for (size_t i = 0; i < rows.size(); i++) {
+        std::vector<std::string> whereArgs;
+        whereArgs.push_back(StringUtil::format("%lld", rows[i].m_id));
+        std::string newKey = HttpUtil::makeCacheKey(m_pKeyHasher, rows[i].m_method, rows[i].m_url);
+        if (newKey.empty() || !newKeys.insert(newKey).second) {
+            // two requests have the same key with the new hasher; only the first one is kept.
+            EASYHTTPCPP_LOG_D(Tag, "remakeCacheKeys: drop cache of %s", rows[i].m_url.c_str());
+            db.deleteRows(HttpInternalConstants::Database::TableName, &whereClause, &whereArgs);
+            renamedKeys.push_back(std::make_pair(rows[i].m_key, std::string()));
+            continue;
+        }
+        ContentValues values;
+        values.put(HttpInternalConstants::Database::Key::CacheKey, newKey);
+        db.update(HttpInternalConstants::Database::TableName, values, &whereClause, &whereArgs);
+        renamedKeys.push_back(std::make_pair(rows[i].m_key, newKey));
+    }
+}
+
+void HttpCacheDatabaseOpenHelper::getCacheKeys(SqliteDatabase& db,
+        std::vector<std::pair<std::string, std::string> >& keys)
+{
+    std::vector<std::string> columns;
+    columns.push_back(HttpInternalConstants::Database::Key::CacheKey);
+    SqliteCursor::Ptr pCursor = db.query(HttpInternalConstants::Database::TableName, &columns, NULL, NULL,
+            NULL, NULL, NULL, NULL);
+    AutoSqliteCursor autoSqliteCursor(pCursor);
+    if (pCursor->moveToFirst()) {
+        do {
+            std::string key = pCursor->getString(0);
+            keys.push_back(std::make_pair(key, key));
+        } while (pCursor->moveToNext());
+    }
+}
+
+void HttpCacheDatabaseOpenHelper::moveCachedFiles(const std::vector<std::pair<std::string, std::string> >& renamedKeys,
+        unsigned int oldDataDirFanOutLevels)
+{
+    Poco::Path cacheRootDir = getDatabasePath().parent();
+    for (size_t i = 0; i < renamedKeys.size(); i++) {
+        Poco::File oldFile(HttpUtil::makeCachedResponseBodyFilename(cacheRootDir, renamedKeys[i].first,
+                oldDataDirFanOutLevels));
+        if (renamedKeys[i].second.empty()) {
+            FileUtil::removeFileIfPresent(oldFile);
+            continue;
+        }
+        try {
+            // a response body stored in the database has no file.
+            if (!oldFile.exists()) {
+                continue;
+            }
+        } catch (const Poco::Exception&) {
+            continue;
+        }
+        Poco::Path newPath(HttpUtil::makeCachedResponseBodyFilename(cacheRootDir, renamedKeys[i].second,
+                m_dataDirFanOutLevels));
+        if (newPath.toString() == oldFile.path()) {
+            continue;
+        }
+        if (!FileUtil::createDirsIfAbsent(Poco::File(newPath.parent())) ||
+                !FileUtil::moveFile(oldFile, Poco::File(newPath))) {
+            EASYHTTPCPP_LOG_D(Tag, "moveCachedFiles: can not move cached file. [%s]", oldFile.path().c_str());
+        }
+    }
 }
 
 } /* namespace easyhttpcpp */
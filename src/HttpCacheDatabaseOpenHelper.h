@@ -5,13 +5,22 @@
 #ifndef EASYHTTPCPP_HTTPCACHEDATABASEOPENHELPER_H_INCLUDED
 #define EASYHTTPCPP_HTTPCACHEDATABASEOPENHELPER_H_INCLUDED
 
+#include <string>
+#include <utility>
+#include <vector>
+
 #include "Poco/AutoPtr.h"
 #include "Poco/RefCountedObject.h"
 #include "Poco/Path.h"
 
+#include "easyhttpcpp/db/ContentValues.h"
 #include "easyhttpcpp/db/SqliteOpenHelper.h"
+#include "easyhttpcpp/HttpCacheKeyHasher.h"
 #include "easyhttpcpp/HttpExports.h"
 
+#include "HttpCacheFreshness.h"
+#include "HttpInternalConstants.h"
+
 namespace easyhttpcpp {
 
 class EASYHTTPCPP_HTTP_INTERNAL_API HttpCacheDatabaseOpenHelper : public easyhttpcpp::db::SqliteOpenHelper,
@@ -19,11 +28,33 @@ public Poco::RefCountedObject {
 public:
     typedef Poco::AutoPtr<HttpCacheDatabaseOpenHelper> Ptr;
 
-    HttpCacheDatabaseOpenHelper(const Poco::Path& databaseFile);
+    // if pKeyHasher is NULL, the default hasher is used.
+    // response body files in the directory of the database are moved when the hasher or the layout is changed.
+    HttpCacheDatabaseOpenHelper(const Poco::Path& databaseFile, HttpCacheKeyHasher::Ptr pKeyHasher = NULL,
+            unsigned int dataDirFanOutLevels = HttpInternalConstants::Caches::DataDirFanOutLevels);
     virtual ~HttpCacheDatabaseOpenHelper();
 
     void onCreate(easyhttpcpp::db::SqliteDatabase& db);
+    void onConfigure(easyhttpcpp::db::SqliteDatabase& db);
+    void onOpen(easyhttpcpp::db::SqliteDatabase& db);
     void onUpgrade(easyhttpcpp::db::SqliteDatabase& db, unsigned int oldVersion, unsigned int newVersion);
+
+    static void putFreshness(easyhttpcpp::db::ContentValues& values, const HttpCacheFreshness& freshness);
+
+private:
+    void addFreshnessColumns(easyhttpcpp::db::SqliteDatabase& db);
+    void convertResponseHeadersToBinary(easyhttpcpp::db::SqliteDatabase& db);
+    void createPropertiesTable(easyhttpcpp::db::SqliteDatabase& db);
+    std::string getProperty(easyhttpcpp::db::SqliteDatabase& db, const std::string& name);
+    void setProperty(easyhttpcpp::db::SqliteDatabase& db, const std::string& name, const std::string& value);
+    void remakeCacheKeys(easyhttpcpp::db::SqliteDatabase& db,
+            std::vector<std::pair<std::string, std::string> >& renamedKeys);
+    void getCacheKeys(easyhttpcpp::db::SqliteDatabase& db, std::vector<std::pair<std::string, std::string> >& keys);
+    void moveCachedFiles(const std::vector<std::pair<std::string, std::string> >& renamedKeys,
+            unsigned int oldDataDirFanOutLevels);
+
+    HttpCacheKeyHasher::Ptr m_pKeyHasher;
+    unsigned int m_dataDirFanOutLevels;
 };
 
 } /* namespace easyhttpcpp */
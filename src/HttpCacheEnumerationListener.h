@@ -5,6 +5,9 @@
 #ifndef EASYHTTPCPP_HTTPCACHEENUMERATIONLISTENER_H_INCLUDED
 #define EASYHTTPCPP_HTTPCACHEENUMERATIONLISTENER_H_INCLUDED
 
+#include <ctime>
+#include <string>
+
 namespace easyhttpcpp {
 
 class HttpCacheEnumerationListener {
@@ -21,6 +24,8 @@ public:
     struct EnumerationParam {
         std::string m_key;
         size_t m_responseBodySize;
+        long long m_id;
+        std::time_t m_lastAccessedAtEpoch;
     };
 };
 
@@ -0,0 +1,47 @@
+/*
+ * Copyright 2019 Sony Corporation
+ */
+
+#include "easyhttpcpp/common/CoreLogger.h"
+#include "easyhttpcpp/HttpException.h"
+
+#include "HttpCacheFillTask.h"
+#include "ResponseBodyStreamWithCaching.h"
+
+namespace easyhttpcpp {
+
+static const std::string Tag = "HttpCacheFillTask";
+
+HttpCacheFillTask::HttpCacheFillTask(EasyHttpContext::Ptr pContext,
+        ResponseBodyStream::Ptr pResponseBodyStreamWithCaching) : m_pContext(pContext),
+        m_pResponseBodyStream(pResponseBodyStreamWithCaching)
+{
+}
+
+HttpCacheFillTask::~HttpCacheFillTask()
+{
+}
+
+void HttpCacheFillTask::runTask()
+{
+    // runs even if cancelled before start, so that the connection is given back.
+    try {
+        static_cast<ResponseBodyStreamWithCaching*> (m_pResponseBodyStream.get())->fillCacheInBackground(
+                HttpExecutionTask::Ptr(this, true));
+        EASYHTTPCPP_LOG_D(Tag, "cache fill finished.");
+    } catch (const HttpException& e) {
+        EASYHTTPCPP_LOG_D(Tag, "Error while filling cache. Details: %s", e.getMessage().c_str());
+    } catch (const std::exception& e) {
+        EASYHTTPCPP_LOG_D(Tag, "Unexpected error while filling cache. Details: %s", e.what());
+    }
+    m_pContext->getHttpExecutionTaskManager()->onComplete(HttpExecutionTask::Ptr(this, true));
+}
+
+bool HttpCacheFillTask::cancel(bool mayInterruptIfRunning)
+{
+    bool ret = HttpExecutionTask::cancel(mayInterruptIfRunning);
+    static_cast<ResponseBodyStreamWithCaching*> (m_pResponseBodyStream.get())->cancelBackgroundCacheFill();
+    return ret;
+}
+
+} /* namespace easyhttpcpp */
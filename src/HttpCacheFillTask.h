@@ -0,0 +1,38 @@
+/*
+ * Copyright 2019 Sony Corporation
+ */
+
+#ifndef EASYHTTPCPP_HTTPCACHEFILLTASK_H_INCLUDED
+#define EASYHTTPCPP_HTTPCACHEFILLTASK_H_INCLUDED
+
+#include "easyhttpcpp/ResponseBodyStream.h"
+
+#include "EasyHttpContext.h"
+#include "HttpExecutionTask.h"
+
+namespace easyhttpcpp {
+
+/**
+ * Reads the rest of a ResponseBodyStreamWithCaching which was closed before the end, so that the response is
+ * stored in HttpCache and the connection is returned to the pool (CacheFillPolicyCompleteInBackground).
+ */
+class HttpCacheFillTask : public HttpExecutionTask {
+public:
+    typedef Poco::AutoPtr<HttpCacheFillTask> Ptr;
+
+    HttpCacheFillTask(EasyHttpContext::Ptr pContext, ResponseBodyStream::Ptr pResponseBodyStreamWithCaching);
+    virtual ~HttpCacheFillTask();
+
+    virtual void runTask();
+    virtual bool cancel(bool mayInterruptIfRunning);
+
+private:
+    HttpCacheFillTask();
+
+    EasyHttpContext::Ptr m_pContext;
+    ResponseBodyStream::Ptr m_pResponseBodyStream;
+};
+
+} /* namespace easyhttpcpp */
+
+#endif /* EASYHTTPCPP_HTTPCACHEFILLTASK_H_INCLUDED */
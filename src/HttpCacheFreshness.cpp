@@ -0,0 +1,163 @@
+/*
+ * Copyright 2019 Sony Corporation
+ */
+
+#include "Poco/NumberParser.h"
+#include "Poco/Timestamp.h"
+
+#include "easyhttpcpp/HttpConstants.h"
+
+#include "HttpCacheFreshness.h"
+#include "HttpUtil.h"
+
+namespace easyhttpcpp {
+
+HttpCacheFreshness::HttpCacheFreshness() : m_responseDateAtEpoch(-1), m_expiresAtEpoch(-1),
+        m_lastModifiedAtEpoch(-1), m_ageSec(-1), m_maxAgeSec(-1), m_sMaxAgeSec(-1), m_noCache(false),
+        m_mustRevalidate(false)
+{
+}
+
+HttpCacheFreshness::~HttpCacheFreshness()
+{
+}
+
+HttpCacheFreshness::Ptr HttpCacheFreshness::createFromHeaders(Headers::Ptr pHeaders)
+{
+    return create(pHeaders, CacheControl::createFromHeaders(pHeaders));
+}
+
+HttpCacheFreshness::Ptr HttpCacheFreshness::create(Headers::Ptr pHeaders, CacheControl::Ptr pCacheControl)
+{
+    HttpCacheFreshness::Ptr pFreshness = new HttpCacheFreshness();
+    if (pHeaders) {
+        pFreshness->m_responseDateAtEpoch = parseDate(pHeaders, HttpConstants::HeaderNames::Date);
+        pFreshness->m_expiresAtEpoch = parseDate(pHeaders, HttpConstants::HeaderNames::Expires);
+        pFreshness->m_lastModifiedAtEpoch = parseDate(pHeaders, HttpConstants::HeaderNames::LastModified);
+        Poco::Int64 ageSec;
+        if (pHeaders->has(HttpConstants::HeaderNames::Age) &&
+                Poco::NumberParser::tryParse64(pHeaders->getValue(HttpConstants::HeaderNames::Age, ""), ageSec)) {
+            pFreshness->m_ageSec = ageSec;
+        }
+        pFreshness->m_eTag = pHeaders->getValue(HttpConstants::HeaderNames::ETag, "");
+        pFreshness->m_lastModified = pHeaders->getValue(HttpConstants::HeaderNames::LastModified, "");
+    }
+    if (pCacheControl) {
+        pFreshness->m_maxAgeSec = pCacheControl->getMaxAgeSec();
+        pFreshness->m_sMaxAgeSec = pCacheControl->getSMaxAgeSec();
+        pFreshness->m_noCache = pCacheControl->isNoCache();
+        pFreshness->m_mustRevalidate = pCacheControl->isMustRevalidate();
+    }
+    return pFreshness;
+}
+
+void HttpCacheFreshness::setResponseDateAtEpoch(long long responseDateAtEpoch)
+{
+    m_responseDateAtEpoch = responseDateAtEpoch;
+}
+
+long long HttpCacheFreshness::getResponseDateAtEpoch() const
+{
+    return m_responseDateAtEpoch;
+}
+
+void HttpCacheFreshness::setExpiresAtEpoch(long long expiresAtEpoch)
+{
+    m_expiresAtEpoch = expiresAtEpoch;
+}
+
+long long HttpCacheFreshness::getExpiresAtEpoch() const
+{
+    return m_expiresAtEpoch;
+}
+
+void HttpCacheFreshness::setLastModifiedAtEpoch(long long lastModifiedAtEpoch)
+{
+    m_lastModifiedAtEpoch = lastModifiedAtEpoch;
+}
+
+long long HttpCacheFreshness::getLastModifiedAtEpoch() const
+{
+    return m_lastModifiedAtEpoch;
+}
+
+void HttpCacheFreshness::setAgeSec(long long ageSec)
+{
+    m_ageSec = ageSec;
+}
+
+long long HttpCacheFreshness::getAgeSec() const
+{
+    return m_ageSec;
+}
+
+void HttpCacheFreshness::setMaxAgeSec(long long maxAgeSec)
+{
+    m_maxAgeSec = maxAgeSec;
+}
+
+long long HttpCacheFreshness::getMaxAgeSec() const
+{
+    return m_maxAgeSec;
+}
+
+void HttpCacheFreshness::setSMaxAgeSec(long long sMaxAgeSec)
+{
+    m_sMaxAgeSec = sMaxAgeSec;
+}
+
+long long HttpCacheFreshness::getSMaxAgeSec() const
+{
+    return m_sMaxAgeSec;
+}
+
+void HttpCacheFreshness::setNoCache(bool noCache)
+{
+    m_noCache = noCache;
+}
+
+bool HttpCacheFreshness::isNoCache() const
+{
+    return m_noCache;
+}
+
+void HttpCacheFreshness::setMustRevalidate(bool mustRevalidate)
+{
+    m_mustRevalidate = mustRevalidate;
+}
+
+bool HttpCacheFreshness::isMustRevalidate() const
+{
+    return m_mustRevalidate;
+}
+
+void HttpCacheFreshness::setETag(const std::string& eTag)
+{
+    m_eTag = eTag;
+}
+
+const std::string& HttpCacheFreshness::getETag() const
+{
+    return m_eTag;
+}
+
+void HttpCacheFreshness::setLastModified(const std::string& lastModified)
+{
+    m_lastModified = lastModified;
+}
+
+const std::string& HttpCacheFreshness::getLastModified() const
+{
+    return m_lastModified;
+}
+
+long long HttpCacheFreshness::parseDate(Headers::Ptr pHeaders, const std::string& name)
+{
+    Poco::Timestamp timestamp;
+    if (pHeaders->has(name) && HttpUtil::tryParseDate(pHeaders->getValue(name, ""), timestamp)) {
+        return static_cast<long long>(timestamp.epochTime());
+    }
+    return -1;
+}
+
+} /* namespace easyhttpcpp */
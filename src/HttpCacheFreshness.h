@@ -0,0 +1,72 @@
+/*
+ * Copyright 2019 Sony Corporation
+ */
+
+#ifndef EASYHTTPCPP_HTTPCACHEFRESHNESS_H_INCLUDED
+#define EASYHTTPCPP_HTTPCACHEFRESHNESS_H_INCLUDED
+
+#include <string>
+
+#include "Poco/AutoPtr.h"
+#include "Poco/RefCountedObject.h"
+
+#include "easyhttpcpp/CacheControl.h"
+#include "easyhttpcpp/Headers.h"
+#include "easyhttpcpp/HttpExports.h"
+
+namespace easyhttpcpp {
+
+/**
+ * Response headers which decide freshness of a cached response, parsed once when the response is stored.
+ * Times and seconds are -1 when the header or directive does not exist or can not be parsed.
+ */
+class EASYHTTPCPP_HTTP_INTERNAL_API HttpCacheFreshness : public Poco::RefCountedObject {
+public:
+    typedef Poco::AutoPtr<HttpCacheFreshness> Ptr;
+
+    HttpCacheFreshness();
+    virtual ~HttpCacheFreshness();
+
+    static HttpCacheFreshness::Ptr createFromHeaders(Headers::Ptr pHeaders);
+    static HttpCacheFreshness::Ptr create(Headers::Ptr pHeaders, CacheControl::Ptr pCacheControl);
+
+    void setResponseDateAtEpoch(long long responseDateAtEpoch);
+    long long getResponseDateAtEpoch() const;
+    void setExpiresAtEpoch(long long expiresAtEpoch);
+    long long getExpiresAtEpoch() const;
+    void setLastModifiedAtEpoch(long long lastModifiedAtEpoch);
+    long long getLastModifiedAtEpoch() const;
+    void setAgeSec(long long ageSec);
+    long long getAgeSec() const;
+    void setMaxAgeSec(long long maxAgeSec);
+    long long getMaxAgeSec() const;
+    void setSMaxAgeSec(long long sMaxAgeSec);
+    long long getSMaxAgeSec() const;
+    void setNoCache(bool noCache);
+    bool isNoCache() const;
+    void setMustRevalidate(bool mustRevalidate);
+    bool isMustRevalidate() const;
+    // raw header values; they are sent back as validators.
+    void setETag(const std::string& eTag);
+    const std::string& getETag() const;
+    void setLastModified(const std::string& lastModified);
+    const std::string& getLastModified() const;
+
+private:
+    static long long parseDate(Headers::Ptr pHeaders, const std::string& name);
+
+    long long m_responseDateAtEpoch;
+    long long m_expiresAtEpoch;
+    long long m_lastModifiedAtEpoch;
+    long long m_ageSec;
+    long long m_maxAgeSec;
+    long long m_sMaxAgeSec;
+    bool m_noCache;
+    bool m_mustRevalidate;
+    std::string m_eTag;
+    std::string m_lastModified;
+};
+
+} /* namespace easyhttpcpp */
+
+#endif /* EASYHTTPCPP_HTTPCACHEFRESHNESS_H_INCLUDED */
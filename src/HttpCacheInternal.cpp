@@ -2,8 +2,12 @@
  * Copyright 2017 Sony Corporation
  */
 
+#include <algorithm>
+
+#include "Poco/Exception.h"
 #include "Poco/File.h"
-#include "Poco/NumberParser.h"
+#include "Poco/Net/HTTPResponse.h"
+#include "Poco/String.h"
 #include "Poco/Timestamp.h"
 
 #include "easyhttpcpp/common/Cache.h"
@@ -12,16 +16,16 @@
 #include "easyhttpcpp/common/CoreLogger.h"
 #include "easyhttpcpp/common/FileUtil.h"
 #include "easyhttpcpp/common/StringUtil.h"
-#include "easyhttpcpp/CacheControl.h"
 #include "easyhttpcpp/HttpConstants.h"
 #include "easyhttpcpp/HttpException.h"
-#include "easyhttpcpp/Headers.h"
 #include "easyhttpcpp/Request.h"
 
+#include "ContentDecodingInputStream.h"
 #include "HttpCacheInternal.h"
 #include "HttpCacheMetadata.h"
 #include "HttpFileCache.h"
 #include "HttpInternalConstants.h"
+#include "HttpMemoryCache.h"
 #include "HttpUtil.h"
 
 using easyhttpcpp::common::Cache;
@@ -34,24 +38,75 @@ namespace easyhttpcpp {
 
 static const std::string Tag = "HttpCacheInternal";
 
-HttpCacheInternal::HttpCacheInternal(const Poco::Path& path, size_t maxSize) : m_maxSize(maxSize)
+namespace {
+
+// content-encoded response bodies and most media are compressed already, so they are not worth compressing.
+bool isCompressibleResponseBody(Response::Ptr pResponse)
+{
+    std::string contentEncoding = pResponse->getHeaderValue(HttpConstants::HeaderNames::ContentEncoding, "");
+    if (!contentEncoding.empty() && Poco::icompare(contentEncoding, "identity") != 0) {
+        return false;
+    }
+    std::string contentType = pResponse->getHeaderValue(HttpConstants::HeaderNames::ContentType, "");
+    if (Poco::icompare(contentType, 0, 9, "image/svg") == 0) {
+        return true;
+    }
+    return Poco::icompare(contentType, 0, 6, "image/") != 0 && Poco::icompare(contentType, 0, 6, "audio/") != 0 &&
+            Poco::icompare(contentType, 0, 6, "video/") != 0;
+}
+
+} /* namespace */
+
+HttpCacheInternal::HttpCacheInternal(const Poco::Path& path, size_t maxSize) : m_maxSize(maxSize),
+        m_pKeyHasher(HttpCacheKeyHasher::createDefaultHasher())
+{
+    initialize(path, 0, 0, HttpInternalConstants::Caches::DataDirFanOutLevels, EvictionPolicyLru, BodyCompressionNone);
+}
+
+HttpCacheInternal::HttpCacheInternal(const HttpCache::Builder& builder) : m_maxSize(builder.getMaxSize()),
+        m_pKeyHasher(builder.getKeyHasher())
+{
+    if (!m_pKeyHasher) {
+        m_pKeyHasher = HttpCacheKeyHasher::createDefaultHasher();
+    }
+    initialize(builder.getPath(), builder.getMemoryCacheMaxSize(), builder.getInlineBodyMaxSize(),
+            builder.getDataDirFanOutLevels(), builder.getEvictionPolicy(), builder.getBodyCompression());
+}
+
+void HttpCacheInternal::initialize(const Poco::Path& path, size_t memoryCacheMaxSize, size_t inlineBodyMaxSize,
+        unsigned int dataDirFanOutLevels, EvictionPolicy evictionPolicy, BodyCompression bodyCompression)
 {
+    m_bodyCompression = bodyCompression;
     m_cachePath = path;
     m_cacheRootDir = path.absolute();
     Poco::Path cacheDir(HttpInternalConstants::Caches::CacheDir);
     m_cacheRootDir.append(cacheDir);
-    m_pFileCache = new HttpFileCache(m_cacheRootDir, maxSize);
-    m_pCacheManager = new CacheManager(NULL, m_pFileCache);
+    m_pFileCache = new HttpFileCache(m_cacheRootDir, m_maxSize, m_pKeyHasher, dataDirFanOutLevels, inlineBodyMaxSize,
+            evictionPolicy);
+    if (memoryCacheMaxSize > 0) {
+        size_t maxDataSize = std::min(memoryCacheMaxSize, HttpInternalConstants::Caches::MemoryCacheMaxDataSize);
+        m_pMemoryCache = new HttpMemoryCache(memoryCacheMaxSize, maxDataSize);
+        m_pCacheManager = new CacheManager(m_pMemoryCache, m_pFileCache, maxDataSize);
+    } else {
+        m_pCacheManager = new CacheManager(NULL, m_pFileCache);
+    }
     Poco::Path tempDir(m_cacheRootDir);
     Poco::Path tempChildDir(HttpInternalConstants::Caches::TempDir);
     tempDir.append(tempChildDir);
     m_cacheTempDir = tempDir.toString();
+    Poco::Path partialDir(m_cacheRootDir);
+    partialDir.append(Poco::Path(HttpInternalConstants::Caches::PartialDir));
+    m_pPartialContentStore = new HttpPartialContentStore(partialDir, m_maxSize);
+    m_pCacheWriter = new HttpCacheWriter(HttpInternalConstants::Caches::WriterQueueMaxBytes);
 }
 
 HttpCacheInternal::~HttpCacheInternal()
 {
     m_pCacheManager = NULL;
+    m_pMemoryCache = NULL;
     m_pFileCache = NULL;
+    m_pPartialContentStore = NULL;
+    m_pCacheWriter = NULL;
 }
 
 const Poco::Path& HttpCacheInternal::getPath() const
@@ -66,6 +121,11 @@ void HttpCacheInternal::evictAll()
         throw HttpExecutionException("Failed to purge cache.");
     }
 
+    if (!m_pPartialContentStore->removeAll()) {
+        EASYHTTPCPP_LOG_D(Tag, "Failed to remove partial contents.");
+        throw HttpExecutionException("Failed to remove partial contents.");
+    }
+
     Poco::FastMutex::ScopedLock lock(m_directoryMutex);
 
     if (!FileUtil::removeDirsIfPresent(Poco::Path(m_cacheTempDir))) {
@@ -86,6 +146,15 @@ size_t HttpCacheInternal::getSize()
     return pFileCache->getSize();
 }
 
+void HttpCacheInternal::flush()
+{
+    HttpFileCache* pFileCache = static_cast<HttpFileCache*> (m_pFileCache.get());
+    if (!pFileCache->flush()) {
+        EASYHTTPCPP_LOG_D(Tag, "Failed to flush cache.");
+        throw HttpExecutionException("Failed to flush cache.");
+    }
+}
+
 const std::string& HttpCacheInternal::getTempDirectory()
 {
     Poco::FastMutex::ScopedLock lock(m_directoryMutex);
@@ -104,12 +173,168 @@ easyhttpcpp::common::CacheManager::Ptr HttpCacheInternal::getCacheManager() cons
     return m_pCacheManager;
 }
 
+HttpCacheWriter::Ptr HttpCacheInternal::getCacheWriter() const
+{
+    return m_pCacheWriter;
+}
+
+bool HttpCacheInternal::isCompressingResponseBody(Response::Ptr pResponse)
+{
+    if (m_bodyCompression != BodyCompressionGzip || !isCompressibleResponseBody(pResponse)) {
+        return false;
+    }
+    ssize_t minBytes = static_cast<ssize_t>(HttpInternalConstants::Caches::BodyCompressionMinBytes);
+    return !pResponse->hasContentLength() || pResponse->getContentLength() >= minBytes;
+}
+
+bool HttpCacheInternal::useCompressedResponseBody(std::string& filePath, size_t& bodySize,
+        const std::string& compressedFilePath)
+{
+    if (compressedFilePath.empty()) {
+        return false;
+    }
+    Poco::File compressedFile(compressedFilePath);
+    Poco::UInt64 compressedSize = 0;
+    try {
+        compressedSize = compressedFile.getSize();
+    } catch (const Poco::Exception& e) {
+        EASYHTTPCPP_LOG_D(Tag, "useCompressedResponseBody: can not get size of [%s]. Details: %s",
+                compressedFilePath.c_str(), e.message().c_str());
+        FileUtil::removeFileIfPresent(compressedFile);
+        return false;
+    }
+
+    // the length of a chunked response body is known only at the end.
+    if (bodySize < HttpInternalConstants::Caches::BodyCompressionMinBytes || compressedSize * 100 >
+            static_cast<Poco::UInt64>(bodySize) * HttpInternalConstants::Caches::BodyCompressionMaxPercentage) {
+        EASYHTTPCPP_LOG_D(Tag, "useCompressedResponseBody: %zu bytes are compressed only to %llu bytes.", bodySize,
+                compressedSize);
+        FileUtil::removeFileIfPresent(compressedFile);
+        return false;
+    }
+    FileUtil::removeFileIfPresent(Poco::File(filePath));
+    EASYHTTPCPP_LOG_D(Tag, "useCompressedResponseBody: %zu bytes are compressed to %llu bytes.", bodySize,
+            compressedSize);
+    filePath = compressedFilePath;
+    bodySize = static_cast<size_t>(compressedSize);
+    return true;
+}
+
+std::string HttpCacheInternal::makeCacheKey(Request::Ptr pRequest)
+{
+    return HttpUtil::makeCacheKey(m_pKeyHasher, pRequest);
+}
+
+std::string HttpCacheInternal::makeCacheKey(Request::HttpMethod httpMethod, const std::string& url)
+{
+    return HttpUtil::makeCacheKey(m_pKeyHasher, httpMethod, url);
+}
+
+HttpPartialContent::Ptr HttpCacheInternal::getPartialContent(Request::Ptr pRequest, const std::string& key)
+{
+    if (key.empty()) {
+        EASYHTTPCPP_LOG_D(Tag, "getPartialContent: can not make key.");
+        return NULL;
+    }
+    return m_pPartialContentStore->get(key, pRequest->getUrl());
+}
+
+bool HttpCacheInternal::putPartialContent(Response::Ptr pResponse, const std::string& key,
+        const std::string& filePath, Poco::UInt64 storedBytes)
+{
+    // only a complete 200 response can be resumed; its length and validator identify the representation.
+    Request::Ptr pRequest = pResponse->getRequest();
+    if (pRequest->getMethod() != Request::HttpMethodGet ||
+            pResponse->getCode() != Poco::Net::HTTPResponse::HTTP_OK || !pResponse->hasContentLength() ||
+            pResponse->getContentLength() <= 0 || storedBytes == 0 ||
+            storedBytes >= static_cast<Poco::UInt64>(pResponse->getContentLength())) {
+        return false;
+    }
+    std::string validator = HttpUtil::getRangeValidator(pResponse->getHeaders());
+    if (validator.empty()) {
+        EASYHTTPCPP_LOG_D(Tag, "putPartialContent: response has no validator.");
+        return false;
+    }
+    if (key.empty()) {
+        EASYHTTPCPP_LOG_D(Tag, "putPartialContent: can not make key.");
+        return false;
+    }
+    EASYHTTPCPP_LOG_D(Tag, "putPartialContent: keep %llu/%zd bytes. [%s]", storedBytes,
+            pResponse->getContentLength(), key.c_str());
+    return m_pPartialContentStore->put(key, pRequest->getUrl(), filePath,
+            static_cast<Poco::UInt64>(pResponse->getContentLength()), validator);
+}
+
+bool HttpCacheInternal::takePartialContent(HttpPartialContent::Ptr pPartialContent,
+        const std::string& destinationFilePath)
+{
+    return m_pPartialContentStore->take(pPartialContent, destinationFilePath);
+}
+
+void HttpCacheInternal::removePartialContent(Request::Ptr pRequest)
+{
+    std::string key = makeCacheKey(pRequest);
+    if (key.empty()) {
+        EASYHTTPCPP_LOG_D(Tag, "removePartialContent: can not make key.");
+        return;
+    }
+    m_pPartialContentStore->remove(key, pRequest->getUrl());
+}
+
+bool HttpCacheInternal::beginRevalidation(const std::string& key)
+{
+    Poco::FastMutex::ScopedLock lock(m_revalidationMutex);
+    return m_revalidatingKeys.insert(key).second;
+}
+
+void HttpCacheInternal::endRevalidation(const std::string& key)
+{
+    Poco::FastMutex::ScopedLock lock(m_revalidationMutex);
+    m_revalidatingKeys.erase(key);
+}
+
+bool HttpCacheInternal::beginFlight(const std::string& key)
+{
+    Poco::FastMutex::ScopedLock lock(m_flightMutex);
+    return m_flightKeys.insert(key).second;
+}
+
+bool HttpCacheInternal::waitFlight(const std::string& key, long timeoutMillis)
+{
+    Poco::Timestamp deadline;
+    deadline += static_cast<Poco::Timestamp::TimeDiff>(timeoutMillis) * 1000;
+
+    Poco::FastMutex::ScopedLock lock(m_flightMutex);
+    // the condition is shared by all keys; wake-ups for other keys are ignored.
+    while (m_flightKeys.find(key) != m_flightKeys.end()) {
+        Poco::Timestamp now;
+        if (now >= deadline) {
+            EASYHTTPCPP_LOG_D(Tag, "waitFlight: timed out. [%s]", key.c_str());
+            return false;
+        }
+        m_flightEndedCondition.tryWait(m_flightMutex, static_cast<long>((deadline - now + 999) / 1000));
+    }
+    return true;
+}
+
+void HttpCacheInternal::endFlight(const std::string& key)
+{
+    Poco::FastMutex::ScopedLock lock(m_flightMutex);
+    if (m_flightKeys.erase(key) > 0) {
+        m_flightEndedCondition.broadcast();
+    }
+}
+
 HttpCacheStrategy::Ptr HttpCacheInternal::createCacheStrategy(Request::Ptr pRequest)
+{
+    return createCacheStrategy(pRequest, makeCacheKey(pRequest));
+}
+
+HttpCacheStrategy::Ptr HttpCacheInternal::createCacheStrategy(Request::Ptr pRequest, const std::string& key)
 {
     Poco::Timestamp now;
     unsigned long long nowAtEpoch = static_cast<unsigned long long>(now.epochTime());
 
-    std::string key = HttpUtil::makeCacheKey(pRequest);
     if (key.empty()) {
         EASYHTTPCPP_LOG_D(Tag, "createCacheStrategy: can not make key.");
         return new HttpCacheStrategy(pRequest, NULL, nowAtEpoch);
@@ -122,67 +347,82 @@ HttpCacheStrategy::Ptr HttpCacheInternal::createCacheStrategy(Request::Ptr pRequ
         EASYHTTPCPP_LOG_D(Tag, "cache not found.");
         return new HttpCacheStrategy(pRequest, NULL, nowAtEpoch);
     }
-    HttpCacheMetadata* pHttpCacheMetadata = static_cast<HttpCacheMetadata*> (pCacheMetadata.get());
+    HttpCacheMetadata::Ptr pHttpCacheMetadata(static_cast<HttpCacheMetadata*> (pCacheMetadata.get()), true);
 
-    // create CacheResponse
-    Response::Ptr pCacheResponse = createResponseFromCacheMetadata(pRequest, *pHttpCacheMetadata);
+    if (!pHttpCacheMetadata->isCacheOf(pRequest->getMethod(), pRequest->getUrl())) {
+        EASYHTTPCPP_LOG_D(Tag, "cache of another request has the same key. [%s]", key.c_str());
+        return new HttpCacheStrategy(pRequest, NULL, nowAtEpoch);
+    }
 
     // check CacheStrategy
-    HttpCacheStrategy::Ptr pCacheStrategy = new HttpCacheStrategy(pRequest, pCacheResponse, nowAtEpoch);
+    // freshness is checked without decoding response headers; CacheResponse is created only when it is used.
+    HttpCacheStrategy::Ptr pCacheStrategy = new HttpCacheStrategy(pRequest, pHttpCacheMetadata,
+            pHttpCacheMetadata->getFreshness(), nowAtEpoch);
 
     return pCacheStrategy;
 }
 
 void HttpCacheInternal::remove(Request::Ptr pRequest)
 {
-    std::string key = HttpUtil::makeCacheKey(Request::HttpMethodGet, pRequest->getUrl());
+    // the cache of GET without Accept-Encoding, and the one of GET with the Accept-Encoding of the request.
+    removeInternal(makeCacheKey(Request::HttpMethodGet, pRequest->getUrl()), pRequest->getUrl());
+    const std::string& acceptEncoding = pRequest->getHeaderValue(HttpConstants::HeaderNames::AcceptEncoding, "");
+    if (!acceptEncoding.empty()) {
+        removeInternal(HttpUtil::makeCacheKey(m_pKeyHasher, Request::HttpMethodGet, pRequest->getUrl(),
+                acceptEncoding), pRequest->getUrl());
+    }
+}
+
+void HttpCacheInternal::removeInternal(const std::string& key, const std::string& url)
+{
     if (key.empty()) {
         EASYHTTPCPP_LOG_D(Tag, "remove: can not make key.");
         return;
     }
-    m_pCacheManager->remove(key);
+    CacheMetadata::Ptr pCacheMetadata;
+    if (m_pCacheManager->getMetadata(key, pCacheMetadata) && !static_cast<HttpCacheMetadata*> (
+            pCacheMetadata.get())->isCacheOf(Request::HttpMethodGet, url)) {
+        EASYHTTPCPP_LOG_D(Tag, "remove: cache of another request has the same key. [%s]", key.c_str());
+    } else {
+        m_pCacheManager->remove(key);
+    }
+    m_pPartialContentStore->remove(key, url);
 }
 
-std::istream* HttpCacheInternal::createInputStreamFromCache(Request::Ptr pRequest)
+std::istream* HttpCacheInternal::createInputStreamFromCache(Request::Ptr pRequest, unsigned int& cacheIndex)
+{
+    return createInputStreamFromCache(pRequest, makeCacheKey(pRequest), cacheIndex);
+}
+
+std::istream* HttpCacheInternal::createInputStreamFromCache(Request::Ptr pRequest, const std::string& key,
+        unsigned int& cacheIndex)
 {
-    std::string key = HttpUtil::makeCacheKey(pRequest);
     if (key.empty()) {
         EASYHTTPCPP_LOG_D(Tag, "createInputStreamFromCache: can not make key.");
         return NULL;
     }
+    // the metadata is taken with the data, so that the compressed flag belongs to the body read.
+    CacheMetadata::Ptr pCacheMetadata;
     std::istream* pStream = NULL;
-    if (m_pCacheManager->getData(key, pStream)) {
-        EASYHTTPCPP_LOG_D(Tag, "create response body stream from cache.");
-        return pStream;
-    } else {
+    if (!m_pCacheManager->get(key, pCacheMetadata, pStream, cacheIndex)) {
         EASYHTTPCPP_LOG_D(Tag, "can not create response body stream from cache.");
         return NULL;
     }
-}
-
-Response::Ptr HttpCacheInternal::createResponseFromCacheMetadata(Request::Ptr pRequest,
-        HttpCacheMetadata& httpCacheMetadata)
-{
-    // create CacheControl from CacheMetadata
-    CacheControl::Ptr pCacheControl = CacheControl::createFromHeaders(httpCacheMetadata.getResponseHeaders());
-
-    // create Response
-    Headers::Ptr pResponseHeaders = httpCacheMetadata.getResponseHeaders();
-    Response::Builder builder;
-    builder.setCode(httpCacheMetadata.getStatusCode()).setMessage(httpCacheMetadata.getStatusMessage()).
-            setCacheControl(pCacheControl).setHeaders(pResponseHeaders).
-            setRequest(pRequest).setSentRequestSec(httpCacheMetadata.getSentRequestAtEpoch()).
-            setReceivedResponseSec(httpCacheMetadata.getReceivedResponseAtEpoch());
-
-    if (pResponseHeaders->has(HttpConstants::HeaderNames::ContentLength)) {
-        std::string contentLengthStr = pResponseHeaders->getValue(
-                HttpConstants::HeaderNames::ContentLength, "-1");
-        Poco::Int64 contentLength;
-        if (Poco::NumberParser::tryParse64(contentLengthStr, contentLength)) {
-            builder.setHasContentLength(true).setContentLength(static_cast<ssize_t> (contentLength));
-        }
+    HttpCacheMetadata* pHttpCacheMetadata = static_cast<HttpCacheMetadata*> (pCacheMetadata.get());
+    // the cache may have been replaced by another request of the same key after its metadata was checked.
+    if (!pHttpCacheMetadata->isCacheOf(pRequest->getMethod(), pRequest->getUrl())) {
+        EASYHTTPCPP_LOG_D(Tag, "createInputStreamFromCache: cache of another request has the same key. [%s]",
+                key.c_str());
+        delete pStream;
+        m_pCacheManager->releaseData(key, cacheIndex);
+        return NULL;
+    }
+    if (pHttpCacheMetadata->isResponseBodyCompressed()) {
+        EASYHTTPCPP_LOG_D(Tag, "create decompressing response body stream from cache.");
+        return new ContentDecodingInputStream(pStream, Poco::InflatingStreamBuf::STREAM_GZIP);
     }
-    return builder.build();
+    EASYHTTPCPP_LOG_D(Tag, "create response body stream from cache.");
+    return pStream;
 }
 
 } /* namespace easyhttpcpp */
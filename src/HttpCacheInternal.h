@@ -6,18 +6,25 @@
 #define EASYHTTPCPP_HTTPCACHEINTERNAL_H_INCLUDED
 
 #include <istream>
+#include <set>
+#include <string>
 
+#include "Poco/Condition.h"
 #include "Poco/Mutex.h"
 #include "Poco/Path.h"
 
 #include "easyhttpcpp/common/Cache.h"
 #include "easyhttpcpp/common/CacheManager.h"
 #include "easyhttpcpp/HttpCache.h"
+#include "easyhttpcpp/HttpCacheKeyHasher.h"
 #include "easyhttpcpp/HttpExports.h"
 #include "easyhttpcpp/Request.h"
 #include "easyhttpcpp/Response.h"
 
 #include "HttpCacheStrategy.h"
+#include "HttpCacheWriter.h"
+#include "HttpPartialContent.h"
+#include "HttpPartialContentStore.h"
 
 namespace easyhttpcpp {
 
@@ -26,29 +33,92 @@ class HttpCacheMetadata;
 class EASYHTTPCPP_HTTP_INTERNAL_API HttpCacheInternal : public HttpCache {
 public:
     HttpCacheInternal(const Poco::Path& path, size_t maxSize);
+    HttpCacheInternal(const HttpCache::Builder& builder);
     virtual ~HttpCacheInternal();
 
     virtual const Poco::Path& getPath() const;
     virtual void evictAll();
     virtual size_t getMaxSize() const;
     virtual size_t getSize();
+    virtual void flush();
 
+    std::string makeCacheKey(Request::Ptr pRequest);
+    std::string makeCacheKey(Request::HttpMethod httpMethod, const std::string& url);
     HttpCacheStrategy::Ptr createCacheStrategy(Request::Ptr pRequest);
+    // key is made by makeCacheKey(pRequest); callers which look up the same request again keep it.
+    HttpCacheStrategy::Ptr createCacheStrategy(Request::Ptr pRequest, const std::string& key);
     void remove(Request::Ptr pRequest);
-    std::istream* createInputStreamFromCache(Request::Ptr pRequest);
+    // a compressed response body is decompressed while it is read from the stream.
+    // cacheIndex is the cache which served the stream; it is released by CacheManager::releaseData(key, cacheIndex).
+    std::istream* createInputStreamFromCache(Request::Ptr pRequest, unsigned int& cacheIndex);
+    std::istream* createInputStreamFromCache(Request::Ptr pRequest, const std::string& key,
+            unsigned int& cacheIndex);
     const std::string& getTempDirectory();
     easyhttpcpp::common::CacheManager::Ptr getCacheManager() const;
+    virtual HttpCacheWriter::Ptr getCacheWriter() const;
+
+    /**
+     * @return true if a gzip copy of the response body is to be written along with it, by the body compression of
+     * the cache and the type of the response body.
+     */
+    bool isCompressingResponseBody(Response::Ptr pResponse);
+
+    /**
+     * Uses the gzip copy of the response body instead of it, when it saves space; the unused file is removed.
+     * @param filePath response body file; replaced by compressedFilePath if it is used.
+     * @param bodySize bytes of the response body; replaced by the compressed bytes if compressedFilePath is used.
+     * @param compressedFilePath gzip copy of the response body.
+     * @return true if compressedFilePath is used.
+     */
+    bool useCompressedResponseBody(std::string& filePath, size_t& bodySize, const std::string& compressedFilePath);
+
+    HttpPartialContent::Ptr getPartialContent(Request::Ptr pRequest, const std::string& key);
+    bool putPartialContent(Response::Ptr pResponse, const std::string& key, const std::string& filePath,
+            Poco::UInt64 storedBytes);
+    bool takePartialContent(HttpPartialContent::Ptr pPartialContent, const std::string& destinationFilePath);
+    void removePartialContent(Request::Ptr pRequest);
+
+    /**
+     * Marks the key as being revalidated in background.
+     * @return false if the key is already being revalidated.
+     */
+    bool beginRevalidation(const std::string& key);
+    void endRevalidation(const std::string& key);
+
+    /**
+     * Marks the key as being fetched from network by a leader of concurrent requests (single-flight).
+     * @return false if another request is already the leader of the key.
+     */
+    bool beginFlight(const std::string& key);
+    /**
+     * Waits until the leader of the key ends its flight.
+     * @return false if timed out.
+     */
+    bool waitFlight(const std::string& key, long timeoutMillis);
+    void endFlight(const std::string& key);
 
 private:
-    Response::Ptr createResponseFromCacheMetadata(Request::Ptr pRequest, HttpCacheMetadata& httpCacheMetadata);
+    void initialize(const Poco::Path& path, size_t memoryCacheMaxSize, size_t inlineBodyMaxSize,
+            unsigned int dataDirFanOutLevels, EvictionPolicy evictionPolicy, BodyCompression bodyCompression);
+    void removeInternal(const std::string& key, const std::string& url);
 
     size_t m_maxSize;
+    HttpCacheKeyHasher::Ptr m_pKeyHasher;
     easyhttpcpp::common::Cache::Ptr m_pFileCache;
+    easyhttpcpp::common::Cache::Ptr m_pMemoryCache;
     easyhttpcpp::common::CacheManager::Ptr m_pCacheManager;
     Poco::Path m_cachePath;
     Poco::Path m_cacheRootDir;
     std::string m_cacheTempDir;
+    HttpPartialContentStore::Ptr m_pPartialContentStore;
+    HttpCacheWriter::Ptr m_pCacheWriter;
+    BodyCompression m_bodyCompression;
     Poco::FastMutex m_directoryMutex;
+    std::set<std::string> m_revalidatingKeys;
+    Poco::FastMutex m_revalidationMutex;
+    std::set<std::string> m_flightKeys;
+    Poco::FastMutex m_flightMutex;
+    Poco::Condition m_flightEndedCondition;
 
 };
 
@@ -0,0 +1,26 @@
+/*
+ * Copyright 2019 Sony Corporation
+ */
+
+#include "easyhttpcpp/HttpCacheKeyHasher.h"
+
+#include "HttpDigestCacheKeyHasher.h"
+#include "HttpMurmur3CacheKeyHasher.h"
+
+namespace easyhttpcpp {
+
+HttpCacheKeyHasher::~HttpCacheKeyHasher()
+{
+}
+
+HttpCacheKeyHasher::Ptr HttpCacheKeyHasher::createDefaultHasher()
+{
+    return new HttpDigestCacheKeyHasher();
+}
+
+HttpCacheKeyHasher::Ptr HttpCacheKeyHasher::createMurmur3Hasher()
+{
+    return new HttpMurmur3CacheKeyHasher();
+}
+
+} /* namespace easyhttpcpp */
@@ -3,11 +3,12 @@
  */
 
 #include "HttpCacheMetadata.h"
+#include "HttpUtil.h"
 
 namespace easyhttpcpp {
 
 HttpCacheMetadata::HttpCacheMetadata() : m_httpMethod(Request::HttpMethodGet), m_statusCode(-1), m_responseBodySize(0),
-        m_sentRequestAtEpoch(0), m_receivedResponseAtEpoch(0), m_createdAtEpoch(0)
+        m_responseBodyCompressed(false), m_sentRequestAtEpoch(0), m_receivedResponseAtEpoch(0), m_createdAtEpoch(0)
 
 {
 }
@@ -36,6 +37,11 @@ Request::HttpMethod HttpCacheMetadata::getHttpMethod() const
     return m_httpMethod;
 }
 
+bool HttpCacheMetadata::isCacheOf(Request::HttpMethod httpMethod, const std::string& url) const
+{
+    return m_httpMethod == httpMethod && m_url == url;
+}
+
 void HttpCacheMetadata::setStatusCode(int statusCode)
 {
     m_statusCode = statusCode;
@@ -59,13 +65,46 @@ const std::string& HttpCacheMetadata::getStatusMessage() const
 void HttpCacheMetadata::setResponseHeaders(Headers::Ptr pResponseHeaders)
 {
     m_pResponseHeaders = pResponseHeaders;
+    m_encodedResponseHeaders.clear();
+    m_pFreshness = NULL;
 }
 
 Headers::Ptr HttpCacheMetadata::getResponseHeaders() const
 {
+    if (!m_pResponseHeaders && !m_encodedResponseHeaders.empty()) {
+        m_pResponseHeaders = HttpUtil::exchangeBinaryStrToHeaders(m_encodedResponseHeaders);
+        m_encodedResponseHeaders.clear();
+    }
     return m_pResponseHeaders;
 }
 
+void HttpCacheMetadata::setEncodedResponseHeaders(const std::string& encodedResponseHeaders)
+{
+    m_pResponseHeaders = NULL;
+    m_encodedResponseHeaders = encodedResponseHeaders;
+}
+
+std::string HttpCacheMetadata::getEncodedResponseHeaders() const
+{
+    if (!m_pResponseHeaders) {
+        return m_encodedResponseHeaders;
+    }
+    return HttpUtil::exchangeHeadersToBinaryStr(m_pResponseHeaders);
+}
+
+void HttpCacheMetadata::setFreshness(HttpCacheFreshness::Ptr pFreshness)
+{
+    m_pFreshness = pFreshness;
+}
+
+HttpCacheFreshness::Ptr HttpCacheMetadata::getFreshness() const
+{
+    if (!m_pFreshness) {
+        m_pFreshness = HttpCacheFreshness::createFromHeaders(getResponseHeaders());
+    }
+    return m_pFreshness;
+}
+
 void HttpCacheMetadata::setResponseBodySize(size_t responseBodySize)
 {
     m_responseBodySize = responseBodySize;
@@ -76,6 +115,16 @@ size_t HttpCacheMetadata::getResponseBodySize() const
     return m_responseBodySize;
 }
 
+void HttpCacheMetadata::setResponseBodyCompressed(bool responseBodyCompressed)
+{
+    m_responseBodyCompressed = responseBodyCompressed;
+}
+
+bool HttpCacheMetadata::isResponseBodyCompressed() const
+{
+    return m_responseBodyCompressed;
+}
+
 void HttpCacheMetadata::setSentRequestAtEpoch(std::time_t sentRequestAtEpoch)
 {
     m_sentRequestAtEpoch = sentRequestAtEpoch;
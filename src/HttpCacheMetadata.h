@@ -15,6 +15,8 @@
 #include "easyhttpcpp/HttpExports.h"
 #include "easyhttpcpp/Request.h"
 
+#include "HttpCacheFreshness.h"
+
 namespace easyhttpcpp {
 
 class EASYHTTPCPP_HTTP_INTERNAL_API HttpCacheMetadata : public easyhttpcpp::common::CacheMetadata {
@@ -28,14 +30,26 @@ public:
     const std::string& getUrl() const;
     void setHttpMethod(Request::HttpMethod httpMethod);
     Request::HttpMethod getHttpMethod() const;
+    // the key is a hash, so the cache of another request may have the same key.
+    bool isCacheOf(Request::HttpMethod httpMethod, const std::string& url) const;
     void setStatusCode(int statusCode);
     int getStatusCode() const;
     void setStatusMessage(const std::string& statusMessage);
     const std::string& getStatusMessage() const;
     void setResponseHeaders(Headers::Ptr pResponseHeaders);
     Headers::Ptr getResponseHeaders() const;
+    // encoded headers are decoded by the first getResponseHeaders().
+    void setEncodedResponseHeaders(const std::string& encodedResponseHeaders);
+    // headers which are not decoded yet are returned as they are; the others are encoded.
+    std::string getEncodedResponseHeaders() const;
+    // freshness is derived from response headers when it is not set.
+    void setFreshness(HttpCacheFreshness::Ptr pFreshness);
+    HttpCacheFreshness::Ptr getFreshness() const;
+    // size of the stored response body; the compressed size when it is stored compressed.
     void setResponseBodySize(size_t responseBodySize);
     size_t getResponseBodySize() const;
+    void setResponseBodyCompressed(bool responseBodyCompressed);
+    bool isResponseBodyCompressed() const;
     void setSentRequestAtEpoch(std::time_t sentRequestAtEpoch);
     std::time_t getSentRequestAtEpoch() const;
     void setReceivedResponseAtEpoch(std::time_t receivedResponseAtEpoch);
@@ -48,8 +62,11 @@ private:
     Request::HttpMethod m_httpMethod;
     int m_statusCode;
     std::string m_statusMessage;
-    Headers::Ptr m_pResponseHeaders;
+    mutable Headers::Ptr m_pResponseHeaders;
+    mutable std::string m_encodedResponseHeaders;
+    mutable HttpCacheFreshness::Ptr m_pFreshness;
     size_t m_responseBodySize;
+    bool m_responseBodyCompressed;
     std::time_t m_sentRequestAtEpoch;
     std::time_t m_receivedResponseAtEpoch;
     std::time_t m_createdAtEpoch;
@@ -0,0 +1,62 @@
+/*
+ * Copyright 2019 Sony Corporation
+ */
+
+#include "easyhttpcpp/common/CoreLogger.h"
+#include "easyhttpcpp/HttpException.h"
+
+#include "HttpCacheInternal.h"
+#include "HttpCacheRevalidationTask.h"
+
+namespace easyhttpcpp {
+
+static const std::string Tag = "HttpCacheRevalidationTask";
+
+HttpCacheRevalidationTask::HttpCacheRevalidationTask(EasyHttpContext::Ptr pContext,
+        Request::Ptr pRevalidationRequest, Response::Ptr pCacheResponse, const std::string& key) :
+        m_pContext(pContext), m_pRevalidationRequest(pRevalidationRequest), m_pCacheResponse(pCacheResponse),
+        m_key(key)
+{
+    m_pHttpEngine = new HttpEngine(m_pContext, m_pRevalidationRequest, NULL);
+}
+
+HttpCacheRevalidationTask::~HttpCacheRevalidationTask()
+{
+}
+
+void HttpCacheRevalidationTask::runTask()
+{
+    if (isCancelled()) {
+        EASYHTTPCPP_LOG_D(Tag, "revalidation was cancelled before start. [%s]", m_key.c_str());
+        notifyCompletion();
+        return;
+    }
+
+    try {
+        m_pHttpEngine->revalidate(m_pRevalidationRequest, m_pCacheResponse);
+        EASYHTTPCPP_LOG_D(Tag, "revalidation finished. [%s]", m_key.c_str());
+    } catch (const HttpException& e) {
+        // the stale response is kept; it is revalidated again when it is requested next time.
+        EASYHTTPCPP_LOG_D(Tag, "Error while revalidating cache. Details: %s", e.getMessage().c_str());
+    } catch (const std::exception& e) {
+        EASYHTTPCPP_LOG_D(Tag, "Unexpected error while revalidating cache. Details: %s", e.what());
+    }
+    notifyCompletion();
+}
+
+bool HttpCacheRevalidationTask::cancel(bool mayInterruptIfRunning)
+{
+    HttpExecutionTask::cancel(mayInterruptIfRunning);
+    return m_pHttpEngine->cancel();
+}
+
+void HttpCacheRevalidationTask::notifyCompletion()
+{
+    HttpCacheInternal* pCacheInternal = static_cast<HttpCacheInternal*> (m_pContext->getCache().get());
+    if (pCacheInternal != NULL) {
+        pCacheInternal->endRevalidation(m_key);
+    }
+    m_pContext->getHttpExecutionTaskManager()->onComplete(HttpExecutionTask::Ptr(this, true));
+}
+
+} /* namespace easyhttpcpp */
@@ -0,0 +1,47 @@
+/*
+ * Copyright 2019 Sony Corporation
+ */
+
+#ifndef EASYHTTPCPP_HTTPCACHEREVALIDATIONTASK_H_INCLUDED
+#define EASYHTTPCPP_HTTPCACHEREVALIDATIONTASK_H_INCLUDED
+
+#include <string>
+
+#include "easyhttpcpp/Request.h"
+#include "easyhttpcpp/Response.h"
+
+#include "EasyHttpContext.h"
+#include "HttpEngine.h"
+#include "HttpExecutionTask.h"
+
+namespace easyhttpcpp {
+
+/**
+ * Revalidates a stale cached response in background, after it was returned by stale-while-revalidate.
+ * The cache is updated by the response of the server; nothing is notified to the caller.
+ */
+class HttpCacheRevalidationTask : public HttpExecutionTask {
+public:
+    typedef Poco::AutoPtr<HttpCacheRevalidationTask> Ptr;
+
+    HttpCacheRevalidationTask(EasyHttpContext::Ptr pContext, Request::Ptr pRevalidationRequest,
+            Response::Ptr pCacheResponse, const std::string& key);
+    virtual ~HttpCacheRevalidationTask();
+
+    virtual void runTask();
+    virtual bool cancel(bool mayInterruptIfRunning);
+
+private:
+    HttpCacheRevalidationTask();
+    void notifyCompletion();
+
+    EasyHttpContext::Ptr m_pContext;
+    Request::Ptr m_pRevalidationRequest;
+    Response::Ptr m_pCacheResponse;
+    std::string m_key;
+    HttpEngine::Ptr m_pHttpEngine;
+};
+
+} /* namespace easyhttpcpp */
+
+#endif /* EASYHTTPCPP_HTTPCACHEREVALIDATIONTASK_H_INCLUDED */
@@ -2,6 +2,7 @@
  * Copyright 2017 Sony Corporation
  */
 
+#include <algorithm>
 #include <list>
 
 #include "Poco/NumberParser.h"
@@ -21,47 +22,34 @@ static const long long OneDaySec = 24 * 60 * 60;
 
 HttpCacheStrategy::HttpCacheStrategy(Request::Ptr pRequest, Response::Ptr pCacheResponse, unsigned long long nowAtEpoch)
         : m_nowAtEpoch(nowAtEpoch), m_pRequest(pRequest), m_pNetworkRequest(pRequest), m_pCacheResponse(pCacheResponse)
-        , m_responseDateExisted(false), m_lastModifiedExisted(false), m_expiresExisted(false), m_ageSec(-1)
-        , m_ageExisted(false)
+        , m_sentRequestSec(0), m_receivedResponseSec(0)
 {
     if (m_pCacheResponse) {
         // preparation frequent used stuff.
-        if (m_pCacheResponse->hasHeader(HttpConstants::HeaderNames::Date)) {
-            if (HttpUtil::tryParseDate(m_pCacheResponse->getHeaderValue(HttpConstants::HeaderNames::Date, ""),
-                    m_responseDate)) {
-                m_responseDateExisted = true;
-            }
-        }
-        if (m_pCacheResponse->hasHeader(HttpConstants::HeaderNames::LastModified)) {
-            if (HttpUtil::tryParseDate(m_pCacheResponse->getHeaderValue(HttpConstants::HeaderNames::LastModified, ""),
-                    m_lastModified)) {
-                m_lastModifiedExisted = true;
-            }
-        }
-        if (m_pCacheResponse->hasHeader(HttpConstants::HeaderNames::Expires)) {
-            if (HttpUtil::tryParseDate(m_pCacheResponse->getHeaderValue(HttpConstants::HeaderNames::Expires, ""),
-                    m_expires)) {
-                m_expiresExisted = true;
-            }
-        }
-        if (m_pCacheResponse->hasHeader(HttpConstants::HeaderNames::Age)) {
-            m_ageExisted = true;
-            Poco::Int64 value;
-            if (Poco::NumberParser::tryParse64(m_pCacheResponse->getHeaderValue(HttpConstants::HeaderNames::Age, ""),
-                    value)) {
-                m_ageSec = value;
-            } else {
-                m_ageSec = -1;
-            }
-        }
+        m_pFreshness = HttpCacheFreshness::create(m_pCacheResponse->getHeaders(), m_pCacheResponse->getCacheControl());
+        m_cacheUrl = m_pCacheResponse->getRequest()->getUrl();
+        m_sentRequestSec = m_pCacheResponse->getSentRequestSec();
+        m_receivedResponseSec = m_pCacheResponse->getReceivedResponseSec();
         resolveCacheResponseAndNetworkRequest();
     } else {
-        // check onlyIfCached
-        CacheControl::Ptr pCacheControl = m_pRequest->getCacheControl();
-        if (pCacheControl && pCacheControl->isOnlyIfCached()) {
-            EASYHTTPCPP_LOG_D(Tag, "can not send request when exist network request and only-if-cached");
-            m_pNetworkRequest = NULL;
-        }
+        resolveNetworkRequestWithoutCache();
+    }
+}
+
+HttpCacheStrategy::HttpCacheStrategy(Request::Ptr pRequest, HttpCacheMetadata::Ptr pCacheMetadata,
+        HttpCacheFreshness::Ptr pFreshness, unsigned long long nowAtEpoch) : m_nowAtEpoch(nowAtEpoch),
+        m_pRequest(pRequest), m_pNetworkRequest(pRequest), m_pCacheMetadata(pCacheMetadata), m_pFreshness(pFreshness),
+        m_sentRequestSec(0), m_receivedResponseSec(0)
+{
+    if (m_pCacheMetadata && m_pFreshness) {
+        // freshness was parsed when the response was stored; headers are not needed to decide.
+        m_cacheUrl = m_pRequest->getUrl();
+        m_sentRequestSec = m_pCacheMetadata->getSentRequestAtEpoch();
+        m_receivedResponseSec = m_pCacheMetadata->getReceivedResponseAtEpoch();
+        resolveCacheResponseAndNetworkRequest();
+    } else {
+        m_pCacheMetadata = NULL;
+        resolveNetworkRequestWithoutCache();
     }
 }
 
@@ -69,6 +57,16 @@ HttpCacheStrategy::~HttpCacheStrategy()
 {
 }
 
+void HttpCacheStrategy::resolveNetworkRequestWithoutCache()
+{
+    // check onlyIfCached
+    CacheControl::Ptr pCacheControl = m_pRequest->getCacheControl();
+    if (pCacheControl && pCacheControl->isOnlyIfCached()) {
+        EASYHTTPCPP_LOG_D(Tag, "can not send request when exist network request and only-if-cached");
+        m_pNetworkRequest = NULL;
+    }
+}
+
 void HttpCacheStrategy::resolveCacheResponseAndNetworkRequest()
 {
     m_pNetworkRequest = NULL;
@@ -88,15 +86,9 @@ void HttpCacheStrategy::resolveCacheResponseAndNetworkRequest()
         requestMaxStaleSec = pRequestCacheControl->getMaxStaleSec();
         isRequestOnlyIfCached = pRequestCacheControl->isOnlyIfCached();
     }
-    CacheControl::Ptr pResponseCacheControl = m_pCacheResponse->getCacheControl();
-    bool isResponseMustRevalidate = false;
-    bool isResponseNoCache = false;
-    long long responseMaxAgeSec = -1;
-    if (pResponseCacheControl) {
-        isResponseMustRevalidate = pResponseCacheControl->isMustRevalidate();
-        isResponseNoCache = pResponseCacheControl->isNoCache();
-        responseMaxAgeSec = pResponseCacheControl->getMaxAgeSec();
-    }
+    bool isResponseMustRevalidate = m_pFreshness->isMustRevalidate();
+    bool isResponseNoCache = m_pFreshness->isNoCache();
+    long long responseMaxAgeSec = m_pFreshness->getMaxAgeSec();
 
     if (requestMaxAgeSec != -1) {
         freshSec = std::min(freshSec, static_cast<unsigned long long>(requestMaxAgeSec));
@@ -123,11 +115,12 @@ void HttpCacheStrategy::resolveCacheResponseAndNetworkRequest()
         }
         // RFC 2616 13.2.4 Expiration Calculations
         // if age is over one day and max-age exist and expires not exist, add warning header.
-        if (ageSec > OneDaySec && responseMaxAgeSec == -1 && !m_expiresExisted) {
+        if (ageSec > OneDaySec && responseMaxAgeSec == -1 && m_pFreshness->getExpiresAtEpoch() == -1) {
             extraHeaders.push_back(std::make_pair(HttpConstants::HeaderNames::Warning,
                     HttpConstants::HeaderValues::HeuristicExpiration));
             EASYHTTPCPP_LOG_D(Tag, "add warning header : %s", HttpConstants::HeaderValues::HeuristicExpiration);
         }
+        loadCacheResponse();
         if (extraHeaders.size() > 0) {
             Response::Builder responseBuilder(m_pCacheResponse);
             for (std::list<std::pair<std::string, std::string> >::const_iterator it = extraHeaders.begin();
@@ -145,18 +138,20 @@ void HttpCacheStrategy::resolveCacheResponseAndNetworkRequest()
     if (isRequestOnlyIfCached) {
         EASYHTTPCPP_LOG_D(Tag, "can not send request when exist network request and only-if-cached");
         m_pCacheResponse = NULL;
+        m_pCacheMetadata = NULL;
         return;
     }
 
     // check conditional request
+    // cache response is needed to combine headers when the server answers Not Modified.
+    loadCacheResponse();
+    Response::Ptr pStaleResponse = m_pCacheResponse;
     Headers conditionalRequestHeaders;
-    if (m_pCacheResponse->hasHeader(HttpConstants::HeaderNames::ETag)) {
-        conditionalRequestHeaders.set(HttpConstants::HeaderNames::IfNoneMatch,
-                m_pCacheResponse->getHeaderValue(HttpConstants::HeaderNames::ETag, ""));
+    if (!m_pFreshness->getETag().empty()) {
+        conditionalRequestHeaders.set(HttpConstants::HeaderNames::IfNoneMatch, m_pFreshness->getETag());
         EASYHTTPCPP_LOG_D(Tag, "conditional request: If-None-Match: ETag");
-    } else if (m_pCacheResponse->hasHeader(HttpConstants::HeaderNames::LastModified)) {
-        conditionalRequestHeaders.set(HttpConstants::HeaderNames::IfModifiedSince, m_pCacheResponse->getHeaderValue(
-                HttpConstants::HeaderNames::LastModified, ""));
+    } else if (!m_pFreshness->getLastModified().empty()) {
+        conditionalRequestHeaders.set(HttpConstants::HeaderNames::IfModifiedSince, m_pFreshness->getLastModified());
         EASYHTTPCPP_LOG_D(Tag, "conditional request: If-Modified-Since: Last-Modified");
     } else if (m_pCacheResponse->hasHeader(HttpConstants::HeaderNames::Date)) {
         conditionalRequestHeaders.set(HttpConstants::HeaderNames::IfModifiedSince,
@@ -174,6 +169,36 @@ void HttpCacheStrategy::resolveCacheResponseAndNetworkRequest()
         requestBuilder.setHeader(it->first, it->second);
     }
     m_pNetworkRequest = requestBuilder.build();
+
+    // RFC 5861 Cache-Control Extensions for Stale Content
+    // stale-while-revalidate and stale-if-error are read only here, since most entries are fresh when used.
+    CacheControl::Ptr pResponseCacheControl = pStaleResponse ? pStaleResponse->getCacheControl() : NULL;
+    if (isResponseNoCache || isResponseMustRevalidate || !pResponseCacheControl) {
+        return;
+    }
+    long long staleWhileRevalidateSec = pResponseCacheControl->getStaleWhileRevalidateSec();
+    long long staleIfErrorSec = pResponseCacheControl->getStaleIfErrorSec();
+    if (pRequestCacheControl && pRequestCacheControl->getStaleIfErrorSec() != -1) {
+        staleIfErrorSec = pRequestCacheControl->getStaleIfErrorSec();
+    }
+    if (staleIfErrorSec != -1 && ageSec < freshSec + static_cast<unsigned long long>(staleIfErrorSec)) {
+        Response::Builder responseBuilder(pStaleResponse);
+        m_pStaleIfErrorResponse = responseBuilder.addHeader(HttpConstants::HeaderNames::Warning,
+                HttpConstants::HeaderValues::RevalidationFailed).build();
+        EASYHTTPCPP_LOG_D(Tag, "stale-if-error: ageSec=%llu freshSec=%llu staleIfErrorSec=%lld", ageSec, freshSec,
+                staleIfErrorSec);
+    }
+    // when the caller asks for a fresher response by max-age or min-fresh, it is revalidated in the foreground.
+    if (staleWhileRevalidateSec != -1 && requestMaxAgeSec == -1 && requestMinFreshSec == -1 &&
+            ageSec < freshSec + static_cast<unsigned long long>(staleWhileRevalidateSec)) {
+        Response::Builder responseBuilder(pStaleResponse);
+        m_pCacheResponse = responseBuilder.addHeader(HttpConstants::HeaderNames::Warning,
+                HttpConstants::HeaderValues::ResponseIsStale).build();
+        m_pRevalidationRequest = m_pNetworkRequest;
+        m_pNetworkRequest = NULL;
+        EASYHTTPCPP_LOG_D(Tag, "stale-while-revalidate: ageSec=%llu freshSec=%llu staleWhileRevalidateSec=%lld",
+                ageSec, freshSec, staleWhileRevalidateSec);
+    }
 }
 
 Request::Ptr HttpCacheStrategy::getNetworkRequest()
@@ -186,6 +211,24 @@ Response::Ptr HttpCacheStrategy::getCachedResponse()
     return m_pCacheResponse;
 }
 
+Request::Ptr HttpCacheStrategy::getRevalidationRequest()
+{
+    return m_pRevalidationRequest;
+}
+
+Response::Ptr HttpCacheStrategy::getStaleIfErrorResponse()
+{
+    return m_pStaleIfErrorResponse;
+}
+
+void HttpCacheStrategy::loadCacheResponse()
+{
+    if (!m_pCacheResponse && m_pCacheMetadata) {
+        m_pCacheResponse = createResponseFromCacheMetadata(m_pRequest, *m_pCacheMetadata);
+        m_pCacheMetadata = NULL;
+    }
+}
+
 unsigned long long HttpCacheStrategy::calculateCacheResponseAge()
 {
     // reference RFC 2616 13.2.3 Age Calculations
@@ -202,16 +245,17 @@ unsigned long long HttpCacheStrategy::calculateCacheResponseAge()
     // receivedAge + responseDuration : Age of receive response (include network delay)
     // receivedAge + responseDuration + residentDuration : current Age (include network delay)
 
-    std::time_t receivedResponseSec = m_pCacheResponse->getReceivedResponseSec();
+    long long receivedResponseSec = m_receivedResponseSec;
+    long long responseDateAtEpoch = m_pFreshness->getResponseDateAtEpoch();
     long long apparentReceivedAge = 0;
-    if (m_responseDateExisted) {
-        apparentReceivedAge = std::max(0LL, static_cast<long long> (receivedResponseSec - m_responseDate.epochTime()));
+    if (responseDateAtEpoch != -1) {
+        apparentReceivedAge = std::max(0LL, receivedResponseSec - responseDateAtEpoch);
     }
     long long receivedAge = apparentReceivedAge;
-    if (m_ageExisted) {
-        receivedAge = std::max(apparentReceivedAge, m_ageSec);
+    if (m_pFreshness->getAgeSec() != -1) {
+        receivedAge = std::max(apparentReceivedAge, m_pFreshness->getAgeSec());
     }
-    long long responseDuration = receivedResponseSec - m_pCacheResponse->getSentRequestSec();
+    long long responseDuration = receivedResponseSec - m_sentRequestSec;
     long long residentDuration = m_nowAtEpoch - receivedResponseSec;
 
     return static_cast<unsigned long long>(receivedAge + responseDuration + residentDuration);
@@ -220,19 +264,19 @@ unsigned long long HttpCacheStrategy::calculateCacheResponseAge()
 unsigned long long HttpCacheStrategy::calculateFreshnessLifetime()
 {
     // RFC 2616 13.2.4 Expiration Calculations
-    CacheControl::Ptr pResponseCacheControl = m_pCacheResponse->getCacheControl();
-    if (pResponseCacheControl && pResponseCacheControl->getMaxAgeSec() != -1) {
+    long long responseDateAtEpoch = m_pFreshness->getResponseDateAtEpoch();
+    if (m_pFreshness->getMaxAgeSec() != -1) {
         // MaxAge
         EASYHTTPCPP_LOG_D(Tag, "calculateFreshnessLifetime: use max-age");
-        return static_cast<unsigned long long>(pResponseCacheControl->getMaxAgeSec());
-    } else if (m_expiresExisted) {
+        return static_cast<unsigned long long>(m_pFreshness->getMaxAgeSec());
+    } else if (m_pFreshness->getExpiresAtEpoch() != -1) {
         // Expires - (Date or receivedResponseSec))
         EASYHTTPCPP_LOG_D(Tag, "calculateFreshnessLifetime: use Expires");
-        long long responseSec = m_pCacheResponse->getReceivedResponseSec();
-        if (m_responseDateExisted) {
-            responseSec = m_responseDate.epochTime();
+        long long responseSec = m_receivedResponseSec;
+        if (responseDateAtEpoch != -1) {
+            responseSec = responseDateAtEpoch;
         }
-        long long delta = m_expires.epochTime() - responseSec;
+        long long delta = m_pFreshness->getExpiresAtEpoch() - responseSec;
         return static_cast<unsigned long long>(delta > 0 ? delta : 0);
     } else {
         // RFC 2616 13.2.4 Expiration Calculations
@@ -240,15 +284,14 @@ unsigned long long HttpCacheStrategy::calculateFreshnessLifetime()
         // RFC 2616 13.9 Side Effects of GET and HEAD
         // if with query url, cache must not treat response as fresh unless the server provides
         // an explicit expiration time.
-        const std::string& url = m_pCacheResponse->getRequest()->getUrl();
-        Poco::URI uri(url);
-        if (m_lastModifiedExisted && uri.getQuery().empty()) {
+        Poco::URI uri(m_cacheUrl);
+        if (m_pFreshness->getLastModifiedAtEpoch() != -1 && uri.getQuery().empty()) {
             EASYHTTPCPP_LOG_D(Tag, "calculateFreshnessLifetime: use 10%% of Date and sentRequestSec");
-            long long responseSec = m_pCacheResponse->getSentRequestSec();
-            if (m_responseDateExisted) {
-                responseSec = m_responseDate.epochTime();
+            long long responseSec = m_sentRequestSec;
+            if (responseDateAtEpoch != -1) {
+                responseSec = responseDateAtEpoch;
             }
-            long long delta = responseSec - m_lastModified.epochTime();
+            long long delta = responseSec - m_pFreshness->getLastModifiedAtEpoch();
             return static_cast<unsigned long long>(delta > 0 ? (delta / 10) : 0);
         }
     }
@@ -273,6 +316,10 @@ bool HttpCacheStrategy::isAvailableToCache(Request::Ptr pRequest)
     if (pRequest->hasHeader(HttpConstants::HeaderNames::IfNoneMatch)) {
         return false;
     }
+    // a cached full response must not be returned for a partial request.
+    if (pRequest->hasHeader(HttpConstants::HeaderNames::Range)) {
+        return false;
+    }
 
     return true;
 }
@@ -456,6 +503,31 @@ bool HttpCacheStrategy::isInvalidCacheMethod(Response::Ptr pResponse)
     }
 }
 
+Response::Ptr HttpCacheStrategy::createResponseFromCacheMetadata(Request::Ptr pRequest,
+        HttpCacheMetadata& httpCacheMetadata)
+{
+    // create CacheControl from CacheMetadata
+    CacheControl::Ptr pCacheControl = CacheControl::createFromHeaders(httpCacheMetadata.getResponseHeaders());
+
+    // create Response
+    Headers::Ptr pResponseHeaders = httpCacheMetadata.getResponseHeaders();
+    Response::Builder builder;
+    builder.setCode(httpCacheMetadata.getStatusCode()).setMessage(httpCacheMetadata.getStatusMessage()).
+            setCacheControl(pCacheControl).setHeaders(pResponseHeaders).
+            setRequest(pRequest).setSentRequestSec(httpCacheMetadata.getSentRequestAtEpoch()).
+            setReceivedResponseSec(httpCacheMetadata.getReceivedResponseAtEpoch());
+
+    if (pResponseHeaders->has(HttpConstants::HeaderNames::ContentLength)) {
+        std::string contentLengthStr = pResponseHeaders->getValue(
+                HttpConstants::HeaderNames::ContentLength, "-1");
+        Poco::Int64 contentLength;
+        if (Poco::NumberParser::tryParse64(contentLengthStr, contentLength)) {
+            builder.setHasContentLength(true).setContentLength(static_cast<ssize_t> (contentLength));
+        }
+    }
+    return builder.build();
+}
+
 bool HttpCacheStrategy::isEndToEnd(const std::string& name)
 {
     // RFC 2616 13.5.1 the following header is Hop-by-hop Headers (except the following is End-to-end Headers)
@@ -9,13 +9,15 @@
 
 #include "Poco/AutoPtr.h"
 #include "Poco/RefCountedObject.h"
-#include "Poco/Timestamp.h"
 
 #include "easyhttpcpp/Headers.h"
 #include "easyhttpcpp/HttpExports.h"
 #include "easyhttpcpp/Request.h"
 #include "easyhttpcpp/Response.h"
 
+#include "HttpCacheFreshness.h"
+#include "HttpCacheMetadata.h"
+
 namespace easyhttpcpp {
 
 class EASYHTTPCPP_HTTP_INTERNAL_API HttpCacheStrategy : public Poco::RefCountedObject {
@@ -23,10 +25,17 @@ public:
     typedef Poco::AutoPtr<HttpCacheStrategy> Ptr;
 
     HttpCacheStrategy(Request::Ptr pRequest, Response::Ptr pCacheResponse, unsigned long long nowAtEpoch);
+    // cache response is created from metadata only when it is used.
+    HttpCacheStrategy(Request::Ptr pRequest, HttpCacheMetadata::Ptr pCacheMetadata,
+            HttpCacheFreshness::Ptr pFreshness, unsigned long long nowAtEpoch);
     virtual ~HttpCacheStrategy();
 
     Request::Ptr getNetworkRequest();
     Response::Ptr getCachedResponse();
+    // RFC 5861 stale-while-revalidate; the cached response is returned and this request is sent in background.
+    Request::Ptr getRevalidationRequest();
+    // RFC 5861 stale-if-error; the cached response which may be returned when the network request fails.
+    Response::Ptr getStaleIfErrorResponse();
 
     static bool isAvailableToCache(Request::Ptr pRequest);
     static bool isValidCacheResponse(Response::Ptr pCacheResponse, Response::Ptr pNetworkResponse);
@@ -35,24 +44,27 @@ public:
     static bool isInvalidCacheMethod(Response::Ptr pResponse);
 
 private:
+    void resolveNetworkRequestWithoutCache();
     void resolveCacheResponseAndNetworkRequest();
+    void loadCacheResponse();
     unsigned long long calculateCacheResponseAge();
     unsigned long long calculateFreshnessLifetime();
 
+    static Response::Ptr createResponseFromCacheMetadata(Request::Ptr pRequest,
+            HttpCacheMetadata& httpCacheMetadata);
     static bool isEndToEnd(const std::string& name);
 
     unsigned long long m_nowAtEpoch;
     Request::Ptr m_pRequest;
     Request::Ptr m_pNetworkRequest;
     Response::Ptr m_pCacheResponse;
-    Poco::Timestamp m_responseDate;
-    bool m_responseDateExisted;
-    Poco::Timestamp m_lastModified;
-    bool m_lastModifiedExisted;
-    Poco::Timestamp m_expires;
-    bool m_expiresExisted;
-    long long m_ageSec;
-    bool m_ageExisted;
+    Request::Ptr m_pRevalidationRequest;
+    Response::Ptr m_pStaleIfErrorResponse;
+    HttpCacheMetadata::Ptr m_pCacheMetadata;
+    HttpCacheFreshness::Ptr m_pFreshness;
+    std::string m_cacheUrl;
+    long long m_sentRequestSec;
+    long long m_receivedResponseSec;
 };
 
 } /* namespace easyhttpcpp */
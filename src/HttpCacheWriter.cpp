@@ -0,0 +1,237 @@
+/*
+ * Copyright 2019 Sony Corporation
+ */
+
+#include "Poco/Exception.h"
+#include "Poco/ScopedUnlock.h"
+
+#include "easyhttpcpp/common/CoreLogger.h"
+
+#include "HttpCacheWriter.h"
+#include "HttpInternalConstants.h"
+
+namespace easyhttpcpp {
+
+static const std::string Tag = "HttpCacheWriter";
+
+HttpCacheWriter::Output::Output(Poco::FileOutputStream* pStream) : m_pStream(pStream), m_pCompressedStream(NULL),
+        m_pDeflatingStream(NULL), m_queuedChunkCount(0), m_failed(false), m_compressionFailed(false)
+{
+}
+
+HttpCacheWriter::Output::Output(Poco::FileOutputStream* pStream, Poco::FileOutputStream* pCompressedStream) :
+        m_pStream(pStream), m_pCompressedStream(pCompressedStream), m_pDeflatingStream(NULL), m_queuedChunkCount(0),
+        m_failed(false), m_compressionFailed(false)
+{
+    if (m_pCompressedStream) {
+        m_pDeflatingStream = new Poco::DeflatingOutputStream(*m_pCompressedStream,
+                Poco::DeflatingStreamBuf::STREAM_GZIP,
+                HttpInternalConstants::ContentEncodings::DefaultCompressionLevel);
+    }
+}
+
+HttpCacheWriter::Output::~Output()
+{
+    // the deflating stream writes to the compressed stream until it is deleted.
+    delete m_pDeflatingStream;
+    m_pDeflatingStream = NULL;
+    if (m_pCompressedStream) {
+        m_pCompressedStream->close();
+        delete m_pCompressedStream;
+        m_pCompressedStream = NULL;
+    }
+    if (m_pStream) {
+        m_pStream->close();
+        delete m_pStream;
+        m_pStream = NULL;
+    }
+}
+
+bool HttpCacheWriter::Output::isCompressed() const
+{
+    // a failed output stops writing both copies.
+    return m_pCompressedStream != NULL && !m_failed && !m_compressionFailed;
+}
+
+HttpCacheWriter::HttpCacheWriter(size_t maxQueuedBytes) : m_maxQueuedBytes(maxQueuedBytes), m_queuedBytes(0),
+        m_stopped(false), m_writerRunnable(*this, &HttpCacheWriter::run)
+{
+}
+
+HttpCacheWriter::~HttpCacheWriter()
+{
+    {
+        Poco::FastMutex::ScopedLock lock(m_instanceMutex);
+        m_stopped = true;
+        m_queuedCondition.signal();
+    }
+    // the queued chunks are written before the writer thread ends.
+    if (m_writerThread.isRunning()) {
+        m_writerThread.join();
+    }
+}
+
+bool HttpCacheWriter::write(Output::Ptr pOutput, const char* pData, size_t bytes, bool waitForRoom)
+{
+    Poco::FastMutex::ScopedLock lock(m_instanceMutex);
+
+    while (m_queuedBytes > 0 && m_queuedBytes + bytes > m_maxQueuedBytes) {
+        if (!waitForRoom) {
+            EASYHTTPCPP_LOG_D(Tag, "write: queue is full. queued=%zu bytes=%zu", m_queuedBytes, bytes);
+            return false;
+        }
+        m_writtenCondition.wait(m_instanceMutex);
+    }
+
+    // the writer thread is started before queuing, so that a chunk is not left behind without a writer.
+    if (!m_writerThread.isRunning()) {
+        try {
+            startWriterThread();
+        } catch (const Poco::Exception& e) {
+            EASYHTTPCPP_LOG_D(Tag, "write: can not start writer thread. Details: %s", e.message().c_str());
+            return false;
+        }
+    }
+
+    m_queue.push_back(Chunk());
+    m_queue.back().m_pOutput = pOutput;
+    m_queue.back().m_data.assign(pData, bytes);
+    m_queuedBytes += bytes;
+    pOutput->m_queuedChunkCount++;
+
+    m_queuedCondition.signal();
+    return true;
+}
+
+bool HttpCacheWriter::close(Output::Ptr pOutput)
+{
+    {
+        Poco::FastMutex::ScopedLock lock(m_instanceMutex);
+        while (pOutput->m_queuedChunkCount > 0) {
+            m_writtenCondition.wait(m_instanceMutex);
+        }
+    }
+
+    // nothing of the output is queued anymore, so the streams are not touched by the writer thread.
+    closeCompressedStream(pOutput);
+    if (!pOutput->m_pStream) {
+        return !pOutput->m_failed;
+    }
+    try {
+        pOutput->m_pStream->close();
+        if (!pOutput->m_pStream->good()) {
+            pOutput->m_failed = true;
+        }
+    } catch (const std::exception& e) {
+        EASYHTTPCPP_LOG_D(Tag, "close: can not close output. Details: %s", e.what());
+        pOutput->m_failed = true;
+    }
+    delete pOutput->m_pStream;
+    pOutput->m_pStream = NULL;
+    return !pOutput->m_failed;
+}
+
+size_t HttpCacheWriter::getQueuedBytes()
+{
+    Poco::FastMutex::ScopedLock lock(m_instanceMutex);
+
+    return m_queuedBytes;
+}
+
+void HttpCacheWriter::startWriterThread()
+{
+    m_writerThread.start(m_writerRunnable);
+}
+
+void HttpCacheWriter::run()
+{
+    Poco::FastMutex::ScopedLock lock(m_instanceMutex);
+
+    while (true) {
+        while (m_queue.empty() && !m_stopped) {
+            m_queuedCondition.wait(m_instanceMutex);
+        }
+        if (m_queue.empty()) {
+            break;
+        }
+        Chunk chunk;
+        chunk.m_pOutput = m_queue.front().m_pOutput;
+        chunk.m_data.swap(m_queue.front().m_data);
+        m_queue.pop_front();
+
+        bool written;
+        {
+            Poco::ScopedUnlock<Poco::FastMutex> unlock(m_instanceMutex);
+            written = writeChunk(chunk.m_pOutput, chunk.m_data);
+        }
+        if (!written) {
+            chunk.m_pOutput->m_failed = true;
+        }
+        // the chunk is counted until it is written, so that the queue bound includes the chunk being written.
+        m_queuedBytes -= chunk.m_data.size();
+        chunk.m_pOutput->m_queuedChunkCount--;
+        m_writtenCondition.broadcast();
+    }
+    EASYHTTPCPP_LOG_D(Tag, "run: writer thread stopped.");
+}
+
+bool HttpCacheWriter::writeChunk(Output* pOutput, const std::string& data)
+{
+    // the rest of a failed output is not written, nor a chunk queued after the output is closed.
+    if (pOutput->m_failed || !pOutput->m_pStream) {
+        return false;
+    }
+    try {
+        pOutput->m_pStream->write(data.data(), static_cast<std::streamsize> (data.size()));
+        if (!pOutput->m_pStream->good()) {
+            EASYHTTPCPP_LOG_D(Tag, "writeChunk: can not write %zu bytes.", data.size());
+            return false;
+        }
+    } catch (const std::exception& e) {
+        EASYHTTPCPP_LOG_D(Tag, "writeChunk: can not write. Details: %s", e.what());
+        return false;
+    }
+    compressChunk(pOutput, data);
+    return true;
+}
+
+void HttpCacheWriter::compressChunk(Output* pOutput, const std::string& data)
+{
+    if (!pOutput->m_pDeflatingStream || pOutput->m_compressionFailed) {
+        return;
+    }
+    try {
+        pOutput->m_pDeflatingStream->write(data.data(), static_cast<std::streamsize> (data.size()));
+        if (!pOutput->m_pDeflatingStream->good()) {
+            EASYHTTPCPP_LOG_D(Tag, "compressChunk: can not compress %zu bytes.", data.size());
+            pOutput->m_compressionFailed = true;
+        }
+    } catch (const std::exception& e) {
+        EASYHTTPCPP_LOG_D(Tag, "compressChunk: can not compress. Details: %s", e.what());
+        pOutput->m_compressionFailed = true;
+    }
+}
+
+void HttpCacheWriter::closeCompressedStream(Output* pOutput)
+{
+    if (!pOutput->m_pCompressedStream) {
+        return;
+    }
+    if (pOutput->m_pDeflatingStream) {
+        try {
+            // writes the rest of the deflated bytes and the gzip trailer.
+            pOutput->m_pDeflatingStream->close();
+            pOutput->m_pCompressedStream->close();
+            if (!pOutput->m_pCompressedStream->good()) {
+                pOutput->m_compressionFailed = true;
+            }
+        } catch (const std::exception& e) {
+            EASYHTTPCPP_LOG_D(Tag, "closeCompressedStream: can not close. Details: %s", e.what());
+            pOutput->m_compressionFailed = true;
+        }
+        delete pOutput->m_pDeflatingStream;
+        pOutput->m_pDeflatingStream = NULL;
+    }
+}
+
+} /* namespace easyhttpcpp */
@@ -0,0 +1,122 @@
+/*
+ * Copyright 2019 Sony Corporation
+ */
+
+#ifndef EASYHTTPCPP_HTTPCACHEWRITER_H_INCLUDED
+#define EASYHTTPCPP_HTTPCACHEWRITER_H_INCLUDED
+
+#include <list>
+#include <string>
+
+#include "Poco/AutoPtr.h"
+#include "Poco/Condition.h"
+#include "Poco/DeflatingStream.h"
+#include "Poco/FileStream.h"
+#include "Poco/Mutex.h"
+#include "Poco/RefCountedObject.h"
+#include "Poco/RunnableAdapter.h"
+#include "Poco/Thread.h"
+#include "Poco/Types.h"
+
+#include "easyhttpcpp/HttpExports.h"
+
+namespace easyhttpcpp {
+
+/**
+ * Writes response bodies to cache temp files on a background thread (write-behind), so that reading a response
+ * body does not wait for the disk. Bytes are queued in memory up to a bound; write does not block when the queue
+ * is full but refuses the bytes, and the caller gives up caching the response then.
+ */
+class EASYHTTPCPP_HTTP_INTERNAL_API HttpCacheWriter : public Poco::RefCountedObject {
+public:
+    typedef Poco::AutoPtr<HttpCacheWriter> Ptr;
+
+    /**
+     * A file written by HttpCacheWriter. The streams are owned by Output and are only touched by the writer thread
+     * until HttpCacheWriter::close.
+     */
+    class Output : public Poco::RefCountedObject {
+    public:
+        typedef Poco::AutoPtr<Output> Ptr;
+
+        Output(Poco::FileOutputStream* pStream);
+        /**
+         * @param pCompressedStream receives a gzip copy of the bytes, deflated by the writer thread as well.
+         */
+        Output(Poco::FileOutputStream* pStream, Poco::FileOutputStream* pCompressedStream);
+        virtual ~Output();
+
+        /**
+         * @return true if the gzip copy is complete; it is known after HttpCacheWriter::close.
+         */
+        bool isCompressed() const;
+
+    private:
+        Output();
+
+        Poco::FileOutputStream* m_pStream;
+        Poco::FileOutputStream* m_pCompressedStream;
+        Poco::DeflatingOutputStream* m_pDeflatingStream;
+        size_t m_queuedChunkCount;
+        bool m_failed;
+        // the gzip copy is best-effort, so that its failure does not fail the output.
+        bool m_compressionFailed;
+
+        friend class HttpCacheWriter;
+    };
+
+    HttpCacheWriter(size_t maxQueuedBytes);
+    virtual ~HttpCacheWriter();
+
+    /**
+     * Queues the bytes to be written to the output. Bytes are always accepted when nothing is queued.
+     * @param waitForRoom if true, waits until the queue has room instead of refusing the bytes.
+     * @return false if the queue is full or the writer thread can not be started; the bytes are not written then.
+     */
+    bool write(Output::Ptr pOutput, const char* pData, size_t bytes, bool waitForRoom);
+
+    /**
+     * Waits until the queued bytes of the output are written, and closes the output.
+     * @return false if writing or flushing the output failed.
+     */
+    bool close(Output::Ptr pOutput);
+
+    size_t getQueuedBytes();
+
+protected:
+    /**
+     * Starts the writer thread; called with the queue locked.
+     * @exception Poco::Exception if the thread can not be started.
+     */
+    virtual void startWriterThread();
+
+private:
+    HttpCacheWriter();
+
+    struct Chunk {
+        Output::Ptr m_pOutput;
+        std::string m_data;
+    };
+
+    void run();
+    bool writeChunk(Output* pOutput, const std::string& data);
+    void compressChunk(Output* pOutput, const std::string& data);
+    void closeCompressedStream(Output* pOutput);
+
+    size_t m_maxQueuedBytes;
+    Poco::FastMutex m_instanceMutex;
+    // signaled when a chunk is queued or the writer is stopped.
+    Poco::Condition m_queuedCondition;
+    // broadcast when a chunk is written.
+    Poco::Condition m_writtenCondition;
+    std::list<Chunk> m_queue;
+    size_t m_queuedBytes;
+    bool m_stopped;
+    // the writer thread is started on the first write.
+    Poco::Thread m_writerThread;
+    Poco::RunnableAdapter<HttpCacheWriter> m_writerRunnable;
+};
+
+} /* namespace easyhttpcpp */
+
+#endif /* EASYHTTPCPP_HTTPCACHEWRITER_H_INCLUDED */
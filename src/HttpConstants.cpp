@@ -6,6 +6,8 @@
 
 namespace easyhttpcpp {
 
+const char* const HttpConstants::HeaderNames::AcceptEncoding = "Accept-Encoding";
+const char* const HttpConstants::HeaderNames::AcceptRanges = "Accept-Ranges";
 const char* const HttpConstants::HeaderNames::Age = "Age";
 const char* const HttpConstants::HeaderNames::Authorization = "Authorization";
 const char* const HttpConstants::HeaderNames::CacheControl = "Cache-Control";
@@ -13,11 +15,13 @@ const char* const HttpConstants::HeaderNames::Connection = "Connection";
 const char* const HttpConstants::HeaderNames::ContentEncoding = "Content-Encoding";
 const char* const HttpConstants::HeaderNames::ContentType = "Content-Type";
 const char* const HttpConstants::HeaderNames::ContentLength = "Content-Length";
+const char* const HttpConstants::HeaderNames::ContentRange = "Content-Range";
 const char* const HttpConstants::HeaderNames::Date = "Date";
 const char* const HttpConstants::HeaderNames::ETag = "ETag";
 const char* const HttpConstants::HeaderNames::Expires = "Expires";
 const char* const HttpConstants::HeaderNames::IfModifiedSince = "If-Modified-Since";
 const char* const HttpConstants::HeaderNames::IfNoneMatch = "If-None-Match";
+const char* const HttpConstants::HeaderNames::IfRange = "If-Range";
 const char* const HttpConstants::HeaderNames::KeepAlive = "Keep-Alive";
 const char* const HttpConstants::HeaderNames::LastModified = "Last-Modified";
 const char* const HttpConstants::HeaderNames::Location = "Location";
@@ -36,7 +40,12 @@ const char* const HttpConstants::HeaderValues::Chunked = "chunked";
 const char* const HttpConstants::HeaderValues::Close = "close";
 const char* const HttpConstants::HeaderValues::HeuristicExpiration = "113 - Heuristic expiration";
 const char* const HttpConstants::HeaderValues::ResponseIsStale = "110 - Response is stale";
+const char* const HttpConstants::HeaderValues::RevalidationFailed = "111 - Revalidation failed";
 const char* const HttpConstants::HeaderValues::ApplicationOctetStream = "application/octet-stream";
+const char* const HttpConstants::HeaderValues::Bytes = "bytes";
+const char* const HttpConstants::HeaderValues::Deflate = "deflate";
+const char* const HttpConstants::HeaderValues::Gzip = "gzip";
+const char* const HttpConstants::HeaderValues::XGzip = "x-gzip";
 
 const char* const HttpConstants::CacheDirectives::MaxAge = "max-age";
 const char* const HttpConstants::CacheDirectives::MaxStale = "max-stale";
@@ -49,6 +58,8 @@ const char* const HttpConstants::CacheDirectives::OnlyIfCached = "only-if-cached
 const char* const HttpConstants::CacheDirectives::Private = "private";
 const char* const HttpConstants::CacheDirectives::Public = "public";
 const char* const HttpConstants::CacheDirectives::SMaxAge = "s-maxage";
+const char* const HttpConstants::CacheDirectives::StaleIfError = "stale-if-error";
+const char* const HttpConstants::CacheDirectives::StaleWhileRevalidate = "stale-while-revalidate";
 
 const char* const HttpConstants::Schemes::Http = "http";
 const char* const HttpConstants::Schemes::Https = "https";
@@ -0,0 +1,33 @@
+/*
+ * Copyright 2019 Sony Corporation
+ */
+
+#include "easyhttpcpp/messagedigest/DigestUtil.h"
+
+#include "HttpDigestCacheKeyHasher.h"
+
+using easyhttpcpp::messagedigest::DigestUtil;
+
+namespace easyhttpcpp {
+
+const std::string HttpDigestCacheKeyHasher::Name = "digest";
+
+HttpDigestCacheKeyHasher::HttpDigestCacheKeyHasher()
+{
+}
+
+HttpDigestCacheKeyHasher::~HttpDigestCacheKeyHasher()
+{
+}
+
+const std::string& HttpDigestCacheKeyHasher::getName() const
+{
+    return Name;
+}
+
+std::string HttpDigestCacheKeyHasher::hash(const std::string& data)
+{
+    return DigestUtil::createHashedFileName(data);
+}
+
+} /* namespace easyhttpcpp */
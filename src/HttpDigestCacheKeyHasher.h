@@ -0,0 +1,32 @@
+/*
+ * Copyright 2019 Sony Corporation
+ */
+
+#ifndef EASYHTTPCPP_HTTPDIGESTCACHEKEYHASHER_H_INCLUDED
+#define EASYHTTPCPP_HTTPDIGESTCACHEKEYHASHER_H_INCLUDED
+
+#include <string>
+
+#include "easyhttpcpp/HttpCacheKeyHasher.h"
+#include "easyhttpcpp/HttpExports.h"
+
+namespace easyhttpcpp {
+
+/**
+ * Makes the key with the message digest of DigestUtil::createHashedFileName, which caches used before the key
+ * hasher was added.
+ */
+class EASYHTTPCPP_HTTP_INTERNAL_API HttpDigestCacheKeyHasher : public HttpCacheKeyHasher {
+public:
+    HttpDigestCacheKeyHasher();
+    virtual ~HttpDigestCacheKeyHasher();
+
+    virtual const std::string& getName() const;
+    virtual std::string hash(const std::string& data);
+
+    static const std::string Name;
+};
+
+} /* namespace easyhttpcpp */
+
+#endif /* EASYHTTPCPP_HTTPDIGESTCACHEKEYHASHER_H_INCLUDED */
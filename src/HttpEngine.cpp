@@ -7,9 +7,12 @@
 
 #include "Poco/Buffer.h"
 #include "Poco/Exception.h"
+#include "Poco/File.h"
+#include "Poco/FileStream.h"
 #include "Poco/NumberFormatter.h"
 #include "Poco/SharedPtr.h"
 #include "Poco/String.h"
+#include "Poco/TemporaryFile.h"
 #include "Poco/Timespan.h"
 #include "Poco/Timestamp.h"
 #include "Poco/URI.h"
@@ -24,23 +27,29 @@
 #include "easyhttpcpp/common/CacheManager.h"
 #include "easyhttpcpp/common/CacheMetadata.h"
 #include "easyhttpcpp/common/CoreLogger.h"
+#include "easyhttpcpp/common/FileUtil.h"
 #include "easyhttpcpp/common/StringUtil.h"
 #include "easyhttpcpp/HttpConstants.h"
 #include "easyhttpcpp/HttpException.h"
 #include "easyhttpcpp/Request.h"
 #include "easyhttpcpp/Response.h"
 
+#include "ByteRangeInputStream.h"
 #include "HttpCacheInternal.h"
 #include "HttpCacheMetadata.h"
+#include "HttpCacheRevalidationTask.h"
 #include "HttpEngine.h"
+#include "HttpInternalConstants.h"
 #include "HttpUtil.h"
 #include "NetworkInterceptorChain.h"
 #include "ResponseBodyStreamFromCache.h"
+#include "ResponseBodyStreamWithDecoding.h"
 #include "ResponseBodyStreamWithoutCaching.h"
 #include "ResponseBodyStreamWithCaching.h"
 
 using easyhttpcpp::common::CacheManager;
 using easyhttpcpp::common::CacheMetadata;
+using easyhttpcpp::common::FileUtil;
 using easyhttpcpp::common::StringUtil;
 
 namespace easyhttpcpp {
@@ -67,6 +76,20 @@ HttpEngine::~HttpEngine()
 }
 
 Response::Ptr HttpEngine::execute()
+{
+    Response::Ptr pUserResponse;
+    try {
+        pUserResponse = createUserResponseWithDecoding(executeInternal());
+    } catch (...) {
+        endFlight();
+        throw;
+    }
+    // the flight ends here unless it was handed over to the response body which is filling the cache.
+    endFlight();
+    return pUserResponse;
+}
+
+Response::Ptr HttpEngine::executeInternal()
 {
     Response::Ptr pUserResponse;
     Request::Ptr pNetworkRequest;
@@ -77,16 +100,37 @@ Response::Ptr HttpEngine::execute()
         return pUserResponse;
     }
 
+    // resume the interrupted download of this request, if any.
+    Request::Ptr pResumeRequest = createResumeRequest(pNetworkRequest);
+
     // execute sendRequest and receiveResponse
-    Response::Ptr pNetworkResponse;
-    EasyHttpContext::InterceptorList& networkInterceptors = m_pContext->getNetworkInterceptors();
-    EasyHttpContext::InterceptorList::iterator it = networkInterceptors.begin();
-    EasyHttpContext::InterceptorList::const_iterator itEnd = networkInterceptors.end();
-    if (it == itEnd) {
-        pNetworkResponse = sendRequestAndReceiveResponseWithRetryByConnection(pNetworkRequest);
-    } else {
-        NetworkInterceptorChain::Ptr chain(new NetworkInterceptorChain(*this, pNetworkRequest, it, itEnd));
-        pNetworkResponse = (*it)->intercept(*chain);
+    Response::Ptr pNetworkResponse = sendNetworkRequestWithStaleIfError(pResumeRequest ? pResumeRequest :
+            pNetworkRequest);
+    if (!pNetworkResponse) {
+        EASYHTTPCPP_LOG_D(Tag, "execute: return from cache because the request failed.(stale-if-error)");
+        return createUserResponseFromCacheResponse(m_pStaleIfErrorResponse, NULL);
+    }
+
+    if (pResumeRequest) {
+        Response::Ptr pResumedResponse = createUserResponseWithResuming(pNetworkResponse);
+        if (pResumedResponse) {
+            EASYHTTPCPP_LOG_D(Tag, "execute: return from partial content and network response.");
+            return pResumedResponse;
+        }
+        // 200 is the whole body because If-Range did not match. otherwise request the whole body again.
+        if (pNetworkResponse->getCode() != Poco::Net::HTTPResponse::HTTP_OK) {
+            EASYHTTPCPP_LOG_D(Tag, "execute: can not resume. [status code=%d]", pNetworkResponse->getCode());
+            pNetworkResponse->getBody()->close();
+            pNetworkResponse = sendNetworkRequest(pNetworkRequest);
+        }
+    }
+
+    // RFC 5861 4. The stale-if-error Cache-Control Extension
+    if (m_pStaleIfErrorResponse && isStaleIfErrorStatusCode(pNetworkResponse)) {
+        EASYHTTPCPP_LOG_D(Tag, "execute: return from cache instead of server error. [status code=%d]",
+                pNetworkResponse->getCode());
+        closeResponseBody(pNetworkResponse);
+        return createUserResponseFromCacheResponse(m_pStaleIfErrorResponse, NULL);
     }
 
     // if not exist cache, create user response from network response.
@@ -122,6 +166,62 @@ Response::Ptr HttpEngine::execute()
     }
 }
 
+void HttpEngine::revalidate(Request::Ptr pRevalidationRequest, Response::Ptr pCacheResponse)
+{
+    Response::Ptr pNetworkResponse = sendNetworkRequest(pRevalidationRequest);
+
+    if (HttpCacheStrategy::isValidCacheResponse(pCacheResponse, pNetworkResponse)) {
+        EASYHTTPCPP_LOG_D(Tag, "revalidate: update cache.(Not Modified or cache is fresh than network response.)");
+        updateCache(pCacheResponse, pNetworkResponse,
+                HttpCacheStrategy::combineCacheAndNetworkHeader(pCacheResponse, pNetworkResponse));
+        closeResponseBody(pNetworkResponse);
+        return;
+    }
+
+    // the cache can not be replaced while the stale response body is read; it is revalidated again next time.
+    if (HttpCacheStrategy::isCacheable(pNetworkResponse)) {
+        EASYHTTPCPP_LOG_D(Tag, "revalidate: replace cache.");
+        readAllResponseBodyForCache(createUserResponseWithCaching(pNetworkResponse));
+        return;
+    }
+
+    EASYHTTPCPP_LOG_D(Tag, "revalidate: keep cache because network response is not cacheable. [status code=%d]",
+            pNetworkResponse->getCode());
+    closeResponseBody(pNetworkResponse);
+}
+
+Response::Ptr HttpEngine::sendNetworkRequestWithStaleIfError(Request::Ptr pNetworkRequest)
+{
+    if (!m_pStaleIfErrorResponse) {
+        return sendNetworkRequest(pNetworkRequest);
+    }
+    try {
+        return sendNetworkRequest(pNetworkRequest);
+    } catch (const HttpException& e) {
+        {
+            Poco::FastMutex::ScopedLock lock(m_connectionMutex);
+            if (m_cancelled) {
+                throw;
+            }
+        }
+        EASYHTTPCPP_LOG_D(Tag, "sendNetworkRequestWithStaleIfError: request failed. [%s]", e.getMessage().c_str());
+        return NULL;
+    }
+}
+
+Response::Ptr HttpEngine::sendNetworkRequest(Request::Ptr pNetworkRequest)
+{
+    EasyHttpContext::InterceptorList& networkInterceptors = m_pContext->getNetworkInterceptors();
+    EasyHttpContext::InterceptorList::iterator it = networkInterceptors.begin();
+    EasyHttpContext::InterceptorList::const_iterator itEnd = networkInterceptors.end();
+    if (it == itEnd) {
+        return sendRequestAndReceiveResponseWithRetryByConnection(pNetworkRequest);
+    } else {
+        NetworkInterceptorChain::Ptr chain(new NetworkInterceptorChain(*this, pNetworkRequest, it, itEnd));
+        return (*it)->intercept(*chain);
+    }
+}
+
 Response::Ptr HttpEngine::stripBody(Response::Ptr pResponse)
 {
     if (!pResponse) {
@@ -207,6 +307,15 @@ void HttpEngine::checkCacheBeforeSendRequest(Response::Ptr& pUserResponse, Reque
         return;
     }
 
+    if (m_pUserRequest->hasHeader(HttpConstants::HeaderNames::Range)) {
+        pUserResponse = createRangeResponseFromCache(pCacheInternal);
+        if (!pUserResponse) {
+            EASYHTTPCPP_LOG_D(Tag, "range request is not available from cache.");
+            pNetworkRequest = m_pUserRequest;
+        }
+        return;
+    }
+
     if (!HttpCacheStrategy::isAvailableToCache(m_pUserRequest)) {
         EASYHTTPCPP_LOG_D(Tag, "request is not available to cache.");
         pNetworkRequest = m_pUserRequest;
@@ -214,9 +323,15 @@ void HttpEngine::checkCacheBeforeSendRequest(Response::Ptr& pUserResponse, Reque
     }
 
     EASYHTTPCPP_LOG_D(Tag, "request is available to cache.");
-    HttpCacheStrategy::Ptr pCacheStrategy = pCacheInternal->createCacheStrategy(m_pUserRequest);
+    HttpCacheStrategy::Ptr pCacheStrategy = pCacheInternal->createCacheStrategy(m_pUserRequest,
+            getCacheKey(pCacheInternal));
+    if (pCacheStrategy->getNetworkRequest() && waitForFlight(pCacheInternal)) {
+        // the leader has stored the response in cache, if it was cacheable.
+        pCacheStrategy = pCacheInternal->createCacheStrategy(m_pUserRequest, getCacheKey(pCacheInternal));
+    }
     pNetworkRequest = pCacheStrategy->getNetworkRequest();
     m_pCacheResponse = pCacheStrategy->getCachedResponse();
+    m_pStaleIfErrorResponse = pCacheStrategy->getStaleIfErrorResponse();
 
     // when no networkRequest and no cacheResponse, return 504.
     if (!pNetworkRequest && !m_pCacheResponse) {
@@ -235,6 +350,101 @@ void HttpEngine::checkCacheBeforeSendRequest(Response::Ptr& pUserResponse, Reque
     if (!pNetworkRequest) {
         EASYHTTPCPP_LOG_D(Tag, "user response is cache response.");
         pUserResponse = createUserResponseFromCacheResponse(m_pCacheResponse, NULL);
+
+        Request::Ptr pRevalidationRequest = pCacheStrategy->getRevalidationRequest();
+        if (pRevalidationRequest) {
+            startRevalidation(pCacheInternal, pRevalidationRequest, m_pCacheResponse);
+        }
+    }
+}
+
+const std::string& HttpEngine::getCacheKey(HttpCacheInternal* pCacheInternal)
+{
+    if (m_cacheKey.empty()) {
+        m_cacheKey = pCacheInternal->makeCacheKey(m_pUserRequest);
+    }
+    return m_cacheKey;
+}
+
+bool HttpEngine::waitForFlight(HttpCacheInternal* pCacheInternal)
+{
+    if (!m_pContext->isRequestCoalescingEnabled()) {
+        return false;
+    }
+    const std::string& key = getCacheKey(pCacheInternal);
+    if (key.empty()) {
+        return false;
+    }
+    // single-flight; the first request of the key goes to the network and the others wait for its cache.
+    if (pCacheInternal->beginFlight(key)) {
+        EASYHTTPCPP_LOG_D(Tag, "waitForFlight: leader of the flight. [%s]", key.c_str());
+        m_flightKey = key;
+        return false;
+    }
+    EASYHTTPCPP_LOG_D(Tag, "waitForFlight: wait for the leader. [%s]", key.c_str());
+    if (!pCacheInternal->waitFlight(key, static_cast<long>(m_pContext->getRequestCoalescingTimeoutMillis()))) {
+        EASYHTTPCPP_LOG_D(Tag, "waitForFlight: the leader did not finish in time. [%s]", key.c_str());
+    }
+    return true;
+}
+
+void HttpEngine::prepareResponseBodyStreamWithCaching(Response::Ptr pResponse,
+        ResponseBodyStream::Ptr pResponseBodyStreamWithCaching)
+{
+    ResponseBodyStreamWithCaching* pStream =
+            static_cast<ResponseBodyStreamWithCaching*> (pResponseBodyStreamWithCaching.get());
+    pStream->setCacheKey(m_cacheKey);
+    if (m_pContext->getCacheFillPolicy() == CacheFillPolicyCompleteInBackground) {
+        pStream->setBackgroundCacheFill(m_pContext);
+    }
+    if (m_flightKey.empty()) {
+        return;
+    }
+    if (!isCoalescableResponse(pResponse)) {
+        // followers can not be served by this response; they go to the network without waiting for its body.
+        EASYHTTPCPP_LOG_D(Tag, "prepareResponseBodyStreamWithCaching: end the flight. [status code=%d]",
+                pResponse->getCode());
+        endFlight();
+        return;
+    }
+    pStream->setFlightKey(m_flightKey);
+    m_flightKey.clear();
+}
+
+void HttpEngine::endFlight()
+{
+    if (m_flightKey.empty()) {
+        return;
+    }
+    HttpCacheInternal* pCacheInternal = static_cast<HttpCacheInternal*> (m_pContext->getCache().get());
+    pCacheInternal->endFlight(m_flightKey);
+    m_flightKey.clear();
+}
+
+void HttpEngine::startRevalidation(HttpCacheInternal* pCacheInternal, Request::Ptr pRevalidationRequest,
+        Response::Ptr pCacheResponse)
+{
+    HttpExecutionTaskManager::Ptr pExecutionTaskManager = m_pContext->getHttpExecutionTaskManager();
+    const std::string& key = getCacheKey(pCacheInternal);
+    if (!pExecutionTaskManager || key.empty()) {
+        EASYHTTPCPP_LOG_D(Tag, "startRevalidation: can not revalidate in background.");
+        return;
+    }
+    // requests of the same stale response share one revalidation.
+    if (!pCacheInternal->beginRevalidation(key)) {
+        EASYHTTPCPP_LOG_D(Tag, "startRevalidation: already revalidating. [%s]", key.c_str());
+        return;
+    }
+
+    HttpCacheRevalidationTask::Ptr pRevalidationTask = new HttpCacheRevalidationTask(m_pContext,
+            pRevalidationRequest, pCacheResponse, key);
+    try {
+        pExecutionTaskManager->start(pRevalidationTask);
+        EASYHTTPCPP_LOG_D(Tag, "startRevalidation: started. [%s]", key.c_str());
+    } catch (const HttpException& e) {
+        // the stale response is still returned; only its revalidation is given up.
+        EASYHTTPCPP_LOG_D(Tag, "startRevalidation: can not start. [%s]", e.getMessage().c_str());
+        pCacheInternal->endRevalidation(key);
     }
 }
 
@@ -399,6 +609,11 @@ void HttpEngine::sendRequest(PocoHttpClientSessionPtr pPocoHttpClientSession, Re
                 pPocoHttpRequest->add(it->first, it->second);
             }
         }
+        // not added to the network request so that the cached request headers stay as the user made them.
+        if (isContentDecodingEnabled() && !pPocoHttpRequest->has(HttpConstants::HeaderNames::AcceptEncoding)) {
+            pPocoHttpRequest->set(HttpConstants::HeaderNames::AcceptEncoding,
+                    HttpInternalConstants::ContentEncodings::AcceptEncoding);
+        }
 
         // content-type, content-length
         RequestBody::Ptr pRequestBody = pNetworkRequest->getBody();
@@ -413,6 +628,14 @@ void HttpEngine::sendRequest(PocoHttpClientSessionPtr pPocoHttpClientSession, Re
                 pPocoHttpRequest->set(HttpConstants::HeaderNames::ContentLength,
                         StringUtil::format("%zu", pRequestBody->getContentLength()));
             }
+            // the encoded size is known only after writing.
+            std::string contentEncoding = pRequestBody->getContentEncoding();
+            if (!contentEncoding.empty()) {
+                pPocoHttpRequest->set(HttpConstants::HeaderNames::ContentEncoding, contentEncoding);
+                if (!pRequestBody->hasContentLength()) {
+                    pPocoHttpRequest->setChunkedTransferEncoding(true);
+                }
+            }
         }
 
         // dump request
@@ -476,25 +699,46 @@ Response::Ptr HttpEngine::receiveResponse(PocoHttpClientSessionPtr pPocoHttpClie
             m_pConnectionPoolInternal->removeConnection(m_pConnectionInternal);
         }
 
+        // decompress before the cache when the cache stores decompressed bodies.
+        Poco::SharedPtr<std::istream> pDecodingStream;
+        if (m_pContext->getContentEncodingPolicy() == ContentEncodingPolicyCacheDecompressed &&
+                isContentDecodingEnabled() && pNetworkRequest->getMethod() != Request::HttpMethodHead &&
+                pPocoHttpResponse->getStatus() == Poco::Net::HTTPResponse::HTTP_OK) {
+            const std::string& contentEncoding = pPocoHttpResponse->get(HttpConstants::HeaderNames::ContentEncoding,
+                    "");
+            if (HttpUtil::isDecodableContentEncoding(contentEncoding)) {
+                EASYHTTPCPP_LOG_D(Tag, "receiveResponse: decompress response body. [%s]", contentEncoding.c_str());
+                pDecodingStream = HttpUtil::createDecodingInputStream(receivingStream, contentEncoding);
+            }
+        }
+        bool hasContentLength = pPocoHttpResponse->hasContentLength() && !pDecodingStream;
+        ssize_t contentLength = hasContentLength ? pPocoHttpResponse->getContentLength() : -1;
+
         // create networkResponse
-        ResponseBodyStream::Ptr pResponseBodyStream = new ResponseBodyStreamWithoutCaching(receivingStream,
-                m_pConnectionInternal, m_pConnectionPoolInternal);
+        ResponseBodyStream::Ptr pResponseBodyStream = new ResponseBodyStreamWithoutCaching(
+                pDecodingStream ? *pDecodingStream : receivingStream, m_pConnectionInternal,
+                m_pConnectionPoolInternal, pDecodingStream);
         MediaType::Ptr pMediaType(new MediaType(pPocoHttpResponse->get(HttpConstants::HeaderNames::ContentType,
                 DEFAULT_CONTENT_TYPE)));
-        ResponseBody::Ptr pResponseBody = ResponseBody::create(pMediaType, pPocoHttpResponse->hasContentLength(),
-                pPocoHttpResponse->getContentLength(), pResponseBodyStream);
+        ResponseBody::Ptr pResponseBody = ResponseBody::create(pMediaType, hasContentLength, contentLength,
+                pResponseBodyStream);
+        pResponseBody->setExecutionTaskManager(m_pContext->getHttpExecutionTaskManager());
 
         Response::Builder responseBuilder;
         responseBuilder.setRequest(pNetworkRequest).setCode(pPocoHttpResponse->getStatus())
                 .setMessage(pPocoHttpResponse->getReason())
-                .setHasContentLength(pPocoHttpResponse->hasContentLength())
-                .setContentLength(pPocoHttpResponse->getContentLength())
+                .setHasContentLength(hasContentLength)
+                .setContentLength(contentLength)
                 .setSentRequestSec(sentRequestTime.epochTime())
                 .setReceivedResponseSec(receivedResponseTime.epochTime())
                 .setBody(pResponseBody);
         Headers::Ptr pHeaders = new Headers();
         for (Poco::Net::NameValueCollection::ConstIterator it = pPocoHttpResponse->begin();
                 it != pPocoHttpResponse->end(); it++) {
+            if (pDecodingStream && (Poco::icompare(it->first, HttpConstants::HeaderNames::ContentEncoding) == 0 ||
+                    Poco::icompare(it->first, HttpConstants::HeaderNames::ContentLength) == 0)) {
+                continue;
+            }
             pHeaders->add(it->first, it->second);
         }
         responseBuilder.setHeaders(pHeaders).setCacheControl(CacheControl::createFromHeaders(pHeaders));
@@ -634,15 +878,275 @@ ResponseBody::Ptr HttpEngine::createResponseBodyFromCache(Response::Ptr pCacheRe
         throw HttpExecutionException(message);
     }
 
-    std::istream* pStream = pCacheInternal->createInputStreamFromCache(pCacheResponse->getRequest());
+    const std::string& key = getCacheKey(pCacheInternal);
+    unsigned int cacheIndex = 0;
+    std::istream* pStream = pCacheInternal->createInputStreamFromCache(m_pUserRequest, key, cacheIndex);
     if (pStream == NULL) {
         EASYHTTPCPP_LOG_D(Tag, "createResponseBodyFromCache: can not create stream from cache.");
         throw HttpExecutionException("Can not create response body from cache. Maybe cache is broken.");
     }
     MediaType::Ptr pMediaType(new MediaType(pCacheResponse->getHeaderValue(
             HttpConstants::HeaderNames::ContentType, DEFAULT_CONTENT_TYPE)));
-    return ResponseBody::create(pMediaType, pCacheResponse->hasContentLength(), pCacheResponse->getContentLength(),
-            new ResponseBodyStreamFromCache(pStream, pCacheResponse, m_pContext->getCache()));
+    ResponseBody::Ptr pResponseBody = ResponseBody::create(pMediaType, pCacheResponse->hasContentLength(),
+            pCacheResponse->getContentLength(),
+            new ResponseBodyStreamFromCache(pStream, pCacheResponse, m_pContext->getCache(), key, cacheIndex));
+    pResponseBody->setExecutionTaskManager(m_pContext->getHttpExecutionTaskManager());
+    return pResponseBody;
+}
+
+Response::Ptr HttpEngine::createRangeResponseFromCache(HttpCacheInternal* pCacheInternal)
+{
+    if (m_pUserRequest->getMethod() != Request::HttpMethodGet) {
+        return NULL;
+    }
+
+    // look up the cache with the request without Range and If-Range.
+    Headers::Ptr pHeaders = new Headers();
+    Headers::Ptr pUserHeaders = m_pUserRequest->getHeaders();
+    for (Headers::HeaderMap::ConstIterator it = pUserHeaders->begin(); it != pUserHeaders->end(); it++) {
+        if (Poco::icompare(it->first, HttpConstants::HeaderNames::Range) != 0 &&
+                Poco::icompare(it->first, HttpConstants::HeaderNames::IfRange) != 0) {
+            pHeaders->add(it->first, it->second);
+        }
+    }
+    Request::Builder requestBuilder(m_pUserRequest);
+    Request::Ptr pRequest = requestBuilder.setHeaders(pHeaders).build();
+    if (!HttpCacheStrategy::isAvailableToCache(pRequest)) {
+        return NULL;
+    }
+
+    // only a fresh and complete cache response is sliced; otherwise the range is requested from network.
+    const std::string& key = getCacheKey(pCacheInternal);
+    HttpCacheStrategy::Ptr pCacheStrategy = pCacheInternal->createCacheStrategy(pRequest, key);
+    Response::Ptr pCacheResponse = pCacheStrategy->getCachedResponse();
+    if (pCacheStrategy->getNetworkRequest() || !pCacheResponse ||
+            pCacheResponse->getCode() != Poco::Net::HTTPResponse::HTTP_OK || !pCacheResponse->hasContentLength() ||
+            pCacheResponse->getContentLength() <= 0) {
+        return NULL;
+    }
+    // a range of an encoded body can not be decoded, so it is given only to a request which accepts the encoding.
+    if (!m_pUserRequest->hasHeader(HttpConstants::HeaderNames::AcceptEncoding) &&
+            pCacheResponse->hasHeader(HttpConstants::HeaderNames::ContentEncoding)) {
+        EASYHTTPCPP_LOG_D(Tag, "createRangeResponseFromCache: cached response body is encoded.");
+        return NULL;
+    }
+    Poco::UInt64 completeLength = static_cast<Poco::UInt64>(pCacheResponse->getContentLength());
+    const std::string& ifRange = m_pUserRequest->getHeaderValue(HttpConstants::HeaderNames::IfRange, "");
+    if (!ifRange.empty() && ifRange != HttpUtil::getRangeValidator(pCacheResponse->getHeaders())) {
+        return NULL;
+    }
+    Poco::UInt64 firstBytePos = 0;
+    Poco::UInt64 lastBytePos = 0;
+    if (!HttpUtil::tryParseRange(m_pUserRequest->getHeaderValue(HttpConstants::HeaderNames::Range, ""),
+            completeLength, firstBytePos, lastBytePos)) {
+        return NULL;
+    }
+
+    unsigned int cacheIndex = 0;
+    std::istream* pStream = pCacheInternal->createInputStreamFromCache(pRequest, key, cacheIndex);
+    if (pStream == NULL) {
+        return NULL;
+    }
+    Poco::UInt64 length = lastBytePos - firstBytePos + 1;
+    ResponseBodyStream::Ptr pResponseBodyStream = new ResponseBodyStreamFromCache(
+            new ByteRangeInputStream(pStream, length), pCacheResponse, m_pContext->getCache(), key, cacheIndex);
+    pStream->seekg(static_cast<std::streamoff>(firstBytePos));
+    if (pStream->fail()) {
+        // a compressed cached response body is not seekable, so it is decompressed up to the first byte.
+        pStream->clear();
+        pStream->ignore(static_cast<std::streamsize>(firstBytePos));
+        if (static_cast<Poco::UInt64>(pStream->gcount()) != firstBytePos) {
+            pStream->setstate(std::ios::failbit);
+        }
+    }
+    if (pStream->fail()) {
+        EASYHTTPCPP_LOG_D(Tag, "createRangeResponseFromCache: can not seek cached response body.");
+        pResponseBodyStream->close();
+        return NULL;
+    }
+    EASYHTTPCPP_LOG_D(Tag, "createRangeResponseFromCache: bytes %llu-%llu/%llu from cache.", firstBytePos,
+            lastBytePos, completeLength);
+
+    Headers::Ptr pResponseHeaders = new Headers(*pCacheResponse->getHeaders());
+    pResponseHeaders->set(HttpConstants::HeaderNames::ContentRange,
+            HttpUtil::makeContentRange(firstBytePos, lastBytePos, completeLength));
+    pResponseHeaders->set(HttpConstants::HeaderNames::ContentLength, Poco::NumberFormatter::format(length));
+    MediaType::Ptr pMediaType(new MediaType(pCacheResponse->getHeaderValue(
+            HttpConstants::HeaderNames::ContentType, DEFAULT_CONTENT_TYPE)));
+    ResponseBody::Ptr pResponseBody = ResponseBody::create(pMediaType, true, static_cast<ssize_t>(length),
+            pResponseBodyStream);
+    pResponseBody->setExecutionTaskManager(m_pContext->getHttpExecutionTaskManager());
+
+    // a stale response within stale-while-revalidate is sliced as well, and revalidated in background.
+    Request::Ptr pRevalidationRequest = pCacheStrategy->getRevalidationRequest();
+    if (pRevalidationRequest) {
+        startRevalidation(pCacheInternal, pRevalidationRequest, pCacheResponse);
+    }
+
+    Response::Builder builder(pCacheResponse);
+    return builder.setRequest(m_pUserRequest).setCode(Poco::Net::HTTPResponse::HTTP_PARTIAL_CONTENT)
+            .setMessage(Poco::Net::HTTPResponse::HTTP_REASON_PARTIAL_CONTENT).setHeaders(pResponseHeaders)
+            .setHasContentLength(true).setContentLength(static_cast<ssize_t>(length))
+            .setPriorResponse(stripBody(m_pPriorResponse)).setCacheResponse(stripBody(pCacheResponse))
+            .setBody(pResponseBody).build();
+}
+
+Request::Ptr HttpEngine::createResumeRequest(Request::Ptr pNetworkRequest)
+{
+    HttpCacheInternal* pCacheInternal = static_cast<HttpCacheInternal*> (m_pContext->getCache().get());
+    if (pCacheInternal == NULL || m_pCacheResponse || !HttpCacheStrategy::isAvailableToCache(m_pUserRequest)) {
+        return NULL;
+    }
+    HttpPartialContent::Ptr pPartialContent = pCacheInternal->getPartialContent(m_pUserRequest,
+            getCacheKey(pCacheInternal));
+    if (!pPartialContent) {
+        return NULL;
+    }
+    EASYHTTPCPP_LOG_D(Tag, "createResumeRequest: resume from %llu/%llu bytes.", pPartialContent->getStoredBytes(),
+            pPartialContent->getCompleteLength());
+
+    // Request::Builder shares the headers of the original request; copy them before adding the range.
+    Headers::Ptr pHeaders = pNetworkRequest->getHeaders() ? new Headers(*pNetworkRequest->getHeaders()) :
+            new Headers();
+    pHeaders->set(HttpConstants::HeaderNames::Range, std::string(HttpConstants::HeaderValues::Bytes) + "=" +
+            Poco::NumberFormatter::format(pPartialContent->getStoredBytes()) + "-");
+    pHeaders->set(HttpConstants::HeaderNames::IfRange, pPartialContent->getValidator());
+    m_pPartialContent = pPartialContent;
+
+    Request::Builder requestBuilder(pNetworkRequest);
+    return requestBuilder.setHeaders(pHeaders).build();
+}
+
+Response::Ptr HttpEngine::createUserResponseWithResuming(Response::Ptr pNetworkResponse)
+{
+    HttpPartialContent::Ptr pPartialContent = m_pPartialContent;
+    m_pPartialContent = NULL;
+    HttpCacheInternal* pCacheInternal = static_cast<HttpCacheInternal*> (m_pContext->getCache().get());
+
+    // the partial content is stale unless the response continues it exactly.
+    Poco::UInt64 firstBytePos = 0;
+    Poco::UInt64 lastBytePos = 0;
+    Poco::UInt64 completeLength = 0;
+    if (pNetworkResponse->getCode() != Poco::Net::HTTPResponse::HTTP_PARTIAL_CONTENT ||
+            !HttpUtil::tryParseContentRange(pNetworkResponse->getHeaderValue(
+            HttpConstants::HeaderNames::ContentRange, ""), firstBytePos, lastBytePos, completeLength) ||
+            firstBytePos != pPartialContent->getStoredBytes() || lastBytePos + 1 != completeLength ||
+            completeLength != pPartialContent->getCompleteLength() ||
+            HttpUtil::getRangeValidator(pNetworkResponse->getHeaders()) != pPartialContent->getValidator()) {
+        EASYHTTPCPP_LOG_D(Tag, "createUserResponseWithResuming: partial content is stale.");
+        pCacheInternal->removePartialContent(m_pUserRequest);
+        return NULL;
+    }
+
+    std::string prefixFilePath;
+    Poco::FileInputStream* pPrefixStream = NULL;
+    try {
+        prefixFilePath = Poco::TemporaryFile::tempName(pCacheInternal->getTempDirectory());
+        if (!pCacheInternal->takePartialContent(pPartialContent, prefixFilePath)) {
+            return NULL;
+        }
+        pPrefixStream = new Poco::FileInputStream(prefixFilePath, std::ios_base::in | std::ios_base::binary);
+    } catch (const HttpException& e) {
+        EASYHTTPCPP_LOG_D(Tag, "createUserResponseWithResuming: can not take partial content. HttpException=%s",
+                e.getMessage().c_str());
+        return NULL;
+    } catch (const Poco::Exception& e) {
+        EASYHTTPCPP_LOG_D(Tag, "createUserResponseWithResuming: can not open partial content. Poco::Exception=%s",
+                e.message().c_str());
+        FileUtil::removeFileIfPresent(Poco::File(prefixFilePath));
+        return NULL;
+    }
+
+    // the user receives the whole body as 200; the network response stays available as is.
+    Headers::Ptr pHeaders = new Headers();
+    Headers::Ptr pNetworkHeaders = pNetworkResponse->getHeaders();
+    for (Headers::HeaderMap::ConstIterator it = pNetworkHeaders->begin(); it != pNetworkHeaders->end(); it++) {
+        if (Poco::icompare(it->first, HttpConstants::HeaderNames::ContentRange) != 0) {
+            pHeaders->add(it->first, it->second);
+        }
+    }
+    pHeaders->set(HttpConstants::HeaderNames::ContentLength, Poco::NumberFormatter::format(completeLength));
+
+    Response::Ptr pStrippedNetworkResponse = stripBody(pNetworkResponse);
+    Response::Builder responseBuilder(pStrippedNetworkResponse);
+    Response::Ptr pStitchedResponse = responseBuilder.setRequest(m_pUserRequest)
+            .setCode(Poco::Net::HTTPResponse::HTTP_OK).setMessage(Poco::Net::HTTPResponse::HTTP_REASON_OK)
+            .setHeaders(pHeaders).setCacheControl(CacheControl::createFromHeaders(pHeaders))
+            .setHasContentLength(true).setContentLength(static_cast<ssize_t>(completeLength)).build();
+
+    // exchange ResponseBodyStreamWithoutCaching to ResponseBodyStreamWithCaching which reads the prefix first.
+    ResponseBody::Ptr pResponseBody = pNetworkResponse->getBody();
+    ResponseBodyStreamWithoutCaching* pResponseBodyStream =
+            static_cast<ResponseBodyStreamWithoutCaching*> (pResponseBody->getByteStream().get());
+    ResponseBodyStream::Ptr pNewResponseBodyStream = pResponseBodyStream->exchangeToResponseBodyStreamWithCaching(
+            pStitchedResponse, m_pContext->getCache());
+    static_cast<ResponseBodyStreamWithCaching*> (pNewResponseBodyStream.get())->setPrefix(pPrefixStream,
+            prefixFilePath, pPartialContent->getStoredBytes());
+    prepareResponseBodyStreamWithCaching(pStitchedResponse, pNewResponseBodyStream);
+    ResponseBody::Ptr pNewResponseBody = ResponseBody::create(pResponseBody->getMediaType(), true,
+            static_cast<ssize_t>(completeLength), pNewResponseBodyStream);
+    pNewResponseBody->setExecutionTaskManager(m_pContext->getHttpExecutionTaskManager());
+
+    Response::Builder userResponseBuilder(pStitchedResponse);
+    return userResponseBuilder.setBody(pNewResponseBody).setNetworkResponse(pStrippedNetworkResponse)
+            .setPriorResponse(stripBody(m_pPriorResponse)).build();
+}
+
+bool HttpEngine::isContentDecodingEnabled()
+{
+    // the user handles the body as received when asking for an encoding or a range by itself.
+    return m_pContext->getContentEncodingPolicy() != ContentEncodingPolicyIdentity &&
+            !m_pUserRequest->hasHeader(HttpConstants::HeaderNames::AcceptEncoding) &&
+            !m_pUserRequest->hasHeader(HttpConstants::HeaderNames::Range);
+}
+
+bool HttpEngine::isDecodableResponse(Response::Ptr pResponse)
+{
+    if (!pResponse || !pResponse->getBody() || pResponse->getCode() != Poco::Net::HTTPResponse::HTTP_OK ||
+            pResponse->getRequest()->getMethod() == Request::HttpMethodHead) {
+        return false;
+    }
+    return HttpUtil::isDecodableContentEncoding(pResponse->getHeaderValue(
+            HttpConstants::HeaderNames::ContentEncoding, ""));
+}
+
+bool HttpEngine::isCachedBodyDecodingRequired(Response::Ptr pUserResponse)
+{
+    // a cached body may have been stored encoded by a client with another ContentEncodingPolicy. a request without
+    // Accept-Encoding shares its cache, so the body is decoded for it even when decoding is disabled.
+    return pUserResponse->getCacheResponse() &&
+            !m_pUserRequest->hasHeader(HttpConstants::HeaderNames::AcceptEncoding) &&
+            !m_pUserRequest->hasHeader(HttpConstants::HeaderNames::Range);
+}
+
+Response::Ptr HttpEngine::createUserResponseWithDecoding(Response::Ptr pUserResponse)
+{
+    // bodies decompressed before the cache have no Content-Encoding any more.
+    if (!isDecodableResponse(pUserResponse) ||
+            !(isContentDecodingEnabled() || isCachedBodyDecodingRequired(pUserResponse))) {
+        return pUserResponse;
+    }
+    const std::string contentEncoding = pUserResponse->getHeaderValue(HttpConstants::HeaderNames::ContentEncoding,
+            "");
+    EASYHTTPCPP_LOG_D(Tag, "createUserResponseWithDecoding: decompress response body. [%s]",
+            contentEncoding.c_str());
+
+    Headers::Ptr pHeaders = new Headers();
+    Headers::Ptr pUserHeaders = pUserResponse->getHeaders();
+    for (Headers::HeaderMap::ConstIterator it = pUserHeaders->begin(); it != pUserHeaders->end(); it++) {
+        if (Poco::icompare(it->first, HttpConstants::HeaderNames::ContentEncoding) != 0 &&
+                Poco::icompare(it->first, HttpConstants::HeaderNames::ContentLength) != 0) {
+            pHeaders->add(it->first, it->second);
+        }
+    }
+    ResponseBody::Ptr pResponseBody = pUserResponse->getBody();
+    ResponseBody::Ptr pDecodedResponseBody = ResponseBody::create(pResponseBody->getMediaType(), false, -1,
+            new ResponseBodyStreamWithDecoding(pResponseBody->getByteStream(), contentEncoding));
+    pDecodedResponseBody->setExecutionTaskManager(m_pContext->getHttpExecutionTaskManager());
+
+    Response::Builder builder(pUserResponse);
+    return builder.setHeaders(pHeaders).setHasContentLength(false).setContentLength(-1)
+            .setBody(pDecodedResponseBody).build();
 }
 
 Response::Ptr HttpEngine::createUserResponseFromCacheResponse(Response::Ptr pCacheResponse,
@@ -685,8 +1189,10 @@ Response::Ptr HttpEngine::createUserResponseWithCaching(Response::Ptr pNetworkRe
     // exchange ResponseBodyStreamWithoutCaching to ResponseBodyStreamWithCaching
     ResponseBodyStream::Ptr pNewResponseBodyStream = pResponseBodyStream->exchangeToResponseBodyStreamWithCaching(
             pStrippedNetworkResponse, m_pContext->getCache());
+    prepareResponseBodyStreamWithCaching(pStrippedNetworkResponse, pNewResponseBodyStream);
     ResponseBody::Ptr pNewResponseBody = ResponseBody::create(pResponseBody->getMediaType(),
             pResponseBody->hasContentLength(), pResponseBody->getContentLength(), pNewResponseBodyStream);
+    pNewResponseBody->setExecutionTaskManager(m_pContext->getHttpExecutionTaskManager());
 
     // create UserResponse from NetworkResponse with ResponseBodyStreamWithCaching
     Response::Builder responseBuilder(pStrippedNetworkResponse);
@@ -708,14 +1214,13 @@ void HttpEngine::updateCache(Response::Ptr pCacheResponse, Response::Ptr pNetwor
         Headers::Ptr pCombinedHeaders)
 {
     CacheMetadata::Ptr pCacheMetadata;
-    Request::Ptr pRequest = pCacheResponse->getRequest();
-    std::string key = HttpUtil::makeCacheKey(pRequest);
+    HttpCache::Ptr pHttpCache = m_pContext->getCache();
+    HttpCacheInternal* pCacheInternal = static_cast<HttpCacheInternal*> (pHttpCache.get());
+    const std::string& key = getCacheKey(pCacheInternal);
     if (key.empty()) {
         EASYHTTPCPP_LOG_D(Tag, "updateCache: can not make key.");
         return;
     }
-    HttpCache::Ptr pHttpCache = m_pContext->getCache();
-    HttpCacheInternal* pCacheInternal = static_cast<HttpCacheInternal*> (pHttpCache.get());
     CacheManager::Ptr pCacheManager = pCacheInternal->getCacheManager();
     if (!pCacheManager->getMetadata(key, pCacheMetadata)) {
         EASYHTTPCPP_LOG_D(Tag, "updateCache: can not get cache[%s].", key.c_str());
@@ -723,6 +1228,10 @@ void HttpEngine::updateCache(Response::Ptr pCacheResponse, Response::Ptr pNetwor
     }
 
     HttpCacheMetadata* pHttpCacheMetadata = static_cast<HttpCacheMetadata*> (pCacheMetadata.get());
+    if (!pHttpCacheMetadata->isCacheOf(m_pUserRequest->getMethod(), m_pUserRequest->getUrl())) {
+        EASYHTTPCPP_LOG_D(Tag, "updateCache: cache of another request has the same key. [%s]", key.c_str());
+        return;
+    }
     pHttpCacheMetadata->setResponseHeaders(pCombinedHeaders);
     pHttpCacheMetadata->setSentRequestAtEpoch(pNetworkResponse->getSentRequestSec());
     pHttpCacheMetadata->setReceivedResponseAtEpoch(pNetworkResponse->getReceivedResponseSec());
@@ -734,6 +1243,39 @@ void HttpEngine::updateCache(Response::Ptr pCacheResponse, Response::Ptr pNetwor
     }
 }
 
+bool HttpEngine::isStaleIfErrorStatusCode(Response::Ptr pResponse)
+{
+    // RFC 5861 4. an error is any situation that would result in a 500, 502, 503, or 504 HTTP response status code.
+    switch (pResponse->getCode()) {
+        case Poco::Net::HTTPResponse::HTTP_INTERNAL_SERVER_ERROR:
+        case Poco::Net::HTTPResponse::HTTP_BAD_GATEWAY:
+        case Poco::Net::HTTPResponse::HTTP_SERVICE_UNAVAILABLE:
+        case Poco::Net::HTTPResponse::HTTP_GATEWAY_TIMEOUT:
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool HttpEngine::isCoalescableResponse(Response::Ptr pResponse)
+{
+    // only a successful response which is stored in cache serves the followers of its flight.
+    if (pResponse->getCode() < Poco::Net::HTTPResponse::HTTP_OK ||
+            pResponse->getCode() >= Poco::Net::HTTPResponse::HTTP_MULTIPLE_CHOICES) {
+        return false;
+    }
+    CacheControl::Ptr pCacheControl = pResponse->getCacheControl();
+    return !(pCacheControl && pCacheControl->isNoStore());
+}
+
+void HttpEngine::closeResponseBody(Response::Ptr pResponse)
+{
+    ResponseBody::Ptr pResponseBody = pResponse->getBody();
+    if (pResponseBody) {
+        pResponseBody->close();
+    }
+}
+
 bool HttpEngine::isRetryStatusCode(Response::Ptr pResponse)
 {
     switch (pResponse->getCode()) {
@@ -23,10 +23,13 @@
 #include "ConnectionPoolInternal.h"
 #include "ConnectionStatusListener.h"
 #include "EasyHttpContext.h"
+#include "HttpPartialContent.h"
 #include "HttpTypedefs.h"
 
 namespace easyhttpcpp {
 
+class HttpCacheInternal;
+
 class EASYHTTPCPP_HTTP_INTERNAL_API HttpEngine : public ConnectionStatusListener, public Poco::RefCountedObject {
 public:
     typedef Poco::AutoPtr<HttpEngine> Ptr;
@@ -34,6 +37,10 @@ public:
     HttpEngine(EasyHttpContext::Ptr pContext, Request::Ptr pRequest, Response::Ptr pPriorResponse);
     virtual ~HttpEngine();
     virtual Response::Ptr execute();
+    /**
+     * Sends the revalidation request of a stale cached response and updates the cache by the response.
+     */
+    void revalidate(Request::Ptr pRevalidationRequest, Response::Ptr pCacheResponse);
     Response::Ptr sendRequestAndReceiveResponseWithRetryByConnection(Request::Ptr pNetworkRequest);
     bool cancel();
     Connection::Ptr getConnection();
@@ -52,7 +59,16 @@ private:
     static Response::Ptr stripBody(Response::Ptr pResponse);
     static bool isRetryStatusCode(Response::Ptr pResponse);
     static Request::Ptr makeRetryRequest(Response::Ptr pResponse);
-
+    static bool isDecodableResponse(Response::Ptr pResponse);
+    static bool isStaleIfErrorStatusCode(Response::Ptr pResponse);
+    static bool isCoalescableResponse(Response::Ptr pResponse);
+    static void closeResponseBody(Response::Ptr pResponse);
+
+    Response::Ptr executeInternal();
+    bool isContentDecodingEnabled();
+    bool isCachedBodyDecodingRequired(Response::Ptr pUserResponse);
+    Response::Ptr createUserResponseWithDecoding(Response::Ptr pUserResponse);
+    Response::Ptr sendNetworkRequest(Request::Ptr pNetworkRequest);
     Response::Ptr sendRequestAndReceiveResponse(Request::Ptr pNetworkRequest, bool forceToCreateConnection,
             bool& connectionReused);
     void sendRequest(PocoHttpClientSessionPtr pPocoHttpClientSession, Request::Ptr pNetworkRequest,
@@ -61,7 +77,21 @@ private:
             const Poco::URI& uri, Poco::Timestamp& sentRequestTime);
 
     void checkCacheBeforeSendRequest(Response::Ptr& pUserResponse, Request::Ptr& pNetworkRequest);
+    // requests of the call have the method and url of the user request, so they share its cache key.
+    const std::string& getCacheKey(HttpCacheInternal* pCacheInternal);
+    void startRevalidation(HttpCacheInternal* pCacheInternal, Request::Ptr pRevalidationRequest,
+            Response::Ptr pCacheResponse);
+    // request coalescing; returns true if this request waited for the leader of the same key.
+    bool waitForFlight(HttpCacheInternal* pCacheInternal);
+    // hands the flight and the cache fill policy over to the stream which stores pResponse in cache.
+    void prepareResponseBodyStreamWithCaching(Response::Ptr pResponse,
+            ResponseBodyStream::Ptr pResponseBodyStreamWithCaching);
+    void endFlight();
+    Response::Ptr sendNetworkRequestWithStaleIfError(Request::Ptr pNetworkRequest);
     ResponseBody::Ptr createResponseBodyFromCache(Response::Ptr pCacheResponse);
+    Response::Ptr createRangeResponseFromCache(HttpCacheInternal* pCacheInternal);
+    Request::Ptr createResumeRequest(Request::Ptr pNetworkRequest);
+    Response::Ptr createUserResponseWithResuming(Response::Ptr pNetworkResponse);
     Response::Ptr createUserResponseFromCacheResponse(Response::Ptr pCacheResponse, Response::Ptr pNetworkResponse);
     Response::Ptr createUserResponseFromNetworkResponse(Response::Ptr pNetworkResponse);
     Response::Ptr createUserResponseWithCaching(Response::Ptr pNetworkResponse);
@@ -72,6 +102,12 @@ private:
     Request::Ptr m_pUserRequest;
     Response::Ptr m_pPriorResponse;
     Response::Ptr m_pCacheResponse;
+    Response::Ptr m_pStaleIfErrorResponse;
+    // cache key of the user request, made once for the call.
+    std::string m_cacheKey;
+    // key of the flight which this engine leads, until it is handed over to the response body.
+    std::string m_flightKey;
+    HttpPartialContent::Ptr m_pPartialContent;
 
     ConnectionInternal::Ptr m_pConnectionInternal;
     bool m_cancelled;
@@ -2,22 +2,29 @@
  * Copyright 2017 Sony Corporation
  */
 
+#include <algorithm>
 #include <fstream>
+#include <vector>
 
 #include "Poco/Exception.h"
 #include "Poco/File.h"
 #include "Poco/FileStream.h"
+#include "Poco/ScopedUnlock.h"
 #include "Poco/Timestamp.h"
 
 #include "easyhttpcpp/common/CoreLogger.h"
 #include "easyhttpcpp/common/FileUtil.h"
+#include "easyhttpcpp/common/MappedFile.h"
+#include "easyhttpcpp/common/MappedFileInputStream.h"
 #include "easyhttpcpp/HttpException.h"
 
+#include "ByteArrayBufferInputStream.h"
 #include "HttpCacheInfo.h"
 #include "HttpCacheMetadata.h"
 #include "HttpFileCache.h"
 #include "HttpInternalConstants.h"
 #include "HttpLruCacheStrategy.h"
+#include "HttpTinyLfuCacheStrategy.h"
 #include "HttpUtil.h"
 
 using easyhttpcpp::common::ByteArrayBuffer;
@@ -26,62 +33,125 @@ using easyhttpcpp::common::CacheMetadata;
 using easyhttpcpp::common::CacheInfoWithDataSize;
 using easyhttpcpp::common::CacheStrategy;
 using easyhttpcpp::common::FileUtil;
+using easyhttpcpp::common::MappedFile;
+using easyhttpcpp::common::MappedFileInputStream;
+using easyhttpcpp::common::StripedMutex;
 using easyhttpcpp::db::SqlDatabaseCorruptException;
 using easyhttpcpp::db::SqlException;
+using easyhttpcpp::db::SqlExecutionException;
 
 namespace easyhttpcpp {
 
 static const std::string Tag = "HttpFileCache";
 
-HttpFileCache::HttpFileCache(const Poco::Path& cacheRootDir, size_t maxSize) : m_cacheInitialized(false),
-        m_cacheRootDir(cacheRootDir.absolute()), m_maxSize(maxSize)
+namespace {
+
+bool isAccessedEarlier(const HttpCacheEnumerationListener::EnumerationParam& left,
+        const HttpCacheEnumerationListener::EnumerationParam& right)
+{
+    if (left.m_lastAccessedAtEpoch != right.m_lastAccessedAtEpoch) {
+        return left.m_lastAccessedAtEpoch < right.m_lastAccessedAtEpoch;
+    }
+    return left.m_id < right.m_id;
+}
+
+bool isDataDir(const Poco::File& file)
+{
+    // the temporary and partial content directories have longer names.
+    return Poco::Path(file.path()).getFileName().size() == HttpInternalConstants::Caches::DataDirNameLength &&
+            file.isDirectory();
+}
+
+// lists response body files in dir and its data directories. files of an old layout are listed too.
+void listCachedFiles(const Poco::File& dir, std::vector<Poco::File>& cachedFiles)
+{
+    std::vector<Poco::File> files;
+    dir.list(files);
+    for (size_t i = 0; i < files.size(); i++) {
+        if (isDataDir(files[i])) {
+            listCachedFiles(files[i], cachedFiles);
+        } else if (Poco::Path(files[i].path()).getExtension() ==
+                std::string(HttpInternalConstants::Caches::DataFileExtention).substr(1)) {
+            cachedFiles.push_back(files[i]);
+        }
+    }
+}
+
+} /* namespace */
+
+HttpFileCache::HttpFileCache(const Poco::Path& cacheRootDir, size_t maxSize, HttpCacheKeyHasher::Ptr pKeyHasher,
+        unsigned int dataDirFanOutLevels, size_t inlineBodyMaxSize, HttpCache::EvictionPolicy evictionPolicy) :
+        m_cacheInitialized(false), m_cacheRootDir(cacheRootDir.absolute()), m_maxSize(maxSize),
+        m_dataDirFanOutLevels(dataDirFanOutLevels), m_inlineBodyMaxSize(inlineBodyMaxSize),
+        m_evictionPolicy(evictionPolicy),
+        m_indexLoaderRunnable(*this, &HttpFileCache::loadIndex), m_indexLoaded(false), m_indexLoaderRunning(false),
+        m_indexLoaderStopRequested(false), m_indexGeneration(0)
 {
     Poco::Path databasePath = m_cacheRootDir;
     databasePath.append(Poco::Path(HttpInternalConstants::Database::FileName));
-    m_pMetadataDb = new HttpCacheDatabase(new HttpCacheDatabaseOpenHelper(databasePath));
-    m_lruCacheStrategy = new HttpLruCacheStrategy(m_maxSize);
+    m_pMetadataDb = new HttpCacheDatabase(new HttpCacheDatabaseOpenHelper(databasePath, pKeyHasher,
+            dataDirFanOutLevels));
+    m_lruCacheStrategy = createLruCacheStrategy();
     m_lruCacheStrategy->setListener(this);
 }
 
 HttpFileCache::~HttpFileCache()
 {
+    {
+        Poco::FastMutex::ScopedLock lock(m_instanceMutex);
+        m_indexLoaderStopRequested = true;
+    }
+    m_indexLoaderThread.join();
+
+    try {
+        flushLastAccessedSec();
+    } catch (const SqlException& e) {
+        EASYHTTPCPP_LOG_D(Tag, "~HttpFileCache : can not write last accessed sec. Details: %s",
+                e.getMessage().c_str());
+    }
     m_pMetadataDb->closeSqliteSession();
 }
 
 bool HttpFileCache::getMetadata(const std::string& key, CacheMetadata::Ptr& pCacheMetadata)
 {
-    Poco::FastMutex::ScopedLock lock(m_instanceMutex);
+    Poco::FastMutex::ScopedLock keyLock(m_keyMutexes.get(key));
 
     try {
-        initializeCache();
+        {
+            Poco::FastMutex::ScopedLock lock(m_instanceMutex);
 
-        EASYHTTPCPP_LOG_D(Tag, "getMetadata key=%s", key.c_str());
-        CacheInfoWithDataSize::Ptr pCacheInfo = m_lruCacheStrategy->get(key);
-        if (!pCacheInfo) {
-            EASYHTTPCPP_LOG_D(Tag, "getMetadata : [%s] not found in cache.", key.c_str());
-            return false;
-        }
+            initializeCache();
 
-        HttpCacheInfo* pHttpCacheInfo = static_cast<HttpCacheInfo*> (pCacheInfo.get());
-        if (pHttpCacheInfo->isReservedRemove()) {
-            EASYHTTPCPP_LOG_D(Tag, "getMetadata : [%s] is reserving delete.", key.c_str());
-            return false;
+            EASYHTTPCPP_LOG_D(Tag, "getMetadata key=%s", key.c_str());
+            const HttpCacheInfo* pHttpCacheInfo = getCacheInfo(key);
+            if (pHttpCacheInfo == NULL) {
+                EASYHTTPCPP_LOG_D(Tag, "getMetadata : [%s] not found in cache.", key.c_str());
+                return false;
+            }
+
+            if (pHttpCacheInfo->isReservedRemove()) {
+                EASYHTTPCPP_LOG_D(Tag, "getMetadata : [%s] is reserving delete.", key.c_str());
+                return false;
+            }
         }
 
+        // the database is read without the instance lock so that lookups of other keys are not blocked.
         HttpCacheMetadata::Ptr pHttpCacheMetadata = m_pMetadataDb->getMetadata(key);
         if (!pHttpCacheMetadata) {
             EASYHTTPCPP_LOG_D(Tag, "getMetadata : [%s] can not get from database.", key.c_str());
             return false;
         }
 
-        if (!m_pMetadataDb->updateLastAccessedSec(key)) {
-            EASYHTTPCPP_LOG_D(Tag, "getMetadata : [%s] can not update last accessed sec. ignored.", key.c_str());
+        {
+            Poco::FastMutex::ScopedLock lock(m_instanceMutex);
+            recordLastAccessedSec(key);
         }
 
         pCacheMetadata = pHttpCacheMetadata;
         EASYHTTPCPP_LOG_D(Tag, "getMetadata : [%s] succeeded.", key.c_str());
         return true;
     } catch (const SqlDatabaseCorruptException& e) {
+        Poco::FastMutex::ScopedLock lock(m_instanceMutex);
         deleteCorruptedCacheFile(__func__, e);
         return false;
     } catch (const SqlException& e) {
@@ -92,122 +162,174 @@ bool HttpFileCache::getMetadata(const std::string& key, CacheMetadata::Ptr& pCac
 
 bool HttpFileCache::getData(const std::string& key, std::istream*& pStream)
 {
-    Poco::FastMutex::ScopedLock lock(m_instanceMutex);
+    Poco::FastMutex::ScopedLock keyLock(m_keyMutexes.get(key));
 
+    size_t dataSize = 0;
     try {
+        Poco::FastMutex::ScopedLock lock(m_instanceMutex);
+
         initializeCache();
 
-        CacheInfoWithDataSize::Ptr pCacheInfo = m_lruCacheStrategy->get(key);
-        if (!pCacheInfo) {
+        const HttpCacheInfo* pHttpCacheInfo = getCacheInfo(key);
+        if (pHttpCacheInfo == NULL) {
             EASYHTTPCPP_LOG_D(Tag, "getData : [%s] not found in cache.", key.c_str());
             return false;
         }
 
-        HttpCacheInfo* pHttpCacheInfo = static_cast<HttpCacheInfo*> (pCacheInfo.get());
         if (pHttpCacheInfo->isReservedRemove()) {
             EASYHTTPCPP_LOG_D(Tag, "getData : [%s] is reserving delete.", key.c_str());
             return false;
         }
 
-        pStream = createStreamFromCache(key);
-        if (pStream == NULL) {
-            EASYHTTPCPP_LOG_D(Tag, "getData : [%s] can not create stream.", key.c_str());
-            return false;
-        }
-
-        pHttpCacheInfo->addDataRef();
-        m_lruCacheStrategy->update(key, pCacheInfo);
-
-        EASYHTTPCPP_LOG_D(Tag, "getData : [%s] succeeded.", key.c_str());
-        return true;
+        // the entry is referenced before the file is opened, so that it is not evicted meanwhile.
+        // the entry in the LRU list is updated in place, so that a cache hit allocates nothing here.
+        dataSize = pHttpCacheInfo->getDataSize();
+        m_lruCacheStrategy->addDataRef(key);
     } catch (const SqlDatabaseCorruptException& e) {
+        Poco::FastMutex::ScopedLock lock(m_instanceMutex);
         deleteCorruptedCacheFile(__func__, e);
         return false;
     } catch (const SqlException& e) {
         EASYHTTPCPP_LOG_D(Tag, "getMetadata : database error occurred. Details: %s", e.getMessage().c_str());
         return false;
     }
+
+    try {
+        pStream = createStreamFromCache(key, dataSize);
+    } catch (const SqlDatabaseCorruptException& e) {
+        Poco::FastMutex::ScopedLock lock(m_instanceMutex);
+        deleteCorruptedCacheFile(__func__, e);
+        return false;
+    } catch (const SqlException& e) {
+        EASYHTTPCPP_LOG_D(Tag, "getData : database error occurred. Details: %s", e.getMessage().c_str());
+        pStream = NULL;
+    }
+    if (pStream == NULL) {
+        EASYHTTPCPP_LOG_D(Tag, "getData : [%s] can not create stream.", key.c_str());
+        Poco::FastMutex::ScopedLock lock(m_instanceMutex);
+        releaseDataInternal(key);
+        return false;
+    }
+
+    EASYHTTPCPP_LOG_D(Tag, "getData : [%s] succeeded.", key.c_str());
+    return true;
 }
 
 bool HttpFileCache::get(const std::string& key, CacheMetadata::Ptr& pCacheMetadata, std::istream*& pStream)
 {
-    Poco::FastMutex::ScopedLock lock(m_instanceMutex);
+    Poco::FastMutex::ScopedLock keyLock(m_keyMutexes.get(key));
+
+    size_t dataSize = 0;
+    try {
+        Poco::FastMutex::ScopedLock lock(m_instanceMutex);
 
-    try{
         initializeCache();
 
         // TODO: when m_reservedRemove is true, LRU list changed by LruCacheStrategy::get.
         // It is better to think of a good way.
-        CacheInfoWithDataSize::Ptr pCacheInfo = m_lruCacheStrategy->get(key);
-        if (!pCacheInfo) {
+        const HttpCacheInfo* pHttpCacheInfo = getCacheInfo(key);
+        if (pHttpCacheInfo == NULL) {
             EASYHTTPCPP_LOG_D(Tag, "get : [%s] not found in cache.", key.c_str());
             return false;
         }
 
-        HttpCacheInfo* pHttpCacheInfo = static_cast<HttpCacheInfo*> (pCacheInfo.get());
         if (pHttpCacheInfo->isReservedRemove()) {
             EASYHTTPCPP_LOG_D(Tag, "get : [%s] is reserving delete.", key.c_str());
             return false;
         }
 
+        dataSize = pHttpCacheInfo->getDataSize();
+        m_lruCacheStrategy->addDataRef(key);
+    } catch (const SqlDatabaseCorruptException& e) {
+        Poco::FastMutex::ScopedLock lock(m_instanceMutex);
+        deleteCorruptedCacheFile(__func__, e);
+        return false;
+    } catch (const SqlException& e) {
+        EASYHTTPCPP_LOG_D(Tag, "get : database error occurred. Details: %s", e.getMessage().c_str());
+        return false;
+    }
+
+    try {
         HttpCacheMetadata::Ptr pHttpCacheMetadata = m_pMetadataDb->getMetadata(key);
         if (!pHttpCacheMetadata) {
             EASYHTTPCPP_LOG_D(Tag, "get : [%s] can not get from database.", key.c_str());
+            Poco::FastMutex::ScopedLock lock(m_instanceMutex);
+            releaseDataInternal(key);
             return false;
         }
 
-        if (!m_pMetadataDb->updateLastAccessedSec(key)) {
-            EASYHTTPCPP_LOG_D(Tag, "get : [%s] can not update last accessed sec. ignored.", key.c_str());
+        {
+            Poco::FastMutex::ScopedLock lock(m_instanceMutex);
+            recordLastAccessedSec(key);
         }
 
-        pStream = createStreamFromCache(key);
+        pStream = createStreamFromCache(key, dataSize);
         if (pStream == NULL) {
             EASYHTTPCPP_LOG_D(Tag, "getData : [%s] can not create stream.", key.c_str());
+            Poco::FastMutex::ScopedLock lock(m_instanceMutex);
+            releaseDataInternal(key);
             return false;
         }
 
         pCacheMetadata = pHttpCacheMetadata;
-        pHttpCacheInfo->addDataRef();
-        m_lruCacheStrategy->update(key, pCacheInfo);
-
         EASYHTTPCPP_LOG_D(Tag, "get : [%s] succeeded.", key.c_str());
         return true;
     } catch (const SqlDatabaseCorruptException& e) {
+        Poco::FastMutex::ScopedLock lock(m_instanceMutex);
         deleteCorruptedCacheFile(__func__, e);
         return false;
     } catch (const SqlException& e) {
         EASYHTTPCPP_LOG_D(Tag, "get : database error occurred. Details: %s", e.getMessage().c_str());
+        Poco::FastMutex::ScopedLock lock(m_instanceMutex);
+        releaseDataInternal(key);
         return false;
     }
 }
 
 bool HttpFileCache::putMetadata(const std::string& key, CacheMetadata::Ptr pCacheMetadata)
 {
-    Poco::FastMutex::ScopedLock lock(m_instanceMutex);
+    Poco::FastMutex::ScopedLock keyLock(m_keyMutexes.get(key));
 
     try {
-        initializeCache();
-
-        CacheInfoWithDataSize::Ptr pCacheInfo = m_lruCacheStrategy->get(key);
-        if (pCacheInfo) {
-            HttpCacheInfo* pHttpCacheInfo = static_cast<HttpCacheInfo*> (pCacheInfo.get());
-            if (pHttpCacheInfo->isReservedRemove()) {
-                EASYHTTPCPP_LOG_D(Tag, "putMetadata : [%s] is reserving delete.", key.c_str());
-                return false;
-            }
-            if (pHttpCacheInfo->getDataRefCount() != 0) {
-                EASYHTTPCPP_LOG_D(Tag, "putMetadata : [%s] dataRefCount is not 0.", key.c_str());
+        {
+            Poco::FastMutex::ScopedLock lock(m_instanceMutex);
+
+            initializeCache();
+
+            const HttpCacheInfo* pHttpCacheInfo = getCacheInfo(key);
+            if (pHttpCacheInfo != NULL) {
+                if (pHttpCacheInfo->isReservedRemove()) {
+                    EASYHTTPCPP_LOG_D(Tag, "putMetadata : [%s] is reserving delete.", key.c_str());
+                    return false;
+                }
+                // the data is not replaced, so the metadata is updated even while the data is read; a revalidated
+                // response is refreshed while its stale body is still being read.
+                // referenced while the database is updated, so that the entry is not evicted meanwhile.
+                m_lruCacheStrategy->addDataRef(key);
+            } else {
+                EASYHTTPCPP_LOG_D(Tag, "putMetadata : not found in cache [%s]", key.c_str());
                 return false;
             }
-        } else {
-            EASYHTTPCPP_LOG_D(Tag, "putMetadata : not found in cache [%s]", key.c_str());
-            return false;
+
+            // updateMetadata writes the current time as last accessed time.
+            m_pendingLastAccessedSecs.erase(key);
         }
 
-        m_pMetadataDb->updateMetadata(key, pCacheMetadata.unsafeCast<HttpCacheMetadata>());
+        try {
+            m_pMetadataDb->updateMetadata(key, pCacheMetadata.unsafeCast<HttpCacheMetadata>());
+        } catch (const SqlDatabaseCorruptException&) {
+            throw;
+        } catch (const SqlException&) {
+            Poco::FastMutex::ScopedLock lock(m_instanceMutex);
+            releaseDataInternal(key);
+            throw;
+        }
 
+        Poco::FastMutex::ScopedLock lock(m_instanceMutex);
+        releaseDataInternal(key);
         return true;
     } catch (const SqlDatabaseCorruptException& e) {
+        Poco::FastMutex::ScopedLock lock(m_instanceMutex);
         deleteCorruptedCacheFile(__func__, e);
         return false;
     } catch (const SqlException& e) {
@@ -218,56 +340,87 @@ bool HttpFileCache::putMetadata(const std::string& key, CacheMetadata::Ptr pCach
 
 bool HttpFileCache::put(const std::string& key, CacheMetadata::Ptr pCacheMetadata, const std::string& path)
 {
-    Poco::FastMutex::ScopedLock lock(m_instanceMutex);
+    Poco::FastMutex::ScopedLock keyLock(m_keyMutexes.get(key));
 
     HttpCacheMetadata::Ptr pHttpCacheMetadata = pCacheMetadata.unsafeCast<HttpCacheMetadata>();
-    try {
-        initializeCache();
+    {
+        Poco::FastMutex::ScopedLock lock(m_instanceMutex);
 
-        CacheInfoWithDataSize::Ptr pOldCacheInfo = m_lruCacheStrategy->get(key);
-        if (pOldCacheInfo) {
-            HttpCacheInfo* pHttpCacheInfo = static_cast<HttpCacheInfo*> (pOldCacheInfo.get());
-            if (pHttpCacheInfo->isReservedRemove()) {
-                EASYHTTPCPP_LOG_D(Tag, "put : [%s] is reserving delete.", key.c_str());
+        try {
+            // a put does not wait for the index. while it is loading, the old entry is looked up in the database,
+            // and the new entry is recorded as accessed, so that the loader evicts older entries for it when the
+            // index is merged.
+            initializeCache();
+            if (!m_cacheInitialized) {
+                EASYHTTPCPP_LOG_D(Tag, "put : cache is not initialized.");
                 return false;
             }
-            if (pHttpCacheInfo->getDataRefCount() != 0) {
-                EASYHTTPCPP_LOG_D(Tag, "put : [%s] dataRefCount is not 0.", key.c_str());
-                return false;
+
+            const HttpCacheInfo* pHttpCacheInfo = getCacheInfo(key);
+            if (pHttpCacheInfo != NULL) {
+                if (pHttpCacheInfo->isReservedRemove()) {
+                    EASYHTTPCPP_LOG_D(Tag, "put : [%s] is reserving delete.", key.c_str());
+                    return false;
+                }
+                if (pHttpCacheInfo->getDataRefCount() != 0) {
+                    EASYHTTPCPP_LOG_D(Tag, "put : [%s] dataRefCount is not 0.", key.c_str());
+                    return false;
+                }
+
+                // remove old cache
+                removeInternal(key);
             }
 
-            // remove old cache
-            removeInternal(key);
-        }
+            if (!m_lruCacheStrategy->makeSpace(pHttpCacheMetadata->getResponseBodySize())) {
+                EASYHTTPCPP_LOG_D(Tag, "put : can not make cache space.");
+                return false;
+            }
 
-        if (!m_lruCacheStrategy->makeSpace(pHttpCacheMetadata->getResponseBodySize())) {
-            EASYHTTPCPP_LOG_D(Tag, "put : can not make cache space.");
+            // updateMetadata writes the current time as last accessed time.
+            m_pendingLastAccessedSecs.erase(key);
+        } catch (const SqlDatabaseCorruptException& e) {
+            deleteCorruptedCacheFile(__func__, e);
+            // continue put processing.
+        } catch (const SqlException& e) {
+            EASYHTTPCPP_LOG_D(Tag, "put : database error occurred. Details: %s", e.getMessage().c_str());
             return false;
         }
-    } catch (const SqlDatabaseCorruptException& e) {
-        deleteCorruptedCacheFile(__func__, e);
-        // continue put processing.
-    } catch (const SqlException& e) {
-        EASYHTTPCPP_LOG_D(Tag, "put : database error occurred. Details: %s", e.getMessage().c_str());
-        return false;
     }
 
+    // the file is moved and the database is written without the instance lock. the key lock keeps other
+    // operations on the same key out until the entry is added to the LRU list.
     CacheInfoWithDataSize::Ptr pNewCacheInfo = new HttpCacheInfo(key, pHttpCacheMetadata->getResponseBodySize());
 
     Poco::File tempFile(path);
     std::string targetFilename = makeCachedFilename(key);
     Poco::File cacheFile(targetFilename);
-    if (!FileUtil::moveFile(tempFile, cacheFile)) {
+    // a small response body is stored in the database row, which saves a file, its directory entry and the
+    // system calls to create, rename, open and remove it.
+    std::string responseBody;
+    bool inlineBody = isInlineBodySize(pHttpCacheMetadata->getResponseBodySize()) &&
+            readInlineBody(path, pHttpCacheMetadata->getResponseBodySize(), responseBody);
+    if (!inlineBody && (!FileUtil::createDirsIfAbsent(Poco::File(Poco::Path(targetFilename).parent())) ||
+            !FileUtil::moveFile(tempFile, cacheFile))) {
         EASYHTTPCPP_LOG_D(Tag, "can not move cache file. [%s] -> [%s]", path.c_str(), targetFilename.c_str());
         return false;
     }
 
     try {
-        initializeCache();
+        {
+            Poco::FastMutex::ScopedLock lock(m_instanceMutex);
+            initializeCache();
+        }
 
-        m_pMetadataDb->updateMetadata(key, pHttpCacheMetadata);
+        if (inlineBody) {
+            m_pMetadataDb->updateMetadata(key, pHttpCacheMetadata, responseBody);
+        } else {
+            m_pMetadataDb->updateMetadata(key, pHttpCacheMetadata);
+        }
     } catch (const SqlDatabaseCorruptException& e) {
-        deleteCorruptedCacheFile(__func__, e);
+        {
+            Poco::FastMutex::ScopedLock lock(m_instanceMutex);
+            deleteCorruptedCacheFile(__func__, e);
+        }
 
         if (!FileUtil::removeFileIfPresent(cacheFile)) {
             EASYHTTPCPP_LOG_D(Tag, "can not remove cache file. [%s]", targetFilename.c_str());
@@ -282,9 +435,25 @@ bool HttpFileCache::put(const std::string& key, CacheMetadata::Ptr pCacheMetadat
     }
 
     EASYHTTPCPP_LOG_D(Tag, "update key=%s", key.c_str());
+    if (inlineBody && !FileUtil::removeFileIfPresent(tempFile)) {
+        EASYHTTPCPP_LOG_D(Tag, "can not remove temporary file. [%s]", path.c_str());
+    }
 
-    // update never fails, because already make free space.
-    m_lruCacheStrategy->update(key, pNewCacheInfo);
+    Poco::FastMutex::ScopedLock lock(m_instanceMutex);
+    try {
+        // the space made above may have been used by a put of another key meanwhile.
+        if (!m_lruCacheStrategy->update(key, pNewCacheInfo)) {
+            EASYHTTPCPP_LOG_D(Tag, "put : [%s] can not make cache space.", key.c_str());
+            onRemove(key);
+            return false;
+        }
+    } catch (const SqlDatabaseCorruptException& e) {
+        deleteCorruptedCacheFile(__func__, e);
+        return false;
+    }
+    if (!m_indexLoaded) {
+        recordKeyAccessedWhileIndexLoading(key);
+    }
 
     return true;
 }
@@ -298,6 +467,7 @@ bool HttpFileCache::put(const std::string& key, CacheMetadata::Ptr pCacheMetadat
 
 bool HttpFileCache::remove(const std::string& key)
 {
+    Poco::FastMutex::ScopedLock keyLock(m_keyMutexes.get(key));
     Poco::FastMutex::ScopedLock lock(m_instanceMutex);
 
     try {
@@ -307,7 +477,7 @@ bool HttpFileCache::remove(const std::string& key)
             EASYHTTPCPP_LOG_D(Tag, "remove : [%s] succeeded.", key.c_str());
             return true;
         } else {
-            EASYHTTPCPP_LOG_D(Tag, "remove : [%s] succeeded.", key.c_str());
+            EASYHTTPCPP_LOG_D(Tag, "remove : [%s] failed.", key.c_str());
             return false;
         }
     } catch (const SqlDatabaseCorruptException& e) {
@@ -321,38 +491,19 @@ bool HttpFileCache::remove(const std::string& key)
 
 void HttpFileCache::releaseData(const std::string& key)
 {
+    Poco::FastMutex::ScopedLock keyLock(m_keyMutexes.get(key));
     Poco::FastMutex::ScopedLock lock(m_instanceMutex);
 
-    CacheInfoWithDataSize::Ptr pCacheInfo = m_lruCacheStrategy->get(key);
-    if (!pCacheInfo) {
-        EASYHTTPCPP_LOG_D(Tag, "releaseData : [%s] not found in cache.", key.c_str());
-        return;
-    }
-
-    HttpCacheInfo* pHttpCacheInfo = static_cast<HttpCacheInfo*> (pCacheInfo.get());
-    if (pHttpCacheInfo->getDataRefCount() == 0) {
-        EASYHTTPCPP_LOG_D(Tag, "releaseData : [%s] dataRefCount is already 0.", key.c_str());
-    } else {
-        pHttpCacheInfo->releaseDataRef();
-
-        try {
-            m_lruCacheStrategy->update(key, pCacheInfo);
-        } catch (const SqlDatabaseCorruptException& e) {
-            deleteCorruptedCacheFile(__func__, e);
-        } catch (const SqlException& e) {
-            EASYHTTPCPP_LOG_D(Tag, "remove : database error occurred. Details: %s", e.getMessage().c_str());
-        }
-    }
-
-    EASYHTTPCPP_LOG_D(Tag, "releaseData : [%s] succeeded.", key.c_str());
+    releaseDataInternal(key);
 }
 
 bool HttpFileCache::purge(bool mayDeleteIfBusy)
 {
+    StripedMutex::ScopedLockAll keyLock(m_keyMutexes);
     Poco::FastMutex::ScopedLock lock(m_instanceMutex);
 
     try {
-        initializeCache();
+        waitForIndexLoaded();
 
         bool ret = m_lruCacheStrategy->clear(mayDeleteIfBusy);
 
@@ -372,14 +523,50 @@ bool HttpFileCache::purge(bool mayDeleteIfBusy)
     }
 }
 
+void HttpFileCache::releaseDataInternal(const std::string& key)
+{
+    const HttpCacheInfo* pHttpCacheInfo = static_cast<const HttpCacheInfo*> (m_lruCacheStrategy->getView(key));
+    if (pHttpCacheInfo == NULL) {
+        EASYHTTPCPP_LOG_D(Tag, "releaseData : [%s] not found in cache.", key.c_str());
+        return;
+    }
+
+    if (pHttpCacheInfo->getDataRefCount() == 0) {
+        EASYHTTPCPP_LOG_D(Tag, "releaseData : [%s] dataRefCount is already 0.", key.c_str());
+    } else {
+        try {
+            // removes the entry if removing it has been reserved.
+            m_lruCacheStrategy->releaseDataRef(key);
+        } catch (const SqlDatabaseCorruptException& e) {
+            deleteCorruptedCacheFile(__func__, e);
+        } catch (const SqlException& e) {
+            EASYHTTPCPP_LOG_D(Tag, "remove : database error occurred. Details: %s", e.getMessage().c_str());
+        }
+    }
+
+    EASYHTTPCPP_LOG_D(Tag, "releaseData : [%s] succeeded.", key.c_str());
+}
+
 void HttpFileCache::deleteCacheFile()
 {
-    // session should be closed before remove the data.
-    m_pMetadataDb->closeSqliteSession();
+    m_pendingLastAccessedSecs.clear();
+
+    // the session is closed by deleteDatabaseFile before the file is removed.
     m_pMetadataDb->deleteDatabaseFile();
 }
 
-std::istream* HttpFileCache::createStreamFromCache(const std::string& key)
+std::istream* HttpFileCache::createStreamFromCache(const std::string& key, size_t dataSize)
+{
+    // the other place is looked up too, because the entry may have been stored with another threshold.
+    if (isInlineBodySize(dataSize)) {
+        std::istream* pStream = createStreamFromDatabase(key);
+        return pStream ? pStream : createStreamFromFile(key);
+    }
+    std::istream* pStream = createStreamFromFile(key);
+    return pStream ? pStream : createStreamFromDatabase(key);
+}
+
+std::istream* HttpFileCache::createStreamFromFile(const std::string& key)
 {
     std::string filePath = makeCachedFilename(key);
     Poco::File file(filePath);
@@ -395,6 +582,12 @@ std::istream* HttpFileCache::createStreamFromCache(const std::string& key)
         EASYHTTPCPP_LOG_D(Tag, "createStreamFromCache: std::exception. [%s]", e.what());
         return NULL;
     }
+    // a mapped file is read without an intermediate buffer, and its contents can be taken without copying.
+    MappedFile::Ptr pMappedFile = MappedFile::map(file, HttpInternalConstants::Caches::MappedReadMaxSize,
+            MappedFile::AccessPatternSequential);
+    if (pMappedFile) {
+        return new MappedFileInputStream(pMappedFile);
+    }
     try {
         Poco::FileInputStream* pIfStream =
                 new Poco::FileInputStream(filePath, std::ios_base::in | std::ios_base::binary);
@@ -405,12 +598,45 @@ std::istream* HttpFileCache::createStreamFromCache(const std::string& key)
     }
 }
 
+std::istream* HttpFileCache::createStreamFromDatabase(const std::string& key)
+{
+    Poco::SharedPtr<ByteArrayBuffer> pResponseBody = m_pMetadataDb->getResponseBody(key);
+    if (!pResponseBody) {
+        return NULL;
+    }
+    return new ByteArrayBufferInputStream(pResponseBody);
+}
+
+bool HttpFileCache::isInlineBodySize(size_t dataSize) const
+{
+    // an empty response body is kept in a file, so that a stored body is never empty.
+    return dataSize > 0 && dataSize <= m_inlineBodyMaxSize;
+}
+
+bool HttpFileCache::readInlineBody(const std::string& path, size_t dataSize, std::string& responseBody)
+{
+    std::ifstream ifs(path.c_str(), std::ios_base::in | std::ios_base::binary);
+    if (!ifs) {
+        EASYHTTPCPP_LOG_D(Tag, "readInlineBody: can not open temporary file. [%s]", path.c_str());
+        return false;
+    }
+    responseBody.resize(dataSize);
+    ifs.read(&responseBody[0], static_cast<std::streamsize>(dataSize));
+    // the file must have exactly the size in the metadata.
+    if (static_cast<size_t>(ifs.gcount()) != dataSize || ifs.peek() != std::ifstream::traits_type::eof()) {
+        EASYHTTPCPP_LOG_D(Tag, "readInlineBody: size of temporary file is not %zu. [%s]", dataSize, path.c_str());
+        responseBody.clear();
+        return false;
+    }
+    return true;
+}
+
 size_t HttpFileCache::getSize()
 {
     Poco::FastMutex::ScopedLock lock(m_instanceMutex);
 
     try {
-        initializeCache();
+        waitForIndexLoaded();
     } catch (const SqlDatabaseCorruptException& e) {
         deleteCorruptedCacheFile(__func__, e);
         throw HttpExecutionException("Cache database is corrupted. Check getCause() for details.", e);
@@ -422,6 +648,22 @@ size_t HttpFileCache::getSize()
     return m_lruCacheStrategy->getTotalSize();
 }
 
+bool HttpFileCache::flush()
+{
+    Poco::FastMutex::ScopedLock lock(m_instanceMutex);
+
+    try {
+        flushLastAccessedSec();
+        return true;
+    } catch (const SqlDatabaseCorruptException& e) {
+        deleteCorruptedCacheFile(__func__, e);
+        return false;
+    } catch (const SqlException& e) {
+        EASYHTTPCPP_LOG_D(Tag, "flush : database error occurred. Details: %s", e.getMessage().c_str());
+        return false;
+    }
+}
+
 bool HttpFileCache::onAdd(const std::string& key, CacheInfoWithDataSize::Ptr value)
 {
     return true;
@@ -434,6 +676,11 @@ bool HttpFileCache::onUpdate(const std::string& key, CacheInfoWithDataSize::Ptr
 
 bool HttpFileCache::onRemove(const std::string& key)
 {
+    m_pendingLastAccessedSecs.erase(key);
+    if (!m_indexLoaded) {
+        m_keysRemovedWhileIndexLoading.insert(key);
+    }
+
     try {
         if (!m_pMetadataDb->deleteMetadata(key)) {
             EASYHTTPCPP_LOG_D(Tag, "onRemove : Failed to delete from database. key=[%s]", key.c_str());
@@ -477,12 +724,16 @@ bool HttpFileCache::onEnumerate(const HttpCacheEnumerationListener::EnumerationP
 
 bool HttpFileCache::removeInternal(const std::string& key)
 {
+    // while the index is loading, the entry is in the LRU list only after it is looked up.
+    if (!m_indexLoaded && !getCacheInfo(key)) {
+        return false;
+    }
     return m_lruCacheStrategy->remove(key);
 }
 
 std::string HttpFileCache::makeCachedFilename(const std::string& key)
 {
-    return HttpUtil::makeCachedResponseBodyFilename(m_cacheRootDir, key);
+    return HttpUtil::makeCachedResponseBodyFilename(m_cacheRootDir, key, m_dataDirFanOutLevels);
 }
 
 void HttpFileCache::initializeCache()
@@ -496,10 +747,242 @@ void HttpFileCache::initializeCache()
         return;
     }
 
-    // initialize date base
-    m_pMetadataDb->enumerate(this);
-
     m_cacheInitialized = true;
+    m_indexLoaded = false;
+    m_indexGeneration++;
+    m_pIndexLoadError = NULL;
+    if (m_indexLoaderRunning) {
+        // the running loader starts over because the generation is changed.
+        return;
+    }
+
+    // the previous loader has already finished under the lock, so join returns immediately.
+    m_indexLoaderThread.join();
+    m_indexLoaderRunning = true;
+    try {
+        m_indexLoaderThread.start(m_indexLoaderRunnable);
+    } catch (const Poco::Exception& e) {
+        EASYHTTPCPP_LOG_W(Tag, "initializeCache: can not start index loader. load index now. Details: %s",
+                e.message().c_str());
+        m_indexLoaderRunning = false;
+        m_cacheInitialized = false;
+        m_indexLoaded = true;
+        m_pMetadataDb->enumerate(this);
+        m_cacheInitialized = true;
+    }
+}
+
+void HttpFileCache::waitForIndexLoaded()
+{
+    initializeCache();
+    while (m_cacheInitialized && !m_indexLoaded) {
+        m_indexLoadedCondition.wait(m_instanceMutex);
+    }
+    if (!m_indexLoaded) {
+        if (m_pIndexLoadError) {
+            m_pIndexLoadError->rethrow();
+        }
+        throw SqlExecutionException("Cache index could not be loaded from the database.");
+    }
+}
+
+HttpLruCacheStrategy::Ptr HttpFileCache::createLruCacheStrategy()
+{
+    if (m_evictionPolicy == HttpCache::EvictionPolicyTinyLfu) {
+        return new HttpTinyLfuCacheStrategy(m_maxSize);
+    }
+    return new HttpLruCacheStrategy(m_maxSize);
+}
+
+const HttpCacheInfo* HttpFileCache::getCacheInfo(const std::string& key)
+{
+    const HttpCacheInfo* pHttpCacheInfo = static_cast<const HttpCacheInfo*> (m_lruCacheStrategy->getView(key));
+    if (m_indexLoaded) {
+        return pHttpCacheInfo;
+    }
+
+    // do not wait for the index; a single row is read from the database and kept in the LRU list.
+    if (pHttpCacheInfo == NULL) {
+        HttpCacheMetadata::Ptr pHttpCacheMetadata = m_pMetadataDb->getMetadata(key);
+        if (!pHttpCacheMetadata) {
+            return NULL;
+        }
+        CacheInfoWithDataSize::Ptr pCacheInfo = new HttpCacheInfo(key, pHttpCacheMetadata->getResponseBodySize());
+        if (!m_lruCacheStrategy->add(key, pCacheInfo)) {
+            EASYHTTPCPP_LOG_D(Tag, "getCacheInfo : [%s] can not add to LRU list.", key.c_str());
+            return NULL;
+        }
+        pHttpCacheInfo = static_cast<const HttpCacheInfo*> (m_lruCacheStrategy->getView(key));
+    }
+    recordKeyAccessedWhileIndexLoading(key);
+    return pHttpCacheInfo;
+}
+
+void HttpFileCache::recordKeyAccessedWhileIndexLoading(const std::string& key)
+{
+    // a key is recorded once in the order of its last access, so that repeated accesses do not grow the list.
+    AccessedKeyMap::iterator it = m_accessedKeyPositions.find(key);
+    if (it != m_accessedKeyPositions.end()) {
+        m_keysAccessedWhileIndexLoading.splice(m_keysAccessedWhileIndexLoading.end(),
+                m_keysAccessedWhileIndexLoading, it->second);
+        return;
+    }
+    m_keysAccessedWhileIndexLoading.push_back(key);
+    m_accessedKeyPositions[key] = --m_keysAccessedWhileIndexLoading.end();
+}
+
+void HttpFileCache::clearKeysChangedWhileIndexLoading()
+{
+    m_keysAccessedWhileIndexLoading.clear();
+    m_accessedKeyPositions.clear();
+    m_keysRemovedWhileIndexLoading.clear();
+}
+
+void HttpFileCache::loadIndex()
+{
+    Poco::FastMutex::ScopedLock lock(m_instanceMutex);
+
+    while (!m_indexLoaderStopRequested && m_cacheInitialized && !m_indexLoaded) {
+        std::set<std::string> indexedKeys;
+        if (!loadIndexEntries(indexedKeys)) {
+            continue;
+        }
+
+        unsigned int generation = m_indexGeneration;
+        Poco::ScopedUnlock<Poco::FastMutex> unlock(m_instanceMutex);
+        removeOrphanedFiles(generation, indexedKeys);
+    }
+
+    m_indexLoaderRunning = false;
+    m_indexLoadedCondition.broadcast();
+}
+
+bool HttpFileCache::loadIndexEntries(std::set<std::string>& indexedKeys)
+{
+    unsigned int generation = m_indexGeneration;
+    HttpCacheDatabase::EnumerationParamList params;
+    long long lastId = 0;
+    try {
+        while (m_pMetadataDb->enumerateChunk(lastId, HttpInternalConstants::Database::IndexLoadChunkCount, params) ==
+                HttpInternalConstants::Database::IndexLoadChunkCount) {
+            lastId = params.back().m_id;
+            {
+                // requests are served between chunks.
+                Poco::ScopedUnlock<Poco::FastMutex> unlock(m_instanceMutex);
+                Poco::Thread::yield();
+            }
+            if (m_indexLoaderStopRequested || !m_cacheInitialized || generation != m_indexGeneration) {
+                return false;
+            }
+        }
+
+        mergeIndex(params, indexedKeys);
+        m_indexLoaded = true;
+        m_indexLoadedCondition.broadcast();
+        EASYHTTPCPP_LOG_D(Tag, "loadIndexEntries: loaded %zu entries.", params.size());
+        return true;
+    } catch (const SqlDatabaseCorruptException& e) {
+        deleteCorruptedCacheFile(__func__, e);
+        m_pIndexLoadError = e.clone();
+    } catch (const SqlException& e) {
+        EASYHTTPCPP_LOG_D(Tag, "loadIndexEntries : database error occurred. Details: %s", e.getMessage().c_str());
+        // loading is retried on the next access.
+        m_cacheInitialized = false;
+        m_pIndexLoadError = e.clone();
+    }
+    return false;
+}
+
+void HttpFileCache::mergeIndex(HttpCacheDatabase::EnumerationParamList& params,
+        std::set<std::string>& indexedKeys)
+{
+    std::stable_sort(params.begin(), params.end(), isAccessedEarlier);
+
+    HttpLruCacheStrategy::Ptr pLruCacheStrategy = createLruCacheStrategy();
+    pLruCacheStrategy->setListener(this);
+
+    // older entries first, then entries accessed or put while loading in the order of access. adding them makes
+    // space by evicting the older entries, so that puts made while loading are kept within the max size.
+    for (HttpCacheDatabase::EnumerationParamList::const_iterator it = params.begin(); it != params.end(); it++) {
+        indexedKeys.insert(it->m_key);
+        if (m_keysRemovedWhileIndexLoading.count(it->m_key) > 0 || m_accessedKeyPositions.count(it->m_key) > 0) {
+            continue;
+        }
+        CacheInfoWithDataSize::Ptr pCacheInfo = new HttpCacheInfo(it->m_key, it->m_responseBodySize);
+        if (!pLruCacheStrategy->add(it->m_key, pCacheInfo)) {
+            EASYHTTPCPP_LOG_D(Tag, "mergeIndex: cannot make cache space");
+        }
+    }
+    for (std::list<std::string>::const_iterator it = m_keysAccessedWhileIndexLoading.begin();
+            it != m_keysAccessedWhileIndexLoading.end(); it++) {
+        indexedKeys.insert(*it);
+        CacheInfoWithDataSize::Ptr pCacheInfo = m_lruCacheStrategy->get(*it);
+        if (pCacheInfo) {
+            pLruCacheStrategy->add(*it, pCacheInfo);
+        }
+    }
+
+    m_lruCacheStrategy->setListener(NULL);
+    m_lruCacheStrategy = pLruCacheStrategy;
+    clearKeysChangedWhileIndexLoading();
+}
+
+void HttpFileCache::removeOrphanedFiles(unsigned int generation, const std::set<std::string>& indexedKeys)
+{
+    // temporary files of unfinished responses and response bodies without metadata are left when the process
+    // stopped while writing. files written by this instance are newer than m_createdAt and are kept.
+    std::vector<Poco::File> files;
+    try {
+        Poco::Path tempDir(m_cacheRootDir);
+        tempDir.append(Poco::Path(HttpInternalConstants::Caches::TempDir));
+        Poco::File tempDirFile(tempDir);
+        if (tempDirFile.exists()) {
+            tempDirFile.list(files);
+        }
+        std::set<std::string> indexedFilenames;
+        for (std::set<std::string>::const_iterator it = indexedKeys.begin(); it != indexedKeys.end(); it++) {
+            indexedFilenames.insert(makeCachedFilename(*it));
+        }
+        std::vector<Poco::File> cacheFiles;
+        listCachedFiles(Poco::File(m_cacheRootDir), cacheFiles);
+        for (size_t i = 0; i < cacheFiles.size(); i++) {
+            if (indexedFilenames.count(cacheFiles[i].path()) == 0) {
+                files.push_back(cacheFiles[i]);
+            }
+        }
+    } catch (const Poco::Exception& e) {
+        EASYHTTPCPP_LOG_D(Tag, "removeOrphanedFiles: can not list files. [%s]", e.message().c_str());
+        return;
+    }
+
+    size_t removedCount = 0;
+    for (size_t i = 0; i < files.size(); i++) {
+        if (isIndexLoadCancelled(generation)) {
+            return;
+        }
+        try {
+            // modified time has a resolution of seconds.
+            if (!files[i].isFile() || files[i].getLastModified().epochTime() >= m_createdAt.epochTime()) {
+                continue;
+            }
+        } catch (const Poco::Exception&) {
+            continue;
+        }
+        if (FileUtil::removeFileIfPresent(files[i])) {
+            removedCount++;
+        } else {
+            EASYHTTPCPP_LOG_D(Tag, "removeOrphanedFiles: can not remove file. [%s]", files[i].path().c_str());
+        }
+    }
+    if (removedCount > 0) {
+        EASYHTTPCPP_LOG_D(Tag, "removeOrphanedFiles: removed %zu files.", removedCount);
+    }
+}
+
+bool HttpFileCache::isIndexLoadCancelled(unsigned int generation)
+{
+    Poco::FastMutex::ScopedLock lock(m_instanceMutex);
+    return m_indexLoaderStopRequested || !m_cacheInitialized || generation != m_indexGeneration;
 }
 
 void HttpFileCache::deleteCorruptedCacheFile(const std::string& funcName, const easyhttpcpp::db::SqlException& e)
@@ -509,23 +992,65 @@ void HttpFileCache::deleteCorruptedCacheFile(const std::string& funcName, const
             e.getMessage().c_str());
 
     m_cacheInitialized = false;
+    m_indexLoaded = false;
 
     // reset LRU cache
     m_lruCacheStrategy->reset();
+    clearKeysChangedWhileIndexLoading();
 
     // delete cache database
     deleteCacheFile();
 
-    // delete cache response body
+    // delete cache response body. the data directories are removed as a whole instead of file by file.
     Poco::File cacheDir(m_cacheRootDir);
     std::vector<Poco::File> fileLists;
     cacheDir.list(fileLists);
     for (size_t i = 0; i < fileLists.size(); i++) {
-        FileUtil::removeFileIfPresent(fileLists[i]);
+        if (isDataDir(fileLists[i])) {
+            FileUtil::removeDirsIfPresent(Poco::Path(fileLists[i].path()));
+        } else {
+            FileUtil::removeFileIfPresent(fileLists[i]);
+        }
     }
 
     EASYHTTPCPP_LOG_W(Tag, "%s: Deleted the cache database and cached files because the Cache database was corrupted.",
             funcName.c_str());
 }
 
+void HttpFileCache::recordLastAccessedSec(const std::string& key)
+{
+    // a write transaction per cache hit makes reads write-bound, so last accessed times are kept in memory and
+    // written in a batch. the persisted value is only used to order LRU entries on the next startup.
+    Poco::Timestamp now;
+    m_pendingLastAccessedSecs[key] = now.epochTime();
+
+    if (m_pendingLastAccessedSecs.size() < HttpInternalConstants::Database::LastAccessedSecFlushMaxPendingCount &&
+            !m_lastAccessedSecFlushedAt.isElapsed(static_cast<Poco::Timestamp::TimeDiff>(
+            HttpInternalConstants::Database::LastAccessedSecFlushIntervalSec) * Poco::Timestamp::resolution())) {
+        return;
+    }
+
+    try {
+        flushLastAccessedSec();
+    } catch (const SqlDatabaseCorruptException& e) {
+        throw;
+    } catch (const SqlException& e) {
+        EASYHTTPCPP_LOG_D(Tag, "recordLastAccessedSec : can not write last accessed sec. ignored. Details: %s",
+                e.getMessage().c_str());
+    }
+}
+
+void HttpFileCache::flushLastAccessedSec()
+{
+    m_lastAccessedSecFlushedAt.update();
+    if (m_pendingLastAccessedSecs.empty()) {
+        return;
+    }
+
+    // pending times are dropped even if writing fails; they are only approximate.
+    HttpCacheDatabase::LastAccessedSecMap lastAccessedSecs;
+    lastAccessedSecs.swap(m_pendingLastAccessedSecs);
+    m_pMetadataDb->updateLastAccessedSecInBatch(lastAccessedSecs);
+}
+
 } /* namespace easyhttpcpp */
@@ -5,17 +5,33 @@
 #ifndef EASYHTTPCPP_HTTPFILECACHE_H_INCLUDED
 #define EASYHTTPCPP_HTTPFILECACHE_H_INCLUDED
 
+#include <list>
+#include <map>
+#include <set>
+#include <string>
+
+#include "Poco/Condition.h"
+#include "Poco/Mutex.h"
 #include "Poco/Path.h"
+#include "Poco/RunnableAdapter.h"
+#include "Poco/Thread.h"
+#include "Poco/Timestamp.h"
 
+#include "easyhttpcpp/common/BaseException.h"
 #include "easyhttpcpp/common/Cache.h"
 #include "easyhttpcpp/common/CacheMetadata.h"
 #include "easyhttpcpp/common/CacheStrategyListener.h"
-#include "easyhttpcpp/common/LruCacheByDataSizeStrategy.h"
+#include "easyhttpcpp/common/StripedMutex.h"
 #include "easyhttpcpp/db/SqlException.h"
+#include "easyhttpcpp/HttpCache.h"
+#include "easyhttpcpp/HttpCacheKeyHasher.h"
 #include "easyhttpcpp/HttpExports.h"
 
 #include "HttpCacheDatabase.h"
 #include "HttpCacheEnumerationListener.h"
+#include "HttpCacheInfo.h"
+#include "HttpInternalConstants.h"
+#include "HttpLruCacheStrategy.h"
 
 namespace easyhttpcpp {
 
@@ -23,7 +39,12 @@ class EASYHTTPCPP_HTTP_INTERNAL_API HttpFileCache : public easyhttpcpp::common::
 public easyhttpcpp::common::CacheStrategyListener<std::string,
         easyhttpcpp::common::CacheInfoWithDataSize::Ptr>, public HttpCacheEnumerationListener {
 public:
-    HttpFileCache(const Poco::Path& cacheRootDir, size_t maxSize);
+    // if pKeyHasher is NULL, the default hasher is used.
+    // response bodies are stored dataDirFanOutLevels directories deep. an existing cache is moved to the layout.
+    // response bodies up to inlineBodyMaxSize bytes are stored in the database instead of a file.
+    HttpFileCache(const Poco::Path& cacheRootDir, size_t maxSize, HttpCacheKeyHasher::Ptr pKeyHasher = NULL,
+            unsigned int dataDirFanOutLevels = HttpInternalConstants::Caches::DataDirFanOutLevels,
+            size_t inlineBodyMaxSize = 0, HttpCache::EvictionPolicy evictionPolicy = HttpCache::EvictionPolicyLru);
     virtual ~HttpFileCache();
     virtual bool getMetadata(const std::string& key, easyhttpcpp::common::CacheMetadata::Ptr& pCacheMetadata);
     virtual bool getData(const std::string& key, std::istream*& pStream);
@@ -40,6 +61,12 @@ public:
 
     size_t getSize();
 
+    /**
+     * Writes last accessed times which are kept in memory to the database.
+     * @return true if succeeded.
+     */
+    bool flush();
+
     virtual bool onAdd(const std::string& key, easyhttpcpp::common::CacheInfoWithDataSize::Ptr value);
     virtual bool onUpdate(const std::string& key, easyhttpcpp::common::CacheInfoWithDataSize::Ptr value);
     virtual bool onRemove(const std::string& key);
@@ -48,20 +75,66 @@ public:
     virtual bool onEnumerate(const HttpCacheEnumerationListener::EnumerationParam& param);
 
 private:
-    std::istream* createStreamFromCache(const std::string& key);
+    std::istream* createStreamFromCache(const std::string& key, size_t dataSize);
+    std::istream* createStreamFromFile(const std::string& key);
+    std::istream* createStreamFromDatabase(const std::string& key);
+    bool isInlineBodySize(size_t dataSize) const;
+    bool readInlineBody(const std::string& path, size_t dataSize, std::string& responseBody);
+    HttpLruCacheStrategy::Ptr createLruCacheStrategy();
+    // returns the entry kept in the LRU list; it is valid until the key is updated or removed.
+    const HttpCacheInfo* getCacheInfo(const std::string& key);
+    void recordKeyAccessedWhileIndexLoading(const std::string& key);
+    void clearKeysChangedWhileIndexLoading();
     bool removeInternal(const std::string& key); 
+    void releaseDataInternal(const std::string& key);
     std::string makeCachedFilename(const std::string& key);
     void cleanupCache(const std::string& key);
     void initializeCache();
+    void waitForIndexLoaded();
+    void loadIndex();
+    bool loadIndexEntries(std::set<std::string>& indexedKeys);
+    void mergeIndex(HttpCacheDatabase::EnumerationParamList& params, std::set<std::string>& indexedKeys);
+    void removeOrphanedFiles(unsigned int generation, const std::set<std::string>& indexedKeys);
+    bool isIndexLoadCancelled(unsigned int generation);
     void deleteCacheFile();
     void deleteCorruptedCacheFile(const std::string& funcName, const easyhttpcpp::db::SqlException& e);
+    void recordLastAccessedSec(const std::string& key);
+    void flushLastAccessedSec();
 
+    // an operation on a key holds the lock of the key, then m_instanceMutex only while the LRU list and the
+    // in-memory state are touched. reading and writing files and the database are done with the key lock only.
+    easyhttpcpp::common::StripedMutex m_keyMutexes;
     Poco::FastMutex m_instanceMutex;
     bool m_cacheInitialized;
     Poco::Path m_cacheRootDir;
     size_t m_maxSize;
+    unsigned int m_dataDirFanOutLevels;
+    size_t m_inlineBodyMaxSize;
+    HttpCache::EvictionPolicy m_evictionPolicy;
     HttpCacheDatabase::Ptr m_pMetadataDb;
-    easyhttpcpp::common::LruCacheByDataSizeStrategy::Ptr m_lruCacheStrategy;
+    HttpLruCacheStrategy::Ptr m_lruCacheStrategy;
+    // last accessed times not written to the database yet.
+    HttpCacheDatabase::LastAccessedSecMap m_pendingLastAccessedSecs;
+    Poco::Timestamp m_lastAccessedSecFlushedAt;
+
+    // the index (LRU list) is loaded from the database by m_indexLoaderThread. until it is loaded, lookups and puts
+    // are answered from the database and operations which need the whole index wait for it.
+    Poco::Timestamp m_createdAt;
+    Poco::Thread m_indexLoaderThread;
+    Poco::RunnableAdapter<HttpFileCache> m_indexLoaderRunnable;
+    Poco::Condition m_indexLoadedCondition;
+    bool m_indexLoaded;
+    bool m_indexLoaderRunning;
+    bool m_indexLoaderStopRequested;
+    // incremented whenever loading starts over, so that a stale load is discarded.
+    unsigned int m_indexGeneration;
+    // thrown to the callers waiting for the index when loading failed.
+    easyhttpcpp::common::BaseException::Ptr m_pIndexLoadError;
+    typedef std::map<std::string, std::list<std::string>::iterator> AccessedKeyMap;
+    std::list<std::string> m_keysAccessedWhileIndexLoading;
+    // positions in m_keysAccessedWhileIndexLoading, so that a key is listed once.
+    AccessedKeyMap m_accessedKeyPositions;
+    std::set<std::string> m_keysRemovedWhileIndexLoading;
 };
 
 } /* namespace easyhttpcpp */
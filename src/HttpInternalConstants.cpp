@@ -9,10 +9,32 @@ namespace easyhttpcpp {
 const char* const HttpInternalConstants::Caches::DataFileExtention = ".data";
 const char* const HttpInternalConstants::Caches::CacheDir = "cache/";
 const char* const HttpInternalConstants::Caches::TempDir = "temp/";
+const char* const HttpInternalConstants::Caches::PartialDir = "partial/";
+const char* const HttpInternalConstants::Caches::PartialInfoFileExtention = ".info";
+const size_t HttpInternalConstants::Caches::MemoryCacheMaxDataSize = 64 * 1024;
+const unsigned int HttpInternalConstants::Caches::DataDirFanOutLevels = 2;
+const size_t HttpInternalConstants::Caches::DataDirNameLength = 2;
+const size_t HttpInternalConstants::Caches::MappedReadMaxSize = 64 * 1024 * 1024;
+const unsigned int HttpInternalConstants::Caches::TinyLfuWindowPercentage = 1;
+const unsigned int HttpInternalConstants::Caches::TinyLfuProtectedPercentage = 80;
+const size_t HttpInternalConstants::Caches::WriterQueueMaxBytes = 4 * 1024 * 1024;
+const size_t HttpInternalConstants::Caches::BodyCompressionMinBytes = 1024;
+const unsigned int HttpInternalConstants::Caches::BodyCompressionMaxPercentage = 90;
 
 const char* const HttpInternalConstants::Database::FileName = "cache_metadata.db";
 const char* const HttpInternalConstants::Database::TableName = "cache_metadata";
-const unsigned int HttpInternalConstants::Database::Version = 1;
+const char* const HttpInternalConstants::Database::PropertiesTableName = "cache_properties";
+const unsigned int HttpInternalConstants::Database::Version = 6;
+const int HttpInternalConstants::Database::CacheSizeKiB = 1024;
+const long long HttpInternalConstants::Database::MmapSize = 4 * 1024 * 1024;
+const unsigned int HttpInternalConstants::Database::BusyTimeoutMs = 3000;
+const unsigned int HttpInternalConstants::Database::LastAccessedSecFlushIntervalSec = 30;
+const size_t HttpInternalConstants::Database::LastAccessedSecFlushMaxPendingCount = 256;
+const size_t HttpInternalConstants::Database::IndexLoadChunkCount = 512;
+const char* const HttpInternalConstants::Database::Property::Name = "name";
+const char* const HttpInternalConstants::Database::Property::Value = "value";
+const char* const HttpInternalConstants::Database::Property::KeyHasherName = "key_hasher_name";
+const char* const HttpInternalConstants::Database::Property::DataDirFanOutLevels = "data_dir_fan_out_levels";
 const char* const HttpInternalConstants::Database::Key::Id = "id";
 const char* const HttpInternalConstants::Database::Key::CacheKey = "cache_key";
 const char* const HttpInternalConstants::Database::Key::Url = "url";
@@ -20,13 +42,45 @@ const char* const HttpInternalConstants::Database::Key::Method = "method";
 const char* const HttpInternalConstants::Database::Key::StatusCode = "status_code";
 const char* const HttpInternalConstants::Database::Key::StatusMessage = "status_message";
 const char* const HttpInternalConstants::Database::Key::ResponseHeaderJson = "response_header_json";
+const char* const HttpInternalConstants::Database::Key::ResponseHeaders = "response_headers";
 const char* const HttpInternalConstants::Database::Key::ResponseBodySize = "response_body_size";
 const char* const HttpInternalConstants::Database::Key::SentRequestAtEpoch = "sent_request_at_epoch";
 const char* const HttpInternalConstants::Database::Key::ReceivedResponseAtEpoch = "received_response_at_epoch";
 const char* const HttpInternalConstants::Database::Key::CreatedAtEpoch = "created_at_epoch";
 const char* const HttpInternalConstants::Database::Key::LastAccessedAtEpoch = "last_accessed_at_epoch";
+const char* const HttpInternalConstants::Database::Key::ResponseDateAtEpoch = "response_date_at_epoch";
+const char* const HttpInternalConstants::Database::Key::ExpiresAtEpoch = "expires_at_epoch";
+const char* const HttpInternalConstants::Database::Key::LastModifiedAtEpoch = "last_modified_at_epoch";
+const char* const HttpInternalConstants::Database::Key::AgeSec = "age_sec";
+const char* const HttpInternalConstants::Database::Key::MaxAgeSec = "max_age_sec";
+const char* const HttpInternalConstants::Database::Key::SMaxAgeSec = "s_max_age_sec";
+const char* const HttpInternalConstants::Database::Key::NoCache = "no_cache";
+const char* const HttpInternalConstants::Database::Key::MustRevalidate = "must_revalidate";
+const char* const HttpInternalConstants::Database::Key::ETag = "etag";
+const char* const HttpInternalConstants::Database::Key::LastModified = "last_modified";
+const char* const HttpInternalConstants::Database::Key::ResponseBody = "response_body";
+const char* const HttpInternalConstants::Database::Key::ResponseBodyCompressed = "response_body_compressed";
 
 const unsigned int HttpInternalConstants::AsyncRequests::DefaultCorePoolSizeOfAsyncThreadPool = 2;
 const unsigned int HttpInternalConstants::AsyncRequests::DefaultMaximumPoolSizeOfAsyncThreadPool = 5;
 
+const unsigned int HttpInternalConstants::Prefetches::DefaultMaxConcurrentPrefetchCount = 1;
+const size_t HttpInternalConstants::Prefetches::ReadBufferBytes = 16 * 1024;
+const long HttpInternalConstants::Prefetches::MaxThrottleSleepMillis = 100;
+
+const unsigned int HttpInternalConstants::RequestCoalescings::DefaultTimeoutMillis = 1000;
+
+const Poco::UInt64 HttpInternalConstants::BackgroundCacheFills::DefaultMaxBytes = 16 * 1024 * 1024;
+const unsigned int HttpInternalConstants::BackgroundCacheFills::DefaultTimeoutSec = 10;
+const size_t HttpInternalConstants::BackgroundCacheFills::ReadBufferBytes = 16 * 1024;
+
+const unsigned int HttpInternalConstants::SegmentedDownloads::DefaultSegmentCount = 4;
+const unsigned int HttpInternalConstants::SegmentedDownloads::DefaultMaxRetryCount = 3;
+const size_t HttpInternalConstants::SegmentedDownloads::ReadBufferBytes = 256 * 1024;
+
+const char* const HttpInternalConstants::ContentEncodings::AcceptEncoding = "gzip, deflate";
+const size_t HttpInternalConstants::ContentEncodings::DecodingBufferBytes = 8192;
+const int HttpInternalConstants::ContentEncodings::DefaultCompressionLevel = 6;
+const size_t HttpInternalConstants::ContentEncodings::MinCompressingBytes = 1024;
+
 } /* namespace easyhttpcpp */
@@ -7,6 +7,8 @@
 
 #include <string>
 
+#include "Poco/Types.h"
+
 #include "easyhttpcpp/HttpExports.h"
 
 namespace easyhttpcpp {
@@ -19,13 +21,48 @@ public:
         static const char* const DataFileExtention;
         static const char* const CacheDir;
         static const char* const TempDir;
+        static const char* const PartialDir;
+        static const char* const PartialInfoFileExtention;
+        static const size_t MemoryCacheMaxDataSize;
+        // response bodies are stored in subdirectories named after the leading characters of the key, so that a
+        // directory does not get too many files.
+        static const unsigned int DataDirFanOutLevels;
+        static const size_t DataDirNameLength;
+        // cached response bodies up to this size are read through a memory mapping.
+        static const size_t MappedReadMaxSize;
+        // W-TinyLFU eviction; percentage of the cache size for the admission window, and of the rest for the
+        // protected segment.
+        static const unsigned int TinyLfuWindowPercentage;
+        static const unsigned int TinyLfuProtectedPercentage;
+        // response body bytes which are queued in memory to be written to cache temp files at most.
+        static const size_t WriterQueueMaxBytes;
+        // response bodies are compressed at rest from this size, and kept compressed only when they shrink to this
+        // percentage or less; a smaller saving is not worth decompressing on every cache hit.
+        static const size_t BodyCompressionMinBytes;
+        static const unsigned int BodyCompressionMaxPercentage;
     };
 
     class EASYHTTPCPP_HTTP_INTERNAL_API Database {
     public:
         static const char* const FileName;
         static const char* const TableName;
+        // name and value pairs of the cache, added in version 4.
+        static const char* const PropertiesTableName;
         static const unsigned int Version;
+        static const int CacheSizeKiB;
+        static const long long MmapSize;
+        static const unsigned int BusyTimeoutMs;
+        static const unsigned int LastAccessedSecFlushIntervalSec;
+        static const size_t LastAccessedSecFlushMaxPendingCount;
+        static const size_t IndexLoadChunkCount;
+
+        class EASYHTTPCPP_HTTP_INTERNAL_API Property {
+        public:
+            static const char* const Name;
+            static const char* const Value;
+            static const char* const KeyHasherName;
+            static const char* const DataDirFanOutLevels;
+        };
 
         class EASYHTTPCPP_HTTP_INTERNAL_API Key {
         public:
@@ -35,12 +72,28 @@ public:
             static const char* const Method;
             static const char* const StatusCode;
             static const char* const StatusMessage;
+            // replaced by ResponseHeaders in version 3; only read to upgrade an older database.
             static const char* const ResponseHeaderJson;
+            static const char* const ResponseHeaders;
             static const char* const ResponseBodySize;
             static const char* const SentRequestAtEpoch;
             static const char* const ReceivedResponseAtEpoch;
             static const char* const CreatedAtEpoch;
             static const char* const LastAccessedAtEpoch;
+            static const char* const ResponseDateAtEpoch;
+            static const char* const ExpiresAtEpoch;
+            static const char* const LastModifiedAtEpoch;
+            static const char* const AgeSec;
+            static const char* const MaxAgeSec;
+            static const char* const SMaxAgeSec;
+            static const char* const NoCache;
+            static const char* const MustRevalidate;
+            static const char* const ETag;
+            static const char* const LastModified;
+            // response body stored in the row, added in version 5. NULL when the body is stored in a file.
+            static const char* const ResponseBody;
+            // 1 when the response body is stored gzip compressed, added in version 6.
+            static const char* const ResponseBodyCompressed;
         };
     };
 
@@ -49,6 +102,41 @@ public:
         static const unsigned int DefaultCorePoolSizeOfAsyncThreadPool;
         static const unsigned int DefaultMaximumPoolSizeOfAsyncThreadPool;
     };
+
+    class EASYHTTPCPP_HTTP_INTERNAL_API Prefetches {
+    public:
+        static const unsigned int DefaultMaxConcurrentPrefetchCount;
+        static const size_t ReadBufferBytes;
+        // a throttled prefetch sleeps at most this long at once, so that it is cancelled without delay.
+        static const long MaxThrottleSleepMillis;
+    };
+
+    class EASYHTTPCPP_HTTP_INTERNAL_API RequestCoalescings {
+    public:
+        static const unsigned int DefaultTimeoutMillis;
+    };
+
+    class EASYHTTPCPP_HTTP_INTERNAL_API BackgroundCacheFills {
+    public:
+        static const Poco::UInt64 DefaultMaxBytes;
+        static const unsigned int DefaultTimeoutSec;
+        static const size_t ReadBufferBytes;
+    };
+
+    class EASYHTTPCPP_HTTP_INTERNAL_API SegmentedDownloads {
+    public:
+        static const unsigned int DefaultSegmentCount;
+        static const unsigned int DefaultMaxRetryCount;
+        static const size_t ReadBufferBytes;
+    };
+
+    class EASYHTTPCPP_HTTP_INTERNAL_API ContentEncodings {
+    public:
+        static const char* const AcceptEncoding;
+        static const size_t DecodingBufferBytes;
+        static const int DefaultCompressionLevel;
+        static const size_t MinCompressingBytes;
+    };
 };
 
 } /* namespace easyhttpcpp */
@@ -42,7 +42,7 @@ bool HttpLruCacheStrategy::remove(const std::string& key)
     LruListMap::Iterator it = m_lruListMap.find(key);
     if (it != m_lruListMap.end()) {
         // check dataRefCount.
-        CacheInfoWithDataSize::Ptr pCacheInfo = *(it->second);
+        CacheInfoWithDataSize::Ptr pCacheInfo = it->second;
         HttpCacheInfo* pHttpCacheInfo = static_cast<HttpCacheInfo*> (pCacheInfo.get());
         if (pHttpCacheInfo->getDataRefCount() > 0) {
             if (!pHttpCacheInfo->isReservedRemove()) {
@@ -72,15 +72,43 @@ bool HttpLruCacheStrategy::clear(bool mayDeleteIfBusy)
     return ret;
 }
 
+bool HttpLruCacheStrategy::addDataRef(const std::string& key)
+{
+    LruListMap::Iterator it = m_lruListMap.find(key);
+    if (it == m_lruListMap.end()) {
+        EASYHTTPCPP_LOG_D(Tag, "addDataRef: not found key. [%s]", key.c_str());
+        return false;
+    }
+    HttpCacheInfo* pHttpCacheInfo = static_cast<HttpCacheInfo*> (it->second.get());
+    pHttpCacheInfo->addDataRef();
+    return true;
+}
+
+bool HttpLruCacheStrategy::releaseDataRef(const std::string& key)
+{
+    LruListMap::Iterator it = m_lruListMap.find(key);
+    if (it == m_lruListMap.end()) {
+        EASYHTTPCPP_LOG_D(Tag, "releaseDataRef: not found key. [%s]", key.c_str());
+        return false;
+    }
+    HttpCacheInfo* pHttpCacheInfo = static_cast<HttpCacheInfo*> (it->second.get());
+    pHttpCacheInfo->releaseDataRef();
+    // check reserved remove.
+    if (pHttpCacheInfo->getDataRefCount() == 0 && pHttpCacheInfo->isReservedRemove()) {
+        EASYHTTPCPP_LOG_D(Tag, "releaseDataRef: remove reserved cache. key=[%s]", key.c_str());
+        return LruCacheByDataSizeStrategy::remove(key);
+    }
+    return true;
+}
+
 bool HttpLruCacheStrategy::createRemoveList(LruKeyList& keys, bool mayDeleteIfBusy)
 {
     bool ret = true;
-    for (LruList::const_iterator it = m_lruList.begin(); it != m_lruList.end(); it++) {
-        CacheInfoWithDataSize::Ptr pCacheInfo = *it;
+    for (CacheInfoWithDataSize* pCacheInfo = m_pNewest; pCacheInfo != NULL; pCacheInfo = pCacheInfo->getOlder()) {
         if (mayDeleteIfBusy) {
             keys.push_back(pCacheInfo->getKey());
         } else {
-            HttpCacheInfo* pHttpCacheInfo = static_cast<HttpCacheInfo*> (pCacheInfo.get());
+            HttpCacheInfo* pHttpCacheInfo = static_cast<HttpCacheInfo*> (pCacheInfo);
             if (pHttpCacheInfo->getDataRefCount() == 0) {
                 keys.push_back(pCacheInfo->getKey());
             } else {
@@ -94,13 +122,12 @@ bool HttpLruCacheStrategy::createRemoveList(LruKeyList& keys, bool mayDeleteIfBu
 bool HttpLruCacheStrategy::createRemoveLruDataList(LruKeyList& keys, size_t removeSize)
 {
     size_t targetSize = 0;
-    LruList::reverse_iterator it = m_lruList.rbegin();
+    CacheInfoWithDataSize* pCacheInfo = m_pOldest;
     while (targetSize < removeSize) {
-        if (it == m_lruList.rend()) {
+        if (pCacheInfo == NULL) {
             return false;
         }
-        CacheInfoWithDataSize::Ptr pCacheInfo = *it;
-        HttpCacheInfo* pHttpCacheInfo = static_cast<HttpCacheInfo*> (pCacheInfo.get());
+        HttpCacheInfo* pHttpCacheInfo = static_cast<HttpCacheInfo*> (pCacheInfo);
         if (pHttpCacheInfo->getDataRefCount() == 0) {
             keys.push_front(pCacheInfo->getKey());
             targetSize += pCacheInfo->getDataSize();
@@ -108,7 +135,7 @@ bool HttpLruCacheStrategy::createRemoveLruDataList(LruKeyList& keys, size_t remo
                     pCacheInfo->getKey().c_str());
         }
 
-        ++it;
+        pCacheInfo = pCacheInfo->getNewer();
     }
     return true;
 }
@@ -120,4 +147,9 @@ CacheInfoWithDataSize::Ptr HttpLruCacheStrategy::newCacheInfo(CacheInfoWithDataS
     return pNewCacheInfo;
 }
 
+void HttpLruCacheStrategy::copyCacheInfo(CacheInfoWithDataSize& destination, const CacheInfoWithDataSize& source)
+{
+    static_cast<HttpCacheInfo&>(destination) = static_cast<const HttpCacheInfo&>(source);
+}
+
 } /* namespace easyhttpcpp */
@@ -5,6 +5,8 @@
 #ifndef EASYHTTPCPP_HTTPLRUCACHESTRATEGY_H_INCLUDED
 #define EASYHTTPCPP_HTTPLRUCACHESTRATEGY_H_INCLUDED
 
+#include "Poco/AutoPtr.h"
+
 #include "easyhttpcpp/common/LruCacheByDataSizeStrategy.h"
 #include "easyhttpcpp/HttpExports.h"
 
@@ -12,6 +14,8 @@ namespace easyhttpcpp {
 
 class EASYHTTPCPP_HTTP_INTERNAL_API HttpLruCacheStrategy : public easyhttpcpp::common::LruCacheByDataSizeStrategy {
 public:
+    typedef Poco::AutoPtr<HttpLruCacheStrategy> Ptr;
+
     HttpLruCacheStrategy(size_t maxSize);
     virtual ~HttpLruCacheStrategy();
 
@@ -19,11 +23,21 @@ public:
     virtual bool remove(const std::string& key);
     virtual bool clear(bool mayDeleteIfBusy);
 
+    /**
+     * Adds or releases a data reference of the kept entry in place. An entry with a data reference is not evicted.
+     * When the last reference is released and removing the entry is reserved, the entry is removed.
+     * @return false if not found.
+     */
+    bool addDataRef(const std::string& key);
+    bool releaseDataRef(const std::string& key);
+
 protected:
     virtual bool createRemoveList(LruKeyList& keys, bool mayDeleteIfBusy);
     virtual bool createRemoveLruDataList(LruKeyList& keys, size_t removeSize);
     virtual easyhttpcpp::common::CacheInfoWithDataSize::Ptr newCacheInfo(
             easyhttpcpp::common::CacheInfoWithDataSize::Ptr pCacheInfo);
+    virtual void copyCacheInfo(easyhttpcpp::common::CacheInfoWithDataSize& destination,
+            const easyhttpcpp::common::CacheInfoWithDataSize& source);
 
 private:
     HttpLruCacheStrategy();
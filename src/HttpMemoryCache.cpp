@@ -0,0 +1,219 @@
+/*
+ * Copyright 2019 Sony Corporation
+ */
+
+#include "easyhttpcpp/common/CoreLogger.h"
+
+#include "ByteArrayBufferInputStream.h"
+#include "HttpMemoryCache.h"
+
+using easyhttpcpp::common::ByteArrayBuffer;
+using easyhttpcpp::common::CacheInfoWithDataSize;
+using easyhttpcpp::common::CacheMetadata;
+using easyhttpcpp::common::LruCacheByDataSizeStrategy;
+
+namespace easyhttpcpp {
+
+static const std::string Tag = "HttpMemoryCache";
+
+HttpMemoryCache::HttpMemoryCache(size_t maxSize, size_t maxDataSize) : m_maxDataSize(maxDataSize)
+{
+    m_lruCacheStrategy = new LruCacheByDataSizeStrategy(maxSize);
+    m_lruCacheStrategy->setListener(this);
+}
+
+HttpMemoryCache::~HttpMemoryCache()
+{
+    m_lruCacheStrategy->setListener(NULL);
+}
+
+bool HttpMemoryCache::getMetadata(const std::string& key, CacheMetadata::Ptr& pCacheMetadata)
+{
+    Poco::FastMutex::ScopedLock lock(m_instanceMutex);
+
+    EntryMap::Iterator it = m_entries.find(key);
+    if (it == m_entries.end() || m_lruCacheStrategy->getView(key) == NULL) {
+        EASYHTTPCPP_LOG_D(Tag, "getMetadata : [%s] not found in cache.", key.c_str());
+        return false;
+    }
+    pCacheMetadata = copyMetadata(it->second.m_pMetadata);
+    EASYHTTPCPP_LOG_D(Tag, "getMetadata : [%s] succeeded.", key.c_str());
+    return true;
+}
+
+bool HttpMemoryCache::getData(const std::string& key, std::istream*& pStream)
+{
+    Poco::FastMutex::ScopedLock lock(m_instanceMutex);
+
+    EntryMap::Iterator it = m_entries.find(key);
+    if (it == m_entries.end() || m_lruCacheStrategy->getView(key) == NULL) {
+        EASYHTTPCPP_LOG_D(Tag, "getData : [%s] not found in cache.", key.c_str());
+        return false;
+    }
+    pStream = new ByteArrayBufferInputStream(it->second.m_pData);
+    EASYHTTPCPP_LOG_D(Tag, "getData : [%s] succeeded.", key.c_str());
+    return true;
+}
+
+bool HttpMemoryCache::get(const std::string& key, CacheMetadata::Ptr& pCacheMetadata, std::istream*& pStream)
+{
+    Poco::FastMutex::ScopedLock lock(m_instanceMutex);
+
+    EntryMap::Iterator it = m_entries.find(key);
+    if (it == m_entries.end() || m_lruCacheStrategy->getView(key) == NULL) {
+        EASYHTTPCPP_LOG_D(Tag, "get : [%s] not found in cache.", key.c_str());
+        return false;
+    }
+    pCacheMetadata = copyMetadata(it->second.m_pMetadata);
+    pStream = new ByteArrayBufferInputStream(it->second.m_pData);
+    EASYHTTPCPP_LOG_D(Tag, "get : [%s] succeeded.", key.c_str());
+    return true;
+}
+
+bool HttpMemoryCache::putMetadata(const std::string& key, CacheMetadata::Ptr pCacheMetadata)
+{
+    Poco::FastMutex::ScopedLock lock(m_instanceMutex);
+
+    EntryMap::Iterator it = m_entries.find(key);
+    if (it == m_entries.end()) {
+        EASYHTTPCPP_LOG_D(Tag, "putMetadata : not found in cache [%s]", key.c_str());
+        return false;
+    }
+    it->second.m_pMetadata = copyMetadata(pCacheMetadata);
+    CacheInfoWithDataSize::Ptr pCacheInfo = new CacheInfoWithDataSize(key, getEntrySize(key, it->second));
+    if (!m_lruCacheStrategy->update(key, pCacheInfo)) {
+        EASYHTTPCPP_LOG_D(Tag, "putMetadata : [%s] can not make cache space.", key.c_str());
+        m_lruCacheStrategy->remove(key);
+        return false;
+    }
+    return true;
+}
+
+bool HttpMemoryCache::put(const std::string& key, CacheMetadata::Ptr pCacheMetadata, const std::string& path)
+{
+    Poco::FastMutex::ScopedLock lock(m_instanceMutex);
+
+    // the old entry must not hide the new one put to L2 cache.
+    if (m_entries.find(key) != m_entries.end()) {
+        m_lruCacheStrategy->remove(key);
+    }
+    EASYHTTPCPP_LOG_D(Tag, "put : [%s] file is not held in memory.", key.c_str());
+    return false;
+}
+
+bool HttpMemoryCache::put(const std::string& key, CacheMetadata::Ptr pCacheMetadata,
+        Poco::SharedPtr<ByteArrayBuffer> pData)
+{
+    Poco::FastMutex::ScopedLock lock(m_instanceMutex);
+
+    if (m_entries.find(key) != m_entries.end()) {
+        m_lruCacheStrategy->remove(key);
+    }
+    if (!pCacheMetadata || !pData) {
+        EASYHTTPCPP_LOG_D(Tag, "put : [%s] metadata or data is NULL.", key.c_str());
+        return false;
+    }
+    if (pData->getWrittenDataSize() > m_maxDataSize) {
+        EASYHTTPCPP_LOG_D(Tag, "put : [%s] data is too large. [%zu bytes]", key.c_str(),
+                pData->getWrittenDataSize());
+        return false;
+    }
+
+    Entry entry;
+    entry.m_pMetadata = copyMetadata(pCacheMetadata);
+    entry.m_pData = pData;
+    m_entries[key] = entry;
+    CacheInfoWithDataSize::Ptr pCacheInfo = new CacheInfoWithDataSize(key, getEntrySize(key, entry));
+    if (!m_lruCacheStrategy->add(key, pCacheInfo)) {
+        EASYHTTPCPP_LOG_D(Tag, "put : [%s] can not make cache space.", key.c_str());
+        m_entries.erase(key);
+        return false;
+    }
+    EASYHTTPCPP_LOG_D(Tag, "put : [%s] succeeded.", key.c_str());
+    return true;
+}
+
+bool HttpMemoryCache::remove(const std::string& key)
+{
+    Poco::FastMutex::ScopedLock lock(m_instanceMutex);
+
+    return m_lruCacheStrategy->remove(key);
+}
+
+void HttpMemoryCache::releaseData(const std::string& key)
+{
+    // streams hold the data by themselves.
+}
+
+bool HttpMemoryCache::purge(bool mayDeleteIfBusy)
+{
+    Poco::FastMutex::ScopedLock lock(m_instanceMutex);
+
+    m_lruCacheStrategy->clear(true);
+    m_entries.clear();
+    return true;
+}
+
+size_t HttpMemoryCache::getSize()
+{
+    Poco::FastMutex::ScopedLock lock(m_instanceMutex);
+
+    return m_lruCacheStrategy->getTotalSize();
+}
+
+size_t HttpMemoryCache::getMaxDataSize() const
+{
+    return m_maxDataSize;
+}
+
+bool HttpMemoryCache::onAdd(const std::string& key, CacheInfoWithDataSize::Ptr value)
+{
+    return true;
+}
+
+bool HttpMemoryCache::onUpdate(const std::string& key, CacheInfoWithDataSize::Ptr value)
+{
+    return true;
+}
+
+bool HttpMemoryCache::onRemove(const std::string& key)
+{
+    m_entries.erase(key);
+    return true;
+}
+
+bool HttpMemoryCache::onGet(const std::string& key, CacheInfoWithDataSize::Ptr value)
+{
+    return true;
+}
+
+HttpCacheMetadata::Ptr HttpMemoryCache::copyMetadata(CacheMetadata::Ptr pCacheMetadata)
+{
+    // callers modify metadata they got, so the held one is never handed out.
+    HttpCacheMetadata* pSource = static_cast<HttpCacheMetadata*>(pCacheMetadata.get());
+    HttpCacheMetadata::Ptr pCopy = new HttpCacheMetadata();
+    pCopy->setKey(pSource->getKey());
+    pCopy->setUrl(pSource->getUrl());
+    pCopy->setHttpMethod(pSource->getHttpMethod());
+    pCopy->setStatusCode(pSource->getStatusCode());
+    pCopy->setStatusMessage(pSource->getStatusMessage());
+    // the held metadata keeps the headers encoded, so that a hit copies a string instead of the headers map and
+    // the headers are decoded only by the caller which uses them.
+    pCopy->setEncodedResponseHeaders(pSource->getEncodedResponseHeaders());
+    // freshness is not modified after it is parsed, so it is shared.
+    pCopy->setFreshness(pSource->getFreshness());
+    pCopy->setResponseBodySize(pSource->getResponseBodySize());
+    pCopy->setResponseBodyCompressed(pSource->isResponseBodyCompressed());
+    pCopy->setSentRequestAtEpoch(pSource->getSentRequestAtEpoch());
+    pCopy->setReceivedResponseAtEpoch(pSource->getReceivedResponseAtEpoch());
+    pCopy->setCreatedAtEpoch(pSource->getCreatedAtEpoch());
+    return pCopy;
+}
+
+size_t HttpMemoryCache::getEntrySize(const std::string& key, const Entry& entry)
+{
+    return key.size() + entry.m_pData->getWrittenDataSize() + entry.m_pMetadata->getUrl().size() +
+            entry.m_pMetadata->getStatusMessage().size() + entry.m_pMetadata->getEncodedResponseHeaders().size();
+}
+
+} /* namespace easyhttpcpp */
@@ -0,0 +1,74 @@
+/*
+ * Copyright 2019 Sony Corporation
+ */
+
+#ifndef EASYHTTPCPP_HTTPMEMORYCACHE_H_INCLUDED
+#define EASYHTTPCPP_HTTPMEMORYCACHE_H_INCLUDED
+
+#include <string>
+
+#include "Poco/HashMap.h"
+#include "Poco/Mutex.h"
+#include "Poco/SharedPtr.h"
+
+#include "easyhttpcpp/common/ByteArrayBuffer.h"
+#include "easyhttpcpp/common/Cache.h"
+#include "easyhttpcpp/common/CacheMetadata.h"
+#include "easyhttpcpp/common/CacheStrategyListener.h"
+#include "easyhttpcpp/common/LruCacheByDataSizeStrategy.h"
+#include "easyhttpcpp/HttpExports.h"
+
+#include "HttpCacheMetadata.h"
+
+namespace easyhttpcpp {
+
+/**
+ * L1 cache which holds HttpCacheMetadata and response bodies in memory. An entry is stored only by
+ * put(ByteArrayBuffer); put(path) just drops the old entry because the L2 cache takes the file.
+ */
+class EASYHTTPCPP_HTTP_INTERNAL_API HttpMemoryCache : public easyhttpcpp::common::Cache,
+public easyhttpcpp::common::CacheStrategyListener<std::string, easyhttpcpp::common::CacheInfoWithDataSize::Ptr> {
+public:
+    HttpMemoryCache(size_t maxSize, size_t maxDataSize);
+    virtual ~HttpMemoryCache();
+    virtual bool getMetadata(const std::string& key, easyhttpcpp::common::CacheMetadata::Ptr& pCacheMetadata);
+    virtual bool getData(const std::string& key, std::istream*& pStream);
+    virtual bool get(const std::string& key, easyhttpcpp::common::CacheMetadata::Ptr& pCacheMetadata,
+            std::istream*& pStream);
+    virtual bool putMetadata(const std::string& key, easyhttpcpp::common::CacheMetadata::Ptr pCacheMetadata);
+    virtual bool put(const std::string& key, easyhttpcpp::common::CacheMetadata::Ptr pCacheMetadata,
+            const std::string& path);
+    virtual bool put(const std::string& key, easyhttpcpp::common::CacheMetadata::Ptr pCacheMetadata,
+            Poco::SharedPtr<easyhttpcpp::common::ByteArrayBuffer> pData);
+    virtual bool remove(const std::string& key);
+    virtual void releaseData(const std::string& key);
+    virtual bool purge(bool mayDeleteIfBusy);
+
+    size_t getSize();
+    size_t getMaxDataSize() const;
+
+    virtual bool onAdd(const std::string& key, easyhttpcpp::common::CacheInfoWithDataSize::Ptr value);
+    virtual bool onUpdate(const std::string& key, easyhttpcpp::common::CacheInfoWithDataSize::Ptr value);
+    virtual bool onRemove(const std::string& key);
+    virtual bool onGet(const std::string& key, easyhttpcpp::common::CacheInfoWithDataSize::Ptr value);
+
+private:
+    class Entry {
+    public:
+        HttpCacheMetadata::Ptr m_pMetadata;
+        Poco::SharedPtr<easyhttpcpp::common::ByteArrayBuffer> m_pData;
+    };
+    typedef Poco::HashMap<std::string, Entry> EntryMap;
+
+    static HttpCacheMetadata::Ptr copyMetadata(easyhttpcpp::common::CacheMetadata::Ptr pCacheMetadata);
+    static size_t getEntrySize(const std::string& key, const Entry& entry);
+
+    Poco::FastMutex m_instanceMutex;
+    size_t m_maxDataSize;
+    EntryMap m_entries;
+    easyhttpcpp::common::LruCacheByDataSizeStrategy::Ptr m_lruCacheStrategy;
+};
+
+} /* namespace easyhttpcpp */
+
+#endif /* EASYHTTPCPP_HTTPMEMORYCACHE_H_INCLUDED */
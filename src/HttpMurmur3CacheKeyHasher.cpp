@@ -0,0 +1,161 @@
+/*
+ * Copyright 2019 Sony Corporation
+ */
+
+#include "Poco/Types.h"
+
+#include "HttpMurmur3CacheKeyHasher.h"
+
+namespace easyhttpcpp {
+
+const std::string HttpMurmur3CacheKeyHasher::Name = "murmur3-x64-128";
+
+namespace {
+
+const Poco::UInt64 C1 = 0x87c37b91114253d5ULL;
+const Poco::UInt64 C2 = 0x4cf5ad432745937fULL;
+
+// two characters per byte, so that a byte is encoded by one lookup.
+const char HexPairs[] =
+        "000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f"
+        "202122232425262728292a2b2c2d2e2f303132333435363738393a3b3c3d3e3f"
+        "404142434445464748494a4b4c4d4e4f505152535455565758595a5b5c5d5e5f"
+        "606162636465666768696a6b6c6d6e6f707172737475767778797a7b7c7d7e7f"
+        "808182838485868788898a8b8c8d8e8f909192939495969798999a9b9c9d9e9f"
+        "a0a1a2a3a4a5a6a7a8a9aaabacadaeafb0b1b2b3b4b5b6b7b8b9babbbcbdbebf"
+        "c0c1c2c3c4c5c6c7c8c9cacbcccdcecfd0d1d2d3d4d5d6d7d8d9dadbdcdddedf"
+        "e0e1e2e3e4e5e6e7e8e9eaebecedeeeff0f1f2f3f4f5f6f7f8f9fafbfcfdfeff";
+
+inline Poco::UInt64 rotl64(Poco::UInt64 x, int r)
+{
+    return (x << r) | (x >> (64 - r));
+}
+
+inline Poco::UInt64 fmix64(Poco::UInt64 k)
+{
+    k ^= k >> 33;
+    k *= 0xff51afd7ed558ccdULL;
+    k ^= k >> 33;
+    k *= 0xc4ceb9fe1a85ec53ULL;
+    k ^= k >> 33;
+    return k;
+}
+
+// little endian regardless of the platform, so that the same url gets the same key everywhere.
+inline Poco::UInt64 load64(const unsigned char* p)
+{
+    Poco::UInt64 value = 0;
+    for (int i = 7; i >= 0; i--) {
+        value = (value << 8) | p[i];
+    }
+    return value;
+}
+
+void appendHex(Poco::UInt64 value, std::string& out)
+{
+    for (int shift = 56; shift >= 0; shift -= 8) {
+        const char* pPair = HexPairs + ((value >> shift) & 0xff) * 2;
+        out.append(pPair, 2);
+    }
+}
+
+} /* namespace */
+
+HttpMurmur3CacheKeyHasher::HttpMurmur3CacheKeyHasher()
+{
+}
+
+HttpMurmur3CacheKeyHasher::~HttpMurmur3CacheKeyHasher()
+{
+}
+
+const std::string& HttpMurmur3CacheKeyHasher::getName() const
+{
+    return Name;
+}
+
+std::string HttpMurmur3CacheKeyHasher::hash(const std::string& data)
+{
+    return hashToHex(data);
+}
+
+std::string HttpMurmur3CacheKeyHasher::hashToHex(const std::string& data)
+{
+    const unsigned char* pData = reinterpret_cast<const unsigned char*>(data.data());
+    const size_t length = data.size();
+    const size_t blockCount = length / 16;
+
+    Poco::UInt64 h1 = 0;
+    Poco::UInt64 h2 = 0;
+
+    for (size_t i = 0; i < blockCount; i++) {
+        Poco::UInt64 k1 = load64(pData + i * 16);
+        Poco::UInt64 k2 = load64(pData + i * 16 + 8);
+
+        k1 *= C1;
+        k1 = rotl64(k1, 31);
+        k1 *= C2;
+        h1 ^= k1;
+        h1 = rotl64(h1, 27);
+        h1 += h2;
+        h1 = h1 * 5 + 0x52dce729;
+
+        k2 *= C2;
+        k2 = rotl64(k2, 33);
+        k2 *= C1;
+        h2 ^= k2;
+        h2 = rotl64(h2, 31);
+        h2 += h1;
+        h2 = h2 * 5 + 0x38495ab5;
+    }
+
+    const unsigned char* pTail = pData + blockCount * 16;
+    Poco::UInt64 k1 = 0;
+    Poco::UInt64 k2 = 0;
+    switch (length & 15) {
+    case 15: k2 ^= static_cast<Poco::UInt64>(pTail[14]) << 48;
+    case 14: k2 ^= static_cast<Poco::UInt64>(pTail[13]) << 40;
+    case 13: k2 ^= static_cast<Poco::UInt64>(pTail[12]) << 32;
+    case 12: k2 ^= static_cast<Poco::UInt64>(pTail[11]) << 24;
+    case 11: k2 ^= static_cast<Poco::UInt64>(pTail[10]) << 16;
+    case 10: k2 ^= static_cast<Poco::UInt64>(pTail[9]) << 8;
+    case 9:
+        k2 ^= static_cast<Poco::UInt64>(pTail[8]);
+        k2 *= C2;
+        k2 = rotl64(k2, 33);
+        k2 *= C1;
+        h2 ^= k2;
+    case 8: k1 ^= static_cast<Poco::UInt64>(pTail[7]) << 56;
+    case 7: k1 ^= static_cast<Poco::UInt64>(pTail[6]) << 48;
+    case 6: k1 ^= static_cast<Poco::UInt64>(pTail[5]) << 40;
+    case 5: k1 ^= static_cast<Poco::UInt64>(pTail[4]) << 32;
+    case 4: k1 ^= static_cast<Poco::UInt64>(pTail[3]) << 24;
+    case 3: k1 ^= static_cast<Poco::UInt64>(pTail[2]) << 16;
+    case 2: k1 ^= static_cast<Poco::UInt64>(pTail[1]) << 8;
+    case 1:
+        k1 ^= static_cast<Poco::UInt64>(pTail[0]);
+        k1 *= C1;
+        k1 = rotl64(k1, 31);
+        k1 *= C2;
+        h1 ^= k1;
+    default:
+        break;
+    }
+
+    h1 ^= static_cast<Poco::UInt64>(length);
+    h2 ^= static_cast<Poco::UInt64>(length);
+    h1 += h2;
+    h2 += h1;
+    h1 = fmix64(h1);
+    h2 = fmix64(h2);
+    h1 += h2;
+    h2 += h1;
+
+    std::string hex;
+    hex.reserve(32);
+    appendHex(h1, hex);
+    appendHex(h2, hex);
+    return hex;
+}
+
+} /* namespace easyhttpcpp */
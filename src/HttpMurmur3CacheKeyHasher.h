@@ -0,0 +1,33 @@
+/*
+ * Copyright 2019 Sony Corporation
+ */
+
+#ifndef EASYHTTPCPP_HTTPMURMUR3CACHEKEYHASHER_H_INCLUDED
+#define EASYHTTPCPP_HTTPMURMUR3CACHEKEYHASHER_H_INCLUDED
+
+#include <string>
+
+#include "easyhttpcpp/HttpCacheKeyHasher.h"
+#include "easyhttpcpp/HttpExports.h"
+
+namespace easyhttpcpp {
+
+/**
+ * Makes the key with MurmurHash3 (x64, 128-bit), which is much faster than a message digest for short urls.
+ */
+class EASYHTTPCPP_HTTP_INTERNAL_API HttpMurmur3CacheKeyHasher : public HttpCacheKeyHasher {
+public:
+    HttpMurmur3CacheKeyHasher();
+    virtual ~HttpMurmur3CacheKeyHasher();
+
+    virtual const std::string& getName() const;
+    virtual std::string hash(const std::string& data);
+
+    static std::string hashToHex(const std::string& data);
+
+    static const std::string Name;
+};
+
+} /* namespace easyhttpcpp */
+
+#endif /* EASYHTTPCPP_HTTPMURMUR3CACHEKEYHASHER_H_INCLUDED */
@@ -0,0 +1,45 @@
+/*
+ * Copyright 2019 Sony Corporation
+ */
+
+#include "HttpPartialContent.h"
+
+namespace easyhttpcpp {
+
+HttpPartialContent::HttpPartialContent(const std::string& key, const std::string& dataFilePath,
+        Poco::UInt64 storedBytes, Poco::UInt64 completeLength, const std::string& validator) : m_key(key),
+        m_dataFilePath(dataFilePath), m_storedBytes(storedBytes), m_completeLength(completeLength),
+        m_validator(validator)
+{
+}
+
+HttpPartialContent::~HttpPartialContent()
+{
+}
+
+const std::string& HttpPartialContent::getKey() const
+{
+    return m_key;
+}
+
+const std::string& HttpPartialContent::getDataFilePath() const
+{
+    return m_dataFilePath;
+}
+
+Poco::UInt64 HttpPartialContent::getStoredBytes() const
+{
+    return m_storedBytes;
+}
+
+Poco::UInt64 HttpPartialContent::getCompleteLength() const
+{
+    return m_completeLength;
+}
+
+const std::string& HttpPartialContent::getValidator() const
+{
+    return m_validator;
+}
+
+} /* namespace easyhttpcpp */
@@ -0,0 +1,44 @@
+/*
+ * Copyright 2019 Sony Corporation
+ */
+
+#ifndef EASYHTTPCPP_HTTPPARTIALCONTENT_H_INCLUDED
+#define EASYHTTPCPP_HTTPPARTIALCONTENT_H_INCLUDED
+
+#include <string>
+
+#include "Poco/AutoPtr.h"
+#include "Poco/RefCountedObject.h"
+#include "Poco/Types.h"
+
+#include "easyhttpcpp/HttpExports.h"
+
+namespace easyhttpcpp {
+
+// the prefix of a response body whose download was interrupted.
+class EASYHTTPCPP_HTTP_INTERNAL_API HttpPartialContent : public Poco::RefCountedObject {
+public:
+    typedef Poco::AutoPtr<HttpPartialContent> Ptr;
+
+    HttpPartialContent(const std::string& key, const std::string& dataFilePath, Poco::UInt64 storedBytes,
+            Poco::UInt64 completeLength, const std::string& validator);
+    virtual ~HttpPartialContent();
+
+    const std::string& getKey() const;
+    const std::string& getDataFilePath() const;
+    Poco::UInt64 getStoredBytes() const;
+    Poco::UInt64 getCompleteLength() const;
+    // strong ETag or Last-Modified of the response, sent as If-Range.
+    const std::string& getValidator() const;
+
+private:
+    std::string m_key;
+    std::string m_dataFilePath;
+    Poco::UInt64 m_storedBytes;
+    Poco::UInt64 m_completeLength;
+    std::string m_validator;
+};
+
+} /* namespace easyhttpcpp */
+
+#endif /* EASYHTTPCPP_HTTPPARTIALCONTENT_H_INCLUDED */
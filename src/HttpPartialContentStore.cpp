@@ -0,0 +1,220 @@
+/*
+ * Copyright 2019 Sony Corporation
+ */
+
+#include <algorithm>
+#include <vector>
+
+#include "Poco/Exception.h"
+#include "Poco/File.h"
+#include "Poco/FileStream.h"
+#include "Poco/NumberParser.h"
+
+#include "easyhttpcpp/common/CoreLogger.h"
+#include "easyhttpcpp/common/FileUtil.h"
+
+#include "HttpInternalConstants.h"
+#include "HttpPartialContentStore.h"
+
+using easyhttpcpp::common::FileUtil;
+
+namespace easyhttpcpp {
+
+static const std::string Tag = "HttpPartialContentStore";
+
+namespace {
+
+bool isOlderThan(const Poco::File& lhs, const Poco::File& rhs)
+{
+    return lhs.getLastModified() < rhs.getLastModified();
+}
+
+} /* namespace */
+
+HttpPartialContentStore::HttpPartialContentStore(const Poco::Path& partialDir, Poco::UInt64 maxSize) :
+        m_partialDir(partialDir), m_maxSize(maxSize)
+{
+}
+
+HttpPartialContentStore::~HttpPartialContentStore()
+{
+}
+
+HttpPartialContent::Ptr HttpPartialContentStore::get(const std::string& key, const std::string& url)
+{
+    Poco::FastMutex::ScopedLock lock(m_mutex);
+
+    std::string dataFilePath = makeDataFilePath(key);
+    try {
+        Poco::File dataFile(dataFilePath);
+        if (!dataFile.exists()) {
+            return NULL;
+        }
+        Poco::UInt64 completeLength = 0;
+        std::string validator;
+        std::string storedUrl;
+        Poco::UInt64 storedBytes = dataFile.getSize();
+        if (!readInfo(key, completeLength, validator, storedUrl) || storedBytes == 0 ||
+                storedBytes >= completeLength) {
+            EASYHTTPCPP_LOG_D(Tag, "get: broken partial content. [%s]", key.c_str());
+            removeInternal(key);
+            return NULL;
+        }
+        if (storedUrl != url) {
+            EASYHTTPCPP_LOG_D(Tag, "get: partial content of another url has the same key. [%s]", key.c_str());
+            return NULL;
+        }
+        return new HttpPartialContent(key, dataFilePath, storedBytes, completeLength, validator);
+    } catch (const Poco::Exception& e) {
+        EASYHTTPCPP_LOG_D(Tag, "get: can not read partial content. [%s] %s", key.c_str(), e.message().c_str());
+        removeInternal(key);
+        return NULL;
+    }
+}
+
+bool HttpPartialContentStore::put(const std::string& key, const std::string& url,
+        const std::string& sourceFilePath, Poco::UInt64 completeLength, const std::string& validator)
+{
+    Poco::FastMutex::ScopedLock lock(m_mutex);
+
+    if (completeLength > m_maxSize || validator.empty()) {
+        return false;
+    }
+    try {
+        if (!FileUtil::createDirsIfAbsent(Poco::File(m_partialDir))) {
+            EASYHTTPCPP_LOG_D(Tag, "put: can not create partial content directory.");
+            return false;
+        }
+        removeInternal(key);
+        trimToSize(Poco::File(sourceFilePath).getSize());
+
+        if (!FileUtil::moveFile(Poco::File(sourceFilePath), Poco::File(makeDataFilePath(key)))) {
+            EASYHTTPCPP_LOG_D(Tag, "put: can not move partial content. [%s]", key.c_str());
+            return false;
+        }
+        Poco::FileOutputStream infoStream(makeInfoFilePath(key), std::ios::out | std::ios::trunc);
+        infoStream << completeLength << "\n" << validator << "\n" << url << "\n";
+        infoStream.close();
+        if (!infoStream.good()) {
+            EASYHTTPCPP_LOG_D(Tag, "put: can not write partial content info. [%s]", key.c_str());
+            removeInternal(key);
+            return false;
+        }
+    } catch (const Poco::Exception& e) {
+        EASYHTTPCPP_LOG_D(Tag, "put: can not store partial content. [%s] %s", key.c_str(), e.message().c_str());
+        removeInternal(key);
+        return false;
+    }
+    return true;
+}
+
+bool HttpPartialContentStore::take(HttpPartialContent::Ptr pPartialContent, const std::string& destinationFilePath)
+{
+    Poco::FastMutex::ScopedLock lock(m_mutex);
+
+    const std::string& key = pPartialContent->getKey();
+    try {
+        Poco::File dataFile(makeDataFilePath(key));
+        if (!dataFile.exists() || dataFile.getSize() != pPartialContent->getStoredBytes()) {
+            EASYHTTPCPP_LOG_D(Tag, "take: partial content has changed. [%s]", key.c_str());
+            return false;
+        }
+        if (!FileUtil::moveFile(dataFile, Poco::File(destinationFilePath))) {
+            EASYHTTPCPP_LOG_D(Tag, "take: can not move partial content. [%s]", key.c_str());
+            return false;
+        }
+    } catch (const Poco::Exception& e) {
+        EASYHTTPCPP_LOG_D(Tag, "take: can not take partial content. [%s] %s", key.c_str(), e.message().c_str());
+        return false;
+    }
+    removeInternal(key);
+    return true;
+}
+
+void HttpPartialContentStore::remove(const std::string& key, const std::string& url)
+{
+    Poco::FastMutex::ScopedLock lock(m_mutex);
+
+    Poco::UInt64 completeLength = 0;
+    std::string validator;
+    std::string storedUrl;
+    try {
+        if (readInfo(key, completeLength, validator, storedUrl) && storedUrl != url) {
+            EASYHTTPCPP_LOG_D(Tag, "remove: partial content of another url has the same key. [%s]", key.c_str());
+            return;
+        }
+    } catch (const Poco::Exception& e) {
+        EASYHTTPCPP_LOG_D(Tag, "remove: can not read partial content. [%s] %s", key.c_str(), e.message().c_str());
+    }
+    removeInternal(key);
+}
+
+bool HttpPartialContentStore::removeAll()
+{
+    Poco::FastMutex::ScopedLock lock(m_mutex);
+
+    return FileUtil::removeDirsIfPresent(m_partialDir);
+}
+
+std::string HttpPartialContentStore::makeDataFilePath(const std::string& key) const
+{
+    return Poco::Path(m_partialDir, key + HttpInternalConstants::Caches::DataFileExtention).toString();
+}
+
+std::string HttpPartialContentStore::makeInfoFilePath(const std::string& key) const
+{
+    return Poco::Path(m_partialDir, key + HttpInternalConstants::Caches::PartialInfoFileExtention).toString();
+}
+
+bool HttpPartialContentStore::readInfo(const std::string& key, Poco::UInt64& completeLength, std::string& validator,
+        std::string& url)
+{
+    Poco::File infoFile(makeInfoFilePath(key));
+    if (!infoFile.exists()) {
+        return false;
+    }
+    Poco::FileInputStream infoStream(infoFile.path());
+    std::string completeLengthStr;
+    std::getline(infoStream, completeLengthStr);
+    std::getline(infoStream, validator);
+    std::getline(infoStream, url);
+    return Poco::NumberParser::tryParseUnsigned64(completeLengthStr, completeLength) && !validator.empty() &&
+            !url.empty();
+}
+
+void HttpPartialContentStore::removeInternal(const std::string& key)
+{
+    FileUtil::removeFileIfPresent(Poco::File(makeDataFilePath(key)));
+    FileUtil::removeFileIfPresent(Poco::File(makeInfoFilePath(key)));
+}
+
+void HttpPartialContentStore::trimToSize(Poco::UInt64 requiredBytes)
+{
+    std::vector<Poco::File> files;
+    Poco::File(m_partialDir).list(files);
+
+    std::vector<Poco::File> dataFiles;
+    Poco::UInt64 totalBytes = 0;
+    std::string extension = std::string(HttpInternalConstants::Caches::DataFileExtention).substr(1);
+    for (size_t i = 0; i < files.size(); i++) {
+        if (Poco::Path(files[i].path()).getExtension() == extension) {
+            totalBytes += files[i].getSize();
+            dataFiles.push_back(files[i]);
+        }
+    }
+    if (totalBytes + requiredBytes <= m_maxSize) {
+        return;
+    }
+
+    // drop the least recently interrupted downloads first.
+    std::sort(dataFiles.begin(), dataFiles.end(), isOlderThan);
+    for (size_t i = 0; i < dataFiles.size() && totalBytes + requiredBytes > m_maxSize; i++) {
+        Poco::UInt64 bytes = dataFiles[i].getSize();
+        std::string key = Poco::Path(dataFiles[i].path()).getBaseName();
+        EASYHTTPCPP_LOG_D(Tag, "trimToSize: remove partial content. [%s]", key.c_str());
+        removeInternal(key);
+        totalBytes -= bytes;
+    }
+}
+
+} /* namespace easyhttpcpp */
@@ -0,0 +1,56 @@
+/*
+ * Copyright 2019 Sony Corporation
+ */
+
+#ifndef EASYHTTPCPP_HTTPPARTIALCONTENTSTORE_H_INCLUDED
+#define EASYHTTPCPP_HTTPPARTIALCONTENTSTORE_H_INCLUDED
+
+#include <string>
+
+#include "Poco/AutoPtr.h"
+#include "Poco/Mutex.h"
+#include "Poco/Path.h"
+#include "Poco/RefCountedObject.h"
+#include "Poco/Types.h"
+
+#include "easyhttpcpp/HttpExports.h"
+
+#include "HttpPartialContent.h"
+
+namespace easyhttpcpp {
+
+// keeps interrupted response bodies next to the cache so that the next request can resume them with Range.
+// each entry is a <key>.data file with the received bytes and a <key>.info file with the complete length, the
+// validator and the url. the entries are not part of the cache size; their total is bounded by maxSize on its own.
+// the key is a hash, so an entry is got or removed only by the url it was put with.
+class EASYHTTPCPP_HTTP_INTERNAL_API HttpPartialContentStore : public Poco::RefCountedObject {
+public:
+    typedef Poco::AutoPtr<HttpPartialContentStore> Ptr;
+
+    HttpPartialContentStore(const Poco::Path& partialDir, Poco::UInt64 maxSize);
+    virtual ~HttpPartialContentStore();
+
+    HttpPartialContent::Ptr get(const std::string& key, const std::string& url);
+    // moves sourceFilePath into the store, replacing the entry of key.
+    bool put(const std::string& key, const std::string& url, const std::string& sourceFilePath,
+            Poco::UInt64 completeLength, const std::string& validator);
+    // moves the data file of the entry to destinationFilePath and drops the entry. fails if the entry has changed.
+    bool take(HttpPartialContent::Ptr pPartialContent, const std::string& destinationFilePath);
+    void remove(const std::string& key, const std::string& url);
+    bool removeAll();
+
+private:
+    std::string makeDataFilePath(const std::string& key) const;
+    std::string makeInfoFilePath(const std::string& key) const;
+    bool readInfo(const std::string& key, Poco::UInt64& completeLength, std::string& validator, std::string& url);
+    void removeInternal(const std::string& key);
+    void trimToSize(Poco::UInt64 requiredBytes);
+
+    Poco::Path m_partialDir;
+    Poco::UInt64 m_maxSize;
+    Poco::FastMutex m_mutex;
+};
+
+} /* namespace easyhttpcpp */
+
+#endif /* EASYHTTPCPP_HTTPPARTIALCONTENTSTORE_H_INCLUDED */
@@ -0,0 +1,144 @@
+/*
+ * Copyright 2019 Sony Corporation
+ */
+
+#include <algorithm>
+
+#include "Poco/Buffer.h"
+#include "Poco/Thread.h"
+
+#include "easyhttpcpp/common/CoreLogger.h"
+#include "easyhttpcpp/HttpException.h"
+#include "easyhttpcpp/ResponseBody.h"
+#include "easyhttpcpp/ResponseBodyStream.h"
+
+#include "CallInternal.h"
+#include "HttpCacheInternal.h"
+#include "HttpCacheStrategy.h"
+#include "HttpInternalConstants.h"
+#include "HttpPrefetchTask.h"
+
+namespace easyhttpcpp {
+
+static const std::string Tag = "HttpPrefetchTask";
+
+HttpPrefetchTask::HttpPrefetchTask(EasyHttpContext::Ptr pContext, HttpPrefetcher::Ptr pPrefetcher,
+        Request::Ptr pRequest) : m_pContext(pContext), m_pPrefetcher(pPrefetcher), m_pRequest(pRequest)
+{
+}
+
+HttpPrefetchTask::~HttpPrefetchTask()
+{
+}
+
+void HttpPrefetchTask::runTask()
+{
+    try {
+        if (isCancelled()) {
+            EASYHTTPCPP_LOG_D(Tag, "prefetch was cancelled before start. [%s]", m_pRequest->getUrl().c_str());
+        } else if (isFreshInCache()) {
+            EASYHTTPCPP_LOG_D(Tag, "prefetch is skipped because cache is fresh. [%s]", m_pRequest->getUrl().c_str());
+        } else {
+            fetch();
+            EASYHTTPCPP_LOG_D(Tag, "prefetch finished. [%s]", m_pRequest->getUrl().c_str());
+        }
+    } catch (const HttpException& e) {
+        EASYHTTPCPP_LOG_D(Tag, "Error while prefetching. Details: %s", e.getMessage().c_str());
+    } catch (const std::exception& e) {
+        EASYHTTPCPP_LOG_D(Tag, "Unexpected error while prefetching. Details: %s", e.what());
+    }
+    notifyCompletion();
+}
+
+bool HttpPrefetchTask::cancel(bool mayInterruptIfRunning)
+{
+    bool ret = HttpExecutionTask::cancel(mayInterruptIfRunning);
+
+    Poco::FastMutex::ScopedLock lock(m_callMutex);
+    if (m_pCall) {
+        m_pCall->cancel();
+    }
+    return ret;
+}
+
+Request::Ptr HttpPrefetchTask::getRequest() const
+{
+    return m_pRequest;
+}
+
+bool HttpPrefetchTask::isFreshInCache()
+{
+    HttpCache::Ptr pCache = m_pContext->getCache();
+    if (!pCache) {
+        return false;
+    }
+    HttpCacheInternal* pCacheInternal = static_cast<HttpCacheInternal*> (pCache.get());
+    HttpCacheStrategy::Ptr pCacheStrategy = pCacheInternal->createCacheStrategy(m_pRequest);
+    // a stale response within stale-while-revalidate is fetched to revalidate it.
+    return !pCacheStrategy->getNetworkRequest() && pCacheStrategy->getCachedResponse() &&
+            !pCacheStrategy->getRevalidationRequest();
+}
+
+void HttpPrefetchTask::fetch()
+{
+    Call::Ptr pCall = new CallInternal(m_pContext, m_pRequest);
+    {
+        Poco::FastMutex::ScopedLock lock(m_callMutex);
+        if (isCancelled()) {
+            return;
+        }
+        m_pCall = pCall;
+    }
+
+    Response::Ptr pResponse = pCall->execute();
+    try {
+        readResponseBody(pResponse);
+    } catch (...) {
+        if (pResponse->getBody()) {
+            pResponse->getBody()->close();
+        }
+        throw;
+    }
+    // when the body was not read to the end, the response is not stored in cache.
+    if (pResponse->getBody()) {
+        pResponse->getBody()->close();
+    }
+}
+
+void HttpPrefetchTask::readResponseBody(Response::Ptr pResponse)
+{
+    // a response from cache, or which is not stored in cache, does not need to be read.
+    if (!pResponse->getBody() || !pResponse->getNetworkResponse() || !HttpCacheStrategy::isCacheable(pResponse)) {
+        EASYHTTPCPP_LOG_D(Tag, "response body is not read. [status code=%d]", pResponse->getCode());
+        return;
+    }
+
+    Poco::Buffer<char> buffer(HttpInternalConstants::Prefetches::ReadBufferBytes);
+    ResponseBodyStream::Ptr pStream = pResponse->getBody()->getByteStream();
+    while (!isCancelled() && !pStream->isEof()) {
+        ssize_t bytes = pStream->read(buffer.begin(), buffer.size());
+        if (bytes <= 0) {
+            break;
+        }
+        waitForBandwidth(m_pPrefetcher->reserveBandwidth(static_cast<size_t>(bytes)));
+    }
+}
+
+void HttpPrefetchTask::waitForBandwidth(long waitMillis)
+{
+    while (waitMillis > 0 && !isCancelled()) {
+        long sleepMillis = std::min(waitMillis, HttpInternalConstants::Prefetches::MaxThrottleSleepMillis);
+        Poco::Thread::sleep(sleepMillis);
+        waitMillis -= sleepMillis;
+    }
+}
+
+void HttpPrefetchTask::notifyCompletion()
+{
+    HttpPrefetcher::Ptr pPrefetcher = m_pPrefetcher;
+    m_pPrefetcher = NULL;
+    m_pContext->getHttpExecutionTaskManager()->onComplete(HttpExecutionTask::Ptr(this, true));
+    pPrefetcher->onComplete(HttpPrefetchTask::Ptr(this, true));
+}
+
+} /* namespace easyhttpcpp */
@@ -0,0 +1,54 @@
+/*
+ * Copyright 2019 Sony Corporation
+ */
+
+#ifndef EASYHTTPCPP_HTTPPREFETCHTASK_H_INCLUDED
+#define EASYHTTPCPP_HTTPPREFETCHTASK_H_INCLUDED
+
+#include "Poco/Mutex.h"
+
+#include "easyhttpcpp/Call.h"
+#include "easyhttpcpp/Request.h"
+#include "easyhttpcpp/Response.h"
+
+#include "EasyHttpContext.h"
+#include "HttpExecutionTask.h"
+#include "HttpPrefetcher.h"
+
+namespace easyhttpcpp {
+
+/**
+ * Fetches one request of EasyHttp::prefetch through the normal cache path and reads its response body, so that
+ * it is stored in HttpCache. A request which is fresh in cache is skipped.
+ */
+class HttpPrefetchTask : public HttpExecutionTask {
+public:
+    typedef Poco::AutoPtr<HttpPrefetchTask> Ptr;
+
+    HttpPrefetchTask(EasyHttpContext::Ptr pContext, HttpPrefetcher::Ptr pPrefetcher, Request::Ptr pRequest);
+    virtual ~HttpPrefetchTask();
+
+    virtual void runTask();
+    virtual bool cancel(bool mayInterruptIfRunning);
+
+    Request::Ptr getRequest() const;
+
+private:
+    HttpPrefetchTask();
+
+    bool isFreshInCache();
+    void fetch();
+    void readResponseBody(Response::Ptr pResponse);
+    void waitForBandwidth(long waitMillis);
+    void notifyCompletion();
+
+    EasyHttpContext::Ptr m_pContext;
+    HttpPrefetcher::Ptr m_pPrefetcher;
+    Request::Ptr m_pRequest;
+    Poco::FastMutex m_callMutex;
+    Call::Ptr m_pCall;
+};
+
+} /* namespace easyhttpcpp */
+
+#endif /* EASYHTTPCPP_HTTPPREFETCHTASK_H_INCLUDED */
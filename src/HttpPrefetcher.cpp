@@ -0,0 +1,144 @@
+/*
+ * Copyright 2019 Sony Corporation
+ */
+
+#include "easyhttpcpp/common/CoreLogger.h"
+#include "easyhttpcpp/HttpException.h"
+
+#include "HttpPrefetcher.h"
+#include "HttpPrefetchTask.h"
+
+namespace easyhttpcpp {
+
+static const std::string Tag = "HttpPrefetcher";
+
+HttpPrefetcher::HttpPrefetcher(EasyHttpContext::Ptr pContext, unsigned int maxConcurrentCount,
+        Poco::UInt64 bytesPerSec) : m_pContext(pContext), m_maxConcurrentCount(maxConcurrentCount),
+        m_bytesPerSec(bytesPerSec)
+{
+}
+
+HttpPrefetcher::~HttpPrefetcher()
+{
+}
+
+bool HttpPrefetcher::prefetch(Request::Ptr pRequest, PrefetchPriority priority)
+{
+    Poco::FastMutex::ScopedLock lock(m_instanceMutex);
+
+    if (!m_pendingUrls.insert(pRequest->getUrl()).second) {
+        EASYHTTPCPP_LOG_D(Tag, "prefetch: already queued. [%s]", pRequest->getUrl().c_str());
+        return false;
+    }
+    m_queues[priority].push_back(pRequest);
+    EASYHTTPCPP_LOG_D(Tag, "prefetch: queued. priority=%d [%s]", priority, pRequest->getUrl().c_str());
+
+    startQueuedTasks();
+    return true;
+}
+
+void HttpPrefetcher::cancelAll()
+{
+    TaskList runningTasksCopy;
+    {
+        Poco::FastMutex::ScopedLock lock(m_instanceMutex);
+
+        for (size_t i = 0; i < PriorityCount; i++) {
+            m_queues[i].clear();
+        }
+        m_pendingUrls.clear();
+        runningTasksCopy = m_runningTasks;
+    }
+
+    // running tasks remove themselves by onComplete.
+    for (TaskList::iterator it = runningTasksCopy.begin(); it != runningTasksCopy.end(); it++) {
+        (*it)->cancel(true);
+    }
+    EASYHTTPCPP_LOG_D(Tag, "cancelAll: cancelled %zu running prefetches.", runningTasksCopy.size());
+}
+
+long HttpPrefetcher::reserveBandwidth(size_t bytes)
+{
+    if (m_bytesPerSec == 0) {
+        return 0;
+    }
+
+    Poco::FastMutex::ScopedLock lock(m_bandwidthMutex);
+
+    // unused bandwidth is not saved up, so that prefetches after idle time do not burst.
+    Poco::Timestamp now;
+    if (m_bandwidthAvailableAt < now) {
+        m_bandwidthAvailableAt = now;
+    }
+    Poco::Timestamp::TimeDiff waitMicros = m_bandwidthAvailableAt - now;
+    m_bandwidthAvailableAt += static_cast<Poco::Timestamp::TimeDiff>(bytes * Poco::Timestamp::resolution() /
+            m_bytesPerSec);
+    return static_cast<long>(waitMicros / 1000);
+}
+
+void HttpPrefetcher::onComplete(HttpPrefetchTask::Ptr pTask)
+{
+    Poco::FastMutex::ScopedLock lock(m_instanceMutex);
+
+    for (TaskList::iterator it = m_runningTasks.begin(); it != m_runningTasks.end(); it++) {
+        if (*it == pTask) {
+            m_runningTasks.erase(it);
+            // after cancelAll, the url may have been queued again; it is fetched by the new request then.
+            if (!pTask->isCancelled()) {
+                m_pendingUrls.erase(pTask->getRequest()->getUrl());
+            }
+            break;
+        }
+    }
+
+    startQueuedTasks();
+}
+
+size_t HttpPrefetcher::getQueuedCount()
+{
+    Poco::FastMutex::ScopedLock lock(m_instanceMutex);
+
+    size_t count = 0;
+    for (size_t i = 0; i < PriorityCount; i++) {
+        count += m_queues[i].size();
+    }
+    return count;
+}
+
+size_t HttpPrefetcher::getRunningCount()
+{
+    Poco::FastMutex::ScopedLock lock(m_instanceMutex);
+
+    return m_runningTasks.size();
+}
+
+void HttpPrefetcher::startQueuedTasks()
+{
+    size_t priority = 0;
+    while (m_runningTasks.size() < m_maxConcurrentCount && priority < PriorityCount) {
+        RequestQueue& queue = m_queues[priority];
+        if (queue.empty()) {
+            priority++;
+            continue;
+        }
+        Request::Ptr pRequest = queue.front();
+        queue.pop_front();
+
+        HttpPrefetchTask::Ptr pTask = new HttpPrefetchTask(m_pContext, HttpPrefetcher::Ptr(this, true), pRequest);
+        m_runningTasks.push_back(pTask);
+        try {
+            m_pContext->getHttpExecutionTaskManager()->start(pTask);
+        } catch (const HttpException& e) {
+            // EasyHttp is invalidated; nothing can be prefetched anymore.
+            EASYHTTPCPP_LOG_D(Tag, "startQueuedTasks: can not start prefetch. Details: %s", e.getMessage().c_str());
+            m_runningTasks.pop_back();
+            for (size_t i = 0; i < PriorityCount; i++) {
+                m_queues[i].clear();
+            }
+            m_pendingUrls.clear();
+            return;
+        }
+    }
+}
+
+} /* namespace easyhttpcpp */
@@ -0,0 +1,89 @@
+/*
+ * Copyright 2019 Sony Corporation
+ */
+
+#ifndef EASYHTTPCPP_HTTPPREFETCHER_H_INCLUDED
+#define EASYHTTPCPP_HTTPPREFETCHER_H_INCLUDED
+
+#include <list>
+#include <set>
+#include <string>
+
+#include "Poco/AutoPtr.h"
+#include "Poco/Mutex.h"
+#include "Poco/RefCountedObject.h"
+#include "Poco/Timestamp.h"
+#include "Poco/Types.h"
+
+#include "easyhttpcpp/HttpExports.h"
+#include "easyhttpcpp/PrefetchPriority.h"
+#include "easyhttpcpp/Request.h"
+
+#include "EasyHttpContext.h"
+
+namespace easyhttpcpp {
+
+class HttpPrefetchTask;
+
+/**
+ * Queues the requests of EasyHttp::prefetch by priority and runs them as HttpPrefetchTask on the asynchronous
+ * thread pool, within a concurrency and bandwidth budget.
+ */
+class EASYHTTPCPP_HTTP_INTERNAL_API HttpPrefetcher : public Poco::RefCountedObject {
+public:
+    typedef Poco::AutoPtr<HttpPrefetcher> Ptr;
+
+    HttpPrefetcher(EasyHttpContext::Ptr pContext, unsigned int maxConcurrentCount, Poco::UInt64 bytesPerSec);
+    virtual ~HttpPrefetcher();
+
+    /**
+     * Queues the request. a request of the same url which is queued or running is not queued again.
+     * @return false if the request was skipped.
+     */
+    bool prefetch(Request::Ptr pRequest, PrefetchPriority priority);
+
+    /**
+     * Removes the queued requests and cancels the running ones.
+     */
+    void cancelAll();
+
+    /**
+     * Reserves the bandwidth of bytes which have been read.
+     * @return milliseconds to wait before reading more, so that the bandwidth budget is kept.
+     */
+    long reserveBandwidth(size_t bytes);
+
+    void onComplete(Poco::AutoPtr<HttpPrefetchTask> pTask);
+
+    size_t getQueuedCount();
+    size_t getRunningCount();
+
+private:
+    HttpPrefetcher();
+
+    typedef std::list<Request::Ptr> RequestQueue;
+    typedef std::list<Poco::AutoPtr<HttpPrefetchTask> > TaskList;
+
+    static const size_t PriorityCount = PrefetchPriorityLow + 1;
+
+    // m_instanceMutex must be locked.
+    void startQueuedTasks();
+
+    EasyHttpContext::Ptr m_pContext;
+    unsigned int m_maxConcurrentCount;
+    Poco::UInt64 m_bytesPerSec;
+
+    Poco::FastMutex m_instanceMutex;
+    RequestQueue m_queues[PriorityCount];
+    // urls of queued and running requests.
+    std::set<std::string> m_pendingUrls;
+    TaskList m_runningTasks;
+
+    Poco::FastMutex m_bandwidthMutex;
+    // time when the bytes reserved so far have been read at the budgeted bandwidth.
+    Poco::Timestamp m_bandwidthAvailableAt;
+};
+
+} /* namespace easyhttpcpp */
+
+#endif /* EASYHTTPCPP_HTTPPREFETCHER_H_INCLUDED */
@@ -0,0 +1,313 @@
+/*
+ * Copyright 2019 Sony Corporation
+ */
+
+#include "easyhttpcpp/common/CoreLogger.h"
+
+#include "HttpCacheInfo.h"
+#include "HttpInternalConstants.h"
+#include "HttpTinyLfuCacheStrategy.h"
+
+using easyhttpcpp::common::CacheInfoWithDataSize;
+
+namespace easyhttpcpp {
+
+static const std::string Tag = "HttpTinyLfuCacheStrategy";
+
+HttpTinyLfuCacheStrategy::SegmentEntry::SegmentEntry() : m_segment(SegmentWindow), m_dataSize(0)
+{
+}
+
+HttpTinyLfuCacheStrategy::SegmentEntry::SegmentEntry(Segment segment, SegmentList::iterator position,
+        size_t dataSize) : m_segment(segment), m_position(position), m_dataSize(dataSize)
+{
+}
+
+HttpTinyLfuCacheStrategy::SegmentCursor::SegmentCursor(SegmentList& segment) : m_segment(segment),
+        m_next(segment.end())
+{
+}
+
+HttpTinyLfuCacheStrategy::HttpTinyLfuCacheStrategy(size_t maxSize) : HttpLruCacheStrategy(maxSize),
+        m_frequencySketch(0), m_incomingSize(0)
+{
+    for (size_t i = 0; i < SegmentCount; i++) {
+        m_segmentSizes[i] = 0;
+    }
+}
+
+HttpTinyLfuCacheStrategy::~HttpTinyLfuCacheStrategy()
+{
+}
+
+bool HttpTinyLfuCacheStrategy::add(const std::string& key, CacheInfoWithDataSize::Ptr pCacheInfo)
+{
+    return addOrUpdateEntry(key, pCacheInfo, true);
+}
+
+bool HttpTinyLfuCacheStrategy::update(const std::string& key, CacheInfoWithDataSize::Ptr pCacheInfo)
+{
+    return addOrUpdateEntry(key, pCacheInfo, false);
+}
+
+bool HttpTinyLfuCacheStrategy::makeSpace(size_t requestSize)
+{
+    // space is made for a new entry, which is put in the window.
+    m_incomingSize = requestSize;
+    bool ret = HttpLruCacheStrategy::makeSpace(requestSize);
+    m_incomingSize = 0;
+    return ret;
+}
+
+unsigned int HttpTinyLfuCacheStrategy::getFrequency(const std::string& key) const
+{
+    return m_frequencySketch.frequency(key);
+}
+
+CacheInfoWithDataSize* HttpTinyLfuCacheStrategy::touch(const std::string& key)
+{
+    // misses are recorded as well, so that a key requested again soon is admitted.
+    m_frequencySketch.increment(key);
+    CacheInfoWithDataSize* pCacheInfo = HttpLruCacheStrategy::touch(key);
+    promote(key);
+    return pCacheInfo;
+}
+
+bool HttpTinyLfuCacheStrategy::createRemoveLruDataList(LruKeyList& keys, size_t removeSize)
+{
+    size_t windowMaxSize = getWindowMaxSize();
+    size_t mainMaxSize = getMainMaxSize();
+    size_t windowSize = m_segmentSizes[SegmentWindow] + m_incomingSize;
+    size_t mainSize = m_segmentSizes[SegmentProbation] + m_segmentSizes[SegmentProtected];
+    SegmentCursor windowCursor(m_segments[SegmentWindow]);
+    SegmentCursor probationCursor(m_segments[SegmentProbation]);
+    SegmentCursor protectedCursor(m_segments[SegmentProtected]);
+    // window entries moved to the probation segment; the segments are changed only if space can be made.
+    SegmentList admittedKeys;
+    SegmentCursor admittedCursor(admittedKeys);
+
+    size_t targetSize = 0;
+    while (targetSize < removeSize) {
+        SegmentList::iterator candidate;
+        SegmentList::iterator victim;
+        if (windowSize > windowMaxSize && peekEvictable(windowCursor, candidate)) {
+            size_t candidateSize = getDataSize(*candidate);
+            if (mainSize + candidateSize <= mainMaxSize) {
+                // the main space has room; the candidate is moved there without competing.
+                windowCursor.m_next = candidate;
+                admittedKeys.push_front(*candidate);
+                windowSize -= candidateSize;
+                mainSize += candidateSize;
+                continue;
+            }
+
+            SegmentCursor* pVictimCursor = peekMainVictim(probationCursor, admittedCursor, protectedCursor, victim);
+            // the candidate is admitted only if it is accessed more often than every entry it evicts.
+            if (pVictimCursor && candidateSize <= mainMaxSize &&
+                    m_frequencySketch.frequency(*candidate) > m_frequencySketch.frequency(*victim)) {
+                size_t victimSize = getDataSize(*victim);
+                keys.push_back(*victim);
+                pVictimCursor->m_next = victim;
+                targetSize += victimSize;
+                mainSize -= victimSize;
+                EASYHTTPCPP_LOG_D(Tag, "createRemoveLruDataList: admit key=%s evict dataSize=%zu key=%s",
+                        candidate->c_str(), victimSize, victim->c_str());
+            } else {
+                keys.push_back(*candidate);
+                windowCursor.m_next = candidate;
+                targetSize += candidateSize;
+                windowSize -= candidateSize;
+                EASYHTTPCPP_LOG_D(Tag, "createRemoveLruDataList: reject dataSize=%zu key=%s", candidateSize,
+                        candidate->c_str());
+            }
+            continue;
+        }
+
+        // the window fits; the least recently used entry of the main space is evicted.
+        SegmentCursor* pVictimCursor = peekMainVictim(probationCursor, admittedCursor, protectedCursor, victim);
+        if (!pVictimCursor) {
+            pVictimCursor = &windowCursor;
+            if (!peekEvictable(windowCursor, victim)) {
+                EASYHTTPCPP_LOG_D(Tag, "createRemoveLruDataList: can not make free space. removeSize=%zu",
+                        removeSize);
+                return false;
+            }
+        }
+        size_t victimSize = getDataSize(*victim);
+        keys.push_back(*victim);
+        pVictimCursor->m_next = victim;
+        targetSize += victimSize;
+        if (pVictimCursor == &windowCursor) {
+            windowSize -= victimSize;
+        } else {
+            mainSize -= victimSize;
+        }
+        EASYHTTPCPP_LOG_D(Tag, "createRemoveLruDataList: dataSize=%zu key=%s", victimSize, victim->c_str());
+    }
+
+    // the first admitted key is moved first, so that the last one is the most recently used in probation.
+    for (SegmentList::reverse_iterator it = admittedKeys.rbegin(); it != admittedKeys.rend(); it++) {
+        moveEntry(m_segmentEntries[*it], SegmentProbation);
+    }
+    return true;
+}
+
+void HttpTinyLfuCacheStrategy::onEntryRemoved(const std::string& key)
+{
+    SegmentEntryMap::Iterator it = m_segmentEntries.find(key);
+    if (it == m_segmentEntries.end()) {
+        return;
+    }
+    SegmentEntry& entry = it->second;
+    m_segmentSizes[entry.m_segment] -= entry.m_dataSize;
+    m_segments[entry.m_segment].erase(entry.m_position);
+    m_segmentEntries.erase(it);
+}
+
+void HttpTinyLfuCacheStrategy::onAllEntriesRemoved()
+{
+    for (size_t i = 0; i < SegmentCount; i++) {
+        m_segments[i].clear();
+        m_segmentSizes[i] = 0;
+    }
+    m_segmentEntries.clear();
+    m_frequencySketch.clear();
+}
+
+bool HttpTinyLfuCacheStrategy::addOrUpdateEntry(const std::string& key, CacheInfoWithDataSize::Ptr pCacheInfo,
+        bool add)
+{
+    bool newEntry = (m_segmentEntries.find(key) == m_segmentEntries.end());
+    m_incomingKey = key;
+    m_incomingSize = (newEntry && pCacheInfo) ? pCacheInfo->getDataSize() : 0;
+    bool ret = add ? HttpLruCacheStrategy::add(key, pCacheInfo) : HttpLruCacheStrategy::update(key, pCacheInfo);
+    m_incomingKey.clear();
+    m_incomingSize = 0;
+
+    syncEntry(key);
+    if (newEntry) {
+        m_frequencySketch.ensureCapacity(m_lruListMap.size());
+    }
+    return ret;
+}
+
+void HttpTinyLfuCacheStrategy::syncEntry(const std::string& key)
+{
+    LruListMap::Iterator it = m_lruListMap.find(key);
+    if (it == m_lruListMap.end()) {
+        return;
+    }
+    size_t dataSize = it->second->getDataSize();
+    SegmentEntryMap::Iterator entryIt = m_segmentEntries.find(key);
+    if (entryIt == m_segmentEntries.end()) {
+        // a new entry starts in the window.
+        SegmentList& window = m_segments[SegmentWindow];
+        window.push_front(key);
+        m_segmentEntries[key] = SegmentEntry(SegmentWindow, window.begin(), dataSize);
+        m_segmentSizes[SegmentWindow] += dataSize;
+        return;
+    }
+    SegmentEntry& entry = entryIt->second;
+    m_segmentSizes[entry.m_segment] -= entry.m_dataSize;
+    m_segmentSizes[entry.m_segment] += dataSize;
+    entry.m_dataSize = dataSize;
+    if (entry.m_segment == SegmentProtected) {
+        demoteProtectedOverflow();
+    }
+}
+
+void HttpTinyLfuCacheStrategy::moveEntry(SegmentEntry& entry, Segment segment)
+{
+    SegmentList& destination = m_segments[segment];
+    destination.splice(destination.begin(), m_segments[entry.m_segment], entry.m_position);
+    m_segmentSizes[entry.m_segment] -= entry.m_dataSize;
+    m_segmentSizes[segment] += entry.m_dataSize;
+    entry.m_segment = segment;
+}
+
+void HttpTinyLfuCacheStrategy::promote(const std::string& key)
+{
+    SegmentEntryMap::Iterator it = m_segmentEntries.find(key);
+    if (it == m_segmentEntries.end()) {
+        return;
+    }
+    SegmentEntry& entry = it->second;
+    if (entry.m_segment == SegmentProbation) {
+        moveEntry(entry, SegmentProtected);
+        demoteProtectedOverflow();
+    } else {
+        SegmentList& segment = m_segments[entry.m_segment];
+        segment.splice(segment.begin(), segment, entry.m_position);
+    }
+}
+
+void HttpTinyLfuCacheStrategy::demoteProtectedOverflow()
+{
+    size_t protectedMaxSize = getProtectedMaxSize();
+    SegmentList& protectedSegment = m_segments[SegmentProtected];
+    while (m_segmentSizes[SegmentProtected] > protectedMaxSize && !protectedSegment.empty()) {
+        moveEntry(m_segmentEntries[protectedSegment.back()], SegmentProbation);
+    }
+}
+
+bool HttpTinyLfuCacheStrategy::peekEvictable(SegmentCursor& cursor, SegmentList::iterator& position)
+{
+    SegmentList::iterator it = cursor.m_next;
+    while (it != cursor.m_segment.begin()) {
+        --it;
+        if (*it != m_incomingKey && isEvictable(*it)) {
+            position = it;
+            return true;
+        }
+    }
+    return false;
+}
+
+HttpTinyLfuCacheStrategy::SegmentCursor* HttpTinyLfuCacheStrategy::peekMainVictim(SegmentCursor& probationCursor,
+        SegmentCursor& admittedCursor, SegmentCursor& protectedCursor, SegmentList::iterator& position)
+{
+    // admitted keys are at the front of the probation segment, so they are evicted after the rest of it.
+    if (peekEvictable(probationCursor, position)) {
+        return &probationCursor;
+    }
+    if (peekEvictable(admittedCursor, position)) {
+        return &admittedCursor;
+    }
+    if (peekEvictable(protectedCursor, position)) {
+        return &protectedCursor;
+    }
+    return NULL;
+}
+
+bool HttpTinyLfuCacheStrategy::isEvictable(const std::string& key)
+{
+    LruListMap::Iterator it = m_lruListMap.find(key);
+    if (it == m_lruListMap.end()) {
+        return false;
+    }
+    HttpCacheInfo* pHttpCacheInfo = static_cast<HttpCacheInfo*> (it->second.get());
+    return pHttpCacheInfo->getDataRefCount() == 0;
+}
+
+size_t HttpTinyLfuCacheStrategy::getDataSize(const std::string& key)
+{
+    SegmentEntryMap::Iterator it = m_segmentEntries.find(key);
+    return it != m_segmentEntries.end() ? it->second.m_dataSize : 0;
+}
+
+size_t HttpTinyLfuCacheStrategy::getWindowMaxSize() const
+{
+    return m_maxSize / 100 * HttpInternalConstants::Caches::TinyLfuWindowPercentage;
+}
+
+size_t HttpTinyLfuCacheStrategy::getMainMaxSize() const
+{
+    return m_maxSize - getWindowMaxSize();
+}
+
+size_t HttpTinyLfuCacheStrategy::getProtectedMaxSize() const
+{
+    return getMainMaxSize() / 100 * HttpInternalConstants::Caches::TinyLfuProtectedPercentage;
+}
+
+} /* namespace easyhttpcpp */
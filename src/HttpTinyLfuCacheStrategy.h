@@ -0,0 +1,107 @@
+/*
+ * Copyright 2019 Sony Corporation
+ */
+
+#ifndef EASYHTTPCPP_HTTPTINYLFUCACHESTRATEGY_H_INCLUDED
+#define EASYHTTPCPP_HTTPTINYLFUCACHESTRATEGY_H_INCLUDED
+
+#include <list>
+#include <string>
+
+#include "Poco/HashMap.h"
+
+#include "easyhttpcpp/common/FrequencySketch.h"
+#include "easyhttpcpp/HttpExports.h"
+
+#include "HttpLruCacheStrategy.h"
+
+namespace easyhttpcpp {
+
+/**
+ * W-TinyLFU eviction by data size.
+ * A new entry is put in a small admission window. When the window is full, its least recently used entry is
+ * moved to the main space only if it has been accessed more often than the entry it would evict from there, so
+ * that a scan of many one-shot entries does not evict frequently used ones. The main space is a segmented LRU;
+ * an entry accessed again in the probation segment is promoted to the protected segment.
+ */
+class EASYHTTPCPP_HTTP_INTERNAL_API HttpTinyLfuCacheStrategy : public HttpLruCacheStrategy {
+public:
+    HttpTinyLfuCacheStrategy(size_t maxSize);
+    virtual ~HttpTinyLfuCacheStrategy();
+
+    virtual bool add(const std::string& key, easyhttpcpp::common::CacheInfoWithDataSize::Ptr pCacheInfo);
+    virtual bool update(const std::string& key, easyhttpcpp::common::CacheInfoWithDataSize::Ptr pCacheInfo);
+    virtual bool makeSpace(size_t requestSize);
+
+    /**
+     * Returns the estimated access count of the key.
+     */
+    unsigned int getFrequency(const std::string& key) const;
+
+protected:
+    virtual easyhttpcpp::common::CacheInfoWithDataSize* touch(const std::string& key);
+    virtual bool createRemoveLruDataList(LruKeyList& keys, size_t removeSize);
+    virtual void onEntryRemoved(const std::string& key);
+    virtual void onAllEntriesRemoved();
+
+private:
+    enum Segment {
+        SegmentWindow = 0,
+        SegmentProbation,
+        SegmentProtected,
+        SegmentCount
+    };
+
+    typedef std::list<std::string> SegmentList;
+
+    class SegmentEntry {
+    public:
+        SegmentEntry();
+        SegmentEntry(Segment segment, SegmentList::iterator position, size_t dataSize);
+
+        Segment m_segment;
+        SegmentList::iterator m_position;
+        size_t m_dataSize;
+    };
+
+    typedef Poco::HashMap<std::string, SegmentEntry> SegmentEntryMap;
+
+    // entries at or after m_next in the segment have already been chosen while making space.
+    class SegmentCursor {
+    public:
+        SegmentCursor(SegmentList& segment);
+
+        SegmentList& m_segment;
+        SegmentList::iterator m_next;
+    };
+
+    HttpTinyLfuCacheStrategy();
+
+    bool addOrUpdateEntry(const std::string& key, easyhttpcpp::common::CacheInfoWithDataSize::Ptr pCacheInfo,
+            bool add);
+    void syncEntry(const std::string& key);
+    void moveEntry(SegmentEntry& entry, Segment segment);
+    void promote(const std::string& key);
+    void demoteProtectedOverflow();
+    bool peekEvictable(SegmentCursor& cursor, SegmentList::iterator& position);
+    SegmentCursor* peekMainVictim(SegmentCursor& probationCursor, SegmentCursor& admittedCursor,
+            SegmentCursor& protectedCursor, SegmentList::iterator& position);
+    bool isEvictable(const std::string& key);
+    size_t getDataSize(const std::string& key);
+    size_t getWindowMaxSize() const;
+    size_t getMainMaxSize() const;
+    size_t getProtectedMaxSize() const;
+
+    SegmentList m_segments[SegmentCount];
+    size_t m_segmentSizes[SegmentCount];
+    SegmentEntryMap m_segmentEntries;
+    easyhttpcpp::common::FrequencySketch m_frequencySketch;
+    // the entry being added or updated; it is not evicted to make space for itself.
+    std::string m_incomingKey;
+    // bytes which are going to be put in the window after space is made.
+    size_t m_incomingSize;
+};
+
+} /* namespace easyhttpcpp */
+
+#endif /* EASYHTTPCPP_HTTPTINYLFUCACHESTRATEGY_H_INCLUDED */
@@ -11,22 +11,98 @@
 #include "Poco/JSON/Object.h"
 #include "Poco/JSON/Parser.h"
 #include "Poco/Net/HTTPRequest.h"
+#include "Poco/NumberFormatter.h"
+#include "Poco/NumberParser.h"
+#include "Poco/String.h"
 
 #include "easyhttpcpp/common/CoreLogger.h"
 #include "easyhttpcpp/common/StringUtil.h"
+#include "easyhttpcpp/HttpConstants.h"
 #include "easyhttpcpp/HttpException.h"
-#include "easyhttpcpp/messagedigest/DigestUtil.h"
 
+#include "ContentDecodingInputStream.h"
 #include "HttpInternalConstants.h"
 #include "HttpUtil.h"
 
 using easyhttpcpp::common::StringUtil;
-using easyhttpcpp::messagedigest::DigestUtil;
 
 namespace easyhttpcpp {
 
 static const std::string Tag = "HttpUtil";
 
+// binary header format version 1. names are only appended to the table, never reordered.
+static const char HeaderBinaryFormatVersion = 0x01;
+static const char* const InternedHeaderNames[] = {
+    "Content-Type",
+    "Content-Length",
+    "Date",
+    "Server",
+    "Cache-Control",
+    "ETag",
+    "Last-Modified",
+    "Expires",
+    "Age",
+    "Vary",
+    "Content-Encoding",
+    "Transfer-Encoding",
+    "Connection",
+    "Keep-Alive",
+    "Accept-Ranges",
+    "Set-Cookie",
+    "Location",
+    "Link",
+    "Pragma",
+    "Via",
+    "Warning",
+    "Content-Disposition",
+    "Content-Language",
+    "Content-Range",
+    "Access-Control-Allow-Origin",
+    "Strict-Transport-Security",
+    "X-Content-Type-Options",
+    "X-Frame-Options",
+    "X-Cache",
+    "Alt-Svc"
+};
+static const size_t InternedHeaderNameCount = sizeof(InternedHeaderNames) / sizeof(InternedHeaderNames[0]);
+
+namespace {
+
+// LEB128. callers pass values of 1 or more, so no NUL byte is written.
+void appendVarUInt(std::string& out, size_t value)
+{
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+bool readVarUInt(const std::string& in, size_t& pos, size_t& value)
+{
+    value = 0;
+    for (unsigned int shift = 0; pos < in.size() && shift < sizeof(size_t) * 8; shift += 7) {
+        unsigned char byte = static_cast<unsigned char>(in[pos++]);
+        value |= static_cast<size_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool readString(const std::string& in, size_t& pos, size_t length, std::string& value)
+{
+    if (length > in.size() - pos) {
+        return false;
+    }
+    value.assign(in, pos, length);
+    pos += length;
+    return true;
+}
+
+} /* namespace */
+
 const std::string& HttpUtil::httpMethodToString(Request::HttpMethod httpMethod)
 {
     switch (httpMethod) {
@@ -69,13 +145,35 @@ bool HttpUtil::tryParseDate(const std::string& value, Poco::Timestamp& timeStamp
 
 std::string HttpUtil::makeCacheKey(Request::Ptr pRequest)
 {
-    return makeCacheKey(pRequest->getMethod(), pRequest->getUrl());
+    return makeCacheKey(HttpCacheKeyHasher::createDefaultHasher(), pRequest);
 }
 
 std::string HttpUtil::makeCacheKey(Request::HttpMethod httpMethod, const std::string& url)
 {
-    // method + url -> digest
-    std::string key = DigestUtil::createHashedFileName(httpMethodToString(httpMethod) + url);
+    return makeCacheKey(HttpCacheKeyHasher::createDefaultHasher(), httpMethod, url);
+}
+
+std::string HttpUtil::makeCacheKey(HttpCacheKeyHasher::Ptr pKeyHasher, Request::Ptr pRequest)
+{
+    return makeCacheKey(pKeyHasher, pRequest->getMethod(), pRequest->getUrl(),
+            pRequest->getHeaderValue(HttpConstants::HeaderNames::AcceptEncoding, ""));
+}
+
+std::string HttpUtil::makeCacheKey(HttpCacheKeyHasher::Ptr pKeyHasher, Request::HttpMethod httpMethod,
+        const std::string& url)
+{
+    return makeCacheKey(pKeyHasher, httpMethod, url, "");
+}
+
+std::string HttpUtil::makeCacheKey(HttpCacheKeyHasher::Ptr pKeyHasher, Request::HttpMethod httpMethod,
+        const std::string& url, const std::string& acceptEncoding)
+{
+    // method + url (+ Accept-Encoding without spaces in lower case) -> hash
+    std::string data = httpMethodToString(httpMethod) + url;
+    if (!acceptEncoding.empty()) {
+        data += "\n" + Poco::toLower(Poco::remove(acceptEncoding, ' '));
+    }
+    std::string key = pKeyHasher->hash(data);
     if (key.empty()) {
         EASYHTTPCPP_LOG_D(Tag, "makeCacheKey failed.(empty string)");
     }
@@ -84,7 +182,22 @@ std::string HttpUtil::makeCacheKey(Request::HttpMethod httpMethod, const std::st
 
 std::string HttpUtil::makeCachedResponseBodyFilename(const Poco::Path& cacheRootDir, const std::string& key)
 {
-    Poco::Path filename(cacheRootDir, key + HttpInternalConstants::Caches::DataFileExtention);
+    return makeCachedResponseBodyFilename(cacheRootDir, key, HttpInternalConstants::Caches::DataDirFanOutLevels);
+}
+
+std::string HttpUtil::makeCachedResponseBodyFilename(const Poco::Path& cacheRootDir, const std::string& key,
+        unsigned int dataDirFanOutLevels)
+{
+    Poco::Path filename(cacheRootDir);
+    filename.makeDirectory();
+    size_t nameLength = HttpInternalConstants::Caches::DataDirNameLength;
+    // a key which is too short is stored in the cache root directory.
+    if (key.size() > dataDirFanOutLevels * nameLength) {
+        for (unsigned int i = 0; i < dataDirFanOutLevels; i++) {
+            filename.pushDirectory(key.substr(i * nameLength, nameLength));
+        }
+    }
+    filename.setFileName(key + HttpInternalConstants::Caches::DataFileExtention);
     return filename.toString();
 }
 
@@ -124,4 +237,194 @@ std::string HttpUtil::exchangeHeadersToJsonStr(Headers::Ptr pHeaders)
     }
 }
 
+std::string HttpUtil::exchangeHeadersToBinaryStr(Headers::Ptr pHeaders)
+{
+    if (!pHeaders) {
+        EASYHTTPCPP_LOG_D(Tag, "exchangeHeadersToBinaryStr: headers is NULL.");
+        return "";
+    }
+    std::string out;
+    out.push_back(HeaderBinaryFormatVersion);
+    appendVarUInt(out, pHeaders->getSize() + 1);
+    for (Headers::HeaderMap::ConstIterator it = pHeaders->begin(); it != pHeaders->end(); it++) {
+        size_t nameTag = 0;
+        for (size_t i = 0; i < InternedHeaderNameCount; i++) {
+            // exact match keeps the case of the name.
+            if (it->first == InternedHeaderNames[i]) {
+                nameTag = i + 1;
+                break;
+            }
+        }
+        if (nameTag != 0) {
+            appendVarUInt(out, nameTag);
+        } else {
+            appendVarUInt(out, InternedHeaderNameCount + 1 + it->first.size());
+            out.append(it->first);
+        }
+        appendVarUInt(out, it->second.size() + 1);
+        out.append(it->second);
+    }
+    return out;
+}
+
+Headers::Ptr HttpUtil::exchangeBinaryStrToHeaders(const std::string& headerBinaryStr)
+{
+    if (headerBinaryStr.empty() || headerBinaryStr[0] != HeaderBinaryFormatVersion) {
+        EASYHTTPCPP_LOG_D(Tag, "exchangeBinaryStrToHeaders: unknown format.");
+        return NULL;
+    }
+    size_t pos = 1;
+    size_t count;
+    if (!readVarUInt(headerBinaryStr, pos, count) || count == 0) {
+        EASYHTTPCPP_LOG_D(Tag, "exchangeBinaryStrToHeaders: invalid header count.");
+        return NULL;
+    }
+    Headers::Ptr pHeaders = new Headers();
+    std::string name;
+    std::string value;
+    for (size_t i = 0; i < count - 1; i++) {
+        size_t nameTag;
+        size_t valueTag;
+        if (!readVarUInt(headerBinaryStr, pos, nameTag) || nameTag == 0) {
+            EASYHTTPCPP_LOG_D(Tag, "exchangeBinaryStrToHeaders: invalid name at %zu.", i);
+            return NULL;
+        }
+        if (nameTag <= InternedHeaderNameCount) {
+            name = InternedHeaderNames[nameTag - 1];
+        } else if (nameTag == InternedHeaderNameCount + 1 ||
+                !readString(headerBinaryStr, pos, nameTag - InternedHeaderNameCount - 1, name)) {
+            EASYHTTPCPP_LOG_D(Tag, "exchangeBinaryStrToHeaders: truncated name at %zu.", i);
+            return NULL;
+        }
+        if (!readVarUInt(headerBinaryStr, pos, valueTag) || valueTag == 0 ||
+                !readString(headerBinaryStr, pos, valueTag - 1, value)) {
+            EASYHTTPCPP_LOG_D(Tag, "exchangeBinaryStrToHeaders: invalid value at %zu.", i);
+            return NULL;
+        }
+        pHeaders->add(name, value);
+    }
+    if (pos != headerBinaryStr.size()) {
+        EASYHTTPCPP_LOG_D(Tag, "exchangeBinaryStrToHeaders: trailing %zu bytes.", headerBinaryStr.size() - pos);
+        return NULL;
+    }
+    return pHeaders;
+}
+
+bool HttpUtil::tryParseRange(const std::string& value, Poco::UInt64 completeLength, Poco::UInt64& firstBytePos,
+        Poco::UInt64& lastBytePos)
+{
+    // RFC 7233 2.1 single byte-range-spec or suffix-byte-range-spec. multiple ranges are not supported.
+    std::string prefix = std::string(HttpConstants::HeaderValues::Bytes) + "=";
+    std::string rangeSet = Poco::trim(value);
+    if (Poco::icompare(rangeSet, 0, prefix.size(), prefix) != 0 || completeLength == 0) {
+        return false;
+    }
+    rangeSet = Poco::trim(rangeSet.substr(prefix.size()));
+    std::string::size_type dash = rangeSet.find('-');
+    if (dash == std::string::npos || rangeSet.find(',') != std::string::npos) {
+        return false;
+    }
+    std::string first = Poco::trim(rangeSet.substr(0, dash));
+    std::string last = Poco::trim(rangeSet.substr(dash + 1));
+    Poco::UInt64 firstValue = 0;
+    Poco::UInt64 lastValue = 0;
+    if (first.empty()) {
+        // bytes=-<suffix-length>
+        if (!Poco::NumberParser::tryParseUnsigned64(last, lastValue) || lastValue == 0) {
+            return false;
+        }
+        firstBytePos = lastValue < completeLength ? completeLength - lastValue : 0;
+        lastBytePos = completeLength - 1;
+        return true;
+    }
+    if (!Poco::NumberParser::tryParseUnsigned64(first, firstValue) || firstValue >= completeLength) {
+        return false;
+    }
+    if (last.empty()) {
+        lastValue = completeLength - 1;
+    } else if (!Poco::NumberParser::tryParseUnsigned64(last, lastValue) || lastValue < firstValue) {
+        return false;
+    }
+    firstBytePos = firstValue;
+    lastBytePos = lastValue < completeLength ? lastValue : completeLength - 1;
+    return true;
+}
+
+bool HttpUtil::tryParseContentRange(const std::string& value, Poco::UInt64& firstBytePos, Poco::UInt64& lastBytePos,
+        Poco::UInt64& completeLength)
+{
+    // RFC 7233 4.2 bytes <first>-<last>/<complete-length>
+    std::string prefix = std::string(HttpConstants::HeaderValues::Bytes) + " ";
+    std::string contentRange = Poco::trim(value);
+    if (Poco::icompare(contentRange, 0, prefix.size(), prefix) != 0) {
+        return false;
+    }
+    std::string::size_type dash = contentRange.find('-', prefix.size());
+    std::string::size_type slash = contentRange.find('/', prefix.size());
+    if (dash == std::string::npos || slash == std::string::npos || slash < dash) {
+        return false;
+    }
+    Poco::UInt64 first = 0;
+    Poco::UInt64 last = 0;
+    Poco::UInt64 length = 0;
+    if (!Poco::NumberParser::tryParseUnsigned64(Poco::trim(contentRange.substr(prefix.size(), dash - prefix.size())),
+            first) ||
+            !Poco::NumberParser::tryParseUnsigned64(Poco::trim(contentRange.substr(dash + 1, slash - dash - 1)),
+            last) ||
+            !Poco::NumberParser::tryParseUnsigned64(Poco::trim(contentRange.substr(slash + 1)), length)) {
+        return false;
+    }
+    if (last < first || last >= length) {
+        return false;
+    }
+    firstBytePos = first;
+    lastBytePos = last;
+    completeLength = length;
+    return true;
+}
+
+std::string HttpUtil::makeContentRange(Poco::UInt64 firstBytePos, Poco::UInt64 lastBytePos,
+        Poco::UInt64 completeLength)
+{
+    return std::string(HttpConstants::HeaderValues::Bytes) + " " + Poco::NumberFormatter::format(firstBytePos) + "-" +
+            Poco::NumberFormatter::format(lastBytePos) + "/" + Poco::NumberFormatter::format(completeLength);
+}
+
+std::string HttpUtil::getRangeValidator(Headers::Ptr pHeaders)
+{
+    // If-Range needs a strong entity-tag (RFC 7233 3.2); Last-Modified is used when there is none.
+    if (!pHeaders) {
+        return "";
+    }
+    const std::string& entityTag = pHeaders->getValue(HttpConstants::HeaderNames::ETag, "");
+    if (!entityTag.empty() && entityTag.compare(0, 2, "W/") != 0) {
+        return entityTag;
+    }
+    return pHeaders->getValue(HttpConstants::HeaderNames::LastModified, "");
+}
+
+bool HttpUtil::isDecodableContentEncoding(const std::string& contentEncoding)
+{
+    // a single gzip or deflate coding. stacked codings (e.g. "deflate, gzip") are passed through as is.
+    std::string coding = Poco::trim(contentEncoding);
+    return Poco::icompare(coding, HttpConstants::HeaderValues::Gzip) == 0 ||
+            Poco::icompare(coding, HttpConstants::HeaderValues::XGzip) == 0 ||
+            Poco::icompare(coding, HttpConstants::HeaderValues::Deflate) == 0;
+}
+
+std::istream* HttpUtil::createDecodingInputStream(std::istream& source, const std::string& contentEncoding)
+{
+    std::string coding = Poco::trim(contentEncoding);
+    if (Poco::icompare(coding, HttpConstants::HeaderValues::Gzip) == 0 ||
+            Poco::icompare(coding, HttpConstants::HeaderValues::XGzip) == 0) {
+        return new ContentDecodingInputStream(source, Poco::InflatingStreamBuf::STREAM_GZIP);
+    }
+    if (Poco::icompare(coding, HttpConstants::HeaderValues::Deflate) == 0) {
+        // "deflate" is the zlib format (RFC 7230 4.2.2).
+        return new ContentDecodingInputStream(source, Poco::InflatingStreamBuf::STREAM_ZLIB);
+    }
+    EASYHTTPCPP_LOG_D(Tag, "createDecodingInputStream: not supported content encoding. [%s]", coding.c_str());
+    return NULL;
+}
+
 } /* namespace easyhttpcpp */
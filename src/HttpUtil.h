@@ -5,12 +5,15 @@
 #ifndef EASYHTTPCPP_HTTPUTIL_H_INCLUDED
 #define EASYHTTPCPP_HTTPUTIL_H_INCLUDED
 
+#include <istream>
 #include <string>
 
 #include "Poco/Path.h"
 #include "Poco/Timestamp.h"
+#include "Poco/Types.h"
 
 #include "easyhttpcpp/Headers.h"
+#include "easyhttpcpp/HttpCacheKeyHasher.h"
 #include "easyhttpcpp/HttpExports.h"
 #include "easyhttpcpp/Request.h"
 
@@ -22,9 +25,36 @@ public:
     static bool tryParseDate(const std::string& value, Poco::Timestamp& timeStamp);
     static std::string makeCacheKey(Request::Ptr pRequest);
     static std::string makeCacheKey(Request::HttpMethod httpMethod, const std::string& url);
+    // a request with Accept-Encoding has a key of its own. (see makeCacheKey with acceptEncoding)
+    static std::string makeCacheKey(HttpCacheKeyHasher::Ptr pKeyHasher, Request::Ptr pRequest);
+    static std::string makeCacheKey(HttpCacheKeyHasher::Ptr pKeyHasher, Request::HttpMethod httpMethod,
+            const std::string& url);
+    // the response body may be stored in any of the encodings which the request accepts, so a request which asks for
+    // its own content encodings does not share the cache of the requests without Accept-Encoding. an empty
+    // acceptEncoding makes the same key as makeCacheKey without it.
+    static std::string makeCacheKey(HttpCacheKeyHasher::Ptr pKeyHasher, Request::HttpMethod httpMethod,
+            const std::string& url, const std::string& acceptEncoding);
     static std::string makeCachedResponseBodyFilename(const Poco::Path& cacheRootDir, const std::string& key);
+    // the file is in dataDirFanOutLevels nested subdirectories of cacheRootDir. (e.g. ab/cd/abcd....data)
+    static std::string makeCachedResponseBodyFilename(const Poco::Path& cacheRootDir, const std::string& key,
+            unsigned int dataDirFanOutLevels);
     static Headers::Ptr exchangeJsonStrToHeaders(const std::string& headerJsonStr);
     static std::string exchangeHeadersToJsonStr(Headers::Ptr pHeaders);
+    // versioned, length-prefixed encoding which keeps repeated header names. common names are stored as an index.
+    // the result never contains NUL, so it can be stored in a TEXT column.
+    static std::string exchangeHeadersToBinaryStr(Headers::Ptr pHeaders);
+    // returns NULL when the format is invalid.
+    static Headers::Ptr exchangeBinaryStrToHeaders(const std::string& headerBinaryStr);
+    static bool tryParseRange(const std::string& value, Poco::UInt64 completeLength, Poco::UInt64& firstBytePos,
+            Poco::UInt64& lastBytePos);
+    static bool tryParseContentRange(const std::string& value, Poco::UInt64& firstBytePos, Poco::UInt64& lastBytePos,
+            Poco::UInt64& completeLength);
+    static std::string makeContentRange(Poco::UInt64 firstBytePos, Poco::UInt64 lastBytePos,
+            Poco::UInt64 completeLength);
+    static std::string getRangeValidator(Headers::Ptr pHeaders);
+    static bool isDecodableContentEncoding(const std::string& contentEncoding);
+    // returns NULL when contentEncoding is not decodable.
+    static std::istream* createDecodingInputStream(std::istream& source, const std::string& contentEncoding);
 private:
     HttpUtil();
 };
@@ -4,7 +4,9 @@
 
 #include "easyhttpcpp/RequestBody.h"
 
+#include "HttpInternalConstants.h"
 #include "RequestBodyForByteBuffer.h"
+#include "RequestBodyForGzip.h"
 #include "RequestBodyForSharedPtrByteBuffer.h"
 #include "RequestBodyForSharedPtrStream.h"
 #include "RequestBodyForSharedPtrString.h"
@@ -38,6 +40,16 @@ RequestBody::Ptr RequestBody::create(MediaType::Ptr pMediaType, Poco::SharedPtr<
     return new RequestBodyForSharedPtrByteBuffer(pMediaType, pContent);
 }
 
+RequestBody::Ptr RequestBody::createGzip(RequestBody::Ptr pRequestBody)
+{
+    return new RequestBodyForGzip(pRequestBody, HttpInternalConstants::ContentEncodings::DefaultCompressionLevel, true);
+}
+
+RequestBody::Ptr RequestBody::createGzip(RequestBody::Ptr pRequestBody, int compressionLevel, bool adaptive)
+{
+    return new RequestBodyForGzip(pRequestBody, compressionLevel, adaptive);
+}
+
 RequestBody::Ptr RequestBody::create(MediaType::Ptr pMediaType, std::istream& content)
 {
     return new RequestBodyForStream(pMediaType, content);
@@ -58,4 +70,9 @@ MediaType::Ptr RequestBody::getMediaType() const
     return m_pMediaType;
 }
 
+std::string RequestBody::getContentEncoding() const
+{
+    return "";
+}
+
 } /* namespace easyhttpcpp */
@@ -0,0 +1,133 @@
+/*
+ * Copyright 2019 Sony Corporation
+ */
+
+#include "Poco/DeflatingStream.h"
+#include "Poco/Exception.h"
+#include "Poco/String.h"
+
+#include "easyhttpcpp/common/CoreLogger.h"
+#include "easyhttpcpp/common/StringUtil.h"
+#include "easyhttpcpp/HttpConstants.h"
+#include "easyhttpcpp/HttpException.h"
+
+#include "HttpInternalConstants.h"
+#include "RequestBodyForGzip.h"
+
+using easyhttpcpp::common::StringUtil;
+
+namespace easyhttpcpp {
+
+static const std::string Tag = "RequestBodyForGzip";
+static const int MinCompressionLevel = 1;
+static const int MaxCompressionLevel = 9;
+static const char* const CompressedMediaTypes[] = {
+    "image/", "audio/", "video/", "font/woff", "application/gzip", "application/x-gzip", "application/zip",
+    "application/zstd", "application/x-bzip2", "application/x-xz", "application/x-7z-compressed"
+};
+
+RequestBodyForGzip::RequestBodyForGzip(RequestBody::Ptr pRequestBody, int compressionLevel, bool adaptive) :
+        RequestBody(pRequestBody ? pRequestBody->getMediaType() : MediaType::Ptr()), m_pRequestBody(pRequestBody),
+        m_compressionLevel(compressionLevel), m_compressing(true)
+{
+    if (!m_pRequestBody) {
+        EASYHTTPCPP_LOG_D(Tag, "pRequestBody cannot be NULL.");
+        throw HttpIllegalArgumentException("pRequestBody cannot be NULL.");
+    }
+    if (compressionLevel < MinCompressionLevel || MaxCompressionLevel < compressionLevel) {
+        EASYHTTPCPP_LOG_D(Tag, "compressionLevel must be from %d to %d. [%d]", MinCompressionLevel,
+                MaxCompressionLevel, compressionLevel);
+        throw HttpIllegalArgumentException(StringUtil::format("compressionLevel must be from %d to %d. [%d]",
+                MinCompressionLevel, MaxCompressionLevel, compressionLevel));
+    }
+    if (!m_pRequestBody->getContentEncoding().empty()) {
+        EASYHTTPCPP_LOG_D(Tag, "pRequestBody is already encoded. [%s]", m_pRequestBody->getContentEncoding().c_str());
+        throw HttpIllegalArgumentException(StringUtil::format("pRequestBody is already encoded. [%s]",
+                m_pRequestBody->getContentEncoding().c_str()));
+    }
+    if (adaptive) {
+        // gzip header and trailer outweigh the saving for small content.
+        if (m_pRequestBody->hasContentLength() && m_pRequestBody->getContentLength() >= 0 &&
+                static_cast<size_t>(m_pRequestBody->getContentLength()) <
+                HttpInternalConstants::ContentEncodings::MinCompressingBytes) {
+            EASYHTTPCPP_LOG_D(Tag, "skip compression of small content. [%zd bytes]",
+                    m_pRequestBody->getContentLength());
+            m_compressing = false;
+        } else if (isCompressedMediaType(getMediaType())) {
+            EASYHTTPCPP_LOG_D(Tag, "skip compression of already compressed media type. [%s]",
+                    getMediaType()->toString().c_str());
+            m_compressing = false;
+        }
+    }
+}
+
+RequestBodyForGzip::~RequestBodyForGzip()
+{
+}
+
+void RequestBodyForGzip::writeTo(std::ostream& outStream)
+{
+    if (!m_compressing) {
+        m_pRequestBody->writeTo(outStream);
+        return;
+    }
+
+    try {
+        Poco::DeflatingOutputStream deflatingStream(outStream, Poco::DeflatingStreamBuf::STREAM_GZIP,
+                m_compressionLevel);
+        m_pRequestBody->writeTo(deflatingStream);
+        deflatingStream.close();
+        outStream.flush();
+    } catch (const HttpException&) {
+        throw;
+    } catch (const Poco::Exception& e) {
+        EASYHTTPCPP_LOG_D(Tag, "Cannot compress request body. Poco::Exception: [%s]", e.message().c_str());
+        throw HttpExecutionException("Cannot compress request body. Check getCause() for details.", e);
+    } catch (const std::exception& e) {
+        EASYHTTPCPP_LOG_D(Tag, "Cannot compress request body. std::exception: [%s]", e.what());
+        throw HttpExecutionException("Cannot compress request body. Check getCause() for details.", e);
+    }
+}
+
+bool RequestBodyForGzip::hasContentLength() const
+{
+    return m_compressing ? false : m_pRequestBody->hasContentLength();
+}
+
+ssize_t RequestBodyForGzip::getContentLength() const
+{
+    return m_compressing ? -1 : m_pRequestBody->getContentLength();
+}
+
+bool RequestBodyForGzip::reset()
+{
+    // the content is compressed again by the next writeTo().
+    return m_pRequestBody->reset();
+}
+
+std::string RequestBodyForGzip::getContentEncoding() const
+{
+    return m_compressing ? HttpConstants::HeaderValues::Gzip : "";
+}
+
+bool RequestBodyForGzip::isCompressing() const
+{
+    return m_compressing;
+}
+
+bool RequestBodyForGzip::isCompressedMediaType(MediaType::Ptr pMediaType)
+{
+    if (!pMediaType) {
+        return false;
+    }
+    std::string contentType = Poco::toLower(pMediaType->toString());
+    for (size_t i = 0; i < sizeof(CompressedMediaTypes) / sizeof(CompressedMediaTypes[0]); i++) {
+        if (contentType.compare(0, std::string(CompressedMediaTypes[i]).size(), CompressedMediaTypes[i]) == 0) {
+            // svg is text.
+            return contentType.compare(0, 13, "image/svg+xml") != 0;
+        }
+    }
+    return false;
+}
+
+} /* namespace easyhttpcpp */
@@ -0,0 +1,40 @@
+/*
+ * Copyright 2019 Sony Corporation
+ */
+
+#ifndef EASYHTTPCPP_REQUESTBODYFORGZIP_H_INCLUDED
+#define EASYHTTPCPP_REQUESTBODYFORGZIP_H_INCLUDED
+
+#include <string>
+
+#include "easyhttpcpp/HttpExports.h"
+#include "easyhttpcpp/RequestBody.h"
+
+namespace easyhttpcpp {
+
+/**
+ * Compresses the wrapped RequestBody while writing it. Since the compressed size is unknown before writing,
+ * the body has no content length.
+ */
+class EASYHTTPCPP_HTTP_INTERNAL_API RequestBodyForGzip : public RequestBody {
+public:
+    RequestBodyForGzip(RequestBody::Ptr pRequestBody, int compressionLevel, bool adaptive);
+    virtual ~RequestBodyForGzip();
+    virtual void writeTo(std::ostream& outStream);
+    virtual bool hasContentLength() const;
+    virtual ssize_t getContentLength() const;
+    virtual bool reset();
+    virtual std::string getContentEncoding() const;
+    bool isCompressing() const;
+
+private:
+    static bool isCompressedMediaType(MediaType::Ptr pMediaType);
+
+    RequestBody::Ptr m_pRequestBody;
+    int m_compressionLevel;
+    bool m_compressing;
+};
+
+} /* namespace easyhttpcpp */
+
+#endif /* EASYHTTPCPP_REQUESTBODYFORGZIP_H_INCLUDED */
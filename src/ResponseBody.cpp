@@ -10,6 +10,11 @@
 #include "easyhttpcpp/ResponseBody.h"
 #include "easyhttpcpp/HttpException.h"
 
+#include "HttpExecutionTaskManager.h"
+#include "ResponseBodyFileWriter.h"
+#include "ResponseBodyStreamInternal.h"
+#include "ResponseBodyWriteTask.h"
+
 using easyhttpcpp::common::Byte;
 using easyhttpcpp::common::ByteArrayBuffer;
 
@@ -70,6 +75,14 @@ std::string ResponseBody::toString()
         bufferSize = m_contentLength;
     }
     try {
+        const char* pData = NULL;
+        size_t size = 0;
+        if (m_pContent->readContiguous(pData, size)) {
+            std::string body(pData, size);
+            m_pContent->close();
+            return body;
+        }
+
         Poco::Buffer<char> inBuffer(bufferSize);
         ByteArrayBuffer outBuffer;
         while(!m_pContent->isEof()) {
@@ -88,4 +101,51 @@ std::string ResponseBody::toString()
     }
 }
 
+Poco::UInt64 ResponseBody::writeTo(const Poco::Path& path, bool append)
+{
+    if (path.toString().empty()) {
+        EASYHTTPCPP_LOG_D(Tag, "writeTo: path is empty.");
+        throw HttpIllegalArgumentException("path can not be empty.");
+    }
+
+    try {
+        // internal streams know where the data already goes (e.g. the cache temporary file) and can avoid
+        // writing it twice.
+        ResponseBodyStreamInternal* pContentInternal = dynamic_cast<ResponseBodyStreamInternal*>(m_pContent.get());
+        if (pContentInternal) {
+            return pContentInternal->writeTo(path, append, m_contentLength);
+        }
+        return ResponseBodyFileWriter::write(*m_pContent, path, append, m_contentLength);
+    } catch (const Poco::Exception& e) {
+        std::string message = "IO exception occurred.";
+        EASYHTTPCPP_LOG_D(Tag, "%s [%s]", message.c_str(), e.message().c_str());
+        throw HttpExecutionException(message, e);
+    }
+}
+
+void ResponseBody::writeToAsync(const Poco::Path& path, ResponseBodyWriteCallback::Ptr pCallback, bool append)
+{
+    if (path.toString().empty()) {
+        EASYHTTPCPP_LOG_D(Tag, "writeToAsync: path is empty.");
+        throw HttpIllegalArgumentException("path can not be empty.");
+    }
+    if (!pCallback) {
+        EASYHTTPCPP_LOG_D(Tag, "writeToAsync: ResponseBodyWriteCallback is NULL.");
+        throw HttpIllegalArgumentException("ResponseBodyWriteCallback can not be NULL.");
+    }
+    if (!m_pExecutionTaskManager) {
+        EASYHTTPCPP_LOG_D(Tag, "writeToAsync: no executor is attached.");
+        throw HttpIllegalStateException("Can not write asynchronously because ResponseBody was not created by Call.");
+    }
+
+    ResponseBodyWriteTask::Ptr pWriteTask = new ResponseBodyWriteTask(m_pExecutionTaskManager,
+            ResponseBody::Ptr(this, true), path, append, pCallback);
+    m_pExecutionTaskManager->start(pWriteTask);
+}
+
+void ResponseBody::setExecutionTaskManager(HttpExecutionTaskManager::Ptr pExecutionTaskManager)
+{
+    m_pExecutionTaskManager = pExecutionTaskManager;
+}
+
 } /* namespace easyhttpcpp */
@@ -0,0 +1,93 @@
+/*
+ * Copyright 2019 Sony Corporation
+ */
+
+#include <fstream>
+
+#include "Poco/Buffer.h"
+#include "Poco/Exception.h"
+#include "Poco/File.h"
+
+#include "easyhttpcpp/common/CoreLogger.h"
+#include "easyhttpcpp/common/FileUtil.h"
+#include "easyhttpcpp/common/StringUtil.h"
+#include "easyhttpcpp/HttpException.h"
+
+#include "ResponseBodyFileWriter.h"
+
+using easyhttpcpp::common::FileUtil;
+using easyhttpcpp::common::StringUtil;
+
+namespace easyhttpcpp {
+
+static const std::string Tag = "ResponseBodyFileWriter";
+// multiple of the page size; large enough to keep the number of read/write system calls low.
+static const size_t WriteBufferBytes = 256 * 1024;
+
+Poco::UInt64 ResponseBodyFileWriter::write(ResponseBodyStream& content, const Poco::Path& path, bool append,
+        ssize_t contentLength)
+{
+    std::string filePath = FileUtil::convertToAbsolutePathString(path.toString());
+    Poco::File file(filePath);
+    Poco::UInt64 offset = 0;
+    try {
+        if (append && file.exists()) {
+            offset = file.getSize();
+        }
+    } catch (const Poco::Exception& e) {
+        EASYHTTPCPP_LOG_D(Tag, "write: can not get file size. [%s]", e.message().c_str());
+        throw HttpExecutionException("Can not get size of the file to append to.", e);
+    }
+
+    // std::ofstream hands writes larger than its internal buffer straight to the OS, while
+    // Poco::FileOutputStream would split them into 4KB chunks.
+    std::ios_base::openmode mode = std::ios_base::out | std::ios_base::binary |
+            (append ? std::ios_base::app : std::ios_base::trunc);
+    std::ofstream out(filePath.c_str(), mode);
+    if (!out.is_open()) {
+        std::string message = StringUtil::format("Can not open file to write response body. [%s]", filePath.c_str());
+        EASYHTTPCPP_LOG_D(Tag, "write: %s", message.c_str());
+        throw HttpExecutionException(message);
+    }
+
+    if (contentLength > 0 && !FileUtil::preallocateFile(file, offset, static_cast<Poco::UInt64>(contentLength))) {
+        EASYHTTPCPP_LOG_D(Tag, "write: preallocation is not available. continue without it.");
+    }
+
+    Poco::UInt64 writtenBytes = 0;
+    Poco::Buffer<char> buffer(WriteBufferBytes);
+    while (!content.isEof()) {
+        ssize_t readBytes = content.read(buffer.begin(), WriteBufferBytes);
+        if (readBytes <= 0) {
+            if (content.isEof()) {
+                break;
+            }
+            // a stream which reads nothing before its end would never reach it.
+            EASYHTTPCPP_LOG_D(Tag, "write: can not read before end of response body. [read=%zd, written=%llu]",
+                    readBytes, writtenBytes);
+            throw HttpExecutionException("Can not read response body before end of it.");
+        }
+        out.write(buffer.begin(), static_cast<std::streamsize>(readBytes));
+        if (!out.good()) {
+            EASYHTTPCPP_LOG_D(Tag, "write: ofstream::write failed. [written=%llu]", writtenBytes);
+            throw HttpExecutionException("Can not write response body to file because IO error occurred.");
+        }
+        writtenBytes += static_cast<Poco::UInt64>(readBytes);
+    }
+    out.close();
+    content.close();
+
+    if (out.fail()) {
+        EASYHTTPCPP_LOG_D(Tag, "write: ofstream::close failed.");
+        throw HttpExecutionException("Can not write response body to file because IO error occurred.");
+    }
+    if (contentLength >= 0 && writtenBytes != static_cast<Poco::UInt64>(contentLength)) {
+        std::string message = StringUtil::format("Response body is truncated. [contentLength=%zd, written=%llu]",
+                contentLength, writtenBytes);
+        EASYHTTPCPP_LOG_D(Tag, "write: %s", message.c_str());
+        throw HttpExecutionException(message);
+    }
+    return writtenBytes;
+}
+
+} /* namespace easyhttpcpp */
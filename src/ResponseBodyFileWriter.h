@@ -0,0 +1,28 @@
+/*
+ * Copyright 2019 Sony Corporation
+ */
+
+#ifndef EASYHTTPCPP_RESPONSEBODYFILEWRITER_H_INCLUDED
+#define EASYHTTPCPP_RESPONSEBODYFILEWRITER_H_INCLUDED
+
+#include "Poco/Path.h"
+#include "Poco/Types.h"
+
+#include "easyhttpcpp/HttpExports.h"
+#include "easyhttpcpp/ResponseBodyStream.h"
+
+namespace easyhttpcpp {
+
+class EASYHTTPCPP_HTTP_INTERNAL_API ResponseBodyFileWriter {
+public:
+    // reads content until eof and writes it to path. content is closed when all data is written.
+    static Poco::UInt64 write(ResponseBodyStream& content, const Poco::Path& path, bool append,
+            ssize_t contentLength);
+
+private:
+    ResponseBodyFileWriter();
+};
+
+} /* namespace easyhttpcpp */
+
+#endif /* EASYHTTPCPP_RESPONSEBODYFILEWRITER_H_INCLUDED */
@@ -4,20 +4,24 @@
 
 #include "easyhttpcpp/common/CacheManager.h"
 #include "easyhttpcpp/common/CoreLogger.h"
+#include "easyhttpcpp/common/MappedFileInputStream.h"
+#include "easyhttpcpp/HttpException.h"
 
 #include "HttpCacheInternal.h"
 #include "HttpUtil.h"
 #include "ResponseBodyStreamFromCache.h"
 
 using easyhttpcpp::common::CacheManager;
+using easyhttpcpp::common::MappedFileInputStream;
 
 namespace easyhttpcpp {
 
 static const std::string Tag = "ResponseBodyStreamFromCache";
 
 ResponseBodyStreamFromCache::ResponseBodyStreamFromCache(std::istream* pContent, Response::Ptr pResponse,
-        HttpCache::Ptr pHttpCache) : ResponseBodyStreamInternal(*pContent), m_pContent(pContent),
-        m_pResponse(pResponse), m_pHttpCache(pHttpCache)
+        HttpCache::Ptr pHttpCache, const std::string& key, unsigned int cacheIndex) :
+        ResponseBodyStreamInternal(*pContent), m_pContent(pContent), m_pResponse(pResponse),
+        m_pHttpCache(pHttpCache), m_key(key), m_cacheIndex(cacheIndex)
 {
 }
 
@@ -26,6 +30,25 @@ ResponseBodyStreamFromCache::~ResponseBodyStreamFromCache()
     delete m_pContent;
 }
 
+bool ResponseBodyStreamFromCache::readContiguous(const char*& pData, size_t& size)
+{
+    Poco::Mutex::ScopedLock lock(m_instanceMutex);
+
+    if (m_closed) {
+        std::string message = "stream already closed.";
+        EASYHTTPCPP_LOG_D(Tag, "%s", message.c_str());
+        throw HttpIllegalStateException(message);
+    }
+
+    // only a memory mapped cache file is contiguous.
+    MappedFileInputStream* pMappedFileInputStream = dynamic_cast<MappedFileInputStream*>(m_pContent);
+    if (!pMappedFileInputStream) {
+        return false;
+    }
+    pMappedFileInputStream->readRest(pData, size);
+    return true;
+}
+
 void ResponseBodyStreamFromCache::close()
 {
     Poco::Mutex::ScopedLock lock(m_instanceMutex);
@@ -41,14 +64,8 @@ void ResponseBodyStreamFromCache::close()
     m_pContent = NULL;
 
     HttpCacheInternal* pCacheInternal = static_cast<HttpCacheInternal*> (m_pHttpCache.get());
-    Request::Ptr pRequest = m_pResponse->getRequest();
-    std::string key = HttpUtil::makeCacheKey(pRequest);
-    if (key.empty()) {
-        EASYHTTPCPP_LOG_D(Tag, "close: can not make key.");
-        return;
-    }
     CacheManager::Ptr pCacheManager = pCacheInternal->getCacheManager();
-    pCacheManager->releaseData(key);
+    pCacheManager->releaseData(m_key, m_cacheIndex);
 
     EASYHTTPCPP_LOG_D(Tag, "close: finished");
 }
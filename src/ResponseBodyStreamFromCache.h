@@ -5,6 +5,8 @@
 #ifndef EASYHTTPCPP_RESPONSEBODYSTREAMFROMCACHE_H_INCLUDED
 #define EASYHTTPCPP_RESPONSEBODYSTREAMFROMCACHE_H_INCLUDED
 
+#include <string>
+
 #include "easyhttpcpp/HttpCache.h"
 #include "easyhttpcpp/HttpExports.h"
 #include "easyhttpcpp/Response.h"
@@ -15,13 +17,18 @@ namespace easyhttpcpp {
 
 class EASYHTTPCPP_HTTP_INTERNAL_API ResponseBodyStreamFromCache : public ResponseBodyStreamInternal {
 public:
-    ResponseBodyStreamFromCache(std::istream* pContent, Response::Ptr pResponse, HttpCache::Ptr pHttpCache);
+    // key and cacheIndex are the key and the cache which served pContent; only that cache is released on close.
+    ResponseBodyStreamFromCache(std::istream* pContent, Response::Ptr pResponse, HttpCache::Ptr pHttpCache,
+            const std::string& key, unsigned int cacheIndex);
     virtual ~ResponseBodyStreamFromCache();
+    virtual bool readContiguous(const char*& pData, size_t& size);
     virtual void close();
 private:
     std::istream* m_pContent;
     Response::Ptr m_pResponse;
     HttpCache::Ptr m_pHttpCache;
+    std::string m_key;
+    unsigned int m_cacheIndex;
 };
 
 } /* namespace easyhttpcpp */
@@ -13,6 +13,7 @@
 #include "easyhttpcpp/common/StringUtil.h"
 #include "easyhttpcpp/HttpException.h"
 
+#include "ResponseBodyFileWriter.h"
 #include "ResponseBodyStreamInternal.h"
 
 using easyhttpcpp::common::StringUtil;
@@ -29,7 +30,9 @@ static const std::string Tag = "ResponseBodyStreamInternal";
 static const Poco::Timestamp::TimeDiff ResponseBodySkipTimeout = 100 * 1000;    // micro sec. 100ms
 static const size_t ResponseBodySkipBytes = 8192;
 
-ResponseBodyStreamInternal::ResponseBodyStreamInternal(std::istream& content) : m_closed(false), m_content(content)
+ResponseBodyStreamInternal::ResponseBodyStreamInternal(std::istream& content,
+        Poco::SharedPtr<std::istream> pContentHolder) : m_closed(false), m_content(content),
+        m_pContentHolder(pContentHolder)
 {
 }
 
@@ -126,6 +129,11 @@ void ResponseBodyStreamInternal::close()
     m_closed = true;
 }
 
+Poco::UInt64 ResponseBodyStreamInternal::writeTo(const Poco::Path& path, bool append, ssize_t contentLength)
+{
+    return ResponseBodyFileWriter::write(*this, path, append, contentLength);
+}
+
 bool ResponseBodyStreamInternal::skipAll(PocoHttpClientSessionPtr pPocoHttpClientSession)
 {
     {
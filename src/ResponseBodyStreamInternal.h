@@ -8,6 +8,9 @@
 #include <istream>
 
 #include "Poco/Mutex.h"
+#include "Poco/Path.h"
+#include "Poco/SharedPtr.h"
+#include "Poco/Types.h"
 
 #include "easyhttpcpp/HttpExports.h"
 #include "easyhttpcpp/ResponseBodyStream.h"
@@ -18,12 +21,15 @@ namespace easyhttpcpp {
 
 class EASYHTTPCPP_HTTP_INTERNAL_API ResponseBodyStreamInternal : public ResponseBodyStream {
 public:
-    ResponseBodyStreamInternal(std::istream& content);
+    // pContentHolder keeps a stream layered on the connection (e.g. decompression) alive while content refers to it.
+    ResponseBodyStreamInternal(std::istream& content,
+            Poco::SharedPtr<std::istream> pContentHolder = Poco::SharedPtr<std::istream>());
     virtual ~ResponseBodyStreamInternal();
 
     virtual ssize_t read(char* pBuffer, size_t readBytes);
     virtual bool isEof();
     virtual void close();
+    virtual Poco::UInt64 writeTo(const Poco::Path& path, bool append, ssize_t contentLength);
 
 protected:
     virtual bool skipAll(PocoHttpClientSessionPtr pPocoHttpClientSession);
@@ -31,6 +37,7 @@ protected:
     Poco::Mutex m_instanceMutex;
     bool m_closed;
     std::istream& m_content;
+    Poco::SharedPtr<std::istream> m_pContentHolder;
 };
 
 } /* namespace easyhttpcpp */
@@ -2,10 +2,14 @@
  * Copyright 2017 Sony Corporation
  */
 
+#include "Poco/Buffer.h"
 #include "Poco/Exception.h"
 #include "Poco/File.h"
 #include "Poco/FileStream.h"
+#include "Poco/Net/StreamSocket.h"
+#include "Poco/ScopedUnlock.h"
 #include "Poco/TemporaryFile.h"
+#include "Poco/Timespan.h"
 #include "Poco/Timestamp.h"
 
 #include "easyhttpcpp/common/CoreLogger.h"
@@ -13,8 +17,10 @@
 #include "easyhttpcpp/common/FileUtil.h"
 #include "easyhttpcpp/HttpException.h"
 
+#include "HttpCacheFillTask.h"
 #include "HttpCacheInternal.h"
 #include "HttpCacheMetadata.h"
+#include "HttpInternalConstants.h"
 #include "HttpUtil.h"
 #include "ResponseBodyStreamWithCaching.h"
 
@@ -29,21 +35,28 @@ static const std::string Tag = "ResponseBodyStreamWithCaching";
 
 ResponseBodyStreamWithCaching::ResponseBodyStreamWithCaching(std::istream& content,
         ConnectionInternal::Ptr pConnectionInternal, ConnectionPoolInternal::Ptr pConnectionPoolInternal,
-        Response::Ptr pResponse, HttpCache::Ptr pHttpCache) :
-        ResponseBodyStreamInternal(content), m_pConnectionInternal(pConnectionInternal),
+        Response::Ptr pResponse, HttpCache::Ptr pHttpCache, Poco::SharedPtr<std::istream> pContentHolder) :
+        ResponseBodyStreamInternal(content, pContentHolder), m_pConnectionInternal(pConnectionInternal),
         m_pConnectionPoolInternal(pConnectionPoolInternal), m_pResponse(pResponse), m_pHttpCache(pHttpCache),
-        m_pTempFileStream(NULL), m_writtenDataSize(0)
+        m_writtenDataSize(0), m_cacheFillDropped(false), m_tempFileFailed(false), m_waitForCacheWriter(false),
+        m_pPrefixStream(NULL), m_prefixRemainingBytes(0)
 {
 }
 
 ResponseBodyStreamWithCaching::~ResponseBodyStreamWithCaching()
 {
     closeOutStream();
+    closePrefix();
+    // not closed, or close failed.
+    endFlight();
 }
 
 ssize_t ResponseBodyStreamWithCaching::read(char* pBuffer, size_t readBytes)
 {
-    ssize_t retBytes = ResponseBodyStreamInternal::read(pBuffer, readBytes);
+    ssize_t retBytes = readPrefix(pBuffer, readBytes);
+    if (retBytes == 0) {
+        retBytes = ResponseBodyStreamInternal::read(pBuffer, readBytes);
+    }
     if (retBytes < 0) {
         return retBytes;
     }
@@ -55,21 +68,46 @@ ssize_t ResponseBodyStreamWithCaching::read(char* pBuffer, size_t readBytes)
     }
 
     // save temp file for cache
-    if (!createTempFile()) {
+    if (m_cacheFillDropped || !createTempFile()) {
         return retBytes;
     }
 
-    try {
-        m_pTempFileStream->write(static_cast<const char*> (pBuffer), static_cast<std::streamsize> (retBytes));
-        m_writtenDataSize += retBytes;
-    } catch (const std::exception& e) {
-        std::string message = "can not receive response because IO error occurred.(write)";
-        EASYHTTPCPP_LOG_D(Tag, "%s %s", message.c_str(), e.what());
+    // the bytes are written by the cache writer thread, so that reading does not wait for the disk.
+    HttpCacheInternal* pCacheInternal = static_cast<HttpCacheInternal*> (m_pHttpCache.get());
+    HttpCacheWriter::Output::Ptr pOutput = m_pTempFileOutput;
+    bool written;
+    if (m_waitForCacheWriter) {
+        // waiting for room in the queue does not block close and isEof of this stream.
+        Poco::ScopedUnlock<Poco::Mutex> unlock(m_instanceMutex);
+        written = pCacheInternal->getCacheWriter()->write(pOutput, pBuffer, static_cast<size_t> (retBytes), true);
+    } else {
+        written = pCacheInternal->getCacheWriter()->write(pOutput, pBuffer, static_cast<size_t> (retBytes), false);
     }
+    if (m_closed || m_pTempFileOutput != pOutput) {
+        EASYHTTPCPP_LOG_D(Tag, "read: closed while waiting for cache writer.");
+        return retBytes;
+    }
+    if (!written) {
+        EASYHTTPCPP_LOG_D(Tag, "read: cache writer is busy, so the rest of response body is not cached.");
+        m_cacheFillDropped = true;
+        return retBytes;
+    }
+    m_writtenDataSize += retBytes;
 
     return retBytes;
 }
 
+bool ResponseBodyStreamWithCaching::isEof()
+{
+    {
+        Poco::Mutex::ScopedLock lock(m_instanceMutex);
+        if (!m_closed && m_prefixRemainingBytes > 0) {
+            return false;
+        }
+    }
+    return ResponseBodyStreamInternal::isEof();
+}
+
 void ResponseBodyStreamWithCaching::close()
 {
     Poco::Mutex::ScopedLock lock(m_instanceMutex);
@@ -79,8 +117,26 @@ void ResponseBodyStreamWithCaching::close()
         return;
     }
 
+    if (startBackgroundCacheFill()) {
+        ResponseBodyStreamInternal::close();
+        EASYHTTPCPP_LOG_D(Tag, "close: the rest of response body is read in background");
+        return;
+    }
+
     // skip remaining data, if exist.
-    if (skipAll(m_pConnectionInternal->getPocoHttpClientSession())) {
+    bool connectionReusable = skipAll(m_pConnectionInternal->getPocoHttpClientSession());
+    bool responseBodyValid = isValidResponseBody(isEof());
+
+    ResponseBodyStreamInternal::close();
+
+    finishCaching(connectionReusable, responseBodyValid);
+
+    EASYHTTPCPP_LOG_D(Tag, "close: finished");
+}
+
+void ResponseBodyStreamWithCaching::finishCaching(bool connectionReusable, bool responseBodyValid)
+{
+    if (connectionReusable) {
         EASYHTTPCPP_LOG_D(Tag, "Connection is reusable.");
         // release connection.
         m_pConnectionPoolInternal->releaseConnection(m_pConnectionInternal);
@@ -92,21 +148,43 @@ void ResponseBodyStreamWithCaching::close()
     m_pConnectionInternal = NULL;
     m_pConnectionPoolInternal = NULL;
 
-    bool responseBodyValid = isValidResponseBody();
-
-    ResponseBodyStreamInternal::close();
-
-    // put cache
+    // put cache after the cache writer has written the temp file.
     closeOutStream();
+    closePrefix();
 
-    if (responseBodyValid) {
+    if (m_tempFileFailed) {
+        EASYHTTPCPP_LOG_D(Tag, "remove TempFile, because it could not be written");
+        removeTempFile();
+    } else if (responseBodyValid) {
         putCache();
+    } else if (putPartialContent()) {
+        EASYHTTPCPP_LOG_D(Tag, "keep TempFile as partial content, because response body is truncated");
     } else {
         EASYHTTPCPP_LOG_D(Tag, "remove TempFile, because response body is not valid");
         removeTempFile();
     }
+    endFlight();
+}
 
-    EASYHTTPCPP_LOG_D(Tag, "close: finished");
+Poco::UInt64 ResponseBodyStreamWithCaching::writeTo(const Poco::Path& path, bool append, ssize_t contentLength)
+{
+    {
+        Poco::Mutex::ScopedLock lock(m_instanceMutex);
+        if (m_closed) {
+            EASYHTTPCPP_LOG_D(Tag, "writeTo: already closed.");
+            throw HttpIllegalStateException("stream already closed.");
+        }
+        // the destination file is written first; the temp file for cache is filled by read on the way, and
+        // caching is best-effort, so that a failure of the cache does not fail the download.
+        if (createTempFile()) {
+            m_waitForCacheWriter = true;
+            if (contentLength > 0) {
+                FileUtil::preallocateFile(Poco::File(m_tempFilePath), 0, static_cast<Poco::UInt64>(contentLength));
+            }
+        }
+    }
+
+    return ResponseBodyStreamInternal::writeTo(path, append, contentLength);
 }
 
 Connection::Ptr ResponseBodyStreamWithCaching::getConnection()
@@ -114,9 +192,200 @@ Connection::Ptr ResponseBodyStreamWithCaching::getConnection()
     return m_pConnectionInternal.unsafeCast<Connection>();
 }
 
+void ResponseBodyStreamWithCaching::setPrefix(Poco::FileInputStream* pPrefixStream, const std::string& prefixFilePath,
+        Poco::UInt64 prefixBytes)
+{
+    Poco::Mutex::ScopedLock lock(m_instanceMutex);
+
+    m_pPrefixStream = pPrefixStream;
+    m_prefixFilePath = prefixFilePath;
+    m_prefixRemainingBytes = prefixBytes;
+}
+
+void ResponseBodyStreamWithCaching::setCacheKey(const std::string& cacheKey)
+{
+    Poco::Mutex::ScopedLock lock(m_instanceMutex);
+
+    m_cacheKey = cacheKey;
+}
+
+void ResponseBodyStreamWithCaching::setFlightKey(const std::string& flightKey)
+{
+    Poco::Mutex::ScopedLock lock(m_instanceMutex);
+
+    m_flightKey = flightKey;
+}
+
+void ResponseBodyStreamWithCaching::setBackgroundCacheFill(EasyHttpContext::Ptr pContext)
+{
+    Poco::Mutex::ScopedLock lock(m_instanceMutex);
+
+    m_pBackgroundCacheFillContext = pContext;
+}
+
+void ResponseBodyStreamWithCaching::fillCacheInBackground(HttpExecutionTask::Ptr pTask)
+{
+    // the stream is already closed for the user, so only this task reads the content; the lock is taken to finish.
+    bool completed = readRest(pTask);
+
+    Poco::Mutex::ScopedLock lock(m_instanceMutex);
+
+    // a cancelled fill may have shut down the socket.
+    bool connectionReusable = completed && !pTask->isCancelled();
+    finishCaching(connectionReusable, connectionReusable && isValidResponseBody(true));
+}
+
+void ResponseBodyStreamWithCaching::cancelBackgroundCacheFill()
+{
+    Poco::Mutex::ScopedLock lock(m_instanceMutex);
+
+    // after finishCaching, the connection may already be used by another request.
+    if (!m_pConnectionInternal) {
+        return;
+    }
+    try {
+        m_pConnectionInternal->getPocoHttpClientSession()->socket().shutdownReceive();
+    } catch (const Poco::Exception& e) {
+        EASYHTTPCPP_LOG_D(Tag, "cancelBackgroundCacheFill: can not shut down socket. Details: %s",
+                e.message().c_str());
+    }
+}
+
+bool ResponseBodyStreamWithCaching::startBackgroundCacheFill()
+{
+    // the prefix is read only through read(), so a stream closed within the prefix is not filled in background.
+    if (!m_pBackgroundCacheFillContext || m_cacheFillDropped || m_tempFileFailed || m_prefixRemainingBytes > 0 ||
+            m_content.eof()) {
+        return false;
+    }
+    Poco::UInt64 maxBytes = m_pBackgroundCacheFillContext->getBackgroundCacheFillMaxBytes();
+    ssize_t contentLength = m_pResponse->hasContentLength() ? m_pResponse->getContentLength() : -1;
+    if (contentLength >= 0 && contentLength > m_writtenDataSize &&
+            static_cast<Poco::UInt64>(contentLength - m_writtenDataSize) > maxBytes) {
+        EASYHTTPCPP_LOG_D(Tag, "startBackgroundCacheFill: the rest is over the budget. [%zd bytes]",
+                contentLength - m_writtenDataSize);
+        return false;
+    }
+
+    HttpExecutionTaskManager::Ptr pExecutionTaskManager =
+            m_pBackgroundCacheFillContext->getHttpExecutionTaskManager();
+    if (!pExecutionTaskManager) {
+        return false;
+    }
+    HttpCacheFillTask::Ptr pCacheFillTask = new HttpCacheFillTask(m_pBackgroundCacheFillContext,
+            ResponseBodyStream::Ptr(this, true));
+    try {
+        pExecutionTaskManager->start(pCacheFillTask);
+    } catch (const HttpException& e) {
+        EASYHTTPCPP_LOG_D(Tag, "startBackgroundCacheFill: can not start. Details: %s", e.getMessage().c_str());
+        return false;
+    }
+    return true;
+}
+
+bool ResponseBodyStreamWithCaching::readRest(HttpExecutionTask::Ptr pTask)
+{
+    Poco::UInt64 maxBytes = m_pBackgroundCacheFillContext->getBackgroundCacheFillMaxBytes();
+    Poco::Timestamp::TimeDiff timeout = static_cast<Poco::Timestamp::TimeDiff> (
+            m_pBackgroundCacheFillContext->getBackgroundCacheFillTimeoutSec()) * Poco::Timestamp::resolution();
+    Poco::Net::StreamSocket& socket = m_pConnectionInternal->getPocoHttpClientSession()->socket();
+    Poco::Timespan originalTimeout;
+    try {
+        originalTimeout = socket.getReceiveTimeout();
+    } catch (const Poco::Exception& e) {
+        EASYHTTPCPP_LOG_D(Tag, "readRest: Could not get socket receive timeout. Details: %s", e.message().c_str());
+        return false;
+    }
+
+    HttpCacheInternal* pCacheInternal = static_cast<HttpCacheInternal*> (m_pHttpCache.get());
+    HttpCacheWriter::Ptr pCacheWriter = pCacheInternal->getCacheWriter();
+    Poco::Buffer<char> buffer(HttpInternalConstants::BackgroundCacheFills::ReadBufferBytes);
+    Poco::UInt64 readBytes = 0;
+    Poco::Timestamp startTime;
+    bool completed = false;
+    try {
+        while (!pTask->isCancelled()) {
+            if (m_content.eof()) {
+                completed = true;
+                break;
+            }
+            Poco::Timestamp::TimeDiff remainingTime = timeout - startTime.elapsed();
+            if (remainingTime <= 0 || readBytes >= maxBytes) {
+                EASYHTTPCPP_LOG_D(Tag, "readRest: over the budget. [%llu bytes]", readBytes);
+                break;
+            }
+            // a slow server does not keep the connection beyond the time budget.
+            socket.setReceiveTimeout(Poco::Timespan(remainingTime));
+            m_content.read(buffer.begin(), static_cast<std::streamsize> (buffer.size()));
+            if (!m_content && !m_content.eof()) {
+                EASYHTTPCPP_LOG_D(Tag, "readRest: istream::read failed.");
+                break;
+            }
+            std::streamsize bytes = m_content.gcount();
+            if (bytes <= 0) {
+                continue;
+            }
+            // nobody waits for this read, so the cache writer is waited for instead of dropping.
+            if (!createTempFile() || !pCacheWriter->write(m_pTempFileOutput, buffer.begin(),
+                    static_cast<size_t> (bytes), true)) {
+                break;
+            }
+            m_writtenDataSize += bytes;
+            readBytes += bytes;
+        }
+    } catch (const Poco::Exception& e) {
+        EASYHTTPCPP_LOG_D(Tag, "readRest: Poco::Exception %s", e.message().c_str());
+        completed = false;
+    } catch (const std::exception& e) {
+        EASYHTTPCPP_LOG_D(Tag, "readRest: std::exception %s", e.what());
+        completed = false;
+    }
+
+    try {
+        socket.setReceiveTimeout(originalTimeout);
+    } catch (const Poco::Exception& e) {
+        EASYHTTPCPP_LOG_D(Tag, "readRest: Could not reset socket receive timeout. Details: %s", e.message().c_str());
+        completed = false;
+    }
+    return completed;
+}
+
+ssize_t ResponseBodyStreamWithCaching::readPrefix(char* pBuffer, size_t readBytes)
+{
+    Poco::Mutex::ScopedLock lock(m_instanceMutex);
+
+    // argument and state errors are reported by ResponseBodyStreamInternal::read.
+    if (m_closed || m_prefixRemainingBytes == 0 || pBuffer == NULL || readBytes == 0) {
+        return 0;
+    }
+    size_t prefixBytes = m_prefixRemainingBytes < readBytes ? static_cast<size_t>(m_prefixRemainingBytes) : readBytes;
+    m_pPrefixStream->read(pBuffer, static_cast<std::streamsize>(prefixBytes));
+    ssize_t retBytes = m_pPrefixStream->gcount();
+    if (retBytes <= 0) {
+        EASYHTTPCPP_LOG_D(Tag, "readPrefix: can not read prefix file.");
+        throw HttpExecutionException("can not receive response because IO error occurred.(read partial content)");
+    }
+    m_prefixRemainingBytes -= retBytes;
+    return retBytes;
+}
+
+void ResponseBodyStreamWithCaching::closePrefix()
+{
+    if (m_pPrefixStream) {
+        m_pPrefixStream->close();
+        delete m_pPrefixStream;
+        m_pPrefixStream = NULL;
+        m_prefixRemainingBytes = 0;
+    }
+    if (!m_prefixFilePath.empty()) {
+        FileUtil::removeFileIfPresent(Poco::File(m_prefixFilePath));
+        m_prefixFilePath.clear();
+    }
+}
+
 bool ResponseBodyStreamWithCaching::createTempFile()
 {
-    if (m_pTempFileStream) {
+    if (m_pTempFileOutput) {
         return true;
     }
 
@@ -127,48 +396,79 @@ bool ResponseBodyStreamWithCaching::createTempFile()
         EASYHTTPCPP_LOG_D(Tag, "tempFile=%s", m_tempFilePath.c_str());
     } catch (const HttpException& e) {
         EASYHTTPCPP_LOG_D(Tag, "can not get temp directory. HttpException=%s", e.getMessage().c_str());
-        m_pTempFileStream = NULL;
+        m_pTempFileOutput = NULL;
         m_tempFilePath.clear();
         return false;
     }
 
     try {
-        m_pTempFileStream = new Poco::FileOutputStream(m_tempFilePath,
+        Poco::FileOutputStream* pStream = new Poco::FileOutputStream(m_tempFilePath,
                 std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+        m_pTempFileOutput = new HttpCacheWriter::Output(pStream, createCompressedTempFile());
         m_writtenDataSize = 0;
 
     } catch (const HttpException& e) {
         EASYHTTPCPP_LOG_D(Tag, "can not create temp file. HttpException=%s", e.getMessage().c_str());
-        m_pTempFileStream = NULL;
+        m_pTempFileOutput = NULL;
         m_tempFilePath.clear();
         return false;
     } catch (const Poco::Exception& e) {
         EASYHTTPCPP_LOG_D(Tag, "can not create temp file. Poco::Exception=%s", e.message().c_str());
-        m_pTempFileStream = NULL;
+        m_pTempFileOutput = NULL;
         m_tempFilePath.clear();
         return false;
     } catch (const std::exception& e) {
         EASYHTTPCPP_LOG_D(Tag, "can not create temp file. std::exception=%s", e.what());
-        m_pTempFileStream = NULL;
+        m_pTempFileOutput = NULL;
         m_tempFilePath.clear();
         return false;
     }
     return true;
 }
 
-void ResponseBodyStreamWithCaching::closeOutStream()
+Poco::FileOutputStream* ResponseBodyStreamWithCaching::createCompressedTempFile()
+{
+    // the response body is compressed while it is written, so that putting the cache does not compress it.
+    HttpCacheInternal* pCacheInternal = static_cast<HttpCacheInternal*> (m_pHttpCache.get());
+    if (!pCacheInternal->isCompressingResponseBody(m_pResponse)) {
+        return NULL;
+    }
+    try {
+        m_compressedTempFilePath = Poco::TemporaryFile::tempName(pCacheInternal->getTempDirectory());
+        return new Poco::FileOutputStream(m_compressedTempFilePath,
+                std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+    } catch (const HttpException& e) {
+        EASYHTTPCPP_LOG_D(Tag, "can not create compressed temp file. HttpException=%s", e.getMessage().c_str());
+    } catch (const Poco::Exception& e) {
+        EASYHTTPCPP_LOG_D(Tag, "can not create compressed temp file. Poco::Exception=%s", e.message().c_str());
+    }
+    removeCompressedTempFile();
+    return NULL;
+}
+
+bool ResponseBodyStreamWithCaching::closeOutStream()
 {
-    if (m_pTempFileStream) {
-        m_pTempFileStream->close();
-        delete m_pTempFileStream;
-        m_pTempFileStream = NULL;
+    if (m_pTempFileOutput) {
+        HttpCacheInternal* pCacheInternal = static_cast<HttpCacheInternal*> (m_pHttpCache.get());
+        if (!pCacheInternal->getCacheWriter()->close(m_pTempFileOutput)) {
+            EASYHTTPCPP_LOG_D(Tag, "closeOutStream: can not write temp file. [%s]", m_tempFilePath.c_str());
+            m_tempFileFailed = true;
+        }
+        if (!m_pTempFileOutput->isCompressed()) {
+            removeCompressedTempFile();
+        }
+        m_pTempFileOutput = NULL;
     }
+    return !m_tempFileFailed;
 }
 
-bool ResponseBodyStreamWithCaching::isValidResponseBody()
+bool ResponseBodyStreamWithCaching::isValidResponseBody(bool eof)
 {
+    if (m_cacheFillDropped) {
+        return false;
+    }
     if (!m_pResponse->hasContentLength()) {
-        if (isEof()) {
+        if (eof) {
             return true;
         } else {
             return false;
@@ -176,7 +476,7 @@ bool ResponseBodyStreamWithCaching::isValidResponseBody()
     }
     ssize_t contentLength = m_pResponse->getContentLength();
     if (contentLength == -1) {
-        if (isEof()) {
+        if (eof) {
             return true;
         } else {
             return false;
@@ -190,6 +490,7 @@ bool ResponseBodyStreamWithCaching::isValidResponseBody()
 
 void ResponseBodyStreamWithCaching::removeTempFile()
 {
+    removeCompressedTempFile();
     if (m_tempFilePath.empty()) {
         EASYHTTPCPP_LOG_D(Tag, "removeTempFile: temporary file is not created.");
         return;
@@ -202,12 +503,54 @@ void ResponseBodyStreamWithCaching::removeTempFile()
     }
 }
 
+void ResponseBodyStreamWithCaching::removeCompressedTempFile()
+{
+    if (m_compressedTempFilePath.empty()) {
+        return;
+    }
+    // the gzip copy is best-effort, so that a file left behind is cleaned up with the temp directory.
+    FileUtil::removeFileIfPresent(Poco::File(m_compressedTempFilePath));
+    m_compressedTempFilePath.clear();
+}
+
+const std::string& ResponseBodyStreamWithCaching::getCacheKey()
+{
+    if (m_cacheKey.empty()) {
+        HttpCacheInternal* pCacheInternal = static_cast<HttpCacheInternal*> (m_pHttpCache.get());
+        m_cacheKey = pCacheInternal->makeCacheKey(m_pResponse->getRequest());
+    }
+    return m_cacheKey;
+}
+
+bool ResponseBodyStreamWithCaching::putPartialContent()
+{
+    // a resumed download appends to the uncompressed bytes.
+    removeCompressedTempFile();
+    if (m_tempFilePath.empty() || m_writtenDataSize <= 0) {
+        return false;
+    }
+    HttpCacheInternal* pCacheInternal = static_cast<HttpCacheInternal*> (m_pHttpCache.get());
+    return pCacheInternal->putPartialContent(m_pResponse, getCacheKey(), m_tempFilePath,
+            static_cast<Poco::UInt64>(m_writtenDataSize));
+}
+
+void ResponseBodyStreamWithCaching::endFlight()
+{
+    if (m_flightKey.empty()) {
+        return;
+    }
+    HttpCacheInternal* pCacheInternal = static_cast<HttpCacheInternal*> (m_pHttpCache.get());
+    pCacheInternal->endFlight(m_flightKey);
+    m_flightKey.clear();
+}
+
 void ResponseBodyStreamWithCaching::putCache()
 {
     CacheMetadata::Ptr pCacheMetadata = new HttpCacheMetadata();
     HttpCacheMetadata* pHttpCacheMetadata = static_cast<HttpCacheMetadata*> (pCacheMetadata.get());
     Request::Ptr pRequest = m_pResponse->getRequest();
-    pHttpCacheMetadata->setKey(HttpUtil::makeCacheKey(pRequest));
+    HttpCacheInternal* pCacheInternal = static_cast<HttpCacheInternal*> (m_pHttpCache.get());
+    pHttpCacheMetadata->setKey(getCacheKey());
     if (pHttpCacheMetadata->getKey().empty()) {
         EASYHTTPCPP_LOG_D(Tag, "putCache: can not make key.");
         removeTempFile();
@@ -218,13 +561,17 @@ void ResponseBodyStreamWithCaching::putCache()
     pHttpCacheMetadata->setStatusCode(m_pResponse->getCode());
     pHttpCacheMetadata->setStatusMessage(m_pResponse->getMessage());
     pHttpCacheMetadata->setResponseHeaders(m_pResponse->getHeaders());
-    pHttpCacheMetadata->setResponseBodySize(m_writtenDataSize);
+    // the size of the stored body, so that the cache size is limited by the bytes on disk.
+    size_t bodySize = static_cast<size_t>(m_writtenDataSize);
+    pHttpCacheMetadata->setResponseBodyCompressed(pCacheInternal->useCompressedResponseBody(m_tempFilePath, bodySize,
+            m_compressedTempFilePath));
+    m_compressedTempFilePath.clear();
+    pHttpCacheMetadata->setResponseBodySize(bodySize);
     pHttpCacheMetadata->setSentRequestAtEpoch(m_pResponse->getSentRequestSec());
     pHttpCacheMetadata->setReceivedResponseAtEpoch(m_pResponse->getReceivedResponseSec());
     Poco::Timestamp now;
     pHttpCacheMetadata->setCreatedAtEpoch(now.epochTime());
 
-    HttpCacheInternal* pCacheInternal = static_cast<HttpCacheInternal*> (m_pHttpCache.get());
     CacheManager::Ptr pCacheManager = pCacheInternal->getCacheManager();
     if (!pCacheManager->put(pHttpCacheMetadata->getKey(), pCacheMetadata, m_tempFilePath)) {
         EASYHTTPCPP_LOG_D(Tag, "putCache: can not put cache[%s].", pHttpCacheMetadata->getKey().c_str());
@@ -18,7 +18,10 @@
 
 #include "ConnectionInternal.h"
 #include "ConnectionPoolInternal.h"
+#include "EasyHttpContext.h"
+#include "HttpCacheWriter.h"
 #include "HttpEngine.h"
+#include "HttpExecutionTask.h"
 #include "ResponseBodyStreamInternal.h"
 
 namespace easyhttpcpp {
@@ -26,27 +29,69 @@ namespace easyhttpcpp {
 class EASYHTTPCPP_HTTP_INTERNAL_API ResponseBodyStreamWithCaching : public ResponseBodyStreamInternal {
 public:
     ResponseBodyStreamWithCaching(std::istream& content, ConnectionInternal::Ptr pConnectionInternal,
-            ConnectionPoolInternal::Ptr pConnectionPoolInternal, Response::Ptr pResponse, HttpCache::Ptr pHttpCache);
+            ConnectionPoolInternal::Ptr pConnectionPoolInternal, Response::Ptr pResponse, HttpCache::Ptr pHttpCache,
+            Poco::SharedPtr<std::istream> pContentHolder = Poco::SharedPtr<std::istream>());
     virtual ~ResponseBodyStreamWithCaching();
     virtual ssize_t read(char* pBuffer, size_t readBytes);
+    virtual bool isEof();
     virtual void close();
+    virtual Poco::UInt64 writeTo(const Poco::Path& path, bool append, ssize_t contentLength);
 
     Connection::Ptr getConnection();    // for test
 
+    // the body starts with prefixBytes of pPrefixStream, which is owned by this stream.
+    // prefixFilePath is removed on close.
+    void setPrefix(Poco::FileInputStream* pPrefixStream, const std::string& prefixFilePath, Poco::UInt64 prefixBytes);
+
+    // the cache key made by HttpEngine for the call; if not set, it is made from the request when it is needed.
+    void setCacheKey(const std::string& cacheKey);
+
+    // this stream is the leader of coalesced requests of the key; the flight ends when the cache is put.
+    void setFlightKey(const std::string& flightKey);
+
+    // when closed before the end, the rest of the body is read by HttpCacheFillTask within the budgets of pContext.
+    void setBackgroundCacheFill(EasyHttpContext::Ptr pContext);
+    void fillCacheInBackground(HttpExecutionTask::Ptr pTask);
+    void cancelBackgroundCacheFill();
+
 private:
+    bool startBackgroundCacheFill();
+    bool readRest(HttpExecutionTask::Ptr pTask);
+    void finishCaching(bool connectionReusable, bool responseBodyValid);
+    ssize_t readPrefix(char* pBuffer, size_t readBytes);
+    void closePrefix();
     bool createTempFile();
-    void closeOutStream();
-    bool isValidResponseBody();
+    Poco::FileOutputStream* createCompressedTempFile();
+    bool closeOutStream();
+    bool isValidResponseBody(bool eof);
     void removeTempFile();
+    void removeCompressedTempFile();
     void putCache();
+    const std::string& getCacheKey();
+    bool putPartialContent();
+    void endFlight();
     
     ConnectionInternal::Ptr m_pConnectionInternal;
     ConnectionPoolInternal::Ptr m_pConnectionPoolInternal;
     Response::Ptr m_pResponse;
     HttpCache::Ptr m_pHttpCache;
     std::string m_tempFilePath;
-    Poco::FileOutputStream* m_pTempFileStream;
+    // the temp file is written by the cache writer thread.
+    HttpCacheWriter::Output::Ptr m_pTempFileOutput;
+    // the gzip copy of the temp file, which is deflated by the cache writer thread as well.
+    std::string m_compressedTempFilePath;
     ssize_t m_writtenDataSize;
+    // the cache writer was too busy to take more bytes; the temp file holds the bytes before them.
+    bool m_cacheFillDropped;
+    bool m_tempFileFailed;
+    // writeTo reads the whole body anyway, so it waits for the cache writer instead of dropping the cache fill.
+    bool m_waitForCacheWriter;
+    std::string m_prefixFilePath;
+    Poco::FileInputStream* m_pPrefixStream;
+    Poco::UInt64 m_prefixRemainingBytes;
+    std::string m_cacheKey;
+    std::string m_flightKey;
+    EasyHttpContext::Ptr m_pBackgroundCacheFillContext;
 };
 
 } /* namespace easyhttpcpp */
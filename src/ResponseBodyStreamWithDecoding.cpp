@@ -0,0 +1,115 @@
+/*
+ * Copyright 2019 Sony Corporation
+ */
+
+#include "Poco/Exception.h"
+
+#include "easyhttpcpp/common/CoreLogger.h"
+#include "easyhttpcpp/HttpException.h"
+
+#include "HttpInternalConstants.h"
+#include "HttpUtil.h"
+#include "ResponseBodyStreamWithDecoding.h"
+
+namespace easyhttpcpp {
+
+static const std::string Tag = "ResponseBodyStreamWithDecoding";
+
+ResponseBodyStreamBuf::ResponseBodyStreamBuf(ResponseBodyStream::Ptr pSource) :
+        Poco::BufferedStreamBuf(HttpInternalConstants::ContentEncodings::DecodingBufferBytes, std::ios::in),
+        m_pSource(pSource)
+{
+}
+
+ResponseBodyStreamBuf::~ResponseBodyStreamBuf()
+{
+}
+
+int ResponseBodyStreamBuf::readFromDevice(char* pBuffer, std::streamsize length)
+{
+    try {
+        while (!m_pSource->isEof()) {
+            ssize_t retBytes = m_pSource->read(pBuffer, static_cast<size_t>(length));
+            if (retBytes > 0) {
+                return static_cast<int>(retBytes);
+            }
+            if (retBytes < 0) {
+                break;
+            }
+        }
+        return -1;
+    } catch (const HttpException& e) {
+        throw Poco::IOException(e.getMessage());
+    }
+}
+
+ResponseBodyStreamWithDecoding::ResponseBodyStreamWithDecoding(ResponseBodyStream::Ptr pSource,
+        const std::string& contentEncoding) : m_closed(false), m_pSource(pSource), m_sourceStreamBuf(pSource),
+        m_sourceStream(&m_sourceStreamBuf)
+{
+    m_pDecodingStream = HttpUtil::createDecodingInputStream(m_sourceStream, contentEncoding);
+    if (!m_pDecodingStream) {
+        std::string message = "Content-Encoding [" + contentEncoding + "] is not supported.";
+        EASYHTTPCPP_LOG_D(Tag, "%s", message.c_str());
+        throw HttpIllegalArgumentException(message);
+    }
+}
+
+ResponseBodyStreamWithDecoding::~ResponseBodyStreamWithDecoding()
+{
+    close();
+}
+
+ssize_t ResponseBodyStreamWithDecoding::read(char* pBuffer, size_t readBytes)
+{
+    {
+        Poco::Mutex::ScopedLock lock(m_instanceMutex);
+        if (m_closed) {
+            std::string message = "stream already closed.";
+            EASYHTTPCPP_LOG_D(Tag, "%s", message.c_str());
+            throw HttpIllegalStateException(message);
+        }
+    }
+    if (pBuffer == NULL) {
+        std::string message = "pBuffer is NULL.";
+        EASYHTTPCPP_LOG_D(Tag, "%s", message.c_str());
+        throw HttpIllegalArgumentException(message);
+    }
+
+    if (m_pDecodingStream->eof()) {
+        return -1;
+    }
+    m_pDecodingStream->read(pBuffer, readBytes);
+    if (!*m_pDecodingStream && !m_pDecodingStream->eof()) {
+        EASYHTTPCPP_LOG_D(Tag, "read: can not decompress response body.[fail:%d, bad:%d]",
+                m_pDecodingStream->fail(), m_pDecodingStream->bad());
+        throw HttpExecutionException("can not decompress response body.");
+    }
+    return m_pDecodingStream->gcount();
+}
+
+bool ResponseBodyStreamWithDecoding::isEof()
+{
+    Poco::Mutex::ScopedLock lock(m_instanceMutex);
+    if (m_closed) {
+        std::string message = "stream already closed.";
+        EASYHTTPCPP_LOG_D(Tag, "%s", message.c_str());
+        throw HttpIllegalStateException(message);
+    }
+    return m_pDecodingStream->eof();
+}
+
+void ResponseBodyStreamWithDecoding::close()
+{
+    {
+        Poco::Mutex::ScopedLock lock(m_instanceMutex);
+        if (m_closed) {
+            return;
+        }
+        m_closed = true;
+    }
+    m_pSource->close();
+    EASYHTTPCPP_LOG_D(Tag, "close: finished");
+}
+
+} /* namespace easyhttpcpp */
@@ -0,0 +1,53 @@
+/*
+ * Copyright 2019 Sony Corporation
+ */
+
+#ifndef EASYHTTPCPP_RESPONSEBODYSTREAMWITHDECODING_H_INCLUDED
+#define EASYHTTPCPP_RESPONSEBODYSTREAMWITHDECODING_H_INCLUDED
+
+#include <istream>
+#include <string>
+
+#include "Poco/BufferedStreamBuf.h"
+#include "Poco/Mutex.h"
+#include "Poco/SharedPtr.h"
+
+#include "easyhttpcpp/HttpExports.h"
+#include "easyhttpcpp/ResponseBodyStream.h"
+
+namespace easyhttpcpp {
+
+class EASYHTTPCPP_HTTP_INTERNAL_API ResponseBodyStreamBuf : public Poco::BufferedStreamBuf {
+public:
+    ResponseBodyStreamBuf(ResponseBodyStream::Ptr pSource);
+    virtual ~ResponseBodyStreamBuf();
+
+protected:
+    virtual int readFromDevice(char* pBuffer, std::streamsize length);
+
+private:
+    ResponseBodyStream::Ptr m_pSource;
+};
+
+// decompresses a response body with Content-Encoding, e.g. the one stored in the cache as received.
+class EASYHTTPCPP_HTTP_INTERNAL_API ResponseBodyStreamWithDecoding : public ResponseBodyStream {
+public:
+    ResponseBodyStreamWithDecoding(ResponseBodyStream::Ptr pSource, const std::string& contentEncoding);
+    virtual ~ResponseBodyStreamWithDecoding();
+
+    virtual ssize_t read(char* pBuffer, size_t readBytes);
+    virtual bool isEof();
+    virtual void close();
+
+private:
+    Poco::Mutex m_instanceMutex;
+    bool m_closed;
+    ResponseBodyStream::Ptr m_pSource;
+    ResponseBodyStreamBuf m_sourceStreamBuf;
+    std::istream m_sourceStream;
+    Poco::SharedPtr<std::istream> m_pDecodingStream;
+};
+
+} /* namespace easyhttpcpp */
+
+#endif /* EASYHTTPCPP_RESPONSEBODYSTREAMWITHDECODING_H_INCLUDED */
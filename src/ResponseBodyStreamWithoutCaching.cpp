@@ -14,8 +14,9 @@ namespace easyhttpcpp {
 static const std::string Tag = "ResponseBodyStreamWithoutCaching";
 
 ResponseBodyStreamWithoutCaching::ResponseBodyStreamWithoutCaching(std::istream& content,
-        ConnectionInternal::Ptr pConnectionInternal, ConnectionPoolInternal::Ptr pConnectionPoolInternal)
-        : ResponseBodyStreamInternal(content), m_pConnectionInternal(pConnectionInternal),
+        ConnectionInternal::Ptr pConnectionInternal, ConnectionPoolInternal::Ptr pConnectionPoolInternal,
+        Poco::SharedPtr<std::istream> pContentHolder)
+        : ResponseBodyStreamInternal(content, pContentHolder), m_pConnectionInternal(pConnectionInternal),
         m_pConnectionPoolInternal(pConnectionPoolInternal)
 {
 }
@@ -63,7 +64,7 @@ ResponseBodyStream::Ptr ResponseBodyStreamWithoutCaching::exchangeToResponseBody
         Response::Ptr pResponse, HttpCache::Ptr pHttpCache)
 {
     ResponseBodyStream::Ptr pNewResponseBodyStream = new ResponseBodyStreamWithCaching(
-            m_content, m_pConnectionInternal, m_pConnectionPoolInternal, pResponse, pHttpCache);
+            m_content, m_pConnectionInternal, m_pConnectionPoolInternal, pResponse, pHttpCache, m_pContentHolder);
 
     // to close state for do not touch stream
     m_pConnectionInternal = NULL;
@@ -17,7 +17,8 @@ namespace easyhttpcpp {
 class EASYHTTPCPP_HTTP_INTERNAL_API ResponseBodyStreamWithoutCaching : public ResponseBodyStreamInternal {
 public:
     ResponseBodyStreamWithoutCaching(std::istream& content, ConnectionInternal::Ptr pConnectionInternal,
-            ConnectionPoolInternal::Ptr pConnectionPoolInternal);
+            ConnectionPoolInternal::Ptr pConnectionPoolInternal,
+            Poco::SharedPtr<std::istream> pContentHolder = Poco::SharedPtr<std::istream>());
     virtual ~ResponseBodyStreamWithoutCaching();
     virtual void close();
 
@@ -0,0 +1,66 @@
+/*
+ * Copyright 2019 Sony Corporation
+ */
+
+#include "easyhttpcpp/common/CoreLogger.h"
+#include "easyhttpcpp/HttpException.h"
+
+#include "ResponseBodyWriteTask.h"
+
+namespace easyhttpcpp {
+
+static const std::string Tag = "ResponseBodyWriteTask";
+
+ResponseBodyWriteTask::ResponseBodyWriteTask(HttpExecutionTaskManager::Ptr pExecutionTaskManager,
+        ResponseBody::Ptr pResponseBody, const Poco::Path& path, bool append,
+        ResponseBodyWriteCallback::Ptr pCallback) : m_pExecutionTaskManager(pExecutionTaskManager),
+        m_pResponseBody(pResponseBody), m_path(path), m_append(append), m_pCallback(pCallback)
+{
+}
+
+ResponseBodyWriteTask::~ResponseBodyWriteTask()
+{
+}
+
+void ResponseBodyWriteTask::runTask()
+{
+    if (isCancelled()) {
+        EASYHTTPCPP_LOG_D(Tag, "ResponseBody write was cancelled before start.");
+        m_pResponseBody->close();
+        notifyCompletion(new HttpExecutionException("ResponseBody write was cancelled."), 0);
+        return;
+    }
+
+    Poco::UInt64 writtenBytes = 0;
+    try {
+        writtenBytes = m_pResponseBody->writeTo(m_path, m_append);
+    } catch (const HttpException& e) {
+        EASYHTTPCPP_LOG_D(Tag, "Error while writing ResponseBody to file. Details: %s", e.getMessage().c_str());
+        notifyCompletion(e.clone(), 0);
+        return;
+    } catch (const std::exception& e) {
+        EASYHTTPCPP_LOG_D(Tag, "Unexpected error while writing ResponseBody to file. Details: %s", e.what());
+        HttpExecutionException::Ptr pWhat = new HttpExecutionException(
+                "Unexpected error while writing ResponseBody to file. Check getCause() for details.", e);
+        notifyCompletion(pWhat, 0);
+        return;
+    }
+
+    EASYHTTPCPP_LOG_D(Tag, "ResponseBody was written to file. [%llu bytes]", writtenBytes);
+    notifyCompletion(NULL, writtenBytes);
+}
+
+void ResponseBodyWriteTask::notifyCompletion(HttpException::Ptr pWhat, Poco::UInt64 writtenBytes)
+{
+    m_pExecutionTaskManager->onComplete(HttpExecutionTask::Ptr(this, true));
+
+    if (m_pCallback) {
+        if (pWhat) {
+            m_pCallback->onFailure(pWhat);
+        } else {
+            m_pCallback->onCompleted(m_path, writtenBytes);
+        }
+    }
+}
+
+} /* namespace easyhttpcpp */
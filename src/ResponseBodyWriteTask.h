@@ -0,0 +1,41 @@
+/*
+ * Copyright 2019 Sony Corporation
+ */
+
+#ifndef EASYHTTPCPP_RESPONSEBODYWRITETASK_H_INCLUDED
+#define EASYHTTPCPP_RESPONSEBODYWRITETASK_H_INCLUDED
+
+#include "Poco/Path.h"
+#include "Poco/Types.h"
+
+#include "easyhttpcpp/ResponseBody.h"
+#include "easyhttpcpp/ResponseBodyWriteCallback.h"
+
+#include "HttpExecutionTask.h"
+#include "HttpExecutionTaskManager.h"
+
+namespace easyhttpcpp {
+
+class ResponseBodyWriteTask : public HttpExecutionTask {
+public:
+    typedef Poco::AutoPtr<ResponseBodyWriteTask> Ptr;
+
+    ResponseBodyWriteTask(HttpExecutionTaskManager::Ptr pExecutionTaskManager, ResponseBody::Ptr pResponseBody,
+            const Poco::Path& path, bool append, ResponseBodyWriteCallback::Ptr pCallback);
+    virtual ~ResponseBodyWriteTask();
+    virtual void runTask();
+
+private:
+    ResponseBodyWriteTask();
+    void notifyCompletion(HttpException::Ptr pWhat, Poco::UInt64 writtenBytes);
+
+    HttpExecutionTaskManager::Ptr m_pExecutionTaskManager;
+    ResponseBody::Ptr m_pResponseBody;
+    Poco::Path m_path;
+    bool m_append;
+    ResponseBodyWriteCallback::Ptr m_pCallback;
+};
+
+} /* namespace easyhttpcpp */
+
+#endif /* EASYHTTPCPP_RESPONSEBODYWRITETASK_H_INCLUDED */
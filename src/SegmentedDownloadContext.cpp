@@ -0,0 +1,109 @@
+/*
+ * Copyright 2019 Sony Corporation
+ */
+
+#include "SegmentedDownloadContext.h"
+
+namespace easyhttpcpp {
+
+SegmentedDownloadContext::SegmentedDownloadContext(EasyHttp::Ptr pEasyHttp, Request::Ptr pRequest,
+        const std::string& entityTag, Poco::UInt64 totalBytes, unsigned int maxRetryCount,
+        SegmentedDownloader::ProgressListener::Ptr pProgressListener) : m_pEasyHttp(pEasyHttp), m_pRequest(pRequest),
+        m_entityTag(entityTag), m_totalBytes(totalBytes), m_maxRetryCount(maxRetryCount),
+        m_pProgressListener(pProgressListener), m_cancelled(false), m_downloadedBytes(0)
+{
+}
+
+SegmentedDownloadContext::~SegmentedDownloadContext()
+{
+    m_file.close();
+}
+
+bool SegmentedDownloadContext::openFile(const std::string& path)
+{
+    return m_file.open(path);
+}
+
+bool SegmentedDownloadContext::writeAt(const char* pBuffer, size_t length, Poco::UInt64 offset)
+{
+    return m_file.writeAt(pBuffer, length, offset);
+}
+
+void SegmentedDownloadContext::closeFile()
+{
+    m_file.close();
+}
+
+bool SegmentedDownloadContext::registerCall(Call::Ptr pCall)
+{
+    Poco::FastMutex::ScopedLock lock(m_callMutex);
+    if (m_cancelled) {
+        return false;
+    }
+    m_calls.push_back(pCall);
+    return true;
+}
+
+void SegmentedDownloadContext::unregisterCall(Call::Ptr pCall)
+{
+    Poco::FastMutex::ScopedLock lock(m_callMutex);
+    m_calls.remove(pCall);
+}
+
+void SegmentedDownloadContext::cancel()
+{
+    Poco::FastMutex::ScopedLock lock(m_callMutex);
+    m_cancelled = true;
+    for (std::list<Call::Ptr>::iterator it = m_calls.begin(); it != m_calls.end(); it++) {
+        (*it)->cancel();
+    }
+}
+
+bool SegmentedDownloadContext::isCancelled()
+{
+    Poco::FastMutex::ScopedLock lock(m_callMutex);
+    return m_cancelled;
+}
+
+void SegmentedDownloadContext::addDownloadedBytes(Poco::UInt64 bytes)
+{
+    // the listener is called under the lock so that the reported progress never goes backwards.
+    Poco::FastMutex::ScopedLock lock(m_progressMutex);
+    m_downloadedBytes += bytes;
+    if (m_pProgressListener) {
+        m_pProgressListener->onProgress(m_downloadedBytes, m_totalBytes);
+    }
+}
+
+Poco::UInt64 SegmentedDownloadContext::getDownloadedBytes()
+{
+    Poco::FastMutex::ScopedLock lock(m_progressMutex);
+    return m_downloadedBytes;
+}
+
+EasyHttp::Ptr SegmentedDownloadContext::getEasyHttp() const
+{
+    return m_pEasyHttp;
+}
+
+Request::Ptr SegmentedDownloadContext::getRequest() const
+{
+    return m_pRequest;
+}
+
+const std::string& SegmentedDownloadContext::getEntityTag() const
+{
+    return m_entityTag;
+}
+
+Poco::UInt64 SegmentedDownloadContext::getTotalBytes() const
+{
+    return m_totalBytes;
+}
+
+unsigned int SegmentedDownloadContext::getMaxRetryCount() const
+{
+    return m_maxRetryCount;
+}
+
+} /* namespace easyhttpcpp */
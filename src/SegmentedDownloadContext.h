@@ -0,0 +1,75 @@
+/*
+ * Copyright 2019 Sony Corporation
+ */
+
+#ifndef EASYHTTPCPP_SEGMENTEDDOWNLOADCONTEXT_H_INCLUDED
+#define EASYHTTPCPP_SEGMENTEDDOWNLOADCONTEXT_H_INCLUDED
+
+#include <list>
+#include <string>
+
+#include "Poco/AutoPtr.h"
+#include "Poco/Mutex.h"
+#include "Poco/RefCountedObject.h"
+#include "Poco/Types.h"
+
+#include "easyhttpcpp/Call.h"
+#include "easyhttpcpp/EasyHttp.h"
+#include "easyhttpcpp/HttpExports.h"
+#include "easyhttpcpp/Request.h"
+#include "easyhttpcpp/SegmentedDownloader.h"
+
+#include "RandomAccessFileImpl.h"
+
+namespace easyhttpcpp {
+
+// state shared by the segments of one SegmentedDownloader::download.
+class EASYHTTPCPP_HTTP_INTERNAL_API SegmentedDownloadContext : public Poco::RefCountedObject {
+public:
+    typedef Poco::AutoPtr<SegmentedDownloadContext> Ptr;
+
+    SegmentedDownloadContext(EasyHttp::Ptr pEasyHttp, Request::Ptr pRequest, const std::string& entityTag,
+            Poco::UInt64 totalBytes, unsigned int maxRetryCount,
+            SegmentedDownloader::ProgressListener::Ptr pProgressListener);
+    virtual ~SegmentedDownloadContext();
+
+    bool openFile(const std::string& path);
+    bool writeAt(const char* pBuffer, size_t length, Poco::UInt64 offset);
+    void closeFile();
+
+    // returns false if already cancelled; the caller must not execute the call.
+    bool registerCall(Call::Ptr pCall);
+    void unregisterCall(Call::Ptr pCall);
+    void cancel();
+    bool isCancelled();
+
+    void addDownloadedBytes(Poco::UInt64 bytes);
+    Poco::UInt64 getDownloadedBytes();
+
+    EasyHttp::Ptr getEasyHttp() const;
+    Request::Ptr getRequest() const;
+    const std::string& getEntityTag() const;
+    Poco::UInt64 getTotalBytes() const;
+    unsigned int getMaxRetryCount() const;
+
+private:
+    EasyHttp::Ptr m_pEasyHttp;
+    Request::Ptr m_pRequest;
+    std::string m_entityTag;
+    Poco::UInt64 m_totalBytes;
+    unsigned int m_maxRetryCount;
+    SegmentedDownloader::ProgressListener::Ptr m_pProgressListener;
+
+    RandomAccessFileImpl m_file;
+
+    Poco::FastMutex m_callMutex;
+    std::list<Call::Ptr> m_calls;
+    bool m_cancelled;
+
+    Poco::FastMutex m_progressMutex;
+    Poco::UInt64 m_downloadedBytes;
+};
+
+} /* namespace easyhttpcpp */
+
+#endif /* EASYHTTPCPP_SEGMENTEDDOWNLOADCONTEXT_H_INCLUDED */
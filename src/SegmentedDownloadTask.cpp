@@ -0,0 +1,168 @@
+/*
+ * Copyright 2019 Sony Corporation
+ */
+
+#include "Poco/Buffer.h"
+#include "Poco/NumberFormatter.h"
+#include "Poco/Net/HTTPResponse.h"
+
+#include "easyhttpcpp/common/CoreLogger.h"
+#include "easyhttpcpp/common/StringUtil.h"
+#include "easyhttpcpp/Call.h"
+#include "easyhttpcpp/Headers.h"
+#include "easyhttpcpp/HttpConstants.h"
+#include "easyhttpcpp/Request.h"
+#include "easyhttpcpp/ResponseBody.h"
+#include "easyhttpcpp/ResponseBodyStream.h"
+
+#include "HttpInternalConstants.h"
+#include "HttpUtil.h"
+#include "SegmentedDownloadTask.h"
+
+using easyhttpcpp::common::StringUtil;
+
+namespace easyhttpcpp {
+
+static const std::string Tag = "SegmentedDownloadTask";
+
+SegmentedDownloadTask::SegmentedDownloadTask(SegmentedDownloadContext::Ptr pContext, Poco::UInt64 firstBytePos,
+        Poco::UInt64 lastBytePos) : m_pContext(pContext), m_firstBytePos(firstBytePos), m_lastBytePos(lastBytePos)
+{
+}
+
+SegmentedDownloadTask::~SegmentedDownloadTask()
+{
+}
+
+void SegmentedDownloadTask::runTask()
+{
+    Poco::Buffer<char> buffer(HttpInternalConstants::SegmentedDownloads::ReadBufferBytes);
+    Poco::UInt64 position = m_firstBytePos;
+    unsigned int retryCount = 0;
+
+    while (position <= m_lastBytePos) {
+        if (isCancelled() || m_pContext->isCancelled()) {
+            EASYHTTPCPP_LOG_D(Tag, "segment was cancelled. [%llu-%llu]", m_firstBytePos, m_lastBytePos);
+            m_pError = new HttpExecutionException("Segmented download was cancelled.");
+            break;
+        }
+        try {
+            position = downloadFrom(position, buffer.begin(), buffer.size());
+        } catch (const HttpIllegalStateException& e) {
+            // the resource on the server has changed or ignored the range; retrying does not help.
+            EASYHTTPCPP_LOG_D(Tag, "segment failed. [%llu-%llu] Details: %s", m_firstBytePos, m_lastBytePos,
+                    e.getMessage().c_str());
+            m_pError = e.clone();
+            break;
+        } catch (const HttpException& e) {
+            if (retryCount >= m_pContext->getMaxRetryCount() || m_pContext->isCancelled()) {
+                EASYHTTPCPP_LOG_D(Tag, "segment failed. [%llu-%llu] Details: %s", m_firstBytePos, m_lastBytePos,
+                        e.getMessage().c_str());
+                m_pError = e.clone();
+                break;
+            }
+            retryCount++;
+            EASYHTTPCPP_LOG_D(Tag, "retry segment from %llu. [%llu-%llu] retry=%u Details: %s", position,
+                    m_firstBytePos, m_lastBytePos, retryCount, e.getMessage().c_str());
+        }
+    }
+}
+
+HttpException::Ptr SegmentedDownloadTask::getError() const
+{
+    return m_pError;
+}
+
+Poco::UInt64 SegmentedDownloadTask::downloadFrom(Poco::UInt64 position, char* pBuffer, size_t bufferBytes)
+{
+    Request::Ptr pTemplate = m_pContext->getRequest();
+
+    // Request::Builder shares the headers of the template request; copy them before adding the range.
+    Headers::Ptr pHeaders = pTemplate->getHeaders() ? new Headers(*pTemplate->getHeaders()) : new Headers();
+    pHeaders->set(HttpConstants::HeaderNames::Range, std::string(HttpConstants::HeaderValues::Bytes) + "=" +
+            Poco::NumberFormatter::format(position) + "-" + Poco::NumberFormatter::format(m_lastBytePos));
+    if (!m_pContext->getEntityTag().empty()) {
+        pHeaders->set(HttpConstants::HeaderNames::IfRange, m_pContext->getEntityTag());
+    }
+    Request::Builder requestBuilder(pTemplate);
+    Request::Ptr pRequest = requestBuilder.setHeaders(pHeaders).build();
+
+    Call::Ptr pCall = m_pContext->getEasyHttp()->newCall(pRequest);
+    if (!m_pContext->registerCall(pCall)) {
+        throw HttpExecutionException("Segmented download was cancelled.");
+    }
+
+    Response::Ptr pResponse;
+    try {
+        pResponse = pCall->execute();
+        checkResponse(pResponse, position);
+        position = readBody(pResponse, position, pBuffer, bufferBytes);
+    } catch (...) {
+        if (pResponse && pResponse->getBody()) {
+            pResponse->getBody()->close();
+        }
+        m_pContext->unregisterCall(pCall);
+        throw;
+    }
+    pResponse->getBody()->close();
+    m_pContext->unregisterCall(pCall);
+
+    if (position <= m_lastBytePos) {
+        throw HttpExecutionException(StringUtil::format("Segment was truncated at %llu. [%llu-%llu]", position,
+                m_firstBytePos, m_lastBytePos));
+    }
+    return position;
+}
+
+Poco::UInt64 SegmentedDownloadTask::readBody(Response::Ptr pResponse, Poco::UInt64 position, char* pBuffer,
+        size_t bufferBytes)
+{
+    ResponseBodyStream::Ptr pStream = pResponse->getBody()->getByteStream();
+    while (position <= m_lastBytePos && !pStream->isEof()) {
+        Poco::UInt64 remaining = m_lastBytePos - position + 1;
+        size_t readBytes = remaining < bufferBytes ? static_cast<size_t>(remaining) : bufferBytes;
+        ssize_t bytes = pStream->read(pBuffer, readBytes);
+        if (bytes <= 0) {
+            break;
+        }
+        if (!m_pContext->writeAt(pBuffer, bytes, position)) {
+            // a local write error is not recoverable by another request.
+            throw HttpIllegalStateException(StringUtil::format("Failed to write segment at %llu.", position));
+        }
+        position += bytes;
+        m_pContext->addDownloadedBytes(bytes);
+    }
+    return position;
+}
+
+void SegmentedDownloadTask::checkResponse(Response::Ptr pResponse, Poco::UInt64 position)
+{
+    int code = pResponse->getCode();
+    if (code == Poco::Net::HTTPResponse::HTTP_PARTIAL_CONTENT) {
+        const std::string& contentRange = pResponse->getHeaderValue(HttpConstants::HeaderNames::ContentRange, "");
+        Poco::UInt64 firstBytePos = 0;
+        Poco::UInt64 lastBytePos = 0;
+        Poco::UInt64 completeLength = 0;
+        if (!HttpUtil::tryParseContentRange(contentRange, firstBytePos, lastBytePos, completeLength) ||
+                firstBytePos != position || completeLength != m_pContext->getTotalBytes()) {
+            throw HttpIllegalStateException(StringUtil::format("Unexpected Content-Range [%s] for range from %llu.",
+                    contentRange.c_str(), position));
+        }
+        const std::string& entityTag = m_pContext->getEntityTag();
+        if (!entityTag.empty() && pResponse->hasHeader(HttpConstants::HeaderNames::ETag) &&
+                pResponse->getHeaderValue(HttpConstants::HeaderNames::ETag, "") != entityTag) {
+            throw HttpIllegalStateException("ETag of resource has changed during segmented download.");
+        }
+        return;
+    }
+    if (code == Poco::Net::HTTPResponse::HTTP_OK) {
+        // If-Range did not match or the server ignored Range.
+        throw HttpIllegalStateException("Server returned the whole resource for a range request.");
+    }
+    if (code >= Poco::Net::HTTPResponse::HTTP_INTERNAL_SERVER_ERROR) {
+        throw HttpExecutionException(StringUtil::format("Range request failed. [status code=%d]", code));
+    }
+    throw HttpIllegalStateException(StringUtil::format("Range request failed. [status code=%d]", code));
+}
+
+} /* namespace easyhttpcpp */
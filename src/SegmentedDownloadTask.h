@@ -0,0 +1,47 @@
+/*
+ * Copyright 2019 Sony Corporation
+ */
+
+#ifndef EASYHTTPCPP_SEGMENTEDDOWNLOADTASK_H_INCLUDED
+#define EASYHTTPCPP_SEGMENTEDDOWNLOADTASK_H_INCLUDED
+
+#include "Poco/Types.h"
+#include "Poco/Void.h"
+
+#include "easyhttpcpp/HttpException.h"
+#include "easyhttpcpp/HttpExports.h"
+#include "easyhttpcpp/Response.h"
+#include "easyhttpcpp/executorservice/FutureTask.h"
+
+#include "SegmentedDownloadContext.h"
+
+namespace easyhttpcpp {
+
+// downloads the bytes [firstBytePos, lastBytePos] of a resource with Range requests.
+class EASYHTTPCPP_HTTP_INTERNAL_API SegmentedDownloadTask : public easyhttpcpp::executorservice::FutureTask<Poco::Void> {
+public:
+    typedef Poco::AutoPtr<SegmentedDownloadTask> Ptr;
+
+    SegmentedDownloadTask(SegmentedDownloadContext::Ptr pContext, Poco::UInt64 firstBytePos,
+            Poco::UInt64 lastBytePos);
+    virtual ~SegmentedDownloadTask();
+
+    virtual void runTask();
+
+    // NULL if the segment was downloaded.
+    HttpException::Ptr getError() const;
+
+private:
+    Poco::UInt64 downloadFrom(Poco::UInt64 position, char* pBuffer, size_t bufferBytes);
+    Poco::UInt64 readBody(Response::Ptr pResponse, Poco::UInt64 position, char* pBuffer, size_t bufferBytes);
+    void checkResponse(Response::Ptr pResponse, Poco::UInt64 position);
+
+    SegmentedDownloadContext::Ptr m_pContext;
+    Poco::UInt64 m_firstBytePos;
+    Poco::UInt64 m_lastBytePos;
+    HttpException::Ptr m_pError;
+};
+
+} /* namespace easyhttpcpp */
+
+#endif /* EASYHTTPCPP_SEGMENTEDDOWNLOADTASK_H_INCLUDED */
@@ -0,0 +1,317 @@
+/*
+ * Copyright 2019 Sony Corporation
+ */
+
+#include <vector>
+
+#include "Poco/File.h"
+#include "Poco/Net/HTTPResponse.h"
+#include "Poco/String.h"
+#include "Poco/StringTokenizer.h"
+
+#include "easyhttpcpp/common/CoreLogger.h"
+#include "easyhttpcpp/common/FileUtil.h"
+#include "easyhttpcpp/common/StringUtil.h"
+#include "easyhttpcpp/executorservice/ExecutorServiceException.h"
+#include "easyhttpcpp/executorservice/QueuedThreadPool.h"
+#include "easyhttpcpp/executorservice/UnboundBlockingQueue.h"
+#include "easyhttpcpp/HttpConstants.h"
+#include "easyhttpcpp/HttpException.h"
+#include "easyhttpcpp/Response.h"
+#include "easyhttpcpp/ResponseBody.h"
+#include "easyhttpcpp/SegmentedDownloader.h"
+
+#include "HttpInternalConstants.h"
+#include "SegmentedDownloadContext.h"
+#include "SegmentedDownloadTask.h"
+
+using easyhttpcpp::common::FileUtil;
+using easyhttpcpp::common::StringUtil;
+using easyhttpcpp::executorservice::ExecutorServiceException;
+using easyhttpcpp::executorservice::QueuedThreadPool;
+using easyhttpcpp::executorservice::UnboundBlockingQueue;
+
+namespace easyhttpcpp {
+
+static const std::string Tag = "SegmentedDownloader";
+
+namespace {
+
+bool acceptsByteRanges(Response::Ptr pResponse)
+{
+    const std::string& acceptRanges = pResponse->getHeaderValue(HttpConstants::HeaderNames::AcceptRanges, "");
+    Poco::StringTokenizer tokens(acceptRanges, ",", Poco::StringTokenizer::TOK_TRIM |
+            Poco::StringTokenizer::TOK_IGNORE_EMPTY);
+    for (Poco::StringTokenizer::Iterator it = tokens.begin(); it != tokens.end(); it++) {
+        if (Poco::icompare(*it, HttpConstants::HeaderValues::Bytes) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// If-Range requires a strong validator (RFC 7233 3.2).
+std::string getStrongEntityTag(Response::Ptr pResponse)
+{
+    const std::string& entityTag = pResponse->getHeaderValue(HttpConstants::HeaderNames::ETag, "");
+    if (entityTag.compare(0, 2, "W/") == 0) {
+        return "";
+    }
+    return entityTag;
+}
+
+} /* namespace */
+
+SegmentedDownloader::SegmentedDownloader(EasyHttp::Ptr pEasyHttp, Builder& builder) : m_pEasyHttp(pEasyHttp),
+        m_segmentCount(builder.getSegmentCount()), m_segmentSize(builder.getSegmentSize()),
+        m_maxRetryCount(builder.getMaxRetryCount()), m_pProgressListener(builder.getProgressListener()),
+        m_downloading(false), m_cancelled(false)
+{
+}
+
+SegmentedDownloader::~SegmentedDownloader()
+{
+}
+
+Poco::UInt64 SegmentedDownloader::download(Request::Ptr pRequest, const Poco::Path& path)
+{
+    if (!pRequest || pRequest->getMethod() != Request::HttpMethodGet) {
+        EASYHTTPCPP_LOG_D(Tag, "download: request must be GET.");
+        throw HttpIllegalArgumentException("Request must be GET.");
+    }
+    if (path.toString().empty()) {
+        EASYHTTPCPP_LOG_D(Tag, "download: path is empty.");
+        throw HttpIllegalArgumentException("Path must not be empty.");
+    }
+    {
+        Poco::FastMutex::ScopedLock lock(m_instanceMutex);
+        if (m_downloading) {
+            EASYHTTPCPP_LOG_D(Tag, "download: already downloading.");
+            throw HttpIllegalStateException("SegmentedDownloader is already downloading.");
+        }
+        m_downloading = true;
+        m_cancelled = false;
+    }
+
+    Poco::UInt64 downloadedBytes = 0;
+    try {
+        // probe the resource; the headers of the user request are kept.
+        Headers::Ptr pHeaders = pRequest->getHeaders() ? new Headers(*pRequest->getHeaders()) : new Headers();
+        Request::Builder probeBuilder(pRequest);
+        Request::Ptr pProbeRequest = probeBuilder.httpHead().setHeaders(pHeaders).build();
+        Response::Ptr pProbeResponse = m_pEasyHttp->newCall(pProbeRequest)->execute();
+        pProbeResponse->getBody()->close();
+
+        Poco::UInt64 totalBytes = 0;
+        bool segmentable = pProbeResponse->getCode() == Poco::Net::HTTPResponse::HTTP_OK &&
+                acceptsByteRanges(pProbeResponse) && pProbeResponse->hasContentLength() &&
+                pProbeResponse->getContentLength() > 0;
+        if (segmentable) {
+            totalBytes = static_cast<Poco::UInt64>(pProbeResponse->getContentLength());
+        }
+
+        Poco::UInt64 segmentSize = m_segmentSize;
+        if (segmentSize == 0) {
+            segmentSize = (totalBytes + m_segmentCount - 1) / m_segmentCount;
+        }
+
+        if (!segmentable || segmentSize >= totalBytes) {
+            EASYHTTPCPP_LOG_D(Tag, "download: server does not accept byte ranges. download with single request.");
+            downloadedBytes = downloadWithSingleRequest(pRequest, path);
+        } else {
+            std::string entityTag = getStrongEntityTag(pProbeResponse);
+            SegmentedDownloadContext::Ptr pContext = new SegmentedDownloadContext(m_pEasyHttp, pRequest, entityTag,
+                    totalBytes, m_maxRetryCount, m_pProgressListener);
+
+            Poco::File file(path);
+            FileUtil::removeFileIfPresent(file);
+            if (!pContext->openFile(path.toString())) {
+                throw HttpExecutionException(StringUtil::format("Failed to open file. [%s]",
+                        path.toString().c_str()));
+            }
+            file.setSize(totalBytes);
+            FileUtil::preallocateFile(file, 0, totalBytes);
+
+            {
+                Poco::FastMutex::ScopedLock lock(m_instanceMutex);
+                if (m_cancelled) {
+                    pContext->cancel();
+                }
+                m_pDownloadContext = pContext;
+            }
+
+            EASYHTTPCPP_LOG_D(Tag, "download: %llu bytes with segments of %llu bytes.", totalBytes, segmentSize);
+
+            std::vector<SegmentedDownloadTask::Ptr> tasks;
+            for (Poco::UInt64 first = 0; first < totalBytes; first += segmentSize) {
+                Poco::UInt64 last = first + segmentSize - 1;
+                tasks.push_back(new SegmentedDownloadTask(pContext, first, last < totalBytes ? last : totalBytes - 1));
+            }
+            unsigned int poolSize = tasks.size() < m_segmentCount ? static_cast<unsigned int>(tasks.size()) :
+                    m_segmentCount;
+            QueuedThreadPool::Ptr pThreadPool = new QueuedThreadPool(poolSize, poolSize, new UnboundBlockingQueue());
+            try {
+                for (size_t i = 0; i < tasks.size(); i++) {
+                    pThreadPool->start(tasks[i]);
+                }
+            } catch (const ExecutorServiceException& e) {
+                EASYHTTPCPP_LOG_D(Tag, "QueuedThreadPool::start failed. Details:%s", e.getMessage().c_str());
+                pContext->cancel();
+                pThreadPool->shutdownAndJoinAll();
+                throw HttpExecutionException("Can not start segmented download. getCause() for details.", e);
+            }
+
+            HttpException::Ptr pError;
+            for (size_t i = 0; i < tasks.size(); i++) {
+                tasks[i]->get();
+                if (!pError && tasks[i]->getError()) {
+                    pError = tasks[i]->getError();
+                    // stop the other segments as early as possible.
+                    pContext->cancel();
+                }
+            }
+            pThreadPool->shutdownAndJoinAll();
+            pContext->closeFile();
+
+            {
+                Poco::FastMutex::ScopedLock lock(m_instanceMutex);
+                m_pDownloadContext = NULL;
+            }
+
+            if (pError) {
+                pError->rethrow();
+            }
+            if (file.getSize() != totalBytes || pContext->getDownloadedBytes() != totalBytes) {
+                throw HttpExecutionException(StringUtil::format("Downloaded size does not match. [%llu/%llu]",
+                        pContext->getDownloadedBytes(), totalBytes));
+            }
+            downloadedBytes = totalBytes;
+        }
+    } catch (...) {
+        Poco::FastMutex::ScopedLock lock(m_instanceMutex);
+        m_pDownloadContext = NULL;
+        m_downloading = false;
+        throw;
+    }
+
+    Poco::FastMutex::ScopedLock lock(m_instanceMutex);
+    m_downloading = false;
+    return downloadedBytes;
+}
+
+bool SegmentedDownloader::cancel()
+{
+    Poco::FastMutex::ScopedLock lock(m_instanceMutex);
+    if (!m_downloading) {
+        return false;
+    }
+    m_cancelled = true;
+    if (m_pDownloadContext) {
+        m_pDownloadContext->cancel();
+    }
+    return true;
+}
+
+unsigned int SegmentedDownloader::getSegmentCount() const
+{
+    return m_segmentCount;
+}
+
+Poco::UInt64 SegmentedDownloader::getSegmentSize() const
+{
+    return m_segmentSize;
+}
+
+unsigned int SegmentedDownloader::getMaxRetryCount() const
+{
+    return m_maxRetryCount;
+}
+
+Poco::UInt64 SegmentedDownloader::downloadWithSingleRequest(Request::Ptr pRequest, const Poco::Path& path)
+{
+    {
+        Poco::FastMutex::ScopedLock lock(m_instanceMutex);
+        if (m_cancelled) {
+            throw HttpExecutionException("Segmented download was cancelled.");
+        }
+    }
+    Response::Ptr pResponse = m_pEasyHttp->newCall(pRequest)->execute();
+    if (!pResponse->isSuccessful()) {
+        pResponse->getBody()->close();
+        throw HttpExecutionException(StringUtil::format("Request failed. [status code=%d]", pResponse->getCode()));
+    }
+    Poco::UInt64 writtenBytes = pResponse->getBody()->writeTo(path);
+    if (m_pProgressListener) {
+        m_pProgressListener->onProgress(writtenBytes, writtenBytes);
+    }
+    return writtenBytes;
+}
+
+SegmentedDownloader::Builder::Builder() : m_segmentCount(HttpInternalConstants::SegmentedDownloads::DefaultSegmentCount),
+        m_segmentSize(0), m_maxRetryCount(HttpInternalConstants::SegmentedDownloads::DefaultMaxRetryCount)
+{
+}
+
+SegmentedDownloader::Builder::~Builder()
+{
+}
+
+SegmentedDownloader::Ptr SegmentedDownloader::Builder::build(EasyHttp::Ptr pEasyHttp)
+{
+    if (!pEasyHttp) {
+        EASYHTTPCPP_LOG_D(Tag, "build: EasyHttp is NULL.");
+        throw HttpIllegalArgumentException("EasyHttp must not be NULL.");
+    }
+    return new SegmentedDownloader(pEasyHttp, *this);
+}
+
+SegmentedDownloader::Builder& SegmentedDownloader::Builder::setSegmentCount(unsigned int segmentCount)
+{
+    if (segmentCount == 0) {
+        EASYHTTPCPP_LOG_D(Tag, "setSegmentCount: segmentCount must be greater than 0.");
+        throw HttpIllegalArgumentException("segmentCount must be greater than 0.");
+    }
+    m_segmentCount = segmentCount;
+    return *this;
+}
+
+unsigned int SegmentedDownloader::Builder::getSegmentCount() const
+{
+    return m_segmentCount;
+}
+
+SegmentedDownloader::Builder& SegmentedDownloader::Builder::setSegmentSize(Poco::UInt64 segmentSize)
+{
+    m_segmentSize = segmentSize;
+    return *this;
+}
+
+Poco::UInt64 SegmentedDownloader::Builder::getSegmentSize() const
+{
+    return m_segmentSize;
+}
+
+SegmentedDownloader::Builder& SegmentedDownloader::Builder::setMaxRetryCount(unsigned int maxRetryCount)
+{
+    m_maxRetryCount = maxRetryCount;
+    return *this;
+}
+
+unsigned int SegmentedDownloader::Builder::getMaxRetryCount() const
+{
+    return m_maxRetryCount;
+}
+
+SegmentedDownloader::Builder& SegmentedDownloader::Builder::setProgressListener(
+        ProgressListener::Ptr pProgressListener)
+{
+    m_pProgressListener = pProgressListener;
+    return *this;
+}
+
+SegmentedDownloader::ProgressListener::Ptr SegmentedDownloader::Builder::getProgressListener() const
+{
+    return m_pProgressListener;
+}
+
+} /* namespace easyhttpcpp */
@@ -7,11 +7,13 @@
 namespace easyhttpcpp {
 namespace common {
 
-CacheInfoWithDataSize::CacheInfoWithDataSize(const std::string& key, size_t dataSize) : m_key(key), m_dataSize(dataSize)
+CacheInfoWithDataSize::CacheInfoWithDataSize(const std::string& key, size_t dataSize) : m_key(key),
+        m_dataSize(dataSize), m_pNewer(NULL), m_pOlder(NULL)
 {
 }
 
-CacheInfoWithDataSize::CacheInfoWithDataSize(const CacheInfoWithDataSize& original)
+CacheInfoWithDataSize::CacheInfoWithDataSize(const CacheInfoWithDataSize& original) : m_pNewer(NULL),
+        m_pOlder(NULL)
 {
     copyFrom(original);
 }
@@ -57,6 +59,16 @@ size_t CacheInfoWithDataSize::getDataSize() const
     return m_dataSize;
 }
 
+CacheInfoWithDataSize* CacheInfoWithDataSize::getNewer() const
+{
+    return m_pNewer;
+}
+
+CacheInfoWithDataSize* CacheInfoWithDataSize::getOlder() const
+{
+    return m_pOlder;
+}
+
 void CacheInfoWithDataSize::copyFrom(const CacheInfoWithDataSize& original)
 {
     m_key = original.m_key;
@@ -11,8 +11,16 @@ namespace easyhttpcpp {
 namespace common {
 
 static const std::string Tag = "CacheManager";
+static const size_t ReadBufferSize = 4096;
 
-CacheManager::CacheManager(Cache::Ptr pL1Cache, Cache::Ptr pL2Cache)
+CacheManager::CacheManager(Cache::Ptr pL1Cache, Cache::Ptr pL2Cache) : m_maxL1DataSize(0)
+{
+    m_caches[0] = pL1Cache;
+    m_caches[1] = pL2Cache;
+}
+
+CacheManager::CacheManager(Cache::Ptr pL1Cache, Cache::Ptr pL2Cache, size_t maxL1DataSize) :
+        m_maxL1DataSize(maxL1DataSize)
 {
     m_caches[0] = pL1Cache;
     m_caches[1] = pL2Cache;
@@ -24,7 +32,7 @@ CacheManager::~CacheManager()
 
 bool CacheManager::getMetadata(const std::string& key, CacheMetadata::Ptr& pCacheMetadata)
 {
-    Poco::FastMutex::ScopedLock lock(m_instanceMutex);
+    Poco::FastMutex::ScopedLock lock(m_keyMutexes.get(key));
 
     for (int i = 0; i < CACHE_MAX; i++) {
         if (m_caches[i]) {
@@ -44,11 +52,18 @@ bool CacheManager::getMetadata(const std::string& key, CacheMetadata::Ptr& pCach
 
 bool CacheManager::getData(const std::string& key, std::istream*& pStream)
 {
-    Poco::FastMutex::ScopedLock lock(m_instanceMutex);
+    unsigned int cacheIndex = 0;
+    return getData(key, pStream, cacheIndex);
+}
+
+bool CacheManager::getData(const std::string& key, std::istream*& pStream, unsigned int& cacheIndex)
+{
+    Poco::FastMutex::ScopedLock lock(m_keyMutexes.get(key));
 
     for (int i = 0; i < CACHE_MAX; i++) {
         if (m_caches[i]) {
             if (m_caches[i]->getData(key, pStream)) {
+                cacheIndex = i;
                 EASYHTTPCPP_LOG_D(Tag, "Cache[%d] getData : found.", i);
                 if (i > 0) {
                     bringToL1Cache(key);
@@ -64,11 +79,19 @@ bool CacheManager::getData(const std::string& key, std::istream*& pStream)
 
 bool CacheManager::get(const std::string& key, CacheMetadata::Ptr& pCacheMetadata, std::istream*& pData)
 {
-    Poco::FastMutex::ScopedLock lock(m_instanceMutex);
+    unsigned int cacheIndex = 0;
+    return get(key, pCacheMetadata, pData, cacheIndex);
+}
+
+bool CacheManager::get(const std::string& key, CacheMetadata::Ptr& pCacheMetadata, std::istream*& pData,
+        unsigned int& cacheIndex)
+{
+    Poco::FastMutex::ScopedLock lock(m_keyMutexes.get(key));
 
     for (int i = 0; i < CACHE_MAX; i++) {
         if (m_caches[i]) {
             if (m_caches[i]->get(key, pCacheMetadata, pData)) {
+                cacheIndex = i;
                 EASYHTTPCPP_LOG_D(Tag, "Cache[%d] get : found.", i);
                 if (i > 0) {
                     bringToL1Cache(key);
@@ -84,7 +107,7 @@ bool CacheManager::get(const std::string& key, CacheMetadata::Ptr& pCacheMetadat
 
 bool CacheManager::putMetadata(const std::string& key, CacheMetadata::Ptr pCacheMetadata)
 {
-    Poco::FastMutex::ScopedLock lock(m_instanceMutex);
+    Poco::FastMutex::ScopedLock lock(m_keyMutexes.get(key));
 
     bool ret = false;
     for (int i = 0; i < CACHE_MAX; i++) {
@@ -102,7 +125,7 @@ bool CacheManager::putMetadata(const std::string& key, CacheMetadata::Ptr pCache
 
 bool CacheManager::put(const std::string& key, CacheMetadata::Ptr pCacheMetadata, const std::string& path)
 {
-    Poco::FastMutex::ScopedLock lock(m_instanceMutex);
+    Poco::FastMutex::ScopedLock lock(m_keyMutexes.get(key));
 
     bool ret = false;
     for (int i = 0; i < CACHE_MAX; i++) {
@@ -121,7 +144,7 @@ bool CacheManager::put(const std::string& key, CacheMetadata::Ptr pCacheMetadata
 bool CacheManager::put(const std::string& key, CacheMetadata::Ptr pCacheMetadata,
         Poco::SharedPtr<ByteArrayBuffer> pData)
 {
-    Poco::FastMutex::ScopedLock lock(m_instanceMutex);
+    Poco::FastMutex::ScopedLock lock(m_keyMutexes.get(key));
 
     bool ret = false;
     for (int i = 0; i < CACHE_MAX; i++) {
@@ -139,27 +162,27 @@ bool CacheManager::put(const std::string& key, CacheMetadata::Ptr pCacheMetadata
 
 bool CacheManager::remove(const std::string& key)
 {
-    Poco::FastMutex::ScopedLock lock(m_instanceMutex);
+    Poco::FastMutex::ScopedLock lock(m_keyMutexes.get(key));
 
-    int cacheCount = 0;
-    int successCount = 0;
+    // the key is removed from every cache, but only the lowest cache decides the result, since an upper cache
+    // holds part of its entries and may not have the key.
+    bool ret = false;
     for (int i = 0; i < CACHE_MAX; i++) {
         if (m_caches[i]) {
-            cacheCount++;
-            if (m_caches[i]->remove(key)) {
+            ret = m_caches[i]->remove(key);
+            if (ret) {
                 EASYHTTPCPP_LOG_D(Tag, "Cache[%d] remove : succeeded.", i);
-                successCount++;
             } else {
                 EASYHTTPCPP_LOG_D(Tag, "Cache[%d] remove : failed.", i);
             }
         }
     }
-    return (cacheCount > 0 && cacheCount == successCount);
+    return ret;
 }
 
 void CacheManager::releaseData(const std::string& key)
 {
-    Poco::FastMutex::ScopedLock lock(m_instanceMutex);
+    Poco::FastMutex::ScopedLock lock(m_keyMutexes.get(key));
 
     for (int i = 0; i < CACHE_MAX; i++) {
         if (m_caches[i]) {
@@ -169,9 +192,20 @@ void CacheManager::releaseData(const std::string& key)
     }
 }
 
+void CacheManager::releaseData(const std::string& key, unsigned int cacheIndex)
+{
+    Poco::FastMutex::ScopedLock lock(m_keyMutexes.get(key));
+
+    if (cacheIndex < CACHE_MAX && m_caches[cacheIndex]) {
+        m_caches[cacheIndex]->releaseData(key);
+        EASYHTTPCPP_LOG_D(Tag, "Cache[%u] releaseData", cacheIndex);
+    }
+}
+
 bool CacheManager::purge(bool mayDeleteIfBusy)
 {
-    Poco::FastMutex::ScopedLock lock(m_instanceMutex);
+    // operations on all keys exclude operations on any key.
+    StripedMutex::ScopedLockAll lock(m_keyMutexes);
 
     bool ret = true;
     for (int i = 0; i < CACHE_MAX; i++) {
@@ -189,13 +223,62 @@ bool CacheManager::purge(bool mayDeleteIfBusy)
 
 void CacheManager::bringToL1Cache(const std::string& key)
 {
-    if (!m_caches[0]) {
+    if (!m_caches[0] || !m_caches[1] || m_maxL1DataSize == 0) {
         return;
     }
 
-    // TODO: 
     // get from L2Cache
+    std::istream* pStream = NULL;
+    if (!m_caches[1]->getData(key, pStream)) {
+        EASYHTTPCPP_LOG_D(Tag, "bringToL1Cache : can not get data from L2 cache.");
+        return;
+    }
+    Poco::SharedPtr<ByteArrayBuffer> pData = readData(*pStream);
+    delete pStream;
+    m_caches[1]->releaseData(key);
+    if (!pData) {
+        EASYHTTPCPP_LOG_D(Tag, "bringToL1Cache : data is not brought. [%s]", key.c_str());
+        return;
+    }
+    CacheMetadata::Ptr pCacheMetadata;
+    if (!m_caches[1]->getMetadata(key, pCacheMetadata)) {
+        EASYHTTPCPP_LOG_D(Tag, "bringToL1Cache : can not get metadata from L2 cache.");
+        return;
+    }
+
     // put to L1Cache
+    if (m_caches[0]->put(key, pCacheMetadata, pData)) {
+        EASYHTTPCPP_LOG_D(Tag, "bringToL1Cache : succeeded. [%s]", key.c_str());
+    } else {
+        EASYHTTPCPP_LOG_D(Tag, "bringToL1Cache : failed. [%s]", key.c_str());
+    }
+}
+
+Poco::SharedPtr<ByteArrayBuffer> CacheManager::readData(std::istream& stream)
+{
+    // skip reading when the size is known to exceed.
+    std::streampos size = stream.seekg(0, std::ios::end).tellg();
+    if (size != std::streampos(-1) && static_cast<size_t>(size) > m_maxL1DataSize) {
+        return NULL;
+    }
+    stream.clear();
+    stream.seekg(0, std::ios::beg);
+    stream.clear();
+
+    Poco::SharedPtr<ByteArrayBuffer> pData = new ByteArrayBuffer();
+    Byte buffer[ReadBufferSize];
+    while (stream.good()) {
+        stream.read(reinterpret_cast<char*>(buffer), ReadBufferSize);
+        size_t readBytes = static_cast<size_t>(stream.gcount());
+        if (pData->getWrittenDataSize() + readBytes > m_maxL1DataSize) {
+            return NULL;
+        }
+        pData->write(buffer, readBytes);
+    }
+    if (stream.bad()) {
+        return NULL;
+    }
+    return pData;
 }
 
 } /* namespace common */
@@ -129,6 +129,45 @@ bool FileUtil::moveFile(const Poco::File& sourceFile, const Poco::File& destinat
     }
 }
 
+bool FileUtil::preallocateFile(const Poco::File& file, Poco::UInt64 offset, Poco::UInt64 length)
+{
+    if (length == 0) {
+        return true;
+    }
+    return FileUtilImpl::preallocateFile(convertToAbsolutePathString(file.path()), offset, length);
+}
+
+bool FileUtil::copyFile(const Poco::File& sourceFile, const Poco::File& destinationFile)
+{
+    Poco::File absoluteSourceFile(convertToAbsolutePathString(sourceFile.path()));
+    if (!absoluteSourceFile.exists() || !absoluteSourceFile.isFile()) {
+        // sourceFile must be an existing file
+        return false;
+    }
+
+    Poco::File absoluteDestinationFile(convertToAbsolutePathString(destinationFile.path()));
+    if (absoluteDestinationFile.path() == absoluteSourceFile.path()) {
+        EASYHTTPCPP_LOG_D(Tag, "Copy is not necessary because source file and destination file are same [%s]",
+                destinationFile.path().c_str());
+        return true;
+    }
+
+    if (FileUtilImpl::cloneFile(absoluteSourceFile.path(), absoluteDestinationFile.path())) {
+        return true;
+    }
+
+    try {
+        absoluteSourceFile.copyTo(absoluteDestinationFile.path());
+
+        return true;
+    } catch (const Poco::Exception& e) {
+        EASYHTTPCPP_LOG_D(Tag, "copyFile(source[%s], destination[%s]) error: %s",
+                sourceFile.path().c_str(), destinationFile.path().c_str(), e.message().c_str());
+
+        return false;
+    }
+}
+
 std::string FileUtil::convertToAbsolutePathString(const std::string& path, bool extendedPrefix)
 {
     return FileUtilImpl::convertToAbsolutePathString(path, extendedPrefix);
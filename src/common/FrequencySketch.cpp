@@ -0,0 +1,95 @@
+/*
+ * Copyright 2019 Sony Corporation
+ */
+
+#include <algorithm>
+
+#include "Poco/Hash.h"
+
+#include "easyhttpcpp/common/FrequencySketch.h"
+
+namespace easyhttpcpp {
+namespace common {
+
+FrequencySketch::FrequencySketch(size_t expectedEntryCount) : m_width(0), m_additionCount(0), m_sampleSize(0)
+{
+    resize(expectedEntryCount);
+}
+
+FrequencySketch::~FrequencySketch()
+{
+}
+
+void FrequencySketch::increment(const std::string& key)
+{
+    Poco::UInt32 hash = static_cast<Poco::UInt32>(Poco::hash(key));
+    unsigned int minFrequency = frequency(key);
+    if (minFrequency >= MaxFrequency) {
+        return;
+    }
+    // conservative update; only the smallest counters are incremented, which keeps the estimation error low.
+    for (size_t depth = 0; depth < Depth; depth++) {
+        unsigned char& counter = m_counters[indexOf(hash, depth)];
+        if (counter == minFrequency) {
+            counter++;
+        }
+    }
+    if (++m_additionCount >= m_sampleSize) {
+        halve();
+    }
+}
+
+unsigned int FrequencySketch::frequency(const std::string& key) const
+{
+    Poco::UInt32 hash = static_cast<Poco::UInt32>(Poco::hash(key));
+    unsigned int minFrequency = MaxFrequency;
+    for (size_t depth = 0; depth < Depth; depth++) {
+        minFrequency = std::min(minFrequency, static_cast<unsigned int>(m_counters[indexOf(hash, depth)]));
+    }
+    return minFrequency;
+}
+
+void FrequencySketch::ensureCapacity(size_t expectedEntryCount)
+{
+    if (expectedEntryCount > m_width) {
+        resize(expectedEntryCount);
+    }
+}
+
+void FrequencySketch::clear()
+{
+    std::fill(m_counters.begin(), m_counters.end(), 0);
+    m_additionCount = 0;
+}
+
+void FrequencySketch::resize(size_t expectedEntryCount)
+{
+    size_t width = MinWidth;
+    while (width < expectedEntryCount) {
+        width <<= 1;
+    }
+    m_width = width;
+    m_counters.assign(m_width * Depth, 0);
+    m_additionCount = 0;
+    m_sampleSize = m_width * SampleSizeFactor;
+}
+
+size_t FrequencySketch::indexOf(Poco::UInt32 hash, size_t depth) const
+{
+    // double hashing; the rows use different combinations of two hashes of the key.
+    Poco::UInt32 secondHash = hash * 0x9E3779B9U;
+    secondHash ^= secondHash >> 16;
+    Poco::UInt32 index = hash + static_cast<Poco::UInt32>(depth) * secondHash;
+    return depth * m_width + (index & (m_width - 1));
+}
+
+void FrequencySketch::halve()
+{
+    for (std::vector<unsigned char>::iterator it = m_counters.begin(); it != m_counters.end(); it++) {
+        *it >>= 1;
+    }
+    m_additionCount /= 2;
+}
+
+} /* namespace common */
+} /* namespace easyhttpcpp */
@@ -10,14 +10,14 @@ namespace common {
 
 static const std::string Tag = "LruCacheByDataSizeStrategy";
 
-LruCacheByDataSizeStrategy::LruCacheByDataSizeStrategy(size_t maxSize) : m_pListener(NULL), m_maxSize(maxSize),
-        m_totalSize(0)
+LruCacheByDataSizeStrategy::LruCacheByDataSizeStrategy(size_t maxSize) : m_pListener(NULL), m_pNewest(NULL),
+        m_pOldest(NULL), m_maxSize(maxSize), m_totalSize(0)
 {
 }
 
 LruCacheByDataSizeStrategy::~LruCacheByDataSizeStrategy()
 {
-    m_lruList.clear();
+    unlinkAll();
     m_lruListMap.clear();
 }
 
@@ -76,10 +76,12 @@ bool LruCacheByDataSizeStrategy::remove(const std::string& key)
             }
         }
         if (ret) {
-            CacheInfoWithDataSize::Ptr pValue = *(it->second);
+            // keeps the entry until the end, since key may be the key of the entry.
+            CacheInfoWithDataSize::Ptr pValue = it->second;
             m_totalSize -= pValue->getDataSize();
-            m_lruList.erase(it->second);
+            unlink(pValue);
             m_lruListMap.erase(it);
+            onEntryRemoved(key);
         }
     } else {
         EASYHTTPCPP_LOG_D(Tag, "remove: not found key. [%s]", key.c_str());
@@ -90,26 +92,16 @@ bool LruCacheByDataSizeStrategy::remove(const std::string& key)
 
 CacheInfoWithDataSize::Ptr LruCacheByDataSizeStrategy::get(const std::string& key)
 {
-    LruListMap::Iterator it = m_lruListMap.find(key);
-    if (it != m_lruListMap.end()) {
-        CacheInfoWithDataSize::Ptr pCacheInfo = *(it->second);
-        // move to latest position
-        m_lruList.erase(it->second);
-        m_lruList.push_front(pCacheInfo);
-
-        it->second = m_lruList.begin();
-
-        if (m_pListener != NULL) {
-            if (!m_pListener->onGet(key, pCacheInfo)) {
-                EASYHTTPCPP_LOG_D(Tag, "get: onGet return false.");
-                return NULL;
-            }
-        }
-        return newCacheInfo(pCacheInfo);
-    } else {
-        EASYHTTPCPP_LOG_D(Tag, "get: not found key. [%s]", key.c_str());
+    CacheInfoWithDataSize* pCacheInfo = touch(key);
+    if (pCacheInfo == NULL) {
         return NULL;
     }
+    return newCacheInfo(CacheInfoWithDataSize::Ptr(pCacheInfo, true));
+}
+
+const CacheInfoWithDataSize* LruCacheByDataSizeStrategy::getView(const std::string& key)
+{
+    return touch(key);
 }
 
 bool LruCacheByDataSizeStrategy::clear(bool mayDeleteIfBusy)
@@ -124,9 +116,10 @@ bool LruCacheByDataSizeStrategy::clear(bool mayDeleteIfBusy)
 
 void LruCacheByDataSizeStrategy::reset()
 {
-    m_lruList.clear();
+    unlinkAll();
     m_lruListMap.clear();
     m_totalSize = 0;
+    onAllEntriesRemoved();
 }
 
 bool LruCacheByDataSizeStrategy::makeSpace(size_t requestSize)
@@ -146,13 +139,12 @@ size_t LruCacheByDataSizeStrategy::getTotalSize() const
 
 bool LruCacheByDataSizeStrategy::isEmpty() const
 {
-    return m_lruList.empty();
+    return m_pNewest == NULL;
 }
 
 bool LruCacheByDataSizeStrategy::createRemoveList(LruKeyList& keys, bool mayDeleteIfBusy)
 {
-    for (LruList::const_iterator it = m_lruList.begin(); it != m_lruList.end(); it++) {
-        CacheInfoWithDataSize::Ptr pCacheInfo = *it;
+    for (CacheInfoWithDataSize* pCacheInfo = m_pNewest; pCacheInfo != NULL; pCacheInfo = pCacheInfo->getOlder()) {
         keys.push_back(pCacheInfo->getKey());
     }
     return true;
@@ -161,19 +153,18 @@ bool LruCacheByDataSizeStrategy::createRemoveList(LruKeyList& keys, bool mayDele
 bool LruCacheByDataSizeStrategy::createRemoveLruDataList(LruKeyList& keys, size_t removeSize)
 {
     size_t targetSize = 0;
-    LruList::reverse_iterator it = m_lruList.rbegin();
+    CacheInfoWithDataSize* pCacheInfo = m_pOldest;
     while (targetSize < removeSize) {
-        if (it == m_lruList.rend()) {
+        if (pCacheInfo == NULL) {
             EASYHTTPCPP_LOG_D(Tag, "createRemoveLruDataList: can not make free space. removeSize=%zu", removeSize);
             return false;
         }
-        CacheInfoWithDataSize::Ptr pCacheInfo = *it;
         keys.push_front(pCacheInfo->getKey());
         targetSize += pCacheInfo->getDataSize();
         EASYHTTPCPP_LOG_D(Tag, "createRemoveLruDataList: dataDize=%zu key=%s", pCacheInfo->getDataSize(),
                 pCacheInfo->getKey().c_str());
 
-        ++it;
+        pCacheInfo = pCacheInfo->getNewer();
     }
     return true;
 }
@@ -183,12 +174,47 @@ CacheInfoWithDataSize::Ptr LruCacheByDataSizeStrategy::newCacheInfo(CacheInfoWit
     return new CacheInfoWithDataSize(*pCacheInfo);
 }
 
+void LruCacheByDataSizeStrategy::copyCacheInfo(CacheInfoWithDataSize& destination,
+        const CacheInfoWithDataSize& source)
+{
+    destination = source;
+}
+
+CacheInfoWithDataSize* LruCacheByDataSizeStrategy::touch(const std::string& key)
+{
+    LruListMap::Iterator it = m_lruListMap.find(key);
+    if (it == m_lruListMap.end()) {
+        EASYHTTPCPP_LOG_D(Tag, "get: not found key. [%s]", key.c_str());
+        return NULL;
+    }
+    CacheInfoWithDataSize* pCacheInfo = it->second;
+    // move to latest position
+    unlink(pCacheInfo);
+    linkNewest(pCacheInfo);
+
+    if (m_pListener != NULL) {
+        if (!m_pListener->onGet(key, it->second)) {
+            EASYHTTPCPP_LOG_D(Tag, "get: onGet return false.");
+            return NULL;
+        }
+    }
+    return pCacheInfo;
+}
+
+void LruCacheByDataSizeStrategy::onEntryRemoved(const std::string& key)
+{
+}
+
+void LruCacheByDataSizeStrategy::onAllEntriesRemoved()
+{
+}
+
 bool LruCacheByDataSizeStrategy::addOrUpdate(const std::string& key, CacheInfoWithDataSize::Ptr pCacheInfo)
 {
     // check free space
     LruListMap::Iterator it = m_lruListMap.find(key);
     if (it != m_lruListMap.end()) {
-        CacheInfoWithDataSize::Ptr pOldCacheInfo = *(it->second);
+        CacheInfoWithDataSize::Ptr pOldCacheInfo = it->second;
         if (pOldCacheInfo->getDataSize() < pCacheInfo->getDataSize()) {
             if (!makeSpace(pCacheInfo->getDataSize(), key)) {
                 return false;
@@ -203,16 +229,20 @@ bool LruCacheByDataSizeStrategy::addOrUpdate(const std::string& key, CacheInfoWi
     // find for update
     it = m_lruListMap.find(key);
     if (it != m_lruListMap.end()) {
-        CacheInfoWithDataSize::Ptr pOldCacheInfo = *(it->second);
+        // the kept entry is updated in place and moved to the top of the list.
+        CacheInfoWithDataSize* pOldCacheInfo = it->second;
         m_totalSize -= pOldCacheInfo->getDataSize();
-        // old value is removed from LruList
-        m_lruList.erase(it->second);
+        if (pOldCacheInfo != pCacheInfo.get()) {
+            copyCacheInfo(*pOldCacheInfo, *pCacheInfo);
+        }
+        unlink(pOldCacheInfo);
+        linkNewest(pOldCacheInfo);
+    } else {
+        // new value is pushed to top of the list
+        CacheInfoWithDataSize::Ptr pNewCacheInfo = newCacheInfo(pCacheInfo);
+        m_lruListMap[key] = pNewCacheInfo;
+        linkNewest(pNewCacheInfo);
     }
-    // new value is pushed to top of LruList
-    m_lruList.push_front(newCacheInfo(pCacheInfo));
-
-    // update lruListMap
-    m_lruListMap[key] = m_lruList.begin();
 
     m_totalSize += pCacheInfo->getDataSize();
 
@@ -225,7 +255,7 @@ bool LruCacheByDataSizeStrategy::makeSpace(size_t requestSize, const std::string
         return true;
     }
 
-    if (m_lruList.empty()) {
+    if (isEmpty()) {
         EASYHTTPCPP_LOG_D(Tag, "makeSpace: list is empty totalSize=%zu requestSize=%zu maxSize=%zu",
                 m_totalSize, requestSize, m_maxSize);
         return false;
@@ -247,5 +277,47 @@ bool LruCacheByDataSizeStrategy::makeSpace(size_t requestSize, const std::string
     }
 }
 
+void LruCacheByDataSizeStrategy::linkNewest(CacheInfoWithDataSize* pCacheInfo)
+{
+    pCacheInfo->m_pNewer = NULL;
+    pCacheInfo->m_pOlder = m_pNewest;
+    if (m_pNewest != NULL) {
+        m_pNewest->m_pNewer = pCacheInfo;
+    } else {
+        m_pOldest = pCacheInfo;
+    }
+    m_pNewest = pCacheInfo;
+}
+
+void LruCacheByDataSizeStrategy::unlink(CacheInfoWithDataSize* pCacheInfo)
+{
+    if (pCacheInfo->m_pNewer != NULL) {
+        pCacheInfo->m_pNewer->m_pOlder = pCacheInfo->m_pOlder;
+    } else {
+        m_pNewest = pCacheInfo->m_pOlder;
+    }
+    if (pCacheInfo->m_pOlder != NULL) {
+        pCacheInfo->m_pOlder->m_pNewer = pCacheInfo->m_pNewer;
+    } else {
+        m_pOldest = pCacheInfo->m_pNewer;
+    }
+    pCacheInfo->m_pNewer = NULL;
+    pCacheInfo->m_pOlder = NULL;
+}
+
+void LruCacheByDataSizeStrategy::unlinkAll()
+{
+    // entries may still be referenced by the callers; they must not point to each other.
+    CacheInfoWithDataSize* pCacheInfo = m_pNewest;
+    while (pCacheInfo != NULL) {
+        CacheInfoWithDataSize* pOlder = pCacheInfo->m_pOlder;
+        pCacheInfo->m_pNewer = NULL;
+        pCacheInfo->m_pOlder = NULL;
+        pCacheInfo = pOlder;
+    }
+    m_pNewest = NULL;
+    m_pOldest = NULL;
+}
+
 } /* namespace common */
 } /* namespace easyhttpcpp */
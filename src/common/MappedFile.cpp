@@ -0,0 +1,44 @@
+/*
+ * Copyright 2019 Sony Corporation
+ */
+
+#include "easyhttpcpp/common/FileUtil.h"
+#include "easyhttpcpp/common/MappedFile.h"
+
+#include "FileUtilImpl.h"
+
+namespace easyhttpcpp {
+namespace common {
+
+MappedFile::MappedFile(void* pAddress, size_t size) : m_pAddress(pAddress), m_size(size)
+{
+}
+
+MappedFile::~MappedFile()
+{
+    FileUtilImpl::unmapFile(m_pAddress, m_size);
+}
+
+MappedFile::Ptr MappedFile::map(const Poco::File& file, size_t maxSize, AccessPattern accessPattern)
+{
+    size_t size = 0;
+    void* pAddress = FileUtilImpl::mapFile(FileUtil::convertToAbsolutePathString(file.path()), maxSize,
+            accessPattern == AccessPatternSequential, size);
+    if (!pAddress) {
+        return NULL;
+    }
+    return new MappedFile(pAddress, size);
+}
+
+const char* MappedFile::getData() const
+{
+    return static_cast<const char*>(m_pAddress);
+}
+
+size_t MappedFile::getSize() const
+{
+    return m_size;
+}
+
+} /* namespace common */
+} /* namespace easyhttpcpp */
@@ -0,0 +1,76 @@
+/*
+ * Copyright 2019 Sony Corporation
+ */
+
+#include "easyhttpcpp/common/MappedFileInputStream.h"
+
+namespace easyhttpcpp {
+namespace common {
+
+MappedFileStreamBuf::MappedFileStreamBuf(MappedFile::Ptr pMappedFile) : m_pMappedFile(pMappedFile)
+{
+    // the get area is never written through.
+    char* pBegin = const_cast<char*>(m_pMappedFile->getData());
+    setg(pBegin, pBegin, pBegin + m_pMappedFile->getSize());
+}
+
+MappedFileStreamBuf::~MappedFileStreamBuf()
+{
+}
+
+void MappedFileStreamBuf::readRest(const char*& pData, size_t& size)
+{
+    pData = gptr();
+    size = static_cast<size_t>(egptr() - gptr());
+    setg(eback(), egptr(), egptr());
+}
+
+std::streamsize MappedFileStreamBuf::showmanyc()
+{
+    std::streamsize available = egptr() - gptr();
+    return available > 0 ? available : -1;
+}
+
+MappedFileStreamBuf::pos_type MappedFileStreamBuf::seekoff(off_type off, std::ios_base::seekdir dir,
+        std::ios_base::openmode which)
+{
+    if ((which & std::ios_base::in) == 0) {
+        return pos_type(off_type(-1));
+    }
+    off_type base = 0;
+    if (dir == std::ios_base::cur) {
+        base = gptr() - eback();
+    } else if (dir == std::ios_base::end) {
+        base = egptr() - eback();
+    }
+    off_type pos = base + off;
+    if (pos < 0 || pos > egptr() - eback()) {
+        return pos_type(off_type(-1));
+    }
+    setg(eback(), eback() + pos, egptr());
+    return pos_type(pos);
+}
+
+MappedFileStreamBuf::pos_type MappedFileStreamBuf::seekpos(pos_type pos, std::ios_base::openmode which)
+{
+    return seekoff(off_type(pos), std::ios_base::beg, which);
+}
+
+MappedFileInputStream::MappedFileInputStream(MappedFile::Ptr pMappedFile) : std::istream(NULL),
+        m_streamBuf(pMappedFile)
+{
+    rdbuf(&m_streamBuf);
+}
+
+MappedFileInputStream::~MappedFileInputStream()
+{
+}
+
+void MappedFileInputStream::readRest(const char*& pData, size_t& size)
+{
+    m_streamBuf.readRest(pData, size);
+    setstate(std::ios_base::eofbit);
+}
+
+} /* namespace common */
+} /* namespace easyhttpcpp */
@@ -0,0 +1,50 @@
+/*
+ * Copyright 2019 Sony Corporation
+ */
+
+#include "Poco/Hash.h"
+
+#include "easyhttpcpp/common/StripedMutex.h"
+
+namespace easyhttpcpp {
+namespace common {
+
+StripedMutex::StripedMutex()
+{
+}
+
+StripedMutex::~StripedMutex()
+{
+}
+
+Poco::FastMutex& StripedMutex::get(const std::string& key)
+{
+    return m_mutexes[Poco::hash(key) % StripeCount];
+}
+
+void StripedMutex::lockAll()
+{
+    for (size_t i = 0; i < StripeCount; i++) {
+        m_mutexes[i].lock();
+    }
+}
+
+void StripedMutex::unlockAll()
+{
+    for (size_t i = StripeCount; i > 0; i--) {
+        m_mutexes[i - 1].unlock();
+    }
+}
+
+StripedMutex::ScopedLockAll::ScopedLockAll(StripedMutex& stripedMutex) : m_stripedMutex(stripedMutex)
+{
+    m_stripedMutex.lockAll();
+}
+
+StripedMutex::ScopedLockAll::~ScopedLockAll()
+{
+    m_stripedMutex.unlockAll();
+}
+
+} /* namespace common */
+} /* namespace easyhttpcpp */
@@ -2,18 +2,141 @@
  * Copyright 2019 Sony Corporation
  */
 
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <linux/falloc.h>
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#include <sys/sendfile.h>
+#endif
+
 #include "Poco/Path.h"
 
+#include "easyhttpcpp/common/CoreLogger.h"
+
 #include "FileUtilImpl.h"
 
 namespace easyhttpcpp {
 namespace common {
 
+static const std::string Tag = "FileUtilImpl";
+
 std::string FileUtilImpl::convertToAbsolutePathString(const std::string& path, bool extendedPrefix)
 {
     // Linux returns absolute path.
     return Poco::Path(path).absolute().toString();
 }
 
+bool FileUtilImpl::preallocateFile(const std::string& path, Poco::UInt64 offset, Poco::UInt64 length)
+{
+#if defined(__linux__) && defined(FALLOC_FL_KEEP_SIZE)
+    int fd = ::open(path.c_str(), O_WRONLY | O_CLOEXEC);
+    if (fd < 0) {
+        EASYHTTPCPP_LOG_D(Tag, "preallocateFile: can not open %s. errno=%d", path.c_str(), errno);
+        return false;
+    }
+    // FALLOC_FL_KEEP_SIZE reserves the blocks without changing the file size, so a short body does not leave
+    // zero-filled bytes at the end of the file and O_APPEND writers keep writing at the real end of the data.
+    int ret = ::fallocate(fd, FALLOC_FL_KEEP_SIZE, static_cast<off_t>(offset), static_cast<off_t>(length));
+    if (ret != 0) {
+        EASYHTTPCPP_LOG_D(Tag, "preallocateFile: fallocate failed. errno=%d", errno);
+    }
+    ::close(fd);
+    return ret == 0;
+#else
+    return false;
+#endif
+}
+
+bool FileUtilImpl::cloneFile(const std::string& sourcePath, const std::string& destinationPath)
+{
+#if defined(__linux__)
+    int sourceFd = ::open(sourcePath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (sourceFd < 0) {
+        return false;
+    }
+    struct stat sourceStat;
+    if (::fstat(sourceFd, &sourceStat) != 0) {
+        ::close(sourceFd);
+        return false;
+    }
+    int destinationFd = ::open(destinationPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+    if (destinationFd < 0) {
+        ::close(sourceFd);
+        return false;
+    }
+
+    bool ret = false;
+#if defined(FICLONE)
+    // shares the extents copy-on-write on filesystems which support reflinks (btrfs, xfs).
+    ret = (::ioctl(destinationFd, FICLONE, sourceFd) == 0);
+#endif
+    if (!ret) {
+        // copies inside the kernel without bouncing the data through a user space buffer.
+        ret = true;
+        off_t offset = 0;
+        while (offset < sourceStat.st_size) {
+            ssize_t sentBytes = ::sendfile(destinationFd, sourceFd, &offset,
+                    static_cast<size_t>(sourceStat.st_size - offset));
+            if (sentBytes <= 0) {
+                EASYHTTPCPP_LOG_D(Tag, "cloneFile: sendfile failed. errno=%d", errno);
+                ret = false;
+                break;
+            }
+        }
+    }
+
+    ::close(sourceFd);
+    ::close(destinationFd);
+    if (!ret) {
+        ::unlink(destinationPath.c_str());
+    }
+    return ret;
+#else
+    return false;
+#endif
+}
+
+void* FileUtilImpl::mapFile(const std::string& path, size_t maxSize, bool sequential, size_t& size)
+{
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        EASYHTTPCPP_LOG_D(Tag, "mapFile: can not open %s. errno=%d", path.c_str(), errno);
+        return NULL;
+    }
+    struct stat fileStat;
+    // an empty file can not be mapped.
+    if (::fstat(fd, &fileStat) != 0 || fileStat.st_size <= 0 ||
+            static_cast<Poco::UInt64>(fileStat.st_size) > static_cast<Poco::UInt64>(maxSize)) {
+        ::close(fd);
+        return NULL;
+    }
+    size = static_cast<size_t>(fileStat.st_size);
+    // the mapping keeps the file referenced, so the descriptor is not needed any more.
+    void* pAddress = ::mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (pAddress == MAP_FAILED) {
+        EASYHTTPCPP_LOG_D(Tag, "mapFile: mmap failed. errno=%d", errno);
+        return NULL;
+    }
+    if (sequential) {
+        // read ahead aggressively and drop pages behind the reader.
+        ::madvise(pAddress, size, MADV_SEQUENTIAL);
+        ::madvise(pAddress, size, MADV_WILLNEED);
+    }
+    return pAddress;
+}
+
+void FileUtilImpl::unmapFile(void* pAddress, size_t size)
+{
+    if (::munmap(pAddress, size) != 0) {
+        EASYHTTPCPP_LOG_D(Tag, "unmapFile: munmap failed. errno=%d", errno);
+    }
+}
+
 } /* namespace common */
 } /* namespace easyhttpcpp */
@@ -26,5 +26,27 @@ std::string FileUtilImpl::convertToAbsolutePathString(const std::string& path, b
     }
 }
 
+bool FileUtilImpl::preallocateFile(const std::string& path, Poco::UInt64 offset, Poco::UInt64 length)
+{
+    // not supported; the file grows as it is written.
+    return false;
+}
+
+bool FileUtilImpl::cloneFile(const std::string& sourcePath, const std::string& destinationPath)
+{
+    // not supported; FileUtil::copyFile falls back to Poco::File::copyTo.
+    return false;
+}
+
+void* FileUtilImpl::mapFile(const std::string& path, size_t maxSize, bool sequential, size_t& size)
+{
+    // not supported; a mapped file can not be removed on Windows, so the file is read with a stream.
+    return NULL;
+}
+
+void FileUtilImpl::unmapFile(void* pAddress, size_t size)
+{
+}
+
 } /* namespace common */
 } /* namespace easyhttpcpp */
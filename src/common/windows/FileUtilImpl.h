@@ -5,12 +5,20 @@
 #ifndef EASYHTTPCPP_COMMON_FILEUTILIMPL_H_INCLUDED
 #define EASYHTTPCPP_COMMON_FILEUTILIMPL_H_INCLUDED
 
+#include <string>
+
+#include "Poco/Types.h"
+
 namespace easyhttpcpp {
 namespace common {
 
 class FileUtilImpl {
 public:
     static std::string convertToAbsolutePathString(const std::string& path, bool extendedPrefix);
+    static bool preallocateFile(const std::string& path, Poco::UInt64 offset, Poco::UInt64 length);
+    static bool cloneFile(const std::string& sourcePath, const std::string& destinationPath);
+    static void* mapFile(const std::string& path, size_t maxSize, bool sequential, size_t& size);
+    static void unmapFile(void* pAddress, size_t size);
 private:
     FileUtilImpl();
 };
@@ -2,7 +2,10 @@
  * Copyright 2017 Sony Corporation
  */
 
+#include <typeinfo>
+
 #include "Poco/Exception.h"
+#include "Poco/Data/LOB.h"
 #include "Poco/NumberParser.h"
 
 #include "easyhttpcpp/common/CoreLogger.h"
@@ -328,6 +331,28 @@ std::string SqliteCursor::optGetString(size_t columnIndex, const std::string& de
     return defaultValue;
 }
 
+std::string SqliteCursor::getBlob(size_t columnIndex)
+{
+    throwExceptionIfIllegalState(__func__);
+
+    try {
+        Poco::Dynamic::Var value = m_pRecordSet->value(columnIndex);
+        if (value.type() != typeid(Poco::Data::BLOB)) {
+            std::string result;
+            value.convert(result);
+            return result;
+        }
+        const Poco::Data::BLOB& blob = value.extract<Poco::Data::BLOB>();
+        if (blob.size() == 0) {
+            return std::string();
+        }
+        return std::string(reinterpret_cast<const char*>(blob.rawContent()), blob.size());
+    } catch (const Poco::Exception& e) {
+        EASYHTTPCPP_LOG_D(Tag, "getBlob Failed columnIndex [%zu]", columnIndex);
+        throw SqlExecutionException("getBlob Failed", e);
+    }
+}
+
 CursorFieldType SqliteCursor::getType(size_t columnIndex)
 {
     throwExceptionIfIllegalState(__func__);
@@ -6,6 +6,7 @@
 #include "Poco/Data/SQLite/SQLiteException.h"
 #include "Poco/Delegate.h"
 #include "Poco/SharedPtr.h"
+#include "Poco/String.h"
 #include "Poco/Data/Session.h"
 #include "Poco/Data/SQLite/Notifier.h"
 
@@ -25,6 +26,27 @@ namespace {
 
 const std::string Tag = "SqliteDatabase";
 
+// indexed by SqliteDatabase::JournalMode
+const char* const JournalModeNames[] = {
+    "DELETE",
+    "TRUNCATE",
+    "PERSIST",
+    "MEMORY",
+    "WAL",
+    "OFF"
+};
+
+easyhttpcpp::db::SqliteDatabase::JournalMode toJournalMode(const std::string& name)
+{
+    for (size_t i = 0; i < sizeof(JournalModeNames) / sizeof(JournalModeNames[0]); i++) {
+        if (Poco::icompare(name, JournalModeNames[i]) == 0) {
+            return static_cast<easyhttpcpp::db::SqliteDatabase::JournalMode>(i);
+        }
+    }
+    // unknown mode is regarded as default mode.
+    return easyhttpcpp::db::SqliteDatabase::JournalModeDelete;
+}
+
 } /* namespace */
 
 namespace easyhttpcpp {
@@ -114,6 +136,62 @@ SqliteCursor::Ptr SqliteDatabase::rawQuery(const std::string& sql, const std::ve
     }
 }
 
+SqliteStatement::Ptr SqliteDatabase::compileStatement(const std::string& sql)
+{
+    Poco::FastMutex::ScopedLock lock(m_mutex);
+    throwExceptionIfIllegalState();
+
+    StatementMap::iterator it = m_statements.find(sql);
+    if (it != m_statements.end()) {
+        return it->second;
+    }
+
+    try {
+        SqliteStatement::Ptr pStatement = new SqliteStatement(*m_pSession, sql);
+        m_statements[sql] = pStatement;
+        return pStatement;
+    } catch (const Poco::Exception& e) {
+        EASYHTTPCPP_LOG_D(Tag, "Failed to compile statement %s", e.message().c_str());
+        throw SqlExecutionException("Failed to compile statement " + sql, e);
+    }
+}
+
+SqliteCursor::Ptr SqliteDatabase::queryStatement(SqliteStatement::Ptr pStatement)
+{
+    Poco::FastMutex::ScopedLock lock(m_mutex);
+    throwExceptionIfIllegalState();
+
+    try {
+        pStatement->execute();
+
+        return new SqliteCursor(pStatement->getStatement());
+    } catch (const Poco::Exception& e) {
+        // failed statement can not be executed again; compile it next time.
+        m_statements.erase(pStatement->getSql());
+        checkForDatabaseCorruption(__func__, e);
+
+        EASYHTTPCPP_LOG_D(Tag, "Failed to query statement %s", e.message().c_str());
+        throw SqlExecutionException("query statement failed", e);
+    }
+}
+
+size_t SqliteDatabase::executeUpdateDelete(SqliteStatement::Ptr pStatement)
+{
+    Poco::FastMutex::ScopedLock lock(m_mutex);
+    throwExceptionIfIllegalState();
+
+    try {
+        return pStatement->execute();
+    } catch (const Poco::Exception& e) {
+        // failed statement can not be executed again; compile it next time.
+        m_statements.erase(pStatement->getSql());
+        checkForDatabaseCorruption(__func__, e);
+
+        EASYHTTPCPP_LOG_D(Tag, "Failed to execute statement %s", e.message().c_str());
+        throw SqlExecutionException("Failed to execute statement " + pStatement->getSql(), e);
+    }
+}
+
 void SqliteDatabase::insert(const std::string& table, const ContentValues& values)
 {
     Poco::FastMutex::ScopedLock lock(m_mutex);
@@ -227,6 +305,8 @@ void SqliteDatabase::closeSqliteSession()
     if (!m_pSession) {
         return;
     }
+    // compiled statements must be released before the session they belong to.
+    m_statements.clear();
     m_pSession->close();
     m_pSession = NULL;
 }
@@ -302,6 +382,88 @@ void SqliteDatabase::setAutoVacuum(AutoVacuum autoVacuum)
     execSql(sql);
 }
 
+SqliteDatabase::JournalMode SqliteDatabase::getJournalMode()
+{
+    std::string sql = "PRAGMA journal_mode;";
+
+    SqliteCursor::Ptr pCursor = rawQuery(sql, NULL);
+    return toJournalMode(pCursor->getString(0));
+}
+
+void SqliteDatabase::setJournalMode(JournalMode journalMode)
+{
+    std::string sql = StringUtil::format("PRAGMA journal_mode = %s;", JournalModeNames[journalMode]);
+
+    // journal_mode returns the mode in effect after the change.
+    SqliteCursor::Ptr pCursor = rawQuery(sql, NULL);
+    std::string actualMode = pCursor->getString(0);
+    if (toJournalMode(actualMode) != journalMode) {
+        EASYHTTPCPP_LOG_D(Tag, "journal mode %s is not applied. current mode is %s", JournalModeNames[journalMode],
+                actualMode.c_str());
+    }
+}
+
+SqliteDatabase::Synchronous SqliteDatabase::getSynchronous()
+{
+    std::string sql = "PRAGMA synchronous;";
+
+    SqliteCursor::Ptr pCursor = rawQuery(sql, NULL);
+    return static_cast<SqliteDatabase::Synchronous>(pCursor->getInt(0));
+}
+
+void SqliteDatabase::setSynchronous(Synchronous synchronous)
+{
+    std::string sql = StringUtil::format("PRAGMA synchronous = %d;", synchronous);
+    execSql(sql);
+}
+
+int SqliteDatabase::getCacheSize()
+{
+    std::string sql = "PRAGMA cache_size;";
+
+    SqliteCursor::Ptr pCursor = rawQuery(sql, NULL);
+    return pCursor->getInt(0);
+}
+
+void SqliteDatabase::setCacheSize(int cacheSize)
+{
+    std::string sql = StringUtil::format("PRAGMA cache_size = %d;", cacheSize);
+    execSql(sql);
+}
+
+long long SqliteDatabase::getMmapSize()
+{
+    std::string sql = "PRAGMA mmap_size;";
+
+    SqliteCursor::Ptr pCursor = rawQuery(sql, NULL);
+    return pCursor->getLongLong(0);
+}
+
+void SqliteDatabase::setMmapSize(long long mmapSize)
+{
+    std::string sql = StringUtil::format("PRAGMA mmap_size = %lld;", mmapSize);
+
+    // mmap_size returns the size in effect after the change.
+    rawQuery(sql, NULL);
+}
+
+unsigned int SqliteDatabase::getBusyTimeout()
+{
+    std::string sql = "PRAGMA busy_timeout;";
+
+    SqliteCursor::Ptr pCursor = rawQuery(sql, NULL);
+    int busyTimeout = pCursor->getInt(0);
+    return busyTimeout < 0 ? 0 : static_cast<unsigned int>(busyTimeout);
+}
+
+void SqliteDatabase::setBusyTimeout(unsigned int busyTimeoutMs)
+{
+    std::string sql = StringUtil::format("PRAGMA busy_timeout = %u;", busyTimeoutMs);
+
+    // busy_timeout returns the timeout in effect after the change.
+    rawQuery(sql, NULL);
+}
+
 bool SqliteDatabase::isOpen()
 {
     Poco::FastMutex::ScopedLock lock(m_mutex);
@@ -311,6 +473,7 @@ bool SqliteDatabase::isOpen()
 void SqliteDatabase::reopen()
 {
     try {
+        m_statements.clear();
         m_pSession->close();
         m_pSession->open();
         m_opened = true;
@@ -0,0 +1,84 @@
+/*
+ * Copyright 2019 Sony Corporation
+ */
+
+#include <algorithm>
+
+#include "Poco/Types.h"
+#include "Poco/Data/LOB.h"
+
+#include "easyhttpcpp/common/CoreLogger.h"
+#include "easyhttpcpp/common/StringUtil.h"
+#include "easyhttpcpp/db/SqlException.h"
+#include "easyhttpcpp/db/SqliteStatement.h"
+
+using easyhttpcpp::common::StringUtil;
+
+namespace easyhttpcpp {
+namespace db {
+
+static const std::string Tag = "SqliteStatement";
+
+SqliteStatement::SqliteStatement(Poco::Data::Session& session, const std::string& sql) : m_sql(sql),
+        m_parameters(std::count(sql.begin(), sql.end(), '?'), Poco::Dynamic::Var(std::string()))
+{
+    m_pStatement = new Poco::Data::Statement(session);
+    *m_pStatement << m_sql;
+    for (size_t i = 0; i < m_parameters.size(); i++) {
+        *m_pStatement, Poco::Data::Keywords::use(m_parameters[i]);
+    }
+}
+
+SqliteStatement::~SqliteStatement()
+{
+}
+
+const std::string& SqliteStatement::getSql() const
+{
+    return m_sql;
+}
+
+size_t SqliteStatement::getParameterCount() const
+{
+    return m_parameters.size();
+}
+
+void SqliteStatement::bindString(size_t index, const std::string& value)
+{
+    throwExceptionIfIllegalIndex(index);
+    m_parameters[index] = value;
+}
+
+void SqliteStatement::bindLongLong(size_t index, long long value)
+{
+    throwExceptionIfIllegalIndex(index);
+    m_parameters[index] = static_cast<Poco::Int64>(value);
+}
+
+void SqliteStatement::bindBlob(size_t index, const std::string& value)
+{
+    throwExceptionIfIllegalIndex(index);
+    m_parameters[index] = Poco::Data::BLOB(reinterpret_cast<const unsigned char*>(value.data()), value.size());
+}
+
+size_t SqliteStatement::execute()
+{
+    return m_pStatement->execute();
+}
+
+Poco::Data::Statement& SqliteStatement::getStatement()
+{
+    return *m_pStatement;
+}
+
+void SqliteStatement::throwExceptionIfIllegalIndex(size_t index) const
+{
+    if (index >= m_parameters.size()) {
+        EASYHTTPCPP_LOG_D(Tag, "invalid parameter index %zu (count=%zu)", index, m_parameters.size());
+        throw SqlIllegalArgumentException(StringUtil::format("Parameter index %zu is out of range. [%s]", index,
+                m_sql.c_str()));
+    }
+}
+
+} /* namespace db */
+} /* namespace easyhttpcpp */
@@ -0,0 +1,66 @@
+/*
+ * Copyright 2019 Sony Corporation
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "easyhttpcpp/common/CoreLogger.h"
+
+#include "RandomAccessFileImpl.h"
+
+namespace easyhttpcpp {
+
+static const std::string Tag = "RandomAccessFileImpl";
+
+RandomAccessFileImpl::RandomAccessFileImpl() : m_fd(-1)
+{
+}
+
+RandomAccessFileImpl::~RandomAccessFileImpl()
+{
+    close();
+}
+
+bool RandomAccessFileImpl::open(const std::string& path)
+{
+    close();
+    m_fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC, 0666);
+    if (m_fd < 0) {
+        EASYHTTPCPP_LOG_D(Tag, "open: can not open %s. errno=%d", path.c_str(), errno);
+        return false;
+    }
+    return true;
+}
+
+bool RandomAccessFileImpl::writeAt(const char* pBuffer, size_t length, Poco::UInt64 offset)
+{
+    if (m_fd < 0) {
+        return false;
+    }
+    while (length > 0) {
+        ssize_t writtenBytes = ::pwrite(m_fd, pBuffer, length, static_cast<off_t>(offset));
+        if (writtenBytes < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            EASYHTTPCPP_LOG_D(Tag, "writeAt: pwrite failed. errno=%d", errno);
+            return false;
+        }
+        pBuffer += writtenBytes;
+        length -= static_cast<size_t>(writtenBytes);
+        offset += static_cast<Poco::UInt64>(writtenBytes);
+    }
+    return true;
+}
+
+void RandomAccessFileImpl::close()
+{
+    if (m_fd >= 0) {
+        ::close(m_fd);
+        m_fd = -1;
+    }
+}
+
+} /* namespace easyhttpcpp */
@@ -0,0 +1,33 @@
+/*
+ * Copyright 2019 Sony Corporation
+ */
+
+#ifndef EASYHTTPCPP_RANDOMACCESSFILEIMPL_H_INCLUDED
+#define EASYHTTPCPP_RANDOMACCESSFILEIMPL_H_INCLUDED
+
+#include <string>
+
+#include "Poco/Types.h"
+
+namespace easyhttpcpp {
+
+// positional writes (pwrite) which can be issued by multiple threads to one file descriptor.
+class RandomAccessFileImpl {
+public:
+    RandomAccessFileImpl();
+    ~RandomAccessFileImpl();
+
+    bool open(const std::string& path);
+    bool writeAt(const char* pBuffer, size_t length, Poco::UInt64 offset);
+    void close();
+
+private:
+    RandomAccessFileImpl(const RandomAccessFileImpl&);
+    RandomAccessFileImpl& operator=(const RandomAccessFileImpl&);
+
+    int m_fd;
+};
+
+} /* namespace easyhttpcpp */
+
+#endif /* EASYHTTPCPP_RANDOMACCESSFILEIMPL_H_INCLUDED */
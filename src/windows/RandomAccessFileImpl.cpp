@@ -0,0 +1,68 @@
+/*
+ * Copyright 2019 Sony Corporation
+ */
+
+#include "Poco/UnicodeConverter.h"
+
+#include "easyhttpcpp/common/CoreLogger.h"
+
+#include "RandomAccessFileImpl.h"
+
+namespace easyhttpcpp {
+
+static const std::string Tag = "RandomAccessFileImpl";
+
+RandomAccessFileImpl::RandomAccessFileImpl() : m_handle(INVALID_HANDLE_VALUE)
+{
+}
+
+RandomAccessFileImpl::~RandomAccessFileImpl()
+{
+    close();
+}
+
+bool RandomAccessFileImpl::open(const std::string& path)
+{
+    close();
+    std::wstring widePath;
+    Poco::UnicodeConverter::toUTF16(path, widePath);
+    m_handle = CreateFileW(widePath.c_str(), GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_ALWAYS,
+            FILE_ATTRIBUTE_NORMAL, NULL);
+    if (m_handle == INVALID_HANDLE_VALUE) {
+        EASYHTTPCPP_LOG_D(Tag, "open: can not open %s. error=%lu", path.c_str(), GetLastError());
+        return false;
+    }
+    return true;
+}
+
+bool RandomAccessFileImpl::writeAt(const char* pBuffer, size_t length, Poco::UInt64 offset)
+{
+    if (m_handle == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    while (length > 0) {
+        OVERLAPPED overlapped = {0};
+        overlapped.Offset = static_cast<DWORD>(offset & 0xFFFFFFFF);
+        overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+        DWORD chunkBytes = length > 0x40000000 ? 0x40000000 : static_cast<DWORD>(length);
+        DWORD writtenBytes = 0;
+        if (!WriteFile(m_handle, pBuffer, chunkBytes, &writtenBytes, &overlapped)) {
+            EASYHTTPCPP_LOG_D(Tag, "writeAt: WriteFile failed. error=%lu", GetLastError());
+            return false;
+        }
+        pBuffer += writtenBytes;
+        length -= writtenBytes;
+        offset += writtenBytes;
+    }
+    return true;
+}
+
+void RandomAccessFileImpl::close()
+{
+    if (m_handle != INVALID_HANDLE_VALUE) {
+        CloseHandle(m_handle);
+        m_handle = INVALID_HANDLE_VALUE;
+    }
+}
+
+} /* namespace easyhttpcpp */
@@ -1214,6 +1214,8 @@ TEST_F(CallWithCacheAfterSendRequestIntegrationTest,
         pResponse2->getBody()->toString();
 
         Poco::Timestamp endTime;
+        // last accessed time is written to database in batch.
+        pCache->flush();
 
         // Then: use cached response and not remove cached response.
         // check database (old data exists)
@@ -1310,6 +1312,8 @@ TEST_F(CallWithCacheAfterSendRequestIntegrationTest,
     std::string responseBody = pResponse2->getBody()->toString();
 
     Poco::Timestamp endTime;
+    // last accessed time is written to database in batch.
+    pCache->flush();
 
     // Then: use network access and not store to cache and not remove cached response.
     // check database (old data exists)
@@ -6,12 +6,14 @@
 
 #include "gtest/gtest.h"
 
+#include "Poco/AtomicCounter.h"
 #include "Poco/Event.h"
 #include "Poco/File.h"
 #include "Poco/FileStream.h"
 #include "Poco/HashMap.h"
 #include "Poco/NumberFormatter.h"
 #include "Poco/Path.h"
+#include "Poco/Thread.h"
 #include "Poco/Timestamp.h"
 #include "Poco/URI.h"
 #include "Poco/Net/HTTPRequestHandler.h"
@@ -22,6 +24,7 @@
 #include "easyhttpcpp/common/FileUtil.h"
 #include "easyhttpcpp/common/StringUtil.h"
 #include "easyhttpcpp/EasyHttp.h"
+#include "easyhttpcpp/HttpConstants.h"
 #include "easyhttpcpp/HttpException.h"
 #include "easyhttpcpp/Interceptor.h"
 #include "easyhttpcpp/Request.h"
@@ -67,6 +70,11 @@ static const char* const HeaderValueDate = "Fri, 22 Jul 2016 15:30:12 GMT";
 static const char* const DifferentResponseBody2 = "<html><body>different response body 2</body><html>";
 static const char* const DifferentResponseContentType2 = "text/html";
 
+static const char* const HeaderValueStaleWhileRevalidate = "max-age=0, stale-while-revalidate=60";
+static const char* const HeaderValueStaleIfError = "max-age=0, stale-if-error=60";
+static const int CacheRefreshPollingCount = 100;
+static const long CacheRefreshPollingIntervalMillis = 50;
+
 class CallWithCacheBeforeSendRequestIntegrationTest : public HttpIntegrationTestCase {
 protected:
 
@@ -315,6 +323,80 @@ public:
     }
 };
 
+// the first response is stale at once; a conditional request is answered by 304 which makes the cache fresh.
+class StaleWhileRevalidateRequestHandler : public Poco::Net::HTTPRequestHandler {
+public:
+
+    virtual void handleRequest(Poco::Net::HTTPServerRequest& request, Poco::Net::HTTPServerResponse& response)
+    {
+        m_requestCount++;
+        response.set(HeaderEtag, HeaderValueEtag);
+        if (request.has(HeaderIfNoneMatch)) {
+            response.set(HttpTestConstants::HeaderCacheControl, HttpTestConstants::MaxAgeOneHour);
+            response.setStatus(Poco::Net::HTTPResponse::HTTP_NOT_MODIFIED);
+            response.send();
+            return;
+        }
+        response.setContentType(HttpTestConstants::DefaultResponseContentType);
+        response.setStatus(Poco::Net::HTTPResponse::HTTP_OK);
+        response.setContentLength(strlen(HttpTestConstants::DefaultResponseBody));
+        response.set(HttpTestConstants::HeaderCacheControl, HeaderValueStaleWhileRevalidate);
+
+        std::ostream& ostr = response.send();
+        ostr << HttpTestConstants::DefaultResponseBody;
+    }
+
+    int getRequestCount() const
+    {
+        return m_requestCount.value();
+    }
+
+private:
+    Poco::AtomicCounter m_requestCount;
+};
+
+// the first response is stale at once; the following requests are answered by 500.
+class StaleIfErrorRequestHandler : public Poco::Net::HTTPRequestHandler {
+public:
+
+    virtual void handleRequest(Poco::Net::HTTPServerRequest& request, Poco::Net::HTTPServerResponse& response)
+    {
+        if (m_requestCount++ > 0) {
+            response.setStatus(Poco::Net::HTTPResponse::HTTP_INTERNAL_SERVER_ERROR);
+            response.setContentLength(0);
+            response.send();
+            return;
+        }
+        response.setContentType(HttpTestConstants::DefaultResponseContentType);
+        response.setStatus(Poco::Net::HTTPResponse::HTTP_OK);
+        response.setContentLength(strlen(HttpTestConstants::DefaultResponseBody));
+        response.set(HeaderEtag, HeaderValueEtag);
+        response.set(HttpTestConstants::HeaderCacheControl, HeaderValueStaleIfError);
+
+        std::ostream& ostr = response.send();
+        ostr << HttpTestConstants::DefaultResponseBody;
+    }
+
+private:
+    Poco::AtomicCounter m_requestCount;
+};
+
+// the background revalidation updates the cache database asynchronously.
+bool waitForCachedCacheControl(const std::string& cachePath, const std::string& url, const std::string& cacheControl)
+{
+    HttpCacheDatabase db(new HttpCacheDatabaseOpenHelper(HttpTestUtil::createDatabasePath(cachePath)));
+    std::string key = HttpUtil::makeCacheKey(Request::HttpMethodGet, url);
+    for (int i = 0; i < CacheRefreshPollingCount; i++) {
+        HttpCacheDatabase::HttpCacheMetadataAll::Ptr pMetadata = db.getMetadataAll(key);
+        if (pMetadata && pMetadata->getResponseHeaders()->getValue(HttpTestConstants::HeaderCacheControl, "") ==
+                cacheControl) {
+            return true;
+        }
+        Poco::Thread::sleep(CacheRefreshPollingIntervalMillis);
+    }
+    return false;
+}
+
 } /* namespace */
 
 TEST_F(CallWithCacheBeforeSendRequestIntegrationTest,
@@ -378,6 +460,8 @@ TEST_F(CallWithCacheBeforeSendRequestIntegrationTest,
     std::string responseBody2 = pResponse2->getBody()->toString();
 
     Poco::Timestamp endTime2;
+    // last accessed time is written to database in batch.
+    pCache->flush();
 
     // database is same as 1st request (except lastAccessedAtEpoch)
     HttpCacheDatabase::HttpCacheMetadataAll::Ptr pMetadata2;
@@ -458,6 +542,8 @@ TEST_F(CallWithCacheBeforeSendRequestIntegrationTest,
     std::string responseBody2 = pResponse2->getBody()->toString();
 
     Poco::Timestamp endTime2;
+    // last accessed time is written to database in batch.
+    pCache->flush();
 
     // database is same as 1st request (except lastAccessedAtEpoch)
     HttpCacheDatabase::HttpCacheMetadataAll::Ptr pMetadata2;
@@ -531,6 +617,8 @@ TEST_F(CallWithCacheBeforeSendRequestIntegrationTest,
     std::string responseBody2 = pResponse2->getBody()->toString();
 
     Poco::Timestamp endTime2;
+    // last accessed time is written to database in batch.
+    pCache->flush();
 
     // check database
     HttpCacheDatabase::HttpCacheMetadataAll::Ptr pMetadata2;
@@ -604,6 +692,8 @@ TEST_F(CallWithCacheBeforeSendRequestIntegrationTest,
     std::string responseBody2 = pResponse2->getBody()->toString();
 
     Poco::Timestamp endTime2;
+    // last accessed time is written to database in batch.
+    pCache->flush();
 
     // database is same as 1st request (except lastAccessedAtEpoch)
     HttpCacheDatabase::HttpCacheMetadataAll::Ptr pMetadata2;
@@ -1405,6 +1495,8 @@ TEST_F(CallWithCacheBeforeSendRequestIntegrationTest,
     EXPECT_FALSE(pResponse2->hasContentLength());
 
     Poco::Timestamp endTime2;
+    // last accessed time is written to database in batch.
+    pCache->flush();
 
     // database is same as 1st request (except lastAccessedAtEpoch)
     HttpCacheDatabase::HttpCacheMetadataAll::Ptr pMetadata2;
@@ -1477,5 +1569,197 @@ TEST_F(CallWithCacheBeforeSendRequestIntegrationTest,
     EASYHTTPCPP_EXPECT_THROW(pCall2->execute(), HttpExecutionException, 100702);
 }
 
+TEST_F(CallWithCacheBeforeSendRequestIntegrationTest,
+        execute_SendsRequestWithinRequestCoalescingTimeout_WhenLeaderDoesNotReadResponseBody)
+{
+    // Given: request coalescing is enabled. the first request has the response but does not read its body.
+    HttpTestServer testServer;
+    HttpTestCommonRequestHandler::OneHourMaxAgeRequestHandler handler;
+    testServer.getTestRequestHandlerFactory().addHandler(HttpTestConstants::DefaultPath, &handler);
+    testServer.start(HttpTestConstants::DefaultPort);
+
+    std::string cachePath = HttpTestUtil::getDefaultCachePath();
+    HttpCache::Ptr pCache = HttpCache::createCache(Poco::Path(cachePath), HttpTestConstants::DefaultCacheMaxSize);
+
+    EasyHttp::Builder httpClientBuilder;
+    EasyHttp::Ptr pHttpClient = httpClientBuilder.setCache(pCache).setRequestCoalescingEnabled(true)
+            .setRequestCoalescingTimeoutMillis(200).build();
+    Request::Builder requestBuilder1;
+    std::string url = HttpTestConstants::DefaultTestUrlWithQuery;
+    Request::Ptr pRequest1 = requestBuilder1.setUrl(url).build();
+    Call::Ptr pCall1 = pHttpClient->newCall(pRequest1);
+    Response::Ptr pResponse1 = pCall1->execute();
+    ASSERT_EQ(Poco::Net::HTTPResponse::HTTP_OK, pResponse1->getCode());
+
+    Request::Builder requestBuilder2;
+    Request::Ptr pRequest2 = requestBuilder2.setUrl(url).build();
+    Call::Ptr pCall2 = pHttpClient->newCall(pRequest2);
+
+    // When: execute the same request.
+    Poco::Timestamp startTime;
+    Response::Ptr pResponse2 = pCall2->execute();
+    Poco::Timestamp::TimeDiff elapsedMillis = startTime.elapsed() / 1000;
+
+    // Then: the request waits for the request coalescing timeout, not for the HTTP timeout, and goes to network.
+    EXPECT_EQ(Poco::Net::HTTPResponse::HTTP_OK, pResponse2->getCode());
+    EXPECT_FALSE(pResponse2->getNetworkResponse().isNull());
+    EXPECT_TRUE(pResponse2->getCacheResponse().isNull());
+    EXPECT_GE(elapsedMillis, 200);
+    EXPECT_LT(elapsedMillis, 5000);
+    EXPECT_EQ(HttpTestConstants::DefaultResponseBody, pResponse2->getBody()->toString());
+    EXPECT_EQ(HttpTestConstants::DefaultResponseBody, pResponse1->getBody()->toString());
+}
+
+TEST_F(CallWithCacheBeforeSendRequestIntegrationTest,
+        execute_RefreshesCacheInBackground_WhenCacheIsStaleWithinStaleWhileRevalidateAndBodyIsBeingRead)
+{
+    // Given: a stale response within stale-while-revalidate is in cache.
+    HttpTestServer testServer;
+    StaleWhileRevalidateRequestHandler handler;
+    testServer.getTestRequestHandlerFactory().addHandler(HttpTestConstants::DefaultPath, &handler);
+    testServer.start(HttpTestConstants::DefaultPort);
+
+    std::string cachePath = HttpTestUtil::getDefaultCachePath();
+    HttpCache::Ptr pCache = HttpCache::createCache(Poco::Path(cachePath), HttpTestConstants::DefaultCacheMaxSize);
+
+    EasyHttp::Builder httpClientBuilder;
+    EasyHttp::Ptr pHttpClient = httpClientBuilder.setCache(pCache).build();
+    std::string url = HttpTestConstants::DefaultTestUrlWithQuery;
+    Request::Builder requestBuilder1;
+    Request::Ptr pRequest1 = requestBuilder1.setUrl(url).build();
+    Response::Ptr pResponse1 = pHttpClient->newCall(pRequest1)->execute();
+    ASSERT_EQ(Poco::Net::HTTPResponse::HTTP_OK, pResponse1->getCode());
+    ASSERT_EQ(HttpTestConstants::DefaultResponseBody, pResponse1->getBody()->toString());
+
+    // When: execute the same request and keep its response body open.
+    Request::Builder requestBuilder2;
+    Request::Ptr pRequest2 = requestBuilder2.setUrl(url).build();
+    Response::Ptr pResponse2 = pHttpClient->newCall(pRequest2)->execute();
+
+    // Then: the stale response is returned at once, and 304 of the background revalidation refreshes the cache
+    // while the stale response body is still open.
+    ASSERT_EQ(Poco::Net::HTTPResponse::HTTP_OK, pResponse2->getCode());
+    EXPECT_TRUE(pResponse2->getNetworkResponse().isNull());
+    EXPECT_EQ(HttpConstants::HeaderValues::ResponseIsStale,
+            pResponse2->getHeaderValue(HttpConstants::HeaderNames::Warning, ""));
+    EXPECT_TRUE(waitForCachedCacheControl(cachePath, url, HttpTestConstants::MaxAgeOneHour));
+    EXPECT_EQ(HttpTestConstants::DefaultResponseBody, pResponse2->getBody()->toString());
+
+    // the refreshed cache is fresh, so the next request does not go to network.
+    Request::Builder requestBuilder3;
+    Request::Ptr pRequest3 = requestBuilder3.setUrl(url).build();
+    Response::Ptr pResponse3 = pHttpClient->newCall(pRequest3)->execute();
+    EXPECT_EQ(Poco::Net::HTTPResponse::HTTP_OK, pResponse3->getCode());
+    EXPECT_TRUE(pResponse3->getNetworkResponse().isNull());
+    EXPECT_FALSE(pResponse3->getCacheResponse().isNull());
+    EXPECT_FALSE(pResponse3->hasHeader(HttpConstants::HeaderNames::Warning));
+    EXPECT_EQ(HttpTestConstants::DefaultResponseBody, pResponse3->getBody()->toString());
+    EXPECT_EQ(2, handler.getRequestCount());
+}
+
+TEST_F(CallWithCacheBeforeSendRequestIntegrationTest,
+        execute_ReturnsStaleCacheResponse_WhenServerErrorWithinStaleIfError)
+{
+    // Given: a stale response within stale-if-error is in cache, and the server answers 500 from now on.
+    HttpTestServer testServer;
+    StaleIfErrorRequestHandler handler;
+    testServer.getTestRequestHandlerFactory().addHandler(HttpTestConstants::DefaultPath, &handler);
+    testServer.start(HttpTestConstants::DefaultPort);
+
+    std::string cachePath = HttpTestUtil::getDefaultCachePath();
+    HttpCache::Ptr pCache = HttpCache::createCache(Poco::Path(cachePath), HttpTestConstants::DefaultCacheMaxSize);
+
+    EasyHttp::Builder httpClientBuilder;
+    EasyHttp::Ptr pHttpClient = httpClientBuilder.setCache(pCache).build();
+    std::string url = HttpTestConstants::DefaultTestUrlWithQuery;
+    Request::Builder requestBuilder1;
+    Request::Ptr pRequest1 = requestBuilder1.setUrl(url).build();
+    Response::Ptr pResponse1 = pHttpClient->newCall(pRequest1)->execute();
+    ASSERT_EQ(Poco::Net::HTTPResponse::HTTP_OK, pResponse1->getCode());
+    ASSERT_EQ(HttpTestConstants::DefaultResponseBody, pResponse1->getBody()->toString());
+
+    // When: execute the same request.
+    Request::Builder requestBuilder2;
+    Request::Ptr pRequest2 = requestBuilder2.setUrl(url).build();
+    Response::Ptr pResponse2 = pHttpClient->newCall(pRequest2)->execute();
+
+    // Then: the stale response is returned instead of 500.
+    EXPECT_EQ(Poco::Net::HTTPResponse::HTTP_OK, pResponse2->getCode());
+    EXPECT_TRUE(pResponse2->getNetworkResponse().isNull());
+    EXPECT_EQ(HttpConstants::HeaderValues::RevalidationFailed,
+            pResponse2->getHeaderValue(HttpConstants::HeaderNames::Warning, ""));
+    EXPECT_EQ(HttpTestConstants::DefaultResponseBody, pResponse2->getBody()->toString());
+}
+
+TEST_F(CallWithCacheBeforeSendRequestIntegrationTest,
+        execute_ReturnsStaleCacheResponse_WhenRequestFailsWithinStaleIfError)
+{
+    // Given: a stale response within stale-if-error is in cache, and the server is stopped.
+    HttpTestServer testServer;
+    StaleIfErrorRequestHandler handler;
+    testServer.getTestRequestHandlerFactory().addHandler(HttpTestConstants::DefaultPath, &handler);
+    testServer.start(HttpTestConstants::DefaultPort);
+
+    std::string cachePath = HttpTestUtil::getDefaultCachePath();
+    HttpCache::Ptr pCache = HttpCache::createCache(Poco::Path(cachePath), HttpTestConstants::DefaultCacheMaxSize);
+
+    EasyHttp::Builder httpClientBuilder;
+    EasyHttp::Ptr pHttpClient = httpClientBuilder.setCache(pCache).build();
+    std::string url = HttpTestConstants::DefaultTestUrlWithQuery;
+    Request::Builder requestBuilder1;
+    Request::Ptr pRequest1 = requestBuilder1.setUrl(url).build();
+    Response::Ptr pResponse1 = pHttpClient->newCall(pRequest1)->execute();
+    ASSERT_EQ(Poco::Net::HTTPResponse::HTTP_OK, pResponse1->getCode());
+    ASSERT_EQ(HttpTestConstants::DefaultResponseBody, pResponse1->getBody()->toString());
+    testServer.stop();
+
+    // When: execute the same request.
+    Request::Builder requestBuilder2;
+    Request::Ptr pRequest2 = requestBuilder2.setUrl(url).build();
+    Response::Ptr pResponse2 = pHttpClient->newCall(pRequest2)->execute();
+
+    // Then: the stale response is returned instead of throwing.
+    EXPECT_EQ(Poco::Net::HTTPResponse::HTTP_OK, pResponse2->getCode());
+    EXPECT_TRUE(pResponse2->getNetworkResponse().isNull());
+    EXPECT_EQ(HttpConstants::HeaderValues::RevalidationFailed,
+            pResponse2->getHeaderValue(HttpConstants::HeaderNames::Warning, ""));
+    EXPECT_EQ(HttpTestConstants::DefaultResponseBody, pResponse2->getBody()->toString());
+}
+
+TEST_F(CallWithCacheBeforeSendRequestIntegrationTest,
+        execute_RefreshesCacheInBackground_WhenRangeIsServedFromCacheWithinStaleWhileRevalidate)
+{
+    // Given: a stale response within stale-while-revalidate is in cache.
+    HttpTestServer testServer;
+    StaleWhileRevalidateRequestHandler handler;
+    testServer.getTestRequestHandlerFactory().addHandler(HttpTestConstants::DefaultPath, &handler);
+    testServer.start(HttpTestConstants::DefaultPort);
+
+    std::string cachePath = HttpTestUtil::getDefaultCachePath();
+    HttpCache::Ptr pCache = HttpCache::createCache(Poco::Path(cachePath), HttpTestConstants::DefaultCacheMaxSize);
+
+    EasyHttp::Builder httpClientBuilder;
+    EasyHttp::Ptr pHttpClient = httpClientBuilder.setCache(pCache).build();
+    std::string url = HttpTestConstants::DefaultTestUrlWithQuery;
+    Request::Builder requestBuilder1;
+    Request::Ptr pRequest1 = requestBuilder1.setUrl(url).build();
+    Response::Ptr pResponse1 = pHttpClient->newCall(pRequest1)->execute();
+    ASSERT_EQ(Poco::Net::HTTPResponse::HTTP_OK, pResponse1->getCode());
+    ASSERT_EQ(HttpTestConstants::DefaultResponseBody, pResponse1->getBody()->toString());
+
+    // When: execute a range request of the same url.
+    Request::Builder requestBuilder2;
+    Request::Ptr pRequest2 = requestBuilder2.setUrl(url).setHeader(HttpConstants::HeaderNames::Range, "bytes=0-3")
+            .build();
+    Response::Ptr pResponse2 = pHttpClient->newCall(pRequest2)->execute();
+
+    // Then: the range is sliced from the stale response, and the cache is refreshed in background.
+    ASSERT_EQ(Poco::Net::HTTPResponse::HTTP_PARTIAL_CONTENT, pResponse2->getCode());
+    EXPECT_TRUE(pResponse2->getNetworkResponse().isNull());
+    EXPECT_EQ(std::string(HttpTestConstants::DefaultResponseBody).substr(0, 4), pResponse2->getBody()->toString());
+    EXPECT_TRUE(waitForCachedCacheControl(cachePath, url, HttpTestConstants::MaxAgeOneHour));
+    EXPECT_EQ(2, handler.getRequestCount());
+}
+
 } /* namespace test */
 } /* namespace easyhttpcpp */
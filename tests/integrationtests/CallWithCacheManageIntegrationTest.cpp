@@ -635,6 +635,8 @@ TEST_F(CallWithCacheManageIntegrationTest, execute_ReturnsRespnseAndCreateCache_
     std::string responseBody3 = pResponse3->getBody()->toString();
 
     Poco::Timestamp endTime3;
+    // last accessed time is written to database in batch.
+    pCache->flush();
 
     // not replace cache.
     HttpCacheDatabase::HttpCacheMetadataAll::Ptr pMetadata3;
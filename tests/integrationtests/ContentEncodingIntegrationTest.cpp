@@ -0,0 +1,521 @@
+/*
+ * Copyright 2019 Sony Corporation
+ */
+
+#include <ctime>
+#include <iterator>
+#include <sstream>
+#include <string>
+
+#include "gtest/gtest.h"
+
+#include "Poco/AtomicCounter.h"
+#include "Poco/DeflatingStream.h"
+#include "Poco/File.h"
+#include "Poco/InflatingStream.h"
+#include "Poco/Mutex.h"
+#include "Poco/NumberFormatter.h"
+#include "Poco/Path.h"
+#include "Poco/Timestamp.h"
+#include "Poco/Net/HTTPRequestHandler.h"
+#include "Poco/Net/HTTPServerRequest.h"
+#include "Poco/Net/HTTPServerResponse.h"
+
+#include "easyhttpcpp/common/FileUtil.h"
+#include "easyhttpcpp/EasyHttp.h"
+#include "easyhttpcpp/HttpCache.h"
+#include "easyhttpcpp/Request.h"
+#include "easyhttpcpp/RequestBody.h"
+#include "easyhttpcpp/Response.h"
+#include "easyhttpcpp/ResponseBody.h"
+#include "HttpTestServer.h"
+#include "TestLogger.h"
+
+#include "HttpIntegrationTestCase.h"
+#include "HttpTestConstants.h"
+#include "HttpTestUtil.h"
+
+using easyhttpcpp::common::FileUtil;
+using easyhttpcpp::testutil::HttpTestServer;
+
+namespace easyhttpcpp {
+namespace test {
+
+static const std::string Tag = "ContentEncodingIntegrationTest";
+
+static const char* const HeaderAcceptEncoding = "Accept-Encoding";
+static const char* const HeaderCacheControl = "Cache-Control";
+static const char* const HeaderContentEncoding = "Content-Encoding";
+static const char* const HeaderValueGzip = "gzip";
+static const char* const HeaderValueIdentity = "identity";
+static const char* const HeaderValueMaxAgeOneHour = "max-age=3600";
+static const size_t CachedResourceBytes = 900;
+static const size_t BenchmarkResourceBytes = 4 * 1024 * 1024;
+static const size_t ReadBufferBytes = 8192;
+
+class ContentEncodingIntegrationTest : public HttpIntegrationTestCase {
+protected:
+
+    void SetUp()
+    {
+        Poco::Path path(HttpTestUtil::getDefaultCachePath());
+        FileUtil::removeDirsIfPresent(path);
+
+        EASYHTTPCPP_TESTLOG_SETUP_END();
+    }
+};
+
+namespace {
+
+// looks like a JSON API response, which compresses well.
+std::string createResource(size_t bytes)
+{
+    std::string resource;
+    resource.reserve(bytes + 64);
+    for (size_t i = 0; resource.size() < bytes; i++) {
+        resource += "{\"id\":" + Poco::NumberFormatter::format(i) + ",\"name\":\"item\",\"enabled\":true},";
+    }
+    resource.resize(bytes);
+    return resource;
+}
+
+std::string compress(const std::string& data)
+{
+    std::stringstream compressed;
+    Poco::DeflatingOutputStream deflater(compressed, Poco::DeflatingStreamBuf::STREAM_GZIP);
+    deflater << data;
+    deflater.close();
+    return compressed.str();
+}
+
+// responds with gzip when the request accepts it.
+class GzipRequestHandler : public Poco::Net::HTTPRequestHandler {
+public:
+
+    GzipRequestHandler(size_t resourceBytes) : m_resource(createResource(resourceBytes)),
+            m_compressedResource(compress(m_resource)), m_chunked(false)
+    {
+    }
+
+    virtual void handleRequest(Poco::Net::HTTPServerRequest& request, Poco::Net::HTTPServerResponse& response)
+    {
+        m_requestCount++;
+        {
+            Poco::FastMutex::ScopedLock lock(m_mutex);
+            m_acceptEncoding = request.get(HeaderAcceptEncoding, "");
+        }
+        bool gzip = request.get(HeaderAcceptEncoding, "").find(HeaderValueGzip) != std::string::npos;
+        const std::string& body = gzip ? m_compressedResource : m_resource;
+
+        response.setStatus(Poco::Net::HTTPResponse::HTTP_OK);
+        response.setContentType(HttpTestConstants::DefaultResponseContentType);
+        response.set(HeaderCacheControl, HeaderValueMaxAgeOneHour);
+        if (gzip) {
+            response.set(HeaderContentEncoding, HeaderValueGzip);
+        }
+        if (m_chunked) {
+            response.setChunkedTransferEncoding(true);
+        } else {
+            response.setContentLength(body.size());
+        }
+        std::ostream& ostr = response.send();
+        ostr << body;
+    }
+
+    const std::string& getResource() const
+    {
+        return m_resource;
+    }
+
+    const std::string& getCompressedResource() const
+    {
+        return m_compressedResource;
+    }
+
+    std::string getAcceptEncoding()
+    {
+        Poco::FastMutex::ScopedLock lock(m_mutex);
+        return m_acceptEncoding;
+    }
+
+    int getRequestCount() const
+    {
+        return m_requestCount.value();
+    }
+
+    void setChunked(bool chunked)
+    {
+        m_chunked = chunked;
+    }
+
+private:
+    std::string m_resource;
+    std::string m_compressedResource;
+    bool m_chunked;
+    std::string m_acceptEncoding;
+    Poco::FastMutex m_mutex;
+    Poco::AtomicCounter m_requestCount;
+};
+
+// inflates gzip request body.
+class GzipRequestBodyHandler : public Poco::Net::HTTPRequestHandler {
+public:
+
+    GzipRequestBodyHandler() : m_chunked(false)
+    {
+    }
+
+    virtual void handleRequest(Poco::Net::HTTPServerRequest& request, Poco::Net::HTTPServerResponse& response)
+    {
+        m_contentEncoding = request.get(HeaderContentEncoding, "");
+        m_chunked = request.getChunkedTransferEncoding();
+        std::istream& istr = request.stream();
+        if (m_contentEncoding == HeaderValueGzip) {
+            Poco::InflatingInputStream inflatingStream(istr, Poco::InflatingStreamBuf::STREAM_GZIP);
+            m_requestBody.assign(std::istreambuf_iterator<char>(inflatingStream), std::istreambuf_iterator<char>());
+        } else {
+            m_requestBody.assign(std::istreambuf_iterator<char>(istr), std::istreambuf_iterator<char>());
+        }
+
+        response.setStatus(Poco::Net::HTTPResponse::HTTP_OK);
+        response.setContentLength(0);
+        response.send();
+    }
+
+    const std::string& getContentEncoding() const
+    {
+        return m_contentEncoding;
+    }
+
+    bool isChunked() const
+    {
+        return m_chunked;
+    }
+
+    const std::string& getRequestBody() const
+    {
+        return m_requestBody;
+    }
+
+private:
+    std::string m_contentEncoding;
+    bool m_chunked;
+    std::string m_requestBody;
+};
+
+} /* namespace */
+
+TEST_F(ContentEncodingIntegrationTest, execute_DoesNotSendAcceptEncoding_WhenContentEncodingPolicyIsIdentity)
+{
+    // Given: default ContentEncodingPolicy
+    HttpTestServer testServer;
+    GzipRequestHandler handler(CachedResourceBytes);
+    testServer.getTestRequestHandlerFactory().addHandler(HttpTestConstants::DefaultPath, &handler);
+    testServer.start(HttpTestConstants::DefaultPort);
+
+    EasyHttp::Builder httpClientBuilder;
+    EasyHttp::Ptr pHttpClient = httpClientBuilder.build();
+    Request::Builder requestBuilder;
+    Request::Ptr pRequest = requestBuilder.setUrl(HttpTestConstants::DefaultTestUrlWithQuery).build();
+
+    // When: execute GET method
+    Response::Ptr pResponse = pHttpClient->newCall(pRequest)->execute();
+
+    // Then: body is not compressed
+    EXPECT_EQ(Poco::Net::HTTPResponse::HTTP_OK, pResponse->getCode());
+    EXPECT_EQ("", handler.getAcceptEncoding());
+    EXPECT_EQ(handler.getResource(), pResponse->getBody()->toString());
+}
+
+TEST_F(ContentEncodingIntegrationTest,
+        execute_ReturnsDecompressedBodyAndCachesIt_WhenContentEncodingPolicyIsCacheDecompressed)
+{
+    // Given: ContentEncodingPolicyCacheDecompressed
+    HttpTestServer testServer;
+    GzipRequestHandler handler(CachedResourceBytes);
+    testServer.getTestRequestHandlerFactory().addHandler(HttpTestConstants::DefaultPath, &handler);
+    testServer.start(HttpTestConstants::DefaultPort);
+
+    std::string cachePath = HttpTestUtil::getDefaultCachePath();
+    HttpCache::Ptr pCache = HttpCache::createCache(Poco::Path(cachePath), HttpTestConstants::DefaultCacheMaxSize);
+    EasyHttp::Builder httpClientBuilder;
+    EasyHttp::Ptr pHttpClient = httpClientBuilder.setCache(pCache)
+            .setContentEncodingPolicy(ContentEncodingPolicyCacheDecompressed).build();
+    std::string url = HttpTestConstants::DefaultTestUrlWithQuery;
+    Request::Builder requestBuilder;
+    Request::Ptr pRequest = requestBuilder.setUrl(url).build();
+
+    // When: execute GET method
+    Response::Ptr pResponse = pHttpClient->newCall(pRequest)->execute();
+
+    // Then: gzip is accepted and user gets decompressed body, which is cached as is
+    EXPECT_EQ(Poco::Net::HTTPResponse::HTTP_OK, pResponse->getCode());
+    EXPECT_EQ("gzip, deflate", handler.getAcceptEncoding());
+    EXPECT_FALSE(pResponse->hasHeader(HeaderContentEncoding));
+    EXPECT_FALSE(pResponse->getBody()->hasContentLength());
+    EXPECT_EQ(handler.getResource(), pResponse->getBody()->toString());
+
+    Poco::File cachedBodyFile(HttpTestUtil::createCachedResponsedBodyFilePath(cachePath, Request::HttpMethodGet,
+            url));
+    ASSERT_TRUE(cachedBodyFile.exists());
+    EXPECT_EQ(handler.getResource().size(), cachedBodyFile.getSize());
+
+    // cached response is used as is
+    Request::Builder requestBuilder2;
+    Request::Ptr pRequest2 = requestBuilder2.setUrl(url).build();
+    Response::Ptr pResponse2 = pHttpClient->newCall(pRequest2)->execute();
+    EXPECT_FALSE(pResponse2->getCacheResponse().isNull());
+    EXPECT_EQ(handler.getResource(), pResponse2->getBody()->toString());
+    EXPECT_EQ(1, handler.getRequestCount());
+}
+
+TEST_F(ContentEncodingIntegrationTest,
+        execute_ReturnsDecompressedBodyAndCachesCompressedBody_WhenContentEncodingPolicyIsCacheCompressed)
+{
+    // Given: ContentEncodingPolicyCacheCompressed
+    HttpTestServer testServer;
+    GzipRequestHandler handler(CachedResourceBytes);
+    testServer.getTestRequestHandlerFactory().addHandler(HttpTestConstants::DefaultPath, &handler);
+    testServer.start(HttpTestConstants::DefaultPort);
+
+    std::string cachePath = HttpTestUtil::getDefaultCachePath();
+    HttpCache::Ptr pCache = HttpCache::createCache(Poco::Path(cachePath), HttpTestConstants::DefaultCacheMaxSize);
+    EasyHttp::Builder httpClientBuilder;
+    EasyHttp::Ptr pHttpClient = httpClientBuilder.setCache(pCache)
+            .setContentEncodingPolicy(ContentEncodingPolicyCacheCompressed).build();
+    std::string url = HttpTestConstants::DefaultTestUrlWithQuery;
+    Request::Builder requestBuilder;
+    Request::Ptr pRequest = requestBuilder.setUrl(url).build();
+
+    // When: execute GET method
+    Response::Ptr pResponse = pHttpClient->newCall(pRequest)->execute();
+
+    // Then: user gets decompressed body and compressed body is cached
+    EXPECT_EQ(Poco::Net::HTTPResponse::HTTP_OK, pResponse->getCode());
+    EXPECT_FALSE(pResponse->hasHeader(HeaderContentEncoding));
+    EXPECT_EQ(handler.getResource(), pResponse->getBody()->toString());
+
+    Poco::File cachedBodyFile(HttpTestUtil::createCachedResponsedBodyFilePath(cachePath, Request::HttpMethodGet,
+            url));
+    ASSERT_TRUE(cachedBodyFile.exists());
+    EXPECT_EQ(handler.getCompressedResource().size(), cachedBodyFile.getSize());
+
+    // cached response is decompressed on read
+    Request::Builder requestBuilder2;
+    Request::Ptr pRequest2 = requestBuilder2.setUrl(url).build();
+    Response::Ptr pResponse2 = pHttpClient->newCall(pRequest2)->execute();
+    EXPECT_FALSE(pResponse2->getCacheResponse().isNull());
+    EXPECT_FALSE(pResponse2->hasHeader(HeaderContentEncoding));
+    EXPECT_EQ(handler.getResource(), pResponse2->getBody()->toString());
+    EXPECT_EQ(1, handler.getRequestCount());
+}
+
+TEST_F(ContentEncodingIntegrationTest, execute_ReturnsCompressedBody_WhenRequestHasAcceptEncoding)
+{
+    // Given: user sets Accept-Encoding
+    HttpTestServer testServer;
+    GzipRequestHandler handler(CachedResourceBytes);
+    testServer.getTestRequestHandlerFactory().addHandler(HttpTestConstants::DefaultPath, &handler);
+    testServer.start(HttpTestConstants::DefaultPort);
+
+    EasyHttp::Builder httpClientBuilder;
+    EasyHttp::Ptr pHttpClient = httpClientBuilder.setContentEncodingPolicy(ContentEncodingPolicyCacheDecompressed)
+            .build();
+    Request::Builder requestBuilder;
+    Request::Ptr pRequest = requestBuilder.setUrl(HttpTestConstants::DefaultTestUrlWithQuery)
+            .setHeader(HeaderAcceptEncoding, HeaderValueGzip).build();
+
+    // When: execute GET method
+    Response::Ptr pResponse = pHttpClient->newCall(pRequest)->execute();
+
+    // Then: body is given as received
+    EXPECT_EQ(HeaderValueGzip, pResponse->getHeaderValue(HeaderContentEncoding, ""));
+    EXPECT_EQ(handler.getCompressedResource(), pResponse->getBody()->toString());
+}
+
+TEST_F(ContentEncodingIntegrationTest, execute_UsesCacheOfEachAcceptEncoding_WhenRequestsHaveDifferentAcceptEncoding)
+{
+    // Given: a compressed body is cached by a request without Accept-Encoding
+    HttpTestServer testServer;
+    GzipRequestHandler handler(CachedResourceBytes);
+    testServer.getTestRequestHandlerFactory().addHandler(HttpTestConstants::DefaultPath, &handler);
+    testServer.start(HttpTestConstants::DefaultPort);
+
+    std::string cachePath = HttpTestUtil::getDefaultCachePath();
+    HttpCache::Ptr pCache = HttpCache::createCache(Poco::Path(cachePath), HttpTestConstants::DefaultCacheMaxSize);
+    EasyHttp::Builder httpClientBuilder;
+    EasyHttp::Ptr pHttpClient = httpClientBuilder.setCache(pCache)
+            .setContentEncodingPolicy(ContentEncodingPolicyCacheCompressed).build();
+    std::string url = HttpTestConstants::DefaultTestUrlWithQuery;
+    Request::Builder requestBuilder1;
+    Request::Ptr pRequest1 = requestBuilder1.setUrl(url).build();
+    Response::Ptr pResponse1 = pHttpClient->newCall(pRequest1)->execute();
+    ASSERT_EQ(handler.getResource(), pResponse1->getBody()->toString());
+
+    // When: execute GET method with Accept-Encoding: identity
+    Request::Builder requestBuilder2;
+    Request::Ptr pRequest2 = requestBuilder2.setUrl(url).setHeader(HeaderAcceptEncoding, HeaderValueIdentity)
+            .build();
+    Response::Ptr pResponse2 = pHttpClient->newCall(pRequest2)->execute();
+
+    // Then: the compressed body is not used; the identity body is got from network and cached on its own
+    EXPECT_TRUE(pResponse2->getCacheResponse().isNull());
+    EXPECT_FALSE(pResponse2->hasHeader(HeaderContentEncoding));
+    EXPECT_EQ(handler.getResource(), pResponse2->getBody()->toString());
+    EXPECT_EQ(2, handler.getRequestCount());
+
+    // both requests are answered from their own cache
+    Request::Builder requestBuilder3;
+    Request::Ptr pRequest3 = requestBuilder3.setUrl(url).setHeader(HeaderAcceptEncoding, HeaderValueIdentity)
+            .build();
+    Response::Ptr pResponse3 = pHttpClient->newCall(pRequest3)->execute();
+    EXPECT_FALSE(pResponse3->getCacheResponse().isNull());
+    EXPECT_FALSE(pResponse3->hasHeader(HeaderContentEncoding));
+    EXPECT_EQ(handler.getResource(), pResponse3->getBody()->toString());
+
+    Request::Builder requestBuilder4;
+    Request::Ptr pRequest4 = requestBuilder4.setUrl(url).build();
+    Response::Ptr pResponse4 = pHttpClient->newCall(pRequest4)->execute();
+    EXPECT_FALSE(pResponse4->getCacheResponse().isNull());
+    EXPECT_FALSE(pResponse4->hasHeader(HeaderContentEncoding));
+    EXPECT_EQ(handler.getResource(), pResponse4->getBody()->toString());
+    EXPECT_EQ(2, handler.getRequestCount());
+}
+
+TEST_F(ContentEncodingIntegrationTest, execute_ReturnsDecompressedCachedBody_WhenContentEncodingPolicyIsIdentity)
+{
+    // Given: a compressed body is cached by a client of ContentEncodingPolicyCacheCompressed
+    HttpTestServer testServer;
+    GzipRequestHandler handler(CachedResourceBytes);
+    testServer.getTestRequestHandlerFactory().addHandler(HttpTestConstants::DefaultPath, &handler);
+    testServer.start(HttpTestConstants::DefaultPort);
+
+    std::string cachePath = HttpTestUtil::getDefaultCachePath();
+    HttpCache::Ptr pCache = HttpCache::createCache(Poco::Path(cachePath), HttpTestConstants::DefaultCacheMaxSize);
+    EasyHttp::Builder compressingClientBuilder;
+    EasyHttp::Ptr pCompressingClient = compressingClientBuilder.setCache(pCache)
+            .setContentEncodingPolicy(ContentEncodingPolicyCacheCompressed).build();
+    std::string url = HttpTestConstants::DefaultTestUrlWithQuery;
+    Request::Builder requestBuilder1;
+    Request::Ptr pRequest1 = requestBuilder1.setUrl(url).build();
+    Response::Ptr pResponse1 = pCompressingClient->newCall(pRequest1)->execute();
+    ASSERT_EQ(handler.getResource(), pResponse1->getBody()->toString());
+
+    // When: execute GET method by a client of ContentEncodingPolicyIdentity sharing the cache
+    EasyHttp::Builder httpClientBuilder;
+    EasyHttp::Ptr pHttpClient = httpClientBuilder.setCache(pCache).build();
+    Request::Builder requestBuilder2;
+    Request::Ptr pRequest2 = requestBuilder2.setUrl(url).build();
+    Response::Ptr pResponse2 = pHttpClient->newCall(pRequest2)->execute();
+
+    // Then: the cached body is decompressed, since the request did not accept gzip
+    EXPECT_FALSE(pResponse2->getCacheResponse().isNull());
+    EXPECT_FALSE(pResponse2->hasHeader(HeaderContentEncoding));
+    EXPECT_EQ(handler.getResource(), pResponse2->getBody()->toString());
+    EXPECT_EQ(1, handler.getRequestCount());
+}
+
+TEST_F(ContentEncodingIntegrationTest, execute_ReusesConnection_WhenCompressedBodyIsChunked)
+{
+    // Given: chunked gzip response
+    HttpTestServer testServer;
+    GzipRequestHandler handler(CachedResourceBytes);
+    handler.setChunked(true);
+    testServer.getTestRequestHandlerFactory().addHandler(HttpTestConstants::DefaultPath, &handler);
+    testServer.start(HttpTestConstants::DefaultPort);
+
+    EasyHttp::Builder httpClientBuilder;
+    EasyHttp::Ptr pHttpClient = httpClientBuilder.setContentEncodingPolicy(ContentEncodingPolicyCacheDecompressed)
+            .build();
+
+    // When: execute GET method twice
+    Request::Builder requestBuilder1;
+    Request::Ptr pRequest1 = requestBuilder1.setUrl(HttpTestConstants::DefaultTestUrlWithQuery).build();
+    Response::Ptr pResponse1 = pHttpClient->newCall(pRequest1)->execute();
+    std::string responseBody1 = pResponse1->getBody()->toString();
+    Request::Builder requestBuilder2;
+    Request::Ptr pRequest2 = requestBuilder2.setUrl(HttpTestConstants::DefaultTestUrlWithQuery).build();
+    Response::Ptr pResponse2 = pHttpClient->newCall(pRequest2)->execute();
+    std::string responseBody2 = pResponse2->getBody()->toString();
+
+    // Then: both bodies are decompressed
+    EXPECT_EQ(handler.getResource(), responseBody1);
+    EXPECT_EQ(handler.getResource(), responseBody2);
+    EXPECT_EQ(2, handler.getRequestCount());
+}
+
+TEST_F(ContentEncodingIntegrationTest, execute_SendsCompressedRequestBody_WhenRequestBodyIsGzip)
+{
+    // Given: gzip RequestBody
+    HttpTestServer testServer;
+    GzipRequestBodyHandler handler;
+    testServer.getTestRequestHandlerFactory().addHandler(HttpTestConstants::DefaultPath, &handler);
+    testServer.start(HttpTestConstants::DefaultPort);
+
+    std::string content = createResource(BenchmarkResourceBytes);
+    RequestBody::Ptr pRequestBody = RequestBody::createGzip(RequestBody::create(
+            new MediaType(HttpTestConstants::DefaultRequestContentType), Poco::SharedPtr<std::string>(
+            new std::string(content))));
+    EasyHttp::Builder httpClientBuilder;
+    EasyHttp::Ptr pHttpClient = httpClientBuilder.build();
+    Request::Builder requestBuilder;
+    Request::Ptr pRequest = requestBuilder.setUrl(HttpTestConstants::DefaultTestUrlWithQuery).httpPost(pRequestBody)
+            .build();
+
+    // When: execute POST method
+    Response::Ptr pResponse = pHttpClient->newCall(pRequest)->execute();
+
+    // Then: server receives chunked gzip body
+    EXPECT_EQ(Poco::Net::HTTPResponse::HTTP_OK, pResponse->getCode());
+    EXPECT_EQ(HeaderValueGzip, handler.getContentEncoding());
+    EXPECT_TRUE(handler.isChunked());
+    EXPECT_EQ(content, handler.getRequestBody());
+}
+
+// benchmark: bytes on the wire and client CPU time per MB of response body.
+TEST_F(ContentEncodingIntegrationTest, execute_ReportsBytesOnWireAndCpuTimePerMegabyte)
+{
+    HttpTestServer testServer;
+    GzipRequestHandler handler(BenchmarkResourceBytes);
+    testServer.getTestRequestHandlerFactory().addHandler(HttpTestConstants::DefaultPath, &handler);
+    testServer.start(HttpTestConstants::DefaultPort);
+
+    ContentEncodingPolicy policies[] = {ContentEncodingPolicyIdentity, ContentEncodingPolicyCacheDecompressed};
+    for (size_t i = 0; i < sizeof(policies) / sizeof(policies[0]); i++) {
+        EasyHttp::Builder httpClientBuilder;
+        EasyHttp::Ptr pHttpClient = httpClientBuilder.setContentEncodingPolicy(policies[i]).build();
+        Request::Builder requestBuilder;
+        Request::Ptr pRequest = requestBuilder.setUrl(HttpTestConstants::DefaultTestUrlWithQuery).build();
+
+        Poco::Timestamp startTime;
+        std::clock_t startClock = std::clock();
+        Response::Ptr pResponse = pHttpClient->newCall(pRequest)->execute();
+        ResponseBodyStream::Ptr pResponseBodyStream = pResponse->getBody()->getByteStream();
+        char buffer[ReadBufferBytes];
+        size_t readBytes = 0;
+        while (!pResponseBodyStream->isEof()) {
+            ssize_t retBytes = pResponseBodyStream->read(buffer, ReadBufferBytes);
+            if (retBytes > 0) {
+                readBytes += retBytes;
+            }
+        }
+        pResponseBodyStream->close();
+        double cpuMilliSec = 1000.0 * (std::clock() - startClock) / CLOCKS_PER_SEC;
+        double elapsedMilliSec = startTime.elapsed() / 1000.0;
+
+        bool compressed = policies[i] != ContentEncodingPolicyIdentity;
+        size_t wireBytes = compressed ? handler.getCompressedResource().size() : handler.getResource().size();
+        double megaBytes = static_cast<double>(readBytes) / (1024 * 1024);
+        EASYHTTPCPP_TESTLOG_I(Tag, "%s: body=%zu bytes wire=%zu bytes (%.1f%%) cpu=%.2f ms/MB elapsed=%.2f ms/MB",
+                compressed ? "gzip" : "identity", readBytes, wireBytes, 100.0 * wireBytes / readBytes,
+                cpuMilliSec / megaBytes, elapsedMilliSec / megaBytes);
+
+        ASSERT_EQ(BenchmarkResourceBytes, readBytes);
+        if (compressed) {
+            EXPECT_LT(wireBytes, readBytes);
+        }
+    }
+}
+
+} /* namespace test */
+} /* namespace easyhttpcpp */
@@ -100,7 +100,7 @@ TEST_F(HttpCacheDatabaseCorruptionIntegrationTest,
 }
 
 TEST_F(HttpCacheDatabaseCorruptionIntegrationTest,
-        getMetadata_ThrowsSqlDatabaseCorruptException_WhenThrowSqlDatabaseCorruptExceptionInQuery)
+        getMetadata_ThrowsSqlDatabaseCorruptException_WhenThrowSqlDatabaseCorruptExceptionInQueryStatement)
 {
     // Given: prepare cache database
     std::string url = Test1Url;
@@ -126,9 +126,8 @@ TEST_F(HttpCacheDatabaseCorruptionIntegrationTest,
             new testing::NiceMock<ForwardingMockSqliteDatabase>(databasePath.toString(), pDb);
     pCacheDatabaseOpenHelper->overrideInternalDatabase(pMockDatabase);
 
-    // throw SqlDatabaseCorruptException from query
-    EXPECT_CALL(*pMockDatabase, query(testing::_, testing::_, testing::_, testing::_, testing::_, testing::_,
-            testing::_, testing::_, testing::_))
+    // throw SqlDatabaseCorruptException from queryStatement
+    EXPECT_CALL(*pMockDatabase, queryStatement(testing::_))
             .WillOnce(testing::Throw(SqlDatabaseCorruptException("exception from mock")));
 
     // When: getMetadata
@@ -137,7 +136,7 @@ TEST_F(HttpCacheDatabaseCorruptionIntegrationTest,
 }
 
 TEST_F(HttpCacheDatabaseCorruptionIntegrationTest,
-        updateLastAccessedSec_ThrowsSqlDatabaseCorruptException_WhenThrowSqlDatabaseCorruptExceptionInUpdate)
+        updateLastAccessedSec_ThrowsSqlDatabaseCorruptException_WhenThrowSqlDatabaseCorruptExceptionInExecuteUpdateDelete)
 {
     // Given: prepare cache database
     std::string url = Test1Url;
@@ -163,8 +162,8 @@ TEST_F(HttpCacheDatabaseCorruptionIntegrationTest,
             new testing::NiceMock<ForwardingMockSqliteDatabase>(databasePath.toString(), pDb);
     pCacheDatabaseOpenHelper->overrideInternalDatabase(pMockDatabase);
 
-    // throw SqlDatabaseCorruptException from update of HttpCacheDatabase::updateLastAccessedSec
-    EXPECT_CALL(*pMockDatabase, update(testing::_, testing::_, testing::_, testing::_))
+    // throw SqlDatabaseCorruptException from executeUpdateDelete of HttpCacheDatabase::updateLastAccessedSec
+    EXPECT_CALL(*pMockDatabase, executeUpdateDelete(testing::_))
             .WillOnce(testing::Throw(SqlDatabaseCorruptException("exception from mock")));
 
     // When: updateLastAccessedSec
@@ -173,7 +172,7 @@ TEST_F(HttpCacheDatabaseCorruptionIntegrationTest,
 }
 
 TEST_F(HttpCacheDatabaseCorruptionIntegrationTest,
-        updateMetadata_ThrowsSqlDatabaseCorruptException_WhenThrowSqlDatabaseCorruptExceptionInReplace)
+        updateMetadata_ThrowsSqlDatabaseCorruptException_WhenThrowSqlDatabaseCorruptExceptionInExecuteUpdateDelete)
 {
     // Given: prepare cache database
     std::string url = Test1Url;
@@ -199,8 +198,8 @@ TEST_F(HttpCacheDatabaseCorruptionIntegrationTest,
             new testing::NiceMock<ForwardingMockSqliteDatabase>(databasePath.toString(), pDb);
     pCacheDatabaseOpenHelper->overrideInternalDatabase(pMockDatabase);
 
-    // throw SqlDatabaseCorruptException from replace
-    EXPECT_CALL(*pMockDatabase, replace(testing::_, testing::_))
+    // throw SqlDatabaseCorruptException from executeUpdateDelete
+    EXPECT_CALL(*pMockDatabase, executeUpdateDelete(testing::_))
             .WillOnce(testing::Throw(SqlDatabaseCorruptException("exception from mock")));
 
     // When: updateMetadata
@@ -209,7 +208,7 @@ TEST_F(HttpCacheDatabaseCorruptionIntegrationTest,
 }
 
 TEST_F(HttpCacheDatabaseCorruptionIntegrationTest,
-        deleteMetadata_ThrowsSqlDatabaseCorruptException_WhenThrowSqlDatabaseCorruptExceptionInDeleteRows)
+        deleteMetadata_ThrowsSqlDatabaseCorruptException_WhenThrowSqlDatabaseCorruptExceptionInExecuteUpdateDelete)
 {
     // Given: prepare cache database
     std::string url = Test1Url;
@@ -235,8 +234,8 @@ TEST_F(HttpCacheDatabaseCorruptionIntegrationTest,
             new testing::NiceMock<ForwardingMockSqliteDatabase>(databasePath.toString(), pDb);
     pCacheDatabaseOpenHelper->overrideInternalDatabase(pMockDatabase);
 
-    // throw SqlDatabaseCorruptException from deleteRows
-    EXPECT_CALL(*pMockDatabase, deleteRows(testing::_, testing::_, testing::_))
+    // throw SqlDatabaseCorruptException from executeUpdateDelete
+    EXPECT_CALL(*pMockDatabase, executeUpdateDelete(testing::_))
             .WillOnce(testing::Throw(SqlDatabaseCorruptException("exception from mock")));
 
     // When: deleteMetadata
@@ -7,15 +7,19 @@
 
 #include "Poco/File.h"
 #include "Poco/Path.h"
+#include "Poco/SharedPtr.h"
 #include "Poco/Timestamp.h"
 #include "Poco/Net/HTTPResponse.h"
 
+#include "easyhttpcpp/common/ByteArrayBuffer.h"
 #include "easyhttpcpp/common/CacheMetadata.h"
 #include "easyhttpcpp/common/CoreLogger.h"
 #include "easyhttpcpp/common/FileUtil.h"
 #include "easyhttpcpp/common/StringUtil.h"
 #include "easyhttpcpp/db/SqlException.h"
+#include "easyhttpcpp/db/SqliteDatabase.h"
 #include "easyhttpcpp/Headers.h"
+#include "easyhttpcpp/HttpCacheKeyHasher.h"
 #include "HeadersEqualMatcher.h"
 #include "EasyHttpCppAssertions.h"
 #include "TestDefs.h"
@@ -24,6 +28,7 @@
 #include "TimeInRangeMatcher.h"
 
 #include "HttpIntegrationTestCase.h"
+#include "HttpCacheFreshness.h"
 #include "HttpCacheMetadata.h"
 #include "HttpCacheDatabase.h"
 #include "HttpCacheEnumerationListener.h"
@@ -32,11 +37,13 @@
 #include "MockHttpCacheEnumerationListener.h"
 #include "SynchronizedExecutionRunner.h"
 
+using easyhttpcpp::common::ByteArrayBuffer;
 using easyhttpcpp::common::CacheMetadata;
 using easyhttpcpp::common::FileUtil;
 using easyhttpcpp::common::StringUtil;
 using easyhttpcpp::db::SqlExecutionException;
 using easyhttpcpp::db::SqlIllegalStateException;
+using easyhttpcpp::db::SqliteDatabase;
 using easyhttpcpp::testutil::TestFileUtil;
 
 namespace easyhttpcpp {
@@ -284,6 +291,23 @@ public:
     }
 };
 
+class HexCacheKeyHasher : public HttpCacheKeyHasher {
+public:
+    virtual const std::string& getName() const
+    {
+        static const std::string Name = "hex";
+        return Name;
+    }
+    virtual std::string hash(const std::string& data)
+    {
+        std::string key;
+        for (size_t i = 0; i < data.size(); i++) {
+            key += StringUtil::format("%02x", static_cast<unsigned char>(data[i]));
+        }
+        return key;
+    }
+};
+
 } /* namespace */
 
 class HttpCacheDatabaseIntegrationTest : public HttpIntegrationTestCase {
@@ -345,6 +369,176 @@ TEST_F(HttpCacheDatabaseIntegrationTest, getMetadata_ReturnsTrue_WhenExistKey)
     EXPECT_EQ(pMetadata->getCreatedAtEpoch(), pHttpCacheMetadata->getCreatedAtEpoch());
 }
 
+// getMetadata
+TEST_F(HttpCacheDatabaseIntegrationTest, getMetadata_ReturnsLatestMetadata_WhenCalledRepeatedlyWithUpdate)
+{
+    // Given: insert cacheMetadata in database
+    ASSERT_TRUE(createDefaultCacheRootDir()) << "cannot create cache root directory.";
+    Poco::Path databaseFile(HttpTestUtil::getDefaultCacheDatabaseFile());
+    HttpCacheDatabase::HttpCacheMetadataAll::Ptr pMetadata = new HttpCacheDatabase::HttpCacheMetadataAll();
+    createDbCacheMetadata(databaseFile, Key1, pMetadata);
+
+    HttpCacheDatabase database(new HttpCacheDatabaseOpenHelper(databaseFile));
+    ASSERT_FALSE(database.getMetadata(Key1).isNull());
+
+    // When: update metadata with a value which contains a quote and getMetadata again
+    HttpCacheMetadata::Ptr pNewMetadata = database.getMetadata(Key1);
+    pNewMetadata->setStatusMessage("It's Ok");
+    database.updateMetadata(Key1, pNewMetadata);
+    HttpCacheMetadata::Ptr pHttpCacheMetadata = database.getMetadata(Key1);
+
+    // Then: updated metadata is returned
+    ASSERT_FALSE(pHttpCacheMetadata.isNull());
+    EXPECT_EQ("It's Ok", pHttpCacheMetadata->getStatusMessage());
+    EXPECT_EQ(pMetadata->getUrl(), pHttpCacheMetadata->getUrl());
+    EXPECT_EQ(pMetadata->getResponseBodySize(), pHttpCacheMetadata->getResponseBodySize());
+    EXPECT_TRUE(database.updateLastAccessedSec(Key1));
+    EXPECT_TRUE(database.deleteMetadata(Key1));
+    EXPECT_TRUE(database.getMetadata(Key1).isNull());
+}
+
+// updateMetadata
+TEST_F(HttpCacheDatabaseIntegrationTest, updateMetadata_StoresMetadataByGivenKey_WhenKeyOfMetadataIsDifferent)
+{
+    // Given: metadata of Key1 is in database
+    ASSERT_TRUE(createDefaultCacheRootDir()) << "cannot create cache root directory.";
+    Poco::Path databaseFile(HttpTestUtil::getDefaultCacheDatabaseFile());
+    HttpCacheDatabase::HttpCacheMetadataAll::Ptr pMetadata = new HttpCacheDatabase::HttpCacheMetadataAll();
+    createDbCacheMetadata(databaseFile, Key1, pMetadata);
+
+    HttpCacheDatabase database(new HttpCacheDatabaseOpenHelper(databaseFile));
+    HttpCacheMetadata::Ptr pNewMetadata = database.getMetadata(Key1);
+    ASSERT_FALSE(pNewMetadata.isNull());
+
+    // When: updateMetadata by Key2 with the metadata of Key1
+    database.updateMetadata(Key2, pNewMetadata);
+
+    // Then: the metadata is stored by Key2, and the metadata of Key1 is left
+    HttpCacheMetadata::Ptr pHttpCacheMetadata = database.getMetadata(Key2);
+    ASSERT_FALSE(pHttpCacheMetadata.isNull());
+    EXPECT_EQ(Key2, pHttpCacheMetadata->getKey());
+    EXPECT_EQ(pMetadata->getUrl(), pHttpCacheMetadata->getUrl());
+    EXPECT_FALSE(database.getMetadata(Key1).isNull());
+}
+
+// getMetadata
+TEST_F(HttpCacheDatabaseIntegrationTest, getMetadata_Benchmark_CacheHitLatency)
+{
+    // Given: insert cacheMetadata in database
+    ASSERT_TRUE(createDefaultCacheRootDir()) << "cannot create cache root directory.";
+    Poco::Path databaseFile(HttpTestUtil::getDefaultCacheDatabaseFile());
+    HttpCacheDatabase::HttpCacheMetadataAll::Ptr pMetadata = new HttpCacheDatabase::HttpCacheMetadataAll();
+    createDbCacheMetadata(databaseFile, Key1, pMetadata);
+
+    HttpCacheDatabase database(new HttpCacheDatabaseOpenHelper(databaseFile));
+
+    // When: do the database access of a cache hit repeatedly
+    static const int Iterations = 1000;
+    Poco::Timestamp start;
+    for (int i = 0; i < Iterations; i++) {
+        ASSERT_FALSE(database.getMetadata(Key1).isNull());
+        ASSERT_TRUE(database.updateLastAccessedSec(Key1));
+    }
+    Poco::Timestamp::TimeDiff elapsed = start.elapsed();
+
+    // Then: log latency per cache hit
+    EASYHTTPCPP_TESTLOG_I(Tag, "getMetadata + updateLastAccessedSec: %.1f us/hit",
+            static_cast<double>(elapsed) / Iterations);
+}
+
+TEST_F(HttpCacheDatabaseIntegrationTest, getMetadata_ReturnsStoredFreshness_WhenUpdatedByUpdateMetadata)
+{
+    // Given: update metadata which has freshness headers
+    ASSERT_TRUE(createDefaultCacheRootDir()) << "cannot create cache root directory.";
+    Poco::Path databaseFile(HttpTestUtil::getDefaultCacheDatabaseFile());
+    HttpCacheDatabase::HttpCacheMetadataAll::Ptr pMetadata = new HttpCacheDatabase::HttpCacheMetadataAll();
+    createDbCacheMetadata(databaseFile, Key1, pMetadata);
+    Headers::Ptr pHeaders = HttpUtil::exchangeJsonStrToHeaders(Test1ResponseHeader);
+    pHeaders->set("Cache-Control", "max-age=3600, must-revalidate");
+    pHeaders->set("Date", Test1ReceivedResponseTime);
+    pHeaders->set("ETag", "\"etag-1\"");
+    pMetadata->setResponseHeaders(pHeaders);
+
+    HttpCacheDatabase database(new HttpCacheDatabaseOpenHelper(databaseFile));
+    database.updateMetadata(Key1, pMetadata);
+
+    // When: getMetadata
+    HttpCacheMetadata::Ptr pHttpCacheMetadata = database.getMetadata(Key1);
+
+    // Then: freshness is read from the database
+    ASSERT_FALSE(pHttpCacheMetadata.isNull());
+    HttpCacheFreshness::Ptr pFreshness = pHttpCacheMetadata->getFreshness();
+    EXPECT_EQ(3600, pFreshness->getMaxAgeSec());
+    EXPECT_TRUE(pFreshness->isMustRevalidate());
+    EXPECT_FALSE(pFreshness->isNoCache());
+    EXPECT_EQ(static_cast<long long>(pMetadata->getReceivedResponseAtEpoch()), pFreshness->getResponseDateAtEpoch());
+    EXPECT_EQ(-1, pFreshness->getExpiresAtEpoch());
+    EXPECT_EQ("\"etag-1\"", pFreshness->getETag());
+    EXPECT_THAT(pHttpCacheMetadata->getResponseHeaders(), testutil::equalHeaders(pHeaders));
+}
+
+TEST_F(HttpCacheDatabaseIntegrationTest, updateMetadata_CreatesDatabaseInWalJournalMode)
+{
+    // Given: create database directory
+    ASSERT_TRUE(createDefaultCacheRootDir()) << "cannot create cache root directory.";
+    Poco::Path databaseFile(HttpTestUtil::getDefaultCacheDatabaseFile());
+
+    // When: insert cacheMetadata in database
+    HttpCacheDatabase::HttpCacheMetadataAll::Ptr pMetadata = new HttpCacheDatabase::HttpCacheMetadataAll();
+    createDbCacheMetadata(databaseFile, Key1, pMetadata);
+
+    // Then: journal mode of the database file is WAL
+    SqliteDatabase::Ptr pDb = SqliteDatabase::openOrCreateDatabase(databaseFile.toString());
+    EXPECT_EQ(SqliteDatabase::JournalModeWal, pDb->getJournalMode());
+}
+
+TEST_F(HttpCacheDatabaseIntegrationTest, updateMetadata_Benchmark_WriteThroughput)
+{
+    // Given: create database
+    ASSERT_TRUE(createDefaultCacheRootDir()) << "cannot create cache root directory.";
+    Poco::Path databaseFile(HttpTestUtil::getDefaultCacheDatabaseFile());
+    HttpCacheDatabase::HttpCacheMetadataAll::Ptr pMetadata = new HttpCacheDatabase::HttpCacheMetadataAll();
+    createDbCacheMetadata(databaseFile, Key1, pMetadata);
+
+    HttpCacheDatabase database(new HttpCacheDatabaseOpenHelper(databaseFile));
+
+    // When: insert cacheMetadata repeatedly
+    static const int Iterations = 500;
+    Poco::Timestamp start;
+    for (int i = 0; i < Iterations; i++) {
+        pMetadata->setKey(StringUtil::format("Key%d", i));
+        database.updateMetadata(pMetadata->getKey(), pMetadata);
+    }
+    Poco::Timestamp::TimeDiff elapsed = start.elapsed();
+
+    // Then: log write throughput
+    EASYHTTPCPP_TESTLOG_I(Tag, "updateMetadata: %.1f writes/sec",
+            static_cast<double>(Iterations) * Poco::Timestamp::resolution() / (elapsed > 0 ? elapsed : 1));
+}
+
+TEST_F(HttpCacheDatabaseIntegrationTest, updateLastAccessedSecInBatch_UpdatesAllExistingKeys)
+{
+    // Given: insert cacheMetadata in database
+    ASSERT_TRUE(createDefaultCacheRootDir()) << "cannot create cache root directory.";
+    Poco::Path databaseFile(HttpTestUtil::getDefaultCacheDatabaseFile());
+    HttpCacheDatabase::HttpCacheMetadataAll::Ptr pMetadata = new HttpCacheDatabase::HttpCacheMetadataAll();
+    createDbCacheMetadata(databaseFile, Key1, pMetadata);
+    createDbCacheMetadata(databaseFile, Key2, pMetadata);
+
+    HttpCacheDatabase database(new HttpCacheDatabaseOpenHelper(databaseFile));
+    HttpCacheDatabase::LastAccessedSecMap lastAccessedSecs;
+    lastAccessedSecs[Key1] = 1000;
+    lastAccessedSecs[Key2] = 2000;
+    lastAccessedSecs[Key3] = 3000;
+
+    // When: updateLastAccessedSecInBatch
+    // Then: existing keys are updated
+    EXPECT_EQ(2U, database.updateLastAccessedSecInBatch(lastAccessedSecs));
+    EXPECT_EQ(1000, database.getMetadataAll(Key1)->getLastAccessedAtEpoch());
+    EXPECT_EQ(2000, database.getMetadataAll(Key2)->getLastAccessedAtEpoch());
+    EXPECT_TRUE(database.getMetadataAll(Key3).isNull());
+}
+
 // getMetadata
 TEST_F(HttpCacheDatabaseIntegrationTest, getMetadata_ThrowsSqlIllegalStateException_WhenDatabaseDirectoryIsAbsent)
 {
@@ -510,6 +704,68 @@ TEST_F(HttpCacheDatabaseIntegrationTest, updateMetadata_UpdatesMatadata_WhenExis
             endTime.epochTime()));
 }
 
+// getResponseBody
+TEST_F(HttpCacheDatabaseIntegrationTest, getResponseBody_ReturnsNull_WhenUpdatedWithoutResponseBody)
+{
+    // Given: update metadata without response body
+    ASSERT_TRUE(createDefaultCacheRootDir()) << "cannot create cache root directory.";
+    Poco::Path databaseFile(HttpTestUtil::getDefaultCacheDatabaseFile());
+    HttpCacheDatabase database(new HttpCacheDatabaseOpenHelper(databaseFile));
+
+    HttpCacheMetadata::Ptr pHttpCacheMetadata = new HttpCacheMetadata();
+    setHttpCacheMetadataForUpdate(Key1, pHttpCacheMetadata);
+    database.updateMetadata(Key1, pHttpCacheMetadata);
+
+    // When: getResponseBody
+    // Then: return NULL
+    EXPECT_TRUE(database.getResponseBody(Key1).isNull());
+}
+
+// getResponseBody
+TEST_F(HttpCacheDatabaseIntegrationTest, getResponseBody_ReturnsResponseBody_WhenUpdatedWithResponseBody)
+{
+    // Given: update metadata with response body which contains NUL
+    ASSERT_TRUE(createDefaultCacheRootDir()) << "cannot create cache root directory.";
+    Poco::Path databaseFile(HttpTestUtil::getDefaultCacheDatabaseFile());
+    HttpCacheDatabase database(new HttpCacheDatabaseOpenHelper(databaseFile));
+
+    HttpCacheMetadata::Ptr pHttpCacheMetadata = new HttpCacheMetadata();
+    setHttpCacheMetadataForUpdate(Key1, pHttpCacheMetadata);
+    std::string responseBody("abc\0def", 7);
+    database.updateMetadata(Key1, pHttpCacheMetadata, responseBody);
+
+    // When: getResponseBody
+    // Then: return the response body
+    Poco::SharedPtr<ByteArrayBuffer> pResponseBody = database.getResponseBody(Key1);
+    ASSERT_FALSE(pResponseBody.isNull());
+    EXPECT_EQ(responseBody, std::string(reinterpret_cast<const char*>(pResponseBody->getBuffer()),
+            pResponseBody->getWrittenDataSize()));
+}
+
+// updateMetadata
+TEST_F(HttpCacheDatabaseIntegrationTest, updateMetadata_KeepsResponseBody_WhenUpdatedWithoutResponseBody)
+{
+    // Given: update metadata with response body
+    ASSERT_TRUE(createDefaultCacheRootDir()) << "cannot create cache root directory.";
+    Poco::Path databaseFile(HttpTestUtil::getDefaultCacheDatabaseFile());
+    HttpCacheDatabase database(new HttpCacheDatabaseOpenHelper(databaseFile));
+
+    HttpCacheMetadata::Ptr pHttpCacheMetadata = new HttpCacheMetadata();
+    setHttpCacheMetadataForUpdate(Key1, pHttpCacheMetadata);
+    std::string responseBody = "response body";
+    database.updateMetadata(Key1, pHttpCacheMetadata, responseBody);
+
+    // When: updateMetadata without response body
+    pHttpCacheMetadata->setStatusMessage("Not Modified");
+    database.updateMetadata(Key1, pHttpCacheMetadata);
+
+    // Then: metadata is updated and response body is kept
+    EXPECT_EQ("Not Modified", database.getMetadata(Key1)->getStatusMessage());
+    Poco::SharedPtr<ByteArrayBuffer> pResponseBody = database.getResponseBody(Key1);
+    ASSERT_FALSE(pResponseBody.isNull());
+    EXPECT_EQ(responseBody, pResponseBody->toString());
+}
+
 // updateMetadata
 TEST_F(HttpCacheDatabaseIntegrationTest, updateMetadata_ThrowsSqlIllegalStateException_WhenDatabaseDirectoryIsAbsent)
 {
@@ -934,5 +1190,66 @@ TEST_F(HttpCacheDatabaseIntegrationTest,
     }
 }
 
+// key hasher
+TEST_F(HttpCacheDatabaseIntegrationTest, open_RemakesCacheKeysAndRenamesFiles_WhenKeyHasherIsChanged)
+{
+    // Given: a cache written with another key hasher
+    ASSERT_TRUE(createDefaultCacheRootDir()) << "cannot create cache root directory.";
+    Poco::Path databaseFile(HttpTestUtil::getDefaultCacheDatabaseFile());
+    Poco::Path cacheRootDir(HttpTestUtil::getDefaultCacheRootDir());
+    HttpCacheKeyHasher::Ptr pOldKeyHasher = new HexCacheKeyHasher();
+    std::string oldKey = HttpUtil::makeCacheKey(pOldKeyHasher, Request::HttpMethodGet, Test1Url);
+    {
+        HttpCacheDatabase db(new HttpCacheDatabaseOpenHelper(databaseFile, pOldKeyHasher));
+        HttpCacheMetadata::Ptr pHttpCacheMetadata = new HttpCacheMetadata();
+        setHttpCacheMetadata(oldKey, pHttpCacheMetadata);
+        db.updateMetadata(oldKey, pHttpCacheMetadata);
+    }
+    Poco::File oldFile(HttpUtil::makeCachedResponseBodyFilename(cacheRootDir, oldKey));
+    Poco::File(Poco::Path(oldFile.path()).parent()).createDirectories();
+    oldFile.createFile();
+
+    // When: open the database with the default key hasher
+    HttpCacheDatabase database(new HttpCacheDatabaseOpenHelper(databaseFile));
+    std::string newKey = HttpUtil::makeCacheKey(Request::HttpMethodGet, Test1Url);
+    HttpCacheMetadata::Ptr pHttpCacheMetadata = database.getMetadata(newKey);
+
+    // Then: the key is made with the default key hasher and the file is renamed
+    ASSERT_FALSE(pHttpCacheMetadata.isNull());
+    EXPECT_EQ(newKey, pHttpCacheMetadata->getKey());
+    EXPECT_EQ(Test1Url, pHttpCacheMetadata->getUrl());
+    EXPECT_TRUE(database.getMetadata(oldKey).isNull());
+    EXPECT_FALSE(oldFile.exists());
+    EXPECT_TRUE(Poco::File(HttpUtil::makeCachedResponseBodyFilename(cacheRootDir, newKey)).exists());
+}
+
+// data directory layout
+TEST_F(HttpCacheDatabaseIntegrationTest, open_MovesFilesToDataDirs_WhenCacheHasFlatLayout)
+{
+    // Given: a cache which has response bodies in the cache root directory
+    ASSERT_TRUE(createDefaultCacheRootDir()) << "cannot create cache root directory.";
+    Poco::Path databaseFile(HttpTestUtil::getDefaultCacheDatabaseFile());
+    Poco::Path cacheRootDir(HttpTestUtil::getDefaultCacheRootDir());
+    std::string key = HttpUtil::makeCacheKey(Request::HttpMethodGet, Test1Url);
+    {
+        HttpCacheDatabase db(new HttpCacheDatabaseOpenHelper(databaseFile, NULL, 0));
+        HttpCacheMetadata::Ptr pHttpCacheMetadata = new HttpCacheMetadata();
+        setHttpCacheMetadata(key, pHttpCacheMetadata);
+        db.updateMetadata(key, pHttpCacheMetadata);
+    }
+    Poco::File flatFile(HttpUtil::makeCachedResponseBodyFilename(cacheRootDir, key, 0));
+    flatFile.createFile();
+
+    // When: open the database with two levels of data directories
+    HttpCacheDatabase database(new HttpCacheDatabaseOpenHelper(databaseFile, NULL, 2));
+    HttpCacheMetadata::Ptr pHttpCacheMetadata = database.getMetadata(key);
+
+    // Then: the key is kept and the file is moved to the data directory
+    ASSERT_FALSE(pHttpCacheMetadata.isNull());
+    EXPECT_EQ(key, pHttpCacheMetadata->getKey());
+    EXPECT_FALSE(flatFile.exists());
+    EXPECT_TRUE(Poco::File(HttpUtil::makeCachedResponseBodyFilename(cacheRootDir, key, 2)).exists());
+}
+
 } /* namespace test */
 } /* namespace easyhttpcpp */
@@ -2,6 +2,7 @@
  * Copyright 2017 Sony Corporation
  */
 
+#include <ctime>
 #include <string>
 
 #include "gtest/gtest.h"
@@ -13,6 +14,7 @@
 #include "Poco/NumberFormatter.h"
 #include "Poco/Path.h"
 #include "Poco/String.h"
+#include "Poco/Timestamp.h"
 #include "Poco/SharedPtr.h"
 #include "Poco/URI.h"
 #include "Poco/Net/HTTPRequestHandler.h"
@@ -67,6 +69,9 @@ static const char* const TestDataForCacheFromDb = "/HttpIntegrationTest/01_cache
 static const char* const TestDataForCacheFromDb = "/HttpIntegrationTest/01_cache_from_db/HttpCache/windows/cache";
 #endif
 static const char* const TempDummyFileName = "dummy";
+static const size_t BenchmarkResponseBodyBytes = 256 * 1024;
+static const size_t BenchmarkResponseCount = 40;
+static const size_t BenchmarkCacheMaxSize = 100 * 1024 * 1024;
 
 class HttpCacheIntegrationTest : public HttpIntegrationTestCase {
 protected:
@@ -80,6 +85,34 @@ protected:
     }
 };
 
+namespace {
+
+// a JSON-like text response body, which is typical of responses worth compressing at rest.
+class JsonRequestHandler : public Poco::Net::HTTPRequestHandler {
+public:
+    JsonRequestHandler(size_t responseBodyBytes)
+    {
+        for (size_t i = 0; m_responseBody.size() < responseBodyBytes; i++) {
+            m_responseBody += StringUtil::format("{\"id\":%zu,\"name\":\"item-%zu\",\"price\":%zu,"
+                    "\"tags\":[\"tag%zu\",\"tag%zu\"]},\n", i, i, (i * 37) % 10000, i % 17, i % 29);
+        }
+        m_responseBody.resize(responseBodyBytes);
+    }
+
+    virtual void handleRequest(Poco::Net::HTTPServerRequest& request, Poco::Net::HTTPServerResponse& response)
+    {
+        response.set(HttpTestConstants::HeaderCacheControl, HttpTestConstants::MaxAgeOneHour);
+        response.setContentType("application/json");
+        response.setContentLength(m_responseBody.size());
+        response.send() << m_responseBody;
+    }
+
+private:
+    std::string m_responseBody;
+};
+
+} /* namespace */
+
 // evictAll
 // 1. CacheのresponseBodyが削除される。
 // 2. CacheのDatabase が空になる。
@@ -521,7 +554,8 @@ TEST_F(HttpCacheIntegrationTest, createInputStreamFromCache_ReturnsIstream_WhenE
     Request::Builder requestBuilder2;
     Request::Ptr pRequest2 = requestBuilder2.setUrl(url).build();
     HttpCacheInternal* pHttpCacheInternal = static_cast<HttpCacheInternal*>(pCache.get());
-    Poco::SharedPtr<std::istream> pStream = pHttpCacheInternal->createInputStreamFromCache(pRequest2);
+    unsigned int cacheIndex = 0;
+    Poco::SharedPtr<std::istream> pStream = pHttpCacheInternal->createInputStreamFromCache(pRequest2, cacheIndex);
 
     // Then: get istream
     EXPECT_FALSE(pStream.isNull());
@@ -546,7 +580,8 @@ TEST_F(HttpCacheIntegrationTest, createInputStreamFromCache_ReturnsNull_WhenNotE
     std::string url = HttpTestConstants::DefaultTestUrlWithQuery;
     Request::Ptr pRequest = requestBuilder.setUrl(url).build();
     HttpCacheInternal* pHttpCacheInternal = static_cast<HttpCacheInternal*>(pCache.get());
-    Poco::SharedPtr<std::istream> pStream = pHttpCacheInternal->createInputStreamFromCache(pRequest);
+    unsigned int cacheIndex = 0;
+    Poco::SharedPtr<std::istream> pStream = pHttpCacheInternal->createInputStreamFromCache(pRequest, cacheIndex);
 
     // Then: can not get istream
     EXPECT_TRUE(pStream.isNull());
@@ -613,5 +648,114 @@ TEST_F(HttpCacheIntegrationTest, getSize_ReturnsTotalSizeOfCachedResponseBody_Wh
     EXPECT_EQ(strlen(HttpTestConstants::DefaultResponseBody) * 2, cachedSize);
 }
 
+TEST_F(HttpCacheIntegrationTest, build_MovesCachedResponseBodies_WhenDataDirFanOutLevelsIsChanged)
+{
+    // Given: a response is cached with the default data directory fan-out levels
+    HttpTestServer testServer;
+    HttpTestCommonRequestHandler::OneHourMaxAgeRequestHandler handler;
+    testServer.getTestRequestHandlerFactory().addHandler(HttpTestConstants::DefaultPath, &handler);
+    testServer.start(HttpTestConstants::DefaultPort);
+
+    std::string cachePath = HttpTestUtil::getDefaultCachePath();
+    std::string url = HttpTestConstants::DefaultTestUrlWithQuery;
+    Poco::Path cacheRootDir(HttpTestUtil::getDefaultCacheRootDir());
+    std::string key = HttpUtil::makeCacheKey(Request::HttpMethodGet, url);
+    std::string responseBody1;
+    {
+        HttpCache::Ptr pCache1 = HttpCache::Builder(Poco::Path(cachePath), HttpTestConstants::DefaultCacheMaxSize)
+                .build();
+        EasyHttp::Builder httpClientBuilder1;
+        EasyHttp::Ptr pHttpClient1 = httpClientBuilder1.setCache(pCache1).build();
+        Request::Builder requestBuilder1;
+        Request::Ptr pRequest1 = requestBuilder1.setUrl(url).build();
+        Response::Ptr pResponse1 = pHttpClient1->newCall(pRequest1)->execute();
+        ASSERT_EQ(Poco::Net::HTTPResponse::HTTP_OK, pResponse1->getCode());
+        responseBody1 = pResponse1->getBody()->toString();
+    }
+    Poco::File oldFile(HttpUtil::makeCachedResponseBodyFilename(cacheRootDir, key, 2));
+    ASSERT_TRUE(oldFile.exists());
+
+    // When: reopen the cache with another fan-out levels and execute the same request
+    HttpCache::Ptr pCache2 = HttpCache::Builder(Poco::Path(cachePath), HttpTestConstants::DefaultCacheMaxSize)
+            .setDataDirFanOutLevels(1).build();
+    EasyHttp::Builder httpClientBuilder2;
+    EasyHttp::Ptr pHttpClient2 = httpClientBuilder2.setCache(pCache2).build();
+    Request::Builder requestBuilder2;
+    Request::Ptr pRequest2 = requestBuilder2.setUrl(url).build();
+    Response::Ptr pResponse2 = pHttpClient2->newCall(pRequest2)->execute();
+
+    // Then: the cached response body is moved to the new layout and the response is served from it
+    EXPECT_EQ(Poco::Net::HTTPResponse::HTTP_OK, pResponse2->getCode());
+    EXPECT_TRUE(pResponse2->getNetworkResponse().isNull());
+    EXPECT_FALSE(pResponse2->getCacheResponse().isNull());
+    EXPECT_EQ(responseBody1, pResponse2->getBody()->toString());
+    EXPECT_FALSE(oldFile.exists());
+    EXPECT_TRUE(Poco::File(HttpUtil::makeCachedResponseBodyFilename(cacheRootDir, key, 1)).exists());
+}
+
+// benchmark: bytes at rest and throughput of filling and hitting the cache, with and without gzip at rest.
+TEST_F(HttpCacheIntegrationTest, getSize_Benchmark_SizeAndThroughputWithGzipAtRest)
+{
+    HttpTestServer testServer;
+    JsonRequestHandler handler(BenchmarkResponseBodyBytes);
+    testServer.getTestRequestHandlerFactory().addHandler(HttpTestConstants::DefaultPath, &handler);
+    testServer.start(HttpTestConstants::DefaultPort);
+
+    HttpCache::BodyCompression compressions[] = {HttpCache::BodyCompressionNone, HttpCache::BodyCompressionGzip};
+    size_t cachedSizes[2] = {0, 0};
+    for (size_t i = 0; i < sizeof(compressions) / sizeof(compressions[0]); i++) {
+        Poco::Path cachePath(HttpTestUtil::getDefaultCachePath());
+        FileUtil::removeDirsIfPresent(cachePath);
+        HttpCache::Ptr pCache = HttpCache::Builder(cachePath, BenchmarkCacheMaxSize)
+                .setBodyCompression(compressions[i]).build();
+        EasyHttp::Builder httpClientBuilder;
+        EasyHttp::Ptr pHttpClient = httpClientBuilder.setCache(pCache).build();
+
+        // fill: each response is read from network and stored to cache.
+        Poco::Timestamp fillStartTime;
+        std::clock_t fillStartClock = std::clock();
+        for (size_t j = 0; j < BenchmarkResponseCount; j++) {
+            Request::Builder requestBuilder;
+            Request::Ptr pRequest = requestBuilder.setUrl(HttpTestUtil::makeUrl(HttpTestConstants::Http,
+                    HttpTestConstants::DefaultHost, HttpTestConstants::DefaultPort, HttpTestConstants::DefaultPath,
+                    StringUtil::format("test=%zu", j))).build();
+            Response::Ptr pResponse = pHttpClient->newCall(pRequest)->execute();
+            ASSERT_EQ(BenchmarkResponseBodyBytes, pResponse->getBody()->toString().size());
+        }
+        double fillCpuMilliSec = 1000.0 * (std::clock() - fillStartClock) / CLOCKS_PER_SEC;
+        double fillElapsedMilliSec = fillStartTime.elapsed() / 1000.0;
+        cachedSizes[i] = pCache->getSize();
+
+        // hit: each response is read from cache.
+        Poco::Timestamp hitStartTime;
+        std::clock_t hitStartClock = std::clock();
+        for (size_t j = 0; j < BenchmarkResponseCount; j++) {
+            Request::Builder requestBuilder;
+            Request::Ptr pRequest = requestBuilder.setUrl(HttpTestUtil::makeUrl(HttpTestConstants::Http,
+                    HttpTestConstants::DefaultHost, HttpTestConstants::DefaultPort, HttpTestConstants::DefaultPath,
+                    StringUtil::format("test=%zu", j))).build();
+            Response::Ptr pResponse = pHttpClient->newCall(pRequest)->execute();
+            ASSERT_TRUE(pResponse->getNetworkResponse().isNull());
+            ASSERT_EQ(BenchmarkResponseBodyBytes, pResponse->getBody()->toString().size());
+        }
+        double hitCpuMilliSec = 1000.0 * (std::clock() - hitStartClock) / CLOCKS_PER_SEC;
+        double hitElapsedMilliSec = hitStartTime.elapsed() / 1000.0;
+
+        double megaBytes = static_cast<double>(BenchmarkResponseBodyBytes * BenchmarkResponseCount) / (1024 * 1024);
+        EASYHTTPCPP_TESTLOG_I(Tag, "%s: body=%zu bytes at rest=%zu bytes (%.1f%%)",
+                compressions[i] == HttpCache::BodyCompressionGzip ? "gzip" : "none",
+                BenchmarkResponseBodyBytes * BenchmarkResponseCount, cachedSizes[i],
+                100.0 * cachedSizes[i] / (BenchmarkResponseBodyBytes * BenchmarkResponseCount));
+        EASYHTTPCPP_TESTLOG_I(Tag, "  fill: cpu=%.2f ms/MB elapsed=%.2f ms/MB (%.1f MB/s)", fillCpuMilliSec / megaBytes,
+                fillElapsedMilliSec / megaBytes, megaBytes * 1000.0 / fillElapsedMilliSec);
+        EASYHTTPCPP_TESTLOG_I(Tag, "  hit: cpu=%.2f ms/MB elapsed=%.2f ms/MB (%.1f MB/s)", hitCpuMilliSec / megaBytes,
+                hitElapsedMilliSec / megaBytes, megaBytes * 1000.0 / hitElapsedMilliSec);
+    }
+
+    // gzip at rest keeps the same responses in fewer bytes.
+    EXPECT_EQ(BenchmarkResponseBodyBytes * BenchmarkResponseCount, cachedSizes[0]);
+    EXPECT_LT(cachedSizes[1], cachedSizes[0]);
+}
+
 } /* namespace test */
 } /* namespace easyhttpcpp */
@@ -5,6 +5,7 @@
 #include "gtest/gtest.h"
 
 #include "Poco/File.h"
+#include "Poco/Path.h"
 #include "Poco/SharedPtr.h"
 
 #include "easyhttpcpp/common/CacheMetadata.h"
@@ -39,7 +40,9 @@ const char* Test2Url = "http://localhost:9982/test2?a=10";
 const char* const Test1ResponseBody = "test1 response body";
 const char* const Test2ResponseBody = "test2 response body";
 const char* const Test1TempFilename = "tempFile0001";
+const size_t DataDirNameLength = 2;
 
+// counts files in dir and in the data directories of cached response bodies.
 size_t getFileCount(Poco::File& dir)
 {
     std::vector<Poco::File> fileLists;
@@ -48,6 +51,8 @@ size_t getFileCount(Poco::File& dir)
     for (size_t i = 0; i < fileLists.size(); i++) {
         if (fileLists[i].isFile()) {
             fileCount++;
+        } else if (Poco::Path(fileLists[i].path()).getFileName().size() == DataDirNameLength) {
+            fileCount += getFileCount(fileLists[i]);
         }
     }
     return fileCount;
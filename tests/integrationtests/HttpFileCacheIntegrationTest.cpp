@@ -8,6 +8,7 @@
 #include "Poco/File.h"
 #include "Poco/FileStream.h"
 #include "Poco/SharedPtr.h"
+#include "Poco/Timestamp.h"
 #include "Poco/Net/HTTPResponse.h"
 
 #include "easyhttpcpp/common/CacheMetadata.h"
@@ -18,10 +19,12 @@
 #include "HeadersEqualMatcher.h"
 #include "TestFileUtil.h"
 #include "TestLogger.h"
+#include "TimeInRangeMatcher.h"
 
 #include "HttpIntegrationTestCase.h"
 #include "HttpCacheMetadata.h"
 #include "HttpFileCache.h"
+#include "HttpInternalConstants.h"
 #include "HttpTestConstants.h"
 #include "HttpTestUtil.h"
 #include "HttpUtil.h"
@@ -44,7 +47,6 @@ static const char* const LruQuery1 = "test=1";
 static const char* const LruQuery3 = "test=3";
 static const char* const LruQuery4 = "test=4";
 static const size_t ResponseBufferBytes = 8192;
-static const char* const CacheResponseBodyFileExtention = ".data";
 
 static const char* Test1Url = "http://localhost:9982/test1?a=10";
 static const char* const Test1ResponseBody = "test1 response body";
@@ -52,6 +54,7 @@ static const char* const Test1TempFilename = "tempFile0001";
 
 static const size_t JustCacheMaxSize = 300;
 static const size_t CacheOverResponseBodySize = 400;
+static const size_t InlineBodyMaxSize = 4096;
 
 class HttpFileCacheIntegrationTest : public HttpIntegrationTestCase {
 protected:
@@ -197,13 +200,12 @@ TEST_F(HttpFileCacheIntegrationTest, getMetadata_ReturnsFalse_WhenErrorOccurredI
 }
 
 // getMetadata
-// updateLastAccessSec が失敗
-//
-// false が返る。
-TEST_F(HttpFileCacheIntegrationTest, getMetadata_ReturnsFalse_WhenUpdateLastAccessSecFailed)
+// lastAccessedSec は flush まで Database に書き込まれない。
+TEST_F(HttpFileCacheIntegrationTest, getMetadata_WritesLastAccessedSecToDatabase_WhenFlushed)
 {
-    // Given: load database and set read only permission to database file
+    // Given: load test database
     prepareTestData();
+    std::string cachePath = HttpTestUtil::getDefaultCachePath();
 
     Poco::Path cacheRootDir(HttpTestUtil::getDefaultCacheRootDir());
     HttpFileCache httpFileCache(cacheRootDir, HttpTestConstants::DefaultCacheMaxSize);
@@ -212,17 +214,27 @@ TEST_F(HttpFileCacheIntegrationTest, getMetadata_ReturnsFalse_WhenUpdateLastAcce
             HttpTestConstants::DefaultPort, HttpTestConstants::DefaultPath, LruQuery1);
     std::string key = HttpUtil::makeCacheKey(Request::HttpMethodGet, url);
 
-    // getMetadata for load Database
-    CacheMetadata::Ptr pCacheMetadata = new HttpCacheMetadata;
-    ASSERT_TRUE(httpFileCache.getMetadata(key, pCacheMetadata));
+    HttpCacheDatabase db(new HttpCacheDatabaseOpenHelper(HttpTestUtil::createDatabasePath(cachePath)));
+    HttpCacheDatabase::HttpCacheMetadataAll::Ptr pMetadata1 = db.getMetadataAll(key);
+    ASSERT_FALSE(pMetadata1.isNull());
 
-    // set read only to database in order to fail updateLastAccessSec.
-    Poco::File databaseFile(HttpTestUtil::getDefaultCacheDatabaseFile());
-    TestFileUtil::setReadOnly(databaseFile.path());
+    Poco::Timestamp startTime;
 
     // When: getMetadata
-    // Then: return false
-    EXPECT_FALSE(httpFileCache.getMetadata(key, pCacheMetadata));
+    CacheMetadata::Ptr pCacheMetadata = new HttpCacheMetadata;
+    ASSERT_TRUE(httpFileCache.getMetadata(key, pCacheMetadata));
+
+    // Then: lastAccessedSec is written to database by flush
+    HttpCacheDatabase::HttpCacheMetadataAll::Ptr pMetadata2 = db.getMetadataAll(key);
+    ASSERT_FALSE(pMetadata2.isNull());
+    EXPECT_EQ(pMetadata1->getLastAccessedAtEpoch(), pMetadata2->getLastAccessedAtEpoch());
+
+    EXPECT_TRUE(httpFileCache.flush());
+    Poco::Timestamp endTime;
+    HttpCacheDatabase::HttpCacheMetadataAll::Ptr pMetadata3 = db.getMetadataAll(key);
+    ASSERT_FALSE(pMetadata3.isNull());
+    EXPECT_THAT(pMetadata3->getLastAccessedAtEpoch(), testutil::isTimeInRange(startTime.epochTime(),
+            endTime.epochTime()));
 }
 
 // getMetadata
@@ -400,8 +412,9 @@ TEST_F(HttpFileCacheIntegrationTest, getData_ReturnsFalse_WhenNotExistResponseBo
             HttpTestConstants::DefaultPort, HttpTestConstants::DefaultPath, LruQuery1);
     std::string key = HttpUtil::makeCacheKey(Request::HttpMethodGet, url);
 
-    Poco::Path cachedFilePath(HttpTestUtil::getDefaultCacheRootDir(), key + CacheResponseBodyFileExtention);
-    Poco::File cachedFile(cachedFilePath);
+    // the test data is moved to the current layout when the cache is opened.
+    httpFileCache.getSize();
+    Poco::File cachedFile(HttpUtil::makeCachedResponseBodyFilename(cacheRootDir, key));
     cachedFile.remove(false);
 
     // When: getData by exist key 
@@ -579,33 +592,37 @@ TEST_F(HttpFileCacheIntegrationTest, get_ReturnsFalse_WhenErrorOccurredInDatabas
 }
 
 // get
-// updateLastAccessSec が失敗
-//
-// false が返る。
-TEST_F(HttpFileCacheIntegrationTest, get_ReturnsFalse_WhenUpdateLastAccessSecFailed)
+// HttpFileCache の破棄時に lastAccessedSec が Database に書き込まれる。
+TEST_F(HttpFileCacheIntegrationTest, get_WritesLastAccessedSecToDatabase_WhenHttpFileCacheIsDestroyed)
 {
-    // Given: load test database and set read only to database file.
+    // Given: load test database
     prepareTestData();
-
-    Poco::Path cacheRootDir(HttpTestUtil::getDefaultCacheRootDir());
-    HttpFileCache httpFileCache(cacheRootDir, HttpTestConstants::DefaultCacheMaxSize);
+    std::string cachePath = HttpTestUtil::getDefaultCachePath();
 
     std::string url = HttpTestUtil::makeUrl(HttpTestConstants::Http, HttpTestConstants::DefaultHost,
             HttpTestConstants::DefaultPort, HttpTestConstants::DefaultPath, LruQuery1);
     std::string key = HttpUtil::makeCacheKey(Request::HttpMethodGet, url);
 
-    // getMetadata for load Database
-    CacheMetadata::Ptr pCacheMetadata = new HttpCacheMetadata;
-    ASSERT_TRUE(httpFileCache.getMetadata(key, pCacheMetadata));
-
-    // set read only to database in order to fail updateLastAccessSec.
-    Poco::File databaseFile(HttpTestUtil::getDefaultCacheDatabaseFile());
-    TestFileUtil::setReadOnly(databaseFile.path());
+    Poco::Timestamp startTime;
+    {
+        Poco::Path cacheRootDir(HttpTestUtil::getDefaultCacheRootDir());
+        HttpFileCache httpFileCache(cacheRootDir, HttpTestConstants::DefaultCacheMaxSize);
+
+        // When: get and destroy HttpFileCache
+        CacheMetadata::Ptr pCacheMetadata;
+        std::istream* pStream = NULL;
+        ASSERT_TRUE(httpFileCache.get(key, pCacheMetadata, pStream));
+        delete pStream;
+        httpFileCache.releaseData(key);
+    }
+    Poco::Timestamp endTime;
 
-    // When: get
-    // Then: return false
-    std::istream* pStream = NULL;
-    EXPECT_FALSE(httpFileCache.get(key, pCacheMetadata, pStream));
+    // Then: lastAccessedSec is written to database
+    HttpCacheDatabase db(new HttpCacheDatabaseOpenHelper(HttpTestUtil::createDatabasePath(cachePath)));
+    HttpCacheDatabase::HttpCacheMetadataAll::Ptr pMetadata = db.getMetadataAll(key);
+    ASSERT_FALSE(pMetadata.isNull());
+    EXPECT_THAT(pMetadata->getLastAccessedAtEpoch(), testutil::isTimeInRange(startTime.epochTime(),
+            endTime.epochTime()));
 }
 
 // get
@@ -625,8 +642,9 @@ TEST_F(HttpFileCacheIntegrationTest, get_ReturnsFalse_WhenNotExistResponseBodyFi
             HttpTestConstants::DefaultPort, HttpTestConstants::DefaultPath, LruQuery1);
     std::string key = HttpUtil::makeCacheKey(Request::HttpMethodGet, url);
 
-    Poco::Path cachedFilePath(HttpTestUtil::getDefaultCacheRootDir(), key + CacheResponseBodyFileExtention);
-    Poco::File cachedFile(cachedFilePath);
+    // the test data is moved to the current layout when the cache is opened.
+    httpFileCache.getSize();
+    Poco::File cachedFile(HttpUtil::makeCachedResponseBodyFilename(cacheRootDir, key));
     cachedFile.remove(false);
 
     // When: get
@@ -767,8 +785,9 @@ TEST_F(HttpFileCacheIntegrationTest, putMetadata_ReturnsFalse_WhenPutToUrlOfRese
 // putMetadata
 // dateRefCont > 0 の key への putMetadata
 //
-// false が返る。
-TEST_F(HttpFileCacheIntegrationTest, putMetadata_ReturnsFalse_WhenPutToDataRefCountIsNotZero)
+// 1. true が返る。
+// 2. 読み込み中のデータはそのまま読める。
+TEST_F(HttpFileCacheIntegrationTest, putMetadata_ReturnsTrue_WhenPutToDataRefCountIsNotZero)
 {
     // Given: load test database and increment dataRefCount
     // prepare test data
@@ -778,6 +797,7 @@ TEST_F(HttpFileCacheIntegrationTest, putMetadata_ReturnsFalse_WhenPutToDataRefCo
     // LRU_QUERY4
 
     prepareTestData();
+    std::string cachePath = HttpTestUtil::getDefaultCachePath();
 
     Poco::Path cacheRootDir(HttpTestUtil::getDefaultCacheRootDir());
     HttpFileCache httpFileCache(cacheRootDir, HttpTestConstants::DefaultCacheMaxSize);
@@ -790,12 +810,19 @@ TEST_F(HttpFileCacheIntegrationTest, putMetadata_ReturnsFalse_WhenPutToDataRefCo
     ASSERT_TRUE(httpFileCache.getData(key1, pStream1));
     Poco::SharedPtr<std::istream> pStreamPtr1 = pStream1;
 
-    std::string url = Test1Url;
-    CacheMetadata::Ptr pCacheMetadata = HttpTestUtil::createHttpCacheMetadata(key1, url, strlen(Test1ResponseBody));
+    CacheMetadata::Ptr pCacheMetadata = HttpTestUtil::createHttpCacheMetadata(key1, url1,
+            strlen(Test1ResponseBody));
 
     // When: putMetadata
-    // Then: return false
-    EXPECT_FALSE(httpFileCache.putMetadata(key1, pCacheMetadata));
+    // Then: return true and the metadata is updated while the data is referenced
+    EXPECT_TRUE(httpFileCache.putMetadata(key1, pCacheMetadata));
+
+    HttpCacheDatabase db(new HttpCacheDatabaseOpenHelper(HttpTestUtil::createDatabasePath(cachePath)));
+    HttpCacheDatabase::HttpCacheMetadataAll::Ptr pMetadata = db.getMetadataAll(key1);
+    ASSERT_FALSE(pMetadata.isNull());
+    EXPECT_EQ(pCacheMetadata.unsafeCast<HttpCacheMetadata>()->getCreatedAtEpoch(), pMetadata->getCreatedAtEpoch());
+    EXPECT_TRUE(pStreamPtr1->good());
+    httpFileCache.releaseData(key1);
 }
 
 // putMetadata
@@ -932,6 +959,74 @@ TEST_F(HttpFileCacheIntegrationTest, put_ReturnsTrue_WhenExistKeyInCache)
     ASSERT_EQ(0, memcmp(inBuffer.begin(), Test1ResponseBody, expectResponseBodySize));
 }
 
+// put
+// inlineBodyMaxSize 以下の response body の put
+//
+// 1. true が返る。
+// 2. response body は database に保存され、file は作られない。
+TEST_F(HttpFileCacheIntegrationTest, put_StoresResponseBodyInDatabase_WhenResponseBodyIsNotLargerThanInlineBodyMaxSize)
+{
+    // Given: empty cache which stores response bodies up to InlineBodyMaxSize in database
+    Poco::Path cacheRootDir(HttpTestUtil::getDefaultCacheRootDir());
+    HttpFileCache httpFileCache(cacheRootDir, HttpTestConstants::DefaultCacheMaxSize, NULL,
+            HttpInternalConstants::Caches::DataDirFanOutLevels, InlineBodyMaxSize);
+
+    std::string url = Test1Url;
+    std::string key = HttpUtil::makeCacheKey(Request::HttpMethodGet, url);
+    CacheMetadata::Ptr pCacheMetadata = HttpTestUtil::createHttpCacheMetadata(key, url, strlen(Test1ResponseBody));
+    std::string tempFilePath = HttpTestUtil::createResponseTempFile(Test1TempFilename, Test1ResponseBody);
+
+    // When: put
+    // Then: return true
+    EXPECT_TRUE(httpFileCache.put(key, pCacheMetadata, tempFilePath));
+
+    // neither cached file nor temporary file remains.
+    Poco::File responseBodyFile(HttpTestUtil::createCachedResponsedBodyFilePath(HttpTestUtil::getDefaultCachePath(),
+            Request::HttpMethodGet, url));
+    EXPECT_FALSE(responseBodyFile.exists());
+    EXPECT_FALSE(Poco::File(tempFilePath).exists());
+    EXPECT_EQ(strlen(Test1ResponseBody), httpFileCache.getSize());
+
+    // response body is read from database.
+    std::istream* pStream = NULL;
+    ASSERT_TRUE(httpFileCache.getData(key, pStream));
+    Poco::SharedPtr<std::istream> pStreamPtr = pStream;
+    Poco::Buffer<char> responseBodyBuffer(ResponseBufferBytes);
+    pStream->read(responseBodyBuffer.begin(), ResponseBufferBytes);
+    ASSERT_EQ(strlen(Test1ResponseBody), pStream->gcount());
+    EXPECT_EQ(0, memcmp(responseBodyBuffer.begin(), Test1ResponseBody, strlen(Test1ResponseBody)));
+    httpFileCache.releaseData(key);
+}
+
+// put
+// inlineBodyMaxSize より大きい response body の put
+//
+// 1. true が返る。
+// 2. response body は file に保存される。
+TEST_F(HttpFileCacheIntegrationTest, put_StoresResponseBodyInFile_WhenResponseBodyIsLargerThanInlineBodyMaxSize)
+{
+    // Given: empty cache which stores response bodies smaller than Test1ResponseBody in database
+    Poco::Path cacheRootDir(HttpTestUtil::getDefaultCacheRootDir());
+    HttpFileCache httpFileCache(cacheRootDir, HttpTestConstants::DefaultCacheMaxSize, NULL,
+            HttpInternalConstants::Caches::DataDirFanOutLevels, strlen(Test1ResponseBody) - 1);
+
+    std::string url = Test1Url;
+    std::string key = HttpUtil::makeCacheKey(Request::HttpMethodGet, url);
+    CacheMetadata::Ptr pCacheMetadata = HttpTestUtil::createHttpCacheMetadata(key, url, strlen(Test1ResponseBody));
+    std::string tempFilePath = HttpTestUtil::createResponseTempFile(Test1TempFilename, Test1ResponseBody);
+
+    // When: put
+    // Then: return true and response body is stored in file.
+    EXPECT_TRUE(httpFileCache.put(key, pCacheMetadata, tempFilePath));
+
+    Poco::File responseBodyFile(HttpTestUtil::createCachedResponsedBodyFilePath(HttpTestUtil::getDefaultCachePath(),
+            Request::HttpMethodGet, url));
+    EXPECT_EQ(strlen(Test1ResponseBody), responseBodyFile.getSize());
+    HttpCacheDatabase db(new HttpCacheDatabaseOpenHelper(
+            HttpTestUtil::createDatabasePath(HttpTestUtil::getDefaultCachePath())));
+    EXPECT_TRUE(db.getResponseBody(key).isNull());
+}
+
 // put
 // put すると、CacheMaxSize を超える場合
 //
@@ -958,7 +1053,8 @@ TEST_F(HttpFileCacheIntegrationTest, put_ReturnsTrueAndOldestCacheIsDeleted_When
     // Then: return true
     EXPECT_TRUE(httpFileCache.put(key, pCacheMetadata, tempFilePath));
 
-    // oldest cache(LRU_QUERY3) is deleted
+    // oldest cache(LRU_QUERY3) is deleted, at the latest when the index is loaded.
+    EXPECT_GE(JustCacheMaxSize, httpFileCache.getSize());
     HttpCacheDatabase db(new HttpCacheDatabaseOpenHelper(HttpTestUtil::createDatabasePath(cachePath)));
     std::string url3 = HttpTestUtil::makeUrl(HttpTestConstants::Http, HttpTestConstants::DefaultHost,
             HttpTestConstants::DefaultPort, HttpTestConstants::DefaultPath, LruQuery3);
@@ -974,6 +1070,51 @@ TEST_F(HttpFileCacheIntegrationTest, put_ReturnsTrueAndOldestCacheIsDeleted_When
     EXPECT_FALSE(db.getMetadataAll(key4).isNull());
 }
 
+// put
+// cache を開いた直後 (index の読み込み中) に put と get を繰り返す場合
+//
+// put は index の読み込みを待たずに true を返し、読み込み後は CacheMaxSize 以内に古い cache が削除される。
+TEST_F(HttpFileCacheIntegrationTest, put_ReturnsTrueAndKeepsCacheMaxSize_WhenPutAndGetAreRepeatedRightAfterOpen)
+{
+    // Given: load test database and maxCacheSize is just database total size.
+    // test data LRU (Query) old -> new
+    // LRU_QUERY3 (response body == 100 Byes)
+    // LRU_QUERY1 (response body == 100 Byes)
+    // LRU_QUERY4 (response body == 100 Byes)
+    prepareTestData();
+    std::string cachePath = HttpTestUtil::getDefaultCachePath();
+
+    Poco::Path cacheRootDir(HttpTestUtil::getDefaultCacheRootDir());
+    HttpFileCache httpFileCache(cacheRootDir, JustCacheMaxSize);
+
+    std::string url1 = HttpTestUtil::makeUrl(HttpTestConstants::Http, HttpTestConstants::DefaultHost,
+            HttpTestConstants::DefaultPort, HttpTestConstants::DefaultPath, LruQuery1);
+    std::string key1 = HttpUtil::makeCacheKey(Request::HttpMethodGet, url1);
+    size_t responseBodySize = 100;
+    std::string url = Test1Url;
+    std::string key = HttpUtil::makeCacheKey(Request::HttpMethodGet, url);
+
+    // When: put the same key and get LRU_QUERY1 repeatedly without waiting for the index.
+    // Then: put returns true
+    for (int i = 0; i < 3; i++) {
+        CacheMetadata::Ptr pCacheMetadata = HttpTestUtil::createHttpCacheMetadata(key, url, responseBodySize);
+        std::string tempFilePath = HttpTestUtil::createResponseTempFileBySize(Test1TempFilename, responseBodySize);
+        EXPECT_TRUE(httpFileCache.put(key, pCacheMetadata, tempFilePath));
+        CacheMetadata::Ptr pCacheMetadata1;
+        EXPECT_TRUE(httpFileCache.getMetadata(key1, pCacheMetadata1));
+    }
+
+    // the put key and LRU_QUERY1 are counted once and the oldest cache(LRU_QUERY3) is deleted.
+    EXPECT_EQ(JustCacheMaxSize, httpFileCache.getSize());
+    HttpCacheDatabase db(new HttpCacheDatabaseOpenHelper(HttpTestUtil::createDatabasePath(cachePath)));
+    std::string url3 = HttpTestUtil::makeUrl(HttpTestConstants::Http, HttpTestConstants::DefaultHost,
+            HttpTestConstants::DefaultPort, HttpTestConstants::DefaultPath, LruQuery3);
+    std::string key3 = HttpUtil::makeCacheKey(Request::HttpMethodGet, url3);
+    EXPECT_TRUE(db.getMetadataAll(key3).isNull());
+    EXPECT_FALSE(db.getMetadataAll(key1).isNull());
+    EXPECT_FALSE(db.getMetadataAll(key).isNull());
+}
+
 // put
 // put すると、CacheMaxSize を超えるが、LRUで削除しても、空き容量が足りない場合
 //
@@ -1910,6 +2051,49 @@ TEST_F(HttpFileCacheIntegrationTest, getSize_ResurnsCacheSize_WhenCacheDeleteByL
     EXPECT_FALSE(db.getMetadataAll(key4).isNull());
 }
 
+TEST_F(HttpFileCacheIntegrationTest, getSize_RemovesOrphanedFilesInBackground_WhenIndexIsLoaded)
+{
+    // Given: load test database and old files which are not in the database
+    prepareTestData();
+    Poco::Timestamp oldTime(Poco::Timestamp().epochMicroseconds() - 3600 * Poco::Timestamp::resolution());
+
+    Poco::File tempDir(HttpTestUtil::getDefaultCacheTempDir());
+    tempDir.createDirectories();
+    Poco::File orphanedTempFile(Poco::Path(tempDir.path(), "orphaned_temp_file").toString());
+    {
+        Poco::FileOutputStream fos(orphanedTempFile.path());
+        fos << "temp";
+    }
+    orphanedTempFile.setLastModified(oldTime);
+    Poco::File orphanedDataFile(HttpUtil::makeCachedResponseBodyFilename(
+            Poco::Path(HttpTestUtil::getDefaultCacheRootDir()), "orphaned"));
+    Poco::File(Poco::Path(orphanedDataFile.path()).parent()).createDirectories();
+    {
+        Poco::FileOutputStream fos(orphanedDataFile.path());
+        fos << "data";
+    }
+    orphanedDataFile.setLastModified(oldTime);
+
+    std::string url = HttpTestUtil::makeUrl(HttpTestConstants::Http, HttpTestConstants::DefaultHost,
+            HttpTestConstants::DefaultPort, HttpTestConstants::DefaultPath, LruQuery1);
+    std::string key = HttpUtil::makeCacheKey(Request::HttpMethodGet, url);
+    Poco::File cachedFile(HttpUtil::makeCachedResponseBodyFilename(
+            Poco::Path(HttpTestUtil::getDefaultCacheRootDir()), key));
+
+    {
+        Poco::Path cacheRootDir(HttpTestUtil::getDefaultCacheRootDir());
+        HttpFileCache httpFileCache(cacheRootDir, HttpTestConstants::DefaultCacheMaxSize);
+
+        // When: getSize and wait for the background work by destroying HttpFileCache
+        EXPECT_EQ(300, httpFileCache.getSize());
+    }
+
+    // Then: orphaned files are removed and cached files are kept
+    EXPECT_FALSE(orphanedTempFile.exists());
+    EXPECT_FALSE(orphanedDataFile.exists());
+    EXPECT_TRUE(cachedFile.exists());
+}
+
 TEST_F(HttpFileCacheIntegrationTest, onRenmove_ReturnsFalse_WhenDeleteMetadataReturnedFalse)
 {
     // Given: load test database and set read only to database file.
@@ -2,12 +2,16 @@
  * Copyright 2017 Sony Corporation
  */
 
+#include <vector>
+
 #include "gtest/gtest.h"
 
 #include "Poco/Buffer.h"
 #include "Poco/File.h"
 #include "Poco/FileStream.h"
 #include "Poco/SharedPtr.h"
+#include "Poco/ThreadPool.h"
+#include "Poco/Timestamp.h"
 #include "Poco/Net/HTTPResponse.h"
 
 #include "easyhttpcpp/common/CacheMetadata.h"
@@ -44,6 +48,9 @@ static const char* const Test1TempFilename = "tempFile0001";
 
 static const size_t ResponseBufferBytes = 8192;
 static const int MultiThreadCount = 10;
+static const int CacheHitMaxThreadCount = 8;
+static const int CacheHitKeyCountPerThread = 16;
+static const int CacheHitIterationCount = 2000;
 
 namespace {
 
@@ -192,6 +199,48 @@ private:
     Poco::Timestamp m_endTime;
 };
 
+class CacheHitExecutionRunner : public SynchronizedExecutionRunner {
+public:
+    CacheHitExecutionRunner(HttpFileCache* pHttpFileCache, int firstNo, int iterationCount) :
+            m_pHttpFileCache(pHttpFileCache), m_firstNo(firstNo), m_iterationCount(iterationCount)
+    {
+    }
+    bool execute()
+    {
+        // prepare
+        std::vector<std::string> keys;
+        for (int i = 0; i < CacheHitKeyCountPerThread; i++) {
+            std::string url = HttpTestUtil::makeUrl(HttpTestConstants::Http, HttpTestConstants::DefaultHost,
+                    HttpTestConstants::DefaultPort, HttpTestConstants::DefaultPath,
+                    StringUtil::format("no=%d", m_firstNo + i));
+            keys.push_back(HttpUtil::makeCacheKey(Request::HttpMethodGet, url));
+        }
+
+        setToReady();
+        waitToStart();
+
+        // execute
+        for (int i = 0; i < m_iterationCount; i++) {
+            const std::string& key = keys[i % keys.size()];
+            CacheMetadata::Ptr pCacheMetadata;
+            if (!m_pHttpFileCache->getMetadata(key, pCacheMetadata)) {
+                return false;
+            }
+            std::istream* pStream = NULL;
+            if (!m_pHttpFileCache->getData(key, pStream)) {
+                return false;
+            }
+            delete pStream;
+            m_pHttpFileCache->releaseData(key);
+        }
+        return true;
+    }
+private:
+    HttpFileCache* m_pHttpFileCache;
+    const int m_firstNo;
+    const int m_iterationCount;
+};
+
 bool prepareToCreateCache(HttpFileCache* pHttpFileCache)
 {
     for (int i = 0; i < MultiThreadCount; i++) {
@@ -879,5 +928,53 @@ TEST_F(HttpFileCacheWithMultiThreadIntegrationTest,
     }
 }
 
+
+// cache hit の throughput を thread 数を変えて計測します。
+// thread ごとに別の key を使うので、key ごとの lock で並列に実行されます。
+TEST_F(HttpFileCacheWithMultiThreadIntegrationTest,
+        getMetadataAndGetData_ScalesWithThreadCount_WhenCalledOnMultiThreadWithDifferentKeys)
+{
+    // Given: create cache for all threads
+    Poco::Path cacheRootDir(HttpTestUtil::getDefaultCacheRootDir());
+    HttpFileCache httpFileCache(cacheRootDir, HttpTestConstants::DefaultCacheMaxSize);
+    for (int i = 0; i < CacheHitMaxThreadCount * CacheHitKeyCountPerThread; i++) {
+        std::string url = HttpTestUtil::makeUrl(HttpTestConstants::Http, HttpTestConstants::DefaultHost,
+                HttpTestConstants::DefaultPort, HttpTestConstants::DefaultPath, StringUtil::format("no=%d", i));
+        std::string key = HttpUtil::makeCacheKey(Request::HttpMethodGet, url);
+        std::string tempFilePath = HttpTestUtil::createResponseTempFile(Test1TempFilename, Test1ResponseBody, i);
+        CacheMetadata::Ptr pCacheMetadata = HttpTestUtil::createHttpCacheMetadata(key, url,
+                strlen(Test1ResponseBody));
+        ASSERT_TRUE(httpFileCache.put(key, pCacheMetadata, tempFilePath));
+    }
+
+    for (int threadCount = 1; threadCount <= CacheHitMaxThreadCount; threadCount *= 2) {
+        Poco::ThreadPool threadPool(threadCount, threadCount);
+        std::vector<Poco::AutoPtr<CacheHitExecutionRunner> > runners;
+        for (int i = 0; i < threadCount; i++) {
+            runners.push_back(new CacheHitExecutionRunner(&httpFileCache, i * CacheHitKeyCountPerThread,
+                    CacheHitIterationCount));
+            threadPool.start(*runners[i]);
+            runners[i]->waitToReady();
+        }
+
+        // When: start getMetadata and getData
+        Poco::Timestamp startTime;
+        for (int i = 0; i < threadCount; i++) {
+            runners[i]->setToStart();
+        }
+        threadPool.joinAll();
+        Poco::Timestamp::TimeDiff elapsedMicroSec = startTime.elapsed();
+
+        // Then: all succeeded
+        for (int i = 0; i < threadCount; i++) {
+            EXPECT_TRUE(runners[i]->isSuccess());
+        }
+        double opsPerSec = static_cast<double>(threadCount) * CacheHitIterationCount * Poco::Timestamp::resolution() /
+                static_cast<double>(elapsedMicroSec > 0 ? elapsedMicroSec : 1);
+        EASYHTTPCPP_TESTLOG_I(Tag, "cache hit: threads=%d elapsed=%lld us throughput=%.0f ops/sec", threadCount,
+                static_cast<long long>(elapsedMicroSec), opsPerSec);
+    }
+}
+
 } /* namespace test */
 } /* namespace easyhttpcpp */
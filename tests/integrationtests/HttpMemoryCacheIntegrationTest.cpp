@@ -0,0 +1,123 @@
+/*
+ * Copyright 2019 Sony Corporation
+ */
+
+#include <string>
+
+#include "gtest/gtest.h"
+
+#include "Poco/File.h"
+#include "Poco/Path.h"
+
+#include "easyhttpcpp/common/FileUtil.h"
+#include "easyhttpcpp/EasyHttp.h"
+#include "easyhttpcpp/HttpCache.h"
+#include "easyhttpcpp/Request.h"
+#include "easyhttpcpp/Response.h"
+#include "easyhttpcpp/ResponseBody.h"
+#include "HttpTestServer.h"
+#include "TestLogger.h"
+
+#include "HttpIntegrationTestCase.h"
+#include "HttpTestCommonRequestHandler.h"
+#include "HttpTestConstants.h"
+#include "HttpTestUtil.h"
+
+using easyhttpcpp::common::FileUtil;
+using easyhttpcpp::testutil::HttpTestServer;
+
+namespace easyhttpcpp {
+namespace test {
+
+static const size_t MemoryCacheMaxSize = 1024;
+
+class HttpMemoryCacheIntegrationTest : public HttpIntegrationTestCase {
+protected:
+
+    void SetUp()
+    {
+        Poco::Path path(HttpTestUtil::getDefaultCachePath());
+        FileUtil::removeDirsIfPresent(path);
+
+        EASYHTTPCPP_TESTLOG_SETUP_END();
+    }
+};
+
+TEST_F(HttpMemoryCacheIntegrationTest, execute_ReturnsResponseFromMemoryCache_WhenCachedBodyFileIsRemoved)
+{
+    // Given: response is cached and read once from cache
+    HttpTestServer testServer;
+    HttpTestCommonRequestHandler::OneHourMaxAgeRequestHandler handler;
+    testServer.getTestRequestHandlerFactory().addHandler(HttpTestConstants::DefaultPath, &handler);
+    testServer.start(HttpTestConstants::DefaultPort);
+
+    std::string cachePath = HttpTestUtil::getDefaultCachePath();
+    HttpCache::Builder cacheBuilder(Poco::Path(cachePath), HttpTestConstants::DefaultCacheMaxSize);
+    HttpCache::Ptr pCache = cacheBuilder.setMemoryCacheMaxSize(MemoryCacheMaxSize).build();
+    EasyHttp::Builder httpClientBuilder;
+    EasyHttp::Ptr pHttpClient = httpClientBuilder.setCache(pCache).build();
+    std::string url = HttpTestConstants::DefaultTestUrlWithQuery;
+
+    Request::Builder requestBuilder1;
+    Request::Ptr pRequest1 = requestBuilder1.setUrl(url).build();
+    Response::Ptr pResponse1 = pHttpClient->newCall(pRequest1)->execute();
+    ASSERT_EQ(HttpTestConstants::DefaultResponseBody, pResponse1->getBody()->toString());
+
+    Request::Builder requestBuilder2;
+    Request::Ptr pRequest2 = requestBuilder2.setUrl(url).build();
+    Response::Ptr pResponse2 = pHttpClient->newCall(pRequest2)->execute();
+    ASSERT_FALSE(pResponse2->getCacheResponse().isNull());
+    ASSERT_EQ(HttpTestConstants::DefaultResponseBody, pResponse2->getBody()->toString());
+
+    // remove cached response body file
+    Poco::File cachedBodyFile(HttpTestUtil::createCachedResponsedBodyFilePath(cachePath, Request::HttpMethodGet,
+            url));
+    ASSERT_TRUE(cachedBodyFile.exists());
+    cachedBodyFile.remove();
+
+    // When: execute same request
+    Request::Builder requestBuilder3;
+    Request::Ptr pRequest3 = requestBuilder3.setUrl(url).build();
+    Response::Ptr pResponse3 = pHttpClient->newCall(pRequest3)->execute();
+
+    // Then: response is made from memory cache without network access
+    EXPECT_FALSE(pResponse3->getCacheResponse().isNull());
+    EXPECT_TRUE(pResponse3->getNetworkResponse().isNull());
+    EXPECT_EQ(HttpTestConstants::DefaultResponseBody, pResponse3->getBody()->toString());
+}
+
+TEST_F(HttpMemoryCacheIntegrationTest, evictAll_RemovesResponseFromMemoryCache)
+{
+    // Given: response is in memory cache
+    HttpTestServer testServer;
+    HttpTestCommonRequestHandler::OneHourMaxAgeRequestHandler handler;
+    testServer.getTestRequestHandlerFactory().addHandler(HttpTestConstants::DefaultPath, &handler);
+    testServer.start(HttpTestConstants::DefaultPort);
+
+    std::string cachePath = HttpTestUtil::getDefaultCachePath();
+    HttpCache::Builder cacheBuilder(Poco::Path(cachePath), HttpTestConstants::DefaultCacheMaxSize);
+    HttpCache::Ptr pCache = cacheBuilder.setMemoryCacheMaxSize(MemoryCacheMaxSize).build();
+    EasyHttp::Builder httpClientBuilder;
+    EasyHttp::Ptr pHttpClient = httpClientBuilder.setCache(pCache).build();
+    std::string url = HttpTestConstants::DefaultTestUrlWithQuery;
+    for (int i = 0; i < 2; i++) {
+        Request::Builder requestBuilder;
+        Request::Ptr pRequest = requestBuilder.setUrl(url).build();
+        Response::Ptr pResponse = pHttpClient->newCall(pRequest)->execute();
+        ASSERT_EQ(HttpTestConstants::DefaultResponseBody, pResponse->getBody()->toString());
+    }
+
+    // When: call evictAll()
+    pCache->evictAll();
+
+    // Then: response is got from network
+    Request::Builder requestBuilder;
+    Request::Ptr pRequest = requestBuilder.setUrl(url).build();
+    Response::Ptr pResponse = pHttpClient->newCall(pRequest)->execute();
+    EXPECT_TRUE(pResponse->getCacheResponse().isNull());
+    EXPECT_FALSE(pResponse->getNetworkResponse().isNull());
+    EXPECT_EQ(HttpTestConstants::DefaultResponseBody, pResponse->getBody()->toString());
+}
+
+} /* namespace test */
+} /* namespace easyhttpcpp */
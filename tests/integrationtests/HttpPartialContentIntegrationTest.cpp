@@ -0,0 +1,229 @@
+/*
+ * Copyright 2019 Sony Corporation
+ */
+
+#include <string>
+
+#include "gtest/gtest.h"
+
+#include "Poco/AtomicCounter.h"
+#include "Poco/File.h"
+#include "Poco/NumberFormatter.h"
+#include "Poco/NumberParser.h"
+#include "Poco/Path.h"
+#include "Poco/Net/HTTPRequestHandler.h"
+#include "Poco/Net/HTTPServerRequest.h"
+#include "Poco/Net/HTTPServerResponse.h"
+
+#include "easyhttpcpp/common/FileUtil.h"
+#include "easyhttpcpp/EasyHttp.h"
+#include "easyhttpcpp/HttpCache.h"
+#include "easyhttpcpp/Request.h"
+#include "easyhttpcpp/Response.h"
+#include "easyhttpcpp/ResponseBody.h"
+#include "HttpTestServer.h"
+#include "TestLogger.h"
+
+#include "HttpIntegrationTestCase.h"
+#include "HttpTestConstants.h"
+#include "HttpTestUtil.h"
+
+using easyhttpcpp::common::FileUtil;
+using easyhttpcpp::testutil::HttpTestServer;
+
+namespace easyhttpcpp {
+namespace test {
+
+static const std::string Tag = "HttpPartialContentIntegrationTest";
+
+static const char* const HeaderCacheControl = "Cache-Control";
+static const char* const HeaderContentRange = "Content-Range";
+static const char* const HeaderETag = "ETag";
+static const char* const HeaderIfRange = "If-Range";
+static const char* const HeaderRange = "Range";
+static const char* const HeaderValueMaxAgeOneHour = "max-age=3600";
+static const char* const EntityTag = "\"resource-v1\"";
+static const size_t ResourceBytes = 1000;
+static const size_t TruncatedBytes = 400;
+
+class HttpPartialContentIntegrationTest : public HttpIntegrationTestCase {
+protected:
+
+    void SetUp()
+    {
+        Poco::Path path(HttpTestUtil::getDefaultCachePath());
+        FileUtil::removeDirsIfPresent(path);
+
+        EASYHTTPCPP_TESTLOG_SETUP_END();
+    }
+};
+
+namespace {
+
+std::string createResource()
+{
+    std::string resource;
+    resource.reserve(ResourceBytes);
+    for (size_t i = 0; i < ResourceBytes; i++) {
+        resource.push_back(static_cast<char>('a' + (i % 26)));
+    }
+    return resource;
+}
+
+// the first response without Range is cut after TruncatedBytes; Range requests with a matching If-Range get 206.
+class TruncatingRangeRequestHandler : public Poco::Net::HTTPRequestHandler {
+public:
+
+    TruncatingRangeRequestHandler() : m_resource(createResource()), m_truncate(true), m_firstBytePos(0)
+    {
+    }
+
+    virtual void handleRequest(Poco::Net::HTTPServerRequest& request, Poco::Net::HTTPServerResponse& response)
+    {
+        m_requestCount++;
+        response.setContentType(HttpTestConstants::DefaultResponseContentType);
+        response.set(HeaderETag, EntityTag);
+        response.set(HeaderCacheControl, HeaderValueMaxAgeOneHour);
+
+        const std::string& range = request.get(HeaderRange, "");
+        if (!range.empty() && request.get(HeaderIfRange, "") == EntityTag) {
+            // bytes=<first>-
+            m_rangeRequestCount++;
+            std::string::size_type equal = range.find('=');
+            std::string::size_type dash = range.find('-');
+            m_firstBytePos = Poco::NumberParser::parseUnsigned(range.substr(equal + 1, dash - equal - 1));
+            response.setStatus(Poco::Net::HTTPResponse::HTTP_PARTIAL_CONTENT);
+            response.set(HeaderContentRange, "bytes " + Poco::NumberFormatter::format(m_firstBytePos) + "-" +
+                    Poco::NumberFormatter::format(m_resource.size() - 1) + "/" +
+                    Poco::NumberFormatter::format(m_resource.size()));
+            response.setContentLength(m_resource.size() - m_firstBytePos);
+            std::ostream& ostr = response.send();
+            ostr << m_resource.substr(m_firstBytePos);
+            return;
+        }
+
+        response.setStatus(Poco::Net::HTTPResponse::HTTP_OK);
+        response.setContentLength(m_resource.size());
+        if (m_truncate) {
+            m_truncate = false;
+            response.setKeepAlive(false);
+            std::ostream& ostr = response.send();
+            ostr << m_resource.substr(0, TruncatedBytes);
+            return;
+        }
+        std::ostream& ostr = response.send();
+        ostr << m_resource;
+    }
+
+    const std::string& getResource() const
+    {
+        return m_resource;
+    }
+
+    int getRequestCount() const
+    {
+        return m_requestCount.value();
+    }
+
+    int getRangeRequestCount() const
+    {
+        return m_rangeRequestCount.value();
+    }
+
+    size_t getFirstBytePos() const
+    {
+        return m_firstBytePos;
+    }
+
+    void setTruncate(bool truncate)
+    {
+        m_truncate = truncate;
+    }
+
+private:
+    std::string m_resource;
+    bool m_truncate;
+    size_t m_firstBytePos;
+    Poco::AtomicCounter m_requestCount;
+    Poco::AtomicCounter m_rangeRequestCount;
+};
+
+} /* namespace */
+
+TEST_F(HttpPartialContentIntegrationTest, execute_ResumesWithRange_WhenPreviousResponseBodyWasTruncated)
+{
+    // Given: 1st response body is truncated
+    HttpTestServer testServer;
+    TruncatingRangeRequestHandler handler;
+    testServer.getTestRequestHandlerFactory().addHandler(HttpTestConstants::DefaultPath, &handler);
+    testServer.start(HttpTestConstants::DefaultPort);
+
+    std::string cachePath = HttpTestUtil::getDefaultCachePath();
+    HttpCache::Ptr pCache = HttpCache::createCache(Poco::Path(cachePath), HttpTestConstants::DefaultCacheMaxSize);
+    EasyHttp::Builder httpClientBuilder;
+    EasyHttp::Ptr pHttpClient = httpClientBuilder.setCache(pCache).build();
+    std::string url = HttpTestConstants::DefaultTestUrlWithQuery;
+
+    Request::Builder requestBuilder1;
+    Request::Ptr pRequest1 = requestBuilder1.setUrl(url).build();
+    Response::Ptr pResponse1 = pHttpClient->newCall(pRequest1)->execute();
+    ASSERT_EQ(Poco::Net::HTTPResponse::HTTP_OK, pResponse1->getCode());
+    std::string responseBody1 = pResponse1->getBody()->toString();
+    ASSERT_EQ(TruncatedBytes, responseBody1.size());
+
+    // When: execute same request
+    Request::Builder requestBuilder2;
+    Request::Ptr pRequest2 = requestBuilder2.setUrl(url).build();
+    Response::Ptr pResponse2 = pHttpClient->newCall(pRequest2)->execute();
+
+    // Then: only the rest is requested and the user gets the whole body, which is cached
+    EXPECT_EQ(Poco::Net::HTTPResponse::HTTP_OK, pResponse2->getCode());
+    EXPECT_EQ(ResourceBytes, static_cast<size_t>(pResponse2->getBody()->getContentLength()));
+    std::string responseBody2 = pResponse2->getBody()->toString();
+    EXPECT_EQ(handler.getResource(), responseBody2);
+    EXPECT_EQ(1, handler.getRangeRequestCount());
+    EXPECT_EQ(TruncatedBytes, handler.getFirstBytePos());
+
+    Poco::File cachedBodyFile(HttpTestUtil::createCachedResponsedBodyFilePath(cachePath, Request::HttpMethodGet,
+            url));
+    ASSERT_TRUE(cachedBodyFile.exists());
+    EXPECT_EQ(ResourceBytes, cachedBodyFile.getSize());
+}
+
+TEST_F(HttpPartialContentIntegrationTest, execute_ReturnsPartialContentFromCache_WhenRangeRequestAndCacheIsFresh)
+{
+    // Given: whole body is cached and fresh
+    HttpTestServer testServer;
+    TruncatingRangeRequestHandler handler;
+    handler.setTruncate(false);
+    testServer.getTestRequestHandlerFactory().addHandler(HttpTestConstants::DefaultPath, &handler);
+    testServer.start(HttpTestConstants::DefaultPort);
+
+    std::string cachePath = HttpTestUtil::getDefaultCachePath();
+    HttpCache::Ptr pCache = HttpCache::createCache(Poco::Path(cachePath), HttpTestConstants::DefaultCacheMaxSize);
+    EasyHttp::Builder httpClientBuilder;
+    EasyHttp::Ptr pHttpClient = httpClientBuilder.setCache(pCache).build();
+    std::string url = HttpTestConstants::DefaultTestUrlWithQuery;
+
+    Request::Builder requestBuilder1;
+    Request::Ptr pRequest1 = requestBuilder1.setUrl(url).build();
+    Response::Ptr pResponse1 = pHttpClient->newCall(pRequest1)->execute();
+    ASSERT_EQ(Poco::Net::HTTPResponse::HTTP_OK, pResponse1->getCode());
+    pResponse1->getBody()->toString();
+
+    // When: execute Range request
+    Request::Builder requestBuilder2;
+    Request::Ptr pRequest2 = requestBuilder2.setUrl(url).setHeader(HeaderRange, "bytes=10-19").build();
+    Response::Ptr pResponse2 = pHttpClient->newCall(pRequest2)->execute();
+
+    // Then: 206 is made from cache without network access
+    EXPECT_EQ(Poco::Net::HTTPResponse::HTTP_PARTIAL_CONTENT, pResponse2->getCode());
+    EXPECT_EQ("bytes 10-19/1000", pResponse2->getHeaderValue(HeaderContentRange, ""));
+    EXPECT_EQ(handler.getResource().substr(10, 10), pResponse2->getBody()->toString());
+    EXPECT_FALSE(pResponse2->getCacheResponse().isNull());
+    EXPECT_TRUE(pResponse2->getNetworkResponse().isNull());
+    EXPECT_EQ(1, handler.getRequestCount());
+}
+
+} /* namespace test */
+} /* namespace easyhttpcpp */
@@ -7,10 +7,13 @@
 #include "Poco/Net/HTTPResponse.h"
 #include "Poco/Path.h"
 #include "Poco/URI.h"
+#include "Poco/Data/SQLite/Connector.h"
 
 #include "easyhttpcpp/common/CommonMacros.h"
 #include "easyhttpcpp/common/FileUtil.h"
 #include "easyhttpcpp/common/StringUtil.h"
+#include "easyhttpcpp/db/SqliteCursor.h"
+#include "easyhttpcpp/db/SqliteDatabase.h"
 
 #include "HttpTestConstants.h"
 #include "HttpTestUtil.h"
@@ -18,6 +21,8 @@
 
 using easyhttpcpp::common::FileUtil;
 using easyhttpcpp::common::StringUtil;
+using easyhttpcpp::db::SqliteCursor;
+using easyhttpcpp::db::SqliteDatabase;
 using easyhttpcpp::testutil::HttpsTestServer;
 
 namespace easyhttpcpp {
@@ -164,6 +169,20 @@ void HttpTestUtil::makeCacheDatabaseCorrupted()
 {
     Poco::File databaseFile(HttpTestUtil::createDatabasePath(HttpTestUtil::getDefaultCachePath()));
 
+    // cache database is kept open in WAL mode, so an open connection does not read the garbage written below.
+    // break the schema through another connection first; every connection notices the schema change.
+    if (databaseFile.exists()) {
+        Poco::Data::SQLite::Connector::registerConnector();
+        SqliteDatabase::Ptr pDatabase = SqliteDatabase::openOrCreateDatabase(databaseFile.path());
+        SqliteCursor::Ptr pCursor = pDatabase->rawQuery("PRAGMA schema_version;", NULL);
+        int schemaVersion = pCursor->getInt(0);
+        pCursor->close();
+        pDatabase->execSql("PRAGMA writable_schema = ON;");
+        pDatabase->execSql("UPDATE sqlite_master SET sql = 'Hello, world!' WHERE type = 'table';");
+        pDatabase->execSql(StringUtil::format("PRAGMA schema_version = %d;", schemaVersion + 1));
+        pDatabase->closeSqliteSession();
+    }
+
     // replace start of database file with some garbage
     Poco::FileOutputStream fos(databaseFile.path());
     fos.seekp(0);
@@ -345,6 +345,64 @@ TEST_F(ResponseBodyStreamFromCacheIntegrationTest, read_ReturnsMinusOne_WhenAfte
     EXPECT_EQ(-1, pResponseBodyStream2->read(responseBodyBuffer2.begin(), ResponseBufferBytes));
 }
 
+#ifndef _WIN32
+// cache file は memory map され、残りを copy せずに取得できる
+TEST_F(ResponseBodyStreamFromCacheIntegrationTest, readContiguous_ReturnsRestOfResponseBody_WhenReadFromCache)
+{
+    // Given: create cache and next request use cache.
+    HttpTestServer testServer;
+    HttpTestCommonRequestHandler::OneHourMaxAgeRequestHandler handler;
+    testServer.getTestRequestHandlerFactory().addHandler(HttpTestConstants::DefaultPath, &handler);
+    testServer.start(HttpTestConstants::DefaultPort);
+
+    std::string cachePath = HttpTestUtil::getDefaultCachePath();
+    HttpCache::Ptr pCache = HttpCache::createCache(Poco::Path(cachePath), HttpTestConstants::DefaultCacheMaxSize);
+
+    // create EasyHttp
+    EasyHttp::Builder httpClientBuilder1;
+    EasyHttp::Ptr pHttpClient1 = httpClientBuilder1.setCache(pCache).build();
+    Request::Builder requestBuilder1;
+    std::string url = HttpTestConstants::DefaultTestUrlWithQuery;
+    Request::Ptr pRequest1 = requestBuilder1.setUrl(url).build();
+    Call::Ptr pCall1 = pHttpClient1->newCall(pRequest1);
+
+    // execute GET method.
+    Response::Ptr pResponse1 = pCall1->execute();
+    ASSERT_EQ(Poco::Net::HTTPResponse::HTTP_OK, pResponse1->getCode());
+    // read response body and close
+    std::string responseBody1 = pResponse1->getBody()->toString();
+
+    // GET same url from cached response.
+    EasyHttp::Builder httpClientBuilder2;
+    EasyHttp::Ptr pHttpClient2 = httpClientBuilder2.setCache(pCache).build();
+    Request::Builder requestBuilder2;
+    Request::Ptr pRequest2 = requestBuilder2.setUrl(url).build();
+    Call::Ptr pCall2 = pHttpClient2->newCall(pRequest2);
+
+    Response::Ptr pResponse2 = pCall2->execute();
+    ASSERT_EQ(Poco::Net::HTTPResponse::HTTP_OK, pResponse2->getCode());
+    ASSERT_FALSE(pResponse2->getCacheResponse().isNull());
+    ResponseBodyStream::Ptr pResponseBodyStream2 = pResponse2->getBody()->getByteStream();
+    ASSERT_FALSE(pResponseBodyStream2.isNull());
+    Poco::Buffer<char> responseBodyBuffer2(ResponseBufferBytes);
+    ssize_t readSize = 10;
+    ASSERT_EQ(readSize, pResponseBodyStream2->read(responseBodyBuffer2.begin(), readSize));
+
+    // When: ResponseBodyStream::readContiguous
+    const char* pData = NULL;
+    size_t size = 0;
+    bool ret = pResponseBodyStream2->readContiguous(pData, size);
+
+    // Then: the rest of response body is returned and stream is at eof
+    ASSERT_TRUE(ret);
+    std::string expectedRest = std::string(HttpTestConstants::DefaultResponseBody).substr(readSize);
+    EXPECT_EQ(expectedRest, std::string(pData, size));
+    EXPECT_TRUE(pResponseBodyStream2->isEof());
+    EXPECT_EQ(-1, pResponseBodyStream2->read(responseBodyBuffer2.begin(), ResponseBufferBytes));
+    pResponseBodyStream2->close();
+}
+#endif
+
 class MethodForRemoveBeforeCloseOfGetParam {
 public:
     Request::HttpMethod httpMethod;
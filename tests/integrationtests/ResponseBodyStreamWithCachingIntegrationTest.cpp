@@ -8,8 +8,10 @@
 #include "gtest/gtest.h"
 
 #include "Poco/DirectoryIterator.h"
+#include "Poco/Exception.h"
 #include "Poco/File.h"
 #include "Poco/NumberFormatter.h"
+#include "Poco/Thread.h"
 #include "Poco/Net/HTTPRequestHandler.h"
 #include "Poco/Net/HTTPServerRequest.h"
 #include "Poco/Net/HTTPServerResponse.h"
@@ -17,6 +19,7 @@
 #include "easyhttpcpp/common/FileUtil.h"
 #include "easyhttpcpp/common/StringUtil.h"
 #include "easyhttpcpp/Connection.h"
+#include "easyhttpcpp/ConnectionPool.h"
 #include "easyhttpcpp/EasyHttp.h"
 #include "easyhttpcpp/HttpException.h"
 #include "easyhttpcpp/Interceptor.h"
@@ -30,7 +33,10 @@
 #include "TestLogger.h"
 
 #include "HttpCacheDatabase.h"
+#include "HttpCacheInternal.h"
+#include "HttpCacheWriter.h"
 #include "HttpIntegrationTestCase.h"
+#include "HttpInternalConstants.h"
 #include "HttpTestCommonRequestHandler.h"
 #include "HttpTestConstants.h"
 #include "HttpTestUtil.h"
@@ -53,6 +59,10 @@ static const char* const HeaderValueChunked = "chunked";
 static const size_t ResponseBufferBytes = 8192;
 static const int TestFailureTimeout = 10 * 1000; // milliseconds
 static const int SkipTimoutSleepMilliSec = 500;
+static const ssize_t BackgroundCacheFillResponseBodyBytes = 1024 * 1024;
+static const size_t BackgroundCacheFillReadBytes = 100;
+static const int BackgroundCacheFillPollingCount = 100;
+static const int BackgroundCacheFillPollingIntervalMillis = 100;
 
 class ResponseBodyStreamWithCachingIntegrationTest : public HttpIntegrationTestCase {
 protected:
@@ -81,6 +91,96 @@ protected:
 
 namespace {
 
+// the background cache fill stores the response asynchronously after close.
+HttpCacheDatabase::HttpCacheMetadataAll::Ptr waitForCachedMetadata(const std::string& cachePath,
+        const std::string& url)
+{
+    HttpCacheDatabase db(new HttpCacheDatabaseOpenHelper(HttpTestUtil::createDatabasePath(cachePath)));
+    std::string key = HttpUtil::makeCacheKey(Request::HttpMethodGet, url);
+    for (int i = 0; i < BackgroundCacheFillPollingCount; i++) {
+        HttpCacheDatabase::HttpCacheMetadataAll::Ptr pMetadata = db.getMetadataAll(key);
+        if (pMetadata) {
+            return pMetadata;
+        }
+        Poco::Thread::sleep(BackgroundCacheFillPollingIntervalMillis);
+    }
+    return NULL;
+}
+
+bool waitForConnectionRemoved(ConnectionPool::Ptr pConnectionPool)
+{
+    for (int i = 0; i < BackgroundCacheFillPollingCount; i++) {
+        if (pConnectionPool->getTotalConnectionCount() == 0) {
+            return true;
+        }
+        Poco::Thread::sleep(BackgroundCacheFillPollingIntervalMillis);
+    }
+    return false;
+}
+
+// HttpCacheInternal which writes response bodies by the given cache writer.
+class HttpCacheWithCacheWriter : public HttpCacheInternal {
+public:
+
+    HttpCacheWithCacheWriter(const Poco::Path& path, size_t maxSize, HttpCacheWriter::Ptr pCacheWriter) :
+            HttpCacheInternal(path, maxSize), m_pCacheWriter(pCacheWriter)
+    {
+    }
+
+    virtual HttpCacheWriter::Ptr getCacheWriter() const
+    {
+        return m_pCacheWriter;
+    }
+
+private:
+    HttpCacheWriter::Ptr m_pCacheWriter;
+};
+
+// the writer thread does not start until startDeferred, so that the queue is not drained.
+class DeferredStartCacheWriter : public HttpCacheWriter {
+public:
+    typedef Poco::AutoPtr<DeferredStartCacheWriter> Ptr;
+
+    DeferredStartCacheWriter(size_t maxQueuedBytes) : HttpCacheWriter(maxQueuedBytes), m_startable(false)
+    {
+    }
+
+    void startDeferred()
+    {
+        m_startable = true;
+        HttpCacheWriter::startWriterThread();
+    }
+
+protected:
+    virtual void startWriterThread()
+    {
+        if (m_startable) {
+            HttpCacheWriter::startWriterThread();
+        }
+    }
+
+private:
+    bool m_startable;
+};
+
+class StartFailingCacheWriter : public HttpCacheWriter {
+public:
+
+    StartFailingCacheWriter() : HttpCacheWriter(HttpInternalConstants::Caches::WriterQueueMaxBytes)
+    {
+    }
+
+protected:
+    virtual void startWriterThread()
+    {
+        throw Poco::SystemException("cannot start thread");
+    }
+};
+
+} /* namespace */
+
+namespace {
+
 class ResponseTransferEncodingIsChunkedRequestHandler : public Poco::Net::HTTPRequestHandler {
 public:
 
@@ -525,5 +625,302 @@ TEST_F(ResponseBodyStreamWithCachingIntegrationTest,
     EXPECT_FALSE(responseBodyFile.exists());
 }
 
+TEST_F(ResponseBodyStreamWithCachingIntegrationTest, writeTo_WritesFileAndStoresCache_WhenCacheable)
+{
+    // Given: response is cacheable
+    HttpTestServer testServer;
+    HttpTestCommonRequestHandler::OkRequestHandler handler;
+    testServer.getTestRequestHandlerFactory().addHandler(HttpTestConstants::DefaultPath, &handler);
+    testServer.start(HttpTestConstants::DefaultPort);
+
+    std::string cachePath = HttpTestUtil::getDefaultCachePath();
+    HttpCache::Ptr pCache = HttpCache::createCache(Poco::Path(cachePath), HttpTestConstants::DefaultCacheMaxSize);
+
+    EasyHttp::Builder httpClientBuilder;
+    EasyHttp::Ptr pHttpClient = httpClientBuilder.setCache(pCache).build();
+    Request::Builder requestBuilder;
+    std::string url = HttpTestConstants::DefaultTestUrlWithQuery;
+    Request::Ptr pRequest = requestBuilder.setUrl(url).build();
+    Call::Ptr pCall = pHttpClient->newCall(pRequest);
+
+    Response::Ptr pResponse = pCall->execute();
+    ASSERT_EQ(Poco::Net::HTTPResponse::HTTP_OK, pResponse->getCode());
+
+    // When: writeTo
+    Poco::Path outputPath(cachePath, "download.data");
+    Poco::UInt64 writtenBytes = pResponse->getBody()->writeTo(outputPath);
+
+    // Then: file has the response body and the response is stored to cache as well
+    EXPECT_EQ(strlen(HttpTestConstants::DefaultResponseBody), writtenBytes);
+    Poco::File outputFile(outputPath);
+    ASSERT_TRUE(outputFile.exists());
+    EXPECT_EQ(strlen(HttpTestConstants::DefaultResponseBody), outputFile.getSize());
+
+    Poco::File responseBodyFile(HttpTestUtil::createCachedResponsedBodyFilePath(cachePath,
+            Request::HttpMethodGet, url));
+    ASSERT_TRUE(responseBodyFile.exists());
+    EXPECT_EQ(strlen(HttpTestConstants::DefaultResponseBody), responseBodyFile.getSize());
+}
+
+TEST_F(ResponseBodyStreamWithCachingIntegrationTest, writeTo_WritesFileAndNotStoreToCache_WhenTempFileCanNotBeCreated)
+{
+    // Given: set read only to parent of temp directory
+    Poco::File cacheTempDir(HttpTestUtil::getDefaultCacheRootDir());
+    cacheTempDir.createDirectories();
+    m_pathToCleanUp.assign(cacheTempDir.path());
+    TestFileUtil::setReadOnly(m_pathToCleanUp);
+
+    HttpTestServer testServer;
+    HttpTestCommonRequestHandler::OkRequestHandler handler;
+    testServer.getTestRequestHandlerFactory().addHandler(HttpTestConstants::DefaultPath, &handler);
+    testServer.start(HttpTestConstants::DefaultPort);
+
+    std::string cachePath = HttpTestUtil::getDefaultCachePath();
+    HttpCache::Ptr pCache = HttpCache::createCache(Poco::Path(cachePath), HttpTestConstants::DefaultCacheMaxSize);
+
+    EasyHttp::Builder httpClientBuilder;
+    EasyHttp::Ptr pHttpClient = httpClientBuilder.setCache(pCache).build();
+    Request::Builder requestBuilder;
+    std::string url = HttpTestConstants::DefaultTestUrlWithQuery;
+    Request::Ptr pRequest = requestBuilder.setUrl(url).build();
+    Call::Ptr pCall = pHttpClient->newCall(pRequest);
+
+    Response::Ptr pResponse = pCall->execute();
+    ASSERT_EQ(Poco::Net::HTTPResponse::HTTP_OK, pResponse->getCode());
+
+    // When: writeTo
+    Poco::Path outputPath(cachePath, "download.data");
+    Poco::UInt64 writtenBytes = pResponse->getBody()->writeTo(outputPath);
+
+    // Then: file has the response body, and the response is not stored to cache
+    EXPECT_EQ(strlen(HttpTestConstants::DefaultResponseBody), writtenBytes);
+    Poco::File outputFile(outputPath);
+    ASSERT_TRUE(outputFile.exists());
+    EXPECT_EQ(strlen(HttpTestConstants::DefaultResponseBody), outputFile.getSize());
+
+    Poco::File responseBodyFile(HttpTestUtil::createCachedResponsedBodyFilePath(cachePath,
+            Request::HttpMethodGet, url));
+    EXPECT_FALSE(responseBodyFile.exists());
+}
+
+TEST_F(ResponseBodyStreamWithCachingIntegrationTest,
+        close_StoresWholeResponseBodyToCacheAndReleasesConnection_WhenCompleteInBackgroundAndClosedEarly)
+{
+    // Given: cache fill policy is CacheFillPolicyCompleteInBackground
+    HttpTestServer testServer;
+    HttpTestCommonRequestHandler::SpecifyingContentLengthRequestHandler handler(BackgroundCacheFillResponseBodyBytes);
+    testServer.getTestRequestHandlerFactory().addHandler(HttpTestConstants::DefaultPath, &handler);
+    testServer.start(HttpTestConstants::DefaultPort);
+
+    std::string cachePath = HttpTestUtil::getDefaultCachePath();
+    HttpCache::Ptr pCache = HttpCache::createCache(Poco::Path(cachePath), HttpTestConstants::DefaultCacheMaxSize);
+    ConnectionPool::Ptr pConnectionPool = ConnectionPool::createConnectionPool();
+
+    EasyHttp::Builder httpClientBuilder;
+    EasyHttp::Ptr pHttpClient = httpClientBuilder.setCache(pCache).setConnectionPool(pConnectionPool)
+            .setCacheFillPolicy(CacheFillPolicyCompleteInBackground).build();
+    Request::Builder requestBuilder1;
+    std::string url = HttpTestConstants::DefaultTestUrlWithQuery;
+    Request::Ptr pRequest1 = requestBuilder1.setUrl(url).build();
+
+    Response::Ptr pResponse1 = pHttpClient->newCall(pRequest1)->execute();
+    ASSERT_EQ(Poco::Net::HTTPResponse::HTTP_OK, pResponse1->getCode());
+    ResponseBodyStream::Ptr pResponseBodyStream = pResponse1->getBody()->getByteStream();
+    Poco::Buffer<char> responseBodyBuffer(BackgroundCacheFillReadBytes);
+    ASSERT_LT(0, pResponseBodyStream->read(responseBodyBuffer.begin(), responseBodyBuffer.size()));
+
+    // When: close before the end of response body
+    pResponseBodyStream->close();
+
+    // Then: the whole response body is stored to cache in background
+    HttpCacheDatabase::HttpCacheMetadataAll::Ptr pMetadata = waitForCachedMetadata(cachePath, url);
+    ASSERT_FALSE(pMetadata.isNull());
+    EXPECT_EQ(static_cast<size_t>(BackgroundCacheFillResponseBodyBytes), pMetadata->getResponseBodySize());
+    Poco::File responseBodyFile(HttpTestUtil::createCachedResponsedBodyFilePath(cachePath,
+            Request::HttpMethodGet, url));
+    ASSERT_TRUE(responseBodyFile.exists());
+    EXPECT_EQ(static_cast<Poco::File::FileSize>(BackgroundCacheFillResponseBodyBytes), responseBodyFile.getSize());
+
+    // the connection is released to ConnectionPool
+    EXPECT_EQ(1, pConnectionPool->getTotalConnectionCount());
+    EXPECT_EQ(1, pConnectionPool->getKeepAliveIdleConnectionCount());
+
+    // the next request is served from cache
+    Request::Builder requestBuilder2;
+    Request::Ptr pRequest2 = requestBuilder2.setUrl(url).build();
+    Response::Ptr pResponse2 = pHttpClient->newCall(pRequest2)->execute();
+    EXPECT_EQ(Poco::Net::HTTPResponse::HTTP_OK, pResponse2->getCode());
+    EXPECT_TRUE(pResponse2->getNetworkResponse().isNull());
+    EXPECT_FALSE(pResponse2->getCacheResponse().isNull());
+    EXPECT_EQ(static_cast<size_t>(BackgroundCacheFillResponseBodyBytes), pResponse2->getBody()->toString().size());
+}
+
+TEST_F(ResponseBodyStreamWithCachingIntegrationTest,
+        close_DoesNotStoreToCache_WhenCompleteInBackgroundAndRestOfResponseBodyIsOverMaxBytes)
+{
+    // Given: the rest of response body is over the background cache fill max bytes
+    HttpTestServer testServer;
+    HttpTestCommonRequestHandler::SpecifyingContentLengthRequestHandler handler(BackgroundCacheFillResponseBodyBytes);
+    testServer.getTestRequestHandlerFactory().addHandler(HttpTestConstants::DefaultPath, &handler);
+    testServer.start(HttpTestConstants::DefaultPort);
+
+    std::string cachePath = HttpTestUtil::getDefaultCachePath();
+    HttpCache::Ptr pCache = HttpCache::createCache(Poco::Path(cachePath), HttpTestConstants::DefaultCacheMaxSize);
+
+    EasyHttp::Builder httpClientBuilder;
+    EasyHttp::Ptr pHttpClient = httpClientBuilder.setCache(pCache)
+            .setCacheFillPolicy(CacheFillPolicyCompleteInBackground)
+            .setBackgroundCacheFillMaxBytes(BackgroundCacheFillResponseBodyBytes / 2).build();
+    Request::Builder requestBuilder1;
+    std::string url = HttpTestConstants::DefaultTestUrlWithQuery;
+    Request::Ptr pRequest1 = requestBuilder1.setUrl(url).build();
+
+    Response::Ptr pResponse1 = pHttpClient->newCall(pRequest1)->execute();
+    ASSERT_EQ(Poco::Net::HTTPResponse::HTTP_OK, pResponse1->getCode());
+    ResponseBodyStream::Ptr pResponseBodyStream = pResponse1->getBody()->getByteStream();
+    Poco::Buffer<char> responseBodyBuffer(BackgroundCacheFillReadBytes);
+    ASSERT_LT(0, pResponseBodyStream->read(responseBodyBuffer.begin(), responseBodyBuffer.size()));
+
+    // When: close before the end of response body
+    pResponseBodyStream->close();
+
+    // Then: the fill is abandoned and a truncated response body is not stored to cache
+    HttpCacheDatabase db(new HttpCacheDatabaseOpenHelper(HttpTestUtil::createDatabasePath(cachePath)));
+    EXPECT_TRUE(db.getMetadataAll(HttpUtil::makeCacheKey(Request::HttpMethodGet, url)).isNull());
+    Poco::File responseBodyFile(HttpTestUtil::createCachedResponsedBodyFilePath(cachePath,
+            Request::HttpMethodGet, url));
+    EXPECT_FALSE(responseBodyFile.exists());
+
+    // the next request is sent to network
+    Request::Builder requestBuilder2;
+    Request::Ptr pRequest2 = requestBuilder2.setUrl(url).build();
+    Response::Ptr pResponse2 = pHttpClient->newCall(pRequest2)->execute();
+    EXPECT_EQ(Poco::Net::HTTPResponse::HTTP_OK, pResponse2->getCode());
+    EXPECT_FALSE(pResponse2->getNetworkResponse().isNull());
+    EXPECT_TRUE(pResponse2->getCacheResponse().isNull());
+    pResponse2->getBody()->close();
+}
+
+TEST_F(ResponseBodyStreamWithCachingIntegrationTest,
+        close_DoesNotStoreToCacheAndRemovesConnection_WhenCompleteInBackgroundAndTimeoutIsOver)
+{
+    // Given: the server stops in the middle of response body longer than the background cache fill timeout
+    HttpTestServer testServer;
+    HttpTestCommonRequestHandler::WaitInTheMiddleOfWriteResponseBodyRequestHandler handler(
+            BackgroundCacheFillResponseBodyBytes, BackgroundCacheFillResponseBodyBytes / 2, 3000);
+    testServer.getTestRequestHandlerFactory().addHandler(HttpTestConstants::DefaultPath, &handler);
+    testServer.start(HttpTestConstants::DefaultPort);
+
+    std::string cachePath = HttpTestUtil::getDefaultCachePath();
+    HttpCache::Ptr pCache = HttpCache::createCache(Poco::Path(cachePath), HttpTestConstants::DefaultCacheMaxSize);
+    ConnectionPool::Ptr pConnectionPool = ConnectionPool::createConnectionPool();
+
+    EasyHttp::Builder httpClientBuilder;
+    EasyHttp::Ptr pHttpClient = httpClientBuilder.setCache(pCache).setConnectionPool(pConnectionPool)
+            .setCacheFillPolicy(CacheFillPolicyCompleteInBackground).setBackgroundCacheFillTimeoutSec(1).build();
+    Request::Builder requestBuilder;
+    std::string url = HttpTestConstants::DefaultTestUrlWithQuery;
+    Request::Ptr pRequest = requestBuilder.setUrl(url).build();
+
+    Response::Ptr pResponse = pHttpClient->newCall(pRequest)->execute();
+    ASSERT_EQ(Poco::Net::HTTPResponse::HTTP_OK, pResponse->getCode());
+    ResponseBodyStream::Ptr pResponseBodyStream = pResponse->getBody()->getByteStream();
+    Poco::Buffer<char> responseBodyBuffer(BackgroundCacheFillReadBytes);
+    ASSERT_LT(0, pResponseBodyStream->read(responseBodyBuffer.begin(), responseBodyBuffer.size()));
+
+    // When: close before the end of response body
+    pResponseBodyStream->close();
+
+    // Then: the fill is abandoned, the connection is not reused and a truncated response body is not stored
+    ASSERT_TRUE(waitForConnectionRemoved(pConnectionPool));
+    EXPECT_EQ(0, pConnectionPool->getKeepAliveIdleConnectionCount());
+    HttpCacheDatabase db(new HttpCacheDatabaseOpenHelper(HttpTestUtil::createDatabasePath(cachePath)));
+    EXPECT_TRUE(db.getMetadataAll(HttpUtil::makeCacheKey(Request::HttpMethodGet, url)).isNull());
+    Poco::File responseBodyFile(HttpTestUtil::createCachedResponsedBodyFilePath(cachePath,
+            Request::HttpMethodGet, url));
+    EXPECT_FALSE(responseBodyFile.exists());
+}
+
+TEST_F(ResponseBodyStreamWithCachingIntegrationTest,
+        read_ReadsWholeResponseBodyAndNotStoreToCache_WhenCacheWriterIsFull)
+{
+    // Given: the cache writer queue is full, since its thread does not drain it
+    HttpTestServer testServer;
+    HttpTestCommonRequestHandler::SpecifyingContentLengthRequestHandler handler(BackgroundCacheFillResponseBodyBytes);
+    testServer.getTestRequestHandlerFactory().addHandler(HttpTestConstants::DefaultPath, &handler);
+    testServer.start(HttpTestConstants::DefaultPort);
+
+    std::string cachePath = HttpTestUtil::getDefaultCachePath();
+    DeferredStartCacheWriter::Ptr pCacheWriter = new DeferredStartCacheWriter(BackgroundCacheFillReadBytes);
+    HttpCache::Ptr pCache = new HttpCacheWithCacheWriter(Poco::Path(cachePath),
+            HttpTestConstants::DefaultCacheMaxSize, pCacheWriter);
+
+    EasyHttp::Builder httpClientBuilder;
+    EasyHttp::Ptr pHttpClient = httpClientBuilder.setCache(pCache).build();
+    Request::Builder requestBuilder;
+    std::string url = HttpTestConstants::DefaultTestUrlWithQuery;
+    Request::Ptr pRequest = requestBuilder.setUrl(url).build();
+
+    Response::Ptr pResponse = pHttpClient->newCall(pRequest)->execute();
+    ASSERT_EQ(Poco::Net::HTTPResponse::HTTP_OK, pResponse->getCode());
+    ResponseBodyStream::Ptr pResponseBodyStream = pResponse->getBody()->getByteStream();
+
+    // When: read to the end of response body and close
+    Poco::Buffer<char> responseBodyBuffer(BackgroundCacheFillReadBytes);
+    ssize_t totalBytes = 0;
+    while (!pResponseBodyStream->isEof()) {
+        ssize_t bytes = pResponseBodyStream->read(responseBodyBuffer.begin(), responseBodyBuffer.size());
+        if (bytes < 0) {
+            break;
+        }
+        totalBytes += bytes;
+    }
+    // the bytes queued before the queue got full are written, so that close does not wait forever.
+    pCacheWriter->startDeferred();
+    pResponseBodyStream->close();
+
+    // Then: the whole response body is read, and the response is not stored to cache
+    EXPECT_EQ(BackgroundCacheFillResponseBodyBytes, totalBytes);
+    HttpCacheDatabase db(new HttpCacheDatabaseOpenHelper(HttpTestUtil::createDatabasePath(cachePath)));
+    EXPECT_TRUE(db.getMetadataAll(HttpUtil::makeCacheKey(Request::HttpMethodGet, url)).isNull());
+    Poco::File responseBodyFile(HttpTestUtil::createCachedResponsedBodyFilePath(cachePath,
+            Request::HttpMethodGet, url));
+    EXPECT_FALSE(responseBodyFile.exists());
+}
+
+TEST_F(ResponseBodyStreamWithCachingIntegrationTest,
+        read_ReadsWholeResponseBodyAndNotStoreToCache_WhenCacheWriterThreadCanNotBeStarted)
+{
+    // Given: the cache writer thread can not be started
+    HttpTestServer testServer;
+    HttpTestCommonRequestHandler::SpecifyingContentLengthRequestHandler handler(BackgroundCacheFillResponseBodyBytes);
+    testServer.getTestRequestHandlerFactory().addHandler(HttpTestConstants::DefaultPath, &handler);
+    testServer.start(HttpTestConstants::DefaultPort);
+
+    std::string cachePath = HttpTestUtil::getDefaultCachePath();
+    HttpCache::Ptr pCache = new HttpCacheWithCacheWriter(Poco::Path(cachePath),
+            HttpTestConstants::DefaultCacheMaxSize, new StartFailingCacheWriter());
+
+    EasyHttp::Builder httpClientBuilder;
+    EasyHttp::Ptr pHttpClient = httpClientBuilder.setCache(pCache).build();
+    Request::Builder requestBuilder;
+    std::string url = HttpTestConstants::DefaultTestUrlWithQuery;
+    Request::Ptr pRequest = requestBuilder.setUrl(url).build();
+
+    Response::Ptr pResponse = pHttpClient->newCall(pRequest)->execute();
+    ASSERT_EQ(Poco::Net::HTTPResponse::HTTP_OK, pResponse->getCode());
+
+    // When: read response body
+    std::string responseBody = pResponse->getBody()->toString();
+
+    // Then: the whole response body is read, and the response is not stored to cache
+    EXPECT_EQ(static_cast<size_t>(BackgroundCacheFillResponseBodyBytes), responseBody.size());
+    HttpCacheDatabase db(new HttpCacheDatabaseOpenHelper(HttpTestUtil::createDatabasePath(cachePath)));
+    EXPECT_TRUE(db.getMetadataAll(HttpUtil::makeCacheKey(Request::HttpMethodGet, url)).isNull());
+    Poco::File responseBodyFile(HttpTestUtil::createCachedResponsedBodyFilePath(cachePath,
+            Request::HttpMethodGet, url));
+    EXPECT_FALSE(responseBodyFile.exists());
+}
+
 } /* namespace test */
 } /* namespace easyhttpcpp */
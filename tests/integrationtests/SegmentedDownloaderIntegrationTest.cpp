@@ -0,0 +1,246 @@
+/*
+ * Copyright 2019 Sony Corporation
+ */
+
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include "Poco/AtomicCounter.h"
+#include "Poco/File.h"
+#include "Poco/NumberFormatter.h"
+#include "Poco/NumberParser.h"
+#include "Poco/Net/HTTPRequestHandler.h"
+#include "Poco/Net/HTTPServerRequest.h"
+#include "Poco/Net/HTTPServerResponse.h"
+
+#include "easyhttpcpp/common/FileUtil.h"
+#include "easyhttpcpp/EasyHttp.h"
+#include "easyhttpcpp/HttpException.h"
+#include "easyhttpcpp/Request.h"
+#include "easyhttpcpp/SegmentedDownloader.h"
+#include "EasyHttpCppAssertions.h"
+#include "HttpTestServer.h"
+#include "TestFileUtil.h"
+#include "TestLogger.h"
+
+#include "HttpIntegrationTestCase.h"
+#include "HttpTestCommonRequestHandler.h"
+#include "HttpTestConstants.h"
+#include "HttpTestUtil.h"
+
+using easyhttpcpp::common::FileUtil;
+using easyhttpcpp::testutil::HttpTestServer;
+using easyhttpcpp::testutil::TestFileUtil;
+
+namespace easyhttpcpp {
+namespace test {
+
+static const std::string Tag = "SegmentedDownloaderIntegrationTest";
+
+static const char* const HeaderAcceptRanges = "Accept-Ranges";
+static const char* const HeaderContentRange = "Content-Range";
+static const char* const HeaderETag = "ETag";
+static const char* const HeaderRange = "Range";
+static const char* const EntityTag = "\"resource-v1\"";
+static const size_t ResourceBytes = 100 * 1000 + 7;
+
+class SegmentedDownloaderIntegrationTest : public HttpIntegrationTestCase {
+protected:
+
+    void SetUp()
+    {
+        m_downloadDir = Poco::Path(HttpTestUtil::getDefaultCachePath());
+        TestFileUtil::setFullAccess(m_downloadDir);
+        FileUtil::removeDirsIfPresent(m_downloadDir);
+        FileUtil::createDirsIfAbsent(Poco::File(m_downloadDir));
+
+        EASYHTTPCPP_TESTLOG_SETUP_END();
+    }
+
+    void TearDown()
+    {
+        EASYHTTPCPP_TESTLOG_TEARDOWN_START();
+
+        TestFileUtil::setFullAccess(m_downloadDir);
+        FileUtil::removeDirsIfPresent(m_downloadDir);
+    }
+
+    static std::string readFile(const Poco::Path& path)
+    {
+        std::ifstream ifs(path.toString().c_str(), std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+    }
+
+    Poco::Path m_downloadDir;
+};
+
+namespace {
+
+std::string createResource()
+{
+    std::string resource;
+    resource.reserve(ResourceBytes);
+    for (size_t i = 0; i < ResourceBytes; i++) {
+        resource.push_back(static_cast<char>('a' + (i % 26)));
+    }
+    return resource;
+}
+
+class RangeRequestHandler : public Poco::Net::HTTPRequestHandler {
+public:
+
+    RangeRequestHandler() : m_resource(createResource())
+    {
+    }
+
+    virtual void handleRequest(Poco::Net::HTTPServerRequest& request, Poco::Net::HTTPServerResponse& response)
+    {
+        response.setContentType(HttpTestConstants::DefaultResponseContentType);
+        response.set(HeaderAcceptRanges, "bytes");
+        response.set(HeaderETag, EntityTag);
+
+        // bytes=<first>-<last>
+        const std::string& range = request.get(HeaderRange, "");
+        if (range.empty()) {
+            response.setStatus(Poco::Net::HTTPResponse::HTTP_OK);
+            response.setContentLength(m_resource.size());
+            std::ostream& ostr = response.send();
+            ostr << m_resource;
+            return;
+        }
+
+        m_rangeRequestCount++;
+        std::string::size_type equal = range.find('=');
+        std::string::size_type dash = range.find('-');
+        size_t first = Poco::NumberParser::parseUnsigned(range.substr(equal + 1, dash - equal - 1));
+        size_t last = Poco::NumberParser::parseUnsigned(range.substr(dash + 1));
+        response.setStatus(Poco::Net::HTTPResponse::HTTP_PARTIAL_CONTENT);
+        response.set(HeaderContentRange, "bytes " + Poco::NumberFormatter::format(first) + "-" +
+                Poco::NumberFormatter::format(last) + "/" + Poco::NumberFormatter::format(m_resource.size()));
+        response.setContentLength(last - first + 1);
+        std::ostream& ostr = response.send();
+        ostr << m_resource.substr(first, last - first + 1);
+    }
+
+    const std::string& getResource() const
+    {
+        return m_resource;
+    }
+
+    int getRangeRequestCount() const
+    {
+        return m_rangeRequestCount.value();
+    }
+
+private:
+    std::string m_resource;
+    Poco::AtomicCounter m_rangeRequestCount;
+};
+
+class RecordingProgressListener : public SegmentedDownloader::ProgressListener {
+public:
+
+    RecordingProgressListener() : m_downloadedBytes(0), m_totalBytes(0)
+    {
+    }
+
+    virtual void onProgress(Poco::UInt64 downloadedBytes, Poco::UInt64 totalBytes)
+    {
+        m_downloadedBytes = downloadedBytes;
+        m_totalBytes = totalBytes;
+    }
+
+    Poco::UInt64 m_downloadedBytes;
+    Poco::UInt64 m_totalBytes;
+};
+
+} /* namespace */
+
+TEST_F(SegmentedDownloaderIntegrationTest, download_WritesWholeResourceBySegments_WhenServerAcceptsRanges)
+{
+    // Given: server accepts byte ranges
+    HttpTestServer testServer;
+    RangeRequestHandler handler;
+    testServer.getTestRequestHandlerFactory().addHandler(HttpTestConstants::DefaultPath, &handler);
+    testServer.start(HttpTestConstants::DefaultPort);
+
+    EasyHttp::Builder httpClientBuilder;
+    EasyHttp::Ptr pHttpClient = httpClientBuilder.build();
+    Poco::AutoPtr<RecordingProgressListener> pProgressListener = new RecordingProgressListener();
+    SegmentedDownloader::Builder downloaderBuilder;
+    SegmentedDownloader::Ptr pDownloader = downloaderBuilder.setSegmentCount(4)
+            .setProgressListener(pProgressListener).build(pHttpClient);
+
+    Request::Builder requestBuilder;
+    Request::Ptr pRequest = requestBuilder.setUrl(HttpTestConstants::DefaultTestUrlWithQuery).build();
+
+    // When: call download()
+    Poco::Path outputPath(m_downloadDir, "download.data");
+    Poco::UInt64 downloadedBytes = pDownloader->download(pRequest, outputPath);
+
+    // Then: file has the whole resource and it was fetched in 4 segments
+    EXPECT_EQ(ResourceBytes, downloadedBytes);
+    EXPECT_EQ(handler.getResource(), readFile(outputPath));
+    EXPECT_EQ(4, handler.getRangeRequestCount());
+    EXPECT_EQ(ResourceBytes, pProgressListener->m_downloadedBytes);
+    EXPECT_EQ(ResourceBytes, pProgressListener->m_totalBytes);
+}
+
+TEST_F(SegmentedDownloaderIntegrationTest, download_SplitsResourceBySegmentSize_WhenSegmentSizeIsSet)
+{
+    // Given: server accepts byte ranges, segment size is 10000 bytes
+    HttpTestServer testServer;
+    RangeRequestHandler handler;
+    testServer.getTestRequestHandlerFactory().addHandler(HttpTestConstants::DefaultPath, &handler);
+    testServer.start(HttpTestConstants::DefaultPort);
+
+    EasyHttp::Builder httpClientBuilder;
+    EasyHttp::Ptr pHttpClient = httpClientBuilder.build();
+    SegmentedDownloader::Builder downloaderBuilder;
+    SegmentedDownloader::Ptr pDownloader = downloaderBuilder.setSegmentCount(3).setSegmentSize(10000)
+            .build(pHttpClient);
+
+    Request::Builder requestBuilder;
+    Request::Ptr pRequest = requestBuilder.setUrl(HttpTestConstants::DefaultTestUrlWithQuery).build();
+
+    // When: call download()
+    Poco::Path outputPath(m_downloadDir, "download.data");
+    Poco::UInt64 downloadedBytes = pDownloader->download(pRequest, outputPath);
+
+    // Then: file has the whole resource and it was fetched in 11 segments
+    EXPECT_EQ(ResourceBytes, downloadedBytes);
+    EXPECT_EQ(handler.getResource(), readFile(outputPath));
+    EXPECT_EQ(11, handler.getRangeRequestCount());
+}
+
+TEST_F(SegmentedDownloaderIntegrationTest, download_WritesResourceWithSingleRequest_WhenServerDoesNotAcceptRanges)
+{
+    // Given: server does not send Accept-Ranges
+    HttpTestServer testServer;
+    HttpTestCommonRequestHandler::OkRequestHandler handler;
+    testServer.getTestRequestHandlerFactory().addHandler(HttpTestConstants::DefaultPath, &handler);
+    testServer.start(HttpTestConstants::DefaultPort);
+
+    EasyHttp::Builder httpClientBuilder;
+    EasyHttp::Ptr pHttpClient = httpClientBuilder.build();
+    SegmentedDownloader::Builder downloaderBuilder;
+    SegmentedDownloader::Ptr pDownloader = downloaderBuilder.build(pHttpClient);
+
+    Request::Builder requestBuilder;
+    Request::Ptr pRequest = requestBuilder.setUrl(HttpTestConstants::DefaultTestUrlWithQuery).build();
+
+    // When: call download()
+    Poco::Path outputPath(m_downloadDir, "download.data");
+    Poco::UInt64 downloadedBytes = pDownloader->download(pRequest, outputPath);
+
+    // Then: file has the response body
+    EXPECT_EQ(strlen(HttpTestConstants::DefaultResponseBody), downloadedBytes);
+    EXPECT_EQ(std::string(HttpTestConstants::DefaultResponseBody), readFile(outputPath));
+}
+
+} /* namespace test */
+} /* namespace easyhttpcpp */
@@ -1536,6 +1536,80 @@ TEST_F(SqliteDatabaseIntegrationTest, setAutoVacuum_Succeeds)
     EXPECT_EQ(SqliteDatabase::AutoVacuumIncremental, pDb->getAutoVacuum());
 }
 
+TEST_F(SqliteDatabaseIntegrationTest, setJournalMode_Succeeds)
+{
+    // Given: create database
+    Poco::Path databaseFilePath(DatabaseDirString, DatabaseFileName);
+    Poco::Data::SQLite::Connector::registerConnector();
+    SqliteDatabase::Ptr pDb = SqliteDatabase::openOrCreateDatabase(databaseFilePath.toString());
+
+    // When: set JournalModeWal
+    EXPECT_EQ(SqliteDatabase::JournalModeDelete, pDb->getJournalMode());
+    pDb->setJournalMode(SqliteDatabase::JournalModeWal);
+
+    // Then: JournalMode has been updated and is kept after reopen
+    EXPECT_EQ(SqliteDatabase::JournalModeWal, pDb->getJournalMode());
+    pDb->close();
+    pDb->reopen();
+    EXPECT_EQ(SqliteDatabase::JournalModeWal, pDb->getJournalMode());
+}
+
+TEST_F(SqliteDatabaseIntegrationTest, setSynchronous_Succeeds)
+{
+    // Given: create database
+    Poco::Path databaseFilePath(DatabaseDirString, DatabaseFileName);
+    Poco::Data::SQLite::Connector::registerConnector();
+    SqliteDatabase::Ptr pDb = SqliteDatabase::openOrCreateDatabase(databaseFilePath.toString());
+
+    // When: set SynchronousNormal
+    EXPECT_EQ(SqliteDatabase::SynchronousFull, pDb->getSynchronous());
+    pDb->setSynchronous(SqliteDatabase::SynchronousNormal);
+
+    // Then: Synchronous has been updated
+    EXPECT_EQ(SqliteDatabase::SynchronousNormal, pDb->getSynchronous());
+}
+
+TEST_F(SqliteDatabaseIntegrationTest, setCacheSize_Succeeds)
+{
+    // Given: create database
+    Poco::Path databaseFilePath(DatabaseDirString, DatabaseFileName);
+    Poco::Data::SQLite::Connector::registerConnector();
+    SqliteDatabase::Ptr pDb = SqliteDatabase::openOrCreateDatabase(databaseFilePath.toString());
+
+    // When: set cache size in KiB
+    pDb->setCacheSize(-1024);
+
+    // Then: cache size has been updated
+    EXPECT_EQ(-1024, pDb->getCacheSize());
+}
+
+TEST_F(SqliteDatabaseIntegrationTest, setMmapSize_DoesNotThrow)
+{
+    // Given: create database
+    Poco::Path databaseFilePath(DatabaseDirString, DatabaseFileName);
+    Poco::Data::SQLite::Connector::registerConnector();
+    SqliteDatabase::Ptr pDb = SqliteDatabase::openOrCreateDatabase(databaseFilePath.toString());
+
+    // When: set mmap size
+    // Then: does not throw (mmap size may be limited by the sqlite build)
+    EXPECT_NO_THROW(pDb->setMmapSize(4 * 1024 * 1024));
+    EXPECT_LE(0, pDb->getMmapSize());
+}
+
+TEST_F(SqliteDatabaseIntegrationTest, setBusyTimeout_Succeeds)
+{
+    // Given: create database
+    Poco::Path databaseFilePath(DatabaseDirString, DatabaseFileName);
+    Poco::Data::SQLite::Connector::registerConnector();
+    SqliteDatabase::Ptr pDb = SqliteDatabase::openOrCreateDatabase(databaseFilePath.toString());
+
+    // When: set busy timeout
+    pDb->setBusyTimeout(3000);
+
+    // Then: busy timeout has been updated
+    EXPECT_EQ(3000U, pDb->getBusyTimeout());
+}
+
 TEST_F(SqliteDatabaseIntegrationTest, setAutoVacuum_ThrowsSqlIllegalStateException_AfterClose)
 {
     // Given: create database
@@ -1550,6 +1624,93 @@ TEST_F(SqliteDatabaseIntegrationTest, setAutoVacuum_ThrowsSqlIllegalStateExcepti
     EASYHTTPCPP_ASSERT_THROW(pDb->setAutoVacuum(SqliteDatabase::AutoVacuumIncremental), SqlIllegalStateException, 100201);
 }
 
+TEST_F(SqliteDatabaseIntegrationTest, compileStatement_ReturnsSameStatement_WhenSqlIsSame)
+{
+    // Given: create database
+    createDefaultDatabaseTable();
+    SqliteDatabase::Ptr pDb = m_pTestUtil->getDatabase();
+    std::string sql = "SELECT Name FROM " + DatabaseTableName + " WHERE Age = ?";
+
+    // When: compile same sql twice
+    SqliteStatement::Ptr pStatement1 = pDb->compileStatement(sql);
+    SqliteStatement::Ptr pStatement2 = pDb->compileStatement(sql);
+
+    // Then: compiled statement is reused
+    EXPECT_EQ(pStatement1.get(), pStatement2.get());
+    EXPECT_EQ(1U, pStatement1->getParameterCount());
+}
+
+TEST_F(SqliteDatabaseIntegrationTest, queryStatement_ReturnsQueryResult_WhenExecutedWithDifferentParameters)
+{
+    // Given: create database and compile statement
+    createDefaultDatabaseTable();
+    SqliteDatabase::Ptr pDb = m_pTestUtil->getDatabase();
+    SqliteStatement::Ptr pStatement = pDb->compileStatement("SELECT Name, Address FROM " + DatabaseTableName +
+            " WHERE Age = ? AND Address = ?");
+
+    // When: execute statement with Age = 12
+    pStatement->bindLongLong(0, 12);
+    pStatement->bindString(1, "Springfield");
+    SqliteCursor::Ptr pCursor1 = pDb->queryStatement(pStatement);
+
+    // Then: Bart is returned
+    ASSERT_TRUE(pCursor1->moveToFirst());
+    EXPECT_EQ(1U, pCursor1->getCount());
+    EXPECT_EQ("Bart Simpson", pCursor1->getString(0));
+    pCursor1->close();
+
+    // When: execute same statement with Age = 10
+    pStatement->bindLongLong(0, 10);
+    SqliteCursor::Ptr pCursor2 = pDb->queryStatement(pStatement);
+
+    // Then: Lisa is returned
+    ASSERT_TRUE(pCursor2->moveToFirst());
+    EXPECT_EQ(1U, pCursor2->getCount());
+    EXPECT_EQ("Lisa Simpson", pCursor2->getString(0));
+}
+
+TEST_F(SqliteDatabaseIntegrationTest, executeUpdateDelete_UpdatesRow_WhenValueContainsQuote)
+{
+    // Given: create database and compile statement
+    createDefaultDatabaseTable();
+    SqliteDatabase::Ptr pDb = m_pTestUtil->getDatabase();
+    SqliteStatement::Ptr pStatement = pDb->compileStatement("UPDATE " + DatabaseTableName +
+            " SET Address = ? WHERE Age = ?");
+
+    // When: execute statement with a value which contains a quote
+    pStatement->bindString(0, "Evergreen's Terrace");
+    pStatement->bindLongLong(1, 10);
+    size_t count = pDb->executeUpdateDelete(pStatement);
+
+    // Then: value is stored as it is
+    EXPECT_EQ(1U, count);
+    std::vector<std::string> columns;
+    columns.push_back("Age");
+    columns.push_back("Name");
+    columns.push_back("Address");
+    columns.push_back("Id");
+    SqliteCursor::Ptr pCursor = queryDatabase(DatabaseTableName, &columns);
+    RowElement expectedExistRows[] = {
+        {1, "Bart Simpson", "Springfield", 12},
+        {2, "Lisa Simpson", "Evergreen's Terrace", 10}
+    };
+    for (size_t i = 0; i < ELEMENT_NUM(expectedExistRows); i++) {
+        EXPECT_TRUE(databaseHasRow(pCursor, expectedExistRows[i]));
+    }
+}
+
+TEST_F(SqliteDatabaseIntegrationTest, bindString_ThrowsSqlIllegalArgumentException_WhenIndexIsOutOfRange)
+{
+    // Given: create database and compile statement
+    createDefaultDatabaseTable();
+    SqliteDatabase::Ptr pDb = m_pTestUtil->getDatabase();
+    SqliteStatement::Ptr pStatement = pDb->compileStatement("DELETE FROM " + DatabaseTableName + " WHERE Age = ?");
+
+    // When: bind to the second parameter
+    // Then: throws SqlIllegalArgumentException
+    EASYHTTPCPP_ASSERT_THROW(pStatement->bindString(1, "a"), SqlIllegalArgumentException, 100200);
+}
+
 } /* namespace test */
 } /* namespace db */
 } /* namespace easyhttpcpp */
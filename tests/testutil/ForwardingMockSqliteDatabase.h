@@ -31,6 +31,15 @@ public:
         ON_CALL(*this, rawQuery(testing::_, testing::_))
                 .WillByDefault(testing::Invoke(m_pDelegate.get(),
                         &easyhttpcpp::db::SqliteDatabase::rawQuery));
+        ON_CALL(*this, compileStatement(testing::_))
+                .WillByDefault(testing::Invoke(m_pDelegate.get(),
+                        &easyhttpcpp::db::SqliteDatabase::compileStatement));
+        ON_CALL(*this, queryStatement(testing::_))
+                .WillByDefault(testing::Invoke(m_pDelegate.get(),
+                        &easyhttpcpp::db::SqliteDatabase::queryStatement));
+        ON_CALL(*this, executeUpdateDelete(testing::_))
+                .WillByDefault(testing::Invoke(m_pDelegate.get(),
+                        &easyhttpcpp::db::SqliteDatabase::executeUpdateDelete));
         ON_CALL(*this, insert(testing::_, testing::_))
                 .WillByDefault(testing::Invoke(m_pDelegate.get(),
                         &easyhttpcpp::db::SqliteDatabase::insert));
@@ -93,6 +102,10 @@ public:
             const bool distinct));
     MOCK_METHOD2(rawQuery, easyhttpcpp::db::SqliteCursor::Ptr(
             const std::string& sql, const std::vector<std::string>* selectionArgs));
+    MOCK_METHOD1(compileStatement, easyhttpcpp::db::SqliteStatement::Ptr(const std::string& sql));
+    MOCK_METHOD1(queryStatement, easyhttpcpp::db::SqliteCursor::Ptr(
+            easyhttpcpp::db::SqliteStatement::Ptr pStatement));
+    MOCK_METHOD1(executeUpdateDelete, size_t(easyhttpcpp::db::SqliteStatement::Ptr pStatement));
     MOCK_METHOD2(insert, void(const std::string& table, const easyhttpcpp::db::ContentValues& values));
     MOCK_METHOD2(replace, void(const std::string& table, const easyhttpcpp::db::ContentValues& initialValues));
     MOCK_METHOD3(deleteRows, size_t(const std::string& table, const std::string* whereClause,
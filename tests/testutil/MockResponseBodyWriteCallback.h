@@ -0,0 +1,27 @@
+/*
+ * Copyright 2019 Sony Corporation
+ */
+
+#ifndef EASYHTTPCPP_TESTUTIL_MOCKRESPONSEBODYWRITECALLBACK_H_INCLUDED
+#define EASYHTTPCPP_TESTUTIL_MOCKRESPONSEBODYWRITECALLBACK_H_INCLUDED
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+
+#include "easyhttpcpp/ResponseBodyWriteCallback.h"
+
+namespace easyhttpcpp {
+namespace testutil {
+
+class MockResponseBodyWriteCallback : public easyhttpcpp::ResponseBodyWriteCallback {
+public:
+    typedef Poco::AutoPtr<MockResponseBodyWriteCallback> Ptr;
+
+    MOCK_METHOD2(onCompleted, void(const Poco::Path& path, Poco::UInt64 writtenBytes));
+    MOCK_METHOD1(onFailure, void(HttpException::Ptr pWhat));
+};
+
+} /* namespace testutil */
+} /* namespace easyhttpcpp */
+
+#endif /* EASYHTTPCPP_TESTUTIL_MOCKRESPONSEBODYWRITECALLBACK_H_INCLUDED */
@@ -679,6 +679,36 @@ TEST(CacheControlUnitTest, createFromHeaders_ReturnsInstance_CacheControlHeaderV
     EXPECT_EQ("", pCacheControl->toString());
 }
 
+TEST(CacheControlUnitTest, createFromHeaders_ReturnsStaleExtensions_WhenStaleWhileRevalidateAndStaleIfErrorExist)
+{
+    // Given: set up headers with RFC 5861 extensions
+    Headers::Ptr pHeaders = new Headers();
+    pHeaders->add("Cache-Control", "max-age=60, stale-while-revalidate=30, stale-if-error=86400");
+
+    // When: call createFromHeaders()
+    CacheControl::Ptr pCacheControl = CacheControl::createFromHeaders(pHeaders);
+
+    // Then: parameters are set from headers
+    EXPECT_EQ(60, pCacheControl->getMaxAgeSec());
+    EXPECT_EQ(30, pCacheControl->getStaleWhileRevalidateSec());
+    EXPECT_EQ(86400, pCacheControl->getStaleIfErrorSec());
+    EXPECT_FALSE(pCacheControl->isMustRevalidate());
+}
+
+TEST(CacheControlUnitTest, createFromHeaders_ReturnsMinusOneForStaleExtensions_WhenTheyDoNotExist)
+{
+    // Given: set up headers without RFC 5861 extensions
+    Headers::Ptr pHeaders = new Headers();
+    pHeaders->add("Cache-Control", "max-age=60");
+
+    // When: call createFromHeaders()
+    CacheControl::Ptr pCacheControl = CacheControl::createFromHeaders(pHeaders);
+
+    // Then: parameters are not set
+    EXPECT_EQ(-1, pCacheControl->getStaleWhileRevalidateSec());
+    EXPECT_EQ(-1, pCacheControl->getStaleIfErrorSec());
+}
+
 TEST(CacheControlBuilderUnitTest, constructor_SetsAllPropertiesToDefault)
 {
     // Given: none
@@ -35,6 +35,12 @@ TEST(EasyHttpContextUnitTest, constructor_ReturnsInstance)
     EXPECT_EQ("", context.getRootCaDirectory());
     EXPECT_EQ("", context.getRootCaFile());
     EXPECT_EQ(CrlCheckPolicyNoCheck, context.getCrlCheckPolicy());
+    EXPECT_EQ(ContentEncodingPolicyIdentity, context.getContentEncodingPolicy());
+    EXPECT_FALSE(context.isRequestCoalescingEnabled());
+    EXPECT_EQ(1000U, context.getRequestCoalescingTimeoutMillis());
+    EXPECT_EQ(CacheFillPolicyDiscardOnClose, context.getCacheFillPolicy());
+    EXPECT_EQ(16U * 1024 * 1024, context.getBackgroundCacheFillMaxBytes());
+    EXPECT_EQ(10U, context.getBackgroundCacheFillTimeoutSec());
     EXPECT_TRUE(context.getCallInterceptors().empty());
     EXPECT_TRUE(context.getNetworkInterceptors().empty());
 }
@@ -150,6 +156,58 @@ TEST(EasyHttpContextUnitTest, setCrlCheckPolicy_StoresValue)
     EXPECT_EQ(CrlCheckPolicyCheckHardFail, context.getCrlCheckPolicy());
 }
 
+TEST(EasyHttpContextUnitTest, setContentEncodingPolicy_StoresValue)
+{
+    // Given: none
+    EasyHttpContext context;
+
+    // When: call setContentEncodingPolicy()
+    context.setContentEncodingPolicy(ContentEncodingPolicyCacheDecompressed);
+
+    // Then: stores value
+    EXPECT_EQ(ContentEncodingPolicyCacheDecompressed, context.getContentEncodingPolicy());
+}
+
+TEST(EasyHttpContextUnitTest, setRequestCoalescingEnabled_StoresValue)
+{
+    // Given: none
+    EasyHttpContext context;
+
+    // When: call setRequestCoalescingEnabled()
+    context.setRequestCoalescingEnabled(true);
+
+    // Then: stores value
+    EXPECT_TRUE(context.isRequestCoalescingEnabled());
+}
+
+TEST(EasyHttpContextUnitTest, setRequestCoalescingTimeoutMillis_StoresValue)
+{
+    // Given: none
+    EasyHttpContext context;
+
+    // When: call setRequestCoalescingTimeoutMillis()
+    context.setRequestCoalescingTimeoutMillis(200);
+
+    // Then: stores value
+    EXPECT_EQ(200U, context.getRequestCoalescingTimeoutMillis());
+}
+
+TEST(EasyHttpContextUnitTest, setCacheFillPolicy_StoresValue)
+{
+    // Given: none
+    EasyHttpContext context;
+
+    // When: call setCacheFillPolicy(), setBackgroundCacheFillMaxBytes() and setBackgroundCacheFillTimeoutSec()
+    context.setCacheFillPolicy(CacheFillPolicyCompleteInBackground);
+    context.setBackgroundCacheFillMaxBytes(1024);
+    context.setBackgroundCacheFillTimeoutSec(30);
+
+    // Then: stores value
+    EXPECT_EQ(CacheFillPolicyCompleteInBackground, context.getCacheFillPolicy());
+    EXPECT_EQ(1024U, context.getBackgroundCacheFillMaxBytes());
+    EXPECT_EQ(30U, context.getBackgroundCacheFillTimeoutSec());
+}
+
 TEST(EasyHttpContextUnitTest, addCallInterceptor_StoresValue)
 {
     // Given: none
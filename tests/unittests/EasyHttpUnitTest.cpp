@@ -54,6 +54,64 @@ TEST(EasyHttpUnitTest, newCall_ThrowsHttpIllegalArgumentException_WhenRequestIsN
     EASYHTTPCPP_EXPECT_THROW(pEasyHttp->newCall(NULL), HttpIllegalArgumentException, 100700);
 }
 
+TEST(EasyHttpUnitTest, prefetch_ThrowsHttpIllegalArgumentException_WhenRequestIsNull)
+{
+    // Given: set cache
+    EasyHttp::Builder builder;
+    EasyHttp::Ptr pEasyHttp = builder.setCache(HttpCache::createCache(Poco::Path(CachePath), CacheMaxSize)).build();
+
+    // When: call prefetch()
+    // Then: throw exception
+    EASYHTTPCPP_EXPECT_THROW(pEasyHttp->prefetch(NULL, PrefetchPriorityNormal), HttpIllegalArgumentException,
+            100700);
+}
+
+TEST(EasyHttpUnitTest, prefetch_ThrowsHttpIllegalArgumentException_WhenRequestIsNotGet)
+{
+    // Given: set cache
+    EasyHttp::Builder builder;
+    EasyHttp::Ptr pEasyHttp = builder.setCache(HttpCache::createCache(Poco::Path(CachePath), CacheMaxSize)).build();
+
+    Request::Builder requestBuilder;
+    Request::Ptr pRequest = requestBuilder.httpDelete().setUrl(Url).build();
+
+    // When: call prefetch()
+    // Then: throw exception
+    EASYHTTPCPP_EXPECT_THROW(pEasyHttp->prefetch(pRequest, PrefetchPriorityNormal), HttpIllegalArgumentException,
+            100700);
+}
+
+TEST(EasyHttpUnitTest, prefetch_ThrowsHttpIllegalStateException_WhenCacheIsNotSet)
+{
+    // Given: cache is not set
+    EasyHttp::Builder builder;
+    EasyHttp::Ptr pEasyHttp = builder.build();
+
+    Request::Builder requestBuilder;
+    Request::Ptr pRequest = requestBuilder.httpGet().setUrl(Url).build();
+
+    // When: call prefetch()
+    // Then: throw exception
+    EASYHTTPCPP_EXPECT_THROW(pEasyHttp->prefetch(pRequest, PrefetchPriorityNormal), HttpIllegalStateException,
+            100701);
+}
+
+TEST(EasyHttpUnitTest, prefetch_ThrowsHttpIllegalStateException_WhenInvalidated)
+{
+    // Given: invalidate EasyHttp
+    EasyHttp::Builder builder;
+    EasyHttp::Ptr pEasyHttp = builder.setCache(HttpCache::createCache(Poco::Path(CachePath), CacheMaxSize)).build();
+    pEasyHttp->invalidateAndCancel();
+
+    Request::Builder requestBuilder;
+    Request::Ptr pRequest = requestBuilder.httpGet().setUrl(Url).build();
+
+    // When: call prefetch()
+    // Then: throw exception
+    EASYHTTPCPP_EXPECT_THROW(pEasyHttp->prefetch(pRequest, PrefetchPriorityNormal), HttpIllegalStateException,
+            100701);
+}
+
 TEST(EasyHttpBuilderUnitTest, constructor_ReturnsInstance)
 {
     // Given: none
@@ -65,10 +123,18 @@ TEST(EasyHttpBuilderUnitTest, constructor_ReturnsInstance)
     EXPECT_EQ(EasyHttpContext::DefaultTimeoutSec, builder.getTimeoutSec());
     EXPECT_TRUE(builder.getCache().isNull());
     EXPECT_EQ(CrlCheckPolicyNoCheck, builder.getCrlCheckPolicy());
+    EXPECT_EQ(ContentEncodingPolicyIdentity, builder.getContentEncodingPolicy());
     EXPECT_EQ("", builder.getRootCaDirectory());
     EXPECT_EQ("", builder.getRootCaFile());
     EXPECT_TRUE(builder.getInterceptors().empty());
     EXPECT_TRUE(builder.getNetworkInterceptors().empty());
+    EXPECT_FALSE(builder.isRequestCoalescingEnabled());
+    EXPECT_EQ(1000U, builder.getRequestCoalescingTimeoutMillis());
+    EXPECT_EQ(CacheFillPolicyDiscardOnClose, builder.getCacheFillPolicy());
+    EXPECT_EQ(16U * 1024 * 1024, builder.getBackgroundCacheFillMaxBytes());
+    EXPECT_EQ(10U, builder.getBackgroundCacheFillTimeoutSec());
+    EXPECT_EQ(1U, builder.getMaxConcurrentPrefetchCount());
+    EXPECT_EQ(0U, builder.getPrefetchBytesPerSec());
 }
 
 TEST(EasyHttpBuilderUnitTest, build_ReturnsEasyHttpInstance)
@@ -84,8 +150,16 @@ TEST(EasyHttpBuilderUnitTest, build_ReturnsEasyHttpInstance)
     EXPECT_EQ(EasyHttpContext::DefaultTimeoutSec, pEasyHttp->getTimeoutSec());
     EXPECT_TRUE(pEasyHttp->getCache().isNull());
     EXPECT_EQ(CrlCheckPolicyNoCheck, pEasyHttp->getCrlCheckPolicy());
+    EXPECT_EQ(ContentEncodingPolicyIdentity, pEasyHttp->getContentEncodingPolicy());
     EXPECT_EQ("", pEasyHttp->getRootCaDirectory());
     EXPECT_EQ("", pEasyHttp->getRootCaFile());
+    EXPECT_FALSE(pEasyHttp->isRequestCoalescingEnabled());
+    EXPECT_EQ(1000U, pEasyHttp->getRequestCoalescingTimeoutMillis());
+    EXPECT_EQ(CacheFillPolicyDiscardOnClose, pEasyHttp->getCacheFillPolicy());
+    EXPECT_EQ(16U * 1024 * 1024, pEasyHttp->getBackgroundCacheFillMaxBytes());
+    EXPECT_EQ(10U, pEasyHttp->getBackgroundCacheFillTimeoutSec());
+    EXPECT_EQ(1U, pEasyHttp->getMaxConcurrentPrefetchCount());
+    EXPECT_EQ(0U, pEasyHttp->getPrefetchBytesPerSec());
 }
 
 TEST(EasyHttpBuilderUnitTest, setProxy_StoresProxy)
@@ -161,6 +235,116 @@ TEST(EasyHttpBuilderUnitTest, setCrlCheckPolicy_StoresValue)
     EXPECT_EQ(CrlCheckPolicyCheckHardFail, pEasyHttp->getCrlCheckPolicy());
 }
 
+TEST(EasyHttpBuilderUnitTest, setContentEncodingPolicy_StoresValue)
+{
+    // Given: none
+    EasyHttp::Builder builder;
+
+    // When: call setContentEncodingPolicy()
+    builder.setContentEncodingPolicy(ContentEncodingPolicyCacheCompressed);
+
+    // Then: stores value
+    EXPECT_EQ(ContentEncodingPolicyCacheCompressed, builder.getContentEncodingPolicy());
+
+    EasyHttp::Ptr pEasyHttp = builder.build();
+    EXPECT_EQ(ContentEncodingPolicyCacheCompressed, pEasyHttp->getContentEncodingPolicy());
+}
+
+TEST(EasyHttpBuilderUnitTest, setRequestCoalescingEnabled_StoresValue)
+{
+    // Given: none
+    EasyHttp::Builder builder;
+
+    // When: call setRequestCoalescingEnabled()
+    builder.setRequestCoalescingEnabled(true);
+
+    // Then: stores value
+    EXPECT_TRUE(builder.isRequestCoalescingEnabled());
+
+    EasyHttp::Ptr pEasyHttp = builder.build();
+    EXPECT_TRUE(pEasyHttp->isRequestCoalescingEnabled());
+}
+
+TEST(EasyHttpBuilderUnitTest, setRequestCoalescingTimeoutMillis_StoresValue)
+{
+    // Given: none
+    EasyHttp::Builder builder;
+
+    // When: call setRequestCoalescingTimeoutMillis()
+    builder.setRequestCoalescingTimeoutMillis(200);
+
+    // Then: stores value
+    EXPECT_EQ(200U, builder.getRequestCoalescingTimeoutMillis());
+
+    EasyHttp::Ptr pEasyHttp = builder.build();
+    EXPECT_EQ(200U, pEasyHttp->getRequestCoalescingTimeoutMillis());
+}
+
+TEST(EasyHttpBuilderUnitTest, setRequestCoalescingTimeoutMillis_ThrowsHttpIllegalArgumentException_WhenValueIs0)
+{
+    // Given: none
+    EasyHttp::Builder builder;
+
+    // When: call setRequestCoalescingTimeoutMillis()
+    // Then: throw exception
+    EASYHTTPCPP_EXPECT_THROW(builder.setRequestCoalescingTimeoutMillis(0), HttpIllegalArgumentException, 100700);
+}
+
+TEST(EasyHttpBuilderUnitTest, setCacheFillPolicy_StoresValue)
+{
+    // Given: none
+    EasyHttp::Builder builder;
+
+    // When: call setCacheFillPolicy()
+    builder.setCacheFillPolicy(CacheFillPolicyCompleteInBackground);
+
+    // Then: stores value
+    EXPECT_EQ(CacheFillPolicyCompleteInBackground, builder.getCacheFillPolicy());
+
+    EasyHttp::Ptr pEasyHttp = builder.build();
+    EXPECT_EQ(CacheFillPolicyCompleteInBackground, pEasyHttp->getCacheFillPolicy());
+}
+
+TEST(EasyHttpBuilderUnitTest, setBackgroundCacheFillMaxBytes_StoresValue)
+{
+    // Given: none
+    EasyHttp::Builder builder;
+
+    // When: call setBackgroundCacheFillMaxBytes()
+    builder.setBackgroundCacheFillMaxBytes(1024 * 1024);
+
+    // Then: stores value
+    EXPECT_EQ(1024U * 1024, builder.getBackgroundCacheFillMaxBytes());
+
+    EasyHttp::Ptr pEasyHttp = builder.build();
+    EXPECT_EQ(1024U * 1024, pEasyHttp->getBackgroundCacheFillMaxBytes());
+}
+
+TEST(EasyHttpBuilderUnitTest, setBackgroundCacheFillTimeoutSec_StoresValue)
+{
+    // Given: none
+    EasyHttp::Builder builder;
+
+    // When: call setBackgroundCacheFillTimeoutSec()
+    builder.setBackgroundCacheFillTimeoutSec(30);
+
+    // Then: stores value
+    EXPECT_EQ(30U, builder.getBackgroundCacheFillTimeoutSec());
+
+    EasyHttp::Ptr pEasyHttp = builder.build();
+    EXPECT_EQ(30U, pEasyHttp->getBackgroundCacheFillTimeoutSec());
+}
+
+TEST(EasyHttpBuilderUnitTest, setBackgroundCacheFillTimeoutSec_ThrowsHttpIllegalArgumentException_WhenValueIs0)
+{
+    // Given: none
+    EasyHttp::Builder builder;
+
+    // When: call setBackgroundCacheFillTimeoutSec()
+    // Then: throw exception
+    EASYHTTPCPP_EXPECT_THROW(builder.setBackgroundCacheFillTimeoutSec(0), HttpIllegalArgumentException, 100700);
+}
+
 TEST(EasyHttpBuilderUnitTest, setRootCaDirectory_StoresValue)
 {
     // Given: none
@@ -301,6 +485,46 @@ TEST(EasyHttpBuilderUnitTest,
     EXPECT_EQ(5, testee.getMaximumPoolSizeOfAsyncThreadPool());
 }
 
+TEST(EasyHttpBuilderUnitTest, setMaxConcurrentPrefetchCount_StoresValue)
+{
+    // Given: none
+    EasyHttp::Builder builder;
+
+    // When: call setMaxConcurrentPrefetchCount()
+    builder.setMaxConcurrentPrefetchCount(3);
+
+    // Then: stores value
+    EXPECT_EQ(3U, builder.getMaxConcurrentPrefetchCount());
+
+    EasyHttp::Ptr pEasyHttp = builder.build();
+    EXPECT_EQ(3U, pEasyHttp->getMaxConcurrentPrefetchCount());
+}
+
+TEST(EasyHttpBuilderUnitTest, setMaxConcurrentPrefetchCount_ThrowsHttpIllegalArgumentException_WhenValueIs0)
+{
+    // Given: none
+    EasyHttp::Builder builder;
+
+    // When: call setMaxConcurrentPrefetchCount()
+    // Then: throw exception
+    EASYHTTPCPP_EXPECT_THROW(builder.setMaxConcurrentPrefetchCount(0), HttpIllegalArgumentException, 100700);
+}
+
+TEST(EasyHttpBuilderUnitTest, setPrefetchBytesPerSec_StoresValue)
+{
+    // Given: none
+    EasyHttp::Builder builder;
+
+    // When: call setPrefetchBytesPerSec()
+    builder.setPrefetchBytesPerSec(64 * 1024);
+
+    // Then: stores value
+    EXPECT_EQ(64U * 1024, builder.getPrefetchBytesPerSec());
+
+    EasyHttp::Ptr pEasyHttp = builder.build();
+    EXPECT_EQ(64U * 1024, pEasyHttp->getPrefetchBytesPerSec());
+}
+
 TEST(EasyHttpBuilderUnitTest, build_ThrowsHttpExecutionException_WhenCorePoolSizeGreaterThanMaximumPooloSize)
 {
     // Given: set CorePoolSize > MaxPoolSize
@@ -0,0 +1,117 @@
+/*
+ * Copyright 2019 Sony Corporation
+ */
+
+#include "gtest/gtest.h"
+
+#include "Poco/Timestamp.h"
+
+#include "easyhttpcpp/Headers.h"
+
+#include "HttpCacheFreshness.h"
+#include "HttpCacheMetadata.h"
+#include "HttpUtil.h"
+
+namespace easyhttpcpp {
+namespace test {
+
+static const char* const DateValue = "Wed, 21 Oct 2015 07:28:00 GMT";
+static const char* const ExpiresValue = "Wed, 21 Oct 2015 08:28:00 GMT";
+static const char* const LastModifiedValue = "Tue, 20 Oct 2015 07:28:00 GMT";
+static const char* const ETagValue = "\"etag-1\"";
+
+namespace {
+
+long long toEpoch(const std::string& date)
+{
+    Poco::Timestamp timestamp;
+    HttpUtil::tryParseDate(date, timestamp);
+    return static_cast<long long>(timestamp.epochTime());
+}
+
+} /* namespace */
+
+TEST(HttpCacheFreshnessUnitTest, createFromHeaders_ParsesDatesAndCacheControl)
+{
+    // Given: headers with all freshness headers
+    Headers::Ptr pHeaders = new Headers();
+    pHeaders->set("Date", DateValue);
+    pHeaders->set("Expires", ExpiresValue);
+    pHeaders->set("Last-Modified", LastModifiedValue);
+    pHeaders->set("Age", "10");
+    pHeaders->set("ETag", ETagValue);
+    pHeaders->set("Cache-Control", "max-age=60, s-maxage=120, no-cache, must-revalidate");
+
+    // When: call createFromHeaders()
+    HttpCacheFreshness::Ptr pFreshness = HttpCacheFreshness::createFromHeaders(pHeaders);
+
+    // Then: values are parsed
+    EXPECT_EQ(toEpoch(DateValue), pFreshness->getResponseDateAtEpoch());
+    EXPECT_EQ(toEpoch(ExpiresValue), pFreshness->getExpiresAtEpoch());
+    EXPECT_EQ(toEpoch(LastModifiedValue), pFreshness->getLastModifiedAtEpoch());
+    EXPECT_EQ(10, pFreshness->getAgeSec());
+    EXPECT_EQ(60, pFreshness->getMaxAgeSec());
+    EXPECT_EQ(120, pFreshness->getSMaxAgeSec());
+    EXPECT_TRUE(pFreshness->isNoCache());
+    EXPECT_TRUE(pFreshness->isMustRevalidate());
+    EXPECT_EQ(ETagValue, pFreshness->getETag());
+    EXPECT_EQ(LastModifiedValue, pFreshness->getLastModified());
+}
+
+TEST(HttpCacheFreshnessUnitTest, createFromHeaders_ReturnsMinusOne_WhenHeadersAreMissingOrInvalid)
+{
+    // Given: headers with invalid date and age
+    Headers::Ptr pHeaders = new Headers();
+    pHeaders->set("Expires", "0");
+    pHeaders->set("Age", "abc");
+
+    // When: call createFromHeaders()
+    HttpCacheFreshness::Ptr pFreshness = HttpCacheFreshness::createFromHeaders(pHeaders);
+
+    // Then: values are not set
+    EXPECT_EQ(-1, pFreshness->getResponseDateAtEpoch());
+    EXPECT_EQ(-1, pFreshness->getExpiresAtEpoch());
+    EXPECT_EQ(-1, pFreshness->getLastModifiedAtEpoch());
+    EXPECT_EQ(-1, pFreshness->getAgeSec());
+    EXPECT_EQ(-1, pFreshness->getMaxAgeSec());
+    EXPECT_FALSE(pFreshness->isNoCache());
+    EXPECT_TRUE(pFreshness->getETag().empty());
+}
+
+TEST(HttpCacheFreshnessUnitTest, getFreshness_DerivesFreshnessFromEncodedHeaders_WhenFreshnessIsNotSet)
+{
+    // Given: metadata with encoded headers
+    Headers::Ptr pHeaders = new Headers();
+    pHeaders->set("Cache-Control", "max-age=3600");
+    HttpCacheMetadata::Ptr pMetadata = new HttpCacheMetadata();
+    pMetadata->setEncodedResponseHeaders(HttpUtil::exchangeHeadersToBinaryStr(pHeaders));
+
+    // When: call getFreshness()
+    HttpCacheFreshness::Ptr pFreshness = pMetadata->getFreshness();
+
+    // Then: freshness is derived from the headers
+    EXPECT_EQ(3600, pFreshness->getMaxAgeSec());
+    EXPECT_EQ("max-age=3600", pMetadata->getResponseHeaders()->getValue("Cache-Control", ""));
+}
+
+TEST(HttpCacheFreshnessUnitTest, getFreshness_ReturnsSetFreshness_WithoutDecodingHeaders)
+{
+    // Given: metadata with encoded headers and freshness
+    Headers::Ptr pHeaders = new Headers();
+    pHeaders->set("Cache-Control", "max-age=3600");
+    HttpCacheMetadata::Ptr pMetadata = new HttpCacheMetadata();
+    pMetadata->setEncodedResponseHeaders(HttpUtil::exchangeHeadersToBinaryStr(pHeaders));
+    HttpCacheFreshness::Ptr pStoredFreshness = new HttpCacheFreshness();
+    pStoredFreshness->setMaxAgeSec(10);
+    pMetadata->setFreshness(pStoredFreshness);
+
+    // When: call getFreshness()
+    HttpCacheFreshness::Ptr pFreshness = pMetadata->getFreshness();
+
+    // Then: set freshness is returned
+    EXPECT_EQ(pStoredFreshness.get(), pFreshness.get());
+    EXPECT_EQ(10, pFreshness->getMaxAgeSec());
+}
+
+} /* namespace test */
+} /* namespace easyhttpcpp */
@@ -2,19 +2,30 @@
  * Copyright 2017 Sony Corporation
  */
 
+#include <cstdlib>
+#include <iterator>
+
 #include "gtest/gtest.h"
 
+#include "Poco/DeflatingStream.h"
 #include "Poco/File.h"
+#include "Poco/FileStream.h"
+#include "Poco/Net/HTTPResponse.h"
 #include "Poco/Path.h"
+#include "Poco/Runnable.h"
+#include "Poco/Thread.h"
 
 #include "easyhttpcpp/common/CommonMacros.h"
 #include "easyhttpcpp/common/FileUtil.h"
 #include "easyhttpcpp/common/StringUtil.h"
+#include "easyhttpcpp/HttpCacheKeyHasher.h"
+#include "easyhttpcpp/HttpConstants.h"
 #include "easyhttpcpp/HttpException.h"
 #include "EasyHttpCppAssertions.h"
 #include "TestFileUtil.h"
 
 #include "HttpCacheInternal.h"
+#include "HttpCacheMetadata.h"
 
 using easyhttpcpp::common::FileUtil;
 using easyhttpcpp::common::StringUtil;
@@ -26,6 +37,99 @@ namespace test {
 static const char* const DefaultCachePath = "/HttpCache/";
 static const size_t DefaultCacheMaxSize = 100;
 static const char* const DefaultCacheTempDirectory = "/HttpCache/cache/temp/";
+static const size_t CompressingCacheMaxSize = 1024 * 1024;
+static const char* const Url = "http://localhost:9982/test";
+static const char* const AnotherUrl = "http://localhost:9982/another";
+
+namespace {
+
+class EndFlightRunner : public Poco::Runnable {
+public:
+    EndFlightRunner(HttpCacheInternal& httpCache, const std::string& key) : m_httpCache(httpCache), m_key(key)
+    {
+    }
+
+    virtual void run()
+    {
+        Poco::Thread::sleep(100);
+        m_httpCache.endFlight(m_key);
+    }
+
+private:
+    HttpCacheInternal& m_httpCache;
+    std::string m_key;
+};
+
+// makes the same key of every request.
+class ConstantCacheKeyHasher : public HttpCacheKeyHasher {
+public:
+    virtual const std::string& getName() const
+    {
+        static const std::string Name = "constant";
+        return Name;
+    }
+    virtual std::string hash(const std::string& /* data */)
+    {
+        return "constant";
+    }
+};
+
+std::string makeTextBody()
+{
+    std::string body;
+    for (int i = 0; i < 1000; i++) {
+        body += StringUtil::format("line %d of a compressible response body.\n", i % 10);
+    }
+    return body;
+}
+
+std::string makeRandomBody()
+{
+    std::string body;
+    for (int i = 0; i < 64 * 1024; i++) {
+        body += static_cast<char>(std::rand() & 0xff);
+    }
+    return body;
+}
+
+std::string writeBodyFile(HttpCacheInternal& httpCache, const std::string& body)
+{
+    std::string filePath = Poco::Path(httpCache.getTempDirectory(), "body.tmp").toString();
+    Poco::FileOutputStream stream(filePath, std::ios::out | std::ios::binary | std::ios::trunc);
+    stream.write(body.data(), body.size());
+    stream.close();
+    return filePath;
+}
+
+std::string writeCompressedBodyFile(HttpCacheInternal& httpCache, const std::string& body)
+{
+    std::string filePath = Poco::Path(httpCache.getTempDirectory(), "body.gz").toString();
+    Poco::FileOutputStream stream(filePath, std::ios::out | std::ios::binary | std::ios::trunc);
+    Poco::DeflatingOutputStream deflatingStream(stream, Poco::DeflatingStreamBuf::STREAM_GZIP);
+    deflatingStream.write(body.data(), body.size());
+    deflatingStream.close();
+    stream.close();
+    return filePath;
+}
+
+std::string readStream(std::istream& stream)
+{
+    return std::string((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+}
+
+HttpCacheMetadata::Ptr putAnotherUrlCache(HttpCacheInternal& httpCache)
+{
+    HttpCacheMetadata::Ptr pMetadata = new HttpCacheMetadata();
+    pMetadata->setKey(httpCache.makeCacheKey(Request::HttpMethodGet, AnotherUrl));
+    pMetadata->setUrl(AnotherUrl);
+    pMetadata->setStatusCode(Poco::Net::HTTPResponse::HTTP_OK);
+    pMetadata->setResponseHeaders(new Headers());
+    pMetadata->setResponseBodySize(3);
+    EXPECT_TRUE(httpCache.getCacheManager()->put(pMetadata->getKey(), pMetadata, writeBodyFile(httpCache, "abc")));
+    return pMetadata;
+}
+
+} /* namespace */
 
 class HttpCacheInternalUnitTest : public testing::Test {
 protected:
@@ -145,5 +249,261 @@ TEST_F(HttpCacheInternalUnitTest, getCacheManager_ReturnsCacheManager)
     EXPECT_FALSE(httpCache.getCacheManager().isNull());
 }
 
+TEST_F(HttpCacheInternalUnitTest, beginFlight_ReturnsFalse_WhenKeyIsAlreadyInFlight)
+{
+    // Given: key1 is in flight
+    Poco::Path path(StringUtil::format("%s%s", EASYHTTPCPP_STRINGIFY_MACRO(RUNTIME_DATA_ROOT), DefaultCachePath));
+    HttpCacheInternal httpCache(path, DefaultCacheMaxSize);
+    ASSERT_TRUE(httpCache.beginFlight("key1"));
+
+    // When: call beginFlight
+    // Then: only the first request of key1 is the leader
+    EXPECT_FALSE(httpCache.beginFlight("key1"));
+    EXPECT_TRUE(httpCache.beginFlight("key2"));
+
+    // the flight can begin again after it ended.
+    httpCache.endFlight("key1");
+    EXPECT_TRUE(httpCache.beginFlight("key1"));
+}
+
+TEST_F(HttpCacheInternalUnitTest, waitFlight_ReturnsTrue_WhenFlightIsEndedByAnotherThread)
+{
+    // Given: key1 is in flight and ended by another thread
+    Poco::Path path(StringUtil::format("%s%s", EASYHTTPCPP_STRINGIFY_MACRO(RUNTIME_DATA_ROOT), DefaultCachePath));
+    HttpCacheInternal httpCache(path, DefaultCacheMaxSize);
+    ASSERT_TRUE(httpCache.beginFlight("key1"));
+    EndFlightRunner runner(httpCache, "key1");
+    Poco::Thread thread;
+    thread.start(runner);
+
+    // When: call waitFlight
+    bool ret = httpCache.waitFlight("key1", 10000);
+    thread.join();
+
+    // Then: waiting ends when the flight ended
+    EXPECT_TRUE(ret);
+    EXPECT_TRUE(httpCache.beginFlight("key1"));
+}
+
+TEST_F(HttpCacheInternalUnitTest, waitFlight_ReturnsFalse_WhenTimedOut)
+{
+    // Given: key1 is in flight
+    Poco::Path path(StringUtil::format("%s%s", EASYHTTPCPP_STRINGIFY_MACRO(RUNTIME_DATA_ROOT), DefaultCachePath));
+    HttpCacheInternal httpCache(path, DefaultCacheMaxSize);
+    ASSERT_TRUE(httpCache.beginFlight("key1"));
+
+    // When: call waitFlight
+    // Then: timed out, and a key which is not in flight does not wait
+    EXPECT_FALSE(httpCache.waitFlight("key1", 50));
+    EXPECT_TRUE(httpCache.waitFlight("key2", 50));
+}
+
+TEST_F(HttpCacheInternalUnitTest, getData_KeepsFileCacheReference_WhenMemoryCacheHitIsReleasedWhileFileStreamIsOpen)
+{
+    // Given: a response body is in the file cache, and a stream of it is open
+    Poco::Path path(StringUtil::format("%s%s", EASYHTTPCPP_STRINGIFY_MACRO(RUNTIME_DATA_ROOT), DefaultCachePath));
+    HttpCacheInternal httpCache(HttpCache::Builder(path, CompressingCacheMaxSize)
+            .setMemoryCacheMaxSize(CompressingCacheMaxSize));
+    easyhttpcpp::common::CacheManager::Ptr pCacheManager = httpCache.getCacheManager();
+    Request::Builder requestBuilder;
+    Request::Ptr pRequest = requestBuilder.setUrl(Url).build();
+    std::string key = httpCache.makeCacheKey(pRequest);
+    HttpCacheMetadata::Ptr pMetadata = new HttpCacheMetadata();
+    pMetadata->setKey(key);
+    pMetadata->setUrl(Url);
+    pMetadata->setStatusCode(Poco::Net::HTTPResponse::HTTP_OK);
+    pMetadata->setResponseHeaders(new Headers());
+    pMetadata->setResponseBodySize(3);
+    ASSERT_TRUE(pCacheManager->put(key, pMetadata, writeBodyFile(httpCache, "old")));
+
+    std::istream* pFileStream = NULL;
+    unsigned int fileCacheIndex = 0;
+    ASSERT_TRUE(pCacheManager->getData(key, pFileStream, fileCacheIndex));
+    ASSERT_EQ(1U, fileCacheIndex);
+
+    // When: the body is read from the memory cache and released, then a new body is put
+    std::istream* pMemoryStream = NULL;
+    unsigned int memoryCacheIndex = 1;
+    ASSERT_TRUE(pCacheManager->getData(key, pMemoryStream, memoryCacheIndex));
+    ASSERT_EQ(0U, memoryCacheIndex);
+    delete pMemoryStream;
+    pCacheManager->releaseData(key, memoryCacheIndex);
+    bool putNewBody = pCacheManager->put(key, pMetadata, writeBodyFile(httpCache, "new"));
+
+    // Then: the file cache still holds the reference of the open stream, so the old body is not replaced
+    EXPECT_FALSE(putNewBody);
+    EXPECT_EQ("old", readStream(*pFileStream));
+    delete pFileStream;
+    pCacheManager->releaseData(key, fileCacheIndex);
+}
+
+TEST_F(HttpCacheInternalUnitTest, useCompressedResponseBody_ReplacesBodyFile_WhenCompressionSavesSpace)
+{
+    // Given: a text response body and its gzip copy
+    Poco::Path path(StringUtil::format("%s%s", EASYHTTPCPP_STRINGIFY_MACRO(RUNTIME_DATA_ROOT), DefaultCachePath));
+    HttpCacheInternal httpCache(HttpCache::Builder(path, CompressingCacheMaxSize)
+            .setBodyCompression(HttpCache::BodyCompressionGzip));
+    std::string body = makeTextBody();
+    std::string bodyFilePath = writeBodyFile(httpCache, body);
+    std::string compressedFilePath = writeCompressedBodyFile(httpCache, body);
+    std::string filePath = bodyFilePath;
+    size_t bodySize = body.size();
+
+    // When: call useCompressedResponseBody
+    // Then: the body file is replaced with the smaller compressed file
+    ASSERT_TRUE(httpCache.useCompressedResponseBody(filePath, bodySize, compressedFilePath));
+    EXPECT_EQ(compressedFilePath, filePath);
+    EXPECT_FALSE(Poco::File(bodyFilePath).exists());
+    EXPECT_LT(bodySize, body.size());
+    EXPECT_EQ(bodySize, Poco::File(filePath).getSize());
+}
+
+TEST_F(HttpCacheInternalUnitTest, useCompressedResponseBody_RemovesCompressedFile_WhenCompressionDoesNotSaveSpace)
+{
+    // Given: a random response body and its gzip copy
+    Poco::Path path(StringUtil::format("%s%s", EASYHTTPCPP_STRINGIFY_MACRO(RUNTIME_DATA_ROOT), DefaultCachePath));
+    HttpCacheInternal httpCache(HttpCache::Builder(path, CompressingCacheMaxSize)
+            .setBodyCompression(HttpCache::BodyCompressionGzip));
+    std::string body = makeRandomBody();
+    std::string bodyFilePath = writeBodyFile(httpCache, body);
+    std::string compressedFilePath = writeCompressedBodyFile(httpCache, body);
+    std::string filePath = bodyFilePath;
+    size_t bodySize = body.size();
+
+    // When: call useCompressedResponseBody
+    // Then: the body file is kept as it is, and the compressed file is removed
+    EXPECT_FALSE(httpCache.useCompressedResponseBody(filePath, bodySize, compressedFilePath));
+    EXPECT_EQ(bodyFilePath, filePath);
+    EXPECT_EQ(body.size(), bodySize);
+    EXPECT_EQ(body.size(), Poco::File(filePath).getSize());
+    EXPECT_FALSE(Poco::File(compressedFilePath).exists());
+}
+
+TEST_F(HttpCacheInternalUnitTest, isCompressingResponseBody_ReturnsTrue_WhenBodyIsTextAndCompressionIsGzip)
+{
+    // Given: gzip body compression
+    Poco::Path path(StringUtil::format("%s%s", EASYHTTPCPP_STRINGIFY_MACRO(RUNTIME_DATA_ROOT), DefaultCachePath));
+    HttpCacheInternal httpCache(HttpCache::Builder(path, CompressingCacheMaxSize)
+            .setBodyCompression(HttpCache::BodyCompressionGzip));
+    Response::Builder builder;
+    Response::Ptr pResponse = builder.setHeader(HttpConstants::HeaderNames::ContentType, "text/plain").build();
+
+    // When: call isCompressingResponseBody
+    // Then: a gzip copy is written
+    EXPECT_TRUE(httpCache.isCompressingResponseBody(pResponse));
+}
+
+TEST_F(HttpCacheInternalUnitTest, isCompressingResponseBody_ReturnsFalse_WhenBodyIsContentEncodedOrCompressionIsNone)
+{
+    // Given: a content-encoded response body, a small response body and a cache without compression
+    Poco::Path path(StringUtil::format("%s%s", EASYHTTPCPP_STRINGIFY_MACRO(RUNTIME_DATA_ROOT), DefaultCachePath));
+    HttpCacheInternal compressingCache(HttpCache::Builder(path, CompressingCacheMaxSize)
+            .setBodyCompression(HttpCache::BodyCompressionGzip));
+    HttpCacheInternal httpCache(path, CompressingCacheMaxSize);
+    Response::Builder encodedBuilder;
+    Response::Ptr pEncodedResponse = encodedBuilder.setHeader(HttpConstants::HeaderNames::ContentEncoding, "br")
+            .build();
+    Response::Builder smallBuilder;
+    Response::Ptr pSmallResponse = smallBuilder.setHasContentLength(true).setContentLength(100).build();
+    Response::Builder builder;
+    Response::Ptr pResponse = builder.build();
+
+    // When: call isCompressingResponseBody
+    // Then: no gzip copy is written
+    EXPECT_FALSE(compressingCache.isCompressingResponseBody(pEncodedResponse));
+    EXPECT_FALSE(compressingCache.isCompressingResponseBody(pSmallResponse));
+    EXPECT_FALSE(httpCache.isCompressingResponseBody(pResponse));
+}
+
+TEST_F(HttpCacheInternalUnitTest, createInputStreamFromCache_DecompressesResponseBody_WhenBodyIsStoredCompressed)
+{
+    // Given: a compressed response body is put in the cache
+    Poco::Path path(StringUtil::format("%s%s", EASYHTTPCPP_STRINGIFY_MACRO(RUNTIME_DATA_ROOT), DefaultCachePath));
+    HttpCacheInternal httpCache(HttpCache::Builder(path, CompressingCacheMaxSize)
+            .setBodyCompression(HttpCache::BodyCompressionGzip));
+    std::string body = makeTextBody();
+    std::string filePath = writeBodyFile(httpCache, body);
+    size_t bodySize = body.size();
+    Request::Builder requestBuilder;
+    Request::Ptr pRequest = requestBuilder.setUrl(Url).build();
+    ASSERT_TRUE(httpCache.useCompressedResponseBody(filePath, bodySize, writeCompressedBodyFile(httpCache, body)));
+
+    HttpCacheMetadata::Ptr pMetadata = new HttpCacheMetadata();
+    pMetadata->setKey(httpCache.makeCacheKey(pRequest));
+    pMetadata->setUrl(Url);
+    pMetadata->setStatusCode(Poco::Net::HTTPResponse::HTTP_OK);
+    pMetadata->setResponseHeaders(new Headers());
+    pMetadata->setResponseBodySize(bodySize);
+    pMetadata->setResponseBodyCompressed(true);
+    ASSERT_TRUE(httpCache.getCacheManager()->put(pMetadata->getKey(), pMetadata, filePath));
+
+    // When: call createInputStreamFromCache
+    unsigned int cacheIndex = 0;
+    std::istream* pStream = httpCache.createInputStreamFromCache(pRequest, cacheIndex);
+
+    // Then: the response body is read decompressed, and the cache size is the compressed size
+    ASSERT_TRUE(pStream != NULL);
+    EXPECT_EQ(body, readStream(*pStream));
+    delete pStream;
+    httpCache.getCacheManager()->releaseData(pMetadata->getKey(), cacheIndex);
+    EXPECT_EQ(bodySize, httpCache.getSize());
+}
+
+TEST_F(HttpCacheInternalUnitTest, createCacheStrategy_ReturnsNoCacheResponse_WhenCacheOfAnotherUrlHasSameKey)
+{
+    // Given: the cache of another url has the same key
+    Poco::Path path(StringUtil::format("%s%s", EASYHTTPCPP_STRINGIFY_MACRO(RUNTIME_DATA_ROOT), DefaultCachePath));
+    HttpCacheInternal httpCache(HttpCache::Builder(path, DefaultCacheMaxSize)
+            .setKeyHasher(new ConstantCacheKeyHasher()));
+    putAnotherUrlCache(httpCache);
+    Request::Builder requestBuilder;
+    Request::Ptr pRequest = requestBuilder.setUrl(Url).build();
+
+    // When: call createCacheStrategy
+    HttpCacheStrategy::Ptr pCacheStrategy = httpCache.createCacheStrategy(pRequest);
+
+    // Then: the cache of another url is not used
+    EXPECT_TRUE(pCacheStrategy->getCachedResponse().isNull());
+    EXPECT_FALSE(pCacheStrategy->getNetworkRequest().isNull());
+}
+
+TEST_F(HttpCacheInternalUnitTest, createInputStreamFromCache_ReturnsNullAndReleasesData_WhenCacheOfAnotherUrlHasSameKey)
+{
+    // Given: the cache of another url has the same key
+    Poco::Path path(StringUtil::format("%s%s", EASYHTTPCPP_STRINGIFY_MACRO(RUNTIME_DATA_ROOT), DefaultCachePath));
+    HttpCacheInternal httpCache(HttpCache::Builder(path, DefaultCacheMaxSize)
+            .setKeyHasher(new ConstantCacheKeyHasher()));
+    HttpCacheMetadata::Ptr pMetadata = putAnotherUrlCache(httpCache);
+    Request::Builder requestBuilder;
+    Request::Ptr pRequest = requestBuilder.setUrl(Url).build();
+
+    // When: call createInputStreamFromCache
+    unsigned int cacheIndex = 0;
+    std::istream* pStream = httpCache.createInputStreamFromCache(pRequest, cacheIndex);
+
+    // Then: returns NULL, and the data is released so that the cache can be replaced
+    EXPECT_TRUE(pStream == NULL);
+    EXPECT_TRUE(httpCache.getCacheManager()->put(pMetadata->getKey(), pMetadata, writeBodyFile(httpCache, "def")));
+}
+
+TEST_F(HttpCacheInternalUnitTest, remove_KeepsCacheOfAnotherUrl_WhenKeyIsSame)
+{
+    // Given: the cache of another url has the same key
+    Poco::Path path(StringUtil::format("%s%s", EASYHTTPCPP_STRINGIFY_MACRO(RUNTIME_DATA_ROOT), DefaultCachePath));
+    HttpCacheInternal httpCache(HttpCache::Builder(path, DefaultCacheMaxSize)
+            .setKeyHasher(new ConstantCacheKeyHasher()));
+    HttpCacheMetadata::Ptr pMetadata = putAnotherUrlCache(httpCache);
+    Request::Builder requestBuilder;
+    Request::Ptr pRequest = requestBuilder.setUrl(Url).build();
+
+    // When: call remove
+    httpCache.remove(pRequest);
+
+    // Then: the cache of another url is kept
+    easyhttpcpp::common::CacheMetadata::Ptr pCacheMetadata;
+    ASSERT_TRUE(httpCache.getCacheManager()->getMetadata(pMetadata->getKey(), pCacheMetadata));
+    EXPECT_EQ(AnotherUrl, static_cast<HttpCacheMetadata*> (pCacheMetadata.get())->getUrl());
+}
+
 } /* namespace test */
 } /* namespace easyhttpcpp */
@@ -33,6 +33,9 @@ static const char* const IfModifiedSinceValue = "Fri, 05 Aug 2016 12:00:00 GMT";
 static const char* const HeaderIfNoneMatch = "If-None-Match";
 static const char* const IfNoneMatchValue = "tag-00001";
 
+static const char* const HeaderRange = "Range";
+static const char* const RangeValue = "bytes=0-99";
+
 static const char* const HeaderLastModified = "Last-Modified";
 static const char* const LastModifiedValue = "Fri, 05 Aug 2016 12:00:00 GMT";
 static const char* const LastModifiedSmall = "Fri, 05 Aug 2016 12:00:00 GMT";
@@ -155,6 +158,17 @@ TEST(HttpCacheStrategyFunctionUnitTest, isAvailableToCache_ReturnsFalse_WhenGetM
     EXPECT_FALSE(HttpCacheStrategy::isAvailableToCache(pRequest));
 }
 
+TEST(HttpCacheStrategyFunctionUnitTest, isAvailableToCache_ReturnsFalse_WhenGetMethodAndRange)
+{
+    // Given: GET Method, Range
+    Request::Builder requestBuilder;
+    Request::Ptr pRequest = requestBuilder.setHeader(HeaderRange, RangeValue).build();
+
+    // When: call isAvailableToCache
+    // Then: return false
+    EXPECT_FALSE(HttpCacheStrategy::isAvailableToCache(pRequest));
+}
+
 TEST(HttpCacheStrategyFunctionUnitTest, isAvailableToCache_ReturnsTrue_WhenGetMethod)
 {
     // Given: GET Method
@@ -85,6 +85,158 @@ TEST(HttpCacheStrategyUnitTest, constructor_getCachedResponseIsNull_WhenCacheRes
     EXPECT_TRUE(httpCacheStrategy.getCachedResponse().isNull());
 }
 
+TEST(HttpCacheStrategyUnitTest, constructor_returnsCachedResponseFromMetadata_WhenFreshnessIsFresh)
+{
+    // Given: metadata with fresh freshness
+    Request::Builder requestBuilder;
+    Request::Ptr pRequest = requestBuilder.setUrl(RequestUrl).build();
+    Poco::Timestamp now;
+    unsigned long long nowAtEpoch = static_cast<unsigned long long>(now.epochTime());
+    Headers::Ptr pHeaders = new Headers();
+    pHeaders->set("Cache-Control", "max-age=3600");
+    pHeaders->set("Content-Length", "10");
+    HttpCacheMetadata::Ptr pMetadata = new HttpCacheMetadata();
+    pMetadata->setStatusCode(200);
+    pMetadata->setStatusMessage("OK");
+    pMetadata->setResponseHeaders(pHeaders);
+    pMetadata->setSentRequestAtEpoch(static_cast<std::time_t>(nowAtEpoch));
+    pMetadata->setReceivedResponseAtEpoch(static_cast<std::time_t>(nowAtEpoch));
+
+    // When: create HttpCacheStrategy
+    HttpCacheStrategy httpCacheStrategy(pRequest, pMetadata, pMetadata->getFreshness(), nowAtEpoch);
+
+    // Then: cached response is created from metadata without network request
+    EXPECT_TRUE(httpCacheStrategy.getNetworkRequest().isNull());
+    Response::Ptr pCachedResponse = httpCacheStrategy.getCachedResponse();
+    ASSERT_FALSE(pCachedResponse.isNull());
+    EXPECT_EQ(200, pCachedResponse->getCode());
+    EXPECT_EQ(10, pCachedResponse->getContentLength());
+}
+
+TEST(HttpCacheStrategyUnitTest, constructor_setsIfNoneMatchFromFreshness_WhenFreshnessIsStale)
+{
+    // Given: metadata with stale freshness which has ETag
+    Request::Builder requestBuilder;
+    Request::Ptr pRequest = requestBuilder.setUrl(RequestUrl).build();
+    Poco::Timestamp now;
+    unsigned long long nowAtEpoch = static_cast<unsigned long long>(now.epochTime());
+    Headers::Ptr pHeaders = new Headers();
+    pHeaders->set("ETag", "\"etag-1\"");
+    HttpCacheMetadata::Ptr pMetadata = new HttpCacheMetadata();
+    pMetadata->setStatusCode(200);
+    pMetadata->setResponseHeaders(pHeaders);
+    pMetadata->setSentRequestAtEpoch(static_cast<std::time_t>(nowAtEpoch - 10));
+    pMetadata->setReceivedResponseAtEpoch(static_cast<std::time_t>(nowAtEpoch - 10));
+
+    // When: create HttpCacheStrategy
+    HttpCacheStrategy httpCacheStrategy(pRequest, pMetadata, pMetadata->getFreshness(), nowAtEpoch);
+
+    // Then: conditional request is made and cached response is kept for revalidation
+    Request::Ptr pNetworkRequest = httpCacheStrategy.getNetworkRequest();
+    ASSERT_FALSE(pNetworkRequest.isNull());
+    EXPECT_EQ("\"etag-1\"", pNetworkRequest->getHeaderValue("If-None-Match", ""));
+    EXPECT_FALSE(httpCacheStrategy.getCachedResponse().isNull());
+}
+
+namespace {
+
+HttpCacheMetadata::Ptr createStaleMetadata(const std::string& cacheControl, unsigned long long nowAtEpoch,
+        unsigned long long ageSec)
+{
+    Headers::Ptr pHeaders = new Headers();
+    pHeaders->set("Cache-Control", cacheControl);
+    pHeaders->set("ETag", "\"etag-1\"");
+    HttpCacheMetadata::Ptr pMetadata = new HttpCacheMetadata();
+    pMetadata->setStatusCode(200);
+    pMetadata->setStatusMessage("OK");
+    pMetadata->setResponseHeaders(pHeaders);
+    pMetadata->setSentRequestAtEpoch(static_cast<std::time_t>(nowAtEpoch - ageSec));
+    pMetadata->setReceivedResponseAtEpoch(static_cast<std::time_t>(nowAtEpoch - ageSec));
+    return pMetadata;
+}
+
+} /* namespace */
+
+TEST(HttpCacheStrategyUnitTest, constructor_returnsStaleResponseAndRevalidationRequest_WhenWithinStaleWhileRevalidate)
+{
+    // Given: metadata which is stale for 10 sec and has stale-while-revalidate=30
+    Request::Builder requestBuilder;
+    Request::Ptr pRequest = requestBuilder.setUrl(RequestUrl).build();
+    Poco::Timestamp now;
+    unsigned long long nowAtEpoch = static_cast<unsigned long long>(now.epochTime());
+    HttpCacheMetadata::Ptr pMetadata = createStaleMetadata("max-age=60, stale-while-revalidate=30", nowAtEpoch, 70);
+
+    // When: create HttpCacheStrategy
+    HttpCacheStrategy httpCacheStrategy(pRequest, pMetadata, pMetadata->getFreshness(), nowAtEpoch);
+
+    // Then: stale cached response is returned without network request and conditional request is made to
+    // revalidate in background
+    EXPECT_TRUE(httpCacheStrategy.getNetworkRequest().isNull());
+    Response::Ptr pCachedResponse = httpCacheStrategy.getCachedResponse();
+    ASSERT_FALSE(pCachedResponse.isNull());
+    EXPECT_TRUE(isExistedWarning(pCachedResponse, "110"));
+    Request::Ptr pRevalidationRequest = httpCacheStrategy.getRevalidationRequest();
+    ASSERT_FALSE(pRevalidationRequest.isNull());
+    EXPECT_EQ("\"etag-1\"", pRevalidationRequest->getHeaderValue("If-None-Match", ""));
+}
+
+TEST(HttpCacheStrategyUnitTest, constructor_returnsNetworkRequest_WhenStaleWhileRevalidateIsExceeded)
+{
+    // Given: metadata which is stale for 40 sec and has stale-while-revalidate=30
+    Request::Builder requestBuilder;
+    Request::Ptr pRequest = requestBuilder.setUrl(RequestUrl).build();
+    Poco::Timestamp now;
+    unsigned long long nowAtEpoch = static_cast<unsigned long long>(now.epochTime());
+    HttpCacheMetadata::Ptr pMetadata = createStaleMetadata("max-age=60, stale-while-revalidate=30", nowAtEpoch, 100);
+
+    // When: create HttpCacheStrategy
+    HttpCacheStrategy httpCacheStrategy(pRequest, pMetadata, pMetadata->getFreshness(), nowAtEpoch);
+
+    // Then: conditional request is sent in foreground
+    EXPECT_FALSE(httpCacheStrategy.getNetworkRequest().isNull());
+    EXPECT_TRUE(httpCacheStrategy.getRevalidationRequest().isNull());
+    EXPECT_TRUE(httpCacheStrategy.getStaleIfErrorResponse().isNull());
+}
+
+TEST(HttpCacheStrategyUnitTest, constructor_returnsStaleIfErrorResponse_WhenWithinStaleIfError)
+{
+    // Given: metadata which is stale for 40 sec and has stale-if-error=3600
+    Request::Builder requestBuilder;
+    Request::Ptr pRequest = requestBuilder.setUrl(RequestUrl).build();
+    Poco::Timestamp now;
+    unsigned long long nowAtEpoch = static_cast<unsigned long long>(now.epochTime());
+    HttpCacheMetadata::Ptr pMetadata = createStaleMetadata("max-age=60, stale-if-error=3600", nowAtEpoch, 100);
+
+    // When: create HttpCacheStrategy
+    HttpCacheStrategy httpCacheStrategy(pRequest, pMetadata, pMetadata->getFreshness(), nowAtEpoch);
+
+    // Then: conditional request is sent and stale response is kept for network error
+    EXPECT_FALSE(httpCacheStrategy.getNetworkRequest().isNull());
+    Response::Ptr pStaleIfErrorResponse = httpCacheStrategy.getStaleIfErrorResponse();
+    ASSERT_FALSE(pStaleIfErrorResponse.isNull());
+    EXPECT_TRUE(isExistedWarning(pStaleIfErrorResponse, "111"));
+    EXPECT_TRUE(isNotExistedWarning(httpCacheStrategy.getCachedResponse(), "111"));
+}
+
+TEST(HttpCacheStrategyUnitTest, constructor_ignoresStaleExtensions_WhenMustRevalidateExists)
+{
+    // Given: metadata which has must-revalidate
+    Request::Builder requestBuilder;
+    Request::Ptr pRequest = requestBuilder.setUrl(RequestUrl).build();
+    Poco::Timestamp now;
+    unsigned long long nowAtEpoch = static_cast<unsigned long long>(now.epochTime());
+    HttpCacheMetadata::Ptr pMetadata = createStaleMetadata(
+            "max-age=60, must-revalidate, stale-while-revalidate=30, stale-if-error=3600", nowAtEpoch, 70);
+
+    // When: create HttpCacheStrategy
+    HttpCacheStrategy httpCacheStrategy(pRequest, pMetadata, pMetadata->getFreshness(), nowAtEpoch);
+
+    // Then: conditional request is sent in foreground without stale response
+    EXPECT_FALSE(httpCacheStrategy.getNetworkRequest().isNull());
+    EXPECT_TRUE(httpCacheStrategy.getRevalidationRequest().isNull());
+    EXPECT_TRUE(httpCacheStrategy.getStaleIfErrorResponse().isNull());
+}
+
 class CheckAgeParam {
 public:
     const char* pUrl;
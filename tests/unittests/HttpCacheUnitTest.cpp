@@ -32,5 +32,61 @@ TEST(HttpCacheUnitTest, create_createsHttpCacheWithPathAndMaxSize_WhenSpecifiedP
     EXPECT_EQ(maxSize, pCache->getMaxSize());
 }
 
+// evictionPolicy 指定
+TEST(HttpCacheUnitTest, build_createsHttpCacheWithPathAndMaxSize_WhenSpecifiedTinyLfuEvictionPolicy)
+{
+    // Given: specified path, maxSize and EvictionPolicyTinyLfu
+    Poco::Path path(DefaultCachePath);
+    size_t maxSize = 100;
+
+    // When: build HttpCache
+    HttpCache::Builder builder(path, maxSize);
+    HttpCache::Ptr pCache = builder.setEvictionPolicy(HttpCache::EvictionPolicyTinyLfu).build();
+
+    // Then: getPath get specified absolute path and maxSize
+    const Poco::Path& gottenPath = pCache->getPath();
+    EXPECT_EQ(path.toString(), gottenPath.toString());
+    EXPECT_EQ(maxSize, pCache->getMaxSize());
+}
+
+TEST(HttpCacheBuilderUnitTest, constructor_ReturnsInstance)
+{
+    // Given: specified path and maxSize
+    Poco::Path path(DefaultCachePath);
+    size_t maxSize = 100;
+
+    // When: call Builder()
+    HttpCache::Builder builder(path, maxSize);
+
+    // Then: initial value is set
+    EXPECT_EQ(path.toString(), builder.getPath().toString());
+    EXPECT_EQ(maxSize, builder.getMaxSize());
+    EXPECT_EQ(0U, builder.getMemoryCacheMaxSize());
+    EXPECT_TRUE(builder.getKeyHasher().isNull());
+    EXPECT_EQ(0U, builder.getInlineBodyMaxSize());
+    EXPECT_EQ(2U, builder.getDataDirFanOutLevels());
+    EXPECT_EQ(HttpCache::EvictionPolicyLru, builder.getEvictionPolicy());
+    EXPECT_EQ(HttpCache::BodyCompressionNone, builder.getBodyCompression());
+}
+
+TEST(HttpCacheBuilderUnitTest, setters_StoreValues)
+{
+    // Given: none
+    HttpCache::Builder builder(Poco::Path(DefaultCachePath), 100);
+    HttpCacheKeyHasher::Ptr pKeyHasher = HttpCacheKeyHasher::createMurmur3Hasher();
+
+    // When: call setters
+    builder.setMemoryCacheMaxSize(10).setKeyHasher(pKeyHasher).setInlineBodyMaxSize(20).setDataDirFanOutLevels(1)
+            .setEvictionPolicy(HttpCache::EvictionPolicyTinyLfu).setBodyCompression(HttpCache::BodyCompressionGzip);
+
+    // Then: getters return the values
+    EXPECT_EQ(10U, builder.getMemoryCacheMaxSize());
+    EXPECT_EQ(pKeyHasher, builder.getKeyHasher());
+    EXPECT_EQ(20U, builder.getInlineBodyMaxSize());
+    EXPECT_EQ(1U, builder.getDataDirFanOutLevels());
+    EXPECT_EQ(HttpCache::EvictionPolicyTinyLfu, builder.getEvictionPolicy());
+    EXPECT_EQ(HttpCache::BodyCompressionGzip, builder.getBodyCompression());
+}
+
 } /* namespace test */
 } /* namespace easyhttpcpp */
@@ -0,0 +1,179 @@
+/*
+ * Copyright 2019 Sony Corporation
+ */
+
+#include <iterator>
+#include <string>
+
+#include "gtest/gtest.h"
+
+#include "Poco/File.h"
+#include "Poco/InflatingStream.h"
+#include "Poco/FileStream.h"
+#include "Poco/Path.h"
+
+#include "easyhttpcpp/common/CommonMacros.h"
+#include "easyhttpcpp/common/FileUtil.h"
+#include "easyhttpcpp/common/StringUtil.h"
+
+#include "HttpCacheWriter.h"
+
+using easyhttpcpp::common::FileUtil;
+using easyhttpcpp::common::StringUtil;
+
+namespace easyhttpcpp {
+namespace test {
+
+static const char* const TestDirectory = "/HttpCacheWriter/";
+static const char* const TestFileName = "body.tmp";
+static const char* const TestCompressedFileName = "body.gz";
+
+class HttpCacheWriterUnitTest : public testing::Test {
+protected:
+
+    void SetUp()
+    {
+        Poco::Path directory(StringUtil::format("%s%s", EASYHTTPCPP_STRINGIFY_MACRO(RUNTIME_DATA_ROOT),
+                TestDirectory));
+        FileUtil::removeDirsIfPresent(directory);
+        Poco::File(directory).createDirectories();
+        m_filePath = Poco::Path(directory, TestFileName).toString();
+        m_compressedFilePath = Poco::Path(directory, TestCompressedFileName).toString();
+    }
+
+    void TearDown()
+    {
+        FileUtil::removeDirsIfPresent(Poco::Path(StringUtil::format("%s%s",
+                EASYHTTPCPP_STRINGIFY_MACRO(RUNTIME_DATA_ROOT), TestDirectory)));
+    }
+
+    HttpCacheWriter::Output::Ptr createOutput()
+    {
+        return new HttpCacheWriter::Output(new Poco::FileOutputStream(m_filePath,
+                std::ios_base::out | std::ios_base::binary | std::ios_base::trunc));
+    }
+
+    HttpCacheWriter::Output::Ptr createCompressingOutput()
+    {
+        return new HttpCacheWriter::Output(new Poco::FileOutputStream(m_filePath,
+                std::ios_base::out | std::ios_base::binary | std::ios_base::trunc),
+                new Poco::FileOutputStream(m_compressedFilePath,
+                std::ios_base::out | std::ios_base::binary | std::ios_base::trunc));
+    }
+
+    std::string readFile()
+    {
+        Poco::FileInputStream stream(m_filePath, std::ios_base::in | std::ios_base::binary);
+        return std::string((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+    }
+
+    std::string readCompressedFile()
+    {
+        Poco::FileInputStream stream(m_compressedFilePath, std::ios_base::in | std::ios_base::binary);
+        Poco::InflatingInputStream inflatingStream(stream, Poco::InflatingStreamBuf::STREAM_GZIP);
+        return std::string((std::istreambuf_iterator<char>(inflatingStream)), std::istreambuf_iterator<char>());
+    }
+
+    std::string m_filePath;
+    std::string m_compressedFilePath;
+};
+
+TEST_F(HttpCacheWriterUnitTest, close_WritesQueuedBytesToFile)
+{
+    // Given: bytes are queued
+    HttpCacheWriter::Ptr pWriter = new HttpCacheWriter(1024);
+    HttpCacheWriter::Output::Ptr pOutput = createOutput();
+    ASSERT_TRUE(pWriter->write(pOutput, "abc", 3, false));
+    ASSERT_TRUE(pWriter->write(pOutput, "def", 3, false));
+
+    // When: call close()
+    // Then: all bytes are written in order
+    EXPECT_TRUE(pWriter->close(pOutput));
+    EXPECT_EQ("abcdef", readFile());
+    EXPECT_EQ(0U, pWriter->getQueuedBytes());
+}
+
+TEST_F(HttpCacheWriterUnitTest, write_AcceptsBytesOverMaxQueuedBytes_WhenNothingIsQueued)
+{
+    // Given: max queued bytes is smaller than the bytes to write
+    HttpCacheWriter::Ptr pWriter = new HttpCacheWriter(4);
+    HttpCacheWriter::Output::Ptr pOutput = createOutput();
+
+    // When: call write() with nothing queued
+    // Then: the bytes are accepted
+    EXPECT_TRUE(pWriter->write(pOutput, "0123456789", 10, false));
+    EXPECT_TRUE(pWriter->close(pOutput));
+    EXPECT_EQ("0123456789", readFile());
+}
+
+TEST_F(HttpCacheWriterUnitTest, write_WaitsForRoom_WhenWaitForRoomIsTrue)
+{
+    // Given: max queued bytes fits only one chunk
+    HttpCacheWriter::Ptr pWriter = new HttpCacheWriter(4);
+    HttpCacheWriter::Output::Ptr pOutput = createOutput();
+
+    // When: call write() repeatedly with waitForRoom
+    std::string expected;
+    for (int i = 0; i < 100; i++) {
+        std::string chunk = StringUtil::format("%04d", i);
+        // Then: no bytes are refused
+        ASSERT_TRUE(pWriter->write(pOutput, chunk.data(), chunk.size(), true));
+        expected += chunk;
+    }
+    EXPECT_TRUE(pWriter->close(pOutput));
+    EXPECT_EQ(expected, readFile());
+}
+
+TEST_F(HttpCacheWriterUnitTest, close_ReturnsFalse_WhenBytesAreQueuedAfterOutputIsClosed)
+{
+    // Given: output is closed
+    HttpCacheWriter::Ptr pWriter = new HttpCacheWriter(1024);
+    HttpCacheWriter::Output::Ptr pOutput = createOutput();
+    ASSERT_TRUE(pWriter->write(pOutput, "abc", 3, false));
+    ASSERT_TRUE(pWriter->close(pOutput));
+
+    // When: call write() and close() again
+    ASSERT_TRUE(pWriter->write(pOutput, "def", 3, true));
+
+    // Then: the late bytes are not written
+    EXPECT_FALSE(pWriter->close(pOutput));
+    EXPECT_EQ("abc", readFile());
+    EXPECT_EQ(0U, pWriter->getQueuedBytes());
+}
+
+TEST_F(HttpCacheWriterUnitTest, close_WritesGzipCopyOfQueuedBytes_WhenOutputHasCompressedStream)
+{
+    // Given: bytes are queued to an output with a compressed stream
+    HttpCacheWriter::Ptr pWriter = new HttpCacheWriter(1024);
+    HttpCacheWriter::Output::Ptr pOutput = createCompressingOutput();
+    std::string expected;
+    for (int i = 0; i < 100; i++) {
+        std::string chunk = StringUtil::format("line %d of a compressible response body.\n", i % 10);
+        ASSERT_TRUE(pWriter->write(pOutput, chunk.data(), chunk.size(), true));
+        expected += chunk;
+    }
+
+    // When: call close()
+    // Then: the bytes are written as they are, and a smaller gzip copy of them is written as well
+    EXPECT_TRUE(pWriter->close(pOutput));
+    EXPECT_TRUE(pOutput->isCompressed());
+    EXPECT_EQ(expected, readFile());
+    EXPECT_EQ(expected, readCompressedFile());
+    EXPECT_GT(expected.size(), Poco::File(m_compressedFilePath).getSize());
+}
+
+TEST_F(HttpCacheWriterUnitTest, isCompressed_ReturnsFalse_WhenOutputHasNoCompressedStream)
+{
+    // Given: bytes are written to an output without a compressed stream
+    HttpCacheWriter::Ptr pWriter = new HttpCacheWriter(1024);
+    HttpCacheWriter::Output::Ptr pOutput = createOutput();
+    ASSERT_TRUE(pWriter->write(pOutput, "abc", 3, false));
+    ASSERT_TRUE(pWriter->close(pOutput));
+
+    // When: call isCompressed()
+    // Then: there is no gzip copy
+    EXPECT_FALSE(pOutput->isCompressed());
+}
+
+} /* namespace test */
+} /* namespace easyhttpcpp */
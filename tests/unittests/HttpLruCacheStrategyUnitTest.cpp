@@ -2,15 +2,22 @@
  * Copyright 2017 Sony Corporation
  */
 
+#include <string>
+#include <vector>
+
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
+#include "Poco/NumberFormatter.h"
+#include "Poco/Timestamp.h"
+
 #include "easyhttpcpp/common/CacheInfoWithDataSize.h"
 #include "easyhttpcpp/common/CacheStrategyListener.h"
 #include "MockCacheStrategyListener.h"
 
 #include "HttpCacheInfo.h"
 #include "HttpLruCacheStrategy.h"
+#include "TestLogger.h"
 
 using easyhttpcpp::common::CacheInfoWithDataSize;
 using easyhttpcpp::common::CacheStrategyListener;
@@ -19,6 +26,7 @@ using easyhttpcpp::testutil::MockCacheStrategyListener;
 namespace easyhttpcpp {
 namespace test {
 
+static const std::string Tag = "HttpLruCacheStrategyUnitTest";
 static const size_t DefaultMaxSise = 500;
 static const char* const Key1 = "key1";
 static const char* const Key2 = "key2";
@@ -824,5 +832,161 @@ TEST_F(HttpLruCacheStrategyUnitTest, clear_ReturnsFalseAndOtherThanFailureRemove
     EXPECT_TRUE(pGottenCacheInfo3.isNull());
 }
 
+// getView
+TEST_F(HttpLruCacheStrategyUnitTest, getView_ReturnsEntryInList_WhenKeyExists)
+{
+    // Given: add to list
+    HttpLruCacheStrategy cacheStrategy(DefaultMaxSise);
+    ASSERT_TRUE(cacheStrategy.add(Key1, new HttpCacheInfo(Key1, DataSize1)));
+    ASSERT_TRUE(cacheStrategy.add(Key2, new HttpCacheInfo(Key2, DataSize2)));
+
+    // When: call getView twice
+    const CacheInfoWithDataSize* pCacheInfo1 = cacheStrategy.getView(Key1);
+    const CacheInfoWithDataSize* pCacheInfo2 = cacheStrategy.getView(Key1);
+
+    // Then: the same entry is returned without copying, and it is moved to the newest position
+    ASSERT_TRUE(pCacheInfo1 != NULL);
+    EXPECT_EQ(pCacheInfo1, pCacheInfo2);
+    EXPECT_EQ(Key1, pCacheInfo1->getKey());
+    EXPECT_EQ(DataSize1, pCacheInfo1->getDataSize());
+    EXPECT_TRUE(pCacheInfo1->getNewer() == NULL);
+    ASSERT_TRUE(pCacheInfo1->getOlder() != NULL);
+    EXPECT_EQ(Key2, pCacheInfo1->getOlder()->getKey());
+}
+
+// getView
+TEST_F(HttpLruCacheStrategyUnitTest, getView_ReturnsNull_WhenKeyDoesNotExist)
+{
+    // Given: add to list
+    HttpLruCacheStrategy cacheStrategy(DefaultMaxSise);
+    ASSERT_TRUE(cacheStrategy.add(Key1, new HttpCacheInfo(Key1, DataSize1)));
+
+    // When: call getView
+    // Then: return NULL
+    EXPECT_TRUE(cacheStrategy.getView(Key2) == NULL);
+}
+
+// update
+TEST_F(HttpLruCacheStrategyUnitTest, update_UpdatesEntryInPlace_WhenKeyExists)
+{
+    // Given: add to list
+    HttpLruCacheStrategy cacheStrategy(DefaultMaxSise);
+    ASSERT_TRUE(cacheStrategy.add(Key1, new HttpCacheInfo(Key1, DataSize1)));
+    const CacheInfoWithDataSize* pCacheInfo = cacheStrategy.getView(Key1);
+
+    // When: call update
+    EXPECT_TRUE(cacheStrategy.update(Key1, new HttpCacheInfo(Key1, DataSize2)));
+
+    // Then: the entry kept in the list is updated
+    EXPECT_EQ(pCacheInfo, cacheStrategy.getView(Key1));
+    EXPECT_EQ(DataSize2, pCacheInfo->getDataSize());
+    EXPECT_EQ(DataSize2, cacheStrategy.getTotalSize());
+}
+
+// addDataRef
+TEST_F(HttpLruCacheStrategyUnitTest, addDataRef_IncrementsDataRefCountOfEntryInList_WhenKeyExists)
+{
+    // Given: add to list
+    HttpLruCacheStrategy cacheStrategy(DefaultMaxSise);
+    ASSERT_TRUE(cacheStrategy.add(Key1, new HttpCacheInfo(Key1, DataSize1)));
+
+    // When: call addDataRef
+    // Then: dataRefCount is incremented
+    EXPECT_TRUE(cacheStrategy.addDataRef(Key1));
+    const HttpCacheInfo* pHttpCacheInfo = static_cast<const HttpCacheInfo*>(cacheStrategy.getView(Key1));
+    EXPECT_EQ(1, pHttpCacheInfo->getDataRefCount());
+    EXPECT_FALSE(cacheStrategy.addDataRef(Key2));
+}
+
+// releaseDataRef
+TEST_F(HttpLruCacheStrategyUnitTest, releaseDataRef_RemovesEntry_WhenDataRefCountBecomesZeroAndRemoveIsReserved)
+{
+    // Given: key1 is referenced and its remove is reserved
+    HttpLruCacheStrategy cacheStrategy(DefaultMaxSise);
+    ASSERT_TRUE(cacheStrategy.add(Key1, new HttpCacheInfo(Key1, DataSize1)));
+    ASSERT_TRUE(cacheStrategy.addDataRef(Key1));
+    ASSERT_TRUE(cacheStrategy.remove(Key1));
+    const HttpCacheInfo* pHttpCacheInfo = static_cast<const HttpCacheInfo*>(cacheStrategy.getView(Key1));
+    ASSERT_TRUE(pHttpCacheInfo != NULL);
+    ASSERT_TRUE(pHttpCacheInfo->isReservedRemove());
+
+    // When: call releaseDataRef
+    // Then: key1 is removed
+    EXPECT_TRUE(cacheStrategy.releaseDataRef(Key1));
+    EXPECT_TRUE(cacheStrategy.getView(Key1) == NULL);
+    EXPECT_EQ(0, cacheStrategy.getTotalSize());
+    EXPECT_TRUE(cacheStrategy.isEmpty());
+}
+
+// releaseDataRef
+TEST_F(HttpLruCacheStrategyUnitTest, releaseDataRef_KeepsEntry_WhenRemoveIsNotReserved)
+{
+    // Given: key1 is referenced
+    HttpLruCacheStrategy cacheStrategy(DefaultMaxSise);
+    ASSERT_TRUE(cacheStrategy.add(Key1, new HttpCacheInfo(Key1, DataSize1)));
+    ASSERT_TRUE(cacheStrategy.addDataRef(Key1));
+
+    // When: call releaseDataRef
+    // Then: dataRefCount is decremented and key1 is kept
+    EXPECT_TRUE(cacheStrategy.releaseDataRef(Key1));
+    const HttpCacheInfo* pHttpCacheInfo = static_cast<const HttpCacheInfo*>(cacheStrategy.getView(Key1));
+    ASSERT_TRUE(pHttpCacheInfo != NULL);
+    EXPECT_EQ(0, pHttpCacheInfo->getDataRefCount());
+    EXPECT_EQ(DataSize1, cacheStrategy.getTotalSize());
+}
+
+// getView
+TEST_F(HttpLruCacheStrategyUnitTest, getView_Benchmark_HitBookkeepingComparedWithGetAndUpdate)
+{
+    // Given: the list is filled with entries
+    static const size_t EntryCount = 1000;
+    static const size_t HitCount = 200000;
+    HttpLruCacheStrategy cacheStrategy(EntryCount * DataSize1);
+    std::vector<std::string> keys;
+    for (size_t i = 0; i < EntryCount; i++) {
+        keys.push_back("key" + Poco::NumberFormatter::format(i));
+        ASSERT_TRUE(cacheStrategy.add(keys.back(), new HttpCacheInfo(keys.back(), DataSize1)));
+    }
+
+    // When: reference and release entries on hits, as HttpFileCache does
+    // the entry is copied by get and update.
+    Poco::Timestamp getAndUpdateStart;
+    for (size_t i = 0; i < HitCount; i++) {
+        const std::string& key = keys[(i * 7) % EntryCount];
+        CacheInfoWithDataSize::Ptr pCacheInfo = cacheStrategy.get(key);
+        HttpCacheInfo* pHttpCacheInfo = static_cast<HttpCacheInfo*>(pCacheInfo.get());
+        pHttpCacheInfo->addDataRef();
+        cacheStrategy.update(key, pCacheInfo);
+        pCacheInfo = cacheStrategy.get(key);
+        pHttpCacheInfo = static_cast<HttpCacheInfo*>(pCacheInfo.get());
+        pHttpCacheInfo->releaseDataRef();
+        cacheStrategy.update(key, pCacheInfo);
+    }
+    Poco::Timestamp::TimeDiff getAndUpdateElapsed = getAndUpdateStart.elapsed();
+
+    // the entry is referenced in place.
+    Poco::Timestamp getViewStart;
+    for (size_t i = 0; i < HitCount; i++) {
+        const std::string& key = keys[(i * 7) % EntryCount];
+        ASSERT_TRUE(cacheStrategy.getView(key) != NULL);
+        cacheStrategy.addDataRef(key);
+        ASSERT_TRUE(cacheStrategy.getView(key) != NULL);
+        cacheStrategy.releaseDataRef(key);
+    }
+    Poco::Timestamp::TimeDiff getViewElapsed = getViewStart.elapsed();
+
+    // Then: the entries are kept in the list
+    EASYHTTPCPP_TESTLOG_I(Tag, "hits: %zu entries: %zu", HitCount, EntryCount);
+    EASYHTTPCPP_TESTLOG_I(Tag, "get and update: %lld usec", static_cast<long long>(getAndUpdateElapsed));
+    EASYHTTPCPP_TESTLOG_I(Tag, "getView and addDataRef/releaseDataRef: %lld usec",
+            static_cast<long long>(getViewElapsed));
+    EXPECT_EQ(EntryCount * DataSize1, cacheStrategy.getTotalSize());
+    for (size_t i = 0; i < EntryCount; i++) {
+        const HttpCacheInfo* pHttpCacheInfo = static_cast<const HttpCacheInfo*>(cacheStrategy.getView(keys[i]));
+        ASSERT_TRUE(pHttpCacheInfo != NULL);
+        EXPECT_EQ(0, pHttpCacheInfo->getDataRefCount());
+    }
+}
+
 } /* namespace test */
 } /* namespace easyhttpcpp */
@@ -0,0 +1,233 @@
+/*
+ * Copyright 2019 Sony Corporation
+ */
+
+#include <iterator>
+#include <string>
+
+#include "gtest/gtest.h"
+
+#include "easyhttpcpp/common/ByteArrayBuffer.h"
+
+#include "HttpCacheMetadata.h"
+#include "HttpMemoryCache.h"
+
+using easyhttpcpp::common::ByteArrayBuffer;
+using easyhttpcpp::common::CacheMetadata;
+
+namespace easyhttpcpp {
+namespace test {
+
+static const std::string Key1 = "key1";
+static const std::string Key2 = "key2";
+static const std::string Url1 = "http://localhost:9982/path1";
+static const std::string Data1 = "test_data1";
+static const std::string Path1 = "/tmp/file.dat";
+static const size_t DefaultMaxSize = 1024;
+static const size_t DefaultMaxDataSize = 256;
+
+namespace {
+
+CacheMetadata::Ptr createMetadata(const std::string& key, size_t responseBodySize)
+{
+    HttpCacheMetadata::Ptr pHttpCacheMetadata = new HttpCacheMetadata();
+    pHttpCacheMetadata->setKey(key);
+    pHttpCacheMetadata->setUrl(Url1);
+    pHttpCacheMetadata->setHttpMethod(Request::HttpMethodGet);
+    pHttpCacheMetadata->setStatusCode(200);
+    pHttpCacheMetadata->setStatusMessage("OK");
+    Headers::Ptr pHeaders = new Headers();
+    pHeaders->set("Cache-Control", "max-age=3600");
+    pHttpCacheMetadata->setResponseHeaders(pHeaders);
+    pHttpCacheMetadata->setResponseBodySize(responseBodySize);
+    return pHttpCacheMetadata;
+}
+
+std::string readAll(std::istream* pStream)
+{
+    std::string data((std::istreambuf_iterator<char>(*pStream)), std::istreambuf_iterator<char>());
+    delete pStream;
+    return data;
+}
+
+} /* namespace */
+
+TEST(HttpMemoryCacheUnitTest, get_ReturnsMetadataAndData_WhenPutWithByteArrayBuffer)
+{
+    // Given: put data
+    HttpMemoryCache memoryCache(DefaultMaxSize, DefaultMaxDataSize);
+    ASSERT_TRUE(memoryCache.put(Key1, createMetadata(Key1, Data1.size()), new ByteArrayBuffer(Data1)));
+
+    // When: call get()
+    CacheMetadata::Ptr pCacheMetadata;
+    std::istream* pStream = NULL;
+    ASSERT_TRUE(memoryCache.get(Key1, pCacheMetadata, pStream));
+
+    // Then: metadata and data are returned
+    HttpCacheMetadata* pHttpCacheMetadata = static_cast<HttpCacheMetadata*>(pCacheMetadata.get());
+    EXPECT_EQ(Key1, pHttpCacheMetadata->getKey());
+    EXPECT_EQ(Url1, pHttpCacheMetadata->getUrl());
+    EXPECT_EQ("max-age=3600", pHttpCacheMetadata->getResponseHeaders()->getValue("Cache-Control", ""));
+    EXPECT_EQ(Data1, readAll(pStream));
+}
+
+TEST(HttpMemoryCacheUnitTest, getMetadata_ReturnsCopy)
+{
+    // Given: put data
+    HttpMemoryCache memoryCache(DefaultMaxSize, DefaultMaxDataSize);
+    ASSERT_TRUE(memoryCache.put(Key1, createMetadata(Key1, Data1.size()), new ByteArrayBuffer(Data1)));
+    CacheMetadata::Ptr pCacheMetadata1;
+    ASSERT_TRUE(memoryCache.getMetadata(Key1, pCacheMetadata1));
+
+    // When: modify got metadata
+    static_cast<HttpCacheMetadata*>(pCacheMetadata1.get())->getResponseHeaders()->set("Cache-Control", "no-cache");
+
+    // Then: held metadata is not modified
+    CacheMetadata::Ptr pCacheMetadata2;
+    ASSERT_TRUE(memoryCache.getMetadata(Key1, pCacheMetadata2));
+    EXPECT_EQ("max-age=3600", static_cast<HttpCacheMetadata*>(pCacheMetadata2.get())->getResponseHeaders()->
+            getValue("Cache-Control", ""));
+}
+
+TEST(HttpMemoryCacheUnitTest, getMetadata_ReturnsHeadersWithoutDecoding_WhenPutWithEncodedHeaders)
+{
+    // Given: put metadata whose headers are encoded. headers in an unknown format are lost when they are decoded,
+    // so they show that the headers are not decoded.
+    HttpMemoryCache memoryCache(DefaultMaxSize, DefaultMaxDataSize);
+    HttpCacheMetadata::Ptr pHttpCacheMetadata = createMetadata(Key1, Data1.size()).unsafeCast<HttpCacheMetadata>();
+    pHttpCacheMetadata->setEncodedResponseHeaders("not decoded");
+    pHttpCacheMetadata->setFreshness(new HttpCacheFreshness());
+    ASSERT_TRUE(memoryCache.put(Key1, pHttpCacheMetadata, new ByteArrayBuffer(Data1)));
+
+    // When: call getMetadata() twice
+    CacheMetadata::Ptr pCacheMetadata1;
+    ASSERT_TRUE(memoryCache.getMetadata(Key1, pCacheMetadata1));
+    CacheMetadata::Ptr pCacheMetadata2;
+    ASSERT_TRUE(memoryCache.getMetadata(Key1, pCacheMetadata2));
+
+    // Then: encoded headers are copied as they are
+    EXPECT_EQ("not decoded", static_cast<HttpCacheMetadata*>(pCacheMetadata1.get())->getEncodedResponseHeaders());
+    EXPECT_EQ("not decoded", static_cast<HttpCacheMetadata*>(pCacheMetadata2.get())->getEncodedResponseHeaders());
+}
+
+TEST(HttpMemoryCacheUnitTest, getData_ReturnsSeekableStream)
+{
+    // Given: put data
+    HttpMemoryCache memoryCache(DefaultMaxSize, DefaultMaxDataSize);
+    ASSERT_TRUE(memoryCache.put(Key1, createMetadata(Key1, Data1.size()), new ByteArrayBuffer(Data1)));
+    std::istream* pStream = NULL;
+    ASSERT_TRUE(memoryCache.getData(Key1, pStream));
+
+    // When: seek stream
+    pStream->seekg(5);
+
+    // Then: rest of data is read
+    EXPECT_FALSE(pStream->fail());
+    EXPECT_EQ(Data1.substr(5), readAll(pStream));
+}
+
+TEST(HttpMemoryCacheUnitTest, getData_ReturnsData_AfterEntryIsRemoved)
+{
+    // Given: stream is got
+    HttpMemoryCache memoryCache(DefaultMaxSize, DefaultMaxDataSize);
+    ASSERT_TRUE(memoryCache.put(Key1, createMetadata(Key1, Data1.size()), new ByteArrayBuffer(Data1)));
+    std::istream* pStream = NULL;
+    ASSERT_TRUE(memoryCache.getData(Key1, pStream));
+
+    // When: remove entry
+    ASSERT_TRUE(memoryCache.remove(Key1));
+
+    // Then: stream still reads the data
+    EXPECT_EQ(Data1, readAll(pStream));
+    CacheMetadata::Ptr pCacheMetadata;
+    EXPECT_FALSE(memoryCache.getMetadata(Key1, pCacheMetadata));
+}
+
+TEST(HttpMemoryCacheUnitTest, putWithByteArrayBuffer_ReturnsFalse_WhenDataExceedsMaxDataSize)
+{
+    // Given: none
+    HttpMemoryCache memoryCache(DefaultMaxSize, DefaultMaxDataSize);
+
+    // When: call put() with large data
+    // Then: returns false
+    std::string largeData(DefaultMaxDataSize + 1, 'a');
+    EXPECT_FALSE(memoryCache.put(Key1, createMetadata(Key1, largeData.size()), new ByteArrayBuffer(largeData)));
+    EXPECT_EQ(0U, memoryCache.getSize());
+}
+
+TEST(HttpMemoryCacheUnitTest, putWithByteArrayBuffer_RemovesLeastRecentlyUsedEntry_WhenMaxSizeIsExceeded)
+{
+    // Given: cache which holds one entry
+    std::string data(DefaultMaxDataSize, 'a');
+    HttpMemoryCache memoryCache(DefaultMaxDataSize + 100, DefaultMaxDataSize);
+    ASSERT_TRUE(memoryCache.put(Key1, createMetadata(Key1, data.size()), new ByteArrayBuffer(data)));
+
+    // When: put another entry
+    ASSERT_TRUE(memoryCache.put(Key2, createMetadata(Key2, data.size()), new ByteArrayBuffer(data)));
+
+    // Then: old entry is removed
+    CacheMetadata::Ptr pCacheMetadata;
+    EXPECT_FALSE(memoryCache.getMetadata(Key1, pCacheMetadata));
+    EXPECT_TRUE(memoryCache.getMetadata(Key2, pCacheMetadata));
+}
+
+TEST(HttpMemoryCacheUnitTest, putWithPath_RemovesEntryAndReturnsFalse)
+{
+    // Given: put data
+    HttpMemoryCache memoryCache(DefaultMaxSize, DefaultMaxDataSize);
+    ASSERT_TRUE(memoryCache.put(Key1, createMetadata(Key1, Data1.size()), new ByteArrayBuffer(Data1)));
+
+    // When: call put() with path
+    // Then: returns false and old entry is removed
+    EXPECT_FALSE(memoryCache.put(Key1, createMetadata(Key1, Data1.size()), Path1));
+    CacheMetadata::Ptr pCacheMetadata;
+    EXPECT_FALSE(memoryCache.getMetadata(Key1, pCacheMetadata));
+    EXPECT_EQ(0U, memoryCache.getSize());
+}
+
+TEST(HttpMemoryCacheUnitTest, putMetadata_UpdatesMetadata_WhenEntryExists)
+{
+    // Given: put data
+    HttpMemoryCache memoryCache(DefaultMaxSize, DefaultMaxDataSize);
+    ASSERT_TRUE(memoryCache.put(Key1, createMetadata(Key1, Data1.size()), new ByteArrayBuffer(Data1)));
+    CacheMetadata::Ptr pNewCacheMetadata = createMetadata(Key1, Data1.size());
+    static_cast<HttpCacheMetadata*>(pNewCacheMetadata.get())->setStatusMessage("Updated");
+
+    // When: call putMetadata()
+    EXPECT_TRUE(memoryCache.putMetadata(Key1, pNewCacheMetadata));
+
+    // Then: metadata is updated
+    CacheMetadata::Ptr pCacheMetadata;
+    ASSERT_TRUE(memoryCache.getMetadata(Key1, pCacheMetadata));
+    EXPECT_EQ("Updated", static_cast<HttpCacheMetadata*>(pCacheMetadata.get())->getStatusMessage());
+}
+
+TEST(HttpMemoryCacheUnitTest, putMetadata_ReturnsFalse_WhenEntryDoesNotExist)
+{
+    // Given: none
+    HttpMemoryCache memoryCache(DefaultMaxSize, DefaultMaxDataSize);
+
+    // When: call putMetadata()
+    // Then: returns false
+    EXPECT_FALSE(memoryCache.putMetadata(Key1, createMetadata(Key1, Data1.size())));
+}
+
+TEST(HttpMemoryCacheUnitTest, purge_RemovesAllEntries)
+{
+    // Given: put data
+    HttpMemoryCache memoryCache(DefaultMaxSize, DefaultMaxDataSize);
+    ASSERT_TRUE(memoryCache.put(Key1, createMetadata(Key1, Data1.size()), new ByteArrayBuffer(Data1)));
+    ASSERT_TRUE(memoryCache.put(Key2, createMetadata(Key2, Data1.size()), new ByteArrayBuffer(Data1)));
+
+    // When: call purge()
+    EXPECT_TRUE(memoryCache.purge(true));
+
+    // Then: all entries are removed
+    CacheMetadata::Ptr pCacheMetadata;
+    EXPECT_FALSE(memoryCache.getMetadata(Key1, pCacheMetadata));
+    EXPECT_FALSE(memoryCache.getMetadata(Key2, pCacheMetadata));
+    EXPECT_EQ(0U, memoryCache.getSize());
+}
+
+} /* namespace test */
+} /* namespace easyhttpcpp */
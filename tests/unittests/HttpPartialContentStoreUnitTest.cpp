@@ -0,0 +1,200 @@
+/*
+ * Copyright 2019 Sony Corporation
+ */
+
+#include "gtest/gtest.h"
+
+#include "Poco/File.h"
+#include "Poco/FileStream.h"
+#include "Poco/Path.h"
+
+#include "easyhttpcpp/common/CommonMacros.h"
+#include "easyhttpcpp/common/FileUtil.h"
+#include "easyhttpcpp/common/StringUtil.h"
+
+#include "HttpPartialContentStore.h"
+
+using easyhttpcpp::common::FileUtil;
+using easyhttpcpp::common::StringUtil;
+
+namespace easyhttpcpp {
+namespace test {
+
+static const char* const DefaultPartialPath = "/HttpPartialContentStore/partial/";
+static const char* const DefaultWorkPath = "/HttpPartialContentStore/work/";
+static const Poco::UInt64 DefaultMaxSize = 100;
+static const std::string Key1 = "key1";
+static const std::string Key2 = "key2";
+static const std::string Url1 = "http://localhost:9982/test1";
+static const std::string Url2 = "http://localhost:9982/test2";
+static const std::string Validator = "\"v1\"";
+
+class HttpPartialContentStoreUnitTest : public testing::Test {
+protected:
+
+    void SetUp()
+    {
+        m_partialDir = Poco::Path(StringUtil::format("%s%s", EASYHTTPCPP_STRINGIFY_MACRO(RUNTIME_DATA_ROOT),
+                DefaultPartialPath));
+        m_workDir = Poco::Path(StringUtil::format("%s%s", EASYHTTPCPP_STRINGIFY_MACRO(RUNTIME_DATA_ROOT),
+                DefaultWorkPath));
+        FileUtil::removeDirsIfPresent(m_partialDir);
+        FileUtil::removeDirsIfPresent(m_workDir);
+        FileUtil::createDirsIfAbsent(Poco::File(m_workDir));
+    }
+
+    void TearDown()
+    {
+        FileUtil::removeDirsIfPresent(m_partialDir);
+        FileUtil::removeDirsIfPresent(m_workDir);
+    }
+
+    std::string createWorkFile(const std::string& name, size_t bytes)
+    {
+        std::string filePath = Poco::Path(m_workDir, name).toString();
+        Poco::FileOutputStream stream(filePath, std::ios::out | std::ios::trunc);
+        stream << std::string(bytes, 'a');
+        stream.close();
+        return filePath;
+    }
+
+    Poco::Path m_partialDir;
+    Poco::Path m_workDir;
+};
+
+TEST_F(HttpPartialContentStoreUnitTest, get_ReturnsPartialContent_WhenPutIsSucceeded)
+{
+    // Given: put partial content
+    HttpPartialContentStore store(m_partialDir, DefaultMaxSize);
+    std::string sourceFilePath = createWorkFile("source", 10);
+    ASSERT_TRUE(store.put(Key1, Url1, sourceFilePath, 50, Validator));
+
+    // When: call get()
+    HttpPartialContent::Ptr pPartialContent = store.get(Key1, Url1);
+
+    // Then: returns stored bytes, complete length and validator. source file is moved.
+    ASSERT_FALSE(pPartialContent.isNull());
+    EXPECT_EQ(Key1, pPartialContent->getKey());
+    EXPECT_EQ(10U, pPartialContent->getStoredBytes());
+    EXPECT_EQ(50U, pPartialContent->getCompleteLength());
+    EXPECT_EQ(Validator, pPartialContent->getValidator());
+    EXPECT_TRUE(Poco::File(pPartialContent->getDataFilePath()).exists());
+    EXPECT_FALSE(Poco::File(sourceFilePath).exists());
+}
+
+TEST_F(HttpPartialContentStoreUnitTest, get_ReturnsNull_WhenNotStored)
+{
+    // Given: nothing is stored
+    HttpPartialContentStore store(m_partialDir, DefaultMaxSize);
+
+    // When: call get()
+    // Then: returns NULL
+    EXPECT_TRUE(store.get(Key1, Url1).isNull());
+}
+
+TEST_F(HttpPartialContentStoreUnitTest, get_ReturnsNull_WhenStoredWithAnotherUrlOfSameKey)
+{
+    // Given: put partial content of Url1
+    HttpPartialContentStore store(m_partialDir, DefaultMaxSize);
+    ASSERT_TRUE(store.put(Key1, Url1, createWorkFile("source", 10), 50, Validator));
+
+    // When: call get() with Url2 of the same key
+    // Then: returns NULL and the entry of Url1 is kept
+    EXPECT_TRUE(store.get(Key1, Url2).isNull());
+    EXPECT_FALSE(store.get(Key1, Url1).isNull());
+}
+
+TEST_F(HttpPartialContentStoreUnitTest, remove_KeepsEntry_WhenStoredWithAnotherUrlOfSameKey)
+{
+    // Given: put partial content of Url1
+    HttpPartialContentStore store(m_partialDir, DefaultMaxSize);
+    ASSERT_TRUE(store.put(Key1, Url1, createWorkFile("source", 10), 50, Validator));
+
+    // When: call remove() with Url2 of the same key
+    store.remove(Key1, Url2);
+
+    // Then: the entry of Url1 is kept
+    EXPECT_FALSE(store.get(Key1, Url1).isNull());
+
+    // When: call remove() with Url1
+    store.remove(Key1, Url1);
+
+    // Then: the entry is removed
+    EXPECT_TRUE(store.get(Key1, Url1).isNull());
+}
+
+TEST_F(HttpPartialContentStoreUnitTest, put_ReturnsFalse_WhenCompleteLengthExceedsMaxSize)
+{
+    // Given: none
+    HttpPartialContentStore store(m_partialDir, DefaultMaxSize);
+    std::string sourceFilePath = createWorkFile("source", 10);
+
+    // When: call put() with complete length larger than max size
+    // Then: returns false and nothing is stored
+    EXPECT_FALSE(store.put(Key1, Url1, sourceFilePath, DefaultMaxSize + 1, Validator));
+    EXPECT_TRUE(store.get(Key1, Url1).isNull());
+}
+
+TEST_F(HttpPartialContentStoreUnitTest, put_RemovesOldestEntry_WhenTotalSizeExceedsMaxSize)
+{
+    // Given: put 60 bytes
+    HttpPartialContentStore store(m_partialDir, DefaultMaxSize);
+    ASSERT_TRUE(store.put(Key1, Url1, createWorkFile("source1", 60), 80, Validator));
+
+    // When: put another 60 bytes
+    ASSERT_TRUE(store.put(Key2, Url2, createWorkFile("source2", 60), 80, Validator));
+
+    // Then: old entry is removed
+    EXPECT_TRUE(store.get(Key1, Url1).isNull());
+    EXPECT_FALSE(store.get(Key2, Url2).isNull());
+}
+
+TEST_F(HttpPartialContentStoreUnitTest, take_MovesDataFileAndRemovesEntry)
+{
+    // Given: put partial content
+    HttpPartialContentStore store(m_partialDir, DefaultMaxSize);
+    ASSERT_TRUE(store.put(Key1, Url1, createWorkFile("source", 10), 50, Validator));
+    HttpPartialContent::Ptr pPartialContent = store.get(Key1, Url1);
+    ASSERT_FALSE(pPartialContent.isNull());
+    std::string destinationFilePath = Poco::Path(m_workDir, "destination").toString();
+
+    // When: call take()
+    // Then: data file is moved and entry is removed
+    EXPECT_TRUE(store.take(pPartialContent, destinationFilePath));
+    Poco::File destinationFile(destinationFilePath);
+    EXPECT_TRUE(destinationFile.exists());
+    EXPECT_EQ(10U, destinationFile.getSize());
+    EXPECT_TRUE(store.get(Key1, Url1).isNull());
+}
+
+TEST_F(HttpPartialContentStoreUnitTest, take_ReturnsFalse_WhenEntryHasBeenReplaced)
+{
+    // Given: entry is replaced after get()
+    HttpPartialContentStore store(m_partialDir, DefaultMaxSize);
+    ASSERT_TRUE(store.put(Key1, Url1, createWorkFile("source1", 10), 50, Validator));
+    HttpPartialContent::Ptr pPartialContent = store.get(Key1, Url1);
+    ASSERT_FALSE(pPartialContent.isNull());
+    ASSERT_TRUE(store.put(Key1, Url1, createWorkFile("source2", 20), 50, Validator));
+
+    // When: call take()
+    // Then: returns false
+    EXPECT_FALSE(store.take(pPartialContent, Poco::Path(m_workDir, "destination").toString()));
+}
+
+TEST_F(HttpPartialContentStoreUnitTest, removeAll_RemovesAllEntries)
+{
+    // Given: put partial contents
+    HttpPartialContentStore store(m_partialDir, DefaultMaxSize);
+    ASSERT_TRUE(store.put(Key1, Url1, createWorkFile("source1", 10), 50, Validator));
+    ASSERT_TRUE(store.put(Key2, Url2, createWorkFile("source2", 10), 50, Validator));
+
+    // When: call removeAll()
+    EXPECT_TRUE(store.removeAll());
+
+    // Then: entries are removed
+    EXPECT_TRUE(store.get(Key1, Url1).isNull());
+    EXPECT_TRUE(store.get(Key2, Url2).isNull());
+}
+
+} /* namespace test */
+} /* namespace easyhttpcpp */
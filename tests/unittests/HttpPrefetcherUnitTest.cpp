@@ -0,0 +1,56 @@
+/*
+ * Copyright 2019 Sony Corporation
+ */
+
+#include "gtest/gtest.h"
+
+#include "EasyHttpContext.h"
+#include "HttpPrefetcher.h"
+
+namespace easyhttpcpp {
+namespace test {
+
+static const unsigned int MaxConcurrentCount = 2;
+
+TEST(HttpPrefetcherUnitTest, reserveBandwidth_ReturnsZero_WhenBandwidthIsUnlimited)
+{
+    // Given: bandwidth is 0 (unlimited)
+    HttpPrefetcher::Ptr pPrefetcher = new HttpPrefetcher(new EasyHttpContext(), MaxConcurrentCount, 0);
+
+    // When: call reserveBandwidth() repeatedly
+    // Then: no need to wait
+    for (size_t i = 0; i < 10; i++) {
+        EXPECT_EQ(0, pPrefetcher->reserveBandwidth(1024 * 1024));
+    }
+}
+
+TEST(HttpPrefetcherUnitTest, reserveBandwidth_ReturnsWaitTime_WhenReservedBytesExceedBandwidth)
+{
+    // Given: bandwidth is 1000 bytes per second
+    HttpPrefetcher::Ptr pPrefetcher = new HttpPrefetcher(new EasyHttpContext(), MaxConcurrentCount, 1000);
+
+    // When: reserve 2000 bytes in 2 calls
+    long firstWaitMillis = pPrefetcher->reserveBandwidth(1000);
+    long secondWaitMillis = pPrefetcher->reserveBandwidth(1000);
+
+    // Then: the first bytes do not wait and the next bytes wait for about 1 second
+    EXPECT_EQ(0, firstWaitMillis);
+    EXPECT_LT(900, secondWaitMillis);
+    EXPECT_GE(1000, secondWaitMillis);
+}
+
+TEST(HttpPrefetcherUnitTest, constructor_HasNoQueuedAndRunningPrefetches)
+{
+    // Given: none
+    // When: create HttpPrefetcher
+    HttpPrefetcher::Ptr pPrefetcher = new HttpPrefetcher(new EasyHttpContext(), MaxConcurrentCount, 0);
+
+    // Then: nothing is queued and running
+    EXPECT_EQ(0U, pPrefetcher->getQueuedCount());
+    EXPECT_EQ(0U, pPrefetcher->getRunningCount());
+    pPrefetcher->cancelAll();
+    EXPECT_EQ(0U, pPrefetcher->getQueuedCount());
+}
+
+} /* namespace test */
+} /* namespace easyhttpcpp */
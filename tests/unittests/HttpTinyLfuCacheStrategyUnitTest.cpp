@@ -0,0 +1,228 @@
+/*
+ * Copyright 2019 Sony Corporation
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "Poco/NumberFormatter.h"
+#include "Poco/Random.h"
+
+#include "easyhttpcpp/common/CacheInfoWithDataSize.h"
+
+#include "HttpCacheInfo.h"
+#include "HttpLruCacheStrategy.h"
+#include "HttpTinyLfuCacheStrategy.h"
+#include "TestLogger.h"
+
+using easyhttpcpp::common::CacheInfoWithDataSize;
+using easyhttpcpp::common::LruCacheByDataSizeStrategy;
+
+namespace easyhttpcpp {
+namespace test {
+
+static const std::string Tag = "HttpTinyLfuCacheStrategyUnitTest";
+static const char* const Key1 = "key1";
+static const char* const Key2 = "key2";
+static const char* const Key3 = "key3";
+static const char* const Key4 = "key4";
+static const size_t DataSize = 100;
+
+namespace {
+
+std::string makeKey(const std::string& prefix, size_t index)
+{
+    return prefix + Poco::NumberFormatter::format(index);
+}
+
+// a missed key is added, as HttpFileCache does after the response is received.
+bool accessCache(LruCacheByDataSizeStrategy& cacheStrategy, const std::string& key, size_t dataSize)
+{
+    if (cacheStrategy.get(key)) {
+        return true;
+    }
+    cacheStrategy.add(key, new HttpCacheInfo(key, dataSize));
+    return false;
+}
+
+// popular keys follow a Zipf distribution; every popularRequestCount requests, scanRequestCount keys which are
+// requested only once are inserted.
+void makeZipfAndScanTrace(size_t popularKeyCount, double exponent, size_t popularRequestCount,
+        size_t scanRequestCount, size_t roundCount, std::vector<std::string>& trace)
+{
+    std::vector<double> cumulativeProbabilities(popularKeyCount);
+    double sum = 0.0;
+    for (size_t i = 0; i < popularKeyCount; i++) {
+        sum += 1.0 / std::pow(static_cast<double>(i + 1), exponent);
+        cumulativeProbabilities[i] = sum;
+    }
+
+    Poco::Random random;
+    random.seed(1);
+    size_t scanKeyIndex = 0;
+    for (size_t round = 0; round < roundCount; round++) {
+        for (size_t i = 0; i < popularRequestCount; i++) {
+            double value = random.nextDouble() * sum;
+            size_t index = std::upper_bound(cumulativeProbabilities.begin(), cumulativeProbabilities.end(), value) -
+                    cumulativeProbabilities.begin();
+            trace.push_back(makeKey("popular", std::min(index, popularKeyCount - 1)));
+        }
+        for (size_t i = 0; i < scanRequestCount; i++) {
+            trace.push_back(makeKey("scan", scanKeyIndex++));
+        }
+    }
+}
+
+double measureHitRatio(LruCacheByDataSizeStrategy& cacheStrategy, const std::vector<std::string>& trace)
+{
+    size_t hitCount = 0;
+    for (std::vector<std::string>::const_iterator it = trace.begin(); it != trace.end(); it++) {
+        if (accessCache(cacheStrategy, *it, DataSize)) {
+            hitCount++;
+        }
+    }
+    return static_cast<double>(hitCount) / trace.size();
+}
+
+} /* namespace */
+
+TEST(HttpTinyLfuCacheStrategyUnitTest, add_KeepsFrequentlyUsedEntries_WhenEntriesUsedOnceAreAdded)
+{
+    // Given: frequently used entries fill the cache
+    HttpTinyLfuCacheStrategy cacheStrategy(DataSize * 10);
+    for (size_t i = 0; i < 9; i++) {
+        accessCache(cacheStrategy, makeKey("popular", i), DataSize);
+    }
+    for (size_t count = 0; count < 3; count++) {
+        for (size_t i = 0; i < 9; i++) {
+            ASSERT_TRUE(accessCache(cacheStrategy, makeKey("popular", i), DataSize));
+        }
+    }
+
+    // When: entries used once are added
+    for (size_t i = 0; i < 20; i++) {
+        accessCache(cacheStrategy, makeKey("scan", i), DataSize);
+    }
+
+    // Then: frequently used entries are kept
+    for (size_t i = 0; i < 9; i++) {
+        EXPECT_FALSE(cacheStrategy.get(makeKey("popular", i)).isNull()) << makeKey("popular", i);
+    }
+    EXPECT_GE(DataSize * 10, cacheStrategy.getTotalSize());
+}
+
+TEST(HttpTinyLfuCacheStrategyUnitTest, add_DoesNotEvictEntry_WhenDataRefCountIsGreaterThanZero)
+{
+    // Given: the cache is full and key1 is referenced
+    HttpTinyLfuCacheStrategy cacheStrategy(DataSize * 3);
+    HttpCacheInfo* pHttpCacheInfo1 = new HttpCacheInfo(Key1, DataSize);
+    pHttpCacheInfo1->addDataRef();
+    ASSERT_TRUE(cacheStrategy.add(Key1, pHttpCacheInfo1));
+    ASSERT_TRUE(cacheStrategy.add(Key2, new HttpCacheInfo(Key2, DataSize)));
+    ASSERT_TRUE(cacheStrategy.add(Key3, new HttpCacheInfo(Key3, DataSize)));
+
+    // When: call add
+    // Then: key2 is evicted instead of key1
+    EXPECT_TRUE(cacheStrategy.add(Key4, new HttpCacheInfo(Key4, DataSize)));
+    EXPECT_EQ(DataSize * 3, cacheStrategy.getTotalSize());
+    EXPECT_FALSE(cacheStrategy.get(Key1).isNull());
+    EXPECT_TRUE(cacheStrategy.get(Key2).isNull());
+    EXPECT_FALSE(cacheStrategy.get(Key3).isNull());
+    EXPECT_FALSE(cacheStrategy.get(Key4).isNull());
+}
+
+TEST(HttpTinyLfuCacheStrategyUnitTest, add_ReturnsFalse_WhenAllEntriesAreReferenced)
+{
+    // Given: the cache is full of referenced entries
+    HttpTinyLfuCacheStrategy cacheStrategy(DataSize * 2);
+    HttpCacheInfo* pHttpCacheInfo1 = new HttpCacheInfo(Key1, DataSize);
+    pHttpCacheInfo1->addDataRef();
+    ASSERT_TRUE(cacheStrategy.add(Key1, pHttpCacheInfo1));
+    HttpCacheInfo* pHttpCacheInfo2 = new HttpCacheInfo(Key2, DataSize);
+    pHttpCacheInfo2->addDataRef();
+    ASSERT_TRUE(cacheStrategy.add(Key2, pHttpCacheInfo2));
+
+    // When: call add
+    // Then: return false and the entries are kept
+    EXPECT_FALSE(cacheStrategy.add(Key3, new HttpCacheInfo(Key3, DataSize)));
+    EXPECT_EQ(DataSize * 2, cacheStrategy.getTotalSize());
+    EXPECT_TRUE(cacheStrategy.get(Key3).isNull());
+}
+
+TEST(HttpTinyLfuCacheStrategyUnitTest, add_EvictsLeastRecentlyUsedEntry_WhenPreviousAddReturnedFalse)
+{
+    // Given: add returned false after key2 could have been moved out of the window, and key1 is released
+    HttpTinyLfuCacheStrategy cacheStrategy(DataSize * 10);
+    HttpCacheInfo* pHttpCacheInfo1 = new HttpCacheInfo(Key1, DataSize * 8);
+    pHttpCacheInfo1->addDataRef();
+    ASSERT_TRUE(cacheStrategy.add(Key1, pHttpCacheInfo1));
+    ASSERT_TRUE(cacheStrategy.add(Key2, new HttpCacheInfo(Key2, DataSize)));
+    ASSERT_FALSE(cacheStrategy.add(Key3, new HttpCacheInfo(Key3, DataSize * 4)));
+    pHttpCacheInfo1->releaseDataRef();
+
+    // When: call add
+    // Then: key1, which is used less recently than key2, is evicted
+    EXPECT_TRUE(cacheStrategy.add(Key4, new HttpCacheInfo(Key4, DataSize * 2)));
+    EXPECT_EQ(DataSize * 3, cacheStrategy.getTotalSize());
+    EXPECT_TRUE(cacheStrategy.get(Key1).isNull());
+    EXPECT_FALSE(cacheStrategy.get(Key2).isNull());
+    EXPECT_FALSE(cacheStrategy.get(Key4).isNull());
+}
+
+TEST(HttpTinyLfuCacheStrategyUnitTest, clear_RemovesAllEntries_WhenEntriesAreInEverySegment)
+{
+    // Given: entries are in the window, probation and protected segments
+    HttpTinyLfuCacheStrategy cacheStrategy(DataSize * 4);
+    for (size_t i = 0; i < 6; i++) {
+        accessCache(cacheStrategy, makeKey("key", i), DataSize);
+        accessCache(cacheStrategy, makeKey("key", i), DataSize);
+    }
+
+    // When: call clear
+    // Then: no entries are left and the cache can be used again
+    EXPECT_TRUE(cacheStrategy.clear(true));
+    EXPECT_EQ(0, cacheStrategy.getTotalSize());
+    EXPECT_TRUE(cacheStrategy.isEmpty());
+    EXPECT_TRUE(cacheStrategy.add(Key1, new HttpCacheInfo(Key1, DataSize * 4)));
+    EXPECT_EQ(DataSize * 4, cacheStrategy.getTotalSize());
+}
+
+TEST(HttpTinyLfuCacheStrategyUnitTest, getFrequency_ReturnsAccessCount_WhenKeyIsGotten)
+{
+    // Given: key1 is gotten 3 times
+    HttpTinyLfuCacheStrategy cacheStrategy(DataSize);
+    for (size_t i = 0; i < 3; i++) {
+        cacheStrategy.get(Key1);
+    }
+
+    // When: call getFrequency
+    // Then: misses are counted too
+    EXPECT_EQ(3, cacheStrategy.getFrequency(Key1));
+    EXPECT_EQ(0, cacheStrategy.getFrequency(Key2));
+}
+
+TEST(HttpTinyLfuCacheStrategyUnitTest, get_Benchmark_HitRatioComparedWithLru)
+{
+    // Given: a trace of popular keys mixed with scans, and a cache of 5% of the popular keys
+    std::vector<std::string> trace;
+    makeZipfAndScanTrace(10000, 0.9, 5000, 2000, 20, trace);
+    HttpLruCacheStrategy lruCacheStrategy(DataSize * 500);
+    HttpTinyLfuCacheStrategy tinyLfuCacheStrategy(DataSize * 500);
+
+    // When: replay the trace
+    double lruHitRatio = measureHitRatio(lruCacheStrategy, trace);
+    double tinyLfuHitRatio = measureHitRatio(tinyLfuCacheStrategy, trace);
+
+    // Then: W-TinyLFU hits more often
+    EASYHTTPCPP_TESTLOG_I(Tag, "requests: %zu", trace.size());
+    EASYHTTPCPP_TESTLOG_I(Tag, "LRU: hit ratio %.3f", lruHitRatio);
+    EASYHTTPCPP_TESTLOG_I(Tag, "W-TinyLFU: hit ratio %.3f", tinyLfuHitRatio);
+    EXPECT_GT(tinyLfuHitRatio, lruHitRatio);
+}
+
+} /* namespace test */
+} /* namespace easyhttpcpp */
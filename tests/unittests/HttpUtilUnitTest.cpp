@@ -2,16 +2,26 @@
  * Copyright 2017 Sony Corporation
  */
 
+#include <iterator>
+#include <sstream>
+
 #include "gtest/gtest.h"
 
+#include "Poco/DeflatingStream.h"
+#include "Poco/SharedPtr.h"
+#include "Poco/Timestamp.h"
+
 #include "easyhttpcpp/common/CommonMacros.h"
+#include "easyhttpcpp/HttpCacheKeyHasher.h"
 #include "easyhttpcpp/HttpException.h"
 
 #include "HttpUtil.h"
+#include "TestLogger.h"
 
 namespace easyhttpcpp {
 namespace test {
 
+static const std::string Tag = "HttpUtilUnitTest";
 static const std::string Url = "http://www.example.com/path/index.html";
 #ifndef _WIN32
 static const std::string GetMethodAndUrlHash = "d4ed7aaa0d5f04fad80bea5c3943741297b0a5d4c256fa1bb56dfeb00321e375";
@@ -20,6 +30,7 @@ static const std::string GetMethodHash = "14e30cd163c732912e048c4c837e15c4e90c06
 static const std::string GetMethodAndUrlHash = "efc0058bfc2909181f382018f9d1e1874333cac2";
 static const std::string GetMethodHash = "f030bbbd32966cde41037b98a8849c46b76e4bc1";
 #endif // !_WIN32
+static const std::string GetMethodAndUrlMurmur3Hash = "000dca1de36ab86d5748735b84e35f03";
 
 static const std::string HeaderName1 = "X-My-Header-Name1";
 static const std::string HeaderName2 = "X-My-Header-Name2";
@@ -138,6 +149,52 @@ TEST(HttpUtilUnitTest, makeCacheKeyWithHttpMethodAndUrl_ReturnsHashedValue_WhenU
     EXPECT_EQ(GetMethodHash, key);
 }
 
+TEST(HttpUtilUnitTest, makeCacheKeyWithHasherAndHttpMethodAndUrl_ReturnsMurmur3Hash_WhenHasherIsMurmur3)
+{
+    // Given: none
+    // When: call makeCacheKey() with the Murmur3 hasher
+    std::string key = HttpUtil::makeCacheKey(HttpCacheKeyHasher::createMurmur3Hasher(), Request::HttpMethodGet, Url);
+
+    // Then: returns Murmur3 hash of HTTP method and url
+    EXPECT_EQ(GetMethodAndUrlMurmur3Hash, key);
+}
+
+TEST(HttpUtilUnitTest, makeCacheKeyWithHasherAndRequest_ReturnsHashOfHasher)
+{
+    // Given: request
+    Request::Builder builder;
+    Request::Ptr request = builder.httpGet().setUrl(Url).build();
+
+    // When: call makeCacheKey() with the Murmur3 hasher
+    std::string key = HttpUtil::makeCacheKey(HttpCacheKeyHasher::createMurmur3Hasher(), request);
+
+    // Then: returns Murmur3 hash of HTTP method and url
+    EXPECT_EQ(GetMethodAndUrlMurmur3Hash, key);
+}
+
+TEST(HttpUtilUnitTest, makeCacheKeyWithHasherAndRequest_ReturnsKeyOfAcceptEncoding_WhenRequestHasAcceptEncoding)
+{
+    // Given: requests with Accept-Encoding
+    Request::Builder builder1;
+    Request::Ptr request1 = builder1.httpGet().setUrl(Url).setHeader("Accept-Encoding", "gzip, deflate").build();
+    Request::Builder builder2;
+    Request::Ptr request2 = builder2.httpGet().setUrl(Url).setHeader("Accept-Encoding", "GZIP,deflate").build();
+    Request::Builder builder3;
+    Request::Ptr request3 = builder3.httpGet().setUrl(Url).setHeader("Accept-Encoding", "identity").build();
+    HttpCacheKeyHasher::Ptr pKeyHasher = HttpCacheKeyHasher::createMurmur3Hasher();
+
+    // When: call makeCacheKey() with the Murmur3 hasher
+    std::string key1 = HttpUtil::makeCacheKey(pKeyHasher, request1);
+    std::string key2 = HttpUtil::makeCacheKey(pKeyHasher, request2);
+    std::string key3 = HttpUtil::makeCacheKey(pKeyHasher, request3);
+
+    // Then: the key differs from the one without Accept-Encoding, ignoring case and spaces of Accept-Encoding
+    EXPECT_NE(GetMethodAndUrlMurmur3Hash, key1);
+    EXPECT_EQ(key1, key2);
+    EXPECT_NE(key1, key3);
+    EXPECT_EQ(key1, HttpUtil::makeCacheKey(pKeyHasher, Request::HttpMethodGet, Url, "gzip, deflate"));
+}
+
 TEST(HttpUtilUnitTest, exchangeJsonStrToHeaders_ReturnsHeadersInstance)
 {
     // Given: none
@@ -221,6 +278,105 @@ TEST(HttpUtilUnitTest, exchangeHeadersToJsonStr_ReturnsEmptyString_WhenHeadersIs
     EXPECT_EQ("", json);
 }
 
+TEST(HttpUtilUnitTest, exchangeBinaryStrToHeaders_ReturnsSameHeaders_WhenEncodedByExchangeHeadersToBinaryStr)
+{
+    // Given: Headers has interned names, other names and repeated names
+    Headers::Ptr pHeaders = new Headers();
+    pHeaders->add("Content-Type", "text/plain");
+    pHeaders->add("content-length", "");
+    pHeaders->add(HeaderName1, HeaderValueFoo);
+    pHeaders->add("Set-Cookie", "a=1");
+    pHeaders->add("Set-Cookie", "b=2");
+    pHeaders->add(HeaderName2, std::string(300, 'x'));
+
+    // When: call exchangeHeadersToBinaryStr() and exchangeBinaryStrToHeaders()
+    std::string encoded = HttpUtil::exchangeHeadersToBinaryStr(pHeaders);
+    Headers::Ptr pDecoded = HttpUtil::exchangeBinaryStrToHeaders(encoded);
+
+    // Then: all headers are restored in order without NUL
+    EXPECT_EQ(std::string::npos, encoded.find('\0'));
+    ASSERT_FALSE(pDecoded.isNull());
+    ASSERT_EQ(pHeaders->getSize(), pDecoded->getSize());
+    Headers::HeaderMap::ConstIterator expected = pHeaders->begin();
+    for (Headers::HeaderMap::ConstIterator it = pDecoded->begin(); it != pDecoded->end(); it++, expected++) {
+        EXPECT_EQ(expected->first, it->first);
+        EXPECT_EQ(expected->second, it->second);
+    }
+}
+
+TEST(HttpUtilUnitTest, exchangeBinaryStrToHeaders_ReturnsEmptyHeaders_WhenHeadersIsEmpty)
+{
+    // Given: none
+    // When: call exchangeBinaryStrToHeaders() with empty Headers
+    Headers::Ptr pDecoded = HttpUtil::exchangeBinaryStrToHeaders(HttpUtil::exchangeHeadersToBinaryStr(new Headers()));
+
+    // Then: returns empty Headers
+    ASSERT_FALSE(pDecoded.isNull());
+    EXPECT_EQ(0, pDecoded->getSize());
+}
+
+TEST(HttpUtilUnitTest, exchangeBinaryStrToHeaders_ReturnsNull_WhenFormatIsInvalid)
+{
+    // Given: encoded headers
+    Headers::Ptr pHeaders = new Headers();
+    pHeaders->add(HeaderName1, HeaderValueFoo);
+    std::string encoded = HttpUtil::exchangeHeadersToBinaryStr(pHeaders);
+
+    // When: call exchangeBinaryStrToHeaders() with broken data
+    // Then: returns NULL
+    EXPECT_TRUE(HttpUtil::exchangeBinaryStrToHeaders("").isNull());
+    EXPECT_TRUE(HttpUtil::exchangeBinaryStrToHeaders(HeadersJson).isNull());
+    EXPECT_TRUE(HttpUtil::exchangeBinaryStrToHeaders(encoded.substr(0, encoded.size() - 1)).isNull());
+    EXPECT_TRUE(HttpUtil::exchangeBinaryStrToHeaders(encoded + "x").isNull());
+}
+
+TEST(HttpUtilUnitTest, exchangeHeadersToBinaryStr_ReturnsEmptyString_WhenHeadersIsNull)
+{
+    // Given: none
+    // When: call exchangeHeadersToBinaryStr()
+    std::string encoded = HttpUtil::exchangeHeadersToBinaryStr(NULL);
+
+    // Then: returns empty string
+    EXPECT_EQ("", encoded);
+}
+
+TEST(HttpUtilUnitTest, exchangeHeadersToBinaryStr_Benchmark_ComparedWithJson)
+{
+    // Given: typical response headers
+    Headers::Ptr pHeaders = new Headers();
+    pHeaders->add("Date", "Fri, 05 Aug 2016 12:00:00 GMT");
+    pHeaders->add("Server", "nginx");
+    pHeaders->add("Content-Type", "text/html; charset=utf-8");
+    pHeaders->add("Content-Length", "12345");
+    pHeaders->add("Cache-Control", "public, max-age=3600");
+    pHeaders->add("ETag", "\"5f3c2a-3039\"");
+    pHeaders->add("Last-Modified", "Thu, 04 Aug 2016 12:00:00 GMT");
+    pHeaders->add("Vary", "Accept-Encoding");
+    pHeaders->add("X-Request-Id", "0f8c7d6e-5b4a-3c2d-1e0f-9a8b7c6d5e4f");
+
+    // When: encode and decode repeatedly
+    static const int Iterations = 10000;
+    std::string json = HttpUtil::exchangeHeadersToJsonStr(pHeaders);
+    std::string binary = HttpUtil::exchangeHeadersToBinaryStr(pHeaders);
+    Poco::Timestamp jsonStart;
+    for (int i = 0; i < Iterations; i++) {
+        ASSERT_FALSE(HttpUtil::exchangeJsonStrToHeaders(HttpUtil::exchangeHeadersToJsonStr(pHeaders)).isNull());
+    }
+    Poco::Timestamp::TimeDiff jsonElapsed = jsonStart.elapsed();
+    Poco::Timestamp binaryStart;
+    for (int i = 0; i < Iterations; i++) {
+        ASSERT_FALSE(HttpUtil::exchangeBinaryStrToHeaders(HttpUtil::exchangeHeadersToBinaryStr(pHeaders)).isNull());
+    }
+    Poco::Timestamp::TimeDiff binaryElapsed = binaryStart.elapsed();
+
+    // Then: binary is smaller; log time and bytes
+    EXPECT_LT(binary.size(), json.size());
+    EASYHTTPCPP_TESTLOG_I(Tag, "json: %zu bytes, %.2f us/round trip", json.size(),
+            static_cast<double>(jsonElapsed) / Iterations);
+    EASYHTTPCPP_TESTLOG_I(Tag, "binary: %zu bytes, %.2f us/round trip", binary.size(),
+            static_cast<double>(binaryElapsed) / Iterations);
+}
+
 TEST(HttpUtilUnitTest, makeCachedResponseBodyFilename_ReturnsFilename_WhenSpecifiedCacheRootDirAndKey)
 {
     std::string cacheRootDirStr = std::string(EASYHTTPCPP_STRINGIFY_MACRO(RUNTIME_DATA_ROOT)) + "/test/";
@@ -230,6 +386,208 @@ TEST(HttpUtilUnitTest, makeCachedResponseBodyFilename_ReturnsFilename_WhenSpecif
             HttpUtil::makeCachedResponseBodyFilename(cacheRootDir, Key1));
 }
 
+TEST(HttpUtilUnitTest, makeCachedResponseBodyFilename_ReturnsFilenameInDataDirs_WhenFanOutLevelsIsSpecified)
+{
+    std::string cacheRootDirStr = std::string(EASYHTTPCPP_STRINGIFY_MACRO(RUNTIME_DATA_ROOT)) + "/test/";
+    Poco::Path cacheRootDir(cacheRootDirStr);
+    std::string key = "0123456789abcdef";
+    std::string expectedFileName = Poco::Path(cacheRootDirStr + "01/23/" + key + CacheDataFileExtention).toString();
+    EXPECT_EQ(expectedFileName, HttpUtil::makeCachedResponseBodyFilename(cacheRootDir, key, 2));
+}
+
+TEST(HttpUtilUnitTest, makeCachedResponseBodyFilename_ReturnsFilenameInCacheRootDir_WhenFanOutLevelsIsZero)
+{
+    std::string cacheRootDirStr = std::string(EASYHTTPCPP_STRINGIFY_MACRO(RUNTIME_DATA_ROOT)) + "/test/";
+    Poco::Path cacheRootDir(cacheRootDirStr);
+    std::string key = "0123456789abcdef";
+    std::string expectedFileName = Poco::Path(cacheRootDirStr + key + CacheDataFileExtention).toString();
+    EXPECT_EQ(expectedFileName, HttpUtil::makeCachedResponseBodyFilename(cacheRootDir, key, 0));
+}
+
+TEST(HttpUtilUnitTest, tryParseRange_ReturnsTrue_WhenFirstAndLastBytePosAreSpecified)
+{
+    // Given: none
+    Poco::UInt64 firstBytePos = 0;
+    Poco::UInt64 lastBytePos = 0;
+
+    // When: call tryParseRange()
+    // Then: returns the range
+    EXPECT_TRUE(HttpUtil::tryParseRange("bytes=10-19", 100, firstBytePos, lastBytePos));
+    EXPECT_EQ(10U, firstBytePos);
+    EXPECT_EQ(19U, lastBytePos);
+}
+
+TEST(HttpUtilUnitTest, tryParseRange_ReturnsRangeToEnd_WhenLastBytePosIsOmittedOrTooLarge)
+{
+    // Given: none
+    Poco::UInt64 firstBytePos = 0;
+    Poco::UInt64 lastBytePos = 0;
+
+    // When: call tryParseRange()
+    // Then: last byte pos is the end of the content
+    EXPECT_TRUE(HttpUtil::tryParseRange("bytes=90-", 100, firstBytePos, lastBytePos));
+    EXPECT_EQ(90U, firstBytePos);
+    EXPECT_EQ(99U, lastBytePos);
+    EXPECT_TRUE(HttpUtil::tryParseRange("bytes=90-1000", 100, firstBytePos, lastBytePos));
+    EXPECT_EQ(90U, firstBytePos);
+    EXPECT_EQ(99U, lastBytePos);
+}
+
+TEST(HttpUtilUnitTest, tryParseRange_ReturnsLastBytes_WhenSuffixLengthIsSpecified)
+{
+    // Given: none
+    Poco::UInt64 firstBytePos = 0;
+    Poco::UInt64 lastBytePos = 0;
+
+    // When: call tryParseRange()
+    // Then: returns the last bytes
+    EXPECT_TRUE(HttpUtil::tryParseRange("bytes=-30", 100, firstBytePos, lastBytePos));
+    EXPECT_EQ(70U, firstBytePos);
+    EXPECT_EQ(99U, lastBytePos);
+    EXPECT_TRUE(HttpUtil::tryParseRange("bytes=-300", 100, firstBytePos, lastBytePos));
+    EXPECT_EQ(0U, firstBytePos);
+    EXPECT_EQ(99U, lastBytePos);
+}
+
+TEST(HttpUtilUnitTest, tryParseRange_ReturnsFalse_WhenRangeIsInvalidOrNotSatisfiable)
+{
+    // Given: none
+    Poco::UInt64 firstBytePos = 0;
+    Poco::UInt64 lastBytePos = 0;
+
+    // When: call tryParseRange()
+    // Then: returns false
+    EXPECT_FALSE(HttpUtil::tryParseRange("", 100, firstBytePos, lastBytePos));
+    EXPECT_FALSE(HttpUtil::tryParseRange("items=0-10", 100, firstBytePos, lastBytePos));
+    EXPECT_FALSE(HttpUtil::tryParseRange("bytes=0-10,20-30", 100, firstBytePos, lastBytePos));
+    EXPECT_FALSE(HttpUtil::tryParseRange("bytes=20-10", 100, firstBytePos, lastBytePos));
+    EXPECT_FALSE(HttpUtil::tryParseRange("bytes=100-", 100, firstBytePos, lastBytePos));
+    EXPECT_FALSE(HttpUtil::tryParseRange("bytes=-0", 100, firstBytePos, lastBytePos));
+    EXPECT_FALSE(HttpUtil::tryParseRange("bytes=a-b", 100, firstBytePos, lastBytePos));
+}
+
+TEST(HttpUtilUnitTest, tryParseContentRange_ReturnsTrue_WhenContentRangeIsValid)
+{
+    // Given: none
+    Poco::UInt64 firstBytePos = 0;
+    Poco::UInt64 lastBytePos = 0;
+    Poco::UInt64 completeLength = 0;
+
+    // When: call tryParseContentRange()
+    // Then: returns the range and the complete length
+    EXPECT_TRUE(HttpUtil::tryParseContentRange("bytes 10-99/100", firstBytePos, lastBytePos, completeLength));
+    EXPECT_EQ(10U, firstBytePos);
+    EXPECT_EQ(99U, lastBytePos);
+    EXPECT_EQ(100U, completeLength);
+}
+
+TEST(HttpUtilUnitTest, tryParseContentRange_ReturnsFalse_WhenContentRangeIsInvalid)
+{
+    // Given: none
+    Poco::UInt64 firstBytePos = 0;
+    Poco::UInt64 lastBytePos = 0;
+    Poco::UInt64 completeLength = 0;
+
+    // When: call tryParseContentRange()
+    // Then: returns false
+    EXPECT_FALSE(HttpUtil::tryParseContentRange("", firstBytePos, lastBytePos, completeLength));
+    EXPECT_FALSE(HttpUtil::tryParseContentRange("bytes 10-99/*", firstBytePos, lastBytePos, completeLength));
+    EXPECT_FALSE(HttpUtil::tryParseContentRange("bytes */100", firstBytePos, lastBytePos, completeLength));
+    EXPECT_FALSE(HttpUtil::tryParseContentRange("bytes 10-100/100", firstBytePos, lastBytePos, completeLength));
+    EXPECT_FALSE(HttpUtil::tryParseContentRange("bytes 20-10/100", firstBytePos, lastBytePos, completeLength));
+}
+
+TEST(HttpUtilUnitTest, makeContentRange_ReturnsContentRange)
+{
+    // Given: none
+    // When: call makeContentRange()
+    // Then: returns Content-Range value
+    EXPECT_EQ("bytes 10-99/100", HttpUtil::makeContentRange(10, 99, 100));
+}
+
+TEST(HttpUtilUnitTest, getRangeValidator_ReturnsETag_WhenETagIsStrong)
+{
+    // Given: strong ETag and Last-Modified
+    Headers::Ptr pHeaders = new Headers();
+    pHeaders->set("ETag", "\"v1\"");
+    pHeaders->set("Last-Modified", "Fri, 05 Aug 2016 12:00:00 GMT");
+
+    // When: call getRangeValidator()
+    // Then: returns ETag
+    EXPECT_EQ("\"v1\"", HttpUtil::getRangeValidator(pHeaders));
+}
+
+TEST(HttpUtilUnitTest, getRangeValidator_ReturnsLastModified_WhenETagIsWeak)
+{
+    // Given: weak ETag and Last-Modified
+    Headers::Ptr pHeaders = new Headers();
+    pHeaders->set("ETag", "W/\"v1\"");
+    pHeaders->set("Last-Modified", "Fri, 05 Aug 2016 12:00:00 GMT");
+
+    // When: call getRangeValidator()
+    // Then: returns Last-Modified
+    EXPECT_EQ("Fri, 05 Aug 2016 12:00:00 GMT", HttpUtil::getRangeValidator(pHeaders));
+}
+
+TEST(HttpUtilUnitTest, getRangeValidator_ReturnsEmptyString_WhenNoValidator)
+{
+    // Given: no validator
+    Headers::Ptr pHeaders = new Headers();
+
+    // When: call getRangeValidator()
+    // Then: returns empty string
+    EXPECT_EQ("", HttpUtil::getRangeValidator(pHeaders));
+}
+
+TEST(HttpUtilUnitTest, isDecodableContentEncoding_ReturnsTrue_WhenGzipOrDeflate)
+{
+    // Given: none
+    // When: call isDecodableContentEncoding()
+    // Then: returns true
+    EXPECT_TRUE(HttpUtil::isDecodableContentEncoding("gzip"));
+    EXPECT_TRUE(HttpUtil::isDecodableContentEncoding("x-gzip"));
+    EXPECT_TRUE(HttpUtil::isDecodableContentEncoding(" GZIP "));
+    EXPECT_TRUE(HttpUtil::isDecodableContentEncoding("deflate"));
+}
+
+TEST(HttpUtilUnitTest, isDecodableContentEncoding_ReturnsFalse_WhenNotSupported)
+{
+    // Given: none
+    // When: call isDecodableContentEncoding()
+    // Then: returns false
+    EXPECT_FALSE(HttpUtil::isDecodableContentEncoding(""));
+    EXPECT_FALSE(HttpUtil::isDecodableContentEncoding("identity"));
+    EXPECT_FALSE(HttpUtil::isDecodableContentEncoding("br"));
+    EXPECT_FALSE(HttpUtil::isDecodableContentEncoding("deflate, gzip"));
+}
+
+TEST(HttpUtilUnitTest, createDecodingInputStream_DecompressesGzip)
+{
+    // Given: gzip data
+    std::stringstream compressed;
+    Poco::DeflatingOutputStream deflater(compressed, Poco::DeflatingStreamBuf::STREAM_GZIP);
+    deflater << HeaderValueFoo << HeaderValueBar;
+    deflater.close();
+
+    // When: call createDecodingInputStream()
+    Poco::SharedPtr<std::istream> pDecodingStream = HttpUtil::createDecodingInputStream(compressed, "gzip");
+
+    // Then: returns decompressed data
+    ASSERT_FALSE(pDecodingStream.isNull());
+    std::string decompressed((std::istreambuf_iterator<char>(*pDecodingStream)), std::istreambuf_iterator<char>());
+    EXPECT_EQ(HeaderValueFoo + HeaderValueBar, decompressed);
+}
+
+TEST(HttpUtilUnitTest, createDecodingInputStream_ReturnsNull_WhenNotSupported)
+{
+    // Given: none
+    std::stringstream compressed;
+
+    // When: call createDecodingInputStream()
+    // Then: returns NULL
+    EXPECT_TRUE(HttpUtil::createDecodingInputStream(compressed, "br") == NULL);
+}
+
 } /* namespace test */
 } /* namespace easyhttpcpp */
 
@@ -0,0 +1,188 @@
+/*
+ * Copyright 2019 Sony Corporation
+ */
+
+#include <iterator>
+#include <sstream>
+
+#include "gtest/gtest.h"
+
+#include "Poco/InflatingStream.h"
+
+#include "easyhttpcpp/HttpException.h"
+#include "easyhttpcpp/RequestBody.h"
+
+#include "RequestBodyForGzip.h"
+
+namespace easyhttpcpp {
+namespace test {
+
+static const std::string ContentType = "application/json";
+static const std::string ContentTypePng = "image/png";
+static const std::string ContentTypeSvg = "image/svg+xml";
+static const std::string SmallContent = "{\"id\":1}";
+static const int CompressionLevel = 9;
+
+namespace {
+
+std::string createLargeContent()
+{
+    std::string content;
+    while (content.size() < 4096) {
+        content += "{\"id\":1,\"name\":\"item\",\"enabled\":true},";
+    }
+    return content;
+}
+
+std::string inflate(const std::string& compressed)
+{
+    std::istringstream compressedStream(compressed);
+    Poco::InflatingInputStream inflatingStream(compressedStream, Poco::InflatingStreamBuf::STREAM_GZIP);
+    return std::string(std::istreambuf_iterator<char>(inflatingStream), std::istreambuf_iterator<char>());
+}
+
+RequestBody::Ptr createRequestBody(const std::string& contentType, const std::string& content)
+{
+    return RequestBody::create(new MediaType(contentType), Poco::SharedPtr<std::string>(new std::string(content)));
+}
+
+} /* namespace */
+
+TEST(RequestBodyForGzipUnitTest, constructor_ReturnsInstanceWithoutContentLength_WhenCompressing)
+{
+    // Given: large content
+    RequestBody::Ptr pRequestBody = createRequestBody(ContentType, createLargeContent());
+
+    // When: call RequestBodyForGzip()
+    RequestBodyForGzip requestBody(pRequestBody, CompressionLevel, true);
+
+    // Then: gzip is applied and content length is unknown
+    EXPECT_TRUE(requestBody.isCompressing());
+    EXPECT_EQ("gzip", requestBody.getContentEncoding());
+    EXPECT_FALSE(requestBody.hasContentLength());
+    EXPECT_EQ(-1, requestBody.getContentLength());
+    EXPECT_EQ(pRequestBody->getMediaType(), requestBody.getMediaType());
+}
+
+TEST(RequestBodyForGzipUnitTest, constructor_ThrowsHttpIllegalArgumentException_WhenRequestBodyIsNull)
+{
+    // Given: none
+    // When: call RequestBodyForGzip()
+    // Then: throws exception
+    EXPECT_THROW(RequestBodyForGzip(NULL, CompressionLevel, true), HttpIllegalArgumentException);
+}
+
+TEST(RequestBodyForGzipUnitTest, constructor_ThrowsHttpIllegalArgumentException_WhenCompressionLevelIsOutOfRange)
+{
+    // Given: none
+    RequestBody::Ptr pRequestBody = createRequestBody(ContentType, createLargeContent());
+
+    // When: call RequestBodyForGzip()
+    // Then: throws exception
+    EXPECT_THROW(RequestBodyForGzip(pRequestBody, 0, true), HttpIllegalArgumentException);
+    EXPECT_THROW(RequestBodyForGzip(pRequestBody, 10, true), HttpIllegalArgumentException);
+}
+
+TEST(RequestBodyForGzipUnitTest, constructor_ThrowsHttpIllegalArgumentException_WhenRequestBodyIsAlreadyEncoded)
+{
+    // Given: gzip RequestBody
+    RequestBody::Ptr pRequestBody = RequestBody::createGzip(createRequestBody(ContentType, createLargeContent()));
+
+    // When: call RequestBodyForGzip()
+    // Then: throws exception
+    EXPECT_THROW(RequestBodyForGzip(pRequestBody, CompressionLevel, true), HttpIllegalArgumentException);
+}
+
+TEST(RequestBodyForGzipUnitTest, constructor_SkipsCompression_WhenAdaptiveAndContentIsSmall)
+{
+    // Given: small content
+    RequestBody::Ptr pRequestBody = createRequestBody(ContentType, SmallContent);
+
+    // When: call RequestBodyForGzip()
+    RequestBodyForGzip requestBody(pRequestBody, CompressionLevel, true);
+
+    // Then: content is written as is
+    EXPECT_FALSE(requestBody.isCompressing());
+    EXPECT_EQ("", requestBody.getContentEncoding());
+    EXPECT_TRUE(requestBody.hasContentLength());
+    EXPECT_EQ(SmallContent.size(), requestBody.getContentLength());
+    std::ostringstream os;
+    requestBody.writeTo(os);
+    EXPECT_EQ(SmallContent, os.str());
+}
+
+TEST(RequestBodyForGzipUnitTest, constructor_SkipsCompression_WhenAdaptiveAndMediaTypeIsCompressed)
+{
+    // Given: image/png
+    RequestBody::Ptr pRequestBody = createRequestBody(ContentTypePng, createLargeContent());
+
+    // When: call RequestBodyForGzip()
+    RequestBodyForGzip requestBody(pRequestBody, CompressionLevel, true);
+
+    // Then: compression is skipped
+    EXPECT_FALSE(requestBody.isCompressing());
+    EXPECT_EQ("", requestBody.getContentEncoding());
+}
+
+TEST(RequestBodyForGzipUnitTest, constructor_Compresses_WhenAdaptiveAndMediaTypeIsSvg)
+{
+    // Given: image/svg+xml
+    RequestBody::Ptr pRequestBody = createRequestBody(ContentTypeSvg, createLargeContent());
+
+    // When: call RequestBodyForGzip()
+    RequestBodyForGzip requestBody(pRequestBody, CompressionLevel, true);
+
+    // Then: compression is applied
+    EXPECT_TRUE(requestBody.isCompressing());
+}
+
+TEST(RequestBodyForGzipUnitTest, constructor_Compresses_WhenNotAdaptiveAndContentIsSmall)
+{
+    // Given: small content
+    RequestBody::Ptr pRequestBody = createRequestBody(ContentType, SmallContent);
+
+    // When: call RequestBodyForGzip()
+    RequestBodyForGzip requestBody(pRequestBody, CompressionLevel, false);
+
+    // Then: compression is applied
+    EXPECT_TRUE(requestBody.isCompressing());
+    std::ostringstream os;
+    requestBody.writeTo(os);
+    EXPECT_EQ(SmallContent, inflate(os.str()));
+}
+
+TEST(RequestBodyForGzipUnitTest, writeTo_WritesCompressedContent)
+{
+    // Given: large content
+    std::string content = createLargeContent();
+    RequestBodyForGzip requestBody(createRequestBody(ContentType, content), CompressionLevel, true);
+
+    // When: call writeTo()
+    std::ostringstream os;
+    requestBody.writeTo(os);
+
+    // Then: written data is gzip of the content
+    EXPECT_LT(os.str().size(), content.size());
+    EXPECT_EQ(content, inflate(os.str()));
+}
+
+TEST(RequestBodyForGzipUnitTest, writeTo_WritesCompressedContentAgain_AfterReset)
+{
+    // Given: content is written once
+    std::string content = createLargeContent();
+    RequestBodyForGzip requestBody(createRequestBody(ContentType, content), CompressionLevel, true);
+    std::ostringstream os1;
+    requestBody.writeTo(os1);
+
+    // When: call reset() and writeTo()
+    ASSERT_TRUE(requestBody.reset());
+    std::ostringstream os2;
+    requestBody.writeTo(os2);
+
+    // Then: same compressed data is written
+    EXPECT_EQ(content, inflate(os2.str()));
+    EXPECT_EQ(os1.str(), os2.str());
+}
+
+} /* namespace test */
+} /* namespace easyhttpcpp */
@@ -5,22 +5,34 @@
 #include "gtest/gtest.h"
 #include "gmock/gmock.h"
 
+#include <fstream>
+
+#include "Poco/File.h"
+#include "Poco/Path.h"
+
 #include "easyhttpcpp/common/ByteArrayBuffer.h"
+#include "easyhttpcpp/common/CommonMacros.h"
+#include "easyhttpcpp/common/FileUtil.h"
 #include "easyhttpcpp/ResponseBody.h"
 #include "easyhttpcpp/HttpException.h"
 #include "EasyHttpCppAssertions.h"
 #include "MockResponseBodyStream.h"
+#include "MockResponseBodyWriteCallback.h"
 
 #include "ResponseBodyStreamInternal.h"
 
 using easyhttpcpp::common::Byte;
 using easyhttpcpp::common::ByteArrayBuffer;
+using easyhttpcpp::common::FileUtil;
+using easyhttpcpp::testutil::MockResponseBodyWriteCallback;
 
 namespace easyhttpcpp {
 namespace test {
 
 static const std::string ContentType = "text/plain";
 static const std::string Content = "test content data";
+static const std::string WriteToTestDir = "/ResponseBody/";
+static const std::string WriteToTestFileName = "body.data";
 
 TEST(ResponseBodyUnitTest, create_ReturnsInstance)
 {
@@ -163,5 +175,158 @@ TEST(ResponseBodyUnitTest, toString_ReturnsStringAsContent_WhenContentLengthIsLe
     EXPECT_EQ(content, pResponseBody->toString());
 }
 
+class ResponseBodyWriteToUnitTest : public testing::Test {
+protected:
+
+    void SetUp()
+    {
+        Poco::Path dir(std::string(EASYHTTPCPP_STRINGIFY_MACRO(RUNTIME_DATA_ROOT)) + WriteToTestDir);
+        FileUtil::removeDirsIfPresent(dir);
+        FileUtil::createDirsIfAbsent(Poco::File(dir));
+        m_filePath = Poco::Path(dir, WriteToTestFileName);
+    }
+
+    std::string readFile()
+    {
+        std::ifstream is(m_filePath.toString().c_str(), std::ios_base::in | std::ios_base::binary);
+        return std::string((std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>());
+    }
+
+    Poco::Path m_filePath;
+};
+
+TEST_F(ResponseBodyWriteToUnitTest, writeTo_WritesContentToFile)
+{
+    // Given: none
+    MediaType::Ptr pMediaType(new MediaType(ContentType));
+    std::istringstream is(Content);
+    ResponseBodyStream::Ptr pBodyStream = new ResponseBodyStreamInternal(is);
+    ResponseBody::Ptr pResponseBody = ResponseBody::create(pMediaType, true, Content.length(), pBodyStream);
+
+    // When: call writeTo()
+    Poco::UInt64 writtenBytes = pResponseBody->writeTo(m_filePath);
+
+    // Then: file has content and stream is closed
+    EXPECT_EQ(Content.length(), writtenBytes);
+    EXPECT_EQ(Content, readFile());
+    char buffer[1024];
+    EASYHTTPCPP_EXPECT_THROW(pResponseBody->getByteStream()->read(buffer, 1024), HttpIllegalStateException, 100701);
+}
+
+TEST_F(ResponseBodyWriteToUnitTest, writeTo_OverwritesExistingFile_WhenAppendIsFalse)
+{
+    // Given: file already exists
+    {
+        std::ofstream os(m_filePath.toString().c_str());
+        os << "previous content which is longer than the new one";
+    }
+    MediaType::Ptr pMediaType(new MediaType(ContentType));
+    std::istringstream is(Content);
+    ResponseBodyStream::Ptr pBodyStream = new ResponseBodyStreamInternal(is);
+    ResponseBody::Ptr pResponseBody = ResponseBody::create(pMediaType, true, Content.length(), pBodyStream);
+
+    // When: call writeTo()
+    pResponseBody->writeTo(m_filePath, false);
+
+    // Then: file has only the new content
+    EXPECT_EQ(Content, readFile());
+}
+
+TEST_F(ResponseBodyWriteToUnitTest, writeTo_AppendsContentToExistingFile_WhenAppendIsTrue)
+{
+    // Given: partial file already exists
+    std::string prefix = "partial ";
+    {
+        std::ofstream os(m_filePath.toString().c_str());
+        os << prefix;
+    }
+    MediaType::Ptr pMediaType(new MediaType(ContentType));
+    std::istringstream is(Content);
+    ResponseBodyStream::Ptr pBodyStream = new ResponseBodyStreamInternal(is);
+    ResponseBody::Ptr pResponseBody = ResponseBody::create(pMediaType, true, Content.length(), pBodyStream);
+
+    // When: call writeTo() with append
+    Poco::UInt64 writtenBytes = pResponseBody->writeTo(m_filePath, true);
+
+    // Then: content is appended to the file
+    EXPECT_EQ(Content.length(), writtenBytes);
+    EXPECT_EQ(prefix + Content, readFile());
+}
+
+TEST_F(ResponseBodyWriteToUnitTest, writeTo_ThrowsHttpExecutionException_WhenContentIsShorterThanContentLength)
+{
+    // Given: content length is larger than content
+    MediaType::Ptr pMediaType(new MediaType(ContentType));
+    std::istringstream is(Content);
+    ResponseBodyStream::Ptr pBodyStream = new ResponseBodyStreamInternal(is);
+    ResponseBody::Ptr pResponseBody = ResponseBody::create(pMediaType, true, Content.length() + 10, pBodyStream);
+
+    // When: call writeTo()
+    // Then: throws exception and received bytes are left in the file
+    EASYHTTPCPP_EXPECT_THROW(pResponseBody->writeTo(m_filePath), HttpExecutionException, 100702);
+    EXPECT_EQ(Content, readFile());
+}
+
+TEST_F(ResponseBodyWriteToUnitTest, writeTo_ThrowsHttpExecutionException_WhenReadReturns0BeforeEof)
+{
+    // Given: content reads nothing but does not reach the end
+    MediaType::Ptr pMediaType(new MediaType(ContentType));
+    easyhttpcpp::testutil::MockResponseBodyStream *pMockBodyStream
+            = new easyhttpcpp::testutil::MockResponseBodyStream();
+    EXPECT_CALL(*pMockBodyStream, close()).Times(testing::AnyNumber());
+    EXPECT_CALL(*pMockBodyStream, read(testing::_, testing::_)).WillRepeatedly(testing::Return(0));
+    EXPECT_CALL(*pMockBodyStream, isEof()).WillRepeatedly(testing::Return(false));
+    ResponseBodyStream::Ptr pBodyStream = pMockBodyStream;
+    ResponseBody::Ptr pResponseBody = ResponseBody::create(pMediaType, true, -1, pBodyStream);
+
+    // When: call writeTo()
+    // Then: throws exception instead of waiting forever
+    EASYHTTPCPP_EXPECT_THROW(pResponseBody->writeTo(m_filePath), HttpExecutionException, 100702);
+}
+
+TEST_F(ResponseBodyWriteToUnitTest, writeTo_ThrowsHttpExecutionException_WhenReadFailsBeforeEof)
+{
+    // Given: content returns error but does not reach the end
+    MediaType::Ptr pMediaType(new MediaType(ContentType));
+    easyhttpcpp::testutil::MockResponseBodyStream *pMockBodyStream
+            = new easyhttpcpp::testutil::MockResponseBodyStream();
+    EXPECT_CALL(*pMockBodyStream, close()).Times(testing::AnyNumber());
+    EXPECT_CALL(*pMockBodyStream, read(testing::_, testing::_)).WillRepeatedly(testing::Return(-1));
+    EXPECT_CALL(*pMockBodyStream, isEof()).WillRepeatedly(testing::Return(false));
+    ResponseBodyStream::Ptr pBodyStream = pMockBodyStream;
+    ResponseBody::Ptr pResponseBody = ResponseBody::create(pMediaType, true, -1, pBodyStream);
+
+    // When: call writeTo()
+    // Then: throws exception instead of waiting forever
+    EASYHTTPCPP_EXPECT_THROW(pResponseBody->writeTo(m_filePath), HttpExecutionException, 100702);
+}
+
+TEST_F(ResponseBodyWriteToUnitTest, writeTo_ThrowsHttpIllegalArgumentException_WhenPathIsEmpty)
+{
+    // Given: none
+    MediaType::Ptr pMediaType(new MediaType(ContentType));
+    std::istringstream is(Content);
+    ResponseBodyStream::Ptr pBodyStream = new ResponseBodyStreamInternal(is);
+    ResponseBody::Ptr pResponseBody = ResponseBody::create(pMediaType, true, Content.length(), pBodyStream);
+
+    // When: call writeTo() with empty path
+    // Then: throws exception
+    EASYHTTPCPP_EXPECT_THROW(pResponseBody->writeTo(Poco::Path()), HttpIllegalArgumentException, 100700);
+}
+
+TEST_F(ResponseBodyWriteToUnitTest, writeToAsync_ThrowsHttpIllegalStateException_WhenNotCreatedByCall)
+{
+    // Given: ResponseBody created by user
+    MediaType::Ptr pMediaType(new MediaType(ContentType));
+    std::istringstream is(Content);
+    ResponseBodyStream::Ptr pBodyStream = new ResponseBodyStreamInternal(is);
+    ResponseBody::Ptr pResponseBody = ResponseBody::create(pMediaType, true, Content.length(), pBodyStream);
+    ResponseBodyWriteCallback::Ptr pCallback = new MockResponseBodyWriteCallback();
+
+    // When: call writeToAsync()
+    // Then: throws exception
+    EASYHTTPCPP_EXPECT_THROW(pResponseBody->writeToAsync(m_filePath, pCallback), HttpIllegalStateException, 100701);
+}
+
 } /* namespace test */
 } /* namespace easyhttpcpp */
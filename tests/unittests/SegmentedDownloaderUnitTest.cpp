@@ -0,0 +1,133 @@
+/*
+ * Copyright 2019 Sony Corporation
+ */
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+
+#include "easyhttpcpp/EasyHttp.h"
+#include "easyhttpcpp/HttpException.h"
+#include "easyhttpcpp/SegmentedDownloader.h"
+#include "EasyHttpCppAssertions.h"
+
+#include "HttpInternalConstants.h"
+
+namespace easyhttpcpp {
+namespace test {
+
+static const std::string Url = "http://www.example.com/path/index.html";
+static const std::string DownloadPath = "/test/download/file";
+static const unsigned int SegmentCount = 8;
+static const Poco::UInt64 SegmentSize = 1024 * 1024;
+static const unsigned int MaxRetryCount = 5;
+
+namespace {
+
+class NullProgressListener : public SegmentedDownloader::ProgressListener {
+public:
+    virtual void onProgress(Poco::UInt64 downloadedBytes, Poco::UInt64 totalBytes)
+    {
+    }
+};
+
+} /* namespace */
+
+TEST(SegmentedDownloaderBuilderUnitTest, constructor_ReturnsInstance)
+{
+    // Given: none
+    // When: call Builder()
+    SegmentedDownloader::Builder builder;
+
+    // Then: initial value is set
+    EXPECT_EQ(HttpInternalConstants::SegmentedDownloads::DefaultSegmentCount, builder.getSegmentCount());
+    EXPECT_EQ(0U, builder.getSegmentSize());
+    EXPECT_EQ(HttpInternalConstants::SegmentedDownloads::DefaultMaxRetryCount, builder.getMaxRetryCount());
+    EXPECT_TRUE(builder.getProgressListener().isNull());
+}
+
+TEST(SegmentedDownloaderBuilderUnitTest, build_ReturnsSegmentedDownloaderInstance_WhenSettingsAreSet)
+{
+    // Given: set all settings
+    EasyHttp::Builder easyHttpBuilder;
+    EasyHttp::Ptr pEasyHttp = easyHttpBuilder.build();
+    SegmentedDownloader::ProgressListener::Ptr pProgressListener = new NullProgressListener();
+    SegmentedDownloader::Builder builder;
+    builder.setSegmentCount(SegmentCount).setSegmentSize(SegmentSize).setMaxRetryCount(MaxRetryCount)
+            .setProgressListener(pProgressListener);
+
+    // When: call build()
+    SegmentedDownloader::Ptr pDownloader = builder.build(pEasyHttp);
+
+    // Then: settings are passed to SegmentedDownloader
+    ASSERT_FALSE(pDownloader.isNull());
+    EXPECT_EQ(SegmentCount, pDownloader->getSegmentCount());
+    EXPECT_EQ(SegmentSize, pDownloader->getSegmentSize());
+    EXPECT_EQ(MaxRetryCount, pDownloader->getMaxRetryCount());
+    EXPECT_EQ(pProgressListener, builder.getProgressListener());
+}
+
+TEST(SegmentedDownloaderBuilderUnitTest, build_ThrowsHttpIllegalArgumentException_WhenEasyHttpIsNull)
+{
+    // Given: none
+    SegmentedDownloader::Builder builder;
+
+    // When: call build() with NULL
+    // Then: throw exception
+    EASYHTTPCPP_EXPECT_THROW(builder.build(NULL), HttpIllegalArgumentException, 100700);
+}
+
+TEST(SegmentedDownloaderBuilderUnitTest, setSegmentCount_ThrowsHttpIllegalArgumentException_WhenSegmentCountIsZero)
+{
+    // Given: none
+    SegmentedDownloader::Builder builder;
+
+    // When: call setSegmentCount() with 0
+    // Then: throw exception
+    EASYHTTPCPP_EXPECT_THROW(builder.setSegmentCount(0), HttpIllegalArgumentException, 100700);
+}
+
+TEST(SegmentedDownloaderUnitTest, download_ThrowsHttpIllegalArgumentException_WhenRequestIsNotGet)
+{
+    // Given: HEAD request
+    EasyHttp::Builder easyHttpBuilder;
+    EasyHttp::Ptr pEasyHttp = easyHttpBuilder.build();
+    SegmentedDownloader::Builder builder;
+    SegmentedDownloader::Ptr pDownloader = builder.build(pEasyHttp);
+    Request::Builder requestBuilder;
+    Request::Ptr pRequest = requestBuilder.httpHead().setUrl(Url).build();
+
+    // When: call download()
+    // Then: throw exception
+    EASYHTTPCPP_EXPECT_THROW(pDownloader->download(pRequest, Poco::Path(DownloadPath)),
+            HttpIllegalArgumentException, 100700);
+}
+
+TEST(SegmentedDownloaderUnitTest, download_ThrowsHttpIllegalArgumentException_WhenRequestIsNull)
+{
+    // Given: none
+    EasyHttp::Builder easyHttpBuilder;
+    EasyHttp::Ptr pEasyHttp = easyHttpBuilder.build();
+    SegmentedDownloader::Builder builder;
+    SegmentedDownloader::Ptr pDownloader = builder.build(pEasyHttp);
+
+    // When: call download() with NULL
+    // Then: throw exception
+    EASYHTTPCPP_EXPECT_THROW(pDownloader->download(NULL, Poco::Path(DownloadPath)),
+            HttpIllegalArgumentException, 100700);
+}
+
+TEST(SegmentedDownloaderUnitTest, cancel_ReturnsFalse_WhenNotDownloading)
+{
+    // Given: none
+    EasyHttp::Builder easyHttpBuilder;
+    EasyHttp::Ptr pEasyHttp = easyHttpBuilder.build();
+    SegmentedDownloader::Builder builder;
+    SegmentedDownloader::Ptr pDownloader = builder.build(pEasyHttp);
+
+    // When: call cancel()
+    // Then: returns false
+    EXPECT_FALSE(pDownloader->cancel());
+}
+
+} /* namespace test */
+} /* namespace easyhttpcpp */
@@ -2,6 +2,8 @@
  * Copyright 2017 Sony Corporation
  */
 
+#include <sstream>
+
 #include "gtest/gtest.h"
 
 #include "easyhttpcpp/common/CacheManager.h"
@@ -1408,9 +1410,9 @@ TEST_F(CacheManagerUnitTest, remove_ReturnsFalse_WhenL1CacheReturnsTrueAndL2Cach
 //
 // L1Cache::remove が呼び出される。
 // L2Cache::remove が呼び出される。
-// false が返る。
+// true が返る。
 
-TEST_F(CacheManagerUnitTest, remove_ReturnsFalse_WhenL1CacheReturnsFalseAndL2CacheReturnsTrue)
+TEST_F(CacheManagerUnitTest, remove_ReturnsTrue_WhenL1CacheReturnsFalseAndL2CacheReturnsTrue)
 {
     // Given: L1Cache and L2Cache
     testing::InSequence seq;
@@ -1422,8 +1424,8 @@ TEST_F(CacheManagerUnitTest, remove_ReturnsFalse_WhenL1CacheReturnsFalseAndL2Cac
     CacheManager cacheManager(m_pMockL1Cache, m_pMockL2Cache);
 
     // When: call remove
-    // Then: return false
-    EXPECT_FALSE(cacheManager.remove(Key1));
+    // Then: return true
+    EXPECT_TRUE(cacheManager.remove(Key1));
 }
 
 // remove
@@ -1530,6 +1532,25 @@ TEST_F(CacheManagerUnitTest, releaseData_CallsReleaseDataOfL1CacheAndL2Cache_Whe
     cacheManager.releaseData(Key1);
 }
 
+TEST_F(CacheManagerUnitTest, releaseData_CallsReleaseDataOfOnlyTheCacheWhichServedData_WhenCacheIndexIsGiven)
+{
+    // Given: L1Cache has the data
+    EXPECT_CALL(*(static_cast<MockCache*> (m_pMockL1Cache.get())), getData(Key1, testing::_)).
+            WillOnce(testing::DoAll(testing::SetArgReferee<1>(Stream1), testing::Return(true)));
+    EXPECT_CALL(*(static_cast<MockCache*> (m_pMockL1Cache.get())), releaseData(Key1)).Times(1);
+    EXPECT_CALL(*(static_cast<MockCache*> (m_pMockL2Cache.get())), releaseData(Key1)).Times(0);
+
+    CacheManager cacheManager(m_pMockL1Cache, m_pMockL2Cache);
+    std::istream* pStream = NULL;
+    unsigned int cacheIndex = 1;
+    ASSERT_TRUE(cacheManager.getData(Key1, pStream, cacheIndex));
+    EXPECT_EQ(0U, cacheIndex);
+
+    // When: call releaseData with the cache index
+    // Then: L2Cache::releaseData is not called, since L2Cache did not give the data
+    cacheManager.releaseData(Key1, cacheIndex);
+}
+
 // purge
 // L1Cache, L2Cache なし。
 //
@@ -1725,6 +1746,71 @@ TEST_F(CacheManagerUnitTest, purge_ReturnsFalse_WhenL1CacheReturnsTrueAndL2Cache
     EXPECT_TRUE(cacheManager.purge(true));
 }
 
+// getData
+// L1Cache, L2Cache あり。L1Cache に入れるデータの最大サイズを指定。
+// L1Cache::getData が false を返す。
+// L2Cache::getData が true を返す。
+//
+// L2Cache から読んだデータと metadata で L1Cache::put が呼び出される。
+// true が返る。
+
+TEST_F(CacheManagerUnitTest, getData_BringsDataToL1Cache_WhenL2CacheReturnsTrueAndDataIsSmall)
+{
+    // Given: L1Cache and L2Cache
+    std::istream* pL2Stream = new std::istringstream(Data1);
+    EXPECT_CALL(*(static_cast<MockCache*> (m_pMockL1Cache.get())), getData(Key1, testing::_)).
+            WillOnce(testing::Return(false));
+    EXPECT_CALL(*(static_cast<MockCache*> (m_pMockL2Cache.get())), getData(Key1, testing::_)).
+            WillOnce(DoAll(testing::SetArgReferee<1>(Stream1), testing::Return(true))).
+            WillOnce(DoAll(testing::SetArgReferee<1>(pL2Stream), testing::Return(true)));
+    EXPECT_CALL(*(static_cast<MockCache*> (m_pMockL2Cache.get())), releaseData(Key1)).Times(1);
+    EXPECT_CALL(*(static_cast<MockCache*> (m_pMockL2Cache.get())), getMetadata(Key1, testing::_)).
+            WillOnce(DoAll(testing::SetArgReferee<1>(setupCacheMetadata()), testing::Return(true)));
+    EXPECT_CALL(*(static_cast<MockCache*> (m_pMockL1Cache.get())),
+            put(Key1, testing::Truly(isMetadataOuterMethodParameter),
+            testing::Matcher<Poco::SharedPtr<ByteArrayBuffer> >(testing::Truly(isDataOuterMethodParameter)))).
+            WillOnce(testing::Return(true));
+
+    CacheManager cacheManager(m_pMockL1Cache, m_pMockL2Cache, Data1.size());
+    std::istream* pStream = NULL;
+
+    // When: call getData
+    // Then: return true and get stream from L2Cache
+    EXPECT_TRUE(cacheManager.getData(Key1, pStream));
+    EXPECT_EQ(Stream1, pStream);
+}
+
+// getData
+// L1Cache, L2Cache あり。L1Cache に入れるデータの最大サイズを指定。
+// L1Cache::getData が false を返す。
+// L2Cache::getData が最大サイズを超えるデータを返す。
+//
+// L1Cache::put は呼び出されない。
+// true が返る。
+
+TEST_F(CacheManagerUnitTest, getData_DoesNotBringDataToL1Cache_WhenDataExceedsMaxL1DataSize)
+{
+    // Given: L1Cache and L2Cache
+    std::istream* pL2Stream = new std::istringstream(Data1);
+    EXPECT_CALL(*(static_cast<MockCache*> (m_pMockL1Cache.get())), getData(Key1, testing::_)).
+            WillOnce(testing::Return(false));
+    EXPECT_CALL(*(static_cast<MockCache*> (m_pMockL2Cache.get())), getData(Key1, testing::_)).
+            WillOnce(DoAll(testing::SetArgReferee<1>(Stream1), testing::Return(true))).
+            WillOnce(DoAll(testing::SetArgReferee<1>(pL2Stream), testing::Return(true)));
+    EXPECT_CALL(*(static_cast<MockCache*> (m_pMockL2Cache.get())), releaseData(Key1)).Times(1);
+    EXPECT_CALL(*(static_cast<MockCache*> (m_pMockL2Cache.get())), getMetadata(Key1, testing::_)).Times(0);
+    EXPECT_CALL(*(static_cast<MockCache*> (m_pMockL1Cache.get())),
+            put(Key1, testing::_, testing::An<Poco::SharedPtr<ByteArrayBuffer> >())).Times(0);
+
+    CacheManager cacheManager(m_pMockL1Cache, m_pMockL2Cache, Data1.size() - 1);
+    std::istream* pStream = NULL;
+
+    // When: call getData
+    // Then: return true and get stream from L2Cache
+    EXPECT_TRUE(cacheManager.getData(Key1, pStream));
+    EXPECT_EQ(Stream1, pStream);
+}
+
 } /* namespace test */
 } /* namespace common */
 } /* namespace easyhttpcpp */
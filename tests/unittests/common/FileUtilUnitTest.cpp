@@ -541,6 +541,52 @@ TEST_F(FileUtilUnitTest, convertToAbsolutePathString_ReturnsAbsolutePath_WhenGiv
     EXPECT_EQ(expetedPath, actualPath);
 }
 
+TEST_F(FileUtilUnitTest, copyFile_CopiesContentAndKeepsSource_WhenSourceFileExists)
+{
+    // Given: prepare source file with content
+    prepareDirectoriesAndFiles();
+    Poco::File source(createPath(SourceFileDepth0, true));
+    {
+        FILE* fp = fopen(source.path().c_str(), "w");
+        ASSERT_TRUE(fp != NULL);
+        fputs("copy test data", fp);
+        fclose(fp);
+    }
+    Poco::File destination(createPath(DestFileDepth0, true));
+
+    // When: call FileUtil::copyFile()
+    // Then: destination has the same size and source still exists
+    EXPECT_TRUE(FileUtil::copyFile(source, destination));
+    EXPECT_TRUE(source.exists());
+    ASSERT_TRUE(destination.exists());
+    EXPECT_EQ(source.getSize(), destination.getSize());
+}
+
+TEST_F(FileUtilUnitTest, copyFile_ReturnsFalse_WhenSourceFileDoesNotExist)
+{
+    // Given: prepare directories and files
+    prepareDirectoriesAndFiles();
+    Poco::File source(createPath(SourceFileNotExists, true));
+    Poco::File destination(createPath(DestFileDepth0, true));
+
+    // When: call FileUtil::copyFile()
+    // Then: returns false
+    EXPECT_FALSE(FileUtil::copyFile(source, destination));
+}
+
+TEST_F(FileUtilUnitTest, preallocateFile_DoesNotChangeFileSize)
+{
+    // Given: prepare empty file
+    prepareDirectoriesAndFiles();
+    Poco::File file(createPath(SourceFileDepth0, true));
+
+    // When: call FileUtil::preallocateFile()
+    FileUtil::preallocateFile(file, 0, 1024 * 1024);
+
+    // Then: file size is not changed regardless of platform support
+    EXPECT_EQ(0, file.getSize());
+}
+
 } /* namespace test */
 } /* namespace Loader */
 } /* namespace easyhttpcpp */
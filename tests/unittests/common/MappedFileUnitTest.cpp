@@ -0,0 +1,120 @@
+/*
+ * Copyright 2019 Sony Corporation
+ */
+
+#include <string>
+
+#include "gtest/gtest.h"
+
+#include "Poco/File.h"
+#include "Poco/FileStream.h"
+#include "Poco/Path.h"
+
+#include "easyhttpcpp/common/CommonMacros.h"
+#include "easyhttpcpp/common/FileUtil.h"
+#include "easyhttpcpp/common/MappedFile.h"
+#include "easyhttpcpp/common/MappedFileInputStream.h"
+
+namespace easyhttpcpp {
+namespace common {
+namespace test {
+
+static const std::string MappedFileTestDir = std::string(EASYHTTPCPP_STRINGIFY_MACRO(RUNTIME_DATA_ROOT)) +
+        "/MappedFile/";
+static const char* const TestData = "0123456789abcdefghij";
+static const size_t MaxSize = 1024;
+
+class MappedFileUnitTest : public testing::Test {
+protected:
+
+    void SetUp()
+    {
+        FileUtil::createDirsIfAbsent(Poco::File(MappedFileTestDir));
+    }
+
+    void TearDown()
+    {
+        FileUtil::removeDirsIfPresent(Poco::Path(MappedFileTestDir));
+    }
+
+    Poco::File createFile(const std::string& name, const std::string& data)
+    {
+        Poco::File file(Poco::Path(MappedFileTestDir, name).toString());
+        Poco::FileOutputStream fos(file.path());
+        fos << data;
+        fos.close();
+        return file;
+    }
+};
+
+#ifndef _WIN32
+TEST_F(MappedFileUnitTest, map_ReturnsMappedFile_WhenFileIsNotEmpty)
+{
+    // Given: create file
+    Poco::File file = createFile("data", TestData);
+
+    // When: call map()
+    MappedFile::Ptr pMappedFile = MappedFile::map(file, MaxSize, MappedFile::AccessPatternSequential);
+
+    // Then: contents of the file are mapped
+    ASSERT_FALSE(pMappedFile.isNull());
+    EXPECT_EQ(std::string(TestData), std::string(pMappedFile->getData(), pMappedFile->getSize()));
+}
+
+TEST_F(MappedFileUnitTest, read_ReadsContinuousData_WhenReadRepeatedly)
+{
+    // Given: create stream of mapped file
+    Poco::File file = createFile("data", TestData);
+    MappedFileInputStream stream(MappedFile::map(file, MaxSize, MappedFile::AccessPatternSequential));
+
+    // When: read twice and read the rest
+    char buffer[5];
+    stream.read(buffer, sizeof(buffer));
+    std::string first(buffer, static_cast<size_t>(stream.gcount()));
+    stream.read(buffer, sizeof(buffer));
+    std::string second(buffer, static_cast<size_t>(stream.gcount()));
+    const char* pData = NULL;
+    size_t size = 0;
+    stream.readRest(pData, size);
+
+    // Then: data is read in order and stream is at eof
+    EXPECT_EQ("01234", first);
+    EXPECT_EQ("56789", second);
+    EXPECT_EQ("abcdefghij", std::string(pData, size));
+    EXPECT_TRUE(stream.eof());
+}
+#endif
+
+TEST_F(MappedFileUnitTest, map_ReturnsNull_WhenFileIsEmpty)
+{
+    // Given: create empty file
+    Poco::File file = createFile("empty", "");
+
+    // When: call map()
+    // Then: NULL is returned
+    EXPECT_TRUE(MappedFile::map(file, MaxSize, MappedFile::AccessPatternNormal).isNull());
+}
+
+TEST_F(MappedFileUnitTest, map_ReturnsNull_WhenFileIsLargerThanMaxSize)
+{
+    // Given: create file
+    Poco::File file = createFile("data", TestData);
+
+    // When: call map() with smaller max size
+    // Then: NULL is returned
+    EXPECT_TRUE(MappedFile::map(file, 10, MappedFile::AccessPatternNormal).isNull());
+}
+
+TEST_F(MappedFileUnitTest, map_ReturnsNull_WhenFileDoesNotExist)
+{
+    // Given: no file
+    Poco::File file(Poco::Path(MappedFileTestDir, "notExist").toString());
+
+    // When: call map()
+    // Then: NULL is returned
+    EXPECT_TRUE(MappedFile::map(file, MaxSize, MappedFile::AccessPatternNormal).isNull());
+}
+
+} /* namespace test */
+} /* namespace common */
+} /* namespace easyhttpcpp */
@@ -0,0 +1,57 @@
+/*
+ * Copyright 2019 Sony Corporation
+ */
+
+#include "gtest/gtest.h"
+
+#include "easyhttpcpp/common/StripedMutex.h"
+
+namespace easyhttpcpp {
+namespace common {
+namespace test {
+
+static const char* const Key1 = "key1";
+static const char* const Key2 = "key2";
+
+TEST(StripedMutexUnitTest, get_ReturnsSameMutex_WhenSameKeyIsSpecified)
+{
+    // Given: create StripedMutex
+    StripedMutex stripedMutex;
+
+    // When: call get() twice with the same key
+    // Then: same mutex is returned
+    EXPECT_EQ(&stripedMutex.get(Key1), &stripedMutex.get(std::string(Key1)));
+}
+
+TEST(StripedMutexUnitTest, lockAll_LocksMutexOfAnyKey)
+{
+    // Given: create StripedMutex
+    StripedMutex stripedMutex;
+
+    // When: call lockAll()
+    stripedMutex.lockAll();
+
+    // Then: mutex of any key can not be locked
+    EXPECT_FALSE(stripedMutex.get(Key1).tryLock());
+    EXPECT_FALSE(stripedMutex.get(Key2).tryLock());
+
+    stripedMutex.unlockAll();
+}
+
+TEST(StripedMutexUnitTest, unlockAll_UnlocksMutexOfAnyKey_WhenLockedByScopedLockAll)
+{
+    // Given: lock all by ScopedLockAll
+    StripedMutex stripedMutex;
+    {
+        StripedMutex::ScopedLockAll lock(stripedMutex);
+    }
+
+    // When: lock mutex of a key
+    // Then: mutex can be locked
+    EXPECT_TRUE(stripedMutex.get(Key1).tryLock());
+    stripedMutex.get(Key1).unlock();
+}
+
+} /* namespace test */
+} /* namespace common */
+} /* namespace easyhttpcpp */